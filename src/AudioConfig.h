@@ -182,6 +182,12 @@ typedef WiFiClient WiFiClientSecure;
 #  define MAX_SINGLE_CHARS 8
 #endif
 
+// single byte I/O calls on a stream after which a per byte I/O warning is
+// logged (0 = disabled); define PER_BYTE_IO_ASSERT to assert instead
+#ifndef PER_BYTE_IO_LIMIT
+#  define PER_BYTE_IO_LIMIT 4096
+#endif
+
 // max size of http processing buffer
 #ifndef HTTP_MAX_LEN
 #  define HTTP_MAX_LEN 1024
@@ -824,6 +830,64 @@ using WiFiServerSecure = BearSSL::WiFiServerSecure;
 #endif
 
 
+/**
+ * -------------------------------------------------------------------------
+ * @brief Build profiles
+ * Curated compile time profiles which prune the platform defaults down to
+ * what the sketch actually needs, so that e.g. a PWM tone only firmware
+ * does not link the unused codec and network code. Define (at most) one of
+ * the following before including AudioTools.h or in AudioConfigLocal.h:
+ * - AUDIO_PROFILE_MINIMAL: core pipeline with PWM and timer only: no
+ *   network, no codec collection, no effects (tone generators are kept)
+ * - AUDIO_PROFILE_PLAYER: local playback: codecs, i2s and effects but no
+ *   network functionality
+ * - AUDIO_PROFILE_NETWORK: streaming: codecs and network but no pwm,
+ *   analog or effects
+ * For even finer control you can set the individual AUDIO_INCLUDE_ and
+ * USE_ defines yourself instead of using a profile.
+ */
+#if defined(AUDIO_PROFILE_MINIMAL)
+#  undef USE_WIFI
+#  undef USE_WIFI_CLIENT_SECURE
+#  undef USE_ETHERNET
+#  undef USE_URL_ARDUINO
+#  undef USE_AUDIO_SERVER
+#  undef USE_I2S
+#  undef USE_ANALOG
+#  undef USE_ANALOG_ARDUINO
+#  undef USE_PDM
+#  undef USE_PDM_RX
+#  undef USE_TDM
+#  undef USE_TOUCH_READ
+#  define AUDIO_INCLUDE_CODECS false
+#  define AUDIO_INCLUDE_EFFECTS false
+#elif defined(AUDIO_PROFILE_PLAYER)
+#  undef USE_WIFI
+#  undef USE_WIFI_CLIENT_SECURE
+#  undef USE_ETHERNET
+#  undef USE_URL_ARDUINO
+#  undef USE_AUDIO_SERVER
+#elif defined(AUDIO_PROFILE_NETWORK)
+#  undef USE_PWM
+#  undef USE_ANALOG
+#  undef USE_ANALOG_ARDUINO
+#  undef USE_PDM
+#  undef USE_PDM_RX
+#  undef USE_TDM
+#  undef USE_TOUCH_READ
+#  define AUDIO_INCLUDE_EFFECTS false
+#endif
+
+// Include the codec collection (CodecWAV, CodecL8, ...) via AudioTools.h
+#ifndef AUDIO_INCLUDE_CODECS
+#  define AUDIO_INCLUDE_CODECS true
+#endif
+
+// Include the audio effects; when false only the tone generators are kept
+#ifndef AUDIO_INCLUDE_EFFECTS
+#  define AUDIO_INCLUDE_EFFECTS true
+#endif
+
 #ifndef URL_CLIENT_TIMEOUT
 #  define URL_CLIENT_TIMEOUT 60000;
 #  define URL_HANDSHAKE_TIMEOUT 120000
@@ -881,6 +945,7 @@ using WiFiServerSecure = BearSSL::WiFiServerSecure;
 #include "AudioTools/CoreAudio/AudioBasic/Int24_3bytes_t.h"
 #include "AudioTools/CoreAudio/AudioBasic/Int24_4bytes_t.h"
 #include "AudioTools/CoreAudio/AudioBasic/FloatAudio.h"
+#include "AudioTools/CoreAudio/AudioBasic/Float16.h"
 
 namespace audio_tools {
     #ifdef USE_3BYTE_INT24
@@ -888,6 +953,8 @@ namespace audio_tools {
     #else
         using int24_t = audio_tools::int24_4bytes_t;
     #endif
+    // 2 byte float storage format (range -1.0 to 1.0)
+    using float16_t = audio_tools::float16;
 }
 
 /**
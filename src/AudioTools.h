@@ -73,7 +73,9 @@
 
 #include "AudioTools/CoreAudio.h"
 #include "AudioTools/AudioCodecs/AudioEncoded.h"
-#include "AudioTools/AudioCodecs/AudioCodecs.h"
+#if AUDIO_INCLUDE_CODECS
+#  include "AudioTools/AudioCodecs/AudioCodecs.h"
+#endif
 
 /**
  * ------------------------------------------------------------------------- 
@@ -81,7 +83,7 @@
  * 
  */
 
-#if defined(ARDUINO) && !defined(IS_DESKTOP)
+#if defined(ARDUINO) && !defined(IS_DESKTOP) && AUDIO_INCLUDE_EFFECTS
 #  include "AudioTools/CoreAudio/AudioEffects/Synthesizer.h"
 #endif
 
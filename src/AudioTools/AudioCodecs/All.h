@@ -35,6 +35,7 @@
 #include "AudioTools/AudioCodecs/CodecL8.h"
 #include "AudioTools/AudioCodecs/CodecMTS.h"
 #include "AudioTools/AudioCodecs/CodecWavIMA.h"
+#include "AudioTools/AudioCodecs/CodecADPCMBlock.h"
 #include "AudioTools/AudioCodecs/CodecBasic.h"
 #include "AudioTools/AudioCodecs/CodecG7xx.h"
 #include "AudioTools/AudioCodecs/CodecLC3.h"
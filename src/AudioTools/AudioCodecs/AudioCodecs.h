@@ -25,5 +25,6 @@
 #include "AudioTools/AudioCodecs/CodecFloat.h"
 #include "AudioTools/AudioCodecs/CodecBase64.h"
 #include "AudioTools/AudioCodecs/DecoderFromStreaming.h"
+#include "AudioTools/AudioCodecs/ContainerOggLight.h"
 #include "AudioTools/AudioCodecs/MultiDecoder.h"
 
@@ -43,14 +43,26 @@ class AudioDecoder : public AudioWriter, public AudioInfoSource {
   virtual void setOutput(AudioOutput &out_stream) {
     Print *p_print = &out_stream;
     setOutput(*p_print);
+    // remember the sink for zero copy writes
+    p_zero_copy = &out_stream;
     addNotifyAudioChange(out_stream);
   }
 
   /// Defines where the decoded result is written to
-  virtual void setOutput(Print &out_stream) override { p_print = &out_stream; }
+  virtual void setOutput(Print &out_stream) override {
+    p_print = &out_stream;
+    p_zero_copy = nullptr;
+  }
 
   /// Returns true to indicate that the decoding result is PCM data
   virtual bool isResultPCM() { return true; }
+
+  /// Provides the byte offset in the encoded data which corresponds to the
+  /// indicated play time in seconds, so that a player can seek by
+  /// repositioning the source: returns -1 if the decoder does not support
+  /// this
+  virtual int64_t byteOffsetForTime(float seconds) { return -1; }
+
   virtual bool begin(AudioInfo info) override {
     setAudioInfo(info);
     return begin();
@@ -67,7 +79,33 @@ class AudioDecoder : public AudioWriter, public AudioInfoSource {
 
  protected:
   Print *p_print = nullptr;
+  AudioOutput *p_zero_copy = nullptr;
   AudioInfo info;
+
+  /// Requests a writable span of len bytes from the sink so that the
+  /// decoded frame can be generated directly into the output buffer:
+  /// returns nullptr if the sink does not provide one - in this case the
+  /// decoder needs to fall back to writing via writePCM()
+  uint8_t *writeBegin(size_t len) {
+    return p_zero_copy != nullptr ? p_zero_copy->writeBegin(len) : nullptr;
+  }
+
+  /// Commits len decoded bytes that have been filled into the span from
+  /// writeBegin()
+  size_t writeEnd(size_t len) {
+    return p_zero_copy != nullptr ? p_zero_copy->writeEnd(len) : 0;
+  }
+
+  /// Writes the decoded pcm result: uses the zero copy span of the sink
+  /// when one is provided, otherwise the data is copied via Print::write
+  size_t writePCM(const uint8_t *data, size_t len) {
+    uint8_t *target = writeBegin(len);
+    if (target != nullptr) {
+      memcpy(target, data, len);
+      return writeEnd(len);
+    }
+    return p_print != nullptr ? p_print->write(data, len) : 0;
+  }
 };
 
 /**
@@ -6,7 +6,9 @@
 #include "AudioTools/CoreAudio/AudioOutput.h"
 #include "AudioTools/CoreAudio/AudioStreams.h"
 #include "AudioTools/CoreAudio/AudioTypes.h"
+#include "AudioTools/CoreAudio/AudioWarmup.h"
 #include "AudioCodecsBase.h"
+#include "MP3HeaderParser.h"
 
 namespace audio_tools {
 
@@ -144,8 +146,11 @@ class EncodedAudioOutput : public ModifyingOutput {
       const CodecNOP *nop = CodecNOP::instance();
       if (decoder_ptr != nop || encoder_ptr != nop) {
         active = true;
+        // report the codec table setup cost to the warmup registry
+        uint32_t start_us = micros();
         if (!decoder_ptr->begin(cfg)) active = false;
         if (!encoder_ptr->begin(cfg)) active = false;
+        warmupRecord("codec", micros() - start_us);
       } else {
         LOGW("no decoder or encoder defined");
       }
@@ -196,7 +201,8 @@ class EncodedAudioOutput : public ModifyingOutput {
       return 0;
     }
 
-    size_t result = writer_ptr->write(data, len);
+    size_t result = is_frame_assembly ? writeFrames(data, len)
+                                      : writer_ptr->write(data, len);
     LOGD("EncodedAudioOutput::write: %d -> %d", (int)len, (int)result);
 #if USE_AUDIO_LOGGING && !defined(USE_IDF_LOGGER)
     custom_log_level.reset();
@@ -228,6 +234,17 @@ class EncodedAudioOutput : public ModifyingOutput {
   /// defines the size of the decoded frame in bytes
   void setFrameSize(int size) { frame_size = size; }
 
+  /// Activates mp3 frame assembly: the written data is collected and the
+  /// decoder is called with one or more complete mp3 frames, so it does not
+  /// need to rescan for sync words across fragmented writes (e.g. from
+  /// URLStream)
+  void setFrameAssembly(bool isActive, int bufferSize = 4096) {
+    is_frame_assembly = isActive;
+    if (isActive && frame_buffer.size() != bufferSize) {
+      frame_buffer.resize(bufferSize);
+    }
+  }
+
  protected:
   // AudioInfo info;
   AudioDecoder *decoder_ptr = CodecNOP::instance();  // decoder
@@ -240,6 +257,73 @@ class EncodedAudioOutput : public ModifyingOutput {
   CustomLogLevel custom_log_level;
 #endif
   int frame_size = DEFAULT_BUFFER_SIZE;
+  bool is_frame_assembly = false;
+  SingleBuffer<uint8_t> frame_buffer{0};
+  MP3HeaderParser mp3_parser;
+
+  /// collects the written data and forwards only complete frames
+  size_t writeFrames(const uint8_t *data, size_t len) {
+    size_t open = len;
+    const uint8_t *ptr = data;
+    while (open > 0) {
+      int written = frame_buffer.writeArray(ptr, open);
+      ptr += written;
+      open -= written;
+      bool consumed = processFrames();
+      if (!consumed && written == 0) {
+        // no progress possible: pass the buffered data through as fallback
+        writer_ptr->write(frame_buffer.data(), frame_buffer.available());
+        frame_buffer.reset();
+      }
+    }
+    return len;
+  }
+
+  /// forwards all complete frames from the assembly buffer to the decoder:
+  /// returns true if any buffered data was consumed
+  bool processFrames() {
+    bool result = false;
+    while (true) {
+      uint8_t *buf = frame_buffer.data();
+      int avail = frame_buffer.available();
+      if (avail < 4) break;
+      int sync = mp3_parser.findSyncWord(buf, avail);
+      if (sync < 0) {
+        // no sync word: drop the data but keep the last byte which might
+        // be the start of a sync word
+        frame_buffer.clearArray(avail - 1);
+        result = true;
+        break;
+      }
+      if (sync > 0) {
+        // skip the data before the sync word
+        frame_buffer.clearArray(sync);
+        result = true;
+        continue;
+      }
+      int frame_len = mp3_parser.parseFrameLength(buf, avail);
+      if (frame_len <= 0) {
+        // false sync: skip it
+        frame_buffer.clearArray(1);
+        result = true;
+        continue;
+      }
+      // frame not complete yet: wait for more data
+      if (avail < frame_len) break;
+      // batch as many complete frames as available
+      int total = frame_len;
+      while (total < avail) {
+        int next = mp3_parser.parseFrameLength(buf + total, avail - total);
+        if (next <= 0 || total + next > avail) break;
+        total += next;
+      }
+      AUDIO_TRACE(TraceFrame, min(total, 32767));
+      writer_ptr->write(buf, total);
+      frame_buffer.clearArray(total);
+      result = true;
+    }
+    return result;
+  }
 };
 
 // legacy name
@@ -384,6 +468,11 @@ class EncodedAudioStream : public ReformatBaseStream {
   /// defines the size of the decoded frame in bytes
   void setFrameSize(int size) { enc_out.setFrameSize(size); }
 
+  /// Activates mp3 frame assembly: see EncodedAudioOutput::setFrameAssembly
+  void setFrameAssembly(bool isActive, int bufferSize = 4096) {
+    enc_out.setFrameAssembly(isActive, bufferSize);
+  }
+
  protected:
   EncodedAudioOutput enc_out;
   float byte_factor = 2.0f;
@@ -0,0 +1,351 @@
+#pragma once
+
+#include "AudioTools/AudioCodecs/CodecWavIMA.h"
+
+#define ADPCM_BLOCK_DEFAULT_SIZE 256
+
+namespace audio_tools {
+
+/**
+ * @brief Precomputed combined IMA ADPCM tables: for each (step index,
+ * nibble) pair we store the signed predictor delta and the already clamped
+ * next step index. This replaces the per nibble step lookup, the branchy
+ * bit tests and the index clamping of the textbook decoder by two plain
+ * table reads, so the inner loop becomes branchless except for the
+ * predictor clamp. The tables are shared by the decoder and the encoder
+ * and are filled once at first use.
+ * @ingroup codecs
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ */
+class IMACombinedTables {
+ public:
+  static IMACombinedTables &instance() {
+    static IMACombinedTables self;
+    return self;
+  }
+
+  int32_t diff[89][16];
+  uint8_t next_index[89][16];
+
+ protected:
+  IMACombinedTables() {
+    for (int idx = 0; idx <= 88; idx++) {
+      int32_t step = ima_step_table[idx];
+      for (int n = 0; n < 16; n++) {
+        int32_t d = step >> 3;
+        if (n & 4) d += step;
+        if (n & 2) d += step >> 1;
+        if (n & 1) d += step >> 2;
+        diff[idx][n] = (n & 8) ? -d : d;
+        int next = idx + ima_index_table[n];
+        if (next < 0) next = 0;
+        if (next > 88) next = 88;
+        next_index[idx][n] = next;
+      }
+    }
+  }
+};
+
+/**
+ * @brief Fast self contained decoder for raw IMA ADPCM blocks (the block
+ * layout of WAVE_FORMAT_IMA_ADPCM: a 4 byte preamble per channel followed
+ * by the nibble data). In contrast to WavIMADecoder no container is
+ * expected, so it can be used directly on raw block streams (e.g. over
+ * ESPNowStream). The inner loop consumes 4 nibbles per iteration using
+ * the combined tables from IMACombinedTables, which roughly halves the
+ * decode cost compared to the nibble by nibble approach. Supports 1 or 2
+ * channels with 16 bit output.
+ * @ingroup codecs
+ * @ingroup decoder
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ */
+class ADPCMBlockDecoder : public AudioDecoderExt {
+ public:
+  ADPCMBlockDecoder(int blockSize = ADPCM_BLOCK_DEFAULT_SIZE) {
+    block_size = blockSize;
+  }
+
+  /// Defines the block size (size of an encoded block in bytes)
+  void setBlockSize(int blockSize) override { block_size = blockSize; }
+
+  /// Provides the block size (size of an encoded block in bytes)
+  int blockSize() { return block_size; }
+
+  /// Provides the number of decoded frames per block
+  int framesPerBlock() { return frames_per_block; }
+
+  bool begin() override {
+    TRACEI();
+    int channels = info.channels;
+    if (channels < 1 || channels > 2) {
+      LOGE("channels not supported: %d", channels);
+      return false;
+    }
+    if (block_size <= 4 * channels || (block_size & 1) != 0) {
+      LOGE("invalid block size: %d", block_size);
+      return false;
+    }
+    frames_per_block = (block_size - 4 * channels) * 2 / channels + 1;
+    adpcm_block.resize(block_size);
+    pcm_block.resize(frames_per_block * channels);
+    current_byte = 0;
+    info.bits_per_sample = 16;
+    notifyAudioChange(info);
+    is_started = true;
+    return true;
+  }
+
+  void end() override {
+    TRACEI();
+    adpcm_block.resize(0);
+    pcm_block.resize(0);
+    is_started = false;
+  }
+
+  size_t write(const uint8_t *data, size_t len) override {
+    LOGD("write: %d", (int)len);
+    if (!is_started) return 0;
+    size_t pos = 0;
+    while (pos < len) {
+      int to_copy = min((int)(len - pos), block_size - current_byte);
+      memcpy(&adpcm_block[current_byte], data + pos, to_copy);
+      current_byte += to_copy;
+      pos += to_copy;
+      if (current_byte == block_size) {
+        decodeBlock();
+        p_print->write((uint8_t *)pcm_block.data(),
+                       pcm_block.size() * sizeof(int16_t));
+        current_byte = 0;
+      }
+    }
+    return len;
+  }
+
+  operator bool() override { return is_started; }
+
+ protected:
+  IMACombinedTables &tables = IMACombinedTables::instance();
+  Vector<uint8_t> adpcm_block;
+  Vector<int16_t> pcm_block;
+  int block_size = ADPCM_BLOCK_DEFAULT_SIZE;
+  int frames_per_block = 0;
+  int current_byte = 0;
+  bool is_started = false;
+
+  /// Decodes a nibble with the combined tables: 2 table reads and a clamp
+  inline int16_t decodeNibble(uint8_t nibble, int32_t &pred, int &idx) {
+    pred += tables.diff[idx][nibble];
+    if (pred < -32768)
+      pred = -32768;
+    else if (pred > 32767)
+      pred = 32767;
+    idx = tables.next_index[idx][nibble];
+    return (int16_t)pred;
+  }
+
+  void decodeBlock() {
+    int channels = info.channels;
+    if (channels == 1) {
+      int32_t pred = (int16_t)(adpcm_block[0] | (adpcm_block[1] << 8));
+      int idx = min((int)adpcm_block[2], 88);
+      pcm_block[0] = (int16_t)pred;
+      int out_pos = 1;
+      // 2 bytes = 4 nibbles per iteration
+      for (int pos = 4; pos < block_size; pos += 2) {
+        uint8_t b0 = adpcm_block[pos];
+        uint8_t b1 = adpcm_block[pos + 1];
+        pcm_block[out_pos++] = decodeNibble(b0 & 15, pred, idx);
+        pcm_block[out_pos++] = decodeNibble(b0 >> 4, pred, idx);
+        pcm_block[out_pos++] = decodeNibble(b1 & 15, pred, idx);
+        pcm_block[out_pos++] = decodeNibble(b1 >> 4, pred, idx);
+      }
+    } else {
+      // stereo: 4 byte groups per channel with 8 nibbles each
+      int32_t pred[2];
+      int idx[2];
+      for (int c = 0; c < 2; c++) {
+        pred[c] = (int16_t)(adpcm_block[c * 4] | (adpcm_block[c * 4 + 1] << 8));
+        idx[c] = min((int)adpcm_block[c * 4 + 2], 88);
+        pcm_block[c] = (int16_t)pred[c];
+      }
+      int out_pos = 2;
+      for (int pos = 8; pos < block_size; pos += 8) {
+        for (int c = 0; c < 2; c++) {
+          int32_t p = pred[c];
+          int i = idx[c];
+          int out = out_pos + c;
+          for (int j = 0; j < 4; j++) {
+            uint8_t b = adpcm_block[pos + c * 4 + j];
+            pcm_block[out] = decodeNibble(b & 15, p, i);
+            out += 2;
+            pcm_block[out] = decodeNibble(b >> 4, p, i);
+            out += 2;
+          }
+          pred[c] = p;
+          idx[c] = i;
+        }
+        out_pos += 16;
+      }
+    }
+  }
+};
+
+/**
+ * @brief Fast self contained encoder counterpart to ADPCMBlockDecoder:
+ * produces raw IMA ADPCM blocks (WAVE_FORMAT_IMA_ADPCM block layout) from
+ * 16 bit PCM. The quantization still needs the step table, but the
+ * predictor update and index advance use the combined tables, and the
+ * inner loop emits a full byte (2 nibbles) per iteration. Supports 1 or 2
+ * channels.
+ * @ingroup codecs
+ * @ingroup encoder
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ */
+class ADPCMBlockEncoder : public AudioEncoderExt {
+ public:
+  ADPCMBlockEncoder(int blockSize = ADPCM_BLOCK_DEFAULT_SIZE) {
+    block_size = blockSize;
+  }
+
+  /// Defines the block size (size of an encoded block in bytes)
+  void setBlockSize(int blockSize) { block_size = blockSize; }
+
+  /// Provides the block size (size of an encoded block in bytes)
+  int blockSize() override { return block_size; }
+
+  /// Provides the number of pcm frames which make up one block
+  int framesPerBlock() { return frames_per_block; }
+
+  const char *mime() override { return "audio/adpcm"; }
+
+  void setOutput(Print &out_stream) override { p_print = &out_stream; }
+
+  bool begin() override {
+    TRACEI();
+    int channels = info.channels;
+    if (channels < 1 || channels > 2) {
+      LOGE("channels not supported: %d", channels);
+      return false;
+    }
+    if (block_size <= 4 * channels || (block_size & 1) != 0) {
+      LOGE("invalid block size: %d", block_size);
+      return false;
+    }
+    frames_per_block = (block_size - 4 * channels) * 2 / channels + 1;
+    pcm_block.resize(frames_per_block * channels);
+    adpcm_block.resize(block_size);
+    current_sample = 0;
+    for (int c = 0; c < 2; c++) idx[c] = 0;
+    is_started = true;
+    return true;
+  }
+
+  void end() override {
+    TRACEI();
+    pcm_block.resize(0);
+    adpcm_block.resize(0);
+    is_started = false;
+  }
+
+  size_t write(const uint8_t *data, size_t len) override {
+    LOGD("write: %d", (int)len);
+    if (!is_started) return 0;
+    int16_t *data16 = (int16_t *)data;
+    int total = pcm_block.size();
+    for (int j = 0; j < (int)(len / 2); j++) {
+      pcm_block[current_sample++] = data16[j];
+      if (current_sample == total) {
+        encodeBlock();
+        p_print->write(adpcm_block.data(), block_size);
+        current_sample = 0;
+      }
+    }
+    return len;
+  }
+
+  operator bool() override { return is_started; }
+
+ protected:
+  IMACombinedTables &tables = IMACombinedTables::instance();
+  Vector<int16_t> pcm_block;
+  Vector<uint8_t> adpcm_block;
+  Print *p_print = nullptr;
+  int block_size = ADPCM_BLOCK_DEFAULT_SIZE;
+  int frames_per_block = 0;
+  int current_sample = 0;
+  int idx[2];
+
+  bool is_started = false;
+
+  /// Quantizes a sample against the predictor: the predictor update and
+  /// the index advance reuse the combined tables
+  inline uint8_t encodeNibble(int32_t sample, int32_t &pred, int &i) {
+    int32_t step = ima_step_table[i];
+    int32_t diff = sample - pred;
+    uint8_t nibble = 0;
+    if (diff < 0) {
+      nibble = 8;
+      diff = -diff;
+    }
+    if (diff >= step) {
+      nibble |= 4;
+      diff -= step;
+    }
+    step >>= 1;
+    if (diff >= step) {
+      nibble |= 2;
+      diff -= step;
+    }
+    step >>= 1;
+    if (diff >= step) nibble |= 1;
+    pred += tables.diff[i][nibble];
+    if (pred < -32768)
+      pred = -32768;
+    else if (pred > 32767)
+      pred = 32767;
+    i = tables.next_index[i][nibble];
+    return nibble;
+  }
+
+  void encodeBlock() {
+    int channels = info.channels;
+    int32_t pred[2];
+    // the preamble carries the first frame verbatim
+    for (int c = 0; c < channels; c++) {
+      pred[c] = pcm_block[c];
+      adpcm_block[c * 4] = pred[c] & 0xFF;
+      adpcm_block[c * 4 + 1] = (pred[c] >> 8) & 0xFF;
+      adpcm_block[c * 4 + 2] = idx[c];
+      adpcm_block[c * 4 + 3] = 0;
+    }
+    if (channels == 1) {
+      int in_pos = 1;
+      // one full byte (2 nibbles) per iteration
+      for (int pos = 4; pos < block_size; pos++) {
+        uint8_t lo = encodeNibble(pcm_block[in_pos++], pred[0], idx[0]);
+        uint8_t hi = encodeNibble(pcm_block[in_pos++], pred[0], idx[0]);
+        adpcm_block[pos] = lo | (hi << 4);
+      }
+    } else {
+      int in_pos = 2;
+      for (int pos = 8; pos < block_size; pos += 8) {
+        for (int c = 0; c < 2; c++) {
+          int in = in_pos + c;
+          for (int j = 0; j < 4; j++) {
+            uint8_t lo = encodeNibble(pcm_block[in], pred[c], idx[c]);
+            in += 2;
+            uint8_t hi = encodeNibble(pcm_block[in], pred[c], idx[c]);
+            in += 2;
+            adpcm_block[pos + c * 4 + j] = lo | (hi << 4);
+          }
+        }
+        in_pos += 16;
+      }
+    }
+  }
+};
+
+}  // namespace audio_tools
@@ -30,8 +30,9 @@ struct ADTSParser {
   uint8_t adts_buf_fullness;
   uint8_t num_rawdata_blocks;
   uint32_t quick_check = 0;
+  uint32_t header_template = 0;
 
-  bool begin() { quick_check = 0; return true;}
+  bool begin() { quick_check = 0; header_template = 0; return true;}
 
   bool parse(uint8_t *hdr) {
     syncword = (hdr[0] << 4) | (hdr[1] >> 4);
@@ -81,10 +82,36 @@ struct ADTSParser {
     }
     if (!is_valid) {
       LOGD("=> Invalid ADTS");
+    } else {
+      // memoize the fixed header fields for the fast path
+      header_template = fixedFields(hdr);
     }
     return is_valid;
   }
 
+  /// the fixed header fields (everything but frame length and buffer
+  /// fullness) packed into one word
+  uint32_t fixedFields(uint8_t *hdr) {
+    return ((uint32_t)hdr[0] << 24) | ((uint32_t)hdr[1] << 16) |
+           ((uint32_t)hdr[2] << 8) | (hdr[3] & 0xC0);
+  }
+
+  /// single word compare against the memoized header: consecutive frames
+  /// share all fixed fields, so no full validation is needed
+  bool matchesTemplate(uint8_t *hdr) {
+    return header_template != 0 && fixedFields(hdr) == header_template;
+  }
+
+  /// decodes only the variable header fields - the fixed ones are known to
+  /// match the already validated template
+  void parseVariable(uint8_t *hdr) {
+    frame_length = ((((unsigned int)hdr[3] & 0x3)) << 11) |
+                   (((unsigned int)hdr[4]) << 3) | (hdr[5] >> 5);
+    adts_buf_fullness = ((hdr[5] & 0b11111) << 6) | (hdr[6] >> 2);
+    num_rawdata_blocks = (hdr[6]) & 0b11;
+    is_valid = frame_length <= 1024;
+  }
+
   unsigned int size() { return frame_length; };
 
   void log() {
@@ -155,6 +182,8 @@ class ADTSDecoder : public AudioDecoder {
         assert(buffer_write_size == parser.size());
         writeFrame();
         buffer_write_size = 0;
+        // process the remaining data of this write
+        parseBuffer();
       }
     }
     return result;
@@ -171,6 +200,9 @@ class ADTSDecoder : public AudioDecoder {
   void parseBuffer() {
     // when nothing is open
     while (buffer.available() >= 7 && buffer_write_size == 0) {
+      // fast path: batch consecutive frames which match the validated
+      // header template
+      if (parseBatch()) continue;
       int pos = parser.findSynchWord(buffer.data(), buffer.available());
       LOGD("synchword at %d from %d", pos, buffer.available());
       if (pos >= 0) {
@@ -184,6 +216,34 @@ class ADTSDecoder : public AudioDecoder {
     }
   }
 
+  /// writes as many template matching complete frames as possible with a
+  /// single downstream write: returns true if any progress was made
+  bool parseBatch() {
+    int batch_len = 0;
+    while (buffer.available() - batch_len >= 7 &&
+           parser.matchesTemplate(buffer.data() + batch_len)) {
+      parser.parseVariable(buffer.data() + batch_len);
+      // degenerate frame length: leave it to the full validation
+      if (!parser.is_valid || parser.size() <= 7) break;
+      if (buffer.available() - batch_len < (int)parser.size()) {
+        if (batch_len == 0) {
+          // collect the open frame
+          resizeBuffer();
+          buffer_write_size = parser.size();
+          return true;
+        }
+        break;
+      }
+      batch_len += parser.size();
+    }
+    if (batch_len == 0) return false;
+    LOGD("writing ADTS batch: %d bytes", batch_len);
+    size_t len = p_print->write(buffer.data(), batch_len);
+    assert((int)len == batch_len);
+    buffer.clearArray(batch_len);
+    return true;
+  }
+
   void processSync(int pos) {
     // remove data up to the sync word
     buffer.clearArray(pos);
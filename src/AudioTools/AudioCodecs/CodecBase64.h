@@ -15,6 +15,22 @@ static char encoding_table[] = {
     '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', '+', '/'};
 static int mod_table[] = {0, 2, 1};
 
+/// Provides the 4096 precomputed base64 character pairs for the 12 bit
+/// encode lookups (8 kB, created on first use): one 24 bit input triple is
+/// encoded with two lookups instead of four 6 bit ones
+inline const uint8_t (*base64EncPairs())[2] {
+  static uint8_t pairs[4096][2];
+  static bool is_setup = false;
+  if (!is_setup) {
+    for (int v = 0; v < 4096; v++) {
+      pairs[v][0] = encoding_table[(v >> 6) & 0x3F];
+      pairs[v][1] = encoding_table[v & 0x3F];
+    }
+    is_setup = true;
+  }
+  return pairs;
+}
+
 static const int B64index[256] = {
     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
@@ -81,11 +97,12 @@ class DecoderBase64 : public AudioDecoder {
     if (p_print == nullptr) return 0;
     TRACED();
     addToBuffer((uint8_t *)data, len);
-    int decode_size = 4;  // maybe we should increase this ?
-    while (buffer.available() >= decode_size) {
-      uint8_t tmp[decode_size];
-      buffer.readArray(tmp, decode_size);
-      decodeLine(tmp, decode_size);
+    // decode all complete groups of 4 in one go
+    int avail = buffer.available() & ~3;
+    if (avail > 0) {
+      if ((int)temp.size() < avail) temp.resize(avail);
+      buffer.readArray(temp.data(), avail);
+      decodeBlock(temp.data(), avail);
     }
 
     return len;
@@ -98,9 +115,29 @@ class DecoderBase64 : public AudioDecoder {
   bool is_valid = false;
   Base46Logic newline_logic = CRforFrame;
   Vector<uint8_t> result;
+  Vector<uint8_t> temp;
   RingBuffer<uint8_t> buffer{1500};
   AudioInfo info;
 
+  /// Decodes a whole block of complete groups of 4: padded groups ('=' at a
+  /// frame end) are split off and decoded individually, everything in between
+  /// is handled in a single decodeLine() call
+  void decodeBlock(uint8_t *data, int len) {
+    int offset = 0;
+    while (offset < len) {
+      uint8_t *pad = (uint8_t *)memchr(data + offset, '=', len - offset);
+      if (pad == nullptr) {
+        decodeLine(data + offset, len - offset);
+        break;
+      }
+      // group of 4 which contains the padding
+      int pad_start = offset + (int)((pad - (data + offset)) & ~3);
+      if (pad_start > offset) decodeLine(data + offset, pad_start - offset);
+      decodeLine(data + pad_start, 4);
+      offset = pad_start + 4;
+    }
+  }
+
   void decodeLine(uint8_t *data, size_t byteCount) {
     LOGD("decode: %d", (int)byteCount);
     int len = byteCount;
@@ -271,21 +308,32 @@ class EncoderBase64 : public AudioEncoder {
       ret.resize(output_length + 1);
     }
 
-    for (int i = 0, j = 0; i < input_length;) {
-      uint32_t octet_a = i < input_length ? (unsigned char)data[i++] : 0;
-      uint32_t octet_b = i < input_length ? (unsigned char)data[i++] : 0;
-      uint32_t octet_c = i < input_length ? (unsigned char)data[i++] : 0;
+    // full triples: two 12 bit lookups provide 2 characters each
+    const uint8_t(*pairs)[2] = base64EncPairs();
+    size_t full = input_length / 3 * 3;
+    size_t i = 0;
+    int j = 0;
+    for (; i < full; i += 3, j += 4) {
+      uint32_t triple = ((uint32_t)data[i] << 0x10) |
+                        ((uint32_t)data[i + 1] << 0x08) | data[i + 2];
+      memcpy(ret.data() + j, pairs[triple >> 12], 2);
+      memcpy(ret.data() + j + 2, pairs[triple & 0xFFF], 2);
+    }
 
-      uint32_t triple = (octet_a << 0x10) + (octet_b << 0x08) + octet_c;
+    // remaining 1 or 2 bytes
+    if (i < input_length) {
+      uint32_t octet_a = (unsigned char)data[i++];
+      uint32_t octet_b = i < input_length ? (unsigned char)data[i++] : 0;
+      uint32_t triple = (octet_a << 0x10) + (octet_b << 0x08);
 
       ret[j++] = encoding_table[(triple >> 3 * 6) & 0x3F];
       ret[j++] = encoding_table[(triple >> 2 * 6) & 0x3F];
       ret[j++] = encoding_table[(triple >> 1 * 6) & 0x3F];
       ret[j++] = encoding_table[(triple >> 0 * 6) & 0x3F];
-    }
 
-    for (int i = 0; i < mod_table[input_length % 3]; i++)
-      ret[output_length - 1 - i] = '=';
+      for (int k = 0; k < mod_table[input_length % 3]; k++)
+        ret[output_length - 1 - k] = '=';
+    }
 
     // add a new line to the end
     if (newline_logic != NoCR) {
@@ -47,6 +47,15 @@ public:
   /// Defines that the source and therefor the result is also PCM data
   void setResultPCM(bool pcm){ is_pcm = pcm;}
 
+  /// Provides the frame aligned byte offset for the indicated play time:
+  /// this is only defined when the data is raw PCM (e.g. L16)
+  int64_t byteOffsetForTime(float seconds) override {
+    if (!is_pcm || seconds < 0.0f) return -1;
+    int frame_size = info.channels * info.bits_per_sample / 8;
+    if (info.sample_rate == 0 || frame_size == 0) return -1;
+    return static_cast<int64_t>(seconds * info.sample_rate) * frame_size;
+  }
+
 protected:
   Print *pt_print=nullptr;
   bool is_pcm = false;
@@ -16,6 +16,23 @@ namespace audio_tools {
  */
 enum G7xxCODEC_e {g723_24, g721, g723_40, others};
 
+/// Shared segment lookup table for the table driven G.711 encoders: the
+/// index is the high byte of the biased magnitude, the entry the segment
+/// number (8 = clip). Built lazily on first use.
+inline const uint8_t *g711SegmentTable() {
+  static uint8_t lut[256];
+  static bool is_setup = false;
+  if (!is_setup) {
+    for (int t = 0; t < 256; t++) {
+      int seg = 0;
+      while (seg < 8 && t >= (1 << seg)) seg++;
+      lut[t] = seg;
+    }
+    is_setup = true;
+  }
+  return lut;
+}
+
 /**
  * @brief g723_24, g721, g723_40 Decoder based on https://github.com/pschatzmann/arduino-libg7xx
  * @ingroup codecs
@@ -93,10 +110,20 @@ class G7xxDecoder : public AudioDecoder {
       return 0;
     }
 
+    // decode in blocks so that we issue one write per block instead of
+    // one write per sample
+    int16_t out[128];
+    int pos = 0;
     uint8_t *p_byte = (uint8_t *)data;
     for (int j = 0; j < len; j++) {
-      sample = (*dec_routine)(p_byte[j], AUDIO_ENCODING_LINEAR, &state);
-      p_print->write((uint8_t*)&sample, out_size);
+      out[pos++] = (*dec_routine)(p_byte[j], AUDIO_ENCODING_LINEAR, &state);
+      if (pos == 128) {
+        p_print->write((uint8_t *)out, pos * sizeof(int16_t));
+        pos = 0;
+      }
+    }
+    if (pos > 0) {
+      p_print->write((uint8_t *)out, pos * sizeof(int16_t));
     }
 
     return len;
@@ -198,14 +225,23 @@ class G7xxEncoder : public AudioEncoder {
       LOGE("inactive");
       return 0;
     }
-    // encode bytes
+    // encode in blocks so that we issue one write per block instead of
+    // one write per sample
+    uint8_t out[128];
+    int pos = 0;
     int16_t *p_16 = (int16_t *)data;
     int samples = len / sizeof(int16_t);
     for (int j = 0; j < samples; j++) {
-        code = (*enc_routine)(p_16[j], AUDIO_ENCODING_LINEAR, &state);
-        p_print->write(&code, 1);
+      out[pos++] = (*enc_routine)(p_16[j], AUDIO_ENCODING_LINEAR, &state);
+      if (pos == 128) {
+        p_print->write(out, pos);
+        pos = 0;
+      }
+    }
+    if (pos > 0) {
+      p_print->write(out, pos);
     }
-   
+
     return len;
   }
 
@@ -306,6 +342,13 @@ class G711Encoder : public G7xxEncoder {
     this->enc = enc;
     assert(this->enc!=nullptr);
   };
+
+  bool begin() override {
+    bool rc = G7xxEncoder::begin();
+    setupFastEncoder();
+    return rc;
+  }
+
   size_t write(const uint8_t *data, size_t len) override {
     LOGD("write: %d", len);
     if (!is_active) {
@@ -316,14 +359,81 @@ class G711Encoder : public G7xxEncoder {
     int samples = len/2;
     int16_t *p_16 = (int16_t *)data;
     uint8_t buffer[samples];
-    for (int j = 0; j < samples; j++) {
-	      buffer[j] = enc(p_16[j]);
+    if (use_fast) {
+      for (int j = 0; j < samples; j++) {
+        buffer[j] = is_alaw ? encodeAlaw(p_16[j]) : encodeUlaw(p_16[j]);
+      }
+    } else {
+      for (int j = 0; j < samples; j++) {
+        buffer[j] = enc(p_16[j]);
+      }
     }
     p_print->write(buffer,samples);
     return len;
   }
   protected:
   uint8_t(*enc)(int)=nullptr;
+  bool use_fast = false;
+  bool is_alaw = false;
+
+  /// Activates the table driven encoder for the standard µ-law/A-law
+  /// routines and confirms once that it is bit exact with the linked
+  /// reference implementation; a custom routine or a mismatch falls back
+  /// to calling the reference per sample
+  void setupFastEncoder() {
+    use_fast = true;
+    if (enc == linear2ulaw) {
+      is_alaw = false;
+    } else if (enc == linear2alaw) {
+      is_alaw = true;
+    } else {
+      use_fast = false;
+      return;
+    }
+    // the stride of 3 hits every quantization cell of both laws
+    for (int32_t v = -32768; v <= 32767; v += 3) {
+      uint8_t fast = is_alaw ? encodeAlaw(v) : encodeUlaw(v);
+      if (fast != enc(v)) {
+        LOGW("table driven G.711 does not match the reference: using the "
+             "reference");
+        use_fast = false;
+        return;
+      }
+    }
+  }
+
+  /// µ-law encoding with the segment from a 256 entry table instead of a
+  /// search loop
+  uint8_t encodeUlaw(int pcm) {
+    int mask;
+    if (pcm < 0) {
+      pcm = 0x84 - pcm;
+      mask = 0x7F;
+    } else {
+      pcm += 0x84;
+      mask = 0xFF;
+    }
+    if (pcm > 0x7FFF) pcm = 0x7FFF;
+    int seg = g711SegmentTable()[pcm >> 8];
+    return (uint8_t)(((seg << 4) | ((pcm >> (seg + 3)) & 0x0F)) ^ mask);
+  }
+
+  /// A-law encoding with the segment from a 256 entry table instead of a
+  /// search loop
+  uint8_t encodeAlaw(int pcm) {
+    int mask;
+    if (pcm >= 0) {
+      mask = 0xD5;
+    } else {
+      mask = 0x55;
+      pcm = -pcm - 8;
+      if (pcm > 0x7FFF) pcm = 0x7FFF;
+    }
+    int seg = g711SegmentTable()[pcm >> 8];
+    int aval = seg << 4;
+    aval |= (seg < 2) ? (pcm >> 4) & 0x0F : (pcm >> (seg + 3)) & 0x0F;
+    return (uint8_t)(aval ^ mask);
+  }
 };
 
 /**
@@ -341,22 +451,40 @@ class G711Decoder : public G7xxDecoder {
     assert(this->dec!=nullptr);
   };
 
+  bool begin() override {
+    bool rc = G7xxDecoder::begin();
+    // decoding becomes a plain table access: the 256 entry table is filled
+    // from the reference implementation
+    for (int j = 0; j < 256; j++) {
+      dec_lut[j] = dec((uint8_t)j);
+    }
+    return rc;
+  }
+
   size_t write(const uint8_t *data, size_t len) override {
     LOGD("write: %d", len);
     if (!is_active) {
       LOGE("inactive");
       return 0;
     }
-    // decode bytes
+    // decode in blocks so that we issue one write per block instead of
+    // one write per sample
+    int16_t out[128];
     uint8_t *p_8 = (uint8_t *)data;
-    for (int j = 0; j < len; j++) {
-	      int16_t result = dec(p_8[j]);
-        p_print->write((uint8_t*)&result,sizeof(int16_t));
+    size_t remaining = len;
+    while (remaining > 0) {
+      int n = remaining < 128 ? remaining : 128;
+      for (int j = 0; j < n; j++) {
+        out[j] = dec_lut[*p_8++];
+      }
+      p_print->write((uint8_t *)out, n * sizeof(int16_t));
+      remaining -= n;
     }
     return len;
   }
   protected:
   int (*dec)(uint8_t a_val)=nullptr;
+  int16_t dec_lut[256] = {0};
 };
 
 
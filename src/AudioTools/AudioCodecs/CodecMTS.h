@@ -119,10 +119,23 @@ class MTSDecoder : public AudioDecoder {
   size_t write(const uint8_t *data, size_t len) override {
     if (!is_active) return 0;
     LOGD("MTSDecoder::write: %d", (int)len);
-    size_t result = buffer.writeArray((uint8_t*)data, len);
-    // demux
-    demux(underflowLimit);
-    return result;
+    size_t pos = 0;
+    // complete a pending partial packet first
+    if (buffer.available() > 0) {
+      int missing = TS_PACKET_SIZE - buffer.available();
+      int to_copy = min((int)len, missing);
+      buffer.writeArray((uint8_t *)data, to_copy);
+      pos += to_copy;
+      if (buffer.available() < TS_PACKET_SIZE) return len;
+      if (processPackets(buffer.data(), TS_PACKET_SIZE) == 0) return len;
+      buffer.reset();
+    }
+    // batch: process all complete packets directly from the burst
+    pos += processPackets(data + pos, len - pos);
+    // keep the remainder (beginning at a sync byte) for the next call
+    while (pos < len && data[pos] != 0x47) pos++;
+    if (pos < len) buffer.writeArray((uint8_t *)data + pos, len - pos);
+    return len;
   }
 
   void flush(){
@@ -182,6 +195,32 @@ class MTSDecoder : public AudioDecoder {
       LOGD("Number of demux calls: %d", count);
   }
 
+  /// Batch core: parses all complete ts packets of the burst in one pass
+  /// without copying them into the write buffer and returns the number of
+  /// consumed bytes; unsynchronized data is skipped up to the next sync
+  /// byte. The per packet logic (parsePacket and the PAT/PMT/PES handling)
+  /// is unchanged and runs on top of this loop.
+  size_t processPackets(const uint8_t *packets, size_t len) {
+    size_t pos = 0;
+    int count = 0;
+    while (pos + TS_PACKET_SIZE <= len) {
+      if (packets[pos] != 0x47) {
+        // resync on the next sync byte
+        pos++;
+        continue;
+      }
+      int rc = parsePacket((uint8_t *)packets + pos, data.data());
+      if (rc < 0) {
+        is_active = false;
+        return pos;
+      }
+      pos += TS_PACKET_SIZE;
+      count++;
+    }
+    LOGD("Number of packets: %d", count);
+    return pos;
+  }
+
   uint32_t parse() {
       int len = buffer.available();
       // If len is too short, return 0
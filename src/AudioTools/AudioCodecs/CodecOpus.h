@@ -281,11 +281,29 @@ class OpusAudioEncoder : public AudioEncoder {
       return false;
     }
     is_open = settings();
+    // starting point for the automatic complexity tuning
+    actual_complexity = cfg.complexity >= 0 ? cfg.complexity : 5;
+    if (is_auto_complexity) {
+      opus_encoder_ctl(enc, OPUS_SET_COMPLEXITY(actual_complexity));
+      avg_encode_time_us = 0;
+      tune_frames = 0;
+    }
     return true;
   }
 
-  /// Provides access to the configuration
-  OpusEncoderSettings &config() { return cfg; }
+  /// Activates the automatic complexity tuning: the encoder measures its
+  /// own encode time per frame and walks the complexity (0-10) up or down
+  /// so that the encoding stays below the indicated percentage of the
+  /// frame period. Each hardware tier thus gets the best quality that it
+  /// can sustain in real time.
+  void setAutoComplexity(bool active, int maxLoadPercent = 70) {
+    is_auto_complexity = active;
+    max_load_percent = maxLoadPercent;
+  }
+
+  /// Provides the actually used complexity (esp. relevant when the
+  /// automatic tuning is active)
+  int complexity() { return actual_complexity; }
 
   OpusEncoderSettings &defaultConfig() { return cfg; }
 
@@ -326,6 +344,11 @@ class OpusAudioEncoder : public AudioEncoder {
   bool is_open = false;
   Vector<uint8_t> frame{0};
   int frame_pos = 0;
+  bool is_auto_complexity = false;
+  int max_load_percent = 70;
+  int actual_complexity = 5;
+  uint32_t avg_encode_time_us = 0;
+  int tune_frames = 0;
 
   void encodeByte(uint8_t data) {
     // add byte to frame
@@ -346,8 +369,10 @@ class OpusAudioEncoder : public AudioEncoder {
 
       int frames = frame.size() / cfg.channels / sizeof(int16_t);
       LOGD("opus_encode - frame_size: %d", frames);
+      uint32_t start_us = micros();
       int len = opus_encode(enc, (opus_int16 *)frame.data(), frames,
                             packet, packet_len);
+      if (is_auto_complexity) tuneComplexity(micros() - start_us, frames);
       if (len < 0) {
         LOGE("opus_encode: %s", opus_strerror(len));
       } else if (len > 0) {
@@ -360,6 +385,33 @@ class OpusAudioEncoder : public AudioEncoder {
     }
   }
 
+  /// Walks the complexity up or down so that the (smoothed) measured
+  /// encode time stays below the configured share of the frame period
+  void tuneComplexity(uint32_t encode_time_us, int frames) {
+    uint32_t frame_period_us = (uint64_t)1000000 * frames / cfg.sample_rate;
+    uint32_t budget_us = frame_period_us * max_load_percent / 100;
+    // smooth the measurement so that single outliers do not trigger
+    avg_encode_time_us = (avg_encode_time_us * 3 + encode_time_us) / 4;
+    // let the average settle before adjusting
+    if (++tune_frames < 8) return;
+    tune_frames = 0;
+    int new_complexity = actual_complexity;
+    if (avg_encode_time_us > budget_us) {
+      new_complexity--;
+    } else if (avg_encode_time_us < budget_us / 2) {
+      new_complexity++;
+    }
+    if (new_complexity < 0) new_complexity = 0;
+    if (new_complexity > 10) new_complexity = 10;
+    if (new_complexity != actual_complexity &&
+        opus_encoder_ctl(enc, OPUS_SET_COMPLEXITY(new_complexity)) ==
+            OPUS_OK) {
+      LOGI("complexity: %d -> %d (%d of %d us)", actual_complexity,
+           new_complexity, (int)avg_encode_time_us, (int)budget_us);
+      actual_complexity = new_complexity;
+    }
+  }
+
   /// Returns the frame size in samples
   int getFrameSizeSamples(int sampling_rate) {
     switch (cfg.frame_sizes_ms_x2) {
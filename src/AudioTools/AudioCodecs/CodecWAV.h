@@ -314,6 +314,20 @@ class WAVDecoder : public AudioDecoder {
 
   AudioInfo audioInfo() override { return header.audioInfo(); }
 
+  /// Provides the frame aligned byte offset for the indicated play time:
+  /// only available after the header has been parsed
+  int64_t byteOffsetForTime(float seconds) override {
+    WAVAudioInfo &wi = header.audioInfo();
+    int byte_rate = wi.byte_rate;
+    if (byte_rate <= 0)
+      byte_rate = wi.sample_rate * wi.channels * wi.bits_per_sample / 8;
+    if (byte_rate <= 0 || seconds < 0.0f) return -1;
+    int64_t offset = static_cast<int64_t>(seconds * byte_rate);
+    int frame_size = wi.channels * wi.bits_per_sample / 8;
+    if (frame_size > 0) offset -= offset % frame_size;
+    return header.getDataPos() + offset;
+  }
+
   virtual size_t write(const uint8_t *data, size_t len) override {
     TRACED();
     size_t result = 0;
@@ -549,16 +563,21 @@ class WAVEncoder : public AudioEncoder {
   }
 
   /// starts the processing using the actual WAVAudioInfo
-  virtual bool begin() override { 
+  virtual bool begin() override {
     TRACED();
+    block_out.begin(p_print, write_buffer_size);
     setupEncodedAudio();
     header_written = false;
+    header_len = 0;
     is_open = true;
     return true;
   }
 
   /// stops the processing
-  void end() override { is_open = false; }
+  void end() override {
+    block_out.flushBlock();
+    is_open = false;
+  }
 
   /// Writes PCM data to be encoded as WAV
   virtual size_t write(const uint8_t *data, size_t len) override {
@@ -575,13 +594,14 @@ class WAVEncoder : public AudioEncoder {
     if (!header_written) {
       LOGI("Writing Header");
       header.setAudioInfo(audioInfo);
-      int len = header.writeHeader(p_print);
+      int len = header.writeHeader(&block_out);
       audioInfo.file_size -= len;
+      header_len = len + audioInfo.offset;
       header_written = true;
     }
 
     int32_t result = 0;
-    Print *p_out = p_encoder==nullptr ? p_print : &enc_out;;
+    Print *p_out = p_encoder==nullptr ? (Print*)&block_out : (Print*)&enc_out;
     if (audioInfo.is_streamed) {
       result = p_out->write((uint8_t *)data, len);
     } else if (size_limit > 0) {
@@ -604,20 +624,121 @@ class WAVEncoder : public AudioEncoder {
   /// Adds n empty bytes at the beginning of the data
   void setDataOffset(uint16_t offset) { audioInfo.offset = offset; }
 
+  /// Collects the output into sector aligned blocks of the indicated size
+  /// before writing, so that e.g. an SD card only sees full sector writes:
+  /// call before begin(); 0 deactivates the buffering
+  void setWriteBufferSize(int size = 4096) { write_buffer_size = size; }
+
+  /// Provides the number of data bytes which have been written after the
+  /// header
+  size_t dataBytesWritten() {
+    return block_out.total() > (size_t)header_len
+               ? block_out.total() - header_len
+               : 0;
+  }
+
+  /// Flushes the pending block and patches the RIFF and data chunk sizes
+  /// in the indicated (seekable) target file, so that a streamed recording
+  /// becomes a regular wav file: call once when the recording is done
+  template <class FileT>
+  bool finalize(FileT &file) {
+    TRACEI();
+    end();
+    size_t data_len = dataBytesWritten() + audioInfo.offset;
+    uint8_t size32[4];
+    // RIFF size = file length - 8
+    toLittleEndian32(36 + data_len, size32);
+    if (!file.seek(4)) return false;
+    if (file.write(size32, 4) != 4) return false;
+    // data chunk size
+    toLittleEndian32(data_len, size32);
+    if (!file.seek(40)) return false;
+    if (file.write(size32, 4) != 4) return false;
+    file.flush();
+    return true;
+  }
+
+  /// Pre-allocates the target file for the indicated number of seconds by
+  /// writing a byte at the end, so that the file system reserves the
+  /// clusters up front and the worst case allocation latency does not hit
+  /// the audio task: based on the pcm byte rate, so it is an upper bound
+  /// for compressed content
+  template <class FileT>
+  bool preAllocate(FileT &file, int seconds) {
+    TRACEI();
+    size_t bytes = 44 + audioInfo.offset +
+                   (size_t)audioInfo.byte_rate * (size_t)seconds;
+    if (!file.seek(bytes - 1)) return false;
+    uint8_t zero = 0;
+    if (file.write(&zero, 1) != 1) return false;
+    return file.seek(0);
+  }
+
  protected:
+  /// Print adapter which collects the data into full blocks before
+  /// forwarding it and keeps track of the total number of bytes
+  class BlockWriter : public Print {
+   public:
+    void begin(Print *out, int blockSize) {
+      p_out = out;
+      block_size = blockSize;
+      if (block_size > 0) buffer.resize(block_size);
+      total_bytes = 0;
+    }
+    size_t write(const uint8_t *data, size_t len) override {
+      if (p_out == nullptr) return 0;
+      if (block_size == 0) {
+        total_bytes += len;
+        return p_out->write(data, len);
+      }
+      size_t pos = 0;
+      while (pos < len) {
+        pos += buffer.writeArray(data + pos, len - pos);
+        if (buffer.isFull()) flushBlock();
+      }
+      total_bytes += len;
+      return len;
+    }
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    /// writes the partially filled block
+    void flushBlock() {
+      if (buffer.available() > 0) {
+        p_out->write(buffer.data(), buffer.available());
+        buffer.reset();
+      }
+    }
+    size_t total() { return total_bytes; }
+
+   protected:
+    Print *p_out = nullptr;
+    SingleBuffer<uint8_t> buffer{0};
+    int block_size = 0;
+    size_t total_bytes = 0;
+  };
+
   WAVHeader header;
   Print *p_print = nullptr; // final output  CopyEncoder copy; // used for PCM
   AudioEncoderExt *p_encoder = nullptr; 
   EncodedAudioOutput enc_out;
   WAVAudioInfo audioInfo = defaultConfig();
+  BlockWriter block_out;
+  int write_buffer_size = 0;
+  int header_len = 0;
   int64_t size_limit = 0;
   bool header_written = false;
   volatile bool is_open = false;
 
+  void toLittleEndian32(uint32_t value, uint8_t *result) {
+    result[0] = value & 0xFF;
+    result[1] = (value >> 8) & 0xFF;
+    result[2] = (value >> 16) & 0xFF;
+    result[3] = (value >> 24) & 0xFF;
+  }
+
   void setupEncodedAudio() {
     if (p_encoder!=nullptr){
       assert(p_print!=nullptr);
-      enc_out.setOutput(p_print);
+      enc_out.setOutput(&block_out);
       enc_out.setEncoder(p_encoder);
       enc_out.setAudioInfo(audioInfo);
       enc_out.begin();
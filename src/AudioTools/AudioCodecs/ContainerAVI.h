@@ -145,8 +145,128 @@ enum ParseState {
   ParseStrf,
   AfterStrf,
   ParseMovi,
+  ParseIdx1,
   ParseIgnore,
 };
+
+/**
+ * @brief Compact seek index built from the idx1 chunk of an AVI file: we
+ * keep one 32 bit offset per video frame and per audio chunk (relative to
+ * the 'movi' FOURCC like in the file) plus one packed keyframe bit per
+ * video frame. This makes seeking an O(1) table lookup instead of
+ * re-reading the file from the start. The ODML 'indx' super index is not
+ * supported.
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ */
+class AVIIndex {
+public:
+  void clear() {
+    video_offsets.resize(0);
+    audio_offsets.resize(0);
+    keyframe_bits.resize(0);
+    carry_len = 0;
+    movi_pos = 0;
+  }
+
+  /// Defines the file position of the 'movi' FOURCC: the idx1 offsets are
+  /// relative to it
+  void setMoviPos(size_t pos) { movi_pos = pos; }
+
+  /// Feeds idx1 chunk content: entries which cross the call boundary are
+  /// carried over to the next call
+  size_t write(const uint8_t *data, size_t len) {
+    size_t pos = 0;
+    if (carry_len > 0) {
+      int fill = min((int)(16 - carry_len), (int)len);
+      memcpy(carry + carry_len, data, fill);
+      carry_len += fill;
+      pos += fill;
+      if (carry_len == 16) {
+        addEntry(carry);
+        carry_len = 0;
+      }
+    }
+    while (pos + 16 <= len) {
+      addEntry(data + pos);
+      pos += 16;
+    }
+    if (pos < len) {
+      carry_len = len - pos;
+      memcpy(carry, data + pos, carry_len);
+    }
+    return len;
+  }
+
+  int videoFrameCount() { return video_offsets.size(); }
+
+  int audioChunkCount() { return audio_offsets.size(); }
+
+  /// Returns true if the index contains any entries
+  operator bool() { return videoFrameCount() > 0 || audioChunkCount() > 0; }
+
+  /// Provides the absolute file position of the chunk header for the
+  /// indicated video frame (-1 if not available)
+  int64_t videoFramePosition(int frame) {
+    if (frame < 0 || frame >= videoFrameCount())
+      return -1;
+    return (int64_t)movi_pos + video_offsets[frame];
+  }
+
+  /// Provides the absolute file position of the chunk header for the
+  /// indicated audio chunk (-1 if not available)
+  int64_t audioChunkPosition(int idx) {
+    if (idx < 0 || idx >= audioChunkCount())
+      return -1;
+    return (int64_t)movi_pos + audio_offsets[idx];
+  }
+
+  /// Checks the AVIIF_KEYFRAME flag of the indicated video frame
+  bool isKeyFrame(int frame) {
+    if (frame < 0 || frame >= videoFrameCount())
+      return false;
+    return (keyframe_bits[frame / 8] >> (frame % 8)) & 1;
+  }
+
+  /// Provides the closest keyframe at or before the indicated frame
+  int keyFrameBefore(int frame) {
+    if (frame >= videoFrameCount())
+      frame = videoFrameCount() - 1;
+    while (frame > 0 && !isKeyFrame(frame))
+      frame--;
+    return frame;
+  }
+
+protected:
+  Vector<uint32_t> video_offsets{0};
+  Vector<uint32_t> audio_offsets{0};
+  Vector<uint8_t> keyframe_bits{0};
+  uint8_t carry[16];
+  int carry_len = 0;
+  size_t movi_pos = 0;
+
+  // idx1 entry: FOURCC, dwFlags, dwOffset, dwSize
+  void addEntry(const uint8_t *entry) {
+    uint32_t flags = read32(entry + 4);
+    uint32_t offset = read32(entry + 8);
+    if (entry[2] == 'd' && (entry[3] == 'c' || entry[3] == 'b')) {
+      int frame = video_offsets.size();
+      video_offsets.push_back(offset);
+      if (frame / 8 >= (int)keyframe_bits.size())
+        keyframe_bits.push_back(0);
+      // AVIIF_KEYFRAME
+      if (flags & 0x10)
+        keyframe_bits[frame / 8] |= 1 << (frame % 8);
+    } else if (entry[2] == 'w' && entry[3] == 'b') {
+      audio_offsets.push_back(offset);
+    }
+  }
+
+  uint32_t read32(const uint8_t *data) {
+    return (uint32_t)data[0] | ((uint32_t)data[1] << 8) |
+           ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+  }
+};
 /***
  * @brief Represents a LIST or a CHUNK: The ParseObject represents the
  * current parsing result. We just keep position information and ids
@@ -277,6 +397,8 @@ public:
     header_is_avi = false;
     stream_header_idx = -1;
     is_metadata_ready = false;
+    avi_index.clear();
+    idx1_open = 0;
     return true;
   }
 
@@ -349,6 +471,41 @@ public:
   /// Replace the synchronization logic with your implementation
   void setVideoAudioSync(VideoAudioSync *yourSync) { p_synch = yourSync; }
 
+  /// Collect the idx1 chunk into a seek index: must be called before
+  /// feeding any data
+  void setBuildIndex(bool active) { is_build_index = active; }
+
+  /// Provides the seek index built from the idx1 chunk
+  AVIIndex &index() { return avi_index; }
+
+  /// Provides the absolute file position of the closest keyframe at or
+  /// before the indicated video frame and primes the parser to continue
+  /// with the chunk at this position: the caller must reposition the data
+  /// source accordingly. Returns -1 when no index is available.
+  int64_t seekToFrame(int frame) {
+    int key = avi_index.keyFrameBefore(frame);
+    int64_t pos = avi_index.videoFramePosition(key);
+    if (pos < 0) {
+      LOGE("seekToFrame: no index");
+      return -1;
+    }
+    parse_buffer.clear();
+    current_pos = pos;
+    open_subchunk_len = 0;
+    parse_state = SubChunk;
+    is_parsing_active = true;
+    return pos;
+  }
+
+  /// Provides the file position of the keyframe for the indicated play
+  /// time using the seek index (-1 if not available)
+  int64_t byteOffsetForTime(float seconds) override {
+    if (main_header.dwMicroSecPerFrame == 0)
+      return -1;
+    int frame = (int)(seconds * 1000000.0f / main_header.dwMicroSecPerFrame);
+    return avi_index.videoFramePosition(avi_index.keyFrameBefore(frame));
+  }
+
 protected:
   bool header_is_avi = false;
   bool is_parsing_active = true;
@@ -378,6 +535,9 @@ protected:
   int video_seconds = 0;
   VideoAudioSync defaultSynch;
   VideoAudioSync *p_synch = &defaultSynch;
+  AVIIndex avi_index;
+  bool is_build_index = false;
+  long idx1_open = 0;
 
   bool isCurrentStreamAudio() {
     return strncmp(stream_header[stream_header_idx].fccType, "auds", 4) == 0;
@@ -471,6 +631,8 @@ protected:
     case ParseMovi: {
       ParseObject movi = tryParseList();
       if (StrView(movi.id()).equals("movi")) {
+        // the idx1 offsets are relative to the 'movi' FOURCC
+        avi_index.setMoviPos(current_pos + 8);
         consume(LIST_HEADER_SIZE);
         is_metadata_ready = true;
         if (validation_cb)
@@ -515,7 +677,11 @@ protected:
           uint32_t time_used_ms = p_output_video->endFrame();
           p_synch->delayVideoFrame(main_header.dwMicroSecPerFrame, time_used_ms);
         }
-        if (tryParseChunk("idx").isValid()) {
+        if (is_build_index && tryParseChunk("idx1").isValid()) {
+          idx1_open = getInt(4);
+          consume(CHUNK_HEADER_SIZE);
+          parse_state = ParseIdx1;
+        } else if (tryParseChunk("idx").isValid()) {
           parse_state = ParseIgnore;
         } else if (tryParseList("rec").isValid()) {
           parse_state = ParseRec;
@@ -529,6 +695,23 @@ protected:
       }
     } break;
 
+    case ParseIdx1: {
+      // collect the index entries which provide the seek offsets
+      long to_consume = min((long)parse_buffer.available(), idx1_open);
+      if (to_consume > 0) {
+        avi_index.write(parse_buffer.data(), to_consume);
+        idx1_open -= to_consume;
+        consume(to_consume);
+      } else {
+        result = false;
+      }
+      if (idx1_open == 0) {
+        LOGI("idx1: %d video frames / %d audio chunks",
+             avi_index.videoFrameCount(), avi_index.audioChunkCount());
+        parse_state = ParseIgnore;
+      }
+    } break;
+
     case ParseIgnore: {
       LOGD("ParseIgnore");
       parse_buffer.clear();
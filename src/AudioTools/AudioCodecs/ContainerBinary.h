@@ -75,6 +75,93 @@ static uint8_t checkSum(const uint8_t *data, size_t len) {
 /// @brief Error types
 enum BinaryContainerEncoderError { InvalidHeader, InvalidChecksum, DataMissing};
 
+/**
+ * @brief View on a single record inside an externally owned buffer: a copy
+ * of the header plus a pointer into the buffer - the payload itself is not
+ * copied.
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ */
+struct BinaryRecordView {
+  CommonHeader header;
+  const uint8_t *payload = nullptr;
+
+  ContainerType type() const { return header.type; }
+
+  /// payload length in bytes (without the header)
+  int size() const {
+    // the config record stores the payload size, the other records include
+    // the header in their len field
+    return header.type == ContainerType::Header
+               ? header.len
+               : header.len - (int)sizeof(CommonHeader);
+  }
+
+  /// record length including the header
+  int totalSize() const { return (int)sizeof(CommonHeader) + size(); }
+
+  /// verifies the payload against the header checksum
+  bool isChecksumValid() const {
+    return header.type != ContainerType::Audio ||
+           header.checksum == checkSum(payload, size());
+  }
+};
+
+/**
+ * @brief Iterates the records of the binary container format directly over
+ * a receive buffer: next() yields (header, payload) views without copying
+ * any data. offset() reports how many bytes have been consumed, so that an
+ * incomplete record at the tail can be carried over to the next buffer.
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ */
+class BinaryContainerIterator {
+public:
+  /// Defines the buffer to iterate
+  void begin(const uint8_t *data, size_t len) {
+    p_data = data;
+    data_len = len;
+    pos = 0;
+  }
+
+  /// Provides a view on the next complete record: returns false when the
+  /// buffer holds no further complete record
+  bool next(BinaryRecordView &view) {
+    while (data_len - pos >= sizeof(CommonHeader)) {
+      const uint8_t *rec = p_data + pos;
+      if (rec[0] != '\r' || rec[1] != '\n') {
+        // resynchronize on the record separator
+        pos++;
+        continue;
+      }
+      memcpy(&view.header, rec, sizeof(CommonHeader));
+      if (!isValidType(view.header.type) || view.size() < 0) {
+        pos += 2;
+        continue;
+      }
+      if (data_len - pos < (size_t)view.totalSize()) return false;
+      view.payload = rec + sizeof(CommonHeader);
+      pos += view.totalSize();
+      return true;
+    }
+    return false;
+  }
+
+  /// Number of consumed bytes: the data after this offset belongs to an
+  /// incomplete record and must be offered again
+  size_t offset() const { return pos; }
+
+protected:
+  const uint8_t *p_data = nullptr;
+  size_t data_len = 0;
+  size_t pos = 0;
+
+  bool isValidType(ContainerType type) {
+    return type == ContainerType::Header || type == ContainerType::Audio ||
+           type == ContainerType::Meta;
+  }
+};
+
 /**
  * @brief Wraps the encoded data into Config, Data, and Meta segments so that we
  * can recover the audio configuration and orignial segments if this is
@@ -116,14 +203,25 @@ public:
 
   AudioInfo audioInfo() override { return cfg.info; }
 
+  /// Collects the indicated number of records and sends them with a single
+  /// output write (e.g. to pack several records into one ESP-NOW datagram).
+  /// The default of 1 writes each record out directly.
+  void setBatchCount(int count) { batch_count = count; }
+
+  /// Sends out any collected records of an open batch
+  void flush() {
+    if (batch.available() > 0) {
+      output(batch.data(), batch.available());
+      batch.reset();
+      batch_records = 0;
+    }
+  }
+
   /// Adds meta data segment
   size_t writeMeta(const uint8_t *data, size_t len) {
     LOGD("BinaryContainerEncoder::writeMeta: %d", (int)len);
     meta.common.len = len + sizeof(SimpleContainerMetaDataHeader);
-    uint8_t tmp_array[meta.common.len];
-    memcpy(tmp_array, &meta, sizeof(meta));
-    memcpy(tmp_array + sizeof(meta), data, len);
-    output(tmp_array, meta.common.len);
+    outputRecord((uint8_t *)&meta, sizeof(meta), data, len);
     return len;
   }
 
@@ -138,7 +236,10 @@ public:
     return len;
   }
 
-  void end() { p_codec->end(); }
+  void end() {
+    flush();
+    p_codec->end();
+  }
 
   operator bool() { return true; };
 
@@ -153,6 +254,9 @@ protected:
   SimpleContainerMetaDataHeader meta;
   AudioEncoder *p_codec = nullptr;
   Print *p_out = nullptr;
+  SingleBuffer<uint8_t> batch{0};
+  int batch_count = 1;
+  int batch_records = 0;
 
   void writeAudio(const uint8_t *data, size_t len) {
     LOGD("writeAudio: %d", (int)len);
@@ -163,18 +267,34 @@ protected:
     p_codec->setOutput(tmp);
     p_codec->write(data, len);
 
-    // output of audio data header
+    // output of audio data header and data
     dh.common.len = tmp.available() + sizeof(CommonHeader);
     dh.common.checksum = checkSum(tmp_buffer.data(), tmp_buffer.available());
-    output((uint8_t *)&dh, sizeof(dh));
-
-    // output of data
-    output(tmp_buffer.data(), tmp_buffer.available());
+    outputRecord((uint8_t *)&dh, sizeof(dh), tmp_buffer.data(),
+                 tmp_buffer.available());
   }
 
   void writeHeader() {
     LOGD("writeHeader");
-    output((uint8_t *)&cfg, sizeof(cfg));
+    outputRecord((uint8_t *)&cfg, sizeof(cfg), nullptr, 0);
+  }
+
+  /// emits one record: the header and payload are written out directly from
+  /// their buffers, or collected when batching is active
+  void outputRecord(const uint8_t *hdr, size_t hdr_len, const uint8_t *payload,
+                    size_t payload_len) {
+    if (batch_count > 1) {
+      int total = hdr_len + payload_len;
+      if (batch.availableForWrite() < total) {
+        batch.resize(batch.available() + total);
+      }
+      batch.writeArray(hdr, hdr_len);
+      if (payload_len > 0) batch.writeArray(payload, payload_len);
+      if (++batch_records >= batch_count) flush();
+    } else {
+      output(hdr, hdr_len);
+      if (payload_len > 0) output(payload, payload_len);
+    }
   }
 
   size_t output(const uint8_t *data, size_t len) {
@@ -227,16 +347,31 @@ public:
   size_t write(const uint8_t *data, size_t len) {
     LOGD("write: %d", (int)len);
     uint8_t *data8 = (uint8_t *)data;
-    if (buffer.size() < len) {
+    size_t consumed = 0;
+
+    // fast path: when no partial record is buffered we iterate the record
+    // views directly over the caller buffer without copying
+    if (is_zero_copy && buffer.available() == 0) {
+      BinaryRecordView view;
+      BinaryContainerIterator it;
+      it.begin(data8, len);
+      while (it.next(view)) processRecord(view);
+      consumed = it.offset();
+      if (consumed == len) return len;
+    }
+
+    // buffer the incomplete tail (or everything when the fast path is off)
+    size_t open = len - consumed;
+    if (buffer.size() < open) {
       buffer.resize(
           std::max(static_cast<int>(DEFAULT_BUFFER_SIZE + header_size),
-                   static_cast<int>(len * 4 + header_size)));
+                   static_cast<int>(open * 4 + header_size)));
     }
 
-    size_t result = buffer.writeArray(data8, len);
+    size_t result = buffer.writeArray(data8 + consumed, open);
     while (parseBuffer())
       ;
-    return ignore_write_errors ? len : result;
+    return ignore_write_errors ? len : result + consumed;
   }
 
   operator bool() { return true; };
@@ -255,6 +390,12 @@ public:
     reference = ref;
   }
 
+  /// If set to false each write is copied into the internal buffer before
+  /// parsing, like in the old implementation (default is true)
+  void setZeroCopy(bool flag){
+    is_zero_copy = flag;
+  }
+
 protected:
   bool is_first = true;
   CommonHeader header;
@@ -265,8 +406,57 @@ protected:
   void (*meta_callback)(uint8_t* data, int len, void* ref) = nullptr;
   void (*error_handler)(BinaryContainerEncoderError error, BinaryContainerDecoder* source, void* ref) = nullptr;
   bool ignore_write_errors = true;
+  bool is_zero_copy = true;
   void * reference = nullptr;
 
+  /// processes one record view in place: the payload stays in the caller
+  /// buffer
+  void processRecord(const BinaryRecordView &view) {
+    header = view.header;
+    switch (view.type()) {
+    case ContainerType::Header: {
+      LOGD("Header");
+      if (view.size() < (int)sizeof(AudioInfo)) break;
+      memcpy(&info, view.payload, sizeof(AudioInfo));
+      notifyAudioChange(info);
+      info.logInfo();
+      p_codec->setAudioInfo(info);
+      p_codec->begin();
+    } break;
+
+    case ContainerType::Audio: {
+      LOGD("Audio");
+      if (view.isChecksumValid()) {
+        decodeAudio(view.payload, view.size());
+      } else {
+        LOGW("invalid checksum");
+        if (error_handler) error_handler(InvalidChecksum, this, reference);
+      }
+    } break;
+
+    case ContainerType::Meta: {
+      LOGD("Meta");
+      if (meta_callback != nullptr) {
+        meta_callback((uint8_t *)view.payload, view.size(), reference);
+      }
+    } break;
+
+    default:
+      break;
+    }
+  }
+
+  /// decodes the audio payload: the decoder writes its result directly to
+  /// the defined output
+  void decodeAudio(const uint8_t *data, int len) {
+    if (p_out == nullptr) {
+      LOGW("output not defined");
+      return;
+    }
+    p_codec->setOutput(*p_out);
+    p_codec->write(data, len);
+  }
+
 
   bool parseBuffer() {
     LOGD("parseBuffer");
@@ -332,15 +522,8 @@ protected:
       int data_len = header.len - header_size;
       uint8_t crc = checkSum(buffer.data(), data_len);
       if (header.checksum == crc) {
-        // decode
-        SingleBuffer<uint8_t> tmp_buffer{data_len * 5};
-        QueueStream<uint8_t> tmp{tmp_buffer};
-        tmp.begin();
-        p_codec->setOutput(tmp);
-        p_codec->write(buffer.data(), data_len);
-
-        // output decoded data
-        output(tmp_buffer.data(), tmp_buffer.available());
+        // decode straight out of the buffer
+        decodeAudio(buffer.data(), data_len);
         buffer.clearArray(data_len);
       } else {
         LOGW("invalid checksum");
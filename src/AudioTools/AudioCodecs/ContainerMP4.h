@@ -84,6 +84,150 @@ struct MP4Atom {
   }
 };
 
+/**
+ * @brief Compact in-RAM sample index for MPEG4 audio built from the stsc,
+ * stsz and stco sample tables during the regular parse pass: afterwards
+ * any sample can be located with an O(1) chunk lookup (plus a short scan
+ * inside the chunk), so that seeking does not need to re-walk the sample
+ * tables. A uniform sample size (stsz with fixed size) needs no table at
+ * all. Limitations: only 32 bit chunk offsets (stco, no co64) and tables
+ * which fit into the parse buffer are supported.
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ */
+class MP4SampleIndex {
+ public:
+  struct SampleLocation {
+    uint32_t file_offset = 0;
+    uint32_t size = 0;
+  };
+
+  void clear() {
+    uniform_size = 0;
+    sample_count = 0;
+    sample_sizes.resize(0);
+    chunk_offsets.resize(0);
+    stsc_first_chunk.resize(0);
+    stsc_samples.resize(0);
+  }
+
+  /// Collects the relevant sample tables from the parsed atom
+  void parse(MP4Atom &atom) {
+    if (atom.data == nullptr) return;
+    if (atom.is("stsz"))
+      parseStsz(atom);
+    else if (atom.is("stco"))
+      parseStco(atom);
+    else if (atom.is("stsc"))
+      parseStsc(atom);
+  }
+
+  /// Returns true when all three sample tables have been collected
+  bool isComplete() {
+    return sample_count > 0 && chunk_offsets.size() > 0 &&
+           stsc_first_chunk.size() > 0;
+  }
+
+  operator bool() { return isComplete(); }
+
+  /// Number of (encoded) samples in the track
+  uint32_t sampleCount() { return sample_count; }
+
+  /// Locates the indicated sample: provides the absolute file offset and
+  /// the sample size
+  bool locate(uint32_t sample, SampleLocation &result) {
+    if (!isComplete() || sample >= sample_count) return false;
+    uint32_t chunk = 0, first_in_chunk = 0;
+    if (!chunkOf(sample, chunk, first_in_chunk)) return false;
+    if (chunk >= (uint32_t)chunk_offsets.size()) return false;
+    uint32_t offset = chunk_offsets[chunk];
+    for (uint32_t s = first_in_chunk; s < sample; s++) offset += sizeOf(s);
+    result.file_offset = offset;
+    result.size = sizeOf(sample);
+    return true;
+  }
+
+ protected:
+  uint32_t uniform_size = 0;
+  uint32_t sample_count = 0;
+  Vector<uint32_t> sample_sizes{0};
+  Vector<uint32_t> chunk_offsets{0};
+  Vector<uint32_t> stsc_first_chunk{0};
+  Vector<uint32_t> stsc_samples{0};
+
+  uint32_t sizeOf(uint32_t sample) {
+    return uniform_size != 0 ? uniform_size : sample_sizes[sample];
+  }
+
+  /// Determines the chunk which holds the sample: O(1) for the usual case
+  /// of a single stsc run
+  bool chunkOf(uint32_t sample, uint32_t &chunk, uint32_t &first_in_chunk) {
+    uint32_t acc = 0;
+    int entries = stsc_first_chunk.size();
+    for (int e = 0; e < entries; e++) {
+      uint32_t spc = stsc_samples[e];
+      if (spc == 0) return false;
+      uint32_t chunk_start = stsc_first_chunk[e] - 1;
+      uint32_t chunk_end = e + 1 < entries ? stsc_first_chunk[e + 1] - 1
+                                           : chunk_offsets.size();
+      uint32_t run_samples = (chunk_end - chunk_start) * spc;
+      if (sample < acc + run_samples) {
+        uint32_t rel = (sample - acc) / spc;
+        chunk = chunk_start + rel;
+        first_in_chunk = acc + rel * spc;
+        return true;
+      }
+      acc += run_samples;
+    }
+    return false;
+  }
+
+  void parseStsz(MP4Atom &atom) {
+    uniform_size = atom.read32(4);
+    sample_count = atom.read32(8);
+    if (uniform_size == 0) {
+      if (atom.data_size < (int)(12 + 4 * sample_count)) {
+        LOGE("stsz truncated: %d", atom.data_size);
+        sample_count = 0;
+        return;
+      }
+      sample_sizes.resize(sample_count);
+      for (uint32_t j = 0; j < sample_count; j++) {
+        sample_sizes[j] = atom.read32(12 + 4 * j);
+      }
+    }
+    LOGI("stsz: %u samples", (unsigned)sample_count);
+  }
+
+  void parseStco(MP4Atom &atom) {
+    uint32_t count = atom.read32(4);
+    if (atom.data_size < (int)(8 + 4 * count)) {
+      LOGE("stco truncated: %d", atom.data_size);
+      return;
+    }
+    chunk_offsets.resize(count);
+    for (uint32_t j = 0; j < count; j++) {
+      chunk_offsets[j] = atom.read32(8 + 4 * j);
+    }
+    LOGI("stco: %u chunks", (unsigned)count);
+  }
+
+  void parseStsc(MP4Atom &atom) {
+    uint32_t count = atom.read32(4);
+    if (atom.data_size < (int)(8 + 12 * count)) {
+      LOGE("stsc truncated: %d", atom.data_size);
+      return;
+    }
+    stsc_first_chunk.resize(count);
+    stsc_samples.resize(count);
+    for (uint32_t j = 0; j < count; j++) {
+      stsc_first_chunk[j] = atom.read32(8 + 12 * j);
+      stsc_samples[j] = atom.read32(8 + 12 * j + 4);
+    }
+    LOGI("stsc: %u entries", (unsigned)count);
+  }
+};
+
 /***
  * @brief Buffer which is used for parsing the mpeg4 data
  * @author Phil Schatzmann
@@ -215,9 +359,31 @@ class ContainerMP4 : public ContainerDecoder {
   /// Defines the maximum size that we can submit to the decoder
   void setMaxSize(int size) { max_size = size; }
 
-  /// Provides the maximum size 
+  /// Provides the maximum size
   int maxSize() { return max_size; }
 
+  /// Activates the collection of the sample index from the stsc, stsz and
+  /// stco tables while the header is parsed: call before begin()
+  void setBuildSampleIndex(bool active) { is_build_index = active; }
+
+  /// Provides the collected sample index (complete after the moov atom has
+  /// been processed)
+  MP4SampleIndex &sampleIndex() { return sample_index; }
+
+  /// Defines the number of pcm frames per encoded sample: 1024 for AAC
+  void setSamplesPerFrame(int samples) { samples_per_frame = samples; }
+
+  /// Provides the file offset for the indicated play time from the sample
+  /// index: only available when setBuildSampleIndex(true) was active
+  int64_t byteOffsetForTime(float seconds) override {
+    if (!sample_index || info.sample_rate == 0 || seconds < 0.0f) return -1;
+    uint32_t sample =
+        (uint32_t)(seconds * info.sample_rate / samples_per_frame);
+    MP4SampleIndex::SampleLocation loc;
+    if (!sample_index.locate(sample, loc)) return -1;
+    return loc.file_offset;
+  }
+
  protected:
   int max_size;
   MP4ParseBuffer buffer{this};
@@ -227,6 +393,9 @@ class ContainerMP4 : public ContainerDecoder {
   AACDecoderHelix aac_decoder;
   AudioDecoder* p_decoder = &aac_decoder;
   const char *stream_atom;
+  MP4SampleIndex sample_index;
+  bool is_build_index = false;
+  int samples_per_frame = 1024;
   int current_pos = 0;
   const char *current_atom = nullptr;
   void (*data_callback)(MP4Atom &atom,
@@ -242,6 +411,11 @@ class ContainerMP4 : public ContainerDecoder {
   /// Defines the size of open data that will be written directly w/o parsing
   void setStreamOutputSize(int size) { stream_out_open = size; }
 
+  /// Feeds the complete sample table atoms into the sample index
+  void collectSampleIndex(MP4Atom &atom) {
+    if (is_build_index && !atom.is_stream) sample_index.parse(atom);
+  }
+
   /// Default logic to determine if a atom is a header
   static bool default_is_header_callback(MP4Atom *atom, const uint8_t *data) {
     // it is a header atom when the next atom just follows it
@@ -386,6 +560,7 @@ MP4Atom MP4ParseBuffer::parse() {
   }
 
   // callback for data
+  if (result) container->collectSampleIndex(result);
   if (result && container->data_callback != nullptr)
     container->data_callback(result, *container);
 
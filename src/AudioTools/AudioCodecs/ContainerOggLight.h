@@ -0,0 +1,289 @@
+#pragma once
+
+#include "AudioTools/AudioCodecs/AudioCodecsBase.h"
+#include "AudioTools/CoreAudio/Buffers.h"
+
+#define OGG_LIGHT_BUFFER_SIZE (16 * 1024)
+
+namespace audio_tools {
+
+/// Defines when OggLightContainerDecoder verifies the page crc: on every
+/// page, only after a (re)synchronization or never
+enum class OggVerifyMode { Always, OnResync, Never };
+
+/**
+ * @brief CRC32 with the Ogg page polynomial (0x04C11DB7, not reflected,
+ * initial value and final xor 0) using a table driven slice by 4 kernel:
+ * 4 bytes are folded per iteration with one table read each, which is
+ * several times faster than the bit by bit or single table version. The
+ * 4 KB of tables are shared and filled once at first use.
+ * @ingroup codecs
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ */
+class OggCRC32 {
+ public:
+  static OggCRC32 &instance() {
+    static OggCRC32 self;
+    return self;
+  }
+
+  /// Updates the crc with the indicated data
+  uint32_t update(uint32_t crc, const uint8_t *data, size_t len) {
+    while (len >= 4) {
+      crc = t[3][((crc >> 24) ^ data[0]) & 0xFF] ^
+            t[2][((crc >> 16) ^ data[1]) & 0xFF] ^
+            t[1][((crc >> 8) ^ data[2]) & 0xFF] ^
+            t[0][(crc ^ data[3]) & 0xFF];
+      data += 4;
+      len -= 4;
+    }
+    while (len-- > 0) {
+      crc = (crc << 8) ^ t[0][((crc >> 24) ^ *data++) & 0xFF];
+    }
+    return crc;
+  }
+
+ protected:
+  uint32_t t[4][256];
+
+  OggCRC32() {
+    for (int b = 0; b < 256; b++) {
+      uint32_t r = (uint32_t)b << 24;
+      for (int j = 0; j < 8; j++) {
+        r = (r & 0x80000000) ? (r << 1) ^ 0x04C11DB7 : r << 1;
+      }
+      t[0][b] = r;
+    }
+    for (int k = 1; k < 4; k++) {
+      for (int b = 0; b < 256; b++) {
+        t[k][b] = (t[k - 1][b] << 8) ^ t[0][(t[k - 1][b] >> 24) & 0xFF];
+      }
+    }
+  }
+};
+
+/**
+ * @brief Lean decoder for an Ogg container which walks the pages with an
+ * in-tree parser instead of liboggz: the packet payloads are assembled
+ * from the lacing table and forwarded to the wrapped decoder. The page
+ * crc verification is a policy (setVerifyMode): Always for untrusted
+ * streams, OnResync to only check while synchronizing (e.g. after a seek)
+ * or Never for trusted local files where the per page CRC32 is wasted
+ * CPU. The begin segment is expected to contain the AudioInfo structure
+ * like with OggContainerDecoder; subclass and overwrite beginOfSegment()
+ * for your own headers. Pages must fit into the write buffer
+ * (resizeBuffer, default 16 KB).
+ * @ingroup codecs
+ * @ingroup decoder
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ */
+class OggLightContainerDecoder : public ContainerDecoder {
+ public:
+  OggLightContainerDecoder() {
+    p_codec = &dec_copy;
+  }
+
+  OggLightContainerDecoder(AudioDecoder &decoder) { setDecoder(&decoder); }
+
+  void setDecoder(AudioDecoder *decoder) { p_codec = decoder; }
+
+  /// Defines the output Stream
+  void setOutput(Print &print) override {
+    p_print = &print;
+    if (p_codec != nullptr) p_codec->setOutput(print);
+  }
+
+  /// Defines when the page crc is verified (default is Always)
+  void setVerifyMode(OggVerifyMode mode) { verify_mode = mode; }
+
+  /// Set a new write buffer size (default is 16384): must be able to hold
+  /// a complete page
+  void resizeBuffer(int size) { buffer_size = size; }
+
+  bool begin() override {
+    TRACED();
+    buffer.resize(buffer_size);
+    buffer.reset();
+    packet.resize(0);
+    is_resync = true;
+    is_first_packet = true;
+    if (p_codec != nullptr) {
+      if (p_print != nullptr) p_codec->setOutput(*p_print);
+      p_codec->begin();
+    }
+    is_active = true;
+    return true;
+  }
+
+  void end() override {
+    TRACED();
+    if (p_codec != nullptr) p_codec->end();
+    is_active = false;
+  }
+
+  virtual operator bool() override { return is_active; }
+
+  size_t write(const uint8_t *data, size_t len) override {
+    LOGD("write: %d", (int)len);
+    if (!is_active) return 0;
+    size_t pos = 0;
+    while (pos < len) {
+      pos += buffer.writeArray((uint8_t *)data + pos, len - pos);
+      bool progress = parsePages();
+      if (!progress && buffer.availableForWrite() == 0) {
+        LOGE("page does not fit into buffer: use resizeBuffer()");
+        is_resync = true;
+        buffer.clearArray(buffer.available() - 3);
+      }
+    }
+    return len;
+  }
+
+ protected:
+  CopyDecoder dec_copy;
+  AudioDecoder *p_codec = nullptr;
+  SingleBuffer<uint8_t> buffer{0};
+  Vector<uint8_t> packet{0};
+  int buffer_size = OGG_LIGHT_BUFFER_SIZE;
+  OggVerifyMode verify_mode = OggVerifyMode::Always;
+  bool is_resync = true;
+  bool is_first_packet = true;
+  bool is_active = false;
+
+  /// Parses all complete pages in the buffer: returns true if at least one
+  /// page (or skipped junk) has been consumed
+  bool parsePages() {
+    bool result = false;
+    while (parseOnePage()) result = true;
+    return result;
+  }
+
+  bool parseOnePage() {
+    int avail = buffer.available();
+    if (avail < 27) return false;
+    uint8_t *page = buffer.data();
+    if (memcmp(page, "OggS", 4) != 0) {
+      // drop data up to the next capture pattern
+      is_resync = true;
+      int sync = findCapturePattern(page + 1, avail - 1);
+      buffer.clearArray(sync >= 0 ? sync + 1 : avail - 3);
+      return true;
+    }
+    int nseg = page[26];
+    int header_len = 27 + nseg;
+    if (avail < header_len) return false;
+    int body_len = 0;
+    for (int j = 0; j < nseg; j++) body_len += page[27 + j];
+    if (avail < header_len + body_len) return false;
+
+    if (shouldVerify() && !checkCRC(page, header_len, body_len)) {
+      LOGE("ogg page crc error");
+      is_resync = true;
+      // skip the capture pattern and resynchronize
+      buffer.clearArray(4);
+      return true;
+    }
+
+    processPage(page, header_len, body_len);
+    is_resync = false;
+    buffer.clearArray(header_len + body_len);
+    return true;
+  }
+
+  int findCapturePattern(uint8_t *data, int len) {
+    for (int j = 0; j + 4 <= len; j++) {
+      if (data[j] == 'O' && data[j + 1] == 'g' && data[j + 2] == 'g' &&
+          data[j + 3] == 'S')
+        return j;
+    }
+    return -1;
+  }
+
+  bool shouldVerify() {
+    switch (verify_mode) {
+      case OggVerifyMode::Always:
+        return true;
+      case OggVerifyMode::OnResync:
+        return is_resync;
+      default:
+        return false;
+    }
+  }
+
+  /// The page crc is computed with the crc field itself set to 0
+  bool checkCRC(uint8_t *page, int header_len, int body_len) {
+    uint32_t stored = (uint32_t)page[22] | ((uint32_t)page[23] << 8) |
+                      ((uint32_t)page[24] << 16) | ((uint32_t)page[25] << 24);
+    OggCRC32 &crc = OggCRC32::instance();
+    uint8_t zero[4] = {0};
+    uint32_t c = crc.update(0, page, 22);
+    c = crc.update(c, zero, 4);
+    c = crc.update(c, page + 26, header_len - 26 + body_len);
+    return c == stored;
+  }
+
+  /// Assembles the packets from the lacing table and processes each
+  /// completed packet
+  void processPage(uint8_t *page, int header_len, int body_len) {
+    uint8_t header_type = page[5];
+    bool eos = (header_type & 0x04) != 0;
+    uint8_t *body = page + header_len;
+    int nseg = page[26];
+    int pos = 0;
+    for (int j = 0; j < nseg; j++) {
+      int seg = page[27 + j];
+      int old_size = packet.size();
+      packet.resize(old_size + seg);
+      if (seg > 0) memcpy(&packet[old_size], body + pos, seg);
+      pos += seg;
+      if (seg < 255) {
+        processPacket(eos && j == nseg - 1);
+        packet.resize(0);
+      }
+    }
+  }
+
+  void processPacket(bool eos) {
+    int len = packet.size();
+    if (is_first_packet) {
+      is_first_packet = false;
+      beginOfSegment(packet.data(), len);
+    } else if (eos && len == 0) {
+      endOfSegment();
+    } else if (len >= 8 && memcmp(packet.data(), "OpusTags", 8) == 0) {
+      LOGD("OpusTags");
+    } else if (p_codec != nullptr && len > 0) {
+      LOGD("process audio packet");
+      int eff = p_codec->write(packet.data(), len);
+      if (eff != len) {
+        LOGE("Incomplete write");
+      }
+    }
+  }
+
+  virtual void beginOfSegment(const uint8_t *data, int len) {
+    LOGD("bos");
+    if (len == sizeof(AudioInfo)) {
+      AudioInfo cfg(*(AudioInfo *)data);
+      cfg.logInfo();
+      if (cfg.bits_per_sample == 16 || cfg.bits_per_sample == 24 ||
+          cfg.bits_per_sample == 32) {
+        setAudioInfo(cfg);
+        if (p_codec != nullptr) p_codec->setAudioInfo(cfg);
+      } else {
+        LOGE("Invalid AudioInfo")
+      }
+    } else {
+      LOGE("Invalid Header")
+    }
+  }
+
+  virtual void endOfSegment() {
+    // end segment not supported
+    LOGW("e_o_s");
+  }
+};
+
+}  // namespace audio_tools
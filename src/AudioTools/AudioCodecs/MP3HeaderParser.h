@@ -282,6 +282,18 @@ class MP3HeaderParser {
     return fileSizeBytes / bitrate;
   }
 
+  /// Provides the estimated byte offset for the indicated playing time in
+  /// seconds: frame index based using the bitrate of the parsed header, so
+  /// it is exact for CBR files and an approximation for VBR
+  int64_t getByteOffsetForTime(float seconds) {
+    int bitrate = getBitRate();
+    int frame_len = getFrameLength();
+    if (bitrate <= 0 || frame_len <= 0 || seconds < 0.0f) return -1;
+    int64_t offset = static_cast<int64_t>(seconds * (bitrate / 8));
+    // snap to the start of a frame
+    return (offset / frame_len) * frame_len;
+  }
+
   const char* getVersionStr() const {
     return header.AudioVersion == FrameHeader::AudioVersionID::MPEG_1   ? "1"
            : header.AudioVersion == FrameHeader::AudioVersionID::MPEG_2 ? "2"
@@ -300,6 +312,17 @@ class MP3HeaderParser {
   // provides the parsed MP3 frame header
   FrameHeader getFrameHeader() { return header; }
 
+  /// Parses the frame header at the indicated position (which must start
+  /// with a sync word) and provides the expected frame length in bytes:
+  /// 0 if the header is not valid
+  int parseFrameLength(const uint8_t* data, size_t len) {
+    if (len < FrameHeader::SERIALIZED_SIZE) return 0;
+    if (data[0] != 0xFF || (data[1] & 0b11100000) != 0b11100000) return 0;
+    memcpy(&header, data, sizeof(header));
+    if (validateFrameHeader(header) != FrameReason::VALID) return 0;
+    return getFrameLength();
+  }
+
   /// Finds the mp3/aac sync word
   int findSyncWord(const uint8_t* buf, size_t nBytes, uint8_t synch = 0xFF,
                    uint8_t syncl = 0xF0) {
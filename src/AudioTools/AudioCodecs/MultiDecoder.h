@@ -33,12 +33,7 @@ class MultiDecoder : public AudioDecoder {
 
   /// closes the actual decoder
   void end() override {
-    if (actual_decoder.decoder != nullptr && actual_decoder.is_open) {
-      actual_decoder.decoder->end();
-    }
-    actual_decoder.is_open = false;
-    actual_decoder.decoder = nullptr;
-    actual_decoder.mime = nullptr;
+    closeActualDecoder();
     is_first = true;
   }
 
@@ -46,6 +41,8 @@ class MultiDecoder : public AudioDecoder {
   void addDecoder(AudioDecoder& decoder, const char* mime) {
     DecoderInfo info{mime, &decoder};
     decoder.addNotifyAudioChange(*this);
+    // avoid a reallocation per added decoder
+    if (decoders.capacity() == 0) decoders.reserve(8);
     decoders.push_back(info);
   }
 
@@ -67,6 +64,23 @@ class MultiDecoder : public AudioDecoder {
   /// Defines url stream from which we determine the mime type from the reply header
   void setMimeSource(AbstractURLStream& url) { p_url_stream = &url; }
 
+  /// Keeps the registered decoders initialized across decoder switches, so
+  /// that switching back does not need to reallocate the codec buffers
+  void setKeepOpen(bool flag) { is_keep_open = flag; }
+
+  /// Pre-initializes the decoder for the indicated mime type while the
+  /// actual decoder is still draining, so that a subsequent switch finds
+  /// the codec already set up (warm handoff)
+  bool preselectDecoder(const char* mime) {
+    for (int j = 0; j < decoders.size(); j++) {
+      if (StrView(decoders[j].mime).equals(mime)) {
+        openDecoder(decoders[j]);
+        return true;
+      }
+    }
+    return false;
+  }
+
   /// selects the actual decoder by mime type - this is usually called
   /// automatically from the determined mime type
   bool selectDecoder(const char* mime) {
@@ -77,20 +91,14 @@ class MultiDecoder : public AudioDecoder {
       return true;
     }
     // close actual decoder
-    end();
+    closeActualDecoder();
 
     // find the corresponding decoder
     for (int j = 0; j < decoders.size(); j++) {
-      DecoderInfo info = decoders[j];
-      if (StrView(info.mime).equals(mime)) {
-        LOGI("New decoder found for %s (%s)", info.mime, mime);
-        actual_decoder = info;
-        // define output if it has not been defined
-        if (p_print != nullptr &&
-            actual_decoder.decoder->getOutput() == nullptr) {
-          actual_decoder.decoder->setOutput(*p_print);
-        }
-        actual_decoder.decoder->begin();
+      if (StrView(decoders[j].mime).equals(mime)) {
+        LOGI("New decoder found for %s (%s)", decoders[j].mime, mime);
+        openDecoder(decoders[j]);
+        actual_decoder = decoders[j];
         result = true;
       }
     }
@@ -149,6 +157,40 @@ class MultiDecoder : public AudioDecoder {
   CodecNOP nop;
   AbstractURLStream* p_url_stream = nullptr;
   bool is_first = true;
+  bool is_keep_open = false;
+
+  /// Starts the decoder if it is not already open
+  void openDecoder(DecoderInfo& info) {
+    // define output if it has not been defined
+    if (p_print != nullptr && info.decoder->getOutput() == nullptr) {
+      info.decoder->setOutput(*p_print);
+    }
+    if (!info.is_open) {
+      info.decoder->begin();
+      info.is_open = true;
+    }
+  }
+
+  /// Ends the actual decoder: when keep open has been activated the codec
+  /// state stays allocated so that a later switch back is fast
+  void closeActualDecoder() {
+    if (actual_decoder.decoder != nullptr && actual_decoder.is_open &&
+        !is_keep_open) {
+      actual_decoder.decoder->end();
+      setOpen(actual_decoder.mime, false);
+    }
+    actual_decoder = DecoderInfo();
+  }
+
+  /// Updates the open state of the registered decoder with the indicated
+  /// mime type
+  void setOpen(const char* mime, bool open) {
+    for (int j = 0; j < decoders.size(); j++) {
+      if (StrView(decoders[j].mime).equals(mime)) {
+        decoders[j].is_open = open;
+      }
+    }
+  }
 };
 
 }  // namespace audio_tools
\ No newline at end of file
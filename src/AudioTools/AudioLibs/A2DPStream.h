@@ -60,6 +60,13 @@ class A2DPConfig {
         int tx_write_timeout_ms = -1; // no timeout
         /// begin should wait for connection to be established (default true)
         bool wait_for_connection=true;
+        /// low latency mode: the exchange buffer is sized from
+        /// target_latency_ms (in MTU sized chunks) instead of the generous
+        /// default and the artificial write delay is removed (default false)
+        bool is_low_latency = false;
+        /// latency budget for the exchange buffer in ms - only used when
+        /// is_low_latency is set (default 100)
+        int target_latency_ms = 100;
 };
 
 
@@ -140,8 +147,24 @@ class A2DPStream : public AudioStream, public VolumeSupport {
             this->config = cfg;
             bool result = false;
             LOGI("Connecting to %s",cfg.name);
-            
-            if (!a2dp_buffer.resize(cfg.buffer_size)){
+
+            // low latency: size the buffer from the latency budget instead
+            // of the generous default
+            int buffer_size = cfg.buffer_size;
+            if (cfg.is_low_latency){
+                // the exchange buffer gets ~half the budget: the SBC codec
+                // and the BT stack queues consume the rest
+                int bytes_per_ms = info.sample_rate * info.channels
+                                   * (info.bits_per_sample / 8) / 1000;
+                buffer_size = cfg.target_latency_ms / 2 * bytes_per_ms;
+                // round up to the MTU sized chunks requested by the callback
+                buffer_size = ((buffer_size + A2DP_BUFFER_SIZE - 1)
+                               / A2DP_BUFFER_SIZE) * A2DP_BUFFER_SIZE;
+                config.delay_ms = 0;
+                LOGI("low latency buffer: %d bytes", buffer_size);
+            }
+
+            if (!a2dp_buffer.resize(buffer_size)){
                 LOGE("a2dp_buffer resize failed");
                 return false;
             }
@@ -263,7 +286,7 @@ class A2DPStream : public AudioStream, public VolumeSupport {
             // write to buffer
             size_t result = a2dp_buffer.writeArray(data, len);
             LOGD("write %d -> %d", len, result);
-            if (config.mode == TX_MODE){
+            if (config.mode == TX_MODE && config.delay_ms > 0){
                 // give the callback a chance to retrieve the data
                 delay(config.delay_ms);
             }
@@ -310,6 +333,15 @@ class A2DPStream : public AudioStream, public VolumeSupport {
             return a2dp_buffer;
         }
 
+        /// Reports the time the audio currently spends in the exchange
+        /// buffer in ms: the SBC codec and the BT stack queues add on top
+        int latencyMs() {
+            int bytes_per_ms = info.sample_rate * info.channels
+                               * (info.bits_per_sample / 8) / 1000;
+            if (bytes_per_ms == 0) return 0;
+            return a2dp_buffer.available() / bytes_per_ms;
+        }
+
         /// Manage config.silence_on_nodata dynamically.
         void setSilenceOnNoData(bool silence){
             config.silence_on_nodata = silence;
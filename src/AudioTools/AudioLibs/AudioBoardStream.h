@@ -3,9 +3,14 @@
 #include "AudioConfig.h"
 #include "AudioTools/AudioLibs/I2SCodecStream.h"
 #include "AudioTools/CoreAudio/AudioActions.h"
+#include "AudioTools/CoreAudio/Pipeline.h"
 
 namespace audio_tools {
 
+/// Codec features which can be provided in hardware, so the equivalent
+/// software stage can be skipped: see AudioBoardStream::hasCapability()
+enum class CodecCapability { Volume, InputVolume, Mute, PA, Tone };
+
 /**
  * @brief New functionality which replaces the AudioKitStream that is based on
  * the legacy AudioKit library. This functionality uses the new
@@ -376,11 +381,58 @@ class AudioBoardStream : public I2SCodecStream {
     return board().isKeyPressed(key);
   }
 
+  /**
+   * @brief Checks whether the codec of the board provides the feature in
+   * hardware. Volume is probed once (by rewriting the current volume over
+   * i2c) and the result is cached; Tone reports false for the time being,
+   * since the generic driver API does not expose the bass/treble
+   * registers of the codecs yet.
+   */
+  bool hasCapability(CodecCapability capability) {
+    if (!hasBoard()) return false;
+    switch (capability) {
+      case CodecCapability::Volume:
+        // probe once: a no-op write of the current volume
+        if (has_hw_volume < 0) {
+          has_hw_volume = board().setVolume(board().getVolume()) ? 1 : 0;
+        }
+        return has_hw_volume == 1;
+      case CodecCapability::Mute:
+        // part of the common codec driver API
+        return true;
+      case CodecCapability::InputVolume:
+        return cfg.rx_tx_mode == RX_MODE || cfg.rx_tx_mode == RXTX_MODE;
+      case CodecCapability::PA:
+        return pinPaEnable() != -1;
+      case CodecCapability::Tone:
+        return false;
+    }
+    return false;
+  }
+
+  /**
+   * @brief Adds the software stage to the pipeline only when the codec
+   * can not provide the corresponding capability in hardware (e.g. a
+   * VolumeStream with CodecCapability::Volume): returns true when the
+   * stage was added. When the stage is skipped, use the corresponding
+   * method of this class (e.g. setVolume()) which drives the codec
+   * registers instead.
+   */
+  bool addIfMissing(Pipeline &pipeline, ModifyingStream &stage,
+                    CodecCapability capability) {
+    if (hasCapability(capability)) {
+      LOGI("software stage skipped: provided by the codec");
+      return false;
+    }
+    return pipeline.add(stage);
+  }
+
  protected:
   AudioActions actions;
   bool headphoneIsConnected = false;
   bool active = true;
   float action_increment_value = 0.02;
+  int8_t has_hw_volume = -1;  // -1 = not probed yet
 
   int getSdCsPin() {
     static GpioPin sd_cs = -2;
@@ -67,6 +67,76 @@ public:
     return setup();
   }
 
+  /// Preloads a complete clip (16 bit pcm in the format defined by info)
+  /// into RTC memory and loads a one shot ULP program that plays it from
+  /// start to end and halts. The RTC memory and the loaded program survive
+  /// deep sleep, so after calling startClip() the main cores can enter deep
+  /// sleep immediately and the clip finishes without any further CPU
+  /// involvement; on the next wakeup the same clip can be restarted with
+  /// startClip() without preloading again. The clip is limited by the RTC
+  /// memory: use clipFrames() to check the capacity (e.g. 8000 hz mono for
+  /// a door chime).
+  bool beginClip(AudioInfo info, const uint8_t *clip, size_t len) {
+    TRACEI();
+    cfg = info;
+    stereoOutput = info.channels == 2;
+    activeDACs = stereoOutput ? 3 : selected_mono_dac;
+    hertz = cfg.sample_rate;
+
+    if (info.bits_per_sample != 16) {
+      LOGE("Unsupported bits_per_sample: %d", info.bits_per_sample);
+      return false;
+    }
+
+    int frames = len / (cfg.channels * sizeof(int16_t));
+    if (frames > clipFrames()) {
+      LOGW("clip of %d frames truncated to %d", frames, clipFrames());
+      frames = clipFrames();
+    }
+    if (frames == 0) {
+      LOGE("clip is empty");
+      return false;
+    }
+
+    // convert the samples to the packed 8 bit pairs consumed by the ULP
+    int16_t *data_16 = (int16_t *)clip;
+    clip_words = 0;
+    if (stereoOutput) {
+      for (int j = 0; j < frames; j++) {
+        unsigned int w = toUlp(data_16[j * 2]);
+        w |= toUlp(data_16[j * 2 + 1]) << 8;
+        RTC_SLOW_MEM[bufferStart + clip_words++] = w;
+      }
+    } else {
+      // two mono frames per word; an odd frame count is padded with silence
+      for (int j = 0; j < frames; j += 2) {
+        unsigned int w = toUlp(data_16[j]);
+        w |= (j + 1 < frames ? toUlp(data_16[j + 1]) : 128) << 8;
+        RTC_SLOW_MEM[bufferStart + clip_words++] = w;
+      }
+    }
+    return setupClip();
+  }
+
+  /// Starts (or restarts) the playback of the preloaded clip: it is safe to
+  /// enter deep sleep right after this call
+  void startClip() {
+    TRACEI();
+    RTC_SLOW_MEM[indexAddress] = 0;
+    ulp_run(0);
+  }
+
+  /// Returns true while the preloaded clip is still playing
+  bool isClipPlaying() {
+    return clip_words > 0 &&
+           (int)(RTC_SLOW_MEM[indexAddress] & 0xffff) < clip_words;
+  }
+
+  /// Maximum number of frames that fit into the RTC memory clip buffer
+  int clipFrames() {
+    return stereoOutput ? totalSampleWords : totalSampleWords * 2;
+  }
+
   size_t write(const uint8_t *data, size_t len) {
     TRACED();
     int16_t *data_16 = (int16_t *)data;
@@ -117,6 +187,7 @@ public:
 
 protected:
   int lastFilledWord = 0;
+  int clip_words = 0;
   int hertz;
   int min_write_bytes = 128;
   UlpDac selected_mono_dac = ULP_DAC1;
@@ -133,20 +204,14 @@ protected:
   const uint32_t indexAddress = opcodeCount;
   const uint32_t bufferStart = indexAddress + 1;
 
-  bool setup() {
-    TRACED();
-    if (!stereoOutput) {
-      waitingOddSample = false;
-      // totalSampleWords += 512;
-      // dacTableStart2 = dacTableStart1;
-    }
-
-    // calculate the actual ULP clock
+  /// Calculates the actual ULP clock
+  unsigned long ulpClockHz() {
     unsigned long rtc_8md256_period = rtc_clk_cal(RTC_CAL_8MD256, 1000);
-    unsigned long rtc_fast_freq_hz =
-        1000000ULL * (1 << RTC_CLK_CAL_FRACT) * 256 / rtc_8md256_period;
+    return 1000000ULL * (1 << RTC_CLK_CAL_FRACT) * 256 / rtc_8md256_period;
+  }
 
-    // initialize DACs
+  /// Initializes the DACs with the silence level
+  void setupDacs() {
     if (activeDACs & 1) {
       dac_output_enable(DAC_CHANNEL_1);
       dac_output_voltage(DAC_CHANNEL_1, 128);
@@ -155,6 +220,22 @@ protected:
       dac_output_enable(DAC_CHANNEL_2);
       dac_output_voltage(DAC_CHANNEL_2, 128);
     }
+  }
+
+  /// Converts a 16 bit sample to the 8 bit DAC value
+  unsigned int toUlp(int16_t sample) { return ((sample >> 8) + 128) & 0xff; }
+
+  bool setup() {
+    TRACED();
+    if (!stereoOutput) {
+      waitingOddSample = false;
+      // totalSampleWords += 512;
+      // dacTableStart2 = dacTableStart1;
+    }
+
+    unsigned long rtc_fast_freq_hz = ulpClockHz();
+
+    setupDacs();
 
     int retAddress1 = 9;
     int retAddress2 = 14;
@@ -229,7 +310,107 @@ protected:
     //  for(int i = 0; i < size; i++)
     //    Serial.println(RTC_SLOW_MEM[i], HEX);
 
-    // create DAC opcode tables
+    setupDacTables(retAddress1, retAddress2);
+
+    // set all samples to 128 (silence)
+    for (int i = 0; i < totalSampleWords; i++)
+      RTC_SLOW_MEM[bufferStart + i] = 0x8080;
+
+    // start
+    RTC_SLOW_MEM[indexAddress] = 0;
+    ulp_run(0);
+
+    // wait until ULP starts using samples and the index of output sample
+    // advances
+    while (RTC_SLOW_MEM[indexAddress] == 0)
+      delay(1);
+
+    return true;
+  }
+
+  /// Loads the one shot ULP program for the preloaded clip: it is the
+  /// stereo program without the ring buffer silence refill (the buffer is
+  /// not reused), which makes room for the final I_END/I_HALT within the
+  /// reserved opcode area and keeps the DAC table return addresses
+  /// unchanged
+  bool setupClip() {
+    TRACED();
+    unsigned long rtc_fast_freq_hz = ulpClockHz();
+
+    setupDacs();
+
+    int retAddress1 = 9;
+    int retAddress2 = 14;
+
+    // loop cycles without the two silence refill instructions
+    int loopCycles = 134 - 14;
+    int loopHalfCycles1 = 90;
+    int loopHalfCycles2 = 44 - 14;
+
+    LOGI("Real RTC clock: %d", rtc_fast_freq_hz);
+
+    uint32_t dt = (rtc_fast_freq_hz / hertz) - loopCycles;
+    uint32_t dt2 = 0;
+    if (!stereoOutput) {
+      dt = (rtc_fast_freq_hz / hertz) - loopHalfCycles1;
+      dt2 = (rtc_fast_freq_hz / hertz) - loopHalfCycles2;
+    }
+
+    const ulp_insn_t clip_program[] = {
+        // reset offset register
+        I_MOVI(R3, 0),
+        // delay to get the right sampling rate
+        I_DELAY(dt), // 6 + dt
+        // reset sample index
+        I_MOVI(R0, 0), // 6
+        // write the index back to memory for the main cpu
+        I_ST(R0, R3, indexAddress), // 8
+        // load the samples
+        I_LD(R1, R0, bufferStart), // 8
+        // mask the lower 8 bits
+        I_ANDI(R2, R1, 0x00ff), // 6
+        // multiply by 2
+        I_LSHI(R2, R2, 1), // 6
+        // add start position
+        I_ADDI(R2, R2, dacTableStart1), // 6
+        // jump to the dac opcode
+        I_BXR(R2), // 4
+        // back from first dac
+        // delay between the two samples in mono rendering
+        I_DELAY(dt2), // 6 + dt2
+        // mask the upper 8 bits
+        I_ANDI(R2, R1, 0xff00), // 6
+        // shift the upper bits to right and multiply by 2
+        I_RSHI(R2, R2, 8 - 1), // 6
+        // add start position of second dac table
+        I_ADDI(R2, R2, dacTableStart2), // 6
+        // jump to the dac opcode
+        I_BXR(R2), // 4
+        // here we get back from writing the second sample
+        // increment the sample index
+        I_ADDI(R0, R0, 1), // 6
+        // when the clip is done, jump to the stop sequence
+        I_BGE(3, clip_words), // 4
+        // wait to get the right sample rate
+        I_DELAY((unsigned int)dt + 2), // 8 + dt
+        // play the next sample: jump absolute to where the index is stored
+        I_BXI(3), // 4
+        // stop the timer and halt until the next startClip()
+        I_END(),
+        I_HALT()};
+
+    size_t load_addr = 0;
+    size_t size = sizeof(clip_program) / sizeof(ulp_insn_t);
+    ulp_process_macros_and_load(load_addr, clip_program, &size);
+
+    setupDacTables(retAddress1, retAddress2);
+
+    RTC_SLOW_MEM[indexAddress] = 0;
+    return true;
+  }
+
+  /// Creates the DAC opcode tables
+  void setupDacTables(int retAddress1, int retAddress2) {
     switch (activeDACs) {
     case 1:
       for (int i = 0; i < 256; i++) {
@@ -268,21 +449,6 @@ protected:
       }
       break;
     }
-
-    // set all samples to 128 (silence)
-    for (int i = 0; i < totalSampleWords; i++)
-      RTC_SLOW_MEM[bufferStart + i] = 0x8080;
-
-    // start
-    RTC_SLOW_MEM[indexAddress] = 0;
-    ulp_run(0);
-
-    // wait until ULP starts using samples and the index of output sample
-    // advances
-    while (RTC_SLOW_MEM[indexAddress] == 0)
-      delay(1);
-
-    return true;
   }
 
   bool writeFrame(int16_t sample[2]) {
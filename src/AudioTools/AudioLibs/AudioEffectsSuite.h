@@ -59,6 +59,19 @@ class EffectSuiteBase  : public AudioEffect {
     return active_flag ? 32767.0f * processDouble(static_cast<effectsuite_t>(inputSample)/32767.0f) : inputSample;
   }
 
+public:
+  /**
+   * Applies the effect to a whole block of samples in place: the int16
+   * scaling is inlined in the loop, so only processDouble() stays a
+   * virtual call per sample instead of two
+   */
+  virtual void processBlock(effect_t *data, size_t sampleCount) override {
+    if (!active_flag) return;
+    for (size_t j = 0; j < sampleCount; j++) {
+      data[j] = 32767.0f *
+                processDouble(static_cast<effectsuite_t>(data[j]) / 32767.0f);
+    }
+  }
 };
 
 
@@ -417,7 +430,7 @@ public:
 
   /** Destructor. */
   ~DelayEffectBase() {
-    if (delayBuffer != nullptr)
+    if (delayBuffer != nullptr && !buffer_from_pool)
       delete[] delayBuffer;
   }
 
@@ -430,6 +443,17 @@ public:
     delayTimeSamples = bufferSizeSamples;
   }
 
+  /**
+   * Defines a common allocator which serves the delay memories of all
+   * suite effects: use an AllocatorArena sized once for the whole chain,
+   * so that enabling several delay based effects does not cause one heap
+   * allocation each. Call before the effects are constructed.
+   */
+  static void setMemoryPool(Allocator &allocator) { memoryPool() = &allocator; }
+
+  /** Removes the common allocator: subsequent delay memories use the heap */
+  static void clearMemoryPool() { memoryPool() = nullptr; }
+
 protected:
   /**
    * Sets the internal lagrange interpolation table. Ideally it should be
@@ -520,8 +544,19 @@ protected:
    * or sets the internal delay buffer and returns true
    */
   bool setDelayBuffer(int bufferSizeSamples) {
+    if (delayBuffer != nullptr && !buffer_from_pool) {
+      delete[] delayBuffer;
+    }
     maxDelayBufferSize = bufferSizeSamples;
-    delayBuffer = new effectsuite_t[maxDelayBufferSize];
+    Allocator *pool = memoryPool();
+    if (pool != nullptr) {
+      delayBuffer = (effectsuite_t *)pool->allocate(maxDelayBufferSize *
+                                                    sizeof(effectsuite_t));
+      buffer_from_pool = true;
+    } else {
+      delayBuffer = new effectsuite_t[maxDelayBufferSize];
+      buffer_from_pool = false;
+    }
     if (!delayBuffer) {
       return false;
     }
@@ -529,6 +564,12 @@ protected:
     return true;
   }
 
+  /** Provides the common allocator for the delay memories (nullptr = heap) */
+  static Allocator *&memoryPool() {
+    static Allocator *pool = nullptr;
+    return pool;
+  }
+
   /**
    * store input sample into the delay buffer
    * @param inputSample sample to be stored for delay (effectsuite_t)
@@ -614,6 +655,8 @@ protected:
 protected: // member variables
   /** buffer to stored audio buffer for delay effects*/
   effectsuite_t *delayBuffer = 0;
+  /** true when delayBuffer was served by the common memory pool*/
+  bool buffer_from_pool = false;
   /** Maximum number of samples that can be stored in delayBuffer*/
   int maxDelayBufferSize = 441000;
   /** the delay time of signal in samples*/
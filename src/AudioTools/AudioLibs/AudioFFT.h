@@ -2,6 +2,7 @@
 
 #include "AudioTools/AudioLibs/FFT/FFTWindows.h"
 #include "AudioTools/CoreAudio/AudioStreams.h"
+#include "AudioTools/CoreAudio/AudioWarmup.h"
 #include "AudioTools/CoreAudio/MusicalNotes.h"
 
 /**
@@ -112,14 +113,31 @@ class FFTInverseOverlapAdder {
     data[pos] += add_value;
   }
 
+  /// adds a whole windowed frame with a fused multiply-add loop: no
+  /// branch or bounds check per sample
+  void addFrame(const float *values, const float *window, int n) {
+    if (n > len) n = len;
+    if (window != nullptr) {
+      for (int j = 0; j < n; j++) {
+        data[j] += values[j] * window[j];
+      }
+    } else {
+      for (int j = 0; j < n; j++) {
+        data[j] += values[j];
+      }
+    }
+  }
+
   // gets the scaled audio data as result
   void getStepData(float *result, int stride, float maxResult) {
     for (int j = 0; j < stride; j++) {
       // determine max value to scale
       if (data[j] > rfft_max) rfft_max = data[j];
     }
+    // scale with one reciprocal multiply per sample instead of a division
+    float factor = rfft_max > 0.0f ? maxResult / rfft_max : 0.0f;
     for (int j = 0; j < stride; j++) {
-      result[j] = data[j] / rfft_max * maxResult;
+      result[j] = data[j] * factor;
       // clip
       if (result[j] > maxResult) {
         result[j] = maxResult;
@@ -129,9 +147,8 @@ class FFTInverseOverlapAdder {
       }
     }
     // copy data to head
-    for (int j = 0; j < len - stride; j++) {
-      data[j] = data[j + stride];
-    }
+    memmove(data.data(), data.data() + stride,
+            (len - stride) * sizeof(float));
     // clear tail
     for (int j = len - stride; j < len; j++) {
       data[j] = 0.0;
@@ -178,6 +195,137 @@ class FFTDriver {
   bool setBin(int pos, FFTBin &bin) { return setBin(pos, bin.real, bin.img); }
   /// gets the value of a bin
   virtual bool getBin(int pos, FFTBin &bin) { return false; }
+  /// Provides direct access to the real input array of the driver so that
+  /// the samples can be filled in place w/o calling setValue() per sample:
+  /// returns nullptr if the driver does not support this
+  virtual float *values() { return nullptr; }
+};
+
+/**
+ * @brief Meta driver which picks the fastest FFT backend at runtime: add
+ * the compiled-in candidate drivers with addDriver() and begin() runs a
+ * short micro benchmark of each one for the configured length and
+ * delegates all further calls to the winner. This allows shipping the same
+ * firmware to different targets (e.g. ESP32, ESP32-S3, RP2350) where the
+ * best backend differs. The result can be queried for logging with
+ * selectedName() and benchmarkTimeUs().
+ * @ingroup fft
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ */
+class FFTDriverBenchmark : public FFTDriver {
+ public:
+  /// Adds a candidate driver with a name used for reporting
+  void addDriver(FFTDriver *driver, const char *name) {
+    Candidate candidate;
+    candidate.driver = driver;
+    candidate.name = name;
+    candidate.time_us = 0;
+    candidates.push_back(candidate);
+  }
+
+  /// Benchmarks all candidates and selects the fastest
+  bool begin(int len) override {
+    if (candidates.size() == 0) {
+      LOGE("No drivers defined");
+      return false;
+    }
+    selected = -1;
+    for (int j = 0; j < (int)candidates.size(); j++) {
+      Candidate &candidate = candidates[j];
+      if (!candidate.driver->begin(len) || !candidate.driver->isValid()) {
+        LOGW("Driver %s not available", candidate.name);
+        candidate.driver->end();
+        candidate.time_us = 0;
+        continue;
+      }
+      candidate.time_us = benchmark(candidate.driver, len);
+      candidate.driver->end();
+      LOGI("Driver %s: %lu us", candidate.name,
+           (unsigned long)candidate.time_us);
+      if (selected < 0 || candidate.time_us < candidates[selected].time_us) {
+        selected = j;
+      }
+    }
+    if (selected < 0) {
+      LOGE("No valid driver");
+      return false;
+    }
+    LOGI("Selected driver: %s", candidates[selected].name);
+    return driver()->begin(len);
+  }
+
+  void end() override {
+    if (selected >= 0) driver()->end();
+  }
+
+  /// Number of benchmark runs per driver
+  void setRuns(int count) { runs = count; }
+
+  /// Name of the selected driver (for logging)
+  const char *selectedName() {
+    return selected >= 0 ? candidates[selected].name : "-";
+  }
+
+  /// Number of registered drivers
+  int driverCount() { return candidates.size(); }
+
+  /// Name of the indicated driver
+  const char *name(int idx) { return candidates[idx].name; }
+
+  /// Measured benchmark time of the indicated driver in microseconds
+  unsigned long benchmarkTimeUs(int idx) { return candidates[idx].time_us; }
+
+  void setValue(int pos, float value) override {
+    driver()->setValue(pos, value);
+  }
+  void fft() override { driver()->fft(); }
+  float magnitude(int idx) override { return driver()->magnitude(idx); }
+  float magnitudeFast(int idx) override {
+    return driver()->magnitudeFast(idx);
+  }
+  bool isValid() override { return selected >= 0 && driver()->isValid(); }
+  bool isReverseFFT() override {
+    return selected >= 0 && driver()->isReverseFFT();
+  }
+  void rfft() override { driver()->rfft(); }
+  float getValue(int pos) override { return driver()->getValue(pos); }
+  bool setBin(int idx, float real, float img) override {
+    return driver()->setBin(idx, real, img);
+  }
+  bool getBin(int pos, FFTBin &bin) override {
+    return driver()->getBin(pos, bin);
+  }
+  float *values() override {
+    return selected >= 0 ? driver()->values() : nullptr;
+  }
+
+  /// Provides the selected driver
+  FFTDriver *driver() {
+    return selected >= 0 ? candidates[selected].driver : nullptr;
+  }
+
+ protected:
+  struct Candidate {
+    FFTDriver *driver;
+    const char *name;
+    unsigned long time_us;
+  };
+  Vector<Candidate> candidates{0};
+  int selected = -1;
+  int runs = 4;
+
+  /// measures the time for a few transforms of a test signal
+  unsigned long benchmark(FFTDriver *drv, int len) {
+    for (int j = 0; j < len; j++) {
+      drv->setValue(j, sinf(2.0f * PI * j / len));
+    }
+    unsigned long start = micros();
+    for (int r = 0; r < runs; r++) {
+      drv->fft();
+    }
+    return micros() - start;
+  }
 };
 
 /**
@@ -222,6 +370,8 @@ class AudioFFTBase : public AudioStream {
       LOGE("Len must be of the power of 2: %d", cfg.length);
       return false;
     }
+    // report the twiddle and window table setup cost to the warmup registry
+    uint32_t start_us = micros();
     if (!p_driver->begin(cfg.length)) {
       LOGE("Not enough memory");
     }
@@ -229,11 +379,17 @@ class AudioFFTBase : public AudioStream {
     if (cfg.window_function_fft != nullptr) {
       cfg.window_function_fft->begin(cfg.length);
     }
-    if (cfg.window_function_ifft != nullptr 
+    if (cfg.window_function_ifft != nullptr
     && cfg.window_function_ifft != cfg.window_function_fft) {
       cfg.window_function_ifft->begin(cfg.length);
     }
 
+    // cache the window tables, so that the hop processing does not need to
+    // call factor() per sample
+    setupWindowTable(window_fft_table, cfg.window_function_fft);
+    setupWindowTable(window_ifft_table, cfg.window_function_ifft);
+    warmupRecord("fft", micros() - start_us);
+
     bool is_valid_rxtx = false;
     if (cfg.rxtx_mode == TX_MODE || cfg.rxtx_mode == RXTX_MODE) {
       // holds last N bytes that need to be reprocessed
@@ -244,6 +400,7 @@ class AudioFFTBase : public AudioStream {
       rfft_data.resize(cfg.channels * bytesPerSample() * cfg.stride);
       rfft_add.resize(cfg.length);
       step_data.resize(cfg.stride);
+      ifft_scratch.resize(cfg.length);
       is_valid_rxtx = true;
     }
 
@@ -284,6 +441,7 @@ class AudioFFTBase : public AudioStream {
     rfft_data.resize(0);
     rfft_add.resize(0);
     step_data.resize(0);
+    ifft_scratch.resize(0);
   }
 
   /// Provide the audio data as FFT input
@@ -370,6 +528,44 @@ class AudioFFTBase : public AudioStream {
     return ret_value;
   }
 
+  /// Determines the N biggest result values using the fast magnitude and a
+  /// small min heap: the square root is only calculated for the N selected
+  /// bins and no memory is allocated
+  template <int N>
+  void resultArrayFast(AudioFFTResult (&result)[N]) {
+    float heap_mag[N];
+    int heap_bin[N];
+    int count = 0;
+    for (int j = 0; j < size(); j++) {
+      float m = p_driver->magnitudeFast(j);
+      if (count < N) {
+        // fill the heap and sift the new value up
+        int i = count++;
+        heap_mag[i] = m;
+        heap_bin[i] = j;
+        while (i > 0 && heap_mag[i] < heap_mag[(i - 1) / 2]) {
+          heapSwap(heap_mag, heap_bin, i, (i - 1) / 2);
+          i = (i - 1) / 2;
+        }
+      } else if (m > heap_mag[0]) {
+        // replace the smallest of the top N
+        heap_mag[0] = m;
+        heap_bin[0] = j;
+        heapSiftDown(heap_mag, heap_bin, 0, count);
+      }
+    }
+    // pop the heap: the minimum comes out first
+    for (int j = count - 1; j >= 0; j--) {
+      result[j].magnitude = sqrt(heap_mag[0]);
+      result[j].bin = heap_bin[0];
+      result[j].frequency = frequency(heap_bin[0]);
+      count--;
+      heap_mag[0] = heap_mag[count];
+      heap_bin[0] = heap_bin[count];
+      heapSiftDown(heap_mag, heap_bin, 0, count);
+    }
+  }
+
   /// Determines the N biggest result values
   template <int N>
   void resultArray(AudioFFTResult (&result)[N]) {
@@ -431,28 +627,36 @@ class AudioFFTBase : public AudioStream {
     return atan2(fft_bin.img, fft_bin.real);
   }
 
+  /// Defines a caller provided scratch array of size() entries which is used
+  /// by magnitudes() and magnitudesFast(): this prevents any allocation in
+  /// the steady state
+  void setMagnitudesScratch(float *scratch, int len) {
+    if (len < size()) {
+      LOGE("scratch too small: %d instead of %d", len, size());
+      return;
+    }
+    p_magnitudes_scratch = scratch;
+  }
+
   /// Provides the magnitudes as array of size size(). Please note that this
-  /// method is allocating additinal memory!
+  /// method is allocating additinal memory if no scratch array was defined!
   float *magnitudes() {
-    if (l_magnitudes.size() == 0) {
-      l_magnitudes.resize(size());
-    }
+    float *result = magnitudesArray();
     for (int j = 0; j < size(); j++) {
-      l_magnitudes[j] = magnitude(j);
+      result[j] = magnitude(j);
     }
-    return l_magnitudes.data();
+    return result;
   }
 
   /// Provides the magnitudes w/o calling the square root function as array of
-  /// size size(). Please note that this method is allocating additinal memory!
+  /// size size(). Please note that this method is allocating additinal memory
+  /// if no scratch array was defined!
   float *magnitudesFast() {
-    if (l_magnitudes.size() == 0) {
-      l_magnitudes.resize(size());
-    }
+    float *result = magnitudesArray();
     for (int j = 0; j < size(); j++) {
-      l_magnitudes[j] = magnitudeFast(j);
+      result[j] = magnitudeFast(j);
     }
-    return l_magnitudes.data();
+    return result;
   }
 
   /// sets the value of a bin
@@ -491,9 +695,58 @@ class AudioFFTBase : public AudioStream {
   FFTInverseOverlapAdder rfft_add{0};
   Vector<float> l_magnitudes{0};
   Vector<float> step_data{0};
+  Vector<float> ifft_scratch{0};
   SingleBuffer<uint8_t> stride_buffer{0};
   RingBuffer<uint8_t> rfft_data{0};
   bool has_rfft_data = false;
+  float *p_magnitudes_scratch = nullptr;
+  Vector<float> window_fft_table{0};
+  Vector<float> window_ifft_table{0};
+
+  /// caches the factors of the window function in a table
+  void setupWindowTable(Vector<float> &table, WindowFunction *fn) {
+    if (fn == nullptr) {
+      table.resize(0);
+      return;
+    }
+    table.resize(cfg.length);
+    for (int j = 0; j < cfg.length; j++) {
+      table[j] = fn->factor(j);
+    }
+  }
+
+  /// provides the scratch array or the allocated vector for the magnitudes
+  float *magnitudesArray() {
+    if (p_magnitudes_scratch != nullptr) return p_magnitudes_scratch;
+    if (l_magnitudes.size() == 0) {
+      l_magnitudes.resize(size());
+    }
+    return l_magnitudes.data();
+  }
+
+  void heapSwap(float *mag, int *bin, int i, int j) {
+    float tmp_mag = mag[i];
+    int tmp_bin = bin[i];
+    mag[i] = mag[j];
+    bin[i] = bin[j];
+    mag[j] = tmp_mag;
+    bin[j] = tmp_bin;
+  }
+
+  /// restores the min heap property starting at the indicated node
+  void heapSiftDown(float *mag, int *bin, int start, int count) {
+    int i = start;
+    while (true) {
+      int smallest = i;
+      int left = 2 * i + 1;
+      int right = 2 * i + 2;
+      if (left < count && mag[left] < mag[smallest]) smallest = left;
+      if (right < count && mag[right] < mag[smallest]) smallest = right;
+      if (smallest == i) break;
+      heapSwap(mag, bin, i, smallest);
+      i = smallest;
+    }
+  }
 
   // Add samples to input data p_x - and process them if full
   template <typename T>
@@ -507,9 +760,17 @@ class AudioFFTBase : public AudioStream {
         T* samples = (T*) stride_buffer.data();
         int sample_count = stride_buffer.size() / sizeof(T);
         assert(sample_count == cfg.length);
-        for (int j=0; j< sample_count; j++){
-          T out_sample = samples[j];
-          p_driver->setValue(j, windowedSample(out_sample, j));
+        float *in_place = p_driver->values();
+        if (in_place != nullptr){
+          // fill the driver buffer directly w/o virtual call per sample
+          for (int j=0; j< sample_count; j++){
+            in_place[j] = windowedSample(samples[j], j);
+          }
+        } else {
+          for (int j=0; j< sample_count; j++){
+            T out_sample = samples[j];
+            p_driver->setValue(j, windowedSample(out_sample, j));
+          }
         }
 
         fft<T>();
@@ -527,8 +788,8 @@ class AudioFFTBase : public AudioStream {
   template <typename T>
   T windowedSample(T sample, int pos) {
     T result = sample;
-    if (cfg.window_function_fft != nullptr) {
-      result = cfg.window_function_fft->factor(pos) * sample;
+    if (window_fft_table.size() > 0) {
+      result = window_fft_table[pos] * sample;
     }
     return result;
   }
@@ -550,11 +811,15 @@ class AudioFFTBase : public AudioStream {
     // execute reverse fft
     p_driver->rfft();
     has_rfft_data = false;
-    // add data to sum buffer
+    // collect the ifft result into the preallocated scratch frame
     for (int j = 0; j < cfg.length; j++) {
-      float value = p_driver->getValue(j);
-      rfft_add.add(value, j, cfg.window_function_ifft);
+      ifft_scratch[j] = p_driver->getValue(j);
     }
+    // add the windowed frame to the sum buffer in one fused loop
+    rfft_add.addFrame(
+        ifft_scratch.data(),
+        window_ifft_table.size() > 0 ? window_ifft_table.data() : nullptr,
+        cfg.length);
     // get result data from sum buffer
     rfftWriteData(rfft_data);
   }
@@ -92,7 +92,14 @@ class FaustStream : public AudioStream {
 
         LOGI("is_read: %s", is_read?"true":"false");
         LOGI("is_write: %s", is_write?"true":"false");
-        gate_exists = ui.exists("gate");
+
+        // resolve the hot parameters to direct float pointers, so that the
+        // midi/frequency updates do not need any label lookup
+        p_zone_freq = ui.zone("freq");
+        p_zone_gain = ui.zone("gain");
+        p_zone_bend = ui.zone("bend");
+        p_zone_gate = ui.zone("gate");
+        gate_exists = p_zone_gate != nullptr;
         LOGI("gate_exists: %s", gate_exists?"true":"false");
 
         return result;
@@ -119,8 +126,11 @@ class FaustStream : public AudioStream {
             TRACED();
             result = len;
             int samples = len / bytes_per_sample;
-            allocateFloatBuffer(samples, false);
-            p_dsp->compute(samples, nullptr, p_buffer);
+            int frames = samples / cfg.channels;
+            // compute() renders frames: each planar channel buffer holds
+            // one sample per frame
+            allocateFloatBuffer(frames, false);
+            p_dsp->compute(frames, nullptr, p_buffer);
             // convert from float to int
             switch(cfg.bits_per_sample){
                 case 8:
@@ -173,6 +183,13 @@ class FaustStream : public AudioStream {
         return ui.getValue(label);
     }
 
+    /// Resolves a parameter to a direct float pointer: call after begin()
+    /// and cache the result to update the parameter from a control loop
+    /// without any label lookup
+    virtual FAUSTFLOAT* labelZone(const char* label) {
+        return ui.zone(label);
+    }
+
     /// Defines the value of a parameter 
     virtual bool setLabelValue(const char*label, FAUSTFLOAT value){
         if (!is_read && !is_write) LOGE("setLabelValue must be called after begin");
@@ -187,36 +204,48 @@ class FaustStream : public AudioStream {
     }
 
     virtual bool setFrequency(FAUSTFLOAT freq){
+        if (p_zone_freq!=nullptr) {
+            *p_zone_freq = freq;
+            return true;
+        }
         return setLabelValue("freq", freq);
     }
 
     virtual FAUSTFLOAT frequency() {
-        return labelValue("freq");
+        return p_zone_freq!=nullptr ? *p_zone_freq : labelValue("freq");
     }
 
     virtual bool setBend(FAUSTFLOAT bend){
+        if (p_zone_bend!=nullptr) {
+            *p_zone_bend = bend;
+            return true;
+        }
         return setLabelValue("bend", bend);
     }
 
     virtual FAUSTFLOAT bend() {
-        return labelValue("bend");
+        return p_zone_bend!=nullptr ? *p_zone_bend : labelValue("bend");
     }
 
     virtual bool setGain(FAUSTFLOAT gain){
+        if (p_zone_gain!=nullptr) {
+            *p_zone_gain = gain;
+            return true;
+        }
         return setLabelValue("gain", gain);
     }
 
     virtual FAUSTFLOAT gain() {
-        return labelValue("gain");
+        return p_zone_gain!=nullptr ? *p_zone_gain : labelValue("gain");
     }
 
     virtual bool midiOn(int note, FAUSTFLOAT gain){
-        if (gate_exists) setLabelValue("gate",1.0);
+        if (gate_exists) *p_zone_gate = 1.0;
         return setMidiNote(note) && setGain(gain);
     }
 
     virtual bool midiOff(int note){
-        if (gate_exists) setLabelValue("gate",0.0);
+        if (gate_exists) *p_zone_gate = 0.0;
         return setMidiNote(note) && setGain(0.0);
     }
     
@@ -235,6 +264,11 @@ class FaustStream : public AudioStream {
     Print *p_out=nullptr;
     FAUSTFLOAT** p_buffer=nullptr;
     FAUSTFLOAT** p_buffer_out=nullptr;
+    // hot parameter zones resolved in begin()
+    FAUSTFLOAT* p_zone_freq=nullptr;
+    FAUSTFLOAT* p_zone_gain=nullptr;
+    FAUSTFLOAT* p_zone_bend=nullptr;
+    FAUSTFLOAT* p_zone_gate=nullptr;
     UI ui;
 
     /// Checks the input and output channels and updates the is_write or is_read scenario flags
@@ -311,8 +345,9 @@ class FaustStream : public AudioStream {
             TRACED();
             int samples = len / bytes_per_sample;
             int frames = samples / cfg.channels;
-            // prepare float input for faust
-            allocateFloatBuffer(samples, with_output_buffer);
+            // prepare float input for faust: planar buffers with one
+            // sample per frame and channel
+            allocateFloatBuffer(frames, with_output_buffer);
             convertIntBufferToFloat<T>(samples, (void*) write_data, p_buffer);
 
             // determine result
@@ -131,6 +131,14 @@ class UI {
         return findEntry(label)!=nullptr;
     }
 
+    /// Resolves a label to the float zone of the dsp: the returned pointer
+    /// stays valid until the next buildUserInterface() and can be used to
+    /// update the parameter without any lookup
+    virtual FAUSTFLOAT* zone(const char* label){
+        Entry *e = findEntry(label);
+        return e!=nullptr ? e->zone : nullptr;
+    }
+
     /// Returns the number of label entries
     virtual size_t size() {
         return entries.size();
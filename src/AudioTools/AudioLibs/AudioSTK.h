@@ -67,9 +67,28 @@ class STKGenerator : public SoundGenerator<T> {
             return result;
         }
 
+        /// Provides a batch of samples using the STK block render API:
+        /// tick(StkFrames&) fills the whole buffer in one call instead of
+        /// one virtual tick() per sample
+        size_t readSamples(T *data, size_t sampleCount) override {
+            if (p_instrument==nullptr) {
+                memset(data, 0, sampleCount*sizeof(T));
+                return sampleCount;
+            }
+            if (frames.frames() != sampleCount) {
+                frames.resize(sampleCount, 1);
+            }
+            p_instrument->tick(frames);
+            for (size_t j = 0; j < sampleCount; j++) {
+                data[j] = frames[j] * max_value;
+            }
+            return sampleCount;
+        }
+
     protected:
         StkCls *p_instrument=nullptr;
         T max_value;
+        stk::StkFrames frames;
 
 };
 
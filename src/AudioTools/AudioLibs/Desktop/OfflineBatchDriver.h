@@ -0,0 +1,88 @@
+#pragma once
+#include <atomic>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "AudioTools/CoreAudio/AudioLogger.h"
+
+namespace audio_tools {
+
+/**
+ * @brief Offline batch driver for desktop builds: processes a list of
+ * files with N worker threads. Each worker instantiates its own pipeline
+ * via the provided callback and runs it as fast as possible (do not use
+ * a Throttle), so an embarrassingly parallel job like batch loudness
+ * normalization uses all cores. The callback must only use local state,
+ * since it is executed concurrently.
+ * @author Phil Schatzmann
+ * @ingroup concurrency
+ * @copyright GPLv3
+ */
+class OfflineBatchDriver {
+ public:
+  /**
+   * @brief Construct a new Offline Batch Driver
+   *
+   * @param fileProcessor builds and runs the pipeline for one file
+   * @param workerCount number of worker threads (default: all cores)
+   */
+  OfflineBatchDriver(std::function<void(const char *path)> fileProcessor,
+                     int workerCount = std::thread::hardware_concurrency()) {
+    processor = fileProcessor;
+    worker_count = workerCount < 1 ? 1 : workerCount;
+  }
+
+  /// Adds a file to the work list
+  void addFile(const char *path) { files.push_back(path); }
+
+  /// Number of queued files
+  size_t size() { return files.size(); }
+
+  /// Optional callback which is executed after each completed file (from
+  /// the worker threads!)
+  void setProgressCallback(std::function<void(const char *path, size_t done,
+                                              size_t total)> cb) {
+    progress_callback = cb;
+  }
+
+  /// Processes all queued files and blocks until they are done
+  bool process() {
+    TRACED();
+    if (processor == nullptr || files.empty()) return false;
+    next_file.store(0);
+    done_count.store(0);
+    std::vector<std::thread> workers;
+    for (int j = 0; j < worker_count; j++) {
+      workers.emplace_back([this]() { workerLoop(); });
+    }
+    for (auto &worker : workers) worker.join();
+    files.clear();
+    return true;
+  }
+
+ protected:
+  std::function<void(const char *path)> processor = nullptr;
+  std::function<void(const char *path, size_t done, size_t total)>
+      progress_callback = nullptr;
+  std::vector<std::string> files;
+  std::atomic<size_t> next_file{0};
+  std::atomic<size_t> done_count{0};
+  int worker_count = 1;
+
+  /// Each worker claims the next file with an atomic increment
+  void workerLoop() {
+    for (;;) {
+      size_t idx = next_file.fetch_add(1);
+      if (idx >= files.size()) break;
+      const char *path = files[idx].c_str();
+      LOGI("processing %s", path);
+      processor(path);
+      size_t done = done_count.fetch_add(1) + 1;
+      if (progress_callback) progress_callback(path, done, files.size());
+    }
+  }
+};
+
+}  // namespace audio_tools
@@ -104,6 +104,168 @@ class BufferedWindow : public WindowFunction {
   }
 };
 
+/**
+ * @brief Buffered window function with the fft length as template parameter:
+ * the table lives in static storage instead of the heap and is calculated
+ * only once, so repeated hops do not re-evaluate the window math
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ */
+template <int N>
+class BufferedWindowT : public WindowFunction {
+ public:
+  BufferedWindowT(WindowFunction* wf) { p_wf = wf; }
+
+  const char* name() override {
+    static char buffer[80] = "Buffered ";
+    strncpy(buffer + 9, p_wf->name(), 69);
+    return buffer;
+  }
+
+  void begin(int samples) override {
+    assert(samples == N);
+    WindowFunction::begin(N);
+    if (!is_setup) {
+      p_wf->begin(N);
+      for (int j = 0; j <= i_half_samples; j++) {
+        table[j] = p_wf->factor(j);
+      }
+      is_setup = true;
+    }
+  }
+
+ protected:
+  WindowFunction* p_wf = nullptr;
+  float table[N / 2 + 1] = {0};
+  bool is_setup = false;
+
+  float factor_internal(int idx) override {
+    if (idx < 0 || idx > i_half_samples) return 0.0f;
+    return table[idx];
+  }
+};
+
+#if __cplusplus >= 201402L
+
+/// Taylor series cos usable in constant expressions: the argument is first
+/// reduced into [-pi, pi], so the series converges well beyond float
+/// precision. Used to build the window tables at compile time.
+constexpr float window_cos(float x) {
+  double xd = x;
+  constexpr double pi = 3.14159265358979323846;
+  while (xd > pi) xd -= 2.0 * pi;
+  while (xd < -pi) xd += 2.0 * pi;
+  double term = 1.0;
+  double sum = 1.0;
+  double x2 = xd * xd;
+  for (int j = 1; j <= 12; j++) {
+    term *= -x2 / ((2 * j - 1) * (2 * j));
+    sum += term;
+  }
+  return (float)sum;
+}
+
+/// Compile time generated half table (the windows are symmetric) for a
+/// generalized cosine window a0 - a1 cos(2 pi r) + a2 cos(4 pi r)
+/// - a3 cos(6 pi r)
+template <int N>
+struct CosineWindowTable {
+  float data[N / 2 + 1];
+  constexpr CosineWindowTable(float a0, float a1, float a2, float a3)
+      : data{} {
+    constexpr float two_pi = 6.28318531f;
+    for (int j = 0; j <= N / 2; j++) {
+      float r = (float)j / (N - 1);
+      float value = a0 - a1 * window_cos(two_pi * r) +
+                    a2 * window_cos(2.0f * two_pi * r) -
+                    a3 * window_cos(3.0f * two_pi * r);
+      data[j] = value > 1.0f ? 1.0f : value;
+    }
+  }
+};
+
+/**
+ * @brief Generalized cosine window with a compile time generated table:
+ * the table is constexpr data, so it lives in flash, needs no begin()
+ * calculation and does not consume any RAM. The coefficients are provided
+ * by a Coeffs type with static constexpr members a0..a3 - see the
+ * HannT/HammingT/... aliases below.
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ * @tparam Coeffs coefficient provider
+ * @tparam N fft length
+ */
+template <typename Coeffs, int N>
+class CosineWindowT : public WindowFunction {
+ public:
+  CosineWindowT() { WindowFunction::begin(N); }
+
+  void begin(int samples) override {
+    assert(samples == N);
+    WindowFunction::begin(N);
+  }
+
+  const char* name() override { return Coeffs::label(); }
+
+ protected:
+  static constexpr CosineWindowTable<N> table{Coeffs::a0, Coeffs::a1,
+                                              Coeffs::a2, Coeffs::a3};
+
+  float factor_internal(int idx) override {
+    if (idx < 0 || idx > i_half_samples) return 0.0f;
+    return table.data[idx];
+  }
+};
+
+template <typename Coeffs, int N>
+constexpr CosineWindowTable<N> CosineWindowT<Coeffs, N>::table;
+
+struct HannCoeffs {
+  static constexpr float a0 = 0.54f, a1 = 0.54f, a2 = 0.0f, a3 = 0.0f;
+  static const char* label() { return "Hann"; }
+};
+
+struct HammingCoeffs {
+  static constexpr float a0 = 0.54f, a1 = 0.46f, a2 = 0.0f, a3 = 0.0f;
+  static const char* label() { return "Hamming"; }
+};
+
+struct NuttallCoeffs {
+  static constexpr float a0 = 0.355768f, a1 = 0.487396f, a2 = 0.144232f,
+                         a3 = 0.012604f;
+  static const char* label() { return "Nuttall"; }
+};
+
+struct BlackmanCoeffs {
+  static constexpr float a0 = 0.42323f, a1 = 0.49755f, a2 = 0.07922f,
+                         a3 = 0.0f;
+  static const char* label() { return "Blackman"; }
+};
+
+struct BlackmanHarrisCoeffs {
+  static constexpr float a0 = 0.35875f, a1 = 0.48829f, a2 = 0.14128f,
+                         a3 = 0.01168f;
+  static const char* label() { return "BlackmanHarris"; }
+};
+
+/// Hann window with a compile time table for the fft length N
+template <int N>
+using HannT = CosineWindowT<HannCoeffs, N>;
+/// Hamming window with a compile time table for the fft length N
+template <int N>
+using HammingT = CosineWindowT<HammingCoeffs, N>;
+/// Nuttall window with a compile time table for the fft length N
+template <int N>
+using NuttallT = CosineWindowT<NuttallCoeffs, N>;
+/// Blackman window with a compile time table for the fft length N
+template <int N>
+using BlackmanT = CosineWindowT<BlackmanCoeffs, N>;
+/// BlackmanHarris window with a compile time table for the fft length N
+template <int N>
+using BlackmanHarrisT = CosineWindowT<BlackmanHarrisCoeffs, N>;
+
+#endif  // __cplusplus >= 201402L
+
 /**
  * @brief Rectange FFT Window function
  * @author Phil Schatzmann
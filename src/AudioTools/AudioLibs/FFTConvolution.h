@@ -0,0 +1,279 @@
+#pragma once
+
+#include "AudioTools/AudioLibs/AudioFFT.h"
+#include "AudioTools/CoreAudio/AudioStreams.h"
+
+namespace audio_tools {
+
+/**
+ * @brief Fast convolution for long FIR filters (e.g. room correction
+ * impulse responses): the impulse response is split into partitions which
+ * are convolved in the frequency domain with overlap-save, so the cost per
+ * sample is O(log N) instead of O(taps) and a 1024 tap filter stays real
+ * time. The FFT itself is delegated to a FFTDriver (e.g. AudioKissFFT,
+ * AudioRealFFT), the partition spectra are precomputed in begin() and the
+ * input spectra are kept in a ring, so each block needs one forward and
+ * one inverse transform per channel. The output is delayed by one block
+ * (fft length / 2 frames).
+ * @ingroup fft
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ */
+class FFTConvolutionStream : public ModifyingStream {
+ public:
+  FFTConvolutionStream(FFTDriver *driver) { p_driver = driver; }
+
+  FFTConvolutionStream(FFTDriver *driver, Print &out) {
+    p_driver = driver;
+    setOutput(out);
+  }
+
+  FFTConvolutionStream(FFTDriver *driver, Stream &io) {
+    p_driver = driver;
+    setStream(io);
+  }
+
+  void setStream(Stream &in) override {
+    p_in = &in;
+    p_print = &in;
+  }
+
+  void setOutput(Print &out) override { p_print = &out; }
+
+  /// Defines the impulse response (the values are copied)
+  void setImpulseResponse(const float *ir, int len) {
+    ir_values.resize(len);
+    for (int j = 0; j < len; j++) ir_values[j] = ir[j];
+  }
+
+  /// Defines the fft length (power of 2, default 1024): the partition size
+  /// is half of it
+  void setLength(int len) { fft_len = len; }
+
+  /// Scaling applied to the inverse fft result: the default 1/len matches
+  /// drivers with an unscaled inverse transform
+  void setPostScale(float scale) { post_scale = scale; }
+
+  bool begin(AudioInfo info) {
+    setAudioInfo(info);
+    return begin();
+  }
+
+  bool begin() override {
+    if (ir_values.size() == 0) {
+      LOGE("No impulse response defined");
+      return false;
+    }
+    if ((fft_len & (fft_len - 1)) != 0) {
+      LOGE("Len must be of the power of 2: %d", fft_len);
+      return false;
+    }
+    block_len = fft_len / 2;
+    bins = fft_len / 2;
+    partitions = (ir_values.size() + block_len - 1) / block_len;
+    if (post_scale == 0.0f) post_scale = 1.0f / fft_len;
+
+    if (!p_driver->begin(fft_len)) {
+      LOGE("Not enough memory");
+      return false;
+    }
+
+    // precompute the partition spectra of the impulse response
+    h_spectra.resize(partitions * bins * 2);
+    FFTBin bin;
+    for (int p = 0; p < partitions; p++) {
+      for (int j = 0; j < fft_len; j++) {
+        int idx = p * block_len + j;
+        float value = (j < block_len && idx < (int)ir_values.size())
+                          ? ir_values[idx]
+                          : 0.0f;
+        p_driver->setValue(j, value);
+      }
+      p_driver->fft();
+      for (int b = 0; b < bins; b++) {
+        p_driver->getBin(b, bin);
+        h_spectra[(p * bins + b) * 2] = bin.real;
+        h_spectra[(p * bins + b) * 2 + 1] = bin.img;
+      }
+    }
+
+    // per channel state
+    channels.resize(info.channels);
+    for (int ch = 0; ch < info.channels; ch++) {
+      channels[ch].input_time.resize(fft_len);
+      channels[ch].x_spectra.resize(partitions * bins * 2);
+      memset(channels[ch].input_time.data(), 0, fft_len * sizeof(float));
+      memset(channels[ch].x_spectra.data(), 0,
+             partitions * bins * 2 * sizeof(float));
+      channels[ch].head = 0;
+    }
+    acc_re.resize(bins);
+    acc_im.resize(bins);
+    in_block.resize(block_len * info.channels);
+    out_buffer.resize(block_len * info.channels * (info.bits_per_sample / 8));
+    fill_frames = 0;
+    return true;
+  }
+
+  void end() override { p_driver->end(); }
+
+  /// Writes the audio data: a processed block is written to the output as
+  /// soon as block_len frames have been collected
+  size_t write(const uint8_t *data, size_t len) override {
+    if (p_print == nullptr) return 0;
+    switch (info.bits_per_sample) {
+      case 16:
+        return process<int16_t>(data, len, nullptr);
+      case 24:
+        return process<int24_t>(data, len, nullptr);
+      case 32:
+        return process<int32_t>(data, len, nullptr);
+      default:
+        LOGE("Unsupported bits_per_sample: %d", info.bits_per_sample);
+    }
+    return 0;
+  }
+
+  /// Reads the convolved audio data from the defined input
+  size_t readBytes(uint8_t *data, size_t len) override {
+    if (p_in == nullptr) return 0;
+    // process input blocks until we can serve the request
+    while (read_buffer.available() < (int)len) {
+      int byte_count = block_len * info.channels * (info.bits_per_sample / 8);
+      tmp_in.resize(byte_count);
+      int n = p_in->readBytes(tmp_in.data(), byte_count);
+      if (n <= 0) break;
+      switch (info.bits_per_sample) {
+        case 16:
+          process<int16_t>(tmp_in.data(), n, &read_buffer);
+          break;
+        case 24:
+          process<int24_t>(tmp_in.data(), n, &read_buffer);
+          break;
+        case 32:
+          process<int32_t>(tmp_in.data(), n, &read_buffer);
+          break;
+        default:
+          LOGE("Unsupported bits_per_sample: %d", info.bits_per_sample);
+          return 0;
+      }
+    }
+    return read_buffer.readArray(data, len);
+  }
+
+  int available() override { return p_in == nullptr ? 0 : p_in->available(); }
+
+  int availableForWrite() override {
+    return p_print == nullptr ? DEFAULT_BUFFER_SIZE
+                              : p_print->availableForWrite();
+  }
+
+ protected:
+  struct ChannelState {
+    Vector<float> input_time{0};   // last fft_len input samples
+    Vector<float> x_spectra{0};    // ring of partition input spectra
+    int head = 0;
+  };
+
+  FFTDriver *p_driver = nullptr;
+  Print *p_print = nullptr;
+  Stream *p_in = nullptr;
+  Vector<float> ir_values{0};
+  Vector<float> h_spectra{0};
+  Vector<ChannelState> channels{0};
+  Vector<float> acc_re{0};
+  Vector<float> acc_im{0};
+  Vector<float> in_block{0};
+  Vector<uint8_t> out_buffer{0};
+  Vector<uint8_t> tmp_in{0};
+  RingBuffer<uint8_t> read_buffer{DEFAULT_BUFFER_SIZE * 4};
+  int fft_len = 1024;
+  int block_len = 0;
+  int bins = 0;
+  int partitions = 0;
+  int fill_frames = 0;
+  float post_scale = 0.0f;
+
+  /// Collects the samples into blocks and convolves full blocks
+  template <typename T>
+  size_t process(const uint8_t *data, size_t len, BaseBuffer<uint8_t> *p_out) {
+    T *samples = (T *)data;
+    int frames = len / sizeof(T) / info.channels;
+    for (int f = 0; f < frames; f++) {
+      for (int ch = 0; ch < info.channels; ch++) {
+        in_block[fill_frames * info.channels + ch] =
+            (float)(int32_t)samples[f * info.channels + ch];
+      }
+      if (++fill_frames == block_len) {
+        convolveBlock<T>(p_out);
+        fill_frames = 0;
+      }
+    }
+    return len;
+  }
+
+  /// Convolves one block for all channels and provides the result
+  template <typename T>
+  void convolveBlock(BaseBuffer<uint8_t> *p_out) {
+    T *out = (T *)out_buffer.data();
+    for (int ch = 0; ch < info.channels; ch++) {
+      ChannelState &state = channels[ch];
+      // overlap-save: slide the time window by one block
+      memmove(state.input_time.data(), state.input_time.data() + block_len,
+              (fft_len - block_len) * sizeof(float));
+      for (int j = 0; j < block_len; j++) {
+        state.input_time[fft_len - block_len + j] =
+            in_block[j * info.channels + ch];
+      }
+      // forward transform of the current window
+      for (int j = 0; j < fft_len; j++) {
+        p_driver->setValue(j, state.input_time[j]);
+      }
+      p_driver->fft();
+      // store the spectrum in the ring
+      state.head = (state.head + 1) % partitions;
+      FFTBin bin;
+      float *x = state.x_spectra.data() + state.head * bins * 2;
+      for (int b = 0; b < bins; b++) {
+        p_driver->getBin(b, bin);
+        x[b * 2] = bin.real;
+        x[b * 2 + 1] = bin.img;
+      }
+      // accumulate the spectra of all partitions
+      for (int b = 0; b < bins; b++) {
+        acc_re[b] = 0.0f;
+        acc_im[b] = 0.0f;
+      }
+      for (int p = 0; p < partitions; p++) {
+        int slot = (state.head - p + partitions) % partitions;
+        float *xs = state.x_spectra.data() + slot * bins * 2;
+        float *h = h_spectra.data() + p * bins * 2;
+        for (int b = 0; b < bins; b++) {
+          float xr = xs[b * 2], xi = xs[b * 2 + 1];
+          float hr = h[b * 2], hi = h[b * 2 + 1];
+          acc_re[b] += xr * hr - xi * hi;
+          acc_im[b] += xr * hi + xi * hr;
+        }
+      }
+      // inverse transform
+      for (int b = 0; b < bins; b++) {
+        p_driver->setBin(b, acc_re[b], acc_im[b]);
+        p_driver->setBin(fft_len - b, acc_re[b], acc_im[b]);
+      }
+      p_driver->rfft();
+      // overlap-save: only the last block is valid
+      for (int j = 0; j < block_len; j++) {
+        float value = p_driver->getValue(fft_len - block_len + j) * post_scale;
+        out[j * info.channels + ch] = NumberConverter::clipT<T>(value);
+      }
+    }
+    int byte_count = block_len * info.channels * sizeof(T);
+    if (p_out != nullptr) {
+      p_out->writeArray(out_buffer.data(), byte_count);
+    } else if (p_print != nullptr) {
+      p_print->write(out_buffer.data(), byte_count);
+    }
+  }
+};
+
+}  // namespace audio_tools
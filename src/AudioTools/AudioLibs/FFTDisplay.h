@@ -39,15 +39,32 @@ class FFTDisplay {
     for (int j = 0; j < p_fft->size(); j++) {
       magnitudes[j] = 0;
     }
+
+    // precompute the clamped bin index per band, so that getMagnitude()
+    // does not need to redo the mapping per led column and fft hop
+    if (band_count > 0) {
+      band_start.resize(band_count);
+      for (int x = 0; x < band_count; x++) {
+        int idx = fft_start_bin + (x * fft_group_bin);
+        if (idx >= magnitudes.size()) idx = magnitudes.size() - 1;
+        band_start[x] = idx;
+      }
+    }
   }
 
+  /// Defines the number of display bands (led columns): when set, begin()
+  /// precomputes the band to bin mapping into an index table
+  void setBands(int count) { band_count = count; }
+
   /// Returns the magnitude for the indicated led x position. We might
   /// need to combine values from the magnitudes array if this is much bigger.
   float getMagnitude(int x) {
     // get magnitude from fft
     float total = 0;
+    int start = (x < band_start.size()) ? band_start[x]
+                                        : fft_start_bin + (x * fft_group_bin);
     for (int j = 0; j < fft_group_bin; j++) {
-      int idx = fft_start_bin + (x * fft_group_bin) + j;
+      int idx = start + j;
       if (idx >= magnitudes.size()) {
         idx = magnitudes.size() - 1;
       }
@@ -74,6 +91,8 @@ class FFTDisplay {
  protected:
   AudioFFTBase *p_fft = nullptr;
   Vector<float> magnitudes{0};
+  Vector<uint16_t> band_start{0};
+  int band_count = 0;
 
   void loadMangnitudes() {
     // just save magnitudes to be displayed
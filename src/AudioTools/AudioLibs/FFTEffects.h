@@ -71,6 +71,12 @@ class FFTEffect : public AudioOutput {
     return fft.write(data, len);
   }
 
+  /// Processing time of the last hop (effect + ifft + output) in us
+  uint32_t hopTimeUs() { return hop_time_us; }
+
+  /// Worst case hop processing time since begin() in us
+  uint32_t maxHopTimeUs() { return max_hop_time_us; }
+
  protected:
   Print *p_out = nullptr;
   AudioRealFFT fft;
@@ -78,16 +84,23 @@ class FFTEffect : public AudioOutput {
   Hann hann;
   BufferedWindow buffered{&hann};
   StreamCopy copier;
+  uint32_t hop_time_us = 0;
+  uint32_t max_hop_time_us = 0;
 
   virtual void effect(AudioFFTBase &fft) = 0;
 
   static void effect_callback(AudioFFTBase &fft) {
     TRACED();
     FFTEffect *ref = (FFTEffect *)fft.config().ref;
+    // measure the hop budget: effect + ifft + output
+    uint32_t start = micros();
     // execute effect
     ref->effect(fft);
     // write ifft to output
     ref->processOutput();
+    ref->hop_time_us = micros() - start;
+    if (ref->hop_time_us > ref->max_hop_time_us)
+      ref->max_hop_time_us = ref->hop_time_us;
   }
 
   void processOutput() {
@@ -115,15 +128,16 @@ class FFTRobotize : public FFTEffect {
   void effect(AudioFFTBase &fft) {
     TRACED();
     AudioFFTResult best = fft.result();
+    // one reciprocal instead of a division per bin
+    float factor = best.magnitude > 0.0f ? 1.0f / best.magnitude : 0.0f;
 
     FFTBin bin;
     for (int n = 0; n < fft.size(); n++) {
       float amplitude = fft.magnitude(n);
 
-      // update new bin value
-      bin.real = amplitude / best.magnitude;
+      // update new bin value: zero phase
+      bin.real = amplitude * factor;
       bin.img = 0.0;
-      Serial.println(bin.real);
 
       fft.setBin(n, bin);
     }
@@ -4,6 +4,9 @@
 #include "AudioTools/CoreAudio/AudioBasic/Str.h"
 #include "AudioTools/CoreAudio/AudioHttp/URLStream.h"
 #include "AudioTools/CoreAudio/StreamCopy.h"
+#if defined(USE_CONCURRENCY)
+#  include "AudioTools/AudioLibs/Concurrency.h"
+#endif
 
 #define MAX_HLS_LINE 512
 #define START_URLS_LIMIT 4
@@ -35,11 +38,24 @@ class URLLoaderHLS {
     buffer.resize(buffer_size * buffer_count);
 
     active = true;
+#if defined(USE_CONCURRENCY)
+    if (is_prefetch && !is_task_active) {
+      task.create("hls-prefetch", task_stack, task_priority, task_core);
+      task.begin([this]() { prefetchLoop(); });
+      is_task_active = true;
+    }
+#endif
     return true;
   }
 
   void end() {
     TRACED();
+#if defined(USE_CONCURRENCY)
+    if (is_task_active) {
+      task.end();
+      is_task_active = false;
+    }
+#endif
     url_stream.end();
     buffer.clear();
     active = false;
@@ -62,19 +78,25 @@ class URLLoaderHLS {
   int available() {
     if (!active) return 0;
     TRACED();
-    bufferRefill();
+    if (!isPrefetchActive()) bufferRefill();
 
-    return buffer.available();
+    lock();
+    int result = buffer.available();
+    unlock();
+    return result;
   }
 
   /// Provides data from the audio stream
   size_t readBytes(uint8_t *data, size_t len) {
     if (!active) return 0;
     TRACED();
-    bufferRefill();
+    if (!isPrefetchActive()) bufferRefill();
 
+    lock();
     if (buffer.available() < len) LOGW("Buffer underflow");
-    return buffer.readArray(data, len);
+    size_t result = buffer.readArray(data, len);
+    unlock();
+    return result;
   }
 
   const char *contentType() {
@@ -96,6 +118,35 @@ class URLLoaderHLS {
 
   void setCACert(const char *cert) { url_stream.setCACert(cert); }
 
+  /// Defines the allocator of the segment buffer: e.g. use AllocatorPSRAM
+  /// to keep a big buffer in psram - call before begin()
+  void setAllocator(Allocator &allocator) { buffer.setAllocator(allocator); }
+
+#if defined(USE_CONCURRENCY)
+  /// Downloads the next segment on a background task while the actual one
+  /// is still playing
+  void setPrefetch(bool active, int core = -1, int priority = 1,
+                   int stackSize = 10000) {
+    is_prefetch = active;
+    task_core = core;
+    task_priority = priority;
+    task_stack = stackSize;
+  }
+
+  /// Callback which is executed on the prefetch task before each refill:
+  /// used by the parser to reload the playlist in the background
+  void setPrefetchCallback(std::function<void()> cb) { prefetch_callback = cb; }
+#endif
+
+  /// Checks if the background prefetch task is filling the buffer
+  bool isPrefetchActive() {
+#if defined(USE_CONCURRENCY)
+    return is_task_active;
+#else
+    return false;
+#endif
+  }
+
  protected:
   Vector<const char *> urls{10};
   RingBuffer<uint8_t> buffer{0};
@@ -104,6 +155,44 @@ class URLLoaderHLS {
   int buffer_count = HLS_BUFFER_COUNT;
   URLStream url_stream;
   const char *url_to_play = nullptr;
+#if defined(USE_CONCURRENCY)
+  Task task;
+  Mutex mutex;
+  std::function<void()> prefetch_callback = nullptr;
+  bool is_prefetch = false;
+  bool is_task_active = false;
+  int task_core = -1;
+  int task_priority = 1;
+  int task_stack = 10000;
+
+  /// Executed on the prefetch task: keeps the playlist and the buffer
+  /// up to date while the actual segment is playing
+  void prefetchLoop() {
+    if (prefetch_callback) prefetch_callback();
+    bufferRefill();
+    delay(HLS_UNDER_OVERFLOW_WAIT_TIME);
+  }
+#endif
+
+  /// The buffer is shared between the prefetch task and the reader
+  inline void lock() {
+#if defined(USE_CONCURRENCY)
+    if (is_task_active) mutex.lock();
+#endif
+  }
+
+  inline void unlock() {
+#if defined(USE_CONCURRENCY)
+    if (is_task_active) mutex.unlock();
+#endif
+  }
+
+  int availableForWrite() {
+    lock();
+    int result = buffer.availableForWrite();
+    unlock();
+    return result;
+  }
 
   /// try to keep the buffer filled
   void bufferRefill() {
@@ -114,7 +203,7 @@ class URLLoaderHLS {
       delay(HLS_UNDER_OVERFLOW_WAIT_TIME);
       return;
     }
-    if (buffer.availableForWrite() == 0) {
+    if (availableForWrite() == 0) {
       LOGD("buffer full");
       delay(HLS_UNDER_OVERFLOW_WAIT_TIME);
       return;
@@ -141,7 +230,7 @@ class URLLoaderHLS {
 
     int total = 0;
     int failed = 0;
-    int to_write = min(buffer.availableForWrite(), DEFAULT_BUFFER_SIZE);
+    int to_write = min(availableForWrite(), DEFAULT_BUFFER_SIZE);
     // try to keep the buffer filled
     while (to_write > 0) {
       uint8_t tmp[to_write] = {0};
@@ -149,10 +238,12 @@ class URLLoaderHLS {
       total += read;
       if (read > 0) {
         failed = 0;
+        lock();
         buffer.writeArray(tmp, read);
         LOGD("buffer add %d -> %d:", read, buffer.available());
+        unlock();
 
-        to_write = min(buffer.availableForWrite(), DEFAULT_BUFFER_SIZE);
+        to_write = min(availableForWrite(), DEFAULT_BUFFER_SIZE);
       }
       // After we processed all data we close the stream to get a new url
       if (url_stream.totalRead() == url_stream.contentLength()) {
@@ -237,6 +328,11 @@ class HLSParser {
       segmentsActivate();
     }
 
+#if defined(USE_CONCURRENCY)
+    // reload the playlist from the prefetch task while a segment plays
+    url_loader.setPrefetchCallback([this]() { reloadSegments(); });
+#endif
+
     if (!url_loader.begin()) {
       TRACEE();
       return false;
@@ -250,7 +346,8 @@ class HLSParser {
     TRACED();
     int result = 0;
     custom_log_level.set();
-    reloadSegments();
+    // with prefetch the playlist is reloaded on the background task
+    if (!url_loader.isPrefetchActive()) reloadSegments();
 
     if (active) result = url_loader.available();
     custom_log_level.reset();
@@ -261,7 +358,8 @@ class HLSParser {
     TRACED();
     size_t result = 0;
     custom_log_level.set();
-    reloadSegments();
+    // with prefetch the playlist is reloaded on the background task
+    if (!url_loader.isPrefetchActive()) reloadSegments();
 
     if (active) result = url_loader.readBytes(data, len);
     custom_log_level.reset();
@@ -305,6 +403,18 @@ class HLSParser {
     url_loader.setBufferSize(size, count);
   }
 
+  /// Defines the allocator of the segment buffer (e.g. AllocatorPSRAM)
+  void setAllocator(Allocator &allocator) { url_loader.setAllocator(allocator); }
+
+#if defined(USE_CONCURRENCY)
+  /// Downloads the next segment and reloads the playlist on a background
+  /// task while the actual segment is playing
+  void setPrefetch(bool active, int core = -1, int priority = 1,
+                   int stackSize = 10000) {
+    url_loader.setPrefetch(active, core, priority, stackSize);
+  }
+#endif
+
   void setCACert(const char *cert) {
     url_stream.setCACert(cert);
     url_loader.setCACert(cert);
@@ -327,7 +437,6 @@ class HLSParser {
   bool is_extm3u = false;
   Str codec;
   Str segments_url_str;
-  Str url_str;
   const char *index_url_str = nullptr;
   URLStream url_stream;
   URLLoaderHLS url_loader;
@@ -335,6 +444,12 @@ class HLSParser {
   bool active = false;
   bool parse_segments_active = false;
   int media_sequence = 0;
+  /// highest media sequence number that was already handed to the loader:
+  /// on a live refresh all older segment lines are skipped
+  int64_t last_sequence = -1;
+  int playlist_sequence = 0;
+  int url_line_index = 0;
+  float pending_extinf_ms = 0;
   int segment_count = 0;
   uint64_t next_sement_load_time_planned = 0;
   float play_time = 0;
@@ -401,14 +516,13 @@ class HLSParser {
     bool result = true;
     is_extm3u = false;
 
-    // parse lines
-    memset(tmp, 0, MAX_HLS_LINE);
+    // parse lines: the StrView is just a slice over the line buffer
     while (true) {
-      memset(tmp, 0, MAX_HLS_LINE);
       size_t len =
-          url_stream.httpRequest().readBytesUntil('\n', tmp, MAX_HLS_LINE);
+          url_stream.httpRequest().readBytesUntil('\n', tmp, MAX_HLS_LINE - 1);
       // stop when there is no more data
       if (len == 0 && url_stream.available() == 0) break;
+      tmp[len] = '\0';
       StrView str(tmp);
 
       // check header
@@ -471,6 +585,9 @@ class HLSParser {
     next_sement_load_time_planned = millis();
     play_time = 0;
     next_sement_load_time = 0xFFFFFFFFFFFFFFFF;
+    playlist_sequence = 0;
+    url_line_index = 0;
+    pending_extinf_ms = 0;
   }
 
   /// parse the segment url provided by the index
@@ -534,12 +651,12 @@ class HLSParser {
     bool result = true;
     is_extm3u = false;
 
-    // parse lines
-    memset(tmp, 0, MAX_HLS_LINE);
+    // parse lines: the StrView is just a slice over the line buffer
     while (true) {
-      memset(tmp, 0, MAX_HLS_LINE);
-      size_t len = url_stream.httpRequest().readBytesUntil('\n', tmp, MAX_HLS_LINE);
+      size_t len =
+          url_stream.httpRequest().readBytesUntil('\n', tmp, MAX_HLS_LINE - 1);
       if (len == 0 && url_stream.available() == 0) break;
+      tmp[len] = '\0';
       StrView str(tmp);
 
       // check header
@@ -575,16 +692,22 @@ class HLSParser {
           LOGW("MEDIA-SEQUENCE already loaded: %d", media_sequence);
           return false;
         }
+        if (new_media_sequence < media_sequence) {
+          // server side discontinuity: forget the skip position
+          LOGW("MEDIA-SEQUENCE reset: %d -> %d", media_sequence,
+               new_media_sequence);
+          last_sequence = (int64_t)new_media_sequence - 1;
+        }
         media_sequence = new_media_sequence;
+        playlist_sequence = new_media_sequence;
       }
 
-      // add play time to next_sement_load_time_planned
+      // the play time only becomes relevant when its segment is new
       if (str.startsWith("#EXTINF")) {
         next_url_type = URLType::Segment;
         StrView sec_str(str.c_str() + 8);
         float sec = sec_str.toFloat();
-        LOGI("adding play time: %f sec", sec);
-        play_time += (sec * 1000.0);
+        pending_extinf_ms = sec * 1000.0;
       }
     }
     return true;
@@ -605,20 +728,32 @@ class HLSParser {
           }
           LOGD("segments_url_str = %s", segments_url_str.c_str());
           break;
-        case URLType::Segment:
+        case URLType::Segment: {
+          // incremental parsing: on a live refresh all segment lines up to
+          // the last loaded sequence number are skipped without copying
+          int64_t sequence = (int64_t)playlist_sequence + url_line_index++;
+          if (sequence <= last_sequence) {
+            LOGD("Sequence %d already loaded", (int)sequence);
+            break;
+          }
+          last_sequence = sequence;
           segment_count++;
-          if (url_history.add(str.c_str())) {
+          play_time += pending_extinf_ms;
+          pending_extinf_ms = 0;
+          // the url is only copied when it was selected
+          const char *url = str.c_str();
+          if (!str.startsWith("http")) {
+            // we create the complete url
+            url = resolve_url(str.c_str(), index_url_str);
+          }
+          if (url_history.add(url)) {
             // provide audio urls to the url_loader
-            if (str.startsWith("http")) {
-              url_str = str;
-            } else {
-              // we create the complete url
-              url_str = resolve_url(str.c_str(), index_url_str);
-            }
-            url_loader.addUrl(url_str.c_str());
+            url_loader.addUrl(url);
           } else {
-            LOGD("Duplicate ignored: %s", str.c_str());
+            LOGD("Duplicate ignored: %s", url);
           }
+          break;
+        }
       }
       // clear url type
       next_url_type = URLType::Undefined;
@@ -704,6 +839,20 @@ class HLSStream : public AbstractURLStream {
   /// Redefines the read buffer size
   void setBufferSize(int size, int count) { parser.setBufferSize(size, count); }
 
+  /// Defines the allocator of the segment buffer: use AllocatorPSRAM to
+  /// afford a bigger buffer in psram
+  void setAllocator(Allocator &allocator) { parser.setAllocator(allocator); }
+
+#if defined(USE_CONCURRENCY)
+  /// Activates the pipelined prefetch: segment n+1 is downloaded and the
+  /// playlist is refreshed on a background task while segment n plays, so
+  /// a segment boundary no longer risks an underrun
+  void setPrefetch(bool active, int core = -1, int priority = 1,
+                   int stackSize = 10000) {
+    parser.setPrefetch(active, core, priority, stackSize);
+  }
+#endif
+
   /// Defines the certificate
   void setCACert(const char *cert) { parser.setCACert(cert); }
 
@@ -4,6 +4,9 @@
 #include "AudioTools/CoreAudio/AudioBasic/Collections/Vector.h"
 #include "AudioTools/AudioLibs/AudioFFT.h"
 #include "FFTDisplay.h"
+#ifdef ESP32
+#include "AudioTools/Concurrency/RTOS/Task.h"
+#endif
 
 namespace audio_tools {
 
@@ -84,7 +87,14 @@ class LEDOutput {
     // clear LED
     FastLED.clear();  // clear all pixel data
 
+    // track the last bar height per column for the dirty check
+    last_bar.resize(cfg.x);
+    for (int j = 0; j < cfg.x; j++) {
+      last_bar[j] = -1;
+    }
+
     if (p_fft != nullptr) {
+      p_fft->setBands(cfg.x);
       p_fft->begin();
     }
 
@@ -93,6 +103,24 @@ class LEDOutput {
     return true;
   }
 
+#ifdef ESP32
+  /// Moves the FastLED.show() call to an own task, so that the led update
+  /// does not steal time from the audio processing
+  bool beginAsyncShow(int core = 1, int stackSize = 4096, int priority = 1) {
+    is_async_show = true;
+    show_pending = false;
+    if (!show_task.create("led-show", stackSize, priority, core)) return false;
+    return show_task.begin([this]() {
+      if (show_pending) {
+        show_pending = false;
+        FastLED.show();
+      } else {
+        delay(1);
+      }
+    });
+  }
+#endif
+
   /// Provides the number of LEDs: call begin() first!
   int ledCount() {
     int num_leds = cfg.x * cfg.y;
@@ -150,6 +178,17 @@ class LEDOutput {
     if (x > max_column) max_column = x;
   }
 
+  /// Update the indicated column only when the bar height changed: returns
+  /// true when the column was dirty and has been repainted
+  bool updateColumnBar(int x, int currY) {
+    if (x >= 0 && x < last_bar.size()) {
+      if (last_bar[x] == currY) return false;
+      last_bar[x] = currY;
+    }
+    setColumnBar(x, currY);
+    return true;
+  }
+
   /// Update the last column with the indicated bar
   void setColumnBar(int currY) { setColumnBar(cfg.x - 1, currY); }
 
@@ -186,8 +225,15 @@ class LEDOutput {
     return max;
   }
 
-  /// Update the led_matrix (calling FastLED.show();
+  /// Update the led_matrix (calling FastLED.show() - or just flagging the
+  /// show task when beginAsyncShow() was used)
   void display() {
+#ifdef ESP32
+    if (is_async_show) {
+      show_pending = true;
+      return;
+    }
+#endif
     FastLED.show();
   }
 
@@ -198,11 +244,17 @@ class LEDOutput {
   friend class AudioFFTBase;
   CRGB not_valid;
   Vector<CRGB> leds{0};
+  Vector<int> last_bar{0};
   LEDOutputConfig cfg;
   VolumeMeter *p_vol = nullptr;
   FFTDisplay *p_fft = nullptr;
   uint64_t count = 0;
   int max_column = -1;
+#ifdef ESP32
+  Task show_task;
+  volatile bool show_pending = false;
+  bool is_async_show = false;
+#endif
 
   /// Adds an empty column to the end shifting the content to the left
   void addEmptyColumn() {
@@ -252,15 +304,17 @@ class LEDOutput {
 
 /// Default update implementation which provides the fft result as "barchart"
 void fftLEDOutput(LEDOutputConfig *cfg, LEDOutput *matrix) {
-  // process horizontal
+  // process horizontal: repaint only the dirty columns
   LockGuard guard(fft_mux);
+  bool is_dirty = false;
   for (int x = 0; x < cfg->x; x++) {
     // max y determined by magnitude
     int currY = matrix->fftDisplay().getMagnitudeScaled(x, cfg->y);
     LOGD("x: %d, y: %d", x, currY);
-    matrix->setColumnBar(x, currY);
+    if (matrix->updateColumnBar(x, currY)) is_dirty = true;
   }
-  FastLED.show();
+  // skip the show() when nothing changed
+  if (is_dirty) matrix->display();
 }
 
 /// Default update implementation which provides the fft result as "barchart"
@@ -270,7 +324,7 @@ void volumeLEDOutput(LEDOutputConfig *cfg, LEDOutput *matrix) {
                        cfg->max_magnitude, 0.0f,
                        static_cast<float>(cfg->y));
   matrix->addColumnBar(currY);
-  FastLED.show();
+  matrix->display();
 }
 
 /// Default logic to update the color for the indicated x,y position
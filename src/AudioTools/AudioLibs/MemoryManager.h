@@ -1,6 +1,7 @@
 #pragma once
 
 #include "AudioLogger.h"
+#include "AudioTools/CoreAudio/AudioBasic/Collections/Allocator.h"
 #ifdef ESP32
 #include "esp_heap_caps.h"
 #endif
@@ -35,4 +36,166 @@ public:
   }
 };
 
+/**
+ * @brief Memory accounting tags: each tag identifies the subsystem which
+ * owns the allocation
+ * @ingroup memorymgmt
+ */
+enum MemoryTag : uint8_t {
+  MemoryTagOther = 0,
+  MemoryTagBuffer,
+  MemoryTagCodec,
+  MemoryTagNetwork,
+  MemoryTagLast  // number of tags: not a valid tag
+};
+
+/**
+ * @brief Per subsystem memory accounting: allocations done via an
+ * AllocatorTracked are booked here by tag, so you can see which component
+ * (buffer, codec, network) the heap usage belongs to. Use dump() for a
+ * snapshot (current bytes, peak bytes, allocation count per tag) and
+ * checkpoint()/leakCheck() around a begin()/end() cycle to find the
+ * subsystem which did not give its memory back.
+ * @ingroup memorymgmt
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ */
+class MemoryAccounting {
+ public:
+  /// Provides the (single) instance
+  static MemoryAccounting &instance() {
+    static MemoryAccounting accounting;
+    return accounting;
+  }
+
+  /// Books an allocation: called by AllocatorTracked
+  void onAllocate(MemoryTag tag, size_t size) {
+    if (tag >= MemoryTagLast) tag = MemoryTagOther;
+    used_bytes[tag] += size;
+    alloc_count[tag]++;
+    if (used_bytes[tag] > peak_bytes[tag]) peak_bytes[tag] = used_bytes[tag];
+  }
+
+  /// Books a release: called by AllocatorTracked
+  void onFree(MemoryTag tag, size_t size) {
+    if (tag >= MemoryTagLast) tag = MemoryTagOther;
+    used_bytes[tag] = used_bytes[tag] >= size ? used_bytes[tag] - size : 0;
+  }
+
+  /// Currently allocated bytes for the tag
+  size_t usedBytes(MemoryTag tag) { return used_bytes[tag]; }
+
+  /// Highest number of allocated bytes ever seen for the tag
+  size_t peakBytes(MemoryTag tag) { return peak_bytes[tag]; }
+
+  /// Total number of allocations done for the tag
+  size_t allocationCount(MemoryTag tag) { return alloc_count[tag]; }
+
+  /// Remembers the current usage per tag as reference for leakCheck()
+  void checkpoint() {
+    for (int j = 0; j < MemoryTagLast; j++) mark_bytes[j] = used_bytes[j];
+  }
+
+  /// Compares the current usage against the last checkpoint() and logs the
+  /// tags which grew: returns true if nothing grew
+  bool leakCheck() {
+    bool result = true;
+    for (int j = 0; j < MemoryTagLast; j++) {
+      if (used_bytes[j] > mark_bytes[j]) {
+        LOGW("memory leak %s: %zu -> %zu bytes", tagName((MemoryTag)j),
+             mark_bytes[j], used_bytes[j]);
+        result = false;
+      }
+    }
+    return result;
+  }
+
+  /// Writes the usage snapshot per tag: tag;bytes;peak;count
+  void dump(Print &out) {
+    char line[80];
+    for (int j = 0; j < MemoryTagLast; j++) {
+      snprintf(line, sizeof(line), "%s;%zu;%zu;%zu", tagName((MemoryTag)j),
+               used_bytes[j], peak_bytes[j], alloc_count[j]);
+      out.println(line);
+    }
+  }
+
+  /// Resets all counters and checkpoints
+  void clear() {
+    for (int j = 0; j < MemoryTagLast; j++) {
+      used_bytes[j] = 0;
+      peak_bytes[j] = 0;
+      alloc_count[j] = 0;
+      mark_bytes[j] = 0;
+    }
+  }
+
+  /// Provides the tag name
+  const char *tagName(MemoryTag tag) {
+    switch (tag) {
+      case MemoryTagBuffer:
+        return "buffer";
+      case MemoryTagCodec:
+        return "codec";
+      case MemoryTagNetwork:
+        return "network";
+      default:
+        return "other";
+    }
+  }
+
+ protected:
+  MemoryAccounting() = default;
+  size_t used_bytes[MemoryTagLast] = {0};
+  size_t peak_bytes[MemoryTagLast] = {0};
+  size_t alloc_count[MemoryTagLast] = {0};
+  size_t mark_bytes[MemoryTagLast] = {0};
+};
+
+/**
+ * @brief Decorator which books all allocations of the wrapped allocator
+ * in the MemoryAccounting under the indicated tag. The size and tag are
+ * stored in a small header in front of the returned region so that free()
+ * can book the release without any lookup table. Pass an instance to the
+ * buffers, codecs or network components which should be accounted, e.g.
+ * Vector<uint8_t> data{tracked_allocator};
+ * @ingroup memorymgmt
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ */
+class AllocatorTracked : public Allocator {
+ public:
+  AllocatorTracked(MemoryTag tag, Allocator &allocator = DefaultAllocator) {
+    this->tag = tag;
+    p_allocator = &allocator;
+  }
+
+  void free(void *memory) override {
+    if (memory == nullptr) return;
+    Header *header = ((Header *)memory) - 1;
+    MemoryAccounting::instance().onFree((MemoryTag)header->tag, header->size);
+    p_allocator->free(header);
+  }
+
+ protected:
+  /// bookkeeping header in front of each allocation: 8 byte aligned
+  struct Header {
+    size_t size;
+    size_t tag;
+  };
+
+  MemoryTag tag = MemoryTagOther;
+  Allocator *p_allocator = nullptr;
+
+  void *do_allocate(size_t size) override {
+    if (size == 0) size = 1;
+    Header *header = (Header *)p_allocator->allocate(size + sizeof(Header));
+    if (header == nullptr) return nullptr;
+    header->size = size;
+    header->tag = tag;
+    MemoryAccounting::instance().onAllocate(tag, size);
+    return (void *)(header + 1);
+  }
+};
+
 }
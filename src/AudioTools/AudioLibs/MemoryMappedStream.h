@@ -0,0 +1,83 @@
+#pragma once
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "AudioTools/CoreAudio/AudioStreams.h"
+
+namespace audio_tools {
+
+/**
+ * @brief Memory mapped file source for desktop builds: the file is mapped
+ * into the address space with mmap and served through the MemoryStream
+ * API, so the reads are zero copy and batch processing benefits from the
+ * OS page cache. MADV_SEQUENTIAL lets the kernel read ahead aggressively.
+ * Use begin(path) to map a file and end() (or a new begin) to unmap it.
+ * @author Phil Schatzmann
+ * @ingroup io
+ * @copyright GPLv3
+ */
+class MemoryMappedStream : public MemoryStream {
+ public:
+  MemoryMappedStream() = default;
+
+  MemoryMappedStream(const char *path) { begin(path); }
+
+  ~MemoryMappedStream() { unmap(); }
+
+  /// Maps the indicated file
+  bool begin(const char *path) {
+    TRACED();
+    unmap();
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0) {
+      LOGE("open failed: %s", path);
+      return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+      LOGE("invalid file: %s", path);
+      ::close(fd);
+      return false;
+    }
+    mapped_size = st.st_size;
+    mapped = mmap(nullptr, mapped_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // the mapping stays valid after the descriptor is closed
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+      LOGE("mmap failed: %s", path);
+      mapped = nullptr;
+      mapped_size = 0;
+      return false;
+    }
+    // audio files are processed sequentially: let the kernel read ahead
+    madvise(mapped, mapped_size, MADV_SEQUENTIAL);
+    setValue((const uint8_t *)mapped, mapped_size, FLASH_RAM);
+    return MemoryStream::begin();
+  }
+
+  void end() override {
+    MemoryStream::end();
+    unmap();
+  }
+
+  /// Size of the mapped file in bytes
+  size_t size() { return mapped_size; }
+
+ protected:
+  void *mapped = nullptr;
+  size_t mapped_size = 0;
+
+  void unmap() {
+    if (mapped != nullptr) {
+      munmap(mapped, mapped_size);
+      mapped = nullptr;
+      mapped_size = 0;
+      // prevent the MemoryStream destructor from freeing the mapping
+      setValue(nullptr, 0, FLASH_RAM);
+    }
+  }
+};
+
+}  // namespace audio_tools
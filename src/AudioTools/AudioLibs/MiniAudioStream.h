@@ -41,6 +41,17 @@ class MiniAudioConfig : public AudioInfo {
   int delay_ms_if_buffer_full = MA_DELAY;
   int buffer_count = MA_BUFFER_COUNT;
   int buffer_start_count = MA_START_COUNT;
+
+  /// Requested period size in frames (0 = miniaudio default): small values
+  /// (e.g. 128) reduce the latency
+  int period_size_frames = 0;
+  /// Requested number of periods (0 = miniaudio default)
+  int period_count = 0;
+  /// Low latency mode: the device is asked for the low latency profile, the
+  /// ring holds only a few periods, playback starts with the first one and
+  /// the callback never blocks - on an empty ring silence is played and
+  /// counted as underrun instead
+  bool is_low_latency = false;
 };
 
 /**
@@ -116,6 +127,7 @@ class MiniAudioStream : public AudioStream {
 
     config_ma.pUserData = this;
     config_ma.playback.channels = config.channels;
+    config_ma.capture.channels = config.channels;
     config_ma.sampleRate = config.sample_rate;
     config_ma.dataCallback = data_callback;
     switch (config.bits_per_sample) {
@@ -135,6 +147,20 @@ class MiniAudioStream : public AudioStream {
         LOGE("Invalid format");
         return false;
     }
+    config_ma.capture.format = config_ma.playback.format;
+
+    // explicit period configuration: small periods reduce the latency
+    if (config.period_size_frames > 0)
+      config_ma.periodSizeInFrames = config.period_size_frames;
+    if (config.period_count > 0) config_ma.periods = config.period_count;
+    if (config.is_low_latency) {
+      config_ma.performanceProfile = ma_performance_profile_low_latency;
+      // keep the ring small and start playing with the first period
+      if (config.buffer_count == MA_BUFFER_COUNT) config.buffer_count = 4;
+      config.buffer_start_count = 1;
+      underrun_count = 0;
+      overrun_count = 0;
+    }
 
     if (ma_device_init(NULL, &config_ma, &device_ma) != MA_SUCCESS) {
       // Failed to initialize the device.
@@ -205,6 +231,26 @@ class MiniAudioStream : public AudioStream {
     return buffer_in.readArray(data, len);
   }
 
+  /// Duplex processing callback: input and output of one period
+  typedef void (*DuplexCallback)(const uint8_t *input, uint8_t *output,
+                                 size_t bytes, void *ref);
+
+  /// Defines a callback which processes the captured period directly into
+  /// the playback period inside the miniaudio callback: the shortest
+  /// possible round trip, no rings involved. Only used in duplex mode
+  void setDuplexCallback(DuplexCallback cb, void *ref = nullptr) {
+    duplex_callback = cb;
+    duplex_ref = ref;
+  }
+
+  /// Number of playback periods which were filled with silence because the
+  /// output ring was empty (low latency mode)
+  uint32_t underruns() { return underrun_count; }
+
+  /// Number of capture periods which were (partly) dropped because the
+  /// input ring was full (low latency mode)
+  uint32_t overruns() { return overrun_count; }
+
  protected:
   MiniAudioConfig config;
   ma_device_config config_ma;
@@ -217,6 +263,10 @@ class MiniAudioStream : public AudioStream {
   std::mutex write_mtx;
   std::mutex read_mtx;
   int buffer_size = 0;
+  DuplexCallback duplex_callback = nullptr;
+  void *duplex_ref = nullptr;
+  volatile uint32_t underrun_count = 0;
+  volatile uint32_t overrun_count = 0;
 
   // In playback mode copy data to pOutput. In capture mode read data from
   // pInput. In full-duplex mode, both pOutput and pInput will be valid and
@@ -249,37 +299,58 @@ class MiniAudioStream : public AudioStream {
     int bytes = frameCount * cfg.channels * cfg.bits_per_sample / 8;
     self->setupBuffers(bytes);
 
-    if (pInput) {
-      int open = bytes;
-      int processed = 0;
-      while (open > 0) {
-        int len = 0;
-        {
-          std::unique_lock<std::mutex> guard(self->read_mtx);
-          int len =
-              self->buffer_in.writeArray((uint8_t *)pInput + processed, open);
-          open -= len;
-          processed += len;
-        }
-        if (len == 0) self->doWait();
-      }
+    // duplex processing without any rings: the shortest round trip
+    if (pInput && pOutput && self->duplex_callback != nullptr) {
+      self->duplex_callback((const uint8_t *)pInput, (uint8_t *)pOutput, bytes,
+                            self->duplex_ref);
+      return;
     }
 
-    if (pOutput) {
-      memset(pOutput, 0, bytes);
-      if (self->is_playing) {
+    if (pInput) {
+      if (self->config.is_low_latency) {
+        // never block in the callback: drop and count instead
+        std::lock_guard<std::mutex> guard(self->read_mtx);
+        int len = self->buffer_in.writeArray((uint8_t *)pInput, bytes);
+        if (len < bytes) self->overrun_count++;
+      } else {
         int open = bytes;
         int processed = 0;
         while (open > 0) {
-          size_t len = 0;
+          int len = 0;
           {
-            std::lock_guard<std::mutex> guard(self->write_mtx);
-            len = self->buffer_out.readArray((uint8_t *)pOutput + processed,
-                                             bytes);
+            std::unique_lock<std::mutex> guard(self->read_mtx);
+            len =
+                self->buffer_in.writeArray((uint8_t *)pInput + processed, open);
             open -= len;
             processed += len;
           }
-          if (len != bytes) self->doWait();
+          if (len == 0) self->doWait();
+        }
+      }
+    }
+
+    if (pOutput) {
+      memset(pOutput, 0, bytes);
+      if (self->is_playing) {
+        if (self->config.is_low_latency) {
+          // never block in the callback: play silence and count instead
+          std::lock_guard<std::mutex> guard(self->write_mtx);
+          int len = self->buffer_out.readArray((uint8_t *)pOutput, bytes);
+          if (len < bytes) self->underrun_count++;
+        } else {
+          int open = bytes;
+          int processed = 0;
+          while (open > 0) {
+            size_t len = 0;
+            {
+              std::lock_guard<std::mutex> guard(self->write_mtx);
+              len = self->buffer_out.readArray((uint8_t *)pOutput + processed,
+                                               open);
+              open -= len;
+              processed += len;
+            }
+            if (len != bytes) self->doWait();
+          }
         }
       }
     }
@@ -74,18 +74,35 @@ class MozziStream : public AudioStream, public VolumeSupport {
     return VolumeSupport::setVolume(vol);
   }
 
-  /// Provides the data filled by calling updateAudio()
+  /// Provides the data filled by calling updateAudio(): the samples are
+  /// rendered in runs up to the next control update, so the control rate
+  /// check is not executed per sample
   size_t readBytes(uint8_t* data, size_t len) {
     if (!active) return 0;
     int samples = len / sizeof(int16_t);
     int frames = samples / cfg.channels;
     int16_t* data16 = (int16_t*)data;
     int idx = 0;
-    for (int j = 0; j < frames; j++) {
-      int16_t sample = nextSample();
-      for (int ch = 0; ch < cfg.channels; ch++) {
-        data16[idx++] = sample;
+    int j = 0;
+    while (j < frames) {
+      if (control_counter <= 0) {
+        control_counter = control_counter_max;
+        LOGD("updateControl");
+        updateControl();
       }
+      int run = min(control_counter, frames - j);
+      for (int k = 0; k < run; k++) {
+        // updateAudio() STANDARD mode is between -244 and 243 inclusive
+        auto result = updateAudio() * cfg.output_volume;
+        // clip result
+        if (result > 32767) result = 32767;
+        if (result < -32768) result = -32768;
+        for (int ch = 0; ch < cfg.channels; ch++) {
+          data16[idx++] = result;
+        }
+      }
+      control_counter -= run;
+      j += run;
     }
     return idx * sizeof(int16_t);
   }
@@ -1,5 +1,14 @@
 #include "AudioTools/CoreAudio/AudioStreams.h"
 #include "AudioTools/CoreAudio/Buffers.h"
+#ifdef ESP32
+#  include "AudioTools/Concurrency/RTOS/BufferRTOS.h"
+#  include "AudioTools/Concurrency/RTOS/Task.h"
+#endif
+
+/// Size of the control message mailbox of PureDataStreamAsync
+#ifndef PD_MAILBOX_SIZE
+#define PD_MAILBOX_SIZE 16
+#endif
 
 namespace audio_tools {
 
@@ -127,4 +136,190 @@ class PureDataStream : public AudioStream {
   }
 };
 
+#ifdef ESP32
+
+/**
+ * @brief PureDataStream which runs the pd (heavy) processing on a dedicated
+ * FreeRTOS task: the rendered blocks are exchanged with the audio driver
+ * through thread safe buffers, and control messages (e.g. from a UI slider)
+ * go through a lock-free single-writer mailbox which the pd task applies at
+ * block boundaries - so a parameter update can never delay the 64-sample
+ * pd block schedule.
+ * @ingroup io
+ * @author phil schatzmann
+ */
+class PureDataStreamAsync : public PureDataStream {
+ public:
+  PureDataStreamAsync(HeavyContextInterface &heavy, int bufferSize = 1024 * 2,
+                      int core = 1, int priority = 1, int stackSize = 8192)
+      : PureDataStream(heavy, bufferSize) {
+    this->core = core;
+    this->priority = priority;
+    stack_size = stackSize;
+  }
+
+  ~PureDataStreamAsync() { end(); }
+
+  bool begin() {
+    if (!PureDataStream::begin()) return false;
+    if (out_channels > 0) {
+      buffer_out_rtos.resize(buffer_size);
+      buffer_out_rtos.setReadMaxWait(5);
+      buffer_out_rtos.setWriteMaxWait(5);
+    }
+    if (in_channels > 0) {
+      buffer_in_rtos.resize(buffer_size);
+      buffer_in_rtos.setReadMaxWait(5);
+      buffer_in_rtos.setWriteMaxWait(5);
+    }
+    active = true;
+    task.create("puredata", stack_size, priority, core);
+    task.begin([this]() { process(); });
+    return true;
+  }
+
+  void end() {
+    active = false;
+    task.end();
+    buffer_out_rtos.resize(0);
+    buffer_in_rtos.resize(0);
+    PureDataStream::end();
+  }
+
+  /// serves the blocks rendered by the pd task
+  size_t readBytes(uint8_t *data, size_t len) {
+    if (!active) return 0;
+    return buffer_out_rtos.readArray(data, len);
+  }
+
+  /// queues the input data for the pd task
+  size_t write(const uint8_t *data, size_t len) {
+    if (!active) return 0;
+    return buffer_in_rtos.writeArray(data, len);
+  }
+
+  int available() override { return buffer_out_rtos.available(); }
+
+  int availableForWrite() override { return buffer_in_rtos.availableForWrite(); }
+
+  /// Queues a float for the indicated receiver: lock-free, the pd task
+  /// applies it at the next block boundary
+  bool sendFloat(uint32_t receiverHash, float value) {
+    return enqueue(receiverHash, value, false);
+  }
+
+  /// Queues a float for the named receiver
+  bool sendFloat(const char *receiverName, float value) {
+    return sendFloat(HeavyContextInterface::getHashForString(receiverName),
+                     value);
+  }
+
+  /// Queues a bang for the indicated receiver
+  bool sendBang(uint32_t receiverHash) { return enqueue(receiverHash, 0, true); }
+
+  /// Queues a bang for the named receiver
+  bool sendBang(const char *receiverName) {
+    return sendBang(HeavyContextInterface::getHashForString(receiverName));
+  }
+
+ protected:
+  /// control message queued for the pd task
+  struct PdMessage {
+    uint32_t hash = 0;
+    float value = 0;
+    bool is_bang = false;
+  };
+
+  BufferRTOS<uint8_t> buffer_out_rtos{0};
+  BufferRTOS<uint8_t> buffer_in_rtos{0};
+  Task task;
+  Vector<int16_t> tmp_int16{0};
+  PdMessage mailbox[PD_MAILBOX_SIZE];
+  volatile uint8_t msg_write = 0;
+  volatile uint8_t msg_read = 0;
+  int core;
+  int priority;
+  int stack_size;
+  volatile bool active = false;
+
+  /// single writer: called from the control context only
+  bool enqueue(uint32_t hash, float value, bool isBang) {
+    if ((uint8_t)(msg_write - msg_read) >= PD_MAILBOX_SIZE) {
+      LOGW("pd mailbox full");
+      return false;
+    }
+    PdMessage &msg = mailbox[msg_write % PD_MAILBOX_SIZE];
+    msg.hash = hash;
+    msg.value = value;
+    msg.is_bang = isBang;
+    msg_write++;
+    return true;
+  }
+
+  /// task loop: applies the queued control messages and renders one batch
+  /// of pd blocks
+  void process() {
+    if (!active) {
+      delay(10);
+      return;
+    }
+
+    // apply the control messages at the block boundary
+    while (msg_read != msg_write) {
+      PdMessage msg = mailbox[msg_read % PD_MAILBOX_SIZE];
+      msg_read++;
+      if (msg.is_bang) {
+        p_heavy->sendBangToReceiver(msg.hash);
+      } else {
+        p_heavy->sendFloatToReceiver(msg.hash, msg.value);
+      }
+    }
+
+    // render a multiple of the pd block size
+    int frames = HV_N_SIMD * 4;
+    int samples_in = frames * in_channels;
+    int samples_out = frames * out_channels;
+    int bytes_in = samples_in * sample_size;
+    int bytes_out = samples_out * sample_size;
+
+    // wait until the input is available and the output fits
+    if (in_channels > 0 && buffer_in_rtos.available() < bytes_in) {
+      delay(1);
+      return;
+    }
+    if (out_channels > 0 && buffer_out_rtos.availableForWrite() < bytes_out) {
+      delay(1);
+      return;
+    }
+
+    if ((int)in.size() < samples_in) in.resize(samples_in);
+    if ((int)out.size() < samples_out) out.resize(samples_out);
+    if ((int)tmp_int16.size() < std::max(samples_in, samples_out))
+      tmp_int16.resize(std::max(samples_in, samples_out));
+
+    // convert int16 to float
+    if (in_channels > 0) {
+      buffer_in_rtos.readArray((uint8_t *)tmp_int16.data(), bytes_in);
+      for (int j = 0; j < samples_in; j++) {
+        in[j] = volume * tmp_int16[j] / max_int;
+      }
+    }
+
+    // process data
+    int frames_eff =
+        p_heavy->processInlineInterleaved(in.data(), out.data(), frames);
+    assert(frames == frames_eff);
+
+    // convert output to int16
+    if (out_channels > 0) {
+      for (int j = 0; j < samples_out; j++) {
+        tmp_int16[j] = volume * out[j] * max_int;
+      }
+      buffer_out_rtos.writeArray((uint8_t *)tmp_int16.data(), bytes_out);
+    }
+  }
+};
+
+#endif  // ESP32
+
 }  // namespace audio_tools
\ No newline at end of file
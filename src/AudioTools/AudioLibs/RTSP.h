@@ -3,6 +3,7 @@
 #include "AudioStreamer.h"
 #include "AudioTools/CoreAudio/AudioPlayer.h"
 #include "AudioTools/CoreAudio/AudioStreams.h"
+#include "AudioTools/CoreAudio/AudioTimer/AudioTimer.h"
 #include "IAudioSource.h"
 #include "RTSPServer.h"
 
@@ -598,5 +599,222 @@ protected:
   AudioStreamer rtsp_streamer;
 };
 
+/**
+ * @brief Shared scheduler for multiple RTSP sessions: the audio is encoded
+ * only once into a common history ring and each session is served from its
+ * own read cursor, so that serving N clients costs one encoder instead of
+ * N. Each session keeps its own RTP sequence and timestamp state. If an
+ * input stream is defined, one shared timer drives the refill for all
+ * sessions, so only a single periodic wakeup is needed.
+ * Depends on the https://github.com/pschatzmann/Micro-RTSP-Audio/ library
+ * @ingroup rtsp
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ */
+class RTSPMultiOutput : public AudioOutput {
+public:
+  /**
+   * @brief IAudioSource view into the shared history ring: assign one
+   * instance (see createSource()) to the AudioStreamer of each session
+   */
+  class Source : public IAudioSource {
+  public:
+    Source(RTSPMultiOutput &out) { p_out = &out; }
+
+    RTSPFormat *getFormat() override { return p_out->p_format; }
+
+    /// Copies the next fragment for this session from the shared ring
+    int readBytes(void *dest, int byteCount) override {
+      if (!started) return 0;
+      int result = p_out->readHistory(read_pos, (uint8_t *)dest, byteCount);
+      if (result > 0) {
+        sequence++;
+        int frame_size =
+            p_out->cfg.channels * p_out->cfg.bits_per_sample / 8;
+        if (frame_size > 0) timestamp += result / frame_size;
+      }
+      return result;
+    }
+
+    void start() override {
+      TRACEI();
+      IAudioSource::start();
+      // start at the current live position
+      read_pos = p_out->writePos();
+      started = true;
+    }
+
+    void stop() override {
+      TRACEI();
+      IAudioSource::stop();
+      started = false;
+    }
+
+    /// RTP sequence number of this session
+    uint16_t rtpSequence() { return sequence; }
+
+    /// RTP timestamp (in frames) of this session
+    uint32_t rtpTimestamp() { return timestamp; }
+
+  protected:
+    RTSPMultiOutput *p_out = nullptr;
+    uint64_t read_pos = 0;
+    uint16_t sequence = 0;
+    uint32_t timestamp = 0;
+    bool started = false;
+  };
+
+  /// Default constructor using RTSPFormatPCM and no encoder
+  RTSPMultiOutput(int history_size = 1024 * 4) {
+    history.resize(history_size);
+    p_encoder->setOutput(history_out);
+  }
+
+  /// Constructor with the format and encoder which is executed only once
+  /// for all sessions
+  RTSPMultiOutput(RTSPFormatAudioTools &format, AudioEncoder &encoder,
+                  int history_size = 1024 * 4) {
+    history.resize(history_size);
+    p_format = &format;
+    p_encoder = &encoder;
+    p_encoder->setOutput(history_out);
+  }
+
+  ~RTSPMultiOutput() {
+    for (Source *source : sources) delete source;
+  }
+
+  /// Defines the input which is pumped by the shared timer
+  void setInput(Stream &input) { p_timer_input = &input; }
+
+  /// Creates the IAudioSource for one additional session
+  Source *createSource() {
+    Source *result = new Source(*this);
+    sources.push_back(result);
+    return result;
+  }
+
+  bool begin(AudioInfo info) {
+    cfg = info;
+    return begin();
+  }
+
+  bool begin() {
+    TRACEI();
+    if (p_encoder == nullptr) {
+      LOGE("encoder is null");
+      return false;
+    }
+    if (p_format == nullptr) {
+      LOGE("format is null");
+      return false;
+    }
+    p_encoder->setAudioInfo(cfg);
+    p_encoder->begin();
+    p_format->begin(cfg);
+#ifdef USE_TIMER
+    // a single timer tick refills the shared ring for all sessions
+    if (p_timer_input != nullptr) {
+      tick_buffer.resize(p_format->fragmentSize());
+      timer.setCallbackParameter(this);
+      timer.begin(timerCallback, p_format->timerPeriod(), MS);
+    }
+#endif
+    return true;
+  }
+
+  void end() override {
+#ifdef USE_TIMER
+    timer.end();
+#endif
+    for (Source *source : sources) source->stop();
+  }
+
+  int availableForWrite() override { return history.size(); }
+
+  /// Writes PCM data which is encoded once into the shared history ring
+  size_t write(const uint8_t *data, size_t len) override {
+    TRACED();
+    return p_encoder->write(data, len);
+  }
+
+protected:
+  /**
+   * @brief Output of the encoder: appends the encoded data to the shared
+   * history ring
+   */
+  class HistoryOutput : public AudioOutput {
+  public:
+    HistoryOutput(RTSPMultiOutput &out) { p_out = &out; }
+    size_t write(const uint8_t *data, size_t len) override {
+      p_out->appendHistory(data, len);
+      return len;
+    }
+
+  protected:
+    RTSPMultiOutput *p_out = nullptr;
+  };
+
+  RTSPFormatPCM pcm;
+  CopyEncoder copy_encoder;
+  HistoryOutput history_out{*this};
+  Vector<uint8_t> history{0};
+  Vector<Source *> sources;
+  uint64_t write_pos = 0;
+  AudioEncoder *p_encoder = &copy_encoder;
+  RTSPFormatAudioTools *p_format = &pcm;
+  Stream *p_timer_input = nullptr;
+#ifdef USE_TIMER
+  TimerAlarmRepeating timer;
+  Vector<uint8_t> tick_buffer{0};
+
+  /// Single shared tick: reads one fragment and encodes it for all sessions
+  static void timerCallback(void *ref) {
+    RTSPMultiOutput *self = (RTSPMultiOutput *)ref;
+    int len = self->p_timer_input->readBytes(self->tick_buffer.data(),
+                                             self->tick_buffer.size());
+    if (len > 0) self->write(self->tick_buffer.data(), len);
+  }
+#endif
+
+  uint64_t writePos() { return write_pos; }
+
+  /// Appends the data to the ring: old data is overwritten, the absolute
+  /// write position keeps growing
+  void appendHistory(const uint8_t *data, size_t len) {
+    size_t size = history.size();
+    if (size == 0) return;
+    size_t pos = 0;
+    while (pos < len) {
+      size_t offset = write_pos % size;
+      size_t to_copy = min(len - pos, size - offset);
+      memcpy(history.data() + offset, data + pos, to_copy);
+      write_pos += to_copy;
+      pos += to_copy;
+    }
+  }
+
+  /// Copies the data starting at the indicated absolute position: a cursor
+  /// which fell out of the history window is moved to the oldest valid data
+  int readHistory(uint64_t &pos, uint8_t *dest, int len) {
+    size_t size = history.size();
+    if (size == 0) return 0;
+    if (write_pos - pos > size) {
+      LOGW("session too slow: skipping ahead");
+      pos = write_pos - size;
+    }
+    int result = min((int)(write_pos - pos), len);
+    int copied = 0;
+    while (copied < result) {
+      size_t offset = pos % size;
+      size_t to_copy = min((size_t)(result - copied), size - offset);
+      memcpy(dest + copied, history.data() + offset, to_copy);
+      pos += to_copy;
+      copied += to_copy;
+    }
+    return result;
+  }
+};
+
 
 } // namespace audio_tools
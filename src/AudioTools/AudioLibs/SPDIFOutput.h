@@ -236,32 +236,45 @@ class SPDIFOutput : public AudioStream {
   size_t write(const uint8_t *data, size_t len) {
     if (!i2sOn) return 0;
     const uint8_t *p = data;
+    const uint8_t *p_end = data + len;
     size_t result = 0;
-
-    while (p < (uint8_t *)data + len) {
-      // convert PCM 16bit data to BMC 32bit pulse pattern
+    // local copies, so the hot loop works on registers
+    uint32_t *ptr = spdif_ptr;
+    uint32_t *const buf_end = &spdif_buf[SPDIF_BUF_ARRAY_SIZE];
+
+    while (p < p_end) {
+      // convert PCM 16bit data to BMC 32bit pulse pattern: block encoded
+      // per channel mode, so there is no per sample branch and the wrap
+      // check is folded into the loop bound
       if (cfg.channels == 2) {
-        *(spdif_ptr + 1) =
-            (uint32_t)(((bmc_tab[*p] << 16) ^ bmc_tab[*(p + 1)]) << 1) >> 1;
-        p += 2;
+        while (p < p_end && ptr < buf_end) {
+          *(ptr + 1) =
+              (uint32_t)(((bmc_tab[p[0]] << 16) ^ bmc_tab[p[1]]) << 1) >> 1;
+          p += 2;
+          ptr += 2;
+          result += 2;
+        }
       } else {
-        // must be one channels -> use the same value for both
-        *(spdif_ptr + 1) =
-            (uint32_t)(((bmc_tab[*p] << 16) ^ bmc_tab[*(p)]) << 1) >> 1;
-        p++;
+        // must be one channel -> use the same value for both
+        while (p < p_end && ptr < buf_end) {
+          int32_t bmc = bmc_tab[p[0]];
+          *(ptr + 1) = (uint32_t)(((bmc << 16) ^ bmc) << 1) >> 1;
+          p++;
+          ptr += 2;
+          result += 2;
+        }
       }
-      result += 2;
-      spdif_ptr += 2;  // advance to next audio data
 
-      if (spdif_ptr >= &spdif_buf[SPDIF_BUF_ARRAY_SIZE]) {
+      if (ptr >= buf_end) {
         // set block start preamble
         ((uint8_t *)spdif_buf)[SYNC_OFFSET] ^= SYNC_FLIP;
 
         i2s.write((uint8_t *)spdif_buf, sizeof(spdif_buf));
-        spdif_ptr = spdif_buf;
+        ptr = spdif_buf;
       }
     }
 
+    spdif_ptr = ptr;
     return result;
   }
 
@@ -0,0 +1,191 @@
+#pragma once
+
+#include "AudioTools/AudioLibs/AudioFFT.h"
+#include "AudioTools/CoreAudio/AudioOutput.h"
+
+namespace audio_tools {
+
+/**
+ * @brief Configuration for the SlidingDFT: define channels,
+ * bits_per_sample, sample_rate and the window length. The channel_used
+ * selects the channel the spectrum is calculated on.
+ * @ingroup fft
+ */
+struct SlidingDFTConfig : public AudioInfo {
+  SlidingDFTConfig() {
+    channels = 2;
+    bits_per_sample = 16;
+    sample_rate = 44100;
+  }
+  /// Window length in samples (does not need to be a power of 2)
+  int length = 1024;
+  /// Channel which is used as input
+  uint8_t channel_used = 0;
+  /// Damping factor slightly below 1.0 to keep the recursion stable
+  float damping = 0.9999f;
+};
+
+/**
+ * @brief Incremental spectrum calculation for a small number of bins (e.g.
+ * pilot tone detection): instead of recomputing a full FFT per window, the
+ * selected bins are updated with the sliding DFT recursion
+ * X(n) = e^(j2πk/N) (r·X(n−1) + x(n) − rᴺ·x(n−N)), so the cost is
+ * O(selected bins) per sample and the result is available after every
+ * sample block instead of every hop. Bins are selected with addFrequency()
+ * or addBin() before begin().
+ * @ingroup fft
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ */
+class SlidingDFT : public AudioOutput {
+ public:
+  SlidingDFTConfig defaultConfig() {
+    SlidingDFTConfig result;
+    return result;
+  }
+
+  /// Adds a bin (0 to length-1) to be tracked
+  bool addBin(int bin) {
+    if (is_active) {
+      LOGE("addBin must be called before begin");
+      return false;
+    }
+    requested_bins.push_back(bin);
+    return true;
+  }
+
+  /// Adds the bin closest to the indicated frequency to be tracked
+  bool addFrequency(float frequency) {
+    requested_frequencies.push_back(frequency);
+    return true;
+  }
+
+  bool begin(SlidingDFTConfig config) {
+    cfg = config;
+    setAudioInfo(config);
+    return begin();
+  }
+
+  bool begin() {
+    // convert the requested frequencies into bins
+    for (int j = 0; j < (int)requested_frequencies.size(); j++) {
+      requested_bins.push_back((int)roundf(requested_frequencies[j] *
+                                           cfg.length / cfg.sample_rate));
+    }
+    requested_frequencies.clear();
+    if (requested_bins.size() == 0) {
+      LOGE("No bins defined");
+      return false;
+    }
+    // setup the per bin recursion state
+    bins.resize(requested_bins.size());
+    for (int j = 0; j < (int)bins.size(); j++) {
+      BinState &state = bins[j];
+      state.bin = requested_bins[j];
+      float omega = 2.0f * PI * state.bin / cfg.length;
+      state.coeff_re = cosf(omega);
+      state.coeff_im = sinf(omega);
+      state.re = 0.0f;
+      state.im = 0.0f;
+    }
+    // setup the sample history ring
+    history.resize(cfg.length);
+    memset(history.data(), 0, cfg.length * sizeof(float));
+    history_pos = 0;
+    damping_n = powf(cfg.damping, cfg.length);
+    is_active = true;
+    return true;
+  }
+
+  void end() override { is_active = false; }
+
+  /// Number of tracked bins
+  int size() { return bins.size(); }
+
+  /// Provides the bin number of the indicated tracked bin
+  int bin(int idx) { return bins[idx].bin; }
+
+  /// Provides the frequency of the indicated tracked bin
+  float frequency(int idx) {
+    return static_cast<float>(bins[idx].bin) * cfg.sample_rate / cfg.length;
+  }
+
+  /// Magnitude of the indicated tracked bin
+  float magnitude(int idx) { return sqrt(magnitudeFast(idx)); }
+
+  /// Magnitude w/o square root of the indicated tracked bin
+  float magnitudeFast(int idx) {
+    BinState &state = bins[idx];
+    return state.re * state.re + state.im * state.im;
+  }
+
+  /// Provides real and imaginary part of the indicated tracked bin
+  bool getBin(int idx, FFTBin &result) {
+    if (idx < 0 || idx >= (int)bins.size()) return false;
+    result.real = bins[idx].re;
+    result.img = bins[idx].im;
+    return true;
+  }
+
+  /// Updates the tracked bins with the provided samples
+  size_t write(const uint8_t *data, size_t len) override {
+    if (!is_active) return 0;
+    switch (cfg.bits_per_sample) {
+      case 16:
+        processSamples<int16_t>(data, len / 2);
+        break;
+      case 24:
+        processSamples<int24_t>(data, len / 3);
+        break;
+      case 32:
+        processSamples<int32_t>(data, len / 4);
+        break;
+      default:
+        LOGE("Unsupported bits_per_sample: %d", cfg.bits_per_sample);
+        return 0;
+    }
+    return len;
+  }
+
+  /// Provides the actual configuration
+  SlidingDFTConfig &config() { return cfg; }
+
+ protected:
+  struct BinState {
+    int bin;
+    float coeff_re, coeff_im;  // e^(j2πk/N)
+    float re, im;              // X(n)
+  };
+  SlidingDFTConfig cfg;
+  Vector<BinState> bins{0};
+  Vector<int> requested_bins{0};
+  Vector<float> requested_frequencies{0};
+  Vector<float> history{0};
+  int history_pos = 0;
+  float damping_n = 1.0f;
+  bool is_active = false;
+
+  template <typename T>
+  void processSamples(const void *data, size_t count) {
+    T *dataT = (T *)data;
+    int bin_count = bins.size();
+    for (int j = 0; j < (int)count; j += cfg.channels) {
+      float sample = (float)(int32_t)dataT[j + cfg.channel_used];
+      // the sample leaving the window, damped over the window length
+      float removed = damping_n * history[history_pos];
+      history[history_pos] = sample;
+      history_pos = (history_pos + 1) % cfg.length;
+      float delta = sample - removed;
+      for (int b = 0; b < bin_count; b++) {
+        BinState &state = bins[b];
+        float re = cfg.damping * state.re + delta;
+        float im = cfg.damping * state.im;
+        // complex multiply with e^(j2πk/N)
+        state.re = re * state.coeff_re - im * state.coeff_im;
+        state.im = re * state.coeff_im + im * state.coeff_re;
+      }
+    }
+  }
+};
+
+}  // namespace audio_tools
@@ -19,6 +19,9 @@
 #include "tensorflow/lite/micro/micro_mutable_op_resolver.h"
 #include "tensorflow/lite/micro/system_setup.h"
 #include "tensorflow/lite/schema/schema_generated.h"
+#ifdef ESP32
+#include "AudioTools/Concurrency/RTOS/Task.h"
+#endif
 
 /** 
  * @defgroup tflite TFLite
@@ -709,6 +712,102 @@ class TfLiteMicroSpeachWriter : public TfLiteWriter {
   }
 };
 
+#ifdef ESP32
+/**
+ * @brief TfLiteMicroSpeachWriter which runs the model inference on an own
+ * core: the audio task only computes the new feature slice (the unchanged
+ * slices of the sliding window are reused by the shift in addSlice()) and
+ * snapshots the int8 spectrogram - Invoke() and the command decoding run on
+ * a dedicated task, so the audio path is never blocked by the model. A
+ * window which completes while the interpreter is still busy is skipped and
+ * counted in skippedInferences().
+ * @ingroup tflite
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ */
+class TfLiteMicroSpeachWriterAsync : public TfLiteMicroSpeachWriter {
+ public:
+  TfLiteMicroSpeachWriterAsync(int core = 1, int stackSize = 8192,
+                               int priority = 1) {
+    this->core = core;
+    this->stack_size = stackSize;
+    this->priority = priority;
+  }
+
+  ~TfLiteMicroSpeachWriterAsync() {
+    task.end();
+    if (p_feature_snapshot != nullptr) delete[] p_feature_snapshot;
+  }
+
+  bool begin(TfLiteAudioStreamBase *parent) override {
+    if (!TfLiteMicroSpeachWriter::begin(parent)) return false;
+    if (p_feature_snapshot == nullptr) {
+      p_feature_snapshot = new int8_t[cfg.featureElementCount()];
+    }
+    is_pending = false;
+    skipped_inferences = 0;
+    if (!task.create("tflite", stack_size, priority, core)) return false;
+    return task.begin([this]() { processInference(); });
+  }
+
+  /// Number of windows which were skipped because the interpreter was busy
+  uint32_t skippedInferences() { return skipped_inferences; }
+
+ protected:
+  Task task;
+  int8_t *p_feature_snapshot = nullptr;
+  volatile bool is_pending = false;
+  int32_t pending_time = 0;
+  uint32_t skipped_inferences = 0;
+  int core;
+  int stack_size;
+  int priority;
+
+  /// Called on the audio task: hand the spectrogram to the inference task
+  /// and return immediately
+  bool processSlices(int8_t *feature_buffer) override {
+    if (is_pending) {
+      // the interpreter is still busy: keep the audio path running
+      skipped_inferences++;
+      return true;
+    }
+    memcpy(p_feature_snapshot, feature_buffer, cfg.featureElementCount());
+    pending_time = current_time;
+    is_pending = true;
+    return true;
+  }
+
+  /// Executed on the inference task
+  void processInference() {
+    if (!is_pending) {
+      delay(1);
+      return;
+    }
+    memcpy(parent->modelInputBuffer(), p_feature_snapshot,
+           cfg.featureElementCount());
+    TfLiteStatus invoke_status = parent->interpreter().Invoke();
+    if (invoke_status != kTfLiteOk) {
+      LOGE("Invoke failed");
+      is_pending = false;
+      return;
+    }
+    TfLiteTensor *output = parent->interpreter().output(0);
+    const char *found_command = nullptr;
+    uint8_t score = 0;
+    bool is_new_command = false;
+    if (cfg.recognizeCommands->getCommand(output, pending_time, &found_command,
+                                          &score,
+                                          &is_new_command) != kTfLiteOk) {
+      LOGE("TfLiteMicroSpeechRecognizeCommands::getCommand() failed");
+      is_pending = false;
+      return;
+    }
+    respondToCommand(found_command, score, is_new_command);
+    is_pending = false;
+  }
+};
+#endif
+
 /**
  * @brief Generate a sine output from a model that was trained on the sine method.
  * (=hello_world)
@@ -84,7 +84,7 @@ class VBANStream : public AudioStream {
         LOGE("Only 16 bits supported")
         return false;
       }
-      tx_buffer.resize(VBAN_PACKET_NUM_SAMPLES);
+      tx_fill = 0;
       return begin_tx();
     } else {
 #ifdef ESP32
@@ -100,7 +100,6 @@ class VBANStream : public AudioStream {
   size_t write(const uint8_t* data, size_t len) override {
     if (!udp_connected) return 0;
 
-    int16_t* adc_data = (int16_t*)data;
     size_t samples = len / (cfg.bits_per_sample/8);
 
     // limit output speed
@@ -108,10 +107,19 @@ class VBANStream : public AudioStream {
       throttle.delayFrames(samples / cfg.channels);
     }
 
-    for (int j = 0; j < samples; j++) {
-      tx_buffer.write(adc_data[j]);
-      if (tx_buffer.availableForWrite() == 0) {
-        memcpy(vban.data_frame, tx_buffer.data(), vban.packet_data_bytes);
+    // The header template is set up once in configure_vban, so we gather the
+    // payload with a single copy from the source buffer straight into the
+    // packet behind it (the wifi stack needs each datagram contiguous) and
+    // submit every completed packet in the same pass
+    const uint8_t* ptr = data;
+    size_t remaining = len;
+    while (remaining > 0) {
+      int to_copy = min((int)remaining, vban.packet_data_bytes - tx_fill);
+      memcpy(vban.data_frame + tx_fill, ptr, to_copy);
+      tx_fill += to_copy;
+      ptr += to_copy;
+      remaining -= to_copy;
+      if (tx_fill == vban.packet_data_bytes) {
         *vban.packet_counter = packet_counter;  // increment packet counter
         // Send packet
         if (cfg.target_ip == broadcast_address) {
@@ -123,7 +131,7 @@ class VBANStream : public AudioStream {
         }
         // defile delay start time
         packet_counter++;
-        tx_buffer.reset();
+        tx_fill = 0;
       }
     }
     return len;
@@ -147,7 +155,8 @@ class VBANStream : public AudioStream {
   AsyncUDP udp;
   VBan vban;
   VBANConfig cfg;
-  SingleBuffer<int16_t> tx_buffer{0};
+  // fill level of the current tx packet payload in bytes
+  int tx_fill = 0;
  #ifdef ESP32
    BufferRTOS<uint8_t> rx_buffer{ 0};
  #else
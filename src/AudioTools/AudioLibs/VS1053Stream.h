@@ -39,7 +39,11 @@ class VS1053Config : public AudioInfo {
     /// set true for streaming midi
     bool is_midi = false;
     /// SPI.begin is called by the driver (default setting)
-    bool is_start_spi = true; 
+    bool is_start_spi = true;
+    /// Collects small writes into bursts of this size (rounded down to a
+    /// multiple of 32 bytes), so the SPI transaction setup is amortized
+    /// over a full burst instead of being paid per chunk (0 = write through)
+    int write_buffer_size = 0;
 #if VS1053_EXT
     VS1053_INPUT input_device = VS1053_MIC;
 #endif
@@ -62,17 +66,54 @@ class VS1053Stream : public AudioStream, public VolumeSupport {
         VS1053StreamOut(VS1053 *vs){
             p_VS1053 = vs;
         }
-        size_t write(const uint8_t *data, size_t len) override { 
+        /// Activates the batching of small writes into bursts
+        void setBufferSize(int size){
+            // the codec accepts the data in 32 byte bursts
+            int adjusted = (size / 32) * 32;
+            buffer.resize(adjusted);
+        }
+        void setDreqPin(int pin){
+            dreq_pin = pin;
+        }
+        size_t write(const uint8_t *data, size_t len) override {
             if (p_VS1053==nullptr) {
                 LOGE("NPE");
                 return 0;
             }
             TRACED();
-            p_VS1053->playChunk((uint8_t*)data, len);
-            return len;
+            // write through when batching is not active
+            if (buffer.size() == 0){
+                p_VS1053->playChunk((uint8_t*)data, len);
+                return len;
+            }
+            // collect the data and send it as one big burst: the driver
+            // keeps the SPI transaction open for the whole chunk
+            size_t result = 0;
+            while (result < len){
+                result += buffer.writeArray(data + result, len - result);
+                if (buffer.availableForWrite() == 0) flush();
+            }
+            return result;
+        }
+        /// Sends the collected data to the codec
+        void flush() override {
+            if (buffer.available() == 0) return;
+            p_VS1053->playChunk(buffer.data(), buffer.available());
+            buffer.reset();
+        }
+        /// When dreq is low the codec fifo is full and playChunk would block
+        int availableForWrite() override {
+            bool ready = dreq_pin < 0 || digitalRead(dreq_pin) == HIGH;
+            if (buffer.size() > 0){
+                int result = buffer.availableForWrite();
+                return result > 0 ? result : (ready ? (int)buffer.size() : 0);
+            }
+            return ready ? DEFAULT_BUFFER_SIZE : 0;
         }
       protected:
         VS1053 *p_VS1053=nullptr;
+        SingleBuffer<uint8_t> buffer{0};
+        int dreq_pin = -1;
     };
 
 public:
@@ -126,6 +167,8 @@ public:
         if (p_vs1053==nullptr){
            p_vs1053 = new VS1053(cfg.cs_pin,cfg.dcs_pin,cfg.dreq_pin);
            p_vs1053_out = new VS1053StreamOut(p_vs1053);
+           p_vs1053_out->setBufferSize(cfg.write_buffer_size);
+           p_vs1053_out->setDreqPin(cfg.dreq_pin);
 
             if (cfg.is_start_spi) {
                 LOGI("SPI.begin()")
@@ -242,6 +285,20 @@ public:
         return p_out->write(data, len);
     }
 
+    /// Sends the collected data of the write buffer to the codec
+    void flush() override {
+        if (p_vs1053_out!=nullptr){
+            p_vs1053_out->flush();
+        }
+    }
+
+    /// Reports 0 when the codec fifo (and the write buffer) is full, so
+    /// the copy loop does not block in playChunk
+    int availableForWrite() override {
+        if (p_vs1053_out==nullptr) return 0;
+        return p_vs1053_out->availableForWrite();
+    }
+
     /// returns the VS1053 object
     VS1053 &getVS1053() {
         TRACED();
@@ -1,4 +1,5 @@
 #pragma once
 // Forward Error Corrections
 #include "AudioTools/Communication/ReedSolomonFEC.h"
-#include "AudioTools/Communication/HammingFEC.h"
\ No newline at end of file
+#include "AudioTools/Communication/HammingFEC.h"
+#include "AudioTools/Communication/ParityFECStream.h"
\ No newline at end of file
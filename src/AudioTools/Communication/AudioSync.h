@@ -3,6 +3,7 @@
 #include "AudioTools/CoreAudio/AudioStreams.h"
 #include "AudioTools/CoreAudio/AudioOutput.h"
 #include "AudioTools/CoreAudio/Buffers.h"
+#include "AudioTools/CoreAudio/ResampleStream.h"
 #include "AudioTools/AudioCodecs/AudioEncoded.h"
 
 
@@ -39,6 +40,150 @@ struct AudioSendData : public AudioHeader {
     rec = RecordType::Send;
   }
   uint16_t size = 0;
+  // sender time in ms: used for the clock drift estimation
+  uint32_t time_ms = 0;
+};
+
+/**
+ * @brief Closed loop clock drift compensation for synchronized playback:
+ * each DAC crystal is off by some ppm, so multiple receivers drift apart
+ * audibly within minutes. The controller compares the local consumption
+ * rate against the sender timestamps and derives a micro adjustment for
+ * the step size of a ResampleStream, so that the playback rate follows
+ * the sender without any buffer resets. An additional phase term slowly
+ * removes any accumulated backlog error, which keeps the latency (and
+ * with it multiple rooms) aligned indefinitely.
+ * @author Phil Schatzmann
+ * @ingroup communications
+ * @copyright GPLv3
+ */
+class ClockDriftController {
+ public:
+  /// Defines the resampler which receives the rate corrections
+  void setResampler(ResampleStream &resample) { p_resample = &resample; }
+
+  /// Defines the maximum applied correction (default 200 ppm)
+  void setMaxCorrectionPPM(float ppm) { max_ppm = ppm; }
+
+  /// Defines how often the correction is updated (default 1000 ms)
+  void setUpdateInterval(uint32_t ms) { update_interval_ms = ms; }
+
+  /// Defines the time in seconds over which a phase error is removed
+  void setPhaseHorizon(float seconds) { phase_horizon_s = seconds; }
+
+  /// Defines the smoothing factor for the drift estimate (0 - 1.0)
+  void setSmoothing(float factor) { smoothing = factor; }
+
+  bool begin(AudioInfo info) {
+    TRACED();
+    if (info.sample_rate == 0) {
+      LOGE("invalid sample rate");
+      return false;
+    }
+    this->info = info;
+    total_received = 0;
+    total_played = 0;
+    window_received = 0;
+    window_played = 0;
+    drift_ppm = 0.0f;
+    applied_ppm = 0.0f;
+    target_backlog = 0;
+    has_target = false;
+    base_step = p_resample != nullptr ? p_resample->getStepSize() : 1.0f;
+    is_window_active = false;
+    return true;
+  }
+
+  /// Reports data which arrived from the sender with its send time in ms
+  void recordReceived(int frames, uint32_t senderMillis) {
+    if (!is_window_active) {
+      window_start_ms = millis();
+      window_sender_start_ms = senderMillis;
+      is_window_active = true;
+      window_received = 0;
+      window_played = 0;
+    }
+    total_received += frames;
+    window_received += frames;
+    last_sender_ms = senderMillis;
+  }
+
+  /// Reports data which has been passed on towards the dac
+  void recordPlayed(int frames) {
+    total_played += frames;
+    window_played += frames;
+    if (is_window_active &&
+        (uint32_t)(millis() - window_start_ms) >= update_interval_ms) {
+      update();
+    }
+  }
+
+  /// Provides the currently applied correction in ppm
+  float driftPPM() { return applied_ppm; }
+
+  /// Provides the backlog deviation from the target in frames
+  int32_t phaseErrorFrames() {
+    if (!has_target) return 0;
+    return (int32_t)(total_received - total_played) - target_backlog;
+  }
+
+ protected:
+  ResampleStream *p_resample = nullptr;
+  AudioInfo info;
+  uint64_t total_received = 0;
+  uint64_t total_played = 0;
+  uint32_t window_received = 0;
+  uint32_t window_played = 0;
+  uint32_t window_start_ms = 0;
+  uint32_t window_sender_start_ms = 0;
+  uint32_t last_sender_ms = 0;
+  uint32_t update_interval_ms = 1000;
+  int32_t target_backlog = 0;
+  float drift_ppm = 0.0f;
+  float applied_ppm = 0.0f;
+  float max_ppm = 200.0f;
+  float phase_horizon_s = 10.0f;
+  float smoothing = 0.25f;
+  float base_step = 1.0f;
+  bool is_window_active = false;
+  bool has_target = false;
+
+  /// Updates the drift estimate and applies the corrected step size
+  void update() {
+    uint32_t local_ms = millis() - window_start_ms;
+    uint32_t sender_ms = last_sender_ms - window_sender_start_ms;
+    is_window_active = false;
+    if (local_ms == 0 || sender_ms == 0 || window_received == 0 ||
+        window_played == 0)
+      return;
+
+    // rate of the local playback vs the rate of the sender
+    float played_rate = 1000.0f * window_played / local_ms;
+    float recv_rate = 1000.0f * window_received / sender_ms;
+    float ratio = played_rate / recv_rate;
+    drift_ppm += smoothing * ((ratio - 1.0f) * 1000000.0f - drift_ppm);
+
+    // the backlog after the first interval defines the phase target
+    int32_t backlog = (int32_t)(total_received - total_played);
+    if (!has_target) {
+      target_backlog = backlog;
+      has_target = true;
+    }
+    float phase_ppm = (backlog - target_backlog) * 1000000.0f /
+                      (info.sample_rate * phase_horizon_s);
+
+    // positive correction -> consume the input faster
+    float correction = -drift_ppm + phase_ppm;
+    if (correction > max_ppm) correction = max_ppm;
+    if (correction < -max_ppm) correction = -max_ppm;
+    applied_ppm = correction;
+
+    if (p_resample != nullptr) {
+      p_resample->setStepSize(base_step * (1.0f + correction * 0.000001f));
+    }
+    LOGI("drift: %f ppm / phase: %d frames -> correction %f ppm", drift_ppm,
+         (int)(backlog - target_backlog), correction);
+  }
 };
 
 /// Protocol Record for Request
@@ -84,6 +229,7 @@ class AudioSyncWriter : public AudioOutput {
       to_write_len = min(open_len, available_to_write);
       send.increment();
       send.size = to_write_len;
+      send.time_ms = millis();
       p_dest->write((const uint8_t *)&send, sizeof(send));
       int w = p_dest->write(data + written_len, to_write_len);
       written_len += w;
@@ -138,6 +284,12 @@ class AudioSyncReader : public AudioStream {
     is_confirmer = isConfirmer;
   }
 
+  /// Defines the controller which compensates the clock drift against the
+  /// sender with the help of the send timestamps
+  void setDriftController(ClockDriftController &controller) {
+    p_drift = &controller;
+  }
+
   size_t copy() {
     int processed = 0;
     int header_size = sizeof(header);
@@ -168,12 +320,16 @@ class AudioSyncReader : public AudioStream {
   bool is_started = false;
   bool is_confirmer;
   int last_seq = 0;
+  ClockDriftController *p_drift = nullptr;
+  int bytes_per_frame = 0;
 
   /// Starts the processing
   void audioDataBegin() {
     readProtocol(&begin, sizeof(begin));
     p_out->begin();
     p_out->setAudioInfo(begin.info);
+    bytes_per_frame = begin.info.channels * begin.info.bits_per_sample / 8;
+    if (p_drift != nullptr) p_drift->begin(begin.info);
     requestData();
   }
 
@@ -197,6 +353,13 @@ class AudioSyncReader : public AudioStream {
       uint8_t buffer[available];
       p_in->readBytes((uint8_t *)buffer, available);
       p_out->write((const uint8_t *)buffer, available);
+      // in the pull protocol the data is consumed as it arrives, so the
+      // estimate compares the sender clock with the local clock
+      if (p_drift != nullptr && bytes_per_frame > 0) {
+        int frames = available / bytes_per_frame;
+        p_drift->recordReceived(frames, data.time_ms);
+        p_drift->recordPlayed(frames);
+      }
       // only one reader should be used as confirmer
       if (is_confirmer) {
         requestData();
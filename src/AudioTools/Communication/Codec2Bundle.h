@@ -0,0 +1,251 @@
+#pragma once
+
+#include "AudioConfig.h"
+#include "AudioTools/CoreAudio/AudioOutput.h"
+#include "AudioTools/CoreAudio/Buffers.h"
+#include "FEC/ReedSolomon/rs.hpp"
+
+namespace audio_tools {
+
+/**
+ * @brief Bit exact copy between byte buffers: the extraction masks are
+ * table driven, so the hot loop is shift/mask/or without any conditional
+ * bit tests. Used to pack sub-byte voice codec frames (e.g. Codec2 with
+ * 28 bits per frame) without the per frame byte padding.
+ * @ingroup fec
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ */
+class BitCopy {
+ public:
+  /// Copies nbits bits from src (starting at bit srcBit) to dst (starting
+  /// at bit dstBit). Bits are counted msb first inside each byte.
+  static void copy(uint8_t *dst, int dstBit, const uint8_t *src, int srcBit,
+                   int nbits) {
+    static const uint8_t mask_right[9] = {0x00, 0x01, 0x03, 0x07, 0x0F,
+                                          0x1F, 0x3F, 0x7F, 0xFF};
+    while (nbits > 0) {
+      int dst_byte = dstBit >> 3;
+      int dst_off = dstBit & 7;
+      int src_byte = srcBit >> 3;
+      int src_off = srcBit & 7;
+      // process up to the next byte boundary of source and destination
+      int n = 8 - (dst_off > src_off ? dst_off : src_off);
+      if (n > nbits) n = nbits;
+      // n source bits right aligned
+      uint8_t bits = (src[src_byte] >> (8 - src_off - n)) & mask_right[n];
+      int shift = 8 - dst_off - n;
+      dst[dst_byte] =
+          (dst[dst_byte] & ~(mask_right[n] << shift)) | (bits << shift);
+      dstBit += n;
+      srcBit += n;
+      nbits -= n;
+    }
+  }
+};
+
+/**
+ * @brief Packs multiple sub-byte voice codec frames (e.g. Codec2) bit
+ * exact into one radio packet and protects it with interleaved Reed
+ * Solomon parity. The frames arrive byte padded from the encoder (one
+ * write per frame or any chunking) and only their frame_bits significant
+ * bits are kept, so no airtime is wasted on padding. When the bundle is
+ * full the Reed Solomon codeword is computed and written column wise
+ * (block interleaving), so a burst of corrupted bytes on air is spread
+ * over the codeword and stays correctable.
+ * @ingroup fec
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ * @tparam payload_bytes net bytes per radio packet
+ * @tparam parity_bytes  Reed Solomon parity bytes per radio packet
+ */
+template <int payload_bytes, int parity_bytes>
+class Codec2BundleEncoder : public AudioOutput {
+ public:
+  Codec2BundleEncoder(Print &out) { p_out = &out; }
+
+  /// Defines the significant bits per codec frame (e.g. 28 for Codec2
+  /// 1400 bps) and the padded frame size in bytes as the codec writes it
+  void setFrameBits(int frameBits) {
+    frame_bits = frameBits;
+    frame_bytes = (frameBits + 7) / 8;
+  }
+
+  /// Defines the interleaver depth (number of rows, default 4)
+  void setInterleaveDepth(int depth) { interleave_depth = depth; }
+
+  /// Number of frames which fit into one radio packet
+  int framesPerBundle() { return (payload_bytes * 8) / frame_bits; }
+
+  /// Total size of one radio packet
+  int bundleBytes() { return payload_bytes + parity_bytes; }
+
+  bool begin() override {
+    if (frame_bits == 0) {
+      LOGE("frame_bits not defined");
+      return false;
+    }
+    frame_buffer.resize(frame_bytes);
+    memset(payload, 0, sizeof(payload));
+    bit_pos = 0;
+    frames = 0;
+    is_active = true;
+    return true;
+  }
+
+  /// Collects the byte padded codec frames and sends full bundles
+  size_t write(const uint8_t *data, size_t len) override {
+    if (!is_active) return 0;
+    size_t pos = 0;
+    while (pos < len) {
+      pos += frame_buffer.writeArray(data + pos, len - pos);
+      if (frame_buffer.availableForWrite() == 0) {
+        addFrame(frame_buffer.data());
+        frame_buffer.reset();
+      }
+    }
+    return len;
+  }
+
+ protected:
+  Print *p_out = nullptr;
+  RS::ReedSolomon<payload_bytes, parity_bytes> rs;
+  SingleBuffer<uint8_t> frame_buffer{0};
+  uint8_t payload[payload_bytes];
+  uint8_t codeword[payload_bytes + parity_bytes];
+  uint8_t interleaved[payload_bytes + parity_bytes];
+  int frame_bits = 0;
+  int frame_bytes = 0;
+  int bit_pos = 0;
+  int frames = 0;
+  int interleave_depth = 4;
+
+  /// Appends the significant bits of one frame to the bundle
+  void addFrame(const uint8_t *frame) {
+    BitCopy::copy(payload, bit_pos, frame, 0, frame_bits);
+    bit_pos += frame_bits;
+    frames++;
+    if (frames >= framesPerBundle()) {
+      sendBundle();
+    }
+  }
+
+  void sendBundle() {
+    rs.Encode(payload, codeword);
+    // column wise block interleave over the complete codeword
+    int total = payload_bytes + parity_bytes;
+    int cols = (total + interleave_depth - 1) / interleave_depth;
+    int idx = 0;
+    for (int c = 0; c < cols; c++) {
+      for (int r = 0; r < interleave_depth; r++) {
+        int src = r * cols + c;
+        if (src < total) interleaved[idx++] = codeword[src];
+      }
+    }
+    p_out->write(interleaved, total);
+    memset(payload, 0, sizeof(payload));
+    bit_pos = 0;
+    frames = 0;
+  }
+};
+
+/**
+ * @brief Counterpart of Codec2BundleEncoder: collects the radio packets,
+ * de-interleaves, corrects with Reed Solomon and unpacks the individual
+ * byte padded frames for the codec decoder (table driven bit extraction).
+ * Uncorrectable bundles are counted and dropped.
+ * @ingroup fec
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ * @tparam payload_bytes net bytes per radio packet
+ * @tparam parity_bytes  Reed Solomon parity bytes per radio packet
+ */
+template <int payload_bytes, int parity_bytes>
+class Codec2BundleDecoder : public AudioOutput {
+ public:
+  Codec2BundleDecoder(Print &out) { p_out = &out; }
+
+  /// Defines the significant bits per codec frame: must match the encoder
+  void setFrameBits(int frameBits) {
+    if (frameBits > 8 * (int)sizeof(frame_scratch)) {
+      LOGE("frame too big: %d bits", frameBits);
+      return;
+    }
+    frame_bits = frameBits;
+    frame_bytes = (frameBits + 7) / 8;
+  }
+
+  /// Defines the interleaver depth: must match the encoder
+  void setInterleaveDepth(int depth) { interleave_depth = depth; }
+
+  int framesPerBundle() { return (payload_bytes * 8) / frame_bits; }
+
+  int bundleBytes() { return payload_bytes + parity_bytes; }
+
+  /// Number of bundles which could not be corrected (and were dropped)
+  uint32_t failedBundles() { return failed_bundles; }
+
+  bool begin() override {
+    if (frame_bits == 0) {
+      LOGE("frame_bits not defined");
+      return false;
+    }
+    bundle_buffer.resize(bundleBytes());
+    is_active = true;
+    return true;
+  }
+
+  /// Collects the radio packets and forwards the corrected frames
+  size_t write(const uint8_t *data, size_t len) override {
+    if (!is_active) return 0;
+    size_t pos = 0;
+    while (pos < len) {
+      pos += bundle_buffer.writeArray(data + pos, len - pos);
+      if (bundle_buffer.availableForWrite() == 0) {
+        processBundle(bundle_buffer.data());
+        bundle_buffer.reset();
+      }
+    }
+    return len;
+  }
+
+ protected:
+  Print *p_out = nullptr;
+  RS::ReedSolomon<payload_bytes, parity_bytes> rs;
+  SingleBuffer<uint8_t> bundle_buffer{0};
+  uint8_t codeword[payload_bytes + parity_bytes];
+  uint8_t payload[payload_bytes];
+  int frame_bits = 0;
+  int frame_bytes = 0;
+  int interleave_depth = 4;
+  uint32_t failed_bundles = 0;
+  uint8_t frame_scratch[32];
+
+  void processBundle(const uint8_t *data) {
+    // undo the column wise interleave
+    int total = payload_bytes + parity_bytes;
+    int cols = (total + interleave_depth - 1) / interleave_depth;
+    int idx = 0;
+    for (int c = 0; c < cols; c++) {
+      for (int r = 0; r < interleave_depth; r++) {
+        int dst = r * cols + c;
+        if (dst < total) codeword[dst] = data[idx++];
+      }
+    }
+    if (rs.Decode(codeword, payload) != 0) {
+      failed_bundles++;
+      LOGW("bundle not correctable: dropped");
+      return;
+    }
+    // unpack the frames: each frame is written byte padded as the codec
+    // decoder expects it
+    int count = framesPerBundle();
+    for (int j = 0; j < count; j++) {
+      memset(frame_scratch, 0, frame_bytes);
+      BitCopy::copy(frame_scratch, 0, payload, j * frame_bits, frame_bits);
+      p_out->write(frame_scratch, frame_bytes);
+    }
+  }
+};
+
+}  // namespace audio_tools
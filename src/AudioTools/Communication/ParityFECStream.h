@@ -0,0 +1,350 @@
+#pragma once
+#include "AudioConfig.h"
+#include "AudioTools/CoreAudio/BaseStream.h"
+#include "AudioTools/CoreAudio/Buffers.h"
+
+#include <functional>
+#include <string.h>
+
+namespace audio_tools {
+
+/**
+ * @brief Configuration for ParityFECStream
+ */
+struct ParityFECConfig {
+  /// payload bytes per data frame: payload_size + 8 byte header must fit
+  /// into one transport frame (e.g. 250 bytes for ESP-NOW)
+  int payload_size = 200;
+  /// data frames per parity frame: 4 -> 25% redundancy, any single lost
+  /// frame per group is recovered
+  int group_size = 4;
+  /// throttle the send rate based on the reported peer queue depth
+  bool is_rate_control = true;
+  /// how often the local queue depth is reported to the peer
+  uint16_t feedback_interval_ms = 100;
+  /// peer fill percent at which the sender starts to throttle
+  int throttle_start_percent = 50;
+  /// maximum delay per sent frame when the peer queue is full
+  int max_throttle_ms = 20;
+};
+
+/**
+ * @brief Ack-less redundancy encoding with rate control e.g. for ESP-NOW:
+ * the data is sent as fixed size frames and after each group of frames one
+ * XOR parity frame is interleaved, so that any single lost frame per group
+ * can be rebuilt on the receiving side without retransmission latency. The
+ * receiving side periodically reports its queue depth (e.g. from
+ * ESPNowStream::getBufferPercent via setFillLevelCallback) over the same
+ * connection and the sender slows down before the peer overflows. Frames
+ * which can not be rebuilt are replaced by silence, so the output stays in
+ * sync. The transport must lose only whole frames (as ESP-NOW does) to
+ * keep the stream aligned.
+ * @ingroup fec
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ */
+class ParityFECStream : public BaseStream {
+ public:
+  ParityFECStream(Stream &stream) {
+    p_stream = &stream;
+    p_print = &stream;
+  }
+
+  ParityFECStream(Print &print) { p_print = &print; }
+
+  ParityFECConfig defaultConfig() { return ParityFECConfig(); }
+
+  bool begin(ParityFECConfig cfg) {
+    TRACED();
+    this->cfg = cfg;
+    if (cfg.payload_size <= 0 || cfg.group_size < 2 ||
+        cfg.group_size > 255) {
+      LOGE("invalid config");
+      return false;
+    }
+    tx_payload.resize(cfg.payload_size);
+    tx_parity.resize(cfg.payload_size);
+    rx_group.resize(cfg.group_size * cfg.payload_size);
+    rx_parity.resize(cfg.payload_size);
+    rx_frame.resize(cfg.payload_size);
+    out_buffer.resize(4 * cfg.group_size * cfg.payload_size);
+    memset(tx_parity.data(), 0, cfg.payload_size);
+    tx_fill = 0;
+    tx_index = 0;
+    tx_group = 0;
+    rx_valid_mask = 0;
+    rx_has_parity = false;
+    rx_current_group = 0;
+    is_rx_sync = false;
+    header_fill = 0;
+    payload_fill = 0;
+    peer_fill = 0;
+    last_feedback_ms = 0;
+    lost_frames = 0;
+    recovered_frames = 0;
+    return true;
+  }
+
+  bool begin() { return begin(cfg); }
+
+  /// Defines the callback which provides the local receive queue fill in
+  /// percent (0 - 100): it is reported periodically to the peer
+  void setFillLevelCallback(std::function<int()> cb) { fill_callback = cb; }
+
+  /// Encodes the data as data frames with interleaved parity frames
+  size_t write(const uint8_t *data, size_t len) override {
+    if (p_print == nullptr) return 0;
+    pump();
+    size_t pos = 0;
+    while (pos < len) {
+      int to_copy = min((int)(len - pos), cfg.payload_size - tx_fill);
+      memcpy(tx_payload.data() + tx_fill, data + pos, to_copy);
+      tx_fill += to_copy;
+      pos += to_copy;
+      if (tx_fill == cfg.payload_size) sendDataFrame();
+    }
+    return len;
+  }
+
+  int availableForWrite() override { return cfg.payload_size; }
+
+  /// Provides the decoded (and if necessary rebuilt) data
+  size_t readBytes(uint8_t *data, size_t len) override {
+    pump();
+    return out_buffer.readArray(data, len);
+  }
+
+  int available() override {
+    pump();
+    return out_buffer.available();
+  }
+
+  /// Peer queue depth in percent from the last feedback frame
+  int peerFillPercent() { return peer_fill; }
+
+  /// Number of frames which could not be rebuilt
+  uint32_t lostFrames() { return lost_frames; }
+
+  /// Number of lost frames which were rebuilt from the parity
+  uint32_t recoveredFrames() { return recovered_frames; }
+
+ protected:
+  enum FrameType : uint8_t { Data = 1, Parity = 2, Feedback = 3 };
+
+  struct FrameHeader {
+    uint8_t magic0 = 0xF5;
+    uint8_t magic1 = 0xEC;
+    uint8_t type = 0;
+    uint8_t index = 0;
+    uint16_t group = 0;
+    uint16_t size = 0;
+  };
+
+  ParityFECConfig cfg;
+  Stream *p_stream = nullptr;
+  Print *p_print = nullptr;
+  std::function<int()> fill_callback = nullptr;
+  Vector<uint8_t> tx_payload{0};
+  Vector<uint8_t> tx_parity{0};
+  Vector<uint8_t> rx_group{0};
+  Vector<uint8_t> rx_parity{0};
+  Vector<uint8_t> rx_frame{0};
+  RingBuffer<uint8_t> out_buffer{0};
+  FrameHeader rx_header;
+  int tx_fill = 0;
+  int tx_index = 0;
+  uint16_t tx_group = 0;
+  uint32_t rx_valid_mask = 0;
+  uint16_t rx_current_group = 0;
+  bool rx_has_parity = false;
+  bool is_rx_sync = false;
+  int header_fill = 0;
+  int payload_fill = 0;
+  int peer_fill = 0;
+  uint32_t last_feedback_ms = 0;
+  uint32_t lost_frames = 0;
+  uint32_t recovered_frames = 0;
+
+  /// Sends the completed data frame and updates the group parity
+  void sendDataFrame() {
+    sendFrame(Data, tx_index, tx_group, tx_payload.data(), cfg.payload_size);
+    // accumulate the parity over the group
+    for (int j = 0; j < cfg.payload_size; j++) {
+      tx_parity[j] ^= tx_payload[j];
+    }
+    tx_fill = 0;
+    if (++tx_index >= cfg.group_size) {
+      sendFrame(Parity, tx_index, tx_group, tx_parity.data(),
+                cfg.payload_size);
+      memset(tx_parity.data(), 0, cfg.payload_size);
+      tx_index = 0;
+      tx_group++;
+    }
+    throttle();
+  }
+
+  /// Writes one frame (header + payload) to the transport
+  void sendFrame(FrameType type, int index, uint16_t group,
+                 const uint8_t *payload, int size) {
+    uint8_t frame[sizeof(FrameHeader) + size];
+    FrameHeader header;
+    header.type = type;
+    header.index = index;
+    header.group = group;
+    header.size = size;
+    memcpy(frame, &header, sizeof(header));
+    if (size > 0) memcpy(frame + sizeof(header), payload, size);
+    p_print->write(frame, sizeof(header) + size);
+  }
+
+  /// Slows down the sender when the peer queue is filling up
+  void throttle() {
+    if (!cfg.is_rate_control) return;
+    if (peer_fill <= cfg.throttle_start_percent) return;
+    int range = 100 - cfg.throttle_start_percent;
+    int wait = (peer_fill - cfg.throttle_start_percent) *
+               cfg.max_throttle_ms / range;
+    if (wait > 0) delay(wait);
+  }
+
+  /// Reports the local queue depth to the peer
+  void sendFeedback() {
+    if (fill_callback == nullptr || p_print == nullptr) return;
+    uint32_t now = millis();
+    if ((uint32_t)(now - last_feedback_ms) < cfg.feedback_interval_ms) return;
+    last_feedback_ms = now;
+    int fill = fill_callback();
+    if (fill < 0) fill = 0;
+    if (fill > 100) fill = 100;
+    sendFrame(Feedback, fill, 0, nullptr, 0);
+  }
+
+  /// Reads the arrived frames from the transport and processes them
+  void pump() {
+    sendFeedback();
+    if (p_stream == nullptr) return;
+    while (true) {
+      // leave the frames in the transport until there is room for a
+      // complete group (a frame can trigger up to two group flushes)
+      if (out_buffer.availableForWrite() <
+          2 * cfg.group_size * cfg.payload_size)
+        return;
+      // collect the frame header
+      if (header_fill < (int)sizeof(FrameHeader)) {
+        header_fill += p_stream->readBytes(
+            (uint8_t *)&rx_header + header_fill,
+            sizeof(FrameHeader) - header_fill);
+        if (header_fill < (int)sizeof(FrameHeader)) return;
+        if (rx_header.magic0 != 0xF5 || rx_header.magic1 != 0xEC ||
+            rx_header.size > cfg.payload_size) {
+          // a partly lost frame has unaligned the stream: resync
+          LOGW("resync");
+          memmove(&rx_header, (uint8_t *)&rx_header + 1,
+                  sizeof(FrameHeader) - 1);
+          header_fill--;
+          continue;
+        }
+        payload_fill = 0;
+      }
+      // collect the frame payload
+      if (payload_fill < rx_header.size) {
+        payload_fill += p_stream->readBytes(rx_frame.data() + payload_fill,
+                                            rx_header.size - payload_fill);
+        if (payload_fill < rx_header.size) return;
+      }
+      header_fill = 0;
+      processFrame();
+    }
+  }
+
+  /// Handles one complete received frame
+  void processFrame() {
+    switch (rx_header.type) {
+      case Feedback:
+        peer_fill = rx_header.index;
+        break;
+      case Data:
+      case Parity: {
+        if (rx_header.type == Data && rx_header.index >= cfg.group_size)
+          break;
+        startGroup(rx_header.group);
+        if ((int16_t)(rx_header.group - rx_current_group) != 0) break;
+        if (rx_header.type == Data) {
+          memcpy(rx_group.data() + rx_header.index * cfg.payload_size,
+                 rx_frame.data(), cfg.payload_size);
+          rx_valid_mask |= (1ul << rx_header.index);
+          // a complete group does not need to wait for its parity
+          if (rx_valid_mask == fullMask()) flushGroup();
+        } else {
+          memcpy(rx_parity.data(), rx_frame.data(), cfg.payload_size);
+          rx_has_parity = true;
+          // the parity ends the group: rebuild a lost frame if possible
+          flushGroup();
+        }
+        break;
+      }
+      default:
+        break;
+    }
+  }
+
+  /// Opens the indicated group: an older incomplete group is flushed
+  void startGroup(uint16_t group) {
+    if (!is_rx_sync) {
+      rx_current_group = group;
+      rx_valid_mask = 0;
+      rx_has_parity = false;
+      is_rx_sync = true;
+      return;
+    }
+    if ((int16_t)(group - rx_current_group) > 0) {
+      if (rx_valid_mask != 0) flushGroup();
+      rx_current_group = group;
+      rx_valid_mask = 0;
+      rx_has_parity = false;
+    }
+  }
+
+  uint32_t fullMask() { return (1ul << cfg.group_size) - 1; }
+
+  /// Delivers the current group: a single lost frame is rebuilt from the
+  /// parity, anything else missing is replaced by silence
+  void flushGroup() {
+    int missing = 0;
+    int missing_index = -1;
+    for (int j = 0; j < cfg.group_size; j++) {
+      if ((rx_valid_mask & (1ul << j)) == 0) {
+        missing++;
+        missing_index = j;
+      }
+    }
+    if (missing == 1 && rx_has_parity) {
+      // xor of the parity and all received frames rebuilds the lost one
+      uint8_t *frame = rx_group.data() + missing_index * cfg.payload_size;
+      memcpy(frame, rx_parity.data(), cfg.payload_size);
+      for (int j = 0; j < cfg.group_size; j++) {
+        if (j == missing_index) continue;
+        uint8_t *other = rx_group.data() + j * cfg.payload_size;
+        for (int i = 0; i < cfg.payload_size; i++) frame[i] ^= other[i];
+      }
+      recovered_frames++;
+      LOGI("rebuilt frame %d of group %u", missing_index,
+           (unsigned)rx_current_group);
+    } else if (missing > 0) {
+      // zero fill, so that the output stays in sync
+      for (int j = 0; j < cfg.group_size; j++) {
+        if ((rx_valid_mask & (1ul << j)) == 0) {
+          memset(rx_group.data() + j * cfg.payload_size, 0, cfg.payload_size);
+        }
+      }
+      lost_frames += missing;
+      LOGW("%d frames of group %u lost", missing, (unsigned)rx_current_group);
+    }
+    out_buffer.writeArray(rx_group.data(), cfg.group_size * cfg.payload_size);
+    rx_valid_mask = 0;
+    rx_has_parity = false;
+    rx_current_group++;
+  }
+};
+
+}  // namespace audio_tools
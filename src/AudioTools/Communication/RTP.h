@@ -0,0 +1,301 @@
+#pragma once
+
+#include "AudioTools/CoreAudio/AudioBasic/Collections.h"
+#include "AudioTools/CoreAudio/AudioLogger.h"
+#include "AudioTools/CoreAudio/BaseStream.h"
+#include "AudioTools/CoreAudio/Buffers.h"
+
+namespace audio_tools {
+
+/**
+ * @brief A parsed RTP packet: the payload points into the original packet
+ * buffer, so no data is copied
+ * @ingroup communications
+ */
+struct RTPPacket {
+  uint8_t version = 0;
+  bool marker = false;
+  uint8_t payload_type = 0;
+  uint16_t sequence = 0;
+  uint32_t timestamp = 0;
+  uint32_t ssrc = 0;
+  uint8_t *payload = nullptr;
+  int payload_size = 0;
+};
+
+/**
+ * @brief Parses RTP packets in place: the header length is determined with
+ * header arithmetic (fixed header + csrc count + extension length) and the
+ * payload is provided as a span into the original buffer - no scanning and
+ * no copy. Sequence numbers are tracked to report lost packets.
+ * @ingroup communications
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ */
+class RTPDepacketizer {
+ public:
+  /// Parses the packet: returns false if the data is no valid RTP packet
+  bool parse(uint8_t *data, int len, RTPPacket &result) {
+    if (data == nullptr || len < RTP_HEADER_SIZE) return false;
+    result.version = data[0] >> 6;
+    if (result.version != 2) return false;
+    bool has_padding = data[0] & 0x20;
+    bool has_extension = data[0] & 0x10;
+    int csrc_count = data[0] & 0x0F;
+    result.marker = data[1] & 0x80;
+    result.payload_type = data[1] & 0x7F;
+    result.sequence = ((uint16_t)data[2] << 8) | data[3];
+    result.timestamp = ((uint32_t)data[4] << 24) | ((uint32_t)data[5] << 16) |
+                       ((uint32_t)data[6] << 8) | data[7];
+    result.ssrc = ((uint32_t)data[8] << 24) | ((uint32_t)data[9] << 16) |
+                  ((uint32_t)data[10] << 8) | data[11];
+
+    // header length arithmetic: fixed header + csrc list + extension
+    int header = RTP_HEADER_SIZE + 4 * csrc_count;
+    if (has_extension) {
+      if (header + 4 > len) return false;
+      int ext_words = ((int)data[header + 2] << 8) | data[header + 3];
+      header += 4 + 4 * ext_words;
+    }
+    int end = len;
+    if (has_padding) {
+      int pad = data[len - 1];
+      if (pad < 1 || pad > end) return false;
+      end -= pad;
+    }
+    if (header > end) return false;
+
+    result.payload = data + header;
+    result.payload_size = end - header;
+    trackSequence(result.sequence);
+    return true;
+  }
+
+  /// Number of successfully parsed packets
+  uint32_t packetsReceived() { return packets_received; }
+
+  /// Number of packets missing according to the sequence numbers
+  uint32_t packetsLost() { return packets_lost; }
+
+  void resetStats() {
+    packets_received = 0;
+    packets_lost = 0;
+    has_sequence = false;
+  }
+
+ protected:
+  static const int RTP_HEADER_SIZE = 12;
+  uint32_t packets_received = 0;
+  uint32_t packets_lost = 0;
+  uint16_t next_sequence = 0;
+  bool has_sequence = false;
+
+  void trackSequence(uint16_t sequence) {
+    packets_received++;
+    if (has_sequence && sequence != next_sequence) {
+      // distance with wrap around: reordered (late) packets are ignored
+      int16_t gap = (int16_t)(sequence - next_sequence);
+      if (gap > 0) {
+        packets_lost += gap;
+        LOGW("rtp: %d packet(s) lost", (int)gap);
+      }
+    }
+    has_sequence = true;
+    next_sequence = sequence + 1;
+  }
+};
+
+/**
+ * @brief Parses the RTSP TCP interleaved framing ($ channel length16): the
+ * frame boundaries are determined from the length fields, so consecutive
+ * frames are located arithmetically without scanning the stream. When a
+ * complete RTP packet sits inside one write the payload span is handed to
+ * the callback straight out of the input buffer; only packets spanning
+ * writes are collected first.
+ * @ingroup communications
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ */
+class RTSPInterleavedParser {
+ public:
+  /// Callback which receives the parsed packets of one interleaved frame
+  typedef void (*PayloadCallback)(RTPPacket &packet, int channel, void *ref);
+
+  void setPayloadCallback(PayloadCallback cb, void *ref = nullptr) {
+    callback = cb;
+    callback_ref = ref;
+  }
+
+  /// Restricts the parsing to one interleaved channel (-1 = all channels)
+  void setChannelFilter(int channel) { channel_filter = channel; }
+
+  /// Provides access to the sequence statistics
+  RTPDepacketizer &depacketizer() { return rtp; }
+
+  /// Feeds received tcp data: can be called with arbitrary chunk sizes
+  size_t write(const uint8_t *data, size_t len) {
+    size_t pos = 0;
+    while (pos < len) {
+      switch (state) {
+        case Magic:
+          if (data[pos] == '$') {
+            state = Header;
+            header_pos = 0;
+            pos++;
+          } else {
+            // out of sync: this only happens on a protocol error
+            LOGW("rtsp: skipping unexpected byte 0x%02x", data[pos]);
+            pos++;
+          }
+          break;
+        case Header:
+          header[header_pos++] = data[pos++];
+          if (header_pos == 3) {
+            frame_channel = header[0];
+            frame_size = ((int)header[1] << 8) | header[2];
+            frame_pos = 0;
+            state = Body;
+            if (frame_size == 0) state = Magic;
+          }
+          break;
+        case Body: {
+          int open = frame_size - frame_pos;
+          int avail = (int)(len - pos);
+          if (frame_pos == 0 && avail >= open) {
+            // fast path: the complete packet is in the input buffer
+            processFrame((uint8_t *)data + pos, frame_size);
+            pos += open;
+            state = Magic;
+          } else {
+            // the packet spans writes: collect it first
+            if ((int)frame_buffer.size() < frame_size)
+              frame_buffer.resize(frame_size);
+            int n = min(open, avail);
+            memcpy(frame_buffer.data() + frame_pos, data + pos, n);
+            frame_pos += n;
+            pos += n;
+            if (frame_pos == frame_size) {
+              processFrame(frame_buffer.data(), frame_size);
+              state = Magic;
+            }
+          }
+          break;
+        }
+      }
+    }
+    return len;
+  }
+
+ protected:
+  enum State { Magic, Header, Body };
+  State state = Magic;
+  uint8_t header[3];
+  int header_pos = 0;
+  int frame_channel = 0;
+  int frame_size = 0;
+  int frame_pos = 0;
+  int channel_filter = -1;
+  Vector<uint8_t> frame_buffer{0};
+  RTPDepacketizer rtp;
+  PayloadCallback callback = nullptr;
+  void *callback_ref = nullptr;
+
+  void processFrame(uint8_t *data, int len) {
+    if (channel_filter >= 0 && frame_channel != channel_filter) return;
+    RTPPacket packet;
+    if (rtp.parse(data, len, packet)) {
+      if (callback != nullptr) callback(packet, frame_channel, callback_ref);
+    } else {
+      LOGW("rtsp: invalid rtp packet on channel %d", frame_channel);
+    }
+  }
+};
+
+/**
+ * @brief RTP over UDP receiver with a receive ring: processUDP() drains the
+ * socket, strips the RTP headers in place and stores only the payload in
+ * the ring, so short stalls of the consumer (e.g. a UI redraw) do not lose
+ * packets as long as the ring has space. The template parameter is the
+ * Arduino UDP implementation (e.g. WiFiUDP).
+ * @ingroup communications
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ * @tparam UDPT
+ */
+template <class UDPT>
+class RTPReceiverUDPT : public BaseStream {
+ public:
+  RTPReceiverUDPT() = default;
+  RTPReceiverUDPT(UDPT &udp) { p_udp = &udp; }
+
+  void setUDP(UDPT &udp) { p_udp = &udp; }
+
+  /// Defines the size of the receive ring (default 8192 bytes)
+  void setBufferSize(int size) { buffer_size = size; }
+
+  bool begin(uint16_t port) {
+    if (p_udp == nullptr) {
+      p_udp = &default_udp;
+    }
+    ring.resize(buffer_size);
+    packet_buffer.resize(1500);
+    rtp.resetStats();
+    return p_udp->begin(port);
+  }
+
+  void end() {
+    p_udp->stop();
+    ring.reset();
+  }
+
+  /// Drains all waiting udp packets into the receive ring: call this often
+  /// (e.g. from a task) - it returns the number of processed packets
+  int processUDP() {
+    int count = 0;
+    while (true) {
+      int size = p_udp->parsePacket();
+      if (size <= 0) break;
+      if (size > (int)packet_buffer.size()) packet_buffer.resize(size);
+      int len = p_udp->read(packet_buffer.data(), size);
+      RTPPacket packet;
+      if (rtp.parse(packet_buffer.data(), len, packet)) {
+        int written = ring.writeArray(packet.payload, packet.payload_size);
+        if (written < packet.payload_size) {
+          dropped_bytes += packet.payload_size - written;
+          LOGW("rtp: receive ring overflow");
+        }
+        count++;
+      }
+    }
+    return count;
+  }
+
+  int available() override {
+    processUDP();
+    return ring.available();
+  }
+
+  size_t readBytes(uint8_t *data, size_t len) override {
+    processUDP();
+    return ring.readArray(data, len);
+  }
+
+  size_t write(const uint8_t *data, size_t len) override { return 0; }
+
+  /// Provides access to the sequence statistics
+  RTPDepacketizer &depacketizer() { return rtp; }
+
+  /// Payload bytes which were discarded because the ring was full
+  uint32_t droppedBytes() { return dropped_bytes; }
+
+ protected:
+  UDPT *p_udp = nullptr;
+  UDPT default_udp;
+  RingBuffer<uint8_t> ring{0};
+  Vector<uint8_t> packet_buffer{0};
+  RTPDepacketizer rtp;
+  int buffer_size = 1024 * 8;
+  uint32_t dropped_bytes = 0;
+};
+
+}  // namespace audio_tools
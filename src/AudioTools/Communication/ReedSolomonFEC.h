@@ -7,8 +7,14 @@
 namespace audio_tools {
 
 /**
- * @brief Forward error correction using Reed-Solomon: 
+ * @brief Forward error correction using Reed-Solomon:
  * write is encoding and readBytes does the decoding.
+ * The encode path is table driven: since the generator polynomial is fixed
+ * by the template parameters, we precompute one 256 byte multiply table per
+ * generator coefficient, so the hot remainder loop is a single table read
+ * and xor per byte instead of log/exp lookups with a modulo. The input is
+ * copied into the block buffer with memcpy based block writes and the
+ * encode time per block is profiled (encodeTimeUs()).
  * @ingroup fec
  * @author Phil Schatzmann
  * @copyright GPLv3
@@ -20,22 +26,29 @@ class ReedSolomonFEC : public BaseStream {
     ReedSolomonFEC(Stream &stream){
         p_stream = &stream;
         p_print = &stream;
+        buildTables();
     }
 
     ReedSolomonFEC(Print &print){
         p_print = &print;
+        buildTables();
     }
 
     int availableForWrite() override {
         return bytecount;
     }
-    
+
     size_t write(const uint8_t* data, size_t len) override {
         if (p_print==nullptr) return 0;
-        for (int j=0;j<len;j++){
-            raw.write(data[j]);
+        size_t pos = 0;
+        while (pos < len){
+            // block copy instead of writing byte by byte
+            pos += raw.writeArray(data + pos, len - pos);
             if(raw.availableForWrite()==0){
-                rs.Encode(raw.data(), encoded.data());
+                uint32_t start_us = micros();
+                encodeBlock(raw.data(), encoded.data());
+                encode_time_us += micros() - start_us;
+                encode_blocks++;
                 p_print->write(encoded.data(), bytecount+additional_bytes);
                 raw.reset();
             }
@@ -57,6 +70,19 @@ class ReedSolomonFEC : public BaseStream {
         return encoded.readArray(data, len);
     }
 
+    /// average encode time per block in microseconds
+    uint32_t encodeTimeUs() {
+        return encode_blocks == 0 ? 0 : encode_time_us / encode_blocks;
+    }
+
+    /// number of encoded blocks since the last clearProfile()
+    uint32_t blocksEncoded() { return encode_blocks; }
+
+    /// restarts the encode time profiling
+    void clearProfile() {
+        encode_time_us = 0;
+        encode_blocks = 0;
+    }
 
   protected:
     SingleBuffer<uint8_t> raw{bytecount};
@@ -64,7 +90,53 @@ class ReedSolomonFEC : public BaseStream {
     RS::ReedSolomon<bytecount, additional_bytes> rs;
     Stream* p_stream = nullptr;
     Print* p_print = nullptr;
+    // one multiply table per generator coefficient (coefficient 0 is 1)
+    uint8_t gen_mul[additional_bytes + 1][256];
+    uint8_t work[bytecount + additional_bytes];
+    uint64_t encode_time_us = 0;
+    uint32_t encode_blocks = 0;
+
+    /// Precomputes the multiply tables for the fixed generator polynomial
+    void buildTables() {
+        // generator polynomial: product of (x - 2^i)
+        uint8_t gen[additional_bytes + 1] = {0};
+        uint8_t next[additional_bytes + 1];
+        gen[0] = 1;
+        int len = 1;
+        for (int i = 0; i < additional_bytes; i++){
+            uint8_t factor = RS::gf::pow(2, i);
+            next[0] = gen[0];
+            for (int j = 1; j <= len; j++){
+                next[j] = (j < len ? gen[j] : 0) ^ RS::gf::mul(gen[j-1], factor);
+            }
+            len++;
+            memcpy(gen, next, len);
+        }
+        for (int j = 0; j <= additional_bytes; j++){
+            gen_mul[j][0] = 0;
+            for (int c = 1; c < 256; c++){
+                gen_mul[j][c] = RS::gf::mul(gen[j], c);
+            }
+        }
+    }
+
+    /// Systematic encode of one block: the message is followed by the
+    /// polynomial remainder as ecc bytes
+    void encodeBlock(const uint8_t* src, uint8_t* dst) {
+        memcpy(work, src, bytecount);
+        memset(work + bytecount, 0, additional_bytes);
+        for (int i = 0; i < bytecount; i++){
+            uint8_t coef = work[i];
+            if (coef != 0){
+                for (int j = 1; j <= additional_bytes; j++){
+                    work[i+j] ^= gen_mul[j][coef];
+                }
+            }
+        }
+        memcpy(dst, src, bytecount);
+        memcpy(dst + bytecount, work + bytecount, additional_bytes);
+    }
 
 };
 
-}
\ No newline at end of file
+}
@@ -3,8 +3,11 @@
 #include <esp_wifi.h>
 #include <WiFiUdp.h>
 
+#include "AudioTools/CoreAudio/AudioClock.h"
 #include "AudioTools/CoreAudio/BaseStream.h"
 #include "AudioTools/CoreAudio/Buffers.h"
+#include "AudioTools/CoreAudio/Fade.h"
+#include "AudioTools/Communication/AudioSync.h"
 
 namespace audio_tools {
 
@@ -148,4 +151,371 @@ protected:
   }
 };
 
+/**
+ * @brief Configuration for UDPJitterStream
+ */
+struct UDPJitterConfig : public AudioInfo {
+  UDPJitterConfig() {
+    sample_rate = 44100;
+    channels = 2;
+    bits_per_sample = 16;
+  }
+  /// payload bytes per udp packet
+  int packet_size = 1024;
+  /// capacity of the reorder buffer in packets
+  int buffer_packets = 32;
+  /// initial playout delay in ms
+  int target_ms = 60;
+  /// lower limit for the adapted playout delay
+  int min_target_ms = 20;
+  /// upper limit for the adapted playout delay
+  int max_target_ms = 200;
+  /// adapt the playout delay to the measured jitter variance
+  bool is_adaptive = true;
+  /// number of consecutive concealed packets before we rebuffer
+  int max_conceal = 10;
+};
+
+/**
+ * @brief Jitter buffer stage for UDPStream: on the sending side each write
+ * is sent as a packet with a sequence number and a timestamp; on the
+ * receiving side the packets are reordered by sequence number and released
+ * by a monotonic playout clock, so that bursts of network jitter do not
+ * reach the audio output. The playout delay can adapt to the measured
+ * interarrival jitter (RFC 3550 estimator) and lost packets are concealed
+ * by repeating the last packet and fading it to silence with the
+ * LastSampleFader.
+ * @ingroup communications
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ */
+class UDPJitterStream : public AudioStream {
+public:
+  UDPJitterStream(UDPStream &udp) { p_udp = &udp; }
+
+  UDPJitterConfig defaultConfig() {
+    UDPJitterConfig result;
+    result.copyFrom(audioInfo());
+    return result;
+  }
+
+  bool begin(UDPJitterConfig cfg) {
+    TRACED();
+    config = cfg;
+    bytes_per_frame = cfg.channels * cfg.bits_per_sample / 8;
+    if (bytes_per_frame == 0 || cfg.sample_rate == 0) {
+      LOGE("invalid audio info");
+      return false;
+    }
+    if (p_drift != nullptr) p_drift->begin(cfg);
+    played_bytes_acc = 0;
+    // a packet must hold full frames
+    config.packet_size -= config.packet_size % bytes_per_frame;
+    frames_per_packet = config.packet_size / bytes_per_frame;
+    packet_us = 1000000ull * frames_per_packet / cfg.sample_rate;
+    slots.resize(config.buffer_packets);
+    for (auto &slot : slots) {
+      slot.data.resize(config.packet_size);
+      slot.valid = false;
+    }
+    current.resize(config.packet_size);
+    last_packet.resize(config.packet_size);
+    rx_packet.resize(config.packet_size + sizeof(PacketHeader));
+    out_buffer.resize(config.packet_size);
+    fader.setAudioInfo(config);
+    jitter_ms = 0.0f;
+    has_transit = false;
+    has_last_packet = false;
+    is_playing = false;
+    is_sync = true;
+    current_size = 0;
+    current_pos = 0;
+    consecutive_loss = 0;
+    lost_packets = 0;
+    late_packets = 0;
+    concealed_packets = 0;
+    send_seq = 0;
+    setAudioInfo(config);
+    return true;
+  }
+
+  bool begin() { return begin(config); }
+
+  void end() override {
+    is_playing = false;
+    is_sync = true;
+    out_buffer.reset();
+    current_size = 0;
+  }
+
+  /// Sending side: the data is collected into packets of the configured
+  /// size which are sent with a sequence number and a timestamp
+  size_t write(const uint8_t *data, size_t len) override {
+    size_t pos = 0;
+    while (pos < len) {
+      pos += out_buffer.writeArray(data + pos, len - pos);
+      if (out_buffer.isFull()) sendPacket();
+    }
+    return len;
+  }
+
+  int availableForWrite() override { return config.packet_size; }
+
+  /// Receiving side: provides the reordered data at the playout rate
+  size_t readBytes(uint8_t *data, size_t len) override {
+    fetchPackets();
+    if (current_pos >= current_size && !preparePacket()) return 0;
+    size_t result = min(len, (size_t)(current_size - current_pos));
+    memcpy(data, current.data() + current_pos, result);
+    current_pos += result;
+    if (p_drift != nullptr) {
+      played_bytes_acc += result;
+      p_drift->recordPlayed(played_bytes_acc / bytes_per_frame);
+      played_bytes_acc %= bytes_per_frame;
+    }
+    if (current_pos >= current_size) {
+      // the packet is consumed: advance the playout clock
+      next_playout_us += packet_us;
+    }
+    return result;
+  }
+
+  int available() override {
+    fetchPackets();
+    if (current_pos >= current_size && !preparePacket()) return 0;
+    return current_size - current_pos;
+  }
+
+  /// Provides the measured interarrival jitter in ms
+  float jitterMs() { return jitter_ms; }
+
+  /// Provides the active playout delay in ms
+  int targetMs() {
+    return (int)(targetPackets() * packet_us / 1000);
+  }
+
+  /// Number of packets which did not arrive in time
+  uint32_t lostPackets() { return lost_packets; }
+
+  /// Number of packets which arrived after their playout time
+  uint32_t latePackets() { return late_packets; }
+
+  /// Number of packets which were replaced by concealment data
+  uint32_t concealedPackets() { return concealed_packets; }
+
+  /// Defines the controller which compensates the clock drift against the
+  /// sender with the help of the packet timestamps
+  void setDriftController(ClockDriftController &controller) {
+    p_drift = &controller;
+  }
+
+  /// Defines the clock for the playout timing: tests can inject a
+  /// SimulatedClock
+  void setClock(AudioClockBase &clock) { p_clock = &clock; }
+
+protected:
+  struct PacketHeader {
+    uint16_t seq;
+    uint16_t size;
+    uint32_t time_ms;
+  };
+
+  struct Slot {
+    uint16_t seq = 0;
+    bool valid = false;
+    Vector<uint8_t> data{0};
+  };
+
+  UDPStream *p_udp = nullptr;
+  UDPJitterConfig config;
+  AudioClockBase *p_clock = &defaultClock();
+  ClockDriftController *p_drift = nullptr;
+  int bytes_per_frame = 0;
+  int played_bytes_acc = 0;
+  Vector<Slot> slots;
+  Vector<uint8_t> current{0};
+  Vector<uint8_t> last_packet{0};
+  Vector<uint8_t> rx_packet{0};
+  SingleBuffer<uint8_t> out_buffer{0};
+  LastSampleFader fader;
+  uint64_t packet_us = 0;
+  uint64_t next_playout_us = 0;
+  int frames_per_packet = 0;
+  int current_size = 0;
+  int current_pos = 0;
+  int consecutive_loss = 0;
+  uint16_t send_seq = 0;
+  uint16_t next_seq = 0;
+  uint16_t highest_seq = 0;
+  bool is_playing = false;
+  bool is_sync = true;       // waiting for the first packet
+  bool has_last_packet = false;
+  // jitter estimation
+  float jitter_ms = 0.0f;
+  int32_t last_transit = 0;
+  bool has_transit = false;
+  // statistics
+  uint32_t lost_packets = 0;
+  uint32_t late_packets = 0;
+  uint32_t concealed_packets = 0;
+
+  /// Sends the collected payload as one udp packet
+  void sendPacket() {
+    uint8_t packet[sizeof(PacketHeader) + config.packet_size];
+    PacketHeader header;
+    header.seq = send_seq++;
+    header.size = out_buffer.available();
+    header.time_ms = p_clock->millis();
+    memcpy(packet, &header, sizeof(header));
+    int len = out_buffer.readArray(packet + sizeof(header), header.size);
+    out_buffer.reset();
+    p_udp->write(packet, sizeof(header) + len);
+  }
+
+  /// Moves the arrived packets into the reorder buffer: when the buffer is
+  /// full the remaining packets are left in the udp receive queue
+  void fetchPackets() {
+    while (depth() < config.buffer_packets - 1 &&
+           p_udp->available() >= (int)sizeof(PacketHeader)) {
+      int len = p_udp->readBytes(rx_packet.data(), rx_packet.size());
+      if (len < (int)sizeof(PacketHeader)) break;
+      PacketHeader header;
+      memcpy(&header, rx_packet.data(), sizeof(header));
+      updateJitter(header.time_ms);
+      if (is_sync) {
+        // the first packet defines the start of the sequence
+        next_seq = header.seq;
+        highest_seq = header.seq;
+        is_sync = false;
+      }
+      // drop packets which have already been played or concealed
+      if ((int16_t)(header.seq - next_seq) < 0) {
+        late_packets++;
+        healthIncrement(HealthUdpLatePacket);
+        continue;
+      }
+      if ((int16_t)(header.seq - highest_seq) > 0) highest_seq = header.seq;
+      Slot &slot = slots[header.seq % config.buffer_packets];
+      slot.seq = header.seq;
+      slot.valid = true;
+      int size = min((int)header.size, config.packet_size);
+      memcpy(slot.data.data(), rx_packet.data() + sizeof(header), size);
+      if (p_drift != nullptr) {
+        p_drift->recordReceived(size / bytes_per_frame, header.time_ms);
+      }
+    }
+  }
+
+  /// RFC 3550 interarrival jitter estimate (works with unsynchronized
+  /// sender and receiver clocks)
+  void updateJitter(uint32_t sent_ms) {
+    int32_t transit = (int32_t)(p_clock->millis() - sent_ms);
+    if (has_transit) {
+      int32_t d = transit - last_transit;
+      if (d < 0) d = -d;
+      jitter_ms += ((float)d - jitter_ms) / 16.0f;
+    }
+    last_transit = transit;
+    has_transit = true;
+  }
+
+  /// Playout delay in packets: adapted to the measured jitter
+  int targetPackets() {
+    int target_ms = config.target_ms;
+    if (config.is_adaptive) {
+      target_ms = (int)(jitter_ms * 4.0f);
+      if (target_ms < config.min_target_ms) target_ms = config.min_target_ms;
+      if (target_ms > config.max_target_ms) target_ms = config.max_target_ms;
+    }
+    int result = target_ms * 1000 / packet_us;
+    if (result < 1) result = 1;
+    if (result > config.buffer_packets - 1) result = config.buffer_packets - 1;
+    return result;
+  }
+
+  /// Number of packets between the playout position and the newest arrival
+  int depth() {
+    if (is_sync) return 0;
+    return (int16_t)(highest_seq - next_seq) + 1;
+  }
+
+  /// Provides the next packet to play in current: either the received data
+  /// or concealment data when the packet did not arrive in time
+  bool preparePacket() {
+    if (!is_playing) {
+      // prebuffering until the playout delay is reached
+      if (depth() < targetPackets()) return false;
+      is_playing = true;
+      next_playout_us = p_clock->micros();
+    }
+    // the monotonic playout clock paces the output
+    if ((int64_t)(p_clock->micros() - next_playout_us) < 0) return false;
+
+    Slot &slot = slots[next_seq % config.buffer_packets];
+    if (slot.valid && slot.seq == next_seq) {
+      memcpy(current.data(), slot.data.data(), config.packet_size);
+      slot.valid = false;
+      // track the last samples for the concealment fade
+      fader.write(current.data(), config.packet_size);
+      memcpy(last_packet.data(), current.data(), config.packet_size);
+      has_last_packet = true;
+      consecutive_loss = 0;
+    } else if (depth() > 0) {
+      // the packet did not arrive in time
+      if (consecutive_loss < config.max_conceal) {
+        conceal();
+      } else {
+        // give up concealing: play silence until real data arrives
+        memset(current.data(), 0, config.packet_size);
+        lost_packets++;
+        healthIncrement(HealthUdpLostPacket);
+        consecutive_loss++;
+      }
+    } else {
+      // nothing to play: rebuffer before we continue
+      LOGW("jitter buffer underrun: rebuffering");
+      is_playing = false;
+      consecutive_loss = 0;
+      return false;
+    }
+    next_seq++;
+    current_size = config.packet_size;
+    current_pos = 0;
+    return true;
+  }
+
+  /// Packet loss concealment: the first missing packet repeats the last
+  /// one, further losses are faded to silence
+  void conceal() {
+    lost_packets++;
+    healthIncrement(HealthUdpLostPacket);
+    concealed_packets++;
+    consecutive_loss++;
+    if (has_last_packet && consecutive_loss == 1) {
+      memcpy(current.data(), last_packet.data(), config.packet_size);
+    } else {
+      FadeTarget target(current.data(), config.packet_size);
+      fader.end(target, frames_per_packet);
+      // anything the fade did not fill is silence
+      memset(current.data() + target.pos, 0, config.packet_size - target.pos);
+    }
+    LOGD("concealed packet %u", (unsigned)next_seq);
+  }
+
+  /// Print adapter which lets the fader write into the current packet
+  struct FadeTarget : public Print {
+    uint8_t *data;
+    int max;
+    int pos = 0;
+    FadeTarget(uint8_t *data, int max) : data(data), max(max) {}
+    size_t write(const uint8_t *src, size_t len) override {
+      int result = min((int)len, max - pos);
+      memcpy(data + pos, src, result);
+      pos += result;
+      return result;
+    }
+    size_t write(uint8_t c) override { return write(&c, 1); }
+  };
+};
+
 } // namespace audio_tools
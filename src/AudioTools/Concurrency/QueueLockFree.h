@@ -8,7 +8,8 @@
 namespace audio_tools {
 
 /**
- * @brief A simple single producer, single consumer lock free queue
+ * @brief A simple single producer, single consumer lock free queue. Use
+ * QueueLockFreeMPSC when multiple tasks need to feed the same queue.
  */
 template <typename T>
 class QueueLockFree {
@@ -89,6 +90,60 @@ class QueueLockFree {
     return true;
   }
 
+  /// Enqueues up to len elements and reserves the complete index range
+  /// with a single atomic update, so that the synchronization cost is
+  /// amortized across the batch: returns the number of stored elements
+  int enqueueN(const T data[], int len) {
+    size_t tail = tail_pos.load(std::memory_order_relaxed);
+    // determine how many consecutive slots are free
+    int n = 0;
+    while (n < len) {
+      Node* node = &p_node[(tail + n) & capacity_mask];
+      if (node->tail.load(std::memory_order_acquire) != tail + n) break;
+      n++;
+    }
+    if (n == 0) return 0;
+    // reserve the complete range at once: fails (and can be retried) when
+    // another producer interfered
+    if (!tail_pos.compare_exchange_strong(tail, tail + n,
+                                          std::memory_order_relaxed))
+      return 0;
+    // bulk copy and publish the slots in order
+    for (int j = 0; j < n; j++) {
+      Node* node = &p_node[(tail + j) & capacity_mask];
+      new (&node->data) T(data[j]);
+      node->head.store(tail + j, std::memory_order_release);
+    }
+    return n;
+  }
+
+  /// Dequeues up to len elements with a single atomic update of the head
+  /// position: returns the number of provided elements
+  int dequeueN(T data[], int len) {
+    size_t head = head_pos.load(std::memory_order_relaxed);
+    // determine how many consecutive slots are filled
+    int n = 0;
+    while (n < len) {
+      Node* node = &p_node[(head + n) & capacity_mask];
+      if (node->head.load(std::memory_order_acquire) != head + n) break;
+      n++;
+    }
+    if (n == 0) return 0;
+    // reserve the complete range at once: fails (and can be retried) when
+    // another consumer interfered
+    if (!head_pos.compare_exchange_strong(head, head + n,
+                                          std::memory_order_relaxed))
+      return 0;
+    // bulk copy and release the slots in order
+    for (int j = 0; j < n; j++) {
+      Node* node = &p_node[(head + j) & capacity_mask];
+      data[j] = node->data;
+      (&node->data)->~T();
+      node->tail.store(head + j + capacity_value, std::memory_order_release);
+    }
+    return n;
+  }
+
   void clear() {
     T tmp;
     while (dequeue(tmp));
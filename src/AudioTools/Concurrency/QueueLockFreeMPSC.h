@@ -0,0 +1,130 @@
+#pragma once
+#include <stdint.h>
+
+#include <atomic>
+#include <cstddef>
+
+#include "AudioTools/CoreAudio/AudioBasic/Collections/Vector.h"
+
+namespace audio_tools {
+
+/**
+ * @brief A bounded multi producer lock free queue: multiple writer tasks
+ * (e.g. a network RX task, a file task and a control task) can feed a
+ * single consumer without ever taking a mutex. Each slot carries a
+ * sequence counter, so concurrent producers claim distinct slots with a
+ * single compare and exchange. The capacity is rounded up to the next
+ * power of 2. It is also safe with multiple consumers.
+ * @ingroup concurrency
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ */
+template <typename T>
+class QueueLockFreeMPSC {
+ public:
+  QueueLockFreeMPSC(size_t capacity, Allocator& allocator = DefaultAllocator) {
+    setAllocator(allocator);
+    resize(capacity);
+  }
+
+  ~QueueLockFreeMPSC() { clear(); }
+
+  void setAllocator(Allocator& allocator) { vector.setAllocator(allocator); }
+
+  void resize(size_t capacity) {
+    capacity_mask = capacity - 1;
+    for (size_t i = 1; i <= sizeof(void*) * 4; i <<= 1)
+      capacity_mask |= capacity_mask >> i;
+    capacity_value = capacity_mask + 1;
+
+    vector.resize(capacity_value);
+    p_node = vector.data();
+
+    for (size_t i = 0; i < capacity_value; ++i)
+      p_node[i].sequence.store(i, std::memory_order_relaxed);
+
+    tail_pos.store(0, std::memory_order_relaxed);
+    head_pos.store(0, std::memory_order_relaxed);
+  }
+
+  size_t capacity() const { return capacity_value; }
+
+  bool empty() { return size() == 0; }
+
+  size_t size() const {
+    size_t head = head_pos.load(std::memory_order_acquire);
+    return tail_pos.load(std::memory_order_relaxed) - head;
+  }
+
+  bool enqueue(const T&& data) { return enqueue(data); }
+
+  /// Adds an entry: safe to call concurrently from multiple tasks
+  bool enqueue(const T& data) {
+    Node* node;
+    size_t tail = tail_pos.load(std::memory_order_relaxed);
+    for (;;) {
+      node = &p_node[tail & capacity_mask];
+      size_t seq = node->sequence.load(std::memory_order_acquire);
+      intptr_t diff = (intptr_t)seq - (intptr_t)tail;
+      if (diff == 0) {
+        // slot is free: try to claim it
+        if (tail_pos.compare_exchange_weak(tail, tail + 1,
+                                           std::memory_order_relaxed))
+          break;
+      } else if (diff < 0) {
+        // the slot still holds an unconsumed entry -> queue is full
+        return false;
+      } else {
+        // another producer claimed the slot: reload and retry
+        tail = tail_pos.load(std::memory_order_relaxed);
+      }
+    }
+    new (&node->data) T(data);
+    node->sequence.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  /// Removes the oldest entry
+  bool dequeue(T& result) {
+    Node* node;
+    size_t head = head_pos.load(std::memory_order_relaxed);
+    for (;;) {
+      node = &p_node[head & capacity_mask];
+      size_t seq = node->sequence.load(std::memory_order_acquire);
+      intptr_t diff = (intptr_t)seq - (intptr_t)(head + 1);
+      if (diff == 0) {
+        if (head_pos.compare_exchange_weak(head, head + 1,
+                                           std::memory_order_relaxed))
+          break;
+      } else if (diff < 0) {
+        // the slot has not been published yet -> queue is empty
+        return false;
+      } else {
+        head = head_pos.load(std::memory_order_relaxed);
+      }
+    }
+    result = node->data;
+    (&node->data)->~T();
+    node->sequence.store(head + capacity_value, std::memory_order_release);
+    return true;
+  }
+
+  void clear() {
+    T tmp;
+    while (dequeue(tmp));
+  }
+
+ protected:
+  struct Node {
+    T data;
+    std::atomic<size_t> sequence;
+  };
+
+  Node* p_node = nullptr;
+  size_t capacity_mask;
+  size_t capacity_value;
+  std::atomic<size_t> tail_pos;
+  std::atomic<size_t> head_pos;
+  Vector<Node> vector;
+};
+}  // namespace audio_tools
@@ -4,3 +4,4 @@
 #include "AudioTools/Concurrency/SynchronizedQueue.h"
 #include "AudioTools/Concurrency/RP2040/BufferRP2040.h"
 #include "AudioTools/Concurrency/RP2040/MutexRP2040.h"
+#include "AudioTools/Concurrency/RP2040/AudioPumpRP2040.h"
@@ -0,0 +1,239 @@
+#pragma once
+
+#ifndef ARDUINO_ARCH_RP2040
+# error "Unsupported architecture"
+#endif
+
+#include "AudioConfig.h"
+#include "AudioTools/CoreAudio/AudioLogger.h"
+#include "AudioTools/CoreAudio/AudioStreams.h"
+#include "AudioTools/CoreAudio/Buffers.h"
+#include "AudioTools/CoreAudio/StreamCopy.h"
+#include "hardware/sync.h"
+#include "pico/multicore.h"
+
+namespace audio_tools {
+
+/**
+ * @brief Ring buffer which is guarded by a RP2040 hardware spinlock: much
+ * cheaper then the SDK mutex and safe to use from both cores. The data is
+ * copied in blocks, so the critical sections stay short.
+ * @ingroup buffers
+ * @ingroup concurrency
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ * @tparam T
+ */
+template <typename T>
+class BufferRP2040Spinlock : public BaseBuffer<T> {
+ public:
+  BufferRP2040Spinlock(int size) : BaseBuffer<T>() {
+    lock_num = spin_lock_claim_unused(true);
+    p_lock = spin_lock_init(lock_num);
+    resize(size);
+  }
+
+  ~BufferRP2040Spinlock() { spin_lock_unclaim(lock_num); }
+
+  /// Re-Allocats the memory (size is in entries)
+  bool resize(int size) {
+    if (size <= 0) return false;
+    vector.resize(size + 1);
+    capacity = size + 1;
+    reset();
+    return true;
+  }
+
+  // reads a single value
+  T read() override {
+    T data = 0;
+    readArray(&data, 1);
+    return data;
+  }
+
+  // peeks the actual entry from the buffer
+  T peek() override {
+    uint32_t irq = spin_lock_blocking(p_lock);
+    T result = read_pos == write_pos ? T(0) : vector[read_pos];
+    spin_unlock(p_lock, irq);
+    return result;
+  }
+
+  // reads multiple values
+  int readArray(T data[], int len) override {
+    uint32_t irq = spin_lock_blocking(p_lock);
+    int result = min(len, availableUnlocked());
+    int copied = 0;
+    while (copied < result) {
+      int to_copy = min(result - copied, capacity - read_pos);
+      memcpy(data + copied, vector.data() + read_pos, to_copy * sizeof(T));
+      read_pos = (read_pos + to_copy) % capacity;
+      copied += to_copy;
+    }
+    spin_unlock(p_lock, irq);
+    return result;
+  }
+
+  int writeArray(const T data[], int len) override {
+    uint32_t irq = spin_lock_blocking(p_lock);
+    int result = min(len, availableForWriteUnlocked());
+    int copied = 0;
+    while (copied < result) {
+      int to_copy = min(result - copied, capacity - write_pos);
+      memcpy(vector.data() + write_pos, data + copied, to_copy * sizeof(T));
+      write_pos = (write_pos + to_copy) % capacity;
+      copied += to_copy;
+    }
+    spin_unlock(p_lock, irq);
+    return result;
+  }
+
+  // write add an entry to the buffer
+  bool write(T data) override { return writeArray(&data, 1) == 1; }
+
+  // checks if the buffer is full
+  bool isFull() override { return availableForWrite() == 0; }
+
+  bool isEmpty() { return available() == 0; }
+
+  // clears the buffer
+  void reset() override {
+    uint32_t irq = spin_lock_blocking(p_lock);
+    read_pos = 0;
+    write_pos = 0;
+    spin_unlock(p_lock, irq);
+  }
+
+  // provides the number of entries that are available to read
+  int available() override {
+    uint32_t irq = spin_lock_blocking(p_lock);
+    int result = availableUnlocked();
+    spin_unlock(p_lock, irq);
+    return result;
+  }
+
+  // provides the number of entries that are available to write
+  int availableForWrite() override {
+    uint32_t irq = spin_lock_blocking(p_lock);
+    int result = availableForWriteUnlocked();
+    spin_unlock(p_lock, irq);
+    return result;
+  }
+
+  // returns the address of the start of the physical read buffer
+  T *address() override { return vector.data(); }
+
+  size_t size() { return capacity == 0 ? 0 : capacity - 1; }
+
+ protected:
+  Vector<T> vector{0};
+  spin_lock_t *p_lock = nullptr;
+  int lock_num = -1;
+  int capacity = 0;
+  int read_pos = 0;
+  int write_pos = 0;
+
+  int availableUnlocked() {
+    return (write_pos + capacity - read_pos) % capacity;
+  }
+
+  int availableForWriteUnlocked() {
+    return (read_pos + capacity - write_pos - 1) % capacity;
+  }
+};
+
+/**
+ * @brief Core to core audio pump for the RP2040 w/o FreeRTOS: core0
+ * decodes and writes the PCM data into a spinlock guarded ring and a
+ * StreamCopy loop which is launched on core1 drives the output (e.g.
+ * PWMAudioOutput). The startup and shutdown handshake uses the inter-core
+ * FIFO. Just use the pump as output of your decoder or player.
+ * @ingroup concurrency
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ */
+class AudioPumpRP2040 : public AudioStream {
+ public:
+  AudioPumpRP2040(Print &out, int bufferSize = 4 * 1024) {
+    p_out = &out;
+    buffer.resize(bufferSize);
+  }
+
+  /// Launches the copy loop on core1
+  bool begin() {
+    TRACED();
+    if (active) return true;
+    instance() = this;
+    active = true;
+    multicore_launch_core1(core1Entry);
+    // wait for the ready handshake over the inter-core FIFO
+    bool result = multicore_fifo_pop_blocking() == PumpReady;
+    if (!result) LOGE("core1 handshake failed");
+    return result;
+  }
+
+  /// Stops the copy loop and resets core1
+  void end() override {
+    TRACED();
+    if (!active) return;
+    active = false;
+    // wait until core1 has confirmed the stop
+    while (multicore_fifo_pop_blocking() != PumpStopped);
+    multicore_reset_core1();
+    instance() = nullptr;
+  }
+
+  /// Called on core0: blocks until all data fits into the ring
+  size_t write(const uint8_t *data, size_t len) override {
+    size_t pos = 0;
+    while (pos < len && active) {
+      int written = buffer.writeArray(data + pos, len - pos);
+      pos += written;
+      if (written == 0) delay(1);
+    }
+    return pos;
+  }
+
+  int availableForWrite() override { return buffer.availableForWrite(); }
+
+  /// Called on core1 by the StreamCopy loop
+  size_t readBytes(uint8_t *data, size_t len) override {
+    return buffer.readArray(data, len);
+  }
+
+  int available() override { return buffer.available(); }
+
+  operator bool() { return active; }
+
+ protected:
+  enum : uint32_t { PumpReady = 0x70756d70, PumpStopped = 0x73746f70 };
+  BufferRP2040Spinlock<uint8_t> buffer{1};
+  Print *p_out = nullptr;
+  volatile bool active = false;
+
+  /// core1 can only be launched with a plain function: we provide the
+  /// actual pump via this singleton
+  static AudioPumpRP2040 *&instance() {
+    static AudioPumpRP2040 *inst = nullptr;
+    return inst;
+  }
+
+  static void core1Entry() {
+    AudioPumpRP2040 *self = instance();
+    multicore_fifo_push_blocking(PumpReady);
+    self->pumpLoop();
+  }
+
+  /// StreamCopy loop running on core1
+  void pumpLoop() {
+    StreamCopy copier(*p_out, *this);
+    while (active) {
+      if (copier.copy() == 0) delay(1);
+    }
+    multicore_fifo_push_blocking(PumpStopped);
+    // wait to be reset by core0
+    while (true) delay(100);
+  }
+};
+
+}  // namespace audio_tools
@@ -2,6 +2,15 @@
 #include "AudioTools/Concurrency/RTOS/QueueRTOS.h"
 #include "AudioTools/Concurrency/RTOS/BufferRTOS.h"
 #include "AudioTools/Concurrency/RTOS/Task.h"
+#include "AudioTools/Concurrency/RTOS/TaskPool.h"
+#include "AudioTools/Concurrency/RTOS/AsyncStreamCopy.h"
+#include "AudioTools/Concurrency/RTOS/AsyncWriteStream.h"
+#include "AudioTools/Concurrency/RTOS/AsyncLogOutput.h"
+#include "AudioTools/Concurrency/RTOS/AsyncPipelineStage.h"
+#include "AudioTools/Concurrency/RTOS/AsyncStreamingDecoder.h"
+#include "AudioTools/Concurrency/RTOS/AudioSourcePrefetch.h"
+#include "AudioTools/Concurrency/RTOS/ReadAheadStream.h"
+#include "AudioTools/Concurrency/RTOS/AudioPlayerAsync.h"
 #include "AudioTools/Concurrency/RTOS/MutexRTOS.h"
 #include "AudioTools/Concurrency/RTOS/SynchronizedNBufferRTOS.h"
 #include "AudioTools/Concurrency/LockGuard.h"
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "AudioTools/Concurrency/RTOS/QueueRTOS.h"
+#include "AudioTools/Concurrency/RTOS/Task.h"
+
+namespace audio_tools {
+
+/**
+ * @brief Deferred logging backend for the AudioLogger: install it with
+ * AudioLogger::instance().begin(asyncLog, level) and the logging call
+ * only copies the formatted line into a fixed size record of a FreeRTOS
+ * queue and returns - a low priority task flushes the records to the
+ * actual (slow) output. This way a LOGI in a hot path no longer stalls
+ * the audio for the duration of a Serial write and it becomes safe to
+ * leave the logging enabled in production. When the queue is full the
+ * line is dropped and counted: see overflowCount().
+ * @ingroup concurrency
+ * @ingroup tools
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ */
+class AsyncLogOutput : public Print {
+ public:
+  /**
+   * @brief Construct a new Async Log Output
+   *
+   * @param out the actual (slow) output e.g. Serial
+   * @param recordCount number of queued log lines (default 30)
+   * @param core core for the flush task (-1 = any)
+   * @param priority flush task priority (default 0: idle priority)
+   */
+  AsyncLogOutput(Print &out, int recordCount = 30, int core = -1,
+                 int priority = 0)
+      : queue(recordCount, 0, portMAX_DELAY) {
+    p_out = &out;
+    this->core = core;
+    this->priority = priority;
+  }
+
+  ~AsyncLogOutput() { end(); }
+
+  /// Defines the flush task stack size in bytes (default 10000)
+  void setStackSize(int size) { stack_size = size; }
+
+  /// Starts the flush task
+  bool begin() {
+    if (is_active) return true;
+    overflow_count = 0;
+    line_pos = 0;
+    is_active = true;
+    task.create("log-flush", stack_size, priority, core);
+    task.begin([this]() { flushStep(); });
+    return true;
+  }
+
+  /// Flushes the queued records and stops the task
+  void end() {
+    if (!is_active) return;
+    for (int j = 0; j < 100 && queue.size() > 0; j++) delay(10);
+    is_active = false;
+    task.end();
+  }
+
+  /// Collects the characters of the log line: a complete line is queued
+  /// as one record
+  size_t write(uint8_t ch) override {
+    if (!is_active) return p_out->write(ch);
+    if (ch == '\n') {
+      commit();
+      return 1;
+    }
+    if (ch != '\r' && line_pos < (int)sizeof(line.msg) - 1) {
+      line.msg[line_pos++] = ch;
+    }
+    return 1;
+  }
+
+  size_t write(const uint8_t *data, size_t len) {
+    for (size_t j = 0; j < len; j++) write(data[j]);
+    return len;
+  }
+
+  /// The actual write to the slow output is done by the flush task
+  void flush() override {}
+
+  /// Number of log lines which were dropped because the queue was full
+  size_t overflowCount() { return overflow_count; }
+
+  operator bool() { return is_active; }
+
+ protected:
+  /// A log line as fixed size record
+  struct LogRecord {
+    char msg[LOG_PRINTF_BUFFER_SIZE] = {0};
+  };
+
+  QueueRTOS<LogRecord> queue;
+  Task task;
+  Print *p_out = nullptr;
+  LogRecord line;
+  int line_pos = 0;
+  int core = -1;
+  int priority = 0;
+  int stack_size = 10000;
+  volatile size_t overflow_count = 0;
+  volatile bool is_active = false;
+
+  /// Queues the completed line: never blocks, drops on overflow
+  void commit() {
+    line.msg[line_pos] = 0;
+    if (!queue.enqueue(line)) overflow_count++;
+    line_pos = 0;
+  }
+
+  /// Executed by the flush task: writes one record to the slow output
+  void flushStep() {
+    LogRecord rec;
+    if (queue.dequeue(rec, pdMS_TO_TICKS(100))) {
+      p_out->println(rec.msg);
+    }
+  }
+};
+
+}  // namespace audio_tools
@@ -0,0 +1,125 @@
+#pragma once
+
+#include "AudioTools/Concurrency/RTOS/BufferRTOS.h"
+#include "AudioTools/Concurrency/RTOS/Task.h"
+#include "AudioTools/CoreAudio/AudioStreams.h"
+
+namespace audio_tools {
+
+/**
+ * @brief ModifyingStream which decouples the stages of a Pipeline with a
+ * thread safe buffer and a FreeRTOS task, so that the up- and downstream
+ * parts of the chain run concurrently (e.g. on different cores of a dual
+ * core ESP32). In an output chain the writes are queued and the task
+ * drains the buffer into the next stage; in an input chain the task
+ * prefetches from the prior stage and reads are served from the buffer.
+ * Just pipeline.add() it between the stages that should be decoupled.
+ * @ingroup concurrency
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ */
+class AsyncPipelineStage : public ModifyingStream {
+ public:
+  /**
+   * @brief Construct a new Async Pipeline Stage
+   *
+   * @param bufferSize size of the decoupling buffer in bytes
+   * @param core core on which the stage task runs (-1 = any)
+   * @param priority task priority
+   * @param stackSize task stack size in bytes
+   */
+  AsyncPipelineStage(int bufferSize = 4 * DEFAULT_BUFFER_SIZE, int core = -1,
+                     int priority = 1, int stackSize = 10000) {
+    buffer_size = bufferSize;
+    this->core = core;
+    this->priority = priority;
+    stack_size = stackSize;
+  }
+
+  ~AsyncPipelineStage() { end(); }
+
+  void setStream(Stream &in) override { p_in = &in; }
+
+  void setOutput(Print &out) override { p_out = &out; }
+
+  bool begin() override {
+    TRACED();
+    buffer.resize(buffer_size);
+    // do not block the audio task when the buffer runs dry/full
+    buffer.setReadMaxWait(5);
+    buffer.setWriteMaxWait(5);
+    temp.resize(DEFAULT_BUFFER_SIZE);
+    task.create("pipeline-stage", stack_size, priority, core);
+    task.begin([this]() { process(); });
+    active = true;
+    return true;
+  }
+
+  void end() override {
+    active = false;
+    task.end();
+  }
+
+  /// output chain: the data is queued and processed by the stage task
+  size_t write(const uint8_t *data, size_t len) override {
+    if (!active) return 0;
+    return buffer.writeArray(data, len);
+  }
+
+  int availableForWrite() override {
+    return active ? buffer.availableForWrite() : 0;
+  }
+
+  /// input chain: serves the data prefetched by the stage task
+  size_t readBytes(uint8_t *data, size_t len) override {
+    if (!active) return 0;
+    return buffer.readArray(data, len);
+  }
+
+  int available() override { return active ? buffer.available() : 0; }
+
+  /// Fill level of the decoupling buffer in %
+  float bufferLevelPercent() { return buffer.levelPercent(); }
+
+ protected:
+  BufferRTOS<uint8_t> buffer{0};
+  Vector<uint8_t> temp{0};
+  Task task;
+  Stream *p_in = nullptr;
+  Print *p_out = nullptr;
+  int buffer_size;
+  int core;
+  int priority;
+  int stack_size;
+  volatile bool active = false;
+
+  /// task loop: moves one block between the buffer and the adjacent stage
+  void process() {
+    if (!active) {
+      delay(10);
+      return;
+    }
+    if (p_in != nullptr) {
+      // input chain: prefetch from the prior stage
+      int len = min((int)temp.size(), buffer.availableForWrite());
+      if (len > 0) {
+        int n = p_in->readBytes(temp.data(), len);
+        if (n > 0) {
+          buffer.writeArray(temp.data(), n);
+          return;
+        }
+      }
+    } else if (p_out != nullptr) {
+      // output chain: drain into the next stage
+      int n = buffer.readArray(temp.data(), temp.size());
+      if (n > 0) {
+        p_out->write(temp.data(), n);
+        return;
+      }
+    }
+    // no data: yield
+    delay(1);
+  }
+};
+
+}  // namespace audio_tools
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "AudioTools/Concurrency/RTOS/BufferRTOS.h"
+#include "AudioTools/Concurrency/RTOS/Task.h"
+#include "AudioTools/CoreAudio/BaseStream.h"
+#include "AudioTools/CoreAudio/StreamCopy.h"
+
+namespace audio_tools {
+
+/**
+ * @brief Asynchronous StreamCopy which runs the copy loop on dedicated
+ * FreeRTOS tasks, so that e.g. the network read (URLStream) and the I2S
+ * write can run on different cores. The data is handed over via a lock
+ * free BufferRTOS: a read task fills the buffer from the source and a
+ * write task drains it into the sink. Just call begin() to start and
+ * end() to stop the processing; bytesCopied() and bytesPerSecond()
+ * report the throughput.
+ * @ingroup concurrency
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ */
+class AsyncStreamCopy {
+ public:
+  /**
+   * @brief Construct a new Async Stream Copy
+   *
+   * @param to sink (e.g. I2SStream)
+   * @param from source (e.g. URLStream)
+   * @param bufferSize size of the handoff buffer in bytes
+   * @param readCore core for the source read task (-1 = any)
+   * @param writeCore core for the sink write task (-1 = any)
+   */
+  AsyncStreamCopy(Print &to, Stream &from, int bufferSize = 4 * DEFAULT_BUFFER_SIZE,
+                  int readCore = -1, int writeCore = -1)
+      : buffer(bufferSize), queue_stream(buffer) {
+    read_core = readCore;
+    write_core = writeCore;
+    copier_in.begin(queue_stream, from);
+    copier_out.begin(to, queue_stream);
+  }
+
+  /// Defines the task priority (default 1)
+  void setPriority(int priority) { task_priority = priority; }
+
+  /// Defines the task stack size in bytes (default 10000)
+  void setStackSize(int size) { stack_size = size; }
+
+  /// Starts the copy tasks
+  bool begin() {
+    TRACED();
+    bytes_copied = 0;
+    start_time = millis();
+    queue_stream.begin();
+    read_task.create("async-copy-read", stack_size, task_priority, read_core);
+    write_task.create("async-copy-write", stack_size, task_priority,
+                      write_core);
+    read_task.begin([this]() { copier_in.copy(); });
+    write_task.begin([this]() { bytes_copied += copier_out.copy(); });
+    active = true;
+    return true;
+  }
+
+  /// Stops the copy tasks
+  void end() {
+    TRACED();
+    read_task.end();
+    write_task.end();
+    queue_stream.end();
+    active = false;
+  }
+
+  bool isActive() { return active; }
+
+  /// Total number of bytes written to the sink
+  size_t bytesCopied() { return bytes_copied; }
+
+  /// Average throughput since begin()
+  size_t bytesPerSecond() {
+    unsigned long run_time = millis() - start_time;
+    return run_time == 0 ? 0 : bytes_copied * 1000 / run_time;
+  }
+
+  /// Fill level of the handoff buffer in %
+  float bufferLevelPercent() { return buffer.levelPercent(); }
+
+  /// Access to the copier that reads from the source
+  StreamCopy &readCopier() { return copier_in; }
+
+  /// Access to the copier that writes to the sink
+  StreamCopy &writeCopier() { return copier_out; }
+
+ protected:
+  BufferRTOS<uint8_t> buffer;
+  QueueStream<uint8_t> queue_stream;
+  StreamCopy copier_in;
+  StreamCopy copier_out;
+  Task read_task;
+  Task write_task;
+  int read_core = -1;
+  int write_core = -1;
+  int task_priority = 1;
+  int stack_size = 10000;
+  volatile size_t bytes_copied = 0;
+  unsigned long start_time = 0;
+  bool active = false;
+};
+
+}  // namespace audio_tools
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "AudioTools/AudioCodecs/AudioCodecsBase.h"
+#include "AudioTools/Concurrency/RTOS/BufferRTOS.h"
+#include "AudioTools/Concurrency/RTOS/Task.h"
+
+namespace audio_tools {
+
+/**
+ * @brief Dual core pipelined decoding for a StreamingDecoder: the input
+ * fetch runs on a dedicated FreeRTOS task (pinned to the indicated core)
+ * which fills a thread safe buffer, while the codec's synthesis keeps
+ * running on the caller's task via copy(). This splits a decode that does
+ * not fit on a single core (e.g. FLAC 24/96) into two halves that run
+ * concurrently on a dual core ESP32. The handover buffer is byte oriented,
+ * so it works for any codec independently of its framing.
+ * @ingroup concurrency
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ */
+class AsyncStreamingDecoder : public StreamingDecoder {
+ public:
+  /**
+   * @brief Construct a new Async Streaming Decoder
+   *
+   * @param decoder the actual StreamingDecoder
+   * @param bufferSize size of the handover buffer in bytes
+   * @param core core on which the input fetch task runs (-1 = any)
+   * @param priority fetch task priority
+   * @param stackSize fetch task stack size in bytes
+   */
+  AsyncStreamingDecoder(StreamingDecoder &decoder, int bufferSize = 8 * 1024,
+                        int core = 0, int priority = 1, int stackSize = 10000) {
+    p_decoder = &decoder;
+    buffer_size = bufferSize;
+    this->core = core;
+    this->priority = priority;
+    stack_size = stackSize;
+  }
+
+  ~AsyncStreamingDecoder() { end(); }
+
+  void setOutput(Print &out_stream) override {
+    StreamingDecoder::setOutput(out_stream);
+    p_decoder->setOutput(out_stream);
+  }
+
+  void setOutput(AudioStream &out_stream) override {
+    StreamingDecoder::setOutput((Print &)out_stream);
+    p_decoder->setOutput(out_stream);
+  }
+
+  void setOutput(AudioOutput &out_stream) override {
+    StreamingDecoder::setOutput((Print &)out_stream);
+    p_decoder->setOutput(out_stream);
+  }
+
+  bool begin() override {
+    TRACED();
+    if (p_input == nullptr) {
+      LOGE("input not defined");
+      return false;
+    }
+    buffer.resize(buffer_size);
+    source.setBuffer(buffer);
+    // the decoder reads the prefetched data from the buffer
+    p_decoder->setInput(source);
+    if (!p_decoder->begin()) return false;
+    is_active = true;
+    task.create("dec-fetch", stack_size, priority, core);
+    task.begin([this]() { fetch(); });
+    return true;
+  }
+
+  void end() override {
+    if (!is_active) return;
+    is_active = false;
+    task.end();
+    p_decoder->end();
+  }
+
+  AudioInfo audioInfo() override { return p_decoder->audioInfo(); }
+
+  operator bool() override { return is_active && (bool)*p_decoder; }
+
+  /// Executes the synthesis on the caller's task
+  bool copy() override { return p_decoder->copy(); }
+
+ protected:
+  /// Stream facade which serves the decoder from the handover buffer
+  class BufferSource : public AudioStream {
+   public:
+    void setBuffer(BaseBuffer<uint8_t> &buf) { p_buffer = &buf; }
+    size_t readBytes(uint8_t *data, size_t len) override {
+      return p_buffer->readArray(data, len);
+    }
+    int available() override { return p_buffer->available(); }
+    size_t write(const uint8_t *data, size_t len) override { return 0; }
+    int availableForWrite() override { return 0; }
+
+   protected:
+    BaseBuffer<uint8_t> *p_buffer = nullptr;
+  };
+
+  StreamingDecoder *p_decoder = nullptr;
+  BufferRTOS<uint8_t> buffer{0};
+  BufferSource source;
+  Task task;
+  int buffer_size;
+  int core;
+  int priority;
+  int stack_size;
+  volatile bool is_active = false;
+
+  size_t readBytes(uint8_t *data, size_t len) override {
+    return p_input != nullptr ? p_input->readBytes(data, len) : 0;
+  }
+
+  /// Task loop: fetches the encoded input into the handover buffer
+  void fetch() {
+    if (!is_active) {
+      delay(5);
+      return;
+    }
+    uint8_t tmp[512];
+    int n = p_input->readBytes(tmp, sizeof(tmp));
+    if (n > 0) {
+      // blocks when the buffer is full
+      buffer.writeArray(tmp, n);
+    } else {
+      delay(5);
+    }
+  }
+};
+
+}  // namespace audio_tools
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "AudioTools/Concurrency/RTOS/BufferRTOS.h"
+#include "AudioTools/Concurrency/RTOS/Task.h"
+#include "AudioTools/CoreAudio/AudioOutput.h"
+
+namespace audio_tools {
+
+/**
+ * @brief Asynchronous write aggregation for slow sinks (e.g. CsvOutput,
+ * SD or Serial): the audio task just copies the data into a thread safe
+ * BufferRTOS and a low priority FreeRTOS task drains it into the actual
+ * sink. This way a logger or file writer that is orders of magnitude
+ * slower than the audio path can no longer stall it. When the buffer
+ * fill level exceeds the high watermark new writes are discarded instead
+ * of blocking: the dropped bytes are counted and can be queried with
+ * bytesDropped().
+ * @ingroup concurrency
+ * @ingroup io
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ */
+class AsyncWriteStream : public AudioOutput {
+ public:
+  /**
+   * @brief Construct a new Async Write Stream
+   *
+   * @param out the actual (slow) sink
+   * @param bufferSize size of the handoff buffer in bytes
+   * @param core core for the drain task (-1 = any)
+   * @param priority drain task priority (default 1: below the audio tasks)
+   */
+  AsyncWriteStream(Print &out, int bufferSize = 4 * DEFAULT_BUFFER_SIZE,
+                   int core = -1, int priority = 1) {
+    p_out = &out;
+    buffer.resize(bufferSize);
+    // the writer must never block on the buffer
+    buffer.setWriteMaxWait(0);
+    buffer.setReadMaxWait(0);
+    this->core = core;
+    this->priority = priority;
+  }
+
+  ~AsyncWriteStream() { end(); }
+
+  /// Defines the drain task stack size in bytes (default 10000)
+  void setStackSize(int size) { stack_size = size; }
+
+  /// Defines the fill level in percent above which new writes are
+  /// discarded (default 90)
+  void setHighWatermarkPercent(int percent) { high_watermark = percent; }
+
+  /// Defines the number of bytes that are written to the sink per drain
+  /// step (default 1024): bigger chunks mean fewer slow sink calls
+  void setDrainChunkSize(int size) { drain_chunk_size = size; }
+
+  /// Starts the drain task
+  bool begin() {
+    TRACED();
+    if (is_active) return true;
+    bytes_dropped = 0;
+    is_active = true;
+    task.create("async-write", stack_size, priority, core);
+    task.begin([this]() { drain(); });
+    return true;
+  }
+
+  /// Drains the remaining data and stops the task
+  void end() override {
+    TRACED();
+    if (!is_active) return;
+    // give the drain task a chance to empty the buffer
+    for (int j = 0; j < 100 && buffer.available() > 0; j++) delay(10);
+    is_active = false;
+    task.end();
+  }
+
+  /// Queues the data: never blocks, drops when above the high watermark
+  size_t write(const uint8_t *data, size_t len) override {
+    if (!is_active) return 0;
+    if (buffer.levelPercent() >= high_watermark) {
+      bytes_dropped += len;
+      // report success so that a dropped log write does not abort the
+      // audio processing
+      return len;
+    }
+    size_t result = buffer.writeArray(data, len);
+    bytes_dropped += len - result;
+    return len;
+  }
+
+  int availableForWrite() override { return buffer.availableForWrite(); }
+
+  /// Number of bytes which were discarded because the sink was too slow
+  size_t bytesDropped() { return bytes_dropped; }
+
+  /// Fill level of the handoff buffer in %
+  float bufferLevelPercent() { return buffer.levelPercent(); }
+
+  operator bool() { return is_active; }
+
+ protected:
+  BufferRTOS<uint8_t> buffer{0};
+  Task task;
+  Print *p_out = nullptr;
+  Vector<uint8_t> drain_buffer{0};
+  int core = -1;
+  int priority = 1;
+  int stack_size = 10000;
+  int high_watermark = 90;
+  int drain_chunk_size = 1024;
+  volatile size_t bytes_dropped = 0;
+  volatile bool is_active = false;
+
+  /// Executed by the drain task: moves one chunk to the slow sink
+  void drain() {
+    if (drain_buffer.size() != (size_t)drain_chunk_size)
+      drain_buffer.resize(drain_chunk_size);
+    int len = buffer.readArray(drain_buffer.data(), drain_chunk_size);
+    if (len > 0) {
+      p_out->write(drain_buffer.data(), len);
+    } else {
+      delay(5);
+    }
+  }
+};
+
+}  // namespace audio_tools
@@ -0,0 +1,199 @@
+#pragma once
+
+#include "AudioTools/Concurrency/LockGuard.h"
+#include "AudioTools/Concurrency/RTOS/MutexRTOS.h"
+#include "AudioTools/Concurrency/RTOS/Task.h"
+#include "AudioTools/CoreAudio/AudioBasic/Str.h"
+#include "AudioTools/CoreAudio/AudioPlayer.h"
+
+namespace audio_tools {
+
+/**
+ * @brief State of the AudioPlayerAsync
+ * @ingroup player
+ */
+enum class AudioPlayerState { Stopped, Opening, Playing, Error };
+
+/**
+ * @brief Non blocking open for the AudioPlayer: begin(), setPath(),
+ * setIndex() and next() just record the request and return immediately;
+ * the actual source open and codec priming is executed on a background
+ * FreeRTOS task, so a UI task never blocks on the network or the SD
+ * card. The player goes through the states Stopped -> Opening ->
+ * Playing (or Error) and a state change callback reports every
+ * transition (from the background task!). Call copy() from the audio
+ * task as usual: it is only copying while the state is Playing.
+ * @ingroup concurrency
+ * @ingroup player
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ */
+class AudioPlayerAsync {
+ public:
+  /**
+   * @brief Construct a new Audio Player Async
+   *
+   * @param player the actual AudioPlayer
+   * @param core core for the open task (-1 = any)
+   * @param priority open task priority
+   * @param stackSize open task stack size in bytes
+   */
+  AudioPlayerAsync(AudioPlayer &player, int core = -1, int priority = 1,
+                   int stackSize = 10000) {
+    p_player = &player;
+    this->core = core;
+    this->priority = priority;
+    stack_size = stackSize;
+  }
+
+  ~AudioPlayerAsync() { end(); }
+
+  /// Defines the callback which reports every state change: it is
+  /// executed from the background task
+  void setStateChangeCallback(std::function<void(AudioPlayerState)> cb) {
+    state_callback = cb;
+  }
+
+  /// Requests the (re)start from the indicated index: returns right away
+  bool begin(int index = 0) {
+    TRACED();
+    startTask();
+    request(CmdBegin, index, nullptr);
+    return true;
+  }
+
+  /// Stops the background task and the player
+  void end() {
+    if (is_task_active) {
+      task.end();
+      is_task_active = false;
+    }
+    p_player->end();
+    setState(AudioPlayerState::Stopped);
+  }
+
+  /// Requests the indicated file: returns right away
+  bool setPath(const char *path) {
+    TRACED();
+    startTask();
+    request(CmdPath, 0, path);
+    return true;
+  }
+
+  /// Requests the indicated index: returns right away
+  bool setIndex(int idx) {
+    TRACED();
+    startTask();
+    request(CmdIndex, idx, nullptr);
+    return true;
+  }
+
+  /// Requests the next (or nth next) title: returns right away
+  bool next(int offset = 1) {
+    TRACED();
+    startTask();
+    request(CmdNext, offset, nullptr);
+    return true;
+  }
+
+  /// Requests the previous title: returns right away
+  bool previous(int offset = 1) {
+    TRACED();
+    startTask();
+    request(CmdPrevious, offset, nullptr);
+    return true;
+  }
+
+  /// Actual state
+  AudioPlayerState state() { return actual_state; }
+
+  bool isPlaying() { return actual_state == AudioPlayerState::Playing; }
+
+  /// Call from the audio task: copies only while the state is Playing
+  size_t copy() {
+    if (actual_state != AudioPlayerState::Playing) return 0;
+    LockGuard guard{mutex};
+    return p_player->copy();
+  }
+
+  /// Access to the wrapped player (e.g. for setVolume)
+  AudioPlayer &player() { return *p_player; }
+
+ protected:
+  enum Cmd { CmdNone, CmdBegin, CmdPath, CmdIndex, CmdNext, CmdPrevious };
+
+  AudioPlayer *p_player = nullptr;
+  Task task;
+  MutexRTOS mutex;
+  std::function<void(AudioPlayerState)> state_callback = nullptr;
+  volatile AudioPlayerState actual_state = AudioPlayerState::Stopped;
+  volatile Cmd pending_cmd = CmdNone;
+  volatile int pending_arg = 0;
+  Str pending_path;
+  int core = -1;
+  int priority = 1;
+  int stack_size = 10000;
+  bool is_task_active = false;
+
+  void startTask() {
+    if (is_task_active) return;
+    task.create("player-open", stack_size, priority, core);
+    task.begin([this]() { openStep(); });
+    is_task_active = true;
+  }
+
+  /// Records the request: the last request wins when the background task
+  /// is still busy. Requests are expected from a single (UI) task.
+  void request(Cmd cmd, int arg, const char *path) {
+    pending_arg = arg;
+    if (path != nullptr) pending_path = path;
+    // publish the command last
+    pending_cmd = cmd;
+  }
+
+  void setState(AudioPlayerState state) {
+    if (state == actual_state) return;
+    actual_state = state;
+    if (state_callback) state_callback(state);
+  }
+
+  /// Executed by the background task: performs the blocking open
+  void openStep() {
+    if (pending_cmd == CmdNone) {
+      delay(10);
+      return;
+    }
+    Cmd cmd = pending_cmd;
+    int arg = pending_arg;
+    pending_cmd = CmdNone;
+    setState(AudioPlayerState::Opening);
+    bool ok = false;
+    {
+      LockGuard guard{mutex};
+      switch (cmd) {
+        case CmdBegin:
+          ok = p_player->begin(arg);
+          break;
+        case CmdPath:
+          ok = p_player->setPath(pending_path.c_str());
+          break;
+        case CmdIndex:
+          ok = p_player->setIndex(arg);
+          break;
+        case CmdNext:
+          ok = p_player->next(arg);
+          break;
+        case CmdPrevious:
+          ok = p_player->previous(arg);
+          break;
+        default:
+          break;
+      }
+    }
+    // a new request might have arrived while opening
+    if (pending_cmd != CmdNone) return;
+    setState(ok ? AudioPlayerState::Playing : AudioPlayerState::Error);
+  }
+};
+
+}  // namespace audio_tools
@@ -0,0 +1,148 @@
+#pragma once
+
+#include "AudioTools/Concurrency/RTOS/Task.h"
+#include "AudioTools/Disk/AudioSource.h"
+
+namespace audio_tools {
+
+/**
+ * @brief Decorator for an AudioSource which opens the next stream on a
+ * dedicated FreeRTOS task while the actual title is still playing. When
+ * the AudioPlayer moves to the next title the stream is already open and
+ * primed, so the audible gap on a track change disappears: combined with
+ * the player's setAutoFade(true) the handover is also click free. Use it
+ * by wrapping your source: AudioSourcePrefetch prefetch(source);
+ * AudioPlayer player(prefetch, out, decoder);
+ * @ingroup concurrency
+ * @ingroup player
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ */
+class AudioSourcePrefetch : public AudioSource {
+ public:
+  /**
+   * @brief Construct a new Audio Source Prefetch
+   *
+   * @param source the actual AudioSource
+   * @param core core on which the prefetch task runs (-1 = any)
+   * @param priority prefetch task priority
+   * @param stackSize prefetch task stack size in bytes
+   */
+  AudioSourcePrefetch(AudioSource& source, int core = 0, int priority = 1,
+                      int stackSize = 10000) {
+    p_source = &source;
+    this->core = core;
+    this->priority = priority;
+    stack_size = stackSize;
+  }
+
+  ~AudioSourcePrefetch() { end(); }
+
+  void begin() override {
+    TRACED();
+    p_source->begin();
+    p_prefetched = nullptr;
+    state = PrefetchState::Idle;
+    if (!is_task_active) {
+      task.create("src-prefetch", stack_size, priority, core);
+      task.begin([this]() { prefetch(); });
+      is_task_active = true;
+    }
+    // prime the first title in the background
+    state = PrefetchState::Requested;
+  }
+
+  /// Stops the prefetch task
+  void end() {
+    if (!is_task_active) return;
+    waitForPrefetch();
+    task.end();
+    is_task_active = false;
+  }
+
+  Stream* nextStream(int offset) override {
+    waitForPrefetch();
+    Stream* result = nullptr;
+    if (offset == 1 && state == PrefetchState::Ready) {
+      LOGI("using prefetched stream");
+      result = p_prefetched;
+    } else {
+      // a completed prefetch has already moved the source by one position
+      int correction = state == PrefetchState::Ready ? 1 : 0;
+      result = p_source->nextStream(offset - correction);
+    }
+    p_prefetched = nullptr;
+    // prepare the next track change in the background
+    state = PrefetchState::Requested;
+    return result;
+  }
+
+  Stream* selectStream(int index) override {
+    waitForPrefetch();
+    state = PrefetchState::Idle;
+    p_prefetched = nullptr;
+    Stream* result = p_source->selectStream(index);
+    state = PrefetchState::Requested;
+    return result;
+  }
+
+  Stream* selectStream(const char* path) override {
+    waitForPrefetch();
+    state = PrefetchState::Idle;
+    p_prefetched = nullptr;
+    Stream* result = p_source->selectStream(path);
+    state = PrefetchState::Requested;
+    return result;
+  }
+
+  void setTimeoutAutoNext(int millisec) override {
+    p_source->setTimeoutAutoNext(millisec);
+  }
+
+  int timeoutAutoNext() override { return p_source->timeoutAutoNext(); }
+
+  bool setMetadataCallback(void (*fn)(MetaDataType info, const char* str,
+                                      int len),
+                           ID3TypeSelection sel = SELECT_ICY) override {
+    return p_source->setMetadataCallback(fn, sel);
+  }
+
+  void setTimeout(int millisec) override { p_source->setTimeout(millisec); }
+
+  bool isAutoNext() override { return p_source->isAutoNext(); }
+
+  bool setPosition(size_t pos) override {
+    waitForPrefetch();
+    return p_source->setPosition(pos);
+  }
+
+ protected:
+  enum class PrefetchState { Idle, Requested, Ready };
+
+  AudioSource* p_source = nullptr;
+  Task task;
+  Stream* volatile p_prefetched = nullptr;
+  volatile PrefetchState state = PrefetchState::Idle;
+  bool is_task_active = false;
+  int core;
+  int priority;
+  int stack_size;
+
+  /// Task loop: opens the next stream when a prefetch has been requested
+  void prefetch() {
+    if (state == PrefetchState::Requested) {
+      p_prefetched = p_source->nextStream(1);
+      state = PrefetchState::Ready;
+    } else {
+      delay(5);
+    }
+  }
+
+  /// Waits until a requested prefetch has completed, so that the source is
+  /// never accessed from two tasks at the same time
+  void waitForPrefetch() {
+    while (state == PrefetchState::Requested) delay(1);
+  }
+};
+
+}  // namespace audio_tools
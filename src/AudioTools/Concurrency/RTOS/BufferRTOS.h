@@ -7,9 +7,11 @@
 #ifdef ESP32
 #  include <freertos/stream_buffer.h>
 #  include "freertos/FreeRTOS.h"
+#  include "freertos/task.h"
 #else
 #  include "FreeRTOS.h"
 #  include "stream_buffer.h"
+#  include "task.h"
 #endif
 
 namespace audio_tools {
@@ -208,6 +210,193 @@ class BufferRTOS : public BaseBuffer<T> {
 };
 // #endif // ESP_IDF_VERSION_MAJOR >= 4
 
+/**
+ * @brief Lock free single producer / single consumer buffer for the case
+ * where the producer runs in an ISR (e.g. an I2S or ADC conversion done
+ * callback) and the consumer is a task: the write never blocks and does
+ * not take any mutex, so the samples can be deposited directly from the
+ * ISR with one copy total. The consumer task is woken up with a task
+ * notification (vTaskNotifyGiveFromISR) when the trigger level has been
+ * reached. The read and write positions are aligned words, so on the
+ * ESP32 the individual updates are atomic.
+ * @ingroup buffers
+ * @ingroup concurrency
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ * @tparam T
+ */
+template <typename T>
+class BufferRTOSIsr : public BaseBuffer<T> {
+ public:
+  BufferRTOSIsr(size_t bufferSize, size_t xTriggerLevel = 1,
+                TickType_t readMaxWait = portMAX_DELAY,
+                Allocator &allocator = DefaultAllocator)
+      : BaseBuffer<T>() {
+    readWait = readMaxWait;
+    trigger_level = xTriggerLevel;
+    p_allocator = &allocator;
+    resize(bufferSize);
+  }
+
+  ~BufferRTOSIsr() { end(); }
+
+  /// Re-Allocates the memory
+  bool resize(size_t size) {
+    if (capacity == size + 1) return true;
+    end();
+    if (size == 0) return true;
+    p_data = (T *)p_allocator->allocate((size + 1) * sizeof(T));
+    if (p_data == nullptr) {
+      LOGE("allocate falied for %d bytes", (int)((size + 1) * sizeof(T)));
+      return false;
+    }
+    capacity = size + 1;
+    reset();
+    return true;
+  }
+
+  void setReadMaxWait(TickType_t ticks) { readWait = ticks; }
+
+  /// By default the producer is expected to run in an ISR: deactivate
+  /// this if the single producer is a regular task
+  void setWriteFromISR(bool active) { write_from_isr = active; }
+
+  /// Single producer: never blocks and can be called from the ISR
+  int writeArray(const T data[], int len) {
+    if (p_data == nullptr) return 0;
+    size_t wp = write_pos;
+    size_t rp = read_pos;
+    size_t free = (rp + capacity - wp - 1) % capacity;
+    int result = min((size_t)len, free);
+    int copied = 0;
+    while (copied < result) {
+      size_t to_copy = min((size_t)(result - copied), capacity - wp);
+      memcpy(p_data + wp, data + copied, to_copy * sizeof(T));
+      wp = (wp + to_copy) % capacity;
+      copied += to_copy;
+    }
+    // publish the new write position to the consumer
+    write_pos = wp;
+    notifyConsumer();
+    return result;
+  }
+
+  /// Single consumer: waits with a task notification when empty
+  int readArray(T data[], int len) {
+    if (p_data == nullptr) return 0;
+    // the first reader becomes the notified consumer task
+    if (p_consumer == nullptr) p_consumer = xTaskGetCurrentTaskHandle();
+    int result = readAvailable(data, len);
+    while (result == 0 && readWait > 0) {
+      // block until the producer notifies or the wait times out
+      if (ulTaskNotifyTake(pdTRUE, readWait) == 0) break;
+      result = readAvailable(data, len);
+    }
+    return result;
+  }
+
+  // reads a single value
+  T read() override {
+    T data = 0;
+    readArray(&data, 1);
+    return data;
+  }
+
+  // peeks the next entry from the buffer
+  T peek() override {
+    if (p_data == nullptr || read_pos == write_pos) return 0;
+    return p_data[read_pos];
+  }
+
+  // write add an entry to the buffer
+  bool write(T data) override { return writeArray(&data, 1) == 1; }
+
+  // checks if the buffer is full
+  bool isFull() override { return availableForWrite() == 0; }
+
+  bool isEmpty() { return read_pos == write_pos; }
+
+  // clears the buffer: only safe while the producer is not active
+  void reset() override {
+    read_pos = 0;
+    write_pos = 0;
+  }
+
+  // provides the number of entries that are available to read
+  int available() override {
+    if (capacity == 0) return 0;
+    return (write_pos + capacity - read_pos) % capacity;
+  }
+
+  // provides the number of entries that are available to write
+  int availableForWrite() override {
+    if (capacity == 0) return 0;
+    return (read_pos + capacity - write_pos - 1) % capacity;
+  }
+
+  // returns the address of the start of the physical read buffer
+  T *address() override { return p_data; }
+
+  size_t size() { return capacity == 0 ? 0 : capacity - 1; }
+
+  operator bool() { return p_data != nullptr && size() > 0; }
+
+ protected:
+  T *p_data = nullptr;
+  Allocator *p_allocator = nullptr;
+  TaskHandle_t p_consumer = nullptr;
+  BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+  // written only by the producer / read only by the consumer and v.v.
+  volatile size_t write_pos = 0;
+  volatile size_t read_pos = 0;
+  size_t capacity = 0;
+  size_t trigger_level = 0;
+  TickType_t readWait = portMAX_DELAY;
+  bool write_from_isr = true;
+
+  /// Wakes up the waiting consumer task when the trigger level is reached
+  void notifyConsumer() {
+    if (p_consumer == nullptr || available() < (int)trigger_level) return;
+    if (write_from_isr) {
+      xHigherPriorityTaskWoken = pdFALSE;
+      vTaskNotifyGiveFromISR(p_consumer, &xHigherPriorityTaskWoken);
+#ifdef ESP32X
+      portYIELD_FROM_ISR();
+#else
+      portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+#endif
+    } else {
+      xTaskNotifyGive(p_consumer);
+    }
+  }
+
+  /// Copies the available data w/o waiting
+  int readAvailable(T data[], int len) {
+    size_t rp = read_pos;
+    size_t wp = write_pos;
+    int result = min((size_t)len, (wp + capacity - rp) % capacity);
+    int copied = 0;
+    while (copied < result) {
+      size_t to_copy = min((size_t)(result - copied), capacity - rp);
+      memcpy(data + copied, p_data + rp, to_copy * sizeof(T));
+      rp = (rp + to_copy) % capacity;
+      copied += to_copy;
+    }
+    // publish the new read position to the producer
+    read_pos = rp;
+    return result;
+  }
+
+  /// Release resources: call resize to restart again
+  void end() {
+    if (p_data != nullptr) p_allocator->free(p_data);
+    p_data = nullptr;
+    capacity = 0;
+    read_pos = 0;
+    write_pos = 0;
+  }
+};
+
 template <class T>
 using SynchronizedBufferRTOS = BufferRTOS<T>;
 
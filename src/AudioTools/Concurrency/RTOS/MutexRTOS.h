@@ -12,6 +12,19 @@
 
 namespace audio_tools {
 
+/**
+ * @brief Per mutex contention counters: returned as plain struct, so that
+ * they can be published like the other metrics
+ */
+struct MutexMetrics {
+  /// number of lock() calls
+  uint32_t acquire_count = 0;
+  /// number of lock() calls which had to wait
+  uint32_t contended_count = 0;
+  /// longest observed wait in microseconds
+  uint32_t max_wait_us = 0;
+};
+
 /**
  * @brief Mutex implemntation using FreeRTOS
  * @ingroup concurrency
@@ -20,22 +33,49 @@ namespace audio_tools {
  */
 class MutexRTOS : public MutexBase {
 public:
-  MutexRTOS() {
-    xSemaphore = xSemaphoreCreateBinary();
-    xSemaphoreGive(xSemaphore);
+  /// @param priorityInheritance use a FreeRTOS mutex which temporarily
+  /// raises the priority of a low priority holder, so that e.g. a logging
+  /// task can not delay the audio task (priority inversion)
+  MutexRTOS(bool priorityInheritance = false) {
+    is_priority_inheritance = priorityInheritance;
+    if (priorityInheritance) {
+      xSemaphore = xSemaphoreCreateMutex();
+    } else {
+      xSemaphore = xSemaphoreCreateBinary();
+      xSemaphoreGive(xSemaphore);
+    }
   }
   virtual ~MutexRTOS() {
     vSemaphoreDelete(xSemaphore);
   }
   void lock() override {
+    stats.acquire_count++;
+    // uncontended fast path
+    if (xSemaphoreTake(xSemaphore, 0) == pdTRUE) return;
+    // measure how long we are blocked by the actual holder
+    stats.contended_count++;
+    uint32_t start = micros();
     xSemaphoreTake(xSemaphore, portMAX_DELAY);
+    uint32_t wait = micros() - start;
+    if (wait > stats.max_wait_us) stats.max_wait_us = wait;
   }
   void unlock() override {
     xSemaphoreGive(xSemaphore);
   }
 
+  /// Returns true when the priority inheritance mutex is used
+  bool isPriorityInheritance() { return is_priority_inheritance; }
+
+  /// Provides the contention counters
+  MutexMetrics metrics() { return stats; }
+
+  /// Restarts the contention counters
+  void resetMetrics() { stats = MutexMetrics(); }
+
 protected:
   SemaphoreHandle_t xSemaphore = NULL;
+  MutexMetrics stats;
+  bool is_priority_inheritance = false;
 };
 
 using Mutex = MutexRTOS;
@@ -74,6 +74,14 @@ class QueueRTOS {
     return xQueueReceive(xQueue, &data, (TickType_t)read_max_wait);
   }
 
+  /// Dequeue with an explicit wait time which overrules the configured
+  /// readMaxWait (e.g. 0 for a non blocking attempt)
+  bool dequeue(T& data, TickType_t maxWait) {
+    TRACED();
+    if (xQueue==nullptr) return false;
+    return xQueueReceive(xQueue, &data, maxWait);
+  }
+
   size_t size() { return queue_size; }
 
   bool clear() {
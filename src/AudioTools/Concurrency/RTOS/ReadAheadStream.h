@@ -0,0 +1,227 @@
+#pragma once
+
+#include "AudioTools/Concurrency/RTOS/BufferRTOS.h"
+#include "AudioTools/Concurrency/RTOS/Task.h"
+#include "AudioTools/CoreAudio/BaseStream.h"
+#include "AudioTools/Disk/AudioSource.h"
+
+namespace audio_tools {
+
+/**
+ * @brief Read ahead for slow sources (e.g. SD files): a background
+ * FreeRTOS task fills a big BufferRTOS with large sequential reads, so
+ * that the decoder on the audio task is served from RAM and the worst
+ * case SD latencies are hidden. The default allocator uses PSRAM when
+ * available, so the buffer can hold a couple of seconds of compressed
+ * data. Wrap your file with setStream() and read from this stream
+ * instead.
+ * @ingroup concurrency
+ * @ingroup io
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ */
+class ReadAheadStream : public BaseStream {
+ public:
+  /**
+   * @brief Construct a new Read Ahead Stream
+   *
+   * @param bufferSize size of the read ahead buffer in bytes
+   * @param core core for the fill task (-1 = any)
+   * @param priority fill task priority
+   */
+  ReadAheadStream(int bufferSize = 64 * 1024, int core = -1,
+                  int priority = 1) {
+    buffer.resize(bufferSize);
+    buffer.setWriteMaxWait(0);
+    buffer.setReadMaxWait(0);
+    this->core = core;
+    this->priority = priority;
+  }
+
+  ~ReadAheadStream() { end(); }
+
+  /// Defines the fill task stack size in bytes (default 10000)
+  void setStackSize(int size) { stack_size = size; }
+
+  /// Defines the number of bytes per sequential read (default 4096):
+  /// big reads let the SD library fetch multiple clusters at once
+  void setReadChunkSize(int size) { read_chunk_size = size; }
+
+  /// Defines the source and starts the fill task
+  bool begin(Stream &stream) {
+    setStream(stream);
+    return begin();
+  }
+
+  void setStream(Stream &stream) {
+    // stop the fill task while the source is replaced
+    bool was_active = is_active;
+    if (was_active) suspendFill();
+    p_stream = &stream;
+    buffer.reset();
+    is_eof = false;
+    if (was_active) resumeFill();
+  }
+
+  bool begin() override {
+    TRACED();
+    if (p_stream == nullptr) return false;
+    if (is_active) return true;
+    is_eof = false;
+    is_active = true;
+    task.create("read-ahead", stack_size, priority, core);
+    task.begin([this]() { fill(); });
+    return true;
+  }
+
+  void end() override {
+    TRACED();
+    if (!is_active) return;
+    is_active = false;
+    task.end();
+    buffer.reset();
+  }
+
+  /// Serves the data from the read ahead buffer: blocks only when the
+  /// buffer ran empty and the source still provides data
+  size_t readBytes(uint8_t *data, size_t len) override {
+    size_t result = 0;
+    while (result < len) {
+      int read = buffer.readArray(data + result, len - result);
+      result += read;
+      if (read == 0) {
+        if (is_eof) break;
+        delay(1);
+      }
+    }
+    return result;
+  }
+
+  int available() override {
+    int result = buffer.available();
+    // report pending data while the fill task is still reading
+    if (result == 0 && !is_eof) result = 1;
+    return result;
+  }
+
+  size_t write(const uint8_t *data, size_t len) override { return 0; }
+
+  int availableForWrite() override { return 0; }
+
+  /// Fill level of the read ahead buffer in %
+  float bufferLevelPercent() { return buffer.levelPercent(); }
+
+  operator bool() { return is_active && available() > 0; }
+
+ protected:
+  BufferRTOS<uint8_t> buffer{0};
+  Task task;
+  Stream *p_stream = nullptr;
+  Vector<uint8_t> chunk{0};
+  int core = -1;
+  int priority = 1;
+  int stack_size = 10000;
+  int read_chunk_size = 4096;
+  volatile bool is_active = false;
+  volatile bool is_eof = false;
+  volatile bool fill_suspended = false;
+  volatile bool fill_idle = false;
+
+  /// Executed by the fill task: one big sequential read per step
+  void fill() {
+    if (fill_suspended || is_eof) {
+      fill_idle = true;
+      delay(5);
+      return;
+    }
+    fill_idle = false;
+    if (chunk.size() != (size_t)read_chunk_size) chunk.resize(read_chunk_size);
+    int space = buffer.availableForWrite();
+    if (space < read_chunk_size) {
+      delay(5);
+      return;
+    }
+    size_t read = p_stream->readBytes(chunk.data(), read_chunk_size);
+    if (read > 0) {
+      buffer.writeArray(chunk.data(), read);
+    } else {
+      is_eof = true;
+    }
+  }
+
+  void suspendFill() {
+    fill_suspended = true;
+    // wait until the fill task has finished the current read
+    while (is_active && !fill_idle) delay(1);
+  }
+
+  void resumeFill() { fill_suspended = false; }
+};
+
+/**
+ * @brief Decorator for an AudioSource which interposes a ReadAheadStream
+ * on every provided stream: the AudioPlayer then decodes from the RAM
+ * buffer while a background task keeps it filled from the SD card. Use
+ * it by wrapping your source: AudioSourceReadAhead buffered(source);
+ * AudioPlayer player(buffered, out, decoder);
+ * @ingroup concurrency
+ * @ingroup player
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ */
+class AudioSourceReadAhead : public AudioSource {
+ public:
+  AudioSourceReadAhead(AudioSource &source, int bufferSize = 64 * 1024,
+                       int core = -1, int priority = 1)
+      : read_ahead(bufferSize, core, priority) {
+    p_source = &source;
+  }
+
+  void begin() override {
+    TRACED();
+    p_source->begin();
+  }
+
+  Stream *nextStream(int offset) override {
+    return wrap(p_source->nextStream(offset));
+  }
+
+  Stream *previousStream(int offset) override {
+    return wrap(p_source->previousStream(offset));
+  }
+
+  Stream *selectStream(int index) override {
+    return wrap(p_source->selectStream(index));
+  }
+
+  Stream *selectStream(const char *path) override {
+    return wrap(p_source->selectStream(path));
+  }
+
+  void setTimeoutAutoNext(int millisec) override {
+    p_source->setTimeoutAutoNext(millisec);
+  }
+
+  int timeoutAutoNext() override { return p_source->timeoutAutoNext(); }
+
+  bool isAutoNext() override { return p_source->isAutoNext(); }
+
+  /// Access to the buffering stream (e.g. for bufferLevelPercent())
+  ReadAheadStream &readAheadStream() { return read_ahead; }
+
+ protected:
+  AudioSource *p_source = nullptr;
+  ReadAheadStream read_ahead;
+
+  Stream *wrap(Stream *stream) {
+    if (stream == nullptr) {
+      read_ahead.end();
+      return nullptr;
+    }
+    read_ahead.setStream(*stream);
+    read_ahead.begin();
+    return &read_ahead;
+  }
+};
+
+}  // namespace audio_tools
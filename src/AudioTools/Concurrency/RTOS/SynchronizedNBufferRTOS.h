@@ -1,9 +1,19 @@
 #pragma once
+#include <atomic>
+
 #include "AudioConfig.h"
 #include "QueueRTOS.h"
 
 namespace audio_tools {
 
+/**
+ * @brief Defines what happens when all buffers are filled: Block waits
+ * until the reader has freed a buffer (lossless, unbounded latency),
+ * DropOldest discards the oldest filled buffer (bounded latency for live
+ * data), DropNewest discards the data which is currently written
+ */
+enum NBufferOverflowPolicy { OverflowBlock, OverflowDropOldest, OverflowDropNewest };
+
 /**
  * @brief NBuffer which uses some RTOS queues to manage the available and filled buffers
  * @ingroup buffers
@@ -31,6 +41,8 @@ public:
     }
 
     max_size = bufferSize * bufferCount;
+    buffer_size = bufferSize;
+    buffer_count = bufferCount;
     NBuffer<T>::buffer_count = bufferCount;
     NBuffer<T>::buffer_size = bufferSize;
 
@@ -41,14 +53,16 @@ public:
     setReadMaxWait(read_max_wait);
     setWriteMaxWait(write_max_wait);
 
-    // setup buffers
-    for (int j = 0; j < bufferCount; j++) {
-      BaseBuffer<T> *tmp = new SingleBuffer<T>(bufferSize);
-      if (tmp != nullptr) {
-        available_buffers.enqueue(tmp);
-      } else {
-        LOGE("Not Enough Memory for buffer %d", j);
-      }
+    createBuffers();
+  }
+
+  /// Defines the allocator (e.g. AllocatorPSRAM) which provides the buffer
+  /// memory: already existing buffers are re-allocated
+  void setAllocator(Allocator &allocator) {
+    p_allocator = &allocator;
+    if (buffer_size > 0) {
+      cleanup();
+      createBuffers();
     }
   }
 
@@ -74,12 +88,42 @@ public:
       return available_buffers.size();
   }
 
+  /// Defines what happens when the writer finds all buffers filled: the
+  /// default OverflowBlock waits (lossless); the drop policies never block
+  void setOverflowPolicy(NBufferOverflowPolicy policy) {
+    overflow_policy = policy;
+  }
+
+  NBufferOverflowPolicy overflowPolicy() { return overflow_policy; }
+
+  /// Number of buffers which were discarded because of the overflow policy
+  uint32_t droppedBuffers() { return dropped_buffers; }
+
+  void resetDroppedBuffers() { dropped_buffers = 0; }
+
 protected:
   QueueRTOS<BaseBuffer<T>*> available_buffers{0,portMAX_DELAY,0};
   QueueRTOS<BaseBuffer<T>*> filled_buffers{0,portMAX_DELAY,0};
   size_t max_size;
   size_t read_max_wait, write_max_wait;
   int buffer_size = 0, buffer_count = 0;
+  NBufferOverflowPolicy overflow_policy = OverflowBlock;
+  std::atomic<uint32_t> dropped_buffers{0};
+  Allocator *p_allocator = nullptr;
+
+  /// Allocates the individual buffers (with the defined allocator)
+  void createBuffers() {
+    for (int j = 0; j < buffer_count; j++) {
+      SingleBuffer<T> *tmp = new SingleBuffer<T>();
+      if (tmp != nullptr) {
+        if (p_allocator != nullptr) tmp->setAllocator(*p_allocator);
+        tmp->resize(buffer_size);
+        available_buffers.enqueue(tmp);
+      } else {
+        LOGE("Not Enough Memory for buffer %d", j);
+      }
+    }
+  }
 
   /// Removes all allocated buffers
   void cleanup(){
@@ -95,8 +139,27 @@ protected:
 
   BaseBuffer<T> *getNextAvailableBuffer() {
     TRACED();
-    BaseBuffer<T>* result;
-    return available_buffers.dequeue(result) ? result : nullptr;
+    BaseBuffer<T>* result = nullptr;
+    switch (overflow_policy) {
+      case OverflowDropOldest:
+        // never block: when nothing is available we reuse the oldest
+        // filled buffer so that the latency stays bounded
+        if (available_buffers.dequeue(result, 0)) return result;
+        if (filled_buffers.dequeue(result, 0)) {
+          dropped_buffers++;
+          result->reset();
+          return result;
+        }
+        return nullptr;
+      case OverflowDropNewest:
+        // never block: the caller just fails to write
+        if (available_buffers.dequeue(result, 0)) return result;
+        dropped_buffers++;
+        return nullptr;
+      case OverflowBlock:
+      default:
+        return available_buffers.dequeue(result) ? result : nullptr;
+    }
   }
 
   bool addAvailableBuffer(BaseBuffer<T> *buffer) {
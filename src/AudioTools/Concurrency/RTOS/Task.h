@@ -79,6 +79,42 @@ class Task {
     return ref;
   }
 
+  /// Defines the real time budget of the loop: the expected period in
+  /// microseconds and the maximum duty in percent. When defined, each
+  /// loop execution is measured and overruns are counted
+  void setBudget(uint32_t periodUs, int maxDutyPercent = 100) {
+    budget_period_us = periodUs;
+    budget_max_duty = maxDutyPercent;
+    resetBudgetStats();
+  }
+
+  /// Defines the callback which is raised when a loop execution exceeds
+  /// the budget
+  void setBudgetCallback(std::function<void(Task &)> cb) {
+    budget_callback = cb;
+  }
+
+  /// Number of loop executions which exceeded the budget
+  uint32_t overrunCount() { return overrun_count; }
+
+  /// Longest observed loop execution in microseconds
+  uint32_t maxExecutionTimeUs() { return max_exec_us; }
+
+  /// Average used part of the budget in percent (e.g. 95 means the task
+  /// is close to missing its deadlines)
+  int dutyPercent() {
+    if (loop_count == 0 || budget_period_us == 0) return 0;
+    return (int)(exec_acc_us * 100 / ((uint64_t)loop_count * budget_period_us));
+  }
+
+  /// Restarts the budget accounting
+  void resetBudgetStats() {
+    overrun_count = 0;
+    max_exec_us = 0;
+    exec_acc_us = 0;
+    loop_count = 0;
+  }
+
 #ifdef ESP32
   int getCoreID() {
     return xPortGetCoreID();
@@ -88,14 +124,42 @@ class Task {
  protected:
   TaskHandle_t xHandle = nullptr;
   std::function<void()> loop_code = nop;
+  std::function<void(Task &)> budget_callback = nullptr;
   void *ref;
+  uint32_t budget_period_us = 0;
+  int budget_max_duty = 100;
+  uint32_t overrun_count = 0;
+  uint32_t max_exec_us = 0;
+  uint64_t exec_acc_us = 0;
+  uint32_t loop_count = 0;
 
   static void nop() { delay(100); }
 
   static void task_loop(void* arg) {
     Task* self = (Task*)arg;
     while (true) {
-      self->loop_code();
+      if (self->budget_period_us == 0) {
+        self->loop_code();
+      } else {
+        self->measuredLoopStep();
+      }
+    }
+  }
+
+  /// Executes one loop step and updates the budget accounting
+  void measuredLoopStep() {
+    uint32_t start = micros();
+    loop_code();
+    uint32_t duration = micros() - start;
+    if (duration > max_exec_us) max_exec_us = duration;
+    exec_acc_us += duration;
+    loop_count++;
+    uint32_t budget = budget_period_us * budget_max_duty / 100;
+    if (duration > budget) {
+      overrun_count++;
+      LOGW("budget overrun: %u us > %u us", (unsigned)duration,
+           (unsigned)budget);
+      if (budget_callback) budget_callback(*this);
     }
   }
 };
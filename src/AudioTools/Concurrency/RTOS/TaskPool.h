@@ -0,0 +1,118 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+
+#include "AudioTools/Concurrency/QueueLockFree.h"
+#include "AudioTools/Concurrency/RTOS/Task.h"
+
+namespace audio_tools {
+
+/**
+ * @brief Fixed size worker pool for data parallel block DSP: the jobs are
+ * kept in a shared lock free queue from which every worker (and the
+ * submitting task itself) pulls the next pending block, so an idle core
+ * automatically steals the remaining work. Use parallelForBlocks() to
+ * split independent blocks (e.g. the left and right channel of a stereo
+ * convolution) across the cores: the call executes blocks on the calling
+ * task as well and returns when all blocks are done.
+ * @ingroup concurrency
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ */
+class TaskPool {
+ public:
+  /// @param workerCount number of worker tasks (in addition to the caller)
+  TaskPool(int workerCount = 1, int stackSize = 4096, int priority = 1,
+           int queueSize = 64) {
+    worker_count = workerCount;
+    stack_size = stackSize;
+    this->priority = priority;
+    jobs.resize(queueSize);
+  }
+
+  ~TaskPool() { end(); }
+
+  /// Creates and starts the worker tasks
+  bool begin() {
+    TRACED();
+    if (!workers.empty()) return true;
+    char name[20];
+    for (int j = 0; j < worker_count; j++) {
+      snprintf(name, sizeof(name), "pool-%d", j);
+      Task *worker = new Task();
+      if (!worker->create(name, stack_size, priority)) {
+        LOGE("could not create %s", name);
+        delete worker;
+        return false;
+      }
+      worker->begin([this]() { workerStep(); });
+      workers.push_back(worker);
+    }
+    return true;
+  }
+
+  /// Stops and deletes the worker tasks
+  void end() {
+    for (Task *worker : workers) {
+      worker->end();
+      delete worker;
+    }
+    workers.clear();
+  }
+
+  /// Schedules a single job: returns false when the queue is full
+  bool submit(std::function<void()> job) { return jobs.enqueue(job); }
+
+  /// Executes one pending job on the calling task: returns false when
+  /// there was nothing to do
+  bool runPending() {
+    std::function<void()> job;
+    if (!jobs.dequeue(job)) return false;
+    job();
+    return true;
+  }
+
+  /// Executes fn for each block index in [0, blockCount) distributed
+  /// across the workers: the calling task processes blocks as well and
+  /// the method returns when all blocks have been completed
+  void parallelForBlocks(int blockCount,
+                         std::function<void(int block)> fn) {
+    if (blockCount <= 0) return;
+    // w/o workers we just process sequentially
+    if (workers.empty()) {
+      for (int j = 0; j < blockCount; j++) fn(j);
+      return;
+    }
+    std::atomic<int> remaining{blockCount};
+    for (int j = 0; j < blockCount; j++) {
+      auto job = [j, &fn, &remaining]() {
+        fn(j);
+        remaining.fetch_sub(1, std::memory_order_release);
+      };
+      // when the queue is full the caller processes the block itself
+      if (!jobs.enqueue(job)) job();
+    }
+    // help with the pending blocks until everything is done
+    while (remaining.load(std::memory_order_acquire) > 0) {
+      if (!runPending()) delay(1);
+    }
+  }
+
+  /// Number of worker tasks
+  int workerCount() { return workers.size(); }
+
+ protected:
+  Vector<Task *> workers;
+  QueueLockFree<std::function<void()>> jobs{0};
+  int worker_count = 1;
+  int stack_size = 4096;
+  int priority = 1;
+
+  /// Loop body of a worker task
+  void workerStep() {
+    if (!runPending()) delay(1);
+  }
+};
+
+}  // namespace audio_tools
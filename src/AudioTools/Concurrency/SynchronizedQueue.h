@@ -1,5 +1,9 @@
 #pragma once
+#include <type_traits>
+
 #include "AudioTools/CoreAudio/AudioBasic/Collections/List.h"
+#include "AudioTools/Concurrency/Mutex.h"
+#include "AudioTools/Concurrency/QueueLockFree.h"
 
 namespace audio_tools {
 
@@ -56,4 +60,77 @@ class SynchronizedQueue {
   TMutex mutex;
 };
 
+/**
+ * @brief QueueLockFree extended with a peek: the peek is only reliable
+ * when there is a single consumer
+ * @ingroup collections
+ * @tparam T
+ */
+template <class T>
+class QueueLockFreePeek : public QueueLockFree<T> {
+ public:
+  using QueueLockFree<T>::QueueLockFree;
+
+  bool peek(T& result) {
+    size_t head = this->head_pos.load(std::memory_order_acquire);
+    typename QueueLockFree<T>::Node* node =
+        &this->p_node[head & this->capacity_mask];
+    if (node->head.load(std::memory_order_acquire) != head) return false;
+    result = node->data;
+    return true;
+  }
+};
+
+/**
+ * @brief Queue with the SynchronizedQueue API which uses atomic CAS
+ * instead of a mutex when T is pointer sized and trivially copyable: this
+ * is much cheaper when e.g. buffer pointers are passed between two tasks
+ * thousands of times per second. The queue is bounded by the indicated
+ * capacity. For larger or non trivial types it transparently falls back
+ * to the mutex protected SynchronizedQueue.
+ * @ingroup collections
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ * @tparam T
+ * @tparam TMutex only used by the mutex based fallback
+ */
+template <class T, class TMutex = MutexBase,
+          bool TLockFree = (sizeof(T) <= sizeof(void*) &&
+                            std::is_trivially_copyable<T>::value)>
+class PtrQueue {
+ public:
+  PtrQueue(size_t capacity = 64) : queue(capacity) {}
+
+  bool enqueue(T& data) { return queue.enqueue(data); }
+
+  /// Only reliable with a single consumer
+  bool peek(T& data) { return queue.peek(data); }
+
+  bool dequeue(T& data) { return queue.dequeue(data); }
+
+  size_t size() { return queue.size(); }
+
+  bool clear() {
+    queue.clear();
+    return true;
+  }
+
+  bool empty() { return queue.empty(); }
+
+  void setAllocator(Allocator& allocator) { queue.setAllocator(allocator); }
+
+ protected:
+  QueueLockFreePeek<T> queue;
+};
+
+/**
+ * @brief Mutex based fallback of PtrQueue for types which can not be
+ * handled with an atomic CAS
+ */
+template <class T, class TMutex>
+class PtrQueue<T, TMutex, false> : public SynchronizedQueue<T, TMutex> {
+ public:
+  PtrQueue(size_t capacity = 64) {}
+};
+
 }  // namespace audio_tools
\ No newline at end of file
@@ -10,16 +10,24 @@
 #include "AudioTools/CoreAudio/VolumeStream.h"
 #include "AudioTools/CoreAudio/AudioIO.h"
 #include "AudioTools/CoreAudio/ResampleStream.h"
+#include "AudioTools/CoreAudio/TimeStretchStream.h"
 #include "AudioTools/CoreAudio/StreamCopy.h"
 #include "AudioTools/CoreAudio/MusicalNotes.h"
 #include "AudioTools/CoreAudio/Fade.h"
 #include "AudioTools/CoreAudio/Pipeline.h"
+#include "AudioTools/CoreAudio/StaticPipeline.h"
+#include "AudioTools/CoreAudio/LatencyMeasurement.h"
 #include "AudioTools/CoreAudio/AudioPlayer.h"
 #include "AudioTools/CoreAudio/AudioTimer.h"
 #include "AudioTools/CoreAudio/AudioFilter.h"
 #include "AudioTools/CoreAudio/I2SStream.h"
 #include "AudioTools/CoreAudio/AudioPWM.h"
 #include "AudioTools/CoreAudio/AnalogAudioStream.h"
-#include "AudioTools/CoreAudio/AudioEffects.h"
+#if AUDIO_INCLUDE_EFFECTS
+#  include "AudioTools/CoreAudio/AudioEffects.h"
+#else
+// the tone generators are part of every profile
+#  include "AudioTools/CoreAudio/AudioEffects/SoundGenerator.h"
+#endif
 #include "AudioTools/CoreAudio/AudioMetaData.h"
 #include "AudioTools/CoreAudio/AudioHttp.h"
@@ -10,6 +10,11 @@
 #define DEBOUNCE_DELAY 500
 #endif
 
+/// Size of the pin change event queue (power of 2)
+#ifndef AUDIO_ACTIONS_QUEUE_SIZE
+#define AUDIO_ACTIONS_QUEUE_SIZE 16
+#endif
+
 #if defined(IS_MIN_DESKTOP)
 extern "C" void pinMode(int, int);
 extern "C" int digitalRead(int);
@@ -46,6 +51,8 @@ public:
     ActiveLogic activeLogic = ActiveHigh;
     bool lastState = true;
     bool enabled = true;
+    /// last pin state seen by the interrupt capture
+    volatile bool capturedState = false;
 
     /// determines the value for the action
     int debounceDelayValue = DEBOUNCE_DELAY;
@@ -79,45 +86,59 @@ public:
 
     virtual void process() {
       if (this->enabled) {
-        bool value = readValue();
-        if (this->actionOn != nullptr && this->actionOff != nullptr) {
-          // we have on and off action defined
-          if (value != this->lastState) {
-            //LOGI("processActions: case with on and off");
-            // execute action -> reports active instead of pin state
-            if ((value && this->activeLogic == ActiveHigh) ||
-                (!value && this->activeLogic == ActiveLow)) {
-              this->actionOn(true, this->pin, this->ref);
-            } else {
-              this->actionOff(false, this->pin, this->ref);
-            }
-            this->lastState = value;
-          }
-        } else if (this->activeLogic == ActiveChange) {
-          bool active = value;
-          // reports pin state
-          if (value != this->lastState && millis() > this->debounceTimeout) {
-            //LOGI("processActions: ActiveChange");
-            //  execute action
-            this->actionOn(active, this->pin, this->ref);
-            this->lastState = value;
-            this->debounceTimeout = millis() + debounceDelayValue;
-          }
-        } else {
-          bool active = (this->activeLogic == ActiveLow) ? !value : value;
-          if (active &&
-              (active != this->lastState || millis() > this->debounceTimeout)) {
-            // LOGI("processActions: %d Active %d - %d", this->pin, value,
-            //  execute action
-            this->actionOn(active, this->pin, this->ref);
-            this->lastState = active;
-            this->debounceTimeout = millis() + debounceDelayValue;
+        processValue(readValue(), millis());
+      }
+    }
+
+    /// Applies the action logic to a pin value captured at the indicated
+    /// time: the debounce is evaluated against the capture timestamp, so
+    /// late processing does not change the result
+    virtual void processValue(bool value, unsigned long time_ms) {
+      if (!this->enabled) return;
+      if (this->actionOn != nullptr && this->actionOff != nullptr) {
+        // we have on and off action defined
+        if (value != this->lastState) {
+          //LOGI("processActions: case with on and off");
+          // execute action -> reports active instead of pin state
+          if ((value && this->activeLogic == ActiveHigh) ||
+              (!value && this->activeLogic == ActiveLow)) {
+            this->actionOn(true, this->pin, this->ref);
+          } else {
+            this->actionOff(false, this->pin, this->ref);
           }
+          this->lastState = value;
+        }
+      } else if (this->activeLogic == ActiveChange) {
+        bool active = value;
+        // reports pin state
+        if (value != this->lastState && time_ms > this->debounceTimeout) {
+          //LOGI("processActions: ActiveChange");
+          //  execute action
+          this->actionOn(active, this->pin, this->ref);
+          this->lastState = value;
+          this->debounceTimeout = time_ms + debounceDelayValue;
+        }
+      } else {
+        bool active = (this->activeLogic == ActiveLow) ? !value : value;
+        if (active &&
+            (active != this->lastState || time_ms > this->debounceTimeout)) {
+          // LOGI("processActions: %d Active %d - %d", this->pin, value,
+          //  execute action
+          this->actionOn(active, this->pin, this->ref);
+          this->lastState = active;
+          this->debounceTimeout = time_ms + debounceDelayValue;
         }
       }
     }
   };
 
+  /// Timestamped pin change captured by the interrupt
+  struct PinEvent {
+    int16_t pin = -1;
+    bool value = false;
+    uint32_t time_ms = 0;
+  };
+
   /// Default constructor
   AudioActions(bool useInterrupt = false) {
     selfAudioActions = this;
@@ -181,6 +202,11 @@ public:
     static int pos = 0;
     if (actions.empty())
       return;
+    // in interrupt mode we only drain the event queue: no polling cost
+    if (use_pin_interrupt) {
+      processEvents();
+      return;
+    }
     // execute action
     actions[pos]->process();
     pos++;
@@ -189,6 +215,41 @@ public:
     }
   }
 
+  /// Called by the pin change interrupt: captures the changed pin states
+  /// with a timestamp into the event queue - the callbacks are NOT executed
+  /// in the interrupt context
+  void captureEvents() {
+    uint32_t now = millis();
+    for (Action *action : actions) {
+      if (!action->enabled || action->activeLogic == ActiveTouch) continue;
+      bool value = digitalRead(action->pin);
+      if (value != action->capturedState) {
+        action->capturedState = value;
+        // drop the oldest event when the queue is full
+        if ((uint8_t)(event_write - event_read) >= AUDIO_ACTIONS_QUEUE_SIZE) {
+          event_read++;
+        }
+        PinEvent &evt = event_queue[event_write % AUDIO_ACTIONS_QUEUE_SIZE];
+        evt.pin = action->pin;
+        evt.value = value;
+        evt.time_ms = now;
+        event_write++;
+      }
+    }
+  }
+
+  /// Dispatches the queued pin change events: the debounce is evaluated
+  /// against the capture timestamps, so fast presses are not missed even
+  /// when the processing happens late
+  void processEvents() {
+    while (event_read != event_write) {
+      PinEvent evt = event_queue[event_read % AUDIO_ACTIONS_QUEUE_SIZE];
+      event_read++;
+      Action *action = findAction(evt.pin);
+      if (action != nullptr) action->processValue(evt.value, evt.time_ms);
+    }
+  }
+
   /// Execute all actions
   void processAllActions() {
     for (Action *action : actions) {
@@ -240,6 +301,9 @@ protected:
   bool use_pin_interrupt = false;
   bool use_pin_mode = true;
   Vector<Action*> actions{0};
+  PinEvent event_queue[AUDIO_ACTIONS_QUEUE_SIZE];
+  volatile uint8_t event_write = 0;
+  volatile uint8_t event_read = 0;
 
   void insertAction(Action& action){
     int idx = findActionIdx(action.id());
@@ -253,7 +317,9 @@ protected:
     }
   }
 
-  static void audioActionsISR() { selfAudioActions->processAllActions(); }
+  // the interrupt only captures the events: the callbacks run later via
+  // processActions()/processEvents() outside of the interrupt context
+  static void audioActionsISR() { selfAudioActions->captureEvents(); }
 
   void setupPin(int pin, ActiveLogic logic) {
     // in the audio-driver library the pins are already set up
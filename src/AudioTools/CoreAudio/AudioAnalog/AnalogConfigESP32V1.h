@@ -118,6 +118,13 @@ class AnalogConfigESP32V1 : public AudioInfo {
 
   // ADC config parameters
   bool adc_calibration_active = false;
+  /// Precompute the raw -> millivolt calibration as lookup table at
+  /// begin(): one table access per sample instead of the per sample
+  /// adc_cali_raw_to_voltage call (costs 2 bytes per raw value in RAM)
+  bool adc_use_calibration_lut = false;
+  /// Average this number of raw samples (per channel) into one output
+  /// sample with running block sums (default 1 = off)
+  int adc_average_samples = 1;
   bool is_auto_center_read = false;
   adc_digi_convert_mode_t adc_conversion_mode = ADC_CONV_MODE;
   adc_digi_output_format_t adc_output_type = ADC_OUTPUT_TYPE;
@@ -109,6 +109,7 @@ protected:
 
     adc_continuous_handle_t adc_handle = nullptr;
     adc_cali_handle_t adc_cali_handle = nullptr;
+    Vector<int16_t> cali_lut{0};
     AnalogConfigESP32V1 cfg;
     bool active = false;
     bool active_tx = false;
@@ -159,6 +160,16 @@ protected:
             for(int ch=0;ch < channels;ch++){
                 sampleIndex[ch] = 0;
             }
+            // the averaging sums survive the calls, so no block boundary
+            // artifacts
+            if ((int)avg_sum.size() != channels) {
+                avg_sum.resize(channels);
+                avg_count.resize(channels);
+                for (int ch = 0; ch < channels; ch++) {
+                    avg_sum[ch] = 0;
+                    avg_count[ch] = 0;
+                }
+            }
             uint16_t *result16 = (uint16_t *)dest; // pointer to the destination buffer
             int samples_requested = size_bytes / sizeof(int16_t);
             int samples_requested_per_channel = samples_requested / channels;
@@ -185,6 +196,15 @@ protected:
 
                         // provide data to dest
                         if (channel >=0 && channel < channels){
+                            // optional averaging with running block sums
+                            int avg = self->cfg.adc_average_samples;
+                            if (avg > 1) {
+                                avg_sum[channel] += sample_value;
+                                if (++avg_count[channel] < avg) continue;
+                                sample_value = avg_sum[channel] / avg;
+                                avg_sum[channel] = 0;
+                                avg_count[channel] = 0;
+                            }
                             int idx = channel + (sampleIndex[channel] * channels);
                             LOGI("idx for %d: %d", channel, idx);
                             if(idx < samples_requested){
@@ -230,6 +250,8 @@ protected:
         AnalogDriverESP32V1 *self = nullptr;
         Vector<uint8_t> result_data{0};
         Vector<int> sampleIndex{0};
+        Vector<int32_t> avg_sum{0};
+        Vector<int> avg_count{0};
 
         int getChannelIdx(ADC_CHANNEL_TYPE chan_num){
             for (int j = 0; j < self->cfg.channels; ++j) {
@@ -241,6 +263,10 @@ protected:
         }
 
         int16_t getCalibratedValue(ADC_DATA_TYPE sample_value){
+            // fast path: precomputed lookup table
+            if (self->cali_lut.size() > 0 && sample_value < self->cali_lut.size()) {
+                return self->cali_lut[sample_value];
+            }
             int data_milliVolts = 0;
             int16_t result = 0;
             auto err = adc_cali_raw_to_voltage(self->adc_cali_handle, sample_value, &data_milliVolts);
@@ -478,6 +504,7 @@ protected:
             adc_cali_delete_scheme_line_fitting(adc_cali_handle);
             #endif
         }
+        cali_lut.resize(0);
 
 #ifdef ARDUINO
         // Set all used pins/channels to INIT state
@@ -606,6 +633,21 @@ protected:
                     cfg.adc_unit, cfg.adc_attenuation, cfg.adc_bit_width);
             }
         }
+
+        // Precompute the raw -> millivolt lookup once from the eFuse
+        // curve: replaces the per sample adc_cali_raw_to_voltage call
+        if (cfg.adc_use_calibration_lut && adc_cali_handle != NULL) {
+            int entries = 1 << cfg.adc_bit_width;
+            cali_lut.resize(entries);
+            for (int raw = 0; raw < entries; raw++) {
+                int data_milliVolts = 0;
+                if (adc_cali_raw_to_voltage(adc_cali_handle, raw, &data_milliVolts) != ESP_OK) {
+                    data_milliVolts = 0;
+                }
+                cali_lut[raw] = static_cast<int16_t>(data_milliVolts);
+            }
+            LOGI("calibration lut: %d entries", entries);
+        }
         return true;
     }
 
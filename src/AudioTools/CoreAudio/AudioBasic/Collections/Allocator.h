@@ -114,6 +114,114 @@ class AllocatorExt : public Allocator {
 };
 
 
+static AllocatorExt DefaultAllocator;
+
+/**
+ * @brief Arena (region) allocator: all allocations are carved sequentially
+ * from one preallocated slab, so a whole pipeline (buffers, decoder frame
+ * memory, copy temporaries) causes only a single heap allocation. free()
+ * is a no-op: the memory of all objects is released together in O(1) by
+ * calling reset() when the pipeline is torn down. This avoids heap
+ * fragmentation from repeated begin()/end() cycles.
+ * @ingroup memorymgmt
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ */
+class AllocatorArena : public Allocator {
+ public:
+  /// Allocates the slab of the indicated size with the provided allocator
+  AllocatorArena(size_t size, Allocator& allocator = DefaultAllocator) {
+    p_allocator = &allocator;
+    slab_size = size;
+    p_slab = (uint8_t*)allocator.allocate(size);
+  }
+
+  /// Uses the provided (e.g. static) memory as slab
+  AllocatorArena(void* slab, size_t size) {
+    p_slab = (uint8_t*)slab;
+    slab_size = size;
+  }
+
+  ~AllocatorArena() {
+    if (p_allocator != nullptr) p_allocator->free(p_slab);
+  }
+
+  /// Releases all allocations in O(1): the slab can be reused afterwards
+  void reset() { offset = 0; }
+
+  /// Bytes still available in the slab
+  size_t available() { return slab_size - offset; }
+
+  /// Largest offset ever used: helps to dimension the slab
+  size_t maxAllocated() { return max_offset; }
+
+  size_t size() { return slab_size; }
+
+  /// no-op: the memory is released via reset()
+  void free(void* memory) override {}
+
+ protected:
+  Allocator* p_allocator = nullptr;
+  uint8_t* p_slab = nullptr;
+  size_t slab_size = 0;
+  size_t offset = 0;
+  size_t max_offset = 0;
+
+  void* do_allocate(size_t size) override {
+    if (size == 0) size = 1;
+    // keep all results word/double aligned
+    size = (size + 7) & ~(size_t)7;
+    if (p_slab == nullptr || offset + size > slab_size) {
+      LOGE("arena exhausted: %zu of %zu bytes used", offset, slab_size);
+      return nullptr;
+    }
+    void* result = p_slab + offset;
+    offset += size;
+    if (offset > max_offset) max_offset = offset;
+    memset(result, 0, size);
+    return result;
+  }
+};
+
+/**
+ * @brief Decorator which guarantees that all allocations of the wrapped
+ * allocator are aligned to the indicated byte boundary (default 16 =
+ * cache line / SIMD friendly). The original address is stored just in
+ * front of the aligned region so that free() can undo the adjustment.
+ * @ingroup memorymgmt
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ */
+class AllocatorAligned : public Allocator {
+ public:
+  AllocatorAligned(int alignment = 16, Allocator& allocator = DefaultAllocator) {
+    this->alignment = alignment;
+    p_allocator = &allocator;
+  }
+
+  void free(void* memory) override {
+    if (memory == nullptr) return;
+    p_allocator->free(((void**)memory)[-1]);
+  }
+
+ protected:
+  Allocator* p_allocator = nullptr;
+  int alignment = 16;
+
+  void* do_allocate(size_t size) override {
+    if (size == 0) size = 1;
+    uint8_t* raw =
+        (uint8_t*)p_allocator->allocate(size + alignment + sizeof(void*));
+    if (raw == nullptr) return nullptr;
+    uintptr_t addr = (uintptr_t)(raw + sizeof(void*));
+    addr = (addr + alignment - 1) & ~((uintptr_t)alignment - 1);
+    ((void**)addr)[-1] = raw;
+    return (void*)addr;
+  }
+};
+
+static AllocatorAligned DefaultAllocatorAligned;
+
 #if (defined(ESP32)) && defined(ARDUINO)
 
 /**
@@ -170,6 +278,4 @@ class AllocatorPSRAM : public Allocator {
 
 #endif
 
-static AllocatorExt DefaultAllocator;
-
 }  // namespace audio_tools
\ No newline at end of file
@@ -3,6 +3,7 @@
 #  include "InitializerList.h" 
 #endif
 #include <stddef.h>
+#include <utility>
 #include "Allocator.h"
 
 namespace audio_tools {
@@ -144,7 +145,7 @@ class List {
             return true;
         }
 
-        bool push_back(T data){
+        bool push_back(const T& data){
             Node *node = createNode();
             if (node==nullptr) return false;
             node->data = data;
@@ -161,7 +162,24 @@ class List {
             return true;
         }
 
-        bool push_front(T data){
+        bool push_back(T&& data){
+            Node *node = createNode();
+            if (node==nullptr) return false;
+            node->data = std::move(data);
+
+            // update links
+            Node *old_last_prior = last.prior;
+            node->next = &last;
+            node->prior = old_last_prior;
+            old_last_prior->next = node;
+            last.prior = node;
+
+            record_count++;
+            validate();
+            return true;
+        }
+
+        bool push_front(const T& data){
             Node *node = createNode();
             if (node==nullptr) return false;
             node->data = data;
@@ -178,6 +196,23 @@ class List {
             return true;
         }
 
+        bool push_front(T&& data){
+            Node *node = createNode();
+            if (node==nullptr) return false;
+            node->data = std::move(data);
+
+            // update links
+            Node *old_begin_next = first.next;
+            node->prior = &first;
+            node->next = old_begin_next;
+            old_begin_next->prior = node;
+            first.next = node;
+
+            record_count++;
+            validate();
+            return true;
+        }
+
         bool insert(Iterator it, const T& data){
             Node *node = createNode();
             if (node==nullptr) return false;
@@ -4,6 +4,8 @@
 #endif
 #include <assert.h>
 
+#include <utility>
+
 #include "Allocator.h"
 
 namespace audio_tools {
@@ -180,34 +182,42 @@ class Vector {
   bool empty() { return size() == 0; }
 
   void push_back(T &&value) {
-    resize_internal(len + 1, true);
-    p_data[len] = value;
+    grow(len + 1);
+    p_data[len] = std::move(value);
     len++;
   }
 
   void push_back(T &value) {
-    resize_internal(len + 1, true);
+    grow(len + 1);
     p_data[len] = value;
     len++;
   }
 
+  /// Constructs the new last element in place
+  template <typename... Args>
+  T &emplace_back(Args &&...args) {
+    grow(len + 1);
+    p_data[len] = T(std::forward<Args>(args)...);
+    return p_data[len++];
+  }
+
   void push_front(T &value) {
-    resize_internal(len + 1, true);
-    // memmove(p_data,p_data+1,len*sizeof(T));
-    for (int j = len; j >= 0; j--) {
-      p_data[j + 1] = p_data[j];
+    grow(len + 1);
+    // shift values by 1 position
+    for (int j = len - 1; j >= 0; j--) {
+      p_data[j + 1] = std::move(p_data[j]);
     }
     p_data[0] = value;
     len++;
   }
 
   void push_front(T &&value) {
-    resize_internal(len + 1, true);
-    // memmove(p_data,p_data+1,len*sizeof(T));
-    for (int j = len; j >= 0; j--) {
-      p_data[j + 1] = p_data[j];
+    grow(len + 1);
+    // shift values by 1 position
+    for (int j = len - 1; j >= 0; j--) {
+      p_data[j + 1] = std::move(p_data[j]);
     }
-    p_data[0] = value;
+    p_data[0] = std::move(value);
     len++;
   }
 
@@ -277,6 +287,16 @@ class Vector {
 
   int capacity() { return this->bufferLen; }
 
+  /// Increases the capacity without changing the size
+  void reserve(int newCapacity) {
+    if (newCapacity > bufferLen) resize_internal(newCapacity, true);
+  }
+
+  /// Defines the growth factor which is applied when a push_back needs more
+  /// capacity (default 1.5): bigger values reduce the number of
+  /// reallocations, 1.0 grows entry by entry as before
+  void setGrowthFactor(float factor) { growth_factor = factor; }
+
   bool resize(int newSize) {
     int oldSize = this->len;
     resize_internal(newSize, true);
@@ -356,6 +376,15 @@ class Vector {
   int len = 0;
   T *p_data = nullptr;
   Allocator *p_allocator = &DefaultAllocator;
+  float growth_factor = 1.5f;
+
+  /// grows the capacity for an element wise insert using the growth factor
+  void grow(int minCapacity) {
+    if (minCapacity <= bufferLen) return;
+    int newCapacity = bufferLen * growth_factor;
+    if (newCapacity < minCapacity) newCapacity = minCapacity;
+    resize_internal(newCapacity, true);
+  }
 
   void resize_internal(int newSize, bool copy, bool shrink = false) {
     if (newSize <= 0) return;
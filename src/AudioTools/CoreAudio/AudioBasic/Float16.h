@@ -1,4 +1,5 @@
 #pragma once
+#include <cmath>
 
 namespace audio_tools {
 
@@ -41,7 +42,7 @@ class float16 {
 
   /// see
   /// https://stackoverflow.com/questions/1659440/32-bit-to-16-bit-floating-point-conversion
-  static uint32_t as_uint(const float x) { return *(uint *)&x; }
+  static uint32_t as_uint(const float x) { return *(uint32_t *)&x; }
   /// see
   /// https://stackoverflow.com/questions/1659440/32-bit-to-16-bit-floating-point-conversion
   static float as_float(const uint32_t x) { return *(float *)&x; }
@@ -109,7 +110,21 @@ inline float operator/(float one, float16 two) { return two / float(one); }
 
 namespace std {
 
-inline float floor(float16 arg) { return std::floor((float)arg); }
-inline float fabs(float16 arg) { return std::fabs((float)arg); }
+inline float floor(audio_tools::float16 arg) { return std::floor((float)arg); }
+inline float fabs(audio_tools::float16 arg) { return std::fabs((float)arg); }
 
 }  // namespace std
+
+#ifdef USE_TYPETRAITS
+
+namespace std {
+template <>
+class numeric_limits<audio_tools::float16> {
+ public:
+  static audio_tools::float16 lowest() { return audio_tools::float16(-1.0f); };
+  static audio_tools::float16 min() { return audio_tools::float16(-1.0f); };
+  static audio_tools::float16 max() { return audio_tools::float16(1.0f); };
+};
+}  // namespace std
+
+#endif
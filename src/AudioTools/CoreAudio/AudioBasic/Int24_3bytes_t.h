@@ -87,14 +87,15 @@ class int24_3bytes_t  {
 
   /// Standard Conversion to Int
   int toInt() const {
-    int newInt = ((((int32_t)0xFF & value[0]) << 16) | (((int32_t)0xFF & value[1]) << 8) | ((int32_t)0xFF & value[2]));
+    // little endian: value[0] is the least significant byte (see set())
+    int newInt = ((((int32_t)0xFF & value[2]) << 16) | (((int32_t)0xFF & value[1]) << 8) | ((int32_t)0xFF & value[0]));
     if ((newInt & 0x00800000) > 0) {
       newInt |= 0xFF000000;
     } else {
       newInt &= 0x00FFFFFF;
     }
     return newInt;
-  }  
+  }
 
   /// convert to float
   float toFloat() const { return int(); }
@@ -3,6 +3,12 @@
 #include "AudioTools/CoreAudio/AudioBasic/StrView.h"
 #include "AudioTools/CoreAudio/AudioBasic/Collections/Vector.h"
 
+/// Small string optimization: strings up to this length are stored inline
+/// without any heap allocation
+#ifndef STR_SSO_LEN
+#define STR_SSO_LEN 15
+#endif
+
 namespace audio_tools {
 
 /**
@@ -42,6 +48,11 @@ class Str : public StrView {
     }
   }
 
+  /// Str whose heap allocations are served by the provided allocator: use
+  /// an AllocatorArena for parser-lifetime strings (e.g. the urls of a
+  /// playlist), so that the parse causes no individual heap allocations
+  Str(Allocator &allocator) : StrView() { vector.setAllocator(allocator); }
+
   /// Convert StrView to Str
   Str(StrView &source) : StrView() { set(source); }
 
@@ -85,6 +96,13 @@ class Str : public StrView {
 
   void setCapacity(size_t newLen) { grow(newLen); }
 
+  /// Defines the allocator which serves the heap allocations: call before
+  /// the first assignment
+  void setAllocator(Allocator &allocator) { vector.setAllocator(allocator); }
+
+  /// Returns true when the content is stored in the inline (SSO) buffer
+  bool isInline() { return chars == sso; }
+
   // make sure that the max size is allocated
   void allocate(int len = -1) {
     int new_size = len < 0 ? maxlen : len;
@@ -171,18 +189,32 @@ class Str : public StrView {
   }
 
   void swap(Str &other){
+    bool this_inline = (chars == sso);
+    bool other_inline = (other.chars == other.sso);
+    bool this_null = (chars == nullptr);
+    bool other_null = (other.chars == nullptr);
+    char tmp_sso[STR_SSO_LEN + 1];
+    memcpy(tmp_sso, sso, STR_SSO_LEN + 1);
+    memcpy(sso, other.sso, STR_SSO_LEN + 1);
+    memcpy(other.sso, tmp_sso, STR_SSO_LEN + 1);
     int tmp_len = len;
     int tmp_maxlen = maxlen;
     len = other.len;
     maxlen = other.maxlen;
+    other.len = tmp_len;
+    other.maxlen = tmp_maxlen;
     vector.swap(other.vector);
-    chars = vector.data();
-    other.chars = other.vector.data();
+    // the chars pointer must follow the storage which now holds the data
+    if (other_inline) chars = sso;
+    else chars = other_null ? nullptr : vector.data();
+    if (this_inline) other.chars = other.sso;
+    else other.chars = this_null ? nullptr : other.vector.data();
   }
 
 
  protected:
   Vector<char> vector;
+  char sso[STR_SSO_LEN + 1] = {0};
 
   Str& move(Str &other) {
     swap(other);
@@ -196,12 +228,26 @@ class Str : public StrView {
     if (newMaxLen < 0) return false;
 
     if (chars == nullptr || newMaxLen > maxlen) {
-      LOGD("grow(%d)", newMaxLen);
-
       grown = true;
       // we use at minimum the defined maxlen
       int newSize = newMaxLen > maxlen ? newMaxLen : maxlen;
+
+      // small string optimization: short strings live in the inline buffer
+      // without any heap allocation
+      if (chars == nullptr && newSize <= STR_SSO_LEN) {
+        sso[0] = 0;
+        chars = sso;
+        maxlen = STR_SSO_LEN;
+        return grown;
+      }
+
+      LOGD("grow(%d)", newMaxLen);
+      bool was_inline = (chars == sso);
       vector.resize(newSize + 1);
+      if (was_inline) {
+        // move the inline content to the heap
+        memcpy(vector.data(), sso, len + 1);
+      }
       chars = &vector[0];
       maxlen = newSize;
     }
@@ -0,0 +1,86 @@
+#pragma once
+#include "AudioConfig.h"
+
+namespace audio_tools {
+
+// Reach the platform time functions from inside the clock class whose
+// method names shadow them (they are globals on Arduino and live in the
+// audio_tools namespace on the desktop)
+inline uint32_t audioClockMillis() { return millis(); }
+inline uint32_t audioClockMicros() { return micros(); }
+inline void audioClockDelay(uint32_t ms) { delay(ms); }
+inline void audioClockDelayUs(uint32_t us) { delayMicroseconds(us); }
+
+/**
+ * @brief Injectable clock abstraction: the timing sensitive classes
+ * (Throttle, MeasuringStream, UDPJitterStream, AudioPlayer) read the time
+ * via a clock object instead of calling millis()/micros() directly. The
+ * default implementation just forwards to the wall clock, so nothing
+ * changes for normal use - but tests can inject a SimulatedClock to drive
+ * the logic with virtual time and reproduce timing bugs deterministically.
+ * @ingroup tools
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ */
+class AudioClockBase {
+ public:
+  virtual ~AudioClockBase() = default;
+
+  /// Milliseconds since the start
+  virtual uint32_t millis() { return audioClockMillis(); }
+
+  /// Microseconds since the start
+  virtual uint32_t micros() { return audioClockMicros(); }
+
+  /// Sleeps for the indicated milliseconds
+  virtual void delay(uint32_t ms) { audioClockDelay(ms); }
+
+  /// Sleeps for the indicated microseconds
+  virtual void delayMicroseconds(uint32_t us) { audioClockDelayUs(us); }
+};
+
+/// Provides the shared default (wall clock) instance
+inline AudioClockBase &defaultClock() {
+  static AudioClockBase wall_clock;
+  return wall_clock;
+}
+
+/**
+ * @brief Deterministic clock for offline tests: time only moves when it is
+ * advanced explicitly or when a component sleeps via delay(), which
+ * advances the virtual time instantly instead of blocking. This makes
+ * timing sensitive logic (throttling, jitter buffer adaptation, player
+ * timeouts) testable much faster than real time and perfectly
+ * reproducible.
+ * @ingroup tools
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ */
+class SimulatedClock : public AudioClockBase {
+ public:
+  SimulatedClock(uint32_t startUs = 0) { time_us = startUs; }
+
+  uint32_t millis() override { return time_us / 1000; }
+
+  uint32_t micros() override { return time_us; }
+
+  /// Advances the virtual time instead of sleeping
+  void delay(uint32_t ms) override { time_us += ms * 1000; }
+
+  /// Advances the virtual time instead of sleeping
+  void delayMicroseconds(uint32_t us) override { time_us += us; }
+
+  /// Advances the virtual time by the indicated microseconds
+  void advanceUs(uint32_t us) { time_us += us; }
+
+  /// Advances the virtual time by the indicated milliseconds
+  void advanceMs(uint32_t ms) { time_us += ms * 1000; }
+
+  /// Resets the virtual time
+  void setTimeUs(uint32_t us) { time_us = us; }
+
+ protected:
+  uint32_t time_us = 0;
+};
+
+}  // namespace audio_tools
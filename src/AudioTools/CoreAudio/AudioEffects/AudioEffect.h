@@ -26,6 +26,14 @@ public:
   /// calculates the effect output from the input
   virtual effect_t process(effect_t in) = 0;
 
+  /// calculates the effect on a whole block of samples in place: subclasses
+  /// can overwrite this to provide a faster block implementation
+  virtual void processBlock(effect_t *data, size_t sampleCount) {
+    for (size_t j = 0; j < sampleCount; j++) {
+      data[j] = process(data[j]);
+    }
+  }
+
   /// sets the effect active/inactive
   virtual void setActive(bool value) { active_flag = value; }
 
@@ -298,12 +306,32 @@ public:
 
   float getSampleRate() { return sampleRate; }
 
+  /// Defines the delay tap in (fractional) samples without resizing the
+  /// delay line: use this to modulate the tap for chorus/flanger effects.
+  /// The fraction is linearly interpolated between the adjacent taps.
+  void setDelaySamples(float samples) {
+    if (samples < 0.0f) samples = 0.0f;
+    float max_samples = delay_mask > 0 ? delay_mask - 1 : 0;
+    if (samples > max_samples) samples = max_samples;
+    delay_len_samples = (size_t)samples;
+    delay_fraction = samples - delay_len_samples;
+  }
+
+  float getDelaySamples() { return delay_len_samples + delay_fraction; }
+
   effect_t process(effect_t input) {
     if (!active())
       return input;
 
-    // Read last audio sample in each delay line
-    int32_t delayed_value = buffer[delay_line_index];
+    // Read the delayed sample: the buffer is a power of two, so the index
+    // wrap is a mask instead of a division
+    size_t tap = (delay_line_index - delay_len_samples) & delay_mask;
+    int32_t delayed_value = buffer[tap];
+    if (delay_fraction > 0.0f) {
+      // fractional tap: linear interpolation with the adjacent older sample
+      int32_t older = buffer[(tap - 1) & delay_mask];
+      delayed_value += (int32_t)((older - delayed_value) * delay_fraction);
+    }
 
     // Mix the above with current audio and write the results back to output
     int32_t out = ((1.0f - depth) * input) + (depth * delayed_value);
@@ -312,9 +340,7 @@ public:
     buffer[delay_line_index] = clip(feedback * (delayed_value + input));
 
     // Finally, update the delay line index
-    if (delay_line_index++ >= delay_len_samples) {
-      delay_line_index = 0;
-    }
+    delay_line_index = (delay_line_index + 1) & delay_mask;
     return clip(out);
   }
 
@@ -323,17 +349,25 @@ public:
 protected:
   Vector<effect_t> buffer{0};
   float feedback = 0.0f, duration = 0.0f, sampleRate = 0.0f, depth = 0.0f;
+  float delay_fraction = 0.0f;
   size_t delay_len_samples = 0;
   size_t delay_line_index = 0;
+  size_t delay_mask = 0;
 
   void updateBufferSize() {
     if (sampleRate > 0 && duration > 0) {
       size_t newSampleCount = sampleRate * duration / 1000;
       if (newSampleCount != delay_len_samples) {
         delay_len_samples = newSampleCount;
-        buffer.resize(delay_len_samples);
-        memset(buffer.data(),0,delay_len_samples*sizeof(effect_t));
-        LOGD("sample_count: %u", (unsigned)delay_len_samples);
+        // the delay line is rounded up to a power of two, so that process()
+        // can wrap the index with a mask
+        size_t size = 1;
+        while (size < newSampleCount + 2) size <<= 1;
+        delay_mask = size - 1;
+        buffer.resize(size);
+        memset(buffer.data(),0,size*sizeof(effect_t));
+        LOGD("sample_count: %u buffer: %u", (unsigned)delay_len_samples,
+             (unsigned)size);
       }
     }
   }
@@ -397,6 +431,25 @@ public:
     return result;
   }
 
+  /// Applies the envelope as segment-constant linear ramps: the state
+  /// machine is only evaluated at the segment boundaries instead of once
+  /// per sample
+  void processBlock(effect_t *data, size_t sampleCount) override {
+    if (!active()) return;
+    size_t pos = 0;
+    while (pos < sampleCount) {
+      float slope = 0.0f;
+      int n = adsr->segment((int)(sampleCount - pos), slope);
+      float value = adsr->value();
+      for (int j = 0; j < n; j++) {
+        value += slope;
+        data[pos + j] = factor * value * data[pos + j];
+      }
+      adsr->advance(n, slope);
+      pos += n;
+    }
+  }
+
   bool isActive() { return adsr->isActive(); }
 
   ADSRGain *clone() { return new ADSRGain(*this); }
@@ -471,7 +524,7 @@ public:
         //Attack -> 30 ms -> 3000
         //Release -> 20 ms -> 2000
         //Hold -> 10ms -> 1000
-        sample_rate = sample_rate * attackMs / 1000;
+        sample_rate = sampleRate;
         attack_count = sample_rate * attackMs / 1000;
         release_count = sample_rate * releaseMs / 1000;
         hold_count = sample_rate * holdMs / 1000; 
@@ -516,11 +569,39 @@ public:
       recalculate();
     }
 
+    /// Defines the detector block size in samples: with a value > 1 the
+    /// envelope state machine runs only once per block on the block peak
+    /// and the gain is linearly interpolated over the block (default 1 =
+    /// per sample detection)
+    void setBlockSize(uint16_t size){
+        block_size = size == 0 ? 1 : size;
+        block_pos = 0;
+        block_peak = 0.0f;
+        gain_smooth = gain;
+        gain_step_block = 0.0f;
+    }
+
     /// Processes the sample
     effect_t process(effect_t input) {
         if (!active())
           return input;
-        return compress(input);
+        if (block_size <= 1)
+          return compress(input);
+
+        // block detection: only track the peak per sample, the state
+        // machine runs once per block and the gain ramps linearly
+        float in = input;
+        float level = fabs(in);
+        if (level > block_peak) block_peak = level;
+        float out = gain_smooth * in;
+        gain_smooth += gain_step_block;
+        if (++block_pos >= block_size) {
+            advance(block_peak, block_size);
+            gain_step_block = (gain - gain_smooth) / block_size;
+            block_peak = 0.0f;
+            block_pos = 0;
+        }
+        return out;
     }
 
     Compressor *clone() { return new Compressor(*this); }
@@ -532,12 +613,78 @@ protected:
     int32_t attack_count, release_count, hold_count,  timeout;
     float gainreduce, gain_step_attack, gain_step_release, gain, threshold;
     uint32_t sample_rate;
+    uint16_t block_size = 1;
+    uint16_t block_pos = 0;
+    float block_peak = 0.0f;
+    float gain_smooth = 1.0f;
+    float gain_step_block = 0.0f;
 
     void recalculate() {
         gain_step_attack = (1.0f - gainreduce) / attack_count;
         gain_step_release = (1.0f - gainreduce) / release_count;
     }
 
+    /// Advances the envelope state machine by n samples in one step: the
+    /// gain and timeout updates are scaled instead of iterated
+    void advance(float level, int n) {
+        if (level > threshold) {
+            if (gain >= gainreduce) {
+                if (state==S_NoOperation || state==S_Release) {
+                    state = S_Attack;
+                    timeout = attack_count;
+                }
+            }
+            if (state==S_GainReduction) timeout = hold_count;
+        }
+
+        if (level < threshold && gain <= 1.0f) {
+            if (timeout<=0 && state==S_GainReduction) {
+                state = S_Release;
+                timeout = release_count;
+            }
+        }
+
+        switch (state) {
+            case S_Attack:
+                if (timeout>0 && gain > gainreduce) {
+                    int steps = n < timeout ? n : timeout;
+                    gain -= gain_step_attack * steps;
+                    timeout -= steps;
+                    if (gain < gainreduce) gain = gainreduce;
+                } else {
+                    state = S_GainReduction;
+                    timeout = hold_count;
+                }
+                break;
+
+            case S_GainReduction:
+                if (timeout>0) timeout -= n;
+                else {
+                    state = S_Release;
+                    timeout = release_count;
+                }
+                break;
+
+            case S_Release:
+                if (timeout>0 && gain<1.0f) {
+                    int steps = n < timeout ? n : timeout;
+                    gain += gain_step_release * steps;
+                    timeout -= steps;
+                    if (gain > 1.0f) gain = 1.0f;
+                } else {
+                    state = S_NoOperation;
+                }
+                break;
+
+            case S_NoOperation:
+                if (gain < 1.0f) gain = 1.0f;
+                break;
+
+            default:
+                break;
+        }
+    }
+
     float compress(float inSampleF){
         if (fabs(inSampleF) > threshold) {
             if (gain >=  gainreduce) {
@@ -26,12 +26,14 @@ class AudioEffectCommon {
         /// Adds an effect object (by reference)
         void addEffect(AudioEffect &effect){
             TRACED();
-            effects.push_back(&effect);
+            addEffect(&effect);
         }
 
         /// Adds an effect using a pointer
         void addEffect(AudioEffect *effect){
             TRACED();
+            // avoid a reallocation per added effect
+            if (effects.capacity() == 0) effects.reserve(8);
             effects.push_back(effect);
             LOGI("addEffect -> Number of effects: %d", (int)size());
         }
@@ -64,11 +66,62 @@ class AudioEffectCommon {
             return effects[idx];
         }
 
+        /// Applies all active effects on a whole block of samples in place
+        void processBlock(effect_t *data, size_t sampleCount){
+            for (int j=0; j<(int)size(); j++){
+                AudioEffect *effect = effects[j];
+                // short-circuit inactive effects at chain level
+                if (!effect->active()) continue;
+                effect->processBlock(data, sampleCount);
+            }
+        }
+
     protected:
         Vector<AudioEffect*> effects;
 
 };
 
+/**
+ * @brief Compile time effects chain for statically known chains: e.g.
+ * EffectsChain<Distortion, Delay, Tremolo>. The effects are referenced by
+ * the constructor and processed in order without any virtual dispatch, so
+ * the calls can be inlined into the block loop. Inactive effects are
+ * skipped per block.
+ * @ingroup effects
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ */
+template <typename... Fx>
+class EffectsChain {
+    public:
+        effect_t process(effect_t in) { return in; }
+        void processBlock(effect_t *data, size_t sampleCount) {}
+};
+
+template <typename First, typename... Rest>
+class EffectsChain<First, Rest...> {
+    public:
+        EffectsChain(First &firstEffect, Rest &...restEffects)
+            : first(firstEffect), rest(restEffects...) {}
+
+        /// calculates the chain output for a single sample
+        effect_t process(effect_t in) {
+            return rest.process(first.process(in));
+        }
+
+        /// applies the chain on a whole block of samples in place
+        void processBlock(effect_t *data, size_t sampleCount) {
+            if (first.active()){
+                first.processBlock(data, sampleCount);
+            }
+            rest.processBlock(data, sampleCount);
+        }
+
+    protected:
+        First &first;
+        EffectsChain<Rest...> rest;
+};
+
 /**
  * @brief OBSOLETE AudioEffects: the template class describes the input audio to which the effects are applied: 
  * e.g. SineWaveGenerator, SquareWaveGenerator, GeneratorFromStream etc. 
@@ -160,6 +213,14 @@ class AudioEffects : public SoundGenerator<effect_t> {
             return sample;
         }
 
+        /// provides a block of samples: the effects are applied per block
+        size_t readSamples(effect_t *data, size_t sampleCount) override {
+            if (p_generator==nullptr) return 0;
+            size_t result = p_generator->readSamples(data, sampleCount);
+            effects.processBlock(data, result);
+            return result;
+        }
+
         /// deletes all defined effects
         void clear() {
             TRACED();
@@ -261,35 +322,33 @@ class AudioEffectStreamT : public ModifyingStream {
     */
     size_t readBytes(uint8_t *data, size_t len) override {
         if (!active || p_io==nullptr)return 0;
-        size_t result_size = 0;
 
         // read data from source
         size_t result = p_io->readBytes((uint8_t*)data, len);
         int frames = result / sizeof(T) / info.channels;
         T* samples = (T*) data;
 
-        for (int count=0;count<frames;count++){
-            // determine sample by combining all channels in frame
+        // combine the channels of each frame into the shared block
+        setupBlock(frames);
+        for (int j=0;j<frames;j++){
             T result_sample = 0;
             for (int ch=0;ch<info.channels;ch++){
-                T sample = *samples++;
-                //p_io->readBytes((uint8_t*)&sample, sizeof(T));
-                result_sample += sample / info.channels;
+                result_sample += samples[j*info.channels+ch] / info.channels;
             }
+            block[j] = result_sample;
+        }
 
-            // apply effects
-            for (int j=0; j<size(); j++){
-                result_sample = effects[j]->process(result_sample);
-            }
+        // apply all active effects on the whole block
+        effects.processBlock(block.data(), frames);
 
-            // write result multiplying channels 
-            T* p_buffer = ((T*)data)+(count*info.channels);
+        // expand the result to all channels
+        for (int j=0;j<frames;j++){
+            T result_sample = block[j];
             for (int ch=0;ch<info.channels;ch++){
-                p_buffer[ch] = result_sample;
-                result_size += sizeof(T);
+                samples[j*info.channels+ch] = result_sample;
             }
         }
-        return result_size;
+        return frames * info.channels * sizeof(T);
     }
 
     /**
@@ -301,34 +360,33 @@ class AudioEffectStreamT : public ModifyingStream {
         // length must be multple of channels
         assert(len % (sizeof(T)*info.channels)==0);
         int frames = len / sizeof(T) / info.channels;
-        size_t result_size = 0;
+        T* samples = (T*) data;
 
-        // process all samples
+        // combine the channels of each frame into the shared block
+        setupBlock(frames);
         for (int j=0;j<frames;j++){
-            // calculate sample for frame
-            T* p_buffer = ((T*)data) + (j*info.channels);
             T sample=0;
             for (int ch=0;ch<info.channels;ch++){
-                sample += p_buffer[ch] / info.channels;
-                result_size += sizeof(T);
+                sample += samples[j*info.channels+ch] / info.channels;
             }
+            block[j] = sample;
+        }
 
-            // apply effects
-            for (int j=0; j<size(); j++){
-                sample = effects[j]->process(sample);
-            }
+        // apply all active effects on the whole block
+        effects.processBlock(block.data(), frames);
 
-            // wite result channel times to output defined in constructor
+        // expand the result to all channels and write it with a single call
+        for (int j=0;j<frames;j++){
+            T sample = block[j];
             for (int ch=0;ch<info.channels;ch++){
-                if (p_io!=nullptr){
-                    p_io->write((uint8_t*)&sample, sizeof(T));
-
-                } else if (p_print!=nullptr){
-                    p_print->write((uint8_t*)&sample, sizeof(T));
-                }
+                out_block[j*info.channels+ch] = sample;
             }
         }
-        return result_size;
+        Print *out = p_io!=nullptr ? (Print*)p_io : p_print;
+        if (out!=nullptr){
+            out->write((uint8_t*)out_block.data(), frames*info.channels*sizeof(T));
+        }
+        return frames * info.channels * sizeof(T);
     }
 
     int available() override {
@@ -381,6 +439,16 @@ class AudioEffectStreamT : public ModifyingStream {
     bool active = false;
     Stream *p_io=nullptr;
     Print *p_print=nullptr;
+    Vector<effect_t> block{0};
+    Vector<T> out_block{0};
+
+    /// makes sure that the shared scratch block is big enough
+    void setupBlock(int frames){
+        if ((int)block.size() < frames){
+            block.resize(frames);
+            out_block.resize(frames*info.channels);
+        }
+    }
 };
 
 #if defined(USE_VARIANTS) && __cplusplus >= 201703L || defined(DOXYGEN)
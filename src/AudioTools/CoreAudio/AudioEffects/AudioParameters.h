@@ -111,6 +111,74 @@ class ADSR : public  AbstractParameter  {
             return state!=Idle;
         }
 
+        /// Provides the number of ticks until the current segment ends
+        /// (limited to maxSamples) and the constant slope of the segment:
+        /// used for block based envelope evaluation
+        int segment(int maxSamples, float &slope) {
+            int remaining = maxSamples;
+            switch (state) {
+                case Attack:
+                    slope = attack;
+                    if (attack > 0) remaining = (int)((target - act_value) / attack) + 1;
+                    break;
+                case Decay:
+                    if (act_value > sustain) {
+                        slope = -decay;
+                        if (decay > 0) remaining = (int)((act_value - sustain) / decay) + 1;
+                    } else {
+                        slope = decay; // attack target < sustainLevel level
+                        if (decay > 0) remaining = (int)((sustain - act_value) / decay) + 1;
+                    }
+                    break;
+                case Release:
+                    slope = -release;
+                    if (release > 0) remaining = (int)(act_value / release) + 1;
+                    break;
+                default:
+                    slope = 0.0f;
+                    break;
+            }
+            if (remaining > maxSamples) remaining = maxSamples;
+            if (remaining < 1) remaining = 1;
+            return remaining;
+        }
+
+        /// Advances the envelope by n ticks in one step: n must not exceed
+        /// the result of segment() with the matching slope
+        void advance(int n, float slope) {
+            act_value += slope * n;
+            switch (state) {
+                case Attack:
+                    if (act_value >= target) {
+                        act_value = target;
+                        target = sustain;
+                        state = Decay;
+                    }
+                    break;
+                case Decay:
+                    if (slope < 0.0f) {
+                        if (act_value <= sustain) {
+                            act_value = sustain;
+                            state = Sustain;
+                        }
+                    } else if (slope > 0.0f) {
+                        if (act_value >= sustain) {
+                            act_value = sustain;
+                            state = Sustain;
+                        }
+                    }
+                    break;
+                case Release:
+                    if (act_value <= 0.0f) {
+                        act_value = 0.0f;
+                        state = Idle;
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+
     protected:
         float attack,  decay,  sustain,  release;
         enum AdsrPhase {Idle, Attack, Decay, Sustain, Release};
@@ -381,6 +381,132 @@ protected:
   }
 };
 
+/**
+ * @brief Variable speed ring buffer tuned for block processing: the buffer
+ * size is rounded up to a power of 2 so that all wrap arounds are a bitwise
+ * and instead of a modulo, the read position is kept in 16.16 fixed point
+ * and the 0°/180° crossfade of VariableSpeedRingBuffer180 is combined with
+ * a fractional delay (linear interpolation) of both read taps. The
+ * readWrite() block kernel keeps the state in locals while processing a
+ * whole chunk.
+ * @ingroup buffers
+ * @tparam T
+ */
+template <typename T> class VariableSpeedRingBufferMasked : public BaseBuffer<T> {
+public:
+  VariableSpeedRingBufferMasked(int size = 0, float increment = 1.0) {
+    setIncrement(increment);
+    if (size > 0)
+      resize(size);
+  }
+
+  void setIncrement(float increment) {
+    pitch_shift = increment;
+    read_increment_fx = (uint32_t)(increment * 65536.0f);
+  }
+
+  void resize(int size) {
+    // round up to the next power of 2
+    buffer_size = 1;
+    while (buffer_size < size) {
+      buffer_size <<= 1;
+    }
+    mask = buffer_size - 1;
+    overlap = buffer_size / 10;
+    buffer.resize(buffer_size);
+    reset();
+  }
+
+  T read() {
+    T result = 0;
+    readWrite(nullptr, &result, 1);
+    return result;
+  }
+
+  T peek() { return buffer[(read_pos_fx >> 16) & mask]; }
+
+  bool write(T sample) {
+    if (buffer.size() == 0) {
+      LOGE("buffer has no memory");
+      return false;
+    }
+    buffer[write_pos] = sample;
+    write_pos = (write_pos + 1) & mask;
+    return true;
+  }
+
+  /// Block kernel: writes n samples and provides n pitch shifted samples;
+  /// in may be nullptr to only read
+  void readWrite(const T *in, T *out, int n) {
+    uint32_t pos = read_pos_fx;
+    uint32_t inc = read_increment_fx;
+    int wp = write_pos;
+    float fade = cross_fade;
+    for (int j = 0; j < n; j++) {
+      if (in != nullptr) {
+        buffer[wp] = in[j];
+        wp = (wp + 1) & mask;
+      }
+      int ri = (pos >> 16) & mask;
+      int ri180 = (ri + buffer_size / 2) & mask;
+      float frac = (float)(pos & 0xFFFF) / 65536.0f;
+
+      // fractional delay on both read taps
+      float sample0 = buffer[ri] + frac * ((float)buffer[(ri + 1) & mask] -
+                                           (float)buffer[ri]);
+      float sample180 = buffer[ri180] +
+                        frac * ((float)buffer[(ri180 + 1) & mask] -
+                                (float)buffer[ri180]);
+
+      // crossfade to the other tap when a read pointer approaches the
+      // write pointer
+      int dist = (wp - ri) & mask;
+      int dist180 = (wp - ri180) & mask;
+      if (dist == 0) {
+        fade = 0.0f;
+      } else if (dist <= overlap && pitch_shift != 1.0f) {
+        fade = (float)dist / (float)overlap;
+      }
+      if (dist180 == 0) {
+        fade = 1.0f;
+      } else if (dist180 <= overlap && pitch_shift != 1.0f) {
+        fade = 1.0f - (float)dist180 / (float)overlap;
+      }
+
+      out[j] = sample0 * fade + sample180 * (1.0f - fade);
+      pos += inc;
+    }
+    read_pos_fx = pos;
+    write_pos = wp;
+    cross_fade = fade;
+  }
+
+  /// Reset pointer positions and clear buffer
+  void reset() {
+    read_pos_fx = 0;
+    write_pos = 0;
+    cross_fade = 1.0f;
+    memset(buffer.data(), 0, sizeof(T) * buffer_size);
+  }
+
+  virtual bool isFull() { return false; }
+  virtual int available() { return buffer_size; }
+  virtual int availableForWrite() { return buffer_size; }
+  virtual T *address() { return nullptr; }
+  size_t size() { return buffer_size; }
+
+protected:
+  Vector<T> buffer{0};
+  uint32_t read_pos_fx = 0;
+  uint32_t read_increment_fx = 0;
+  float cross_fade = 1.0f;
+  float pitch_shift = 0.0f;
+  int write_pos = 0;
+  int buffer_size = 0;
+  int mask = 0;
+  int overlap = 0;
+};
+
 /**
  * @brief Pitch Shift: Shifts the frequency up or down w/o impacting the length!
  * We reduce the channels to 1 to calculate the pitch shift and provides the
@@ -409,6 +535,8 @@ public:
     buffer.resize(info.buffer_size);
     buffer.reset();
     buffer.setIncrement(info.pitch_shift);
+    mono_block.resize(chunk_size);
+    out_block.resize(chunk_size * info.channels);
     active = true;
     return active;
   }
@@ -418,43 +546,64 @@ public:
     if (!active)
       return 0;
 
-    size_t result = 0;
     int channels = cfg.channels;
     T *p_in = (T *)data;
-    int sample_count = len / sizeof(T);
-
-    for (int j = 0; j < sample_count; j += channels) {
-      float value = 0;
-      for (int ch = 0; ch < channels; ch++) {
-        value += p_in[j + ch];
+    int frame_count = len / (sizeof(T) * channels);
+
+    for (int start = 0; start < frame_count; start += chunk_size) {
+      int n = min(chunk_size, frame_count - start);
+      // mix the channels into a mono chunk
+      for (int j = 0; j < n; j++) {
+        const T *frame = p_in + (start + j) * channels;
+        float value = 0;
+        for (int ch = 0; ch < channels; ch++) {
+          value += frame[ch];
+        }
+        mono_block[j] = value / channels;
       }
-      // calculate avg sample value
-      value /= cfg.channels;
-
-      // output values
-      T out_value = pitchShift(value);
-      LOGD("PitchShiftOutput %f -> %d", value, (int) out_value);
-      T out_array[channels];
-      for (int ch = 0; ch < channels; ch++) {
-        out_array[ch] = out_value;
+      // pitch shift the whole chunk
+      processChunk(buffer, mono_block.data(), mono_block.data(), n, 0);
+      // provide the result on all channels with a single write
+      for (int j = 0; j < n; j++) {
+        T value = mono_block[j];
+        for (int ch = 0; ch < channels; ch++) {
+          out_block[j * channels + ch] = value;
+        }
       }
-      result += p_out->write((uint8_t *)out_array, sizeof(T) * channels);
+      p_out->write((uint8_t *)out_block.data(), n * channels * sizeof(T));
     }
-    return result;
+    return len;
   }
 
   void end() { active = false; }
 
 protected:
+  static const int chunk_size = 256;
   BufferT buffer;
   bool active;
   PitchShiftInfo cfg;
   Print *p_out = nullptr;
+  Vector<T> mono_block{0};
+  Vector<T> out_block{0};
+
+  /// uses the block kernel of the buffer if it provides one
+  template <class B>
+  auto processChunk(B &buf, const T *in, T *out, int n, int)
+      -> decltype(buf.readWrite(in, out, n)) {
+    buf.readWrite(in, out, n);
+  }
+
+  /// fallback: process the chunk sample by sample
+  template <class B>
+  void processChunk(B &buf, const T *in, T *out, int n, long) {
+    for (int j = 0; j < n; j++) {
+      out[j] = pitchShift(in[j]);
+    }
+  }
 
   // execute the pitch shift by writing one sample and returning the pitch
   // shifted result sample
   T pitchShift(T value) {
-    TRACED();
     if (!active)
       return 0;
     buffer.write(value);
@@ -58,6 +58,16 @@ public:
   /// Provides a single sample
   virtual T readSample() = 0;
 
+  /// Provides a batch of samples: the default implementation just calls
+  /// readSample() in a loop; subclasses can override this with a tight loop
+  /// to avoid the virtual call per sample
+  virtual size_t readSamples(T *data, size_t sampleCount) {
+    for (size_t j = 0; j < sampleCount; j++) {
+      data[j] = readSample();
+    }
+    return sampleCount;
+  }
+
   /// Provides the data as byte array with the requested number of channels
   virtual size_t readBytes(uint8_t *data, size_t len) {
     LOGD("readBytes: %d", (int)len);
@@ -105,11 +115,22 @@ protected:
   size_t readBytesFrames(uint8_t *buffer, size_t lengthBytes, int frames,
                          int channels) {
     T *result_buffer = (T *)buffer;
-    for (int j = 0; j < frames; j++) {
-      T sample = readSample();
-      for (int ch = 0; ch < channels; ch++) {
-        *result_buffer++ = sample;
+    if (channels == 1) {
+      // mono: fill the result buffer directly in one batch
+      return readSamples(result_buffer, frames) * sizeof(T);
+    }
+    // generate in batches and duplicate the samples over the channels
+    T tmp[64];
+    int open = frames;
+    while (open > 0) {
+      int n = min(open, 64);
+      readSamples(tmp, n);
+      for (int j = 0; j < n; j++) {
+        for (int ch = 0; ch < channels; ch++) {
+          *result_buffer++ = tmp[j];
+        }
       }
+      open -= n;
     }
     return frames * sizeof(T) * channels;
   }
@@ -206,6 +227,21 @@ public:
     return result;
   }
 
+  /// Provides a batch of samples in one tight loop
+  size_t readSamples(T *data, size_t sampleCount) override {
+    float cycles = m_cycles;
+    float delta = m_frequency * m_deltaTime;
+    for (size_t j = 0; j < sampleCount; j++) {
+      data[j] = m_amplitude * sinf(double_Pi * cycles + m_phase);
+      cycles += delta;
+      if (cycles > 1.0f) {
+        cycles -= 1.0f;
+      }
+    }
+    m_cycles = cycles;
+    return sampleCount;
+  }
+
   void setAmplitude(float amp) { m_amplitude = amp; }
 
 protected:
@@ -250,6 +286,23 @@ public:
     return result;
   }
 
+  /// Provides a batch of samples in one tight loop
+  size_t readSamples(T *data, size_t sampleCount) override {
+    float cycles = SineWaveGenerator<T>::m_cycles;
+    float delta =
+        SineWaveGenerator<T>::m_frequency * SineWaveGenerator<T>::m_deltaTime;
+    for (size_t j = 0; j < sampleCount; j++) {
+      data[j] = SineWaveGenerator<T>::m_amplitude *
+                sine(cycles + SineWaveGenerator<T>::m_phase);
+      cycles += delta;
+      if (cycles > 1.0f) {
+        cycles -= 1.0f;
+      }
+    }
+    SineWaveGenerator<T>::m_cycles = cycles;
+    return sampleCount;
+  }
+
 protected:
   /// sine approximation.
   inline float sine(float t) {
@@ -278,6 +331,16 @@ public:
                  FastSineGenerator<T>::m_amplitude);
   }
 
+  /// Provides a batch of samples in one tight loop
+  size_t readSamples(T *data, size_t sampleCount) override {
+    FastSineGenerator<T>::readSamples(data, sampleCount);
+    T amplitude = FastSineGenerator<T>::m_amplitude;
+    for (size_t j = 0; j < sampleCount; j++) {
+      data[j] = value(data[j], amplitude);
+    }
+    return sampleCount;
+  }
+
 protected:
   // returns amplitude for positive vales and -amplitude for negative values
   T value(T value, T amplitude) {
@@ -388,6 +451,135 @@ protected:
   unsigned int amplitude;
 };
 
+/**
+ * @brief Integer only pink noise (Voss-McCartney): per sample only one row
+ * is replaced by a fresh random value and a running sum is maintained, so
+ * there is no float operation, no rand() call and no summing loop. The
+ * random source is a word wide xorshift32. Intended for long running low
+ * clock scenarios where PinkNoiseGenerator is too expensive.
+ * @ingroup generator
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ * @tparam T
+ */
+template <class T> class FastPinkNoiseGenerator : public SoundGenerator<T> {
+public:
+  /// the amplitude defines the max value which is generated
+  FastPinkNoiseGenerator(T amplitude = 32767, uint32_t seed = 0x8a5cd789) {
+    amplitude_q = (int32_t)amplitude;
+    rng = seed == 0 ? 1 : seed;
+    running_sum = 0;
+    for (int j = 0; j < ROWS; j++) {
+      rows[j] = nextRandom();
+      running_sum += rows[j];
+    }
+  }
+
+  T readSample() override {
+    T result;
+    readSamples(&result, 1);
+    return result;
+  }
+
+  /// Provides a batch of samples in one tight integer loop
+  size_t readSamples(T *data, size_t sampleCount) override {
+    uint32_t r = rng;
+    uint32_t cnt = counter;
+    int32_t sum = running_sum;
+    for (size_t j = 0; j < sampleCount; j++) {
+      cnt++;
+      // index of the lowest set bit selects the row to update
+      uint32_t bits = cnt;
+      int idx = 0;
+      while ((bits & 1) == 0 && idx < ROWS - 1) {
+        bits >>= 1;
+        idx++;
+      }
+      // xorshift32: one word wide random value per sample
+      r ^= r << 13;
+      r ^= r >> 17;
+      r ^= r << 5;
+      int32_t value = (int32_t)r >> 16; // -32768..32767
+      sum += value - rows[idx];
+      rows[idx] = value;
+      // second xorshift draw for the per sample white component
+      r ^= r << 13;
+      r ^= r >> 17;
+      r ^= r << 5;
+      int32_t mix = (sum + ((int32_t)r >> 16)) / (ROWS + 1);
+      data[j] = (T)((mix * amplitude_q) >> 15);
+    }
+    rng = r;
+    counter = cnt;
+    running_sum = sum;
+    return sampleCount;
+  }
+
+protected:
+  static const int ROWS = 8;
+  int32_t rows[ROWS];
+  int32_t running_sum = 0;
+  int32_t amplitude_q = 32767;
+  uint32_t counter = 0;
+  uint32_t rng = 1;
+
+  inline int32_t nextRandom() {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return (int32_t)rng >> 16;
+  }
+};
+
+/**
+ * @brief Integer only brown (red) noise: a random walk driven by a
+ * xorshift32 source with a leaky integrator (shift based) that keeps the
+ * walk bounded - no floats and no divisions in the sample loop.
+ * @ingroup generator
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ * @tparam T
+ */
+template <class T> class BrownNoiseGenerator : public SoundGenerator<T> {
+public:
+  /// the amplitude defines the max value which is generated
+  BrownNoiseGenerator(T amplitude = 32767, uint32_t seed = 0x3c6ef372) {
+    amplitude_q = (int32_t)amplitude;
+    rng = seed == 0 ? 1 : seed;
+  }
+
+  T readSample() override {
+    T result;
+    readSamples(&result, 1);
+    return result;
+  }
+
+  /// Provides a batch of samples in one tight integer loop
+  size_t readSamples(T *data, size_t sampleCount) override {
+    uint32_t r = rng;
+    int32_t walk = acc;
+    for (size_t j = 0; j < sampleCount; j++) {
+      r ^= r << 13;
+      r ^= r >> 17;
+      r ^= r << 5;
+      walk += ((int32_t)r >> 16) >> 4; // random step -2048..2047
+      walk -= walk >> 8;               // leak: bounds the walk
+      int32_t value = walk >> 4;
+      if (value > 32767) value = 32767;
+      if (value < -32768) value = -32768;
+      data[j] = (T)((value * amplitude_q) >> 15);
+    }
+    rng = r;
+    acc = walk;
+    return sampleCount;
+  }
+
+protected:
+  int32_t acc = 0;
+  int32_t amplitude_q = 32767;
+  uint32_t rng = 1;
+};
+
 /**
  * @brief Provides a fixed value (e.g. 0) as sound data. This can be used e.g.
  * to test the output functionality which should optimally just output silence
@@ -773,6 +965,166 @@ protected:
   }
 };
 
+/**
+ * @brief Shared bank of Q15 wavetables (256 entries + 1 wrap around guard
+ * entry for interpolation). The tables are calculated on first use and
+ * shared by all WaveTableGenerator instances, so a multi voice setup pays
+ * for each table only once.
+ * @ingroup generator
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ */
+class WaveTables {
+public:
+  static const int size = 256;
+
+  /// Q15 sine table
+  static const int16_t *sine() {
+    static int16_t table[size + 1];
+    static bool is_setup = false;
+    if (!is_setup) {
+      for (int j = 0; j <= size; j++) {
+        table[j] = (int16_t)roundf(32767.0f * sinf(2.0f * PI * j / size));
+      }
+      is_setup = true;
+    }
+    return table;
+  }
+
+  /// Q15 sawtooth table (rising ramp)
+  static const int16_t *saw() {
+    static int16_t table[size + 1];
+    static bool is_setup = false;
+    if (!is_setup) {
+      for (int j = 0; j <= size; j++) {
+        table[j] = (int16_t)(-32767 + (int32_t)j * 65534 / size);
+      }
+      is_setup = true;
+    }
+    return table;
+  }
+
+  /// Q15 square table
+  static const int16_t *square() {
+    static int16_t table[size + 1];
+    static bool is_setup = false;
+    if (!is_setup) {
+      for (int j = 0; j <= size; j++) {
+        table[j] = j < size / 2 ? 32767 : -32767;
+      }
+      is_setup = true;
+    }
+    return table;
+  }
+};
+
+/**
+ * @brief Sound generator which indexes a shared Q15 wavetable with a 32 bit
+ * phase accumulator: no per sample float math, just a lookup with optional
+ * linear interpolation, so many voices (e.g. a 16 voice GeneratorMixer)
+ * stay cheap. Use the sine, saw or square table from WaveTables or provide
+ * your own table with WaveTables::size entries plus one guard entry.
+ * @ingroup generator
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ * @tparam T
+ */
+template <class T> class WaveTableGenerator : public SoundGenerator<T> {
+public:
+  WaveTableGenerator(const int16_t *table = WaveTables::sine(),
+                     float amplitude = 0.9f * NumberConverter::maxValueT<T>()) {
+    LOGD("WaveTableGenerator");
+    p_table = table;
+    m_amplitude = amplitude;
+  }
+
+  bool begin() override {
+    TRACEI();
+    SoundGenerator<T>::begin();
+    amplitude_q = (int32_t)m_amplitude;
+    setFrequency(m_frequency);
+    return true;
+  }
+
+  bool begin(AudioInfo info, float frequency) {
+    SoundGenerator<T>::begin(info);
+    amplitude_q = (int32_t)m_amplitude;
+    setFrequency(frequency);
+    return true;
+  }
+
+  bool begin(int channels, int sample_rate, float frequency) {
+    SoundGenerator<T>::info.channels = channels;
+    SoundGenerator<T>::info.sample_rate = sample_rate;
+    return begin(SoundGenerator<T>::info, frequency);
+  }
+
+  /// Defines the frequency - after the processing has been started
+  void setFrequency(float frequency) override {
+    m_frequency = frequency;
+    int sample_rate = SoundGenerator<T>::info.sample_rate;
+    if (sample_rate > 0) {
+      phase_inc = (uint32_t)(frequency * 4294967296.0f / sample_rate);
+    }
+  }
+
+  /// Defines the wavetable to be indexed
+  void setTable(const int16_t *table) { p_table = table; }
+
+  /// Linear interpolation between the table entries (default true)
+  void setInterpolate(bool flag) { is_interpolate = flag; }
+
+  void setAmplitude(float amp) {
+    m_amplitude = amp;
+    amplitude_q = (int32_t)amp;
+  }
+
+  T readSample() override {
+    T result = sample(phase);
+    phase += phase_inc;
+    return result;
+  }
+
+  /// Provides a batch of samples in one tight loop
+  size_t readSamples(T *data, size_t sampleCount) override {
+    uint32_t ph = phase;
+    uint32_t inc = phase_inc;
+    if (is_interpolate) {
+      for (size_t j = 0; j < sampleCount; j++) {
+        data[j] = sample(ph);
+        ph += inc;
+      }
+    } else {
+      for (size_t j = 0; j < sampleCount; j++) {
+        int32_t val = p_table[ph >> 24];
+        data[j] = (T)(((int64_t)val * amplitude_q) >> 15);
+        ph += inc;
+      }
+    }
+    phase = ph;
+    return sampleCount;
+  }
+
+protected:
+  const int16_t *p_table = nullptr;
+  float m_amplitude = 1.0f;
+  float m_frequency = 0.0f;
+  int32_t amplitude_q = 32767;
+  uint32_t phase = 0;
+  uint32_t phase_inc = 0;
+  bool is_interpolate = true;
+
+  /// table lookup with linear interpolation in Q15
+  inline T sample(uint32_t ph) {
+    uint32_t idx = ph >> 24;  // upper 8 bits: table index
+    int32_t frac = (ph >> 9) & 0x7FFF;  // next 15 bits: fraction
+    int32_t val0 = p_table[idx];
+    int32_t val1 = p_table[idx + 1];
+    int32_t val = val0 + (((val1 - val0) * frac) >> 15);
+    return (T)(((int64_t)val * amplitude_q) >> 15);
+  }
+};
+
 /**
  * @brief Generator which combines (mixes) multiple sound generators into one output
  * @ingroup generator
@@ -802,6 +1154,32 @@ public:
     return count > 0.0f ? total / count : 0;
   }
 
+  /// Provides a batch of samples: mixes the batches of the generators
+  size_t readSamples(T *data, size_t sampleCount) override {
+    float totals[64];
+    T tmp[64];
+    size_t result = 0;
+    while (result < sampleCount) {
+      int n = min((int)(sampleCount - result), 64);
+      memset(totals, 0, n * sizeof(float));
+      int count = 0;
+      for (auto &generator : vector) {
+        if (generator->isActive()) {
+          generator->readSamples(tmp, n);
+          for (int j = 0; j < n; j++) {
+            totals[j] += tmp[j];
+          }
+          count++;
+        }
+      }
+      for (int j = 0; j < n; j++) {
+        data[result + j] = count > 0 ? (T)(totals[j] / count) : 0;
+      }
+      result += n;
+    }
+    return sampleCount;
+  }
+
 protected:
   Vector<SoundGenerator<T> *> vector;
   int actualChannel = 0;
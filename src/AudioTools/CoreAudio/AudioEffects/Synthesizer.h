@@ -328,10 +328,228 @@ class Synthesizer : public SoundGenerator<int16_t> {
                 if (par->p_synthesizer!=nullptr){
                     par->p_synthesizer->keyOff(par->note);
                 } else {
-                    LOGE("callbackKeyOff: p_synthesizer is null");               
+                    LOGE("callbackKeyOff: p_synthesizer is null");
                 }
             } else {
-                LOGE("callbackKeyOff: ref is null");               
+                LOGE("callbackKeyOff: ref is null");
+            }
+        }
+};
+
+/**
+ * @brief Polyphonic voice engine: a fixed pool of voices (wavetable
+ * oscillator + ADSR + pan) which are all rendered in a single pass into a
+ * shared int32 mix bus. In contrast to the Synthesizer above there is no
+ * virtual call per voice and sample and no intermediate buffer per voice,
+ * so considerably more voices fit into the same render budget. When all
+ * voices are busy keyOn() steals a voice: released voices are preferred,
+ * otherwise the oldest one is retriggered.
+ * @ingroup generator
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ */
+class VoiceEngine : public SoundGenerator<int16_t> {
+    public:
+        VoiceEngine(int voiceCount = 8, const int16_t *table = WaveTables::sine()){
+            voices.resize(voiceCount);
+            p_table = table;
+        }
+
+        bool begin(AudioInfo info) override {
+            setAudioInfo(info);
+            return begin();
+        }
+
+        bool begin() override {
+            TRACEI();
+            SoundGenerator<int16_t>::begin();
+            for (int j=0; j<voices.size(); j++){
+                voices[j].adsr = adsr_template;
+                voices[j].adsr.keyOff();
+            }
+            return true;
+        }
+
+        /// Defines the wavetable shared by all voices
+        void setTable(const int16_t *table) { p_table = table; }
+
+        /// Defines the envelope which is copied to every voice
+        void setADSR(float attack, float decay, float sustainLevel, float release){
+            adsr_template = ADSR(attack, decay, sustainLevel, release);
+        }
+
+        /// Master volume applied to the mix bus (0.0 - 1.0)
+        void setVolume(float vol){
+            volume_q = (int32_t)(vol * 32767.0f);
+        }
+
+        /// Starts a note: frequency in Hz, velocity 0.0 - 1.0, pan -1.0 (left)
+        /// to 1.0 (right) - pan is only relevant for a stereo output
+        void keyOn(float frequency, float velocity = 1.0f, float pan = 0.0f){
+            LOGI("keyOn: %f", frequency);
+            Voice &voice = stealVoice();
+            voice.note = frequency;
+            voice.phase = 0;
+            voice.phase_inc = (uint32_t)(frequency * 4294967296.0f / info.sample_rate);
+            voice.velocity_q = (int32_t)(velocity * 32767.0f);
+            // equal power pan
+            float angle = (pan + 1.0f) * PI / 4.0f;
+            voice.gain_left_q = (int32_t)(cosf(angle) * 32767.0f);
+            voice.gain_right_q = (int32_t)(sinf(angle) * 32767.0f);
+            voice.released = false;
+            voice.order = order_counter++;
+            voice.adsr.keyOn();
+        }
+
+        /// Releases the (newest) voice playing the indicated note
+        void keyOff(float frequency){
+            LOGI("keyOff: %f", frequency);
+            Voice *p_found = nullptr;
+            for (int j=0; j<voices.size(); j++){
+                Voice &voice = voices[j];
+                if (voice.note == frequency && voice.adsr.isActive() && !voice.released){
+                    if (p_found==nullptr || voice.order > p_found->order){
+                        p_found = &voice;
+                    }
+                }
+            }
+            if (p_found!=nullptr){
+                p_found->released = true;
+                p_found->adsr.keyOff();
+            }
+        }
+
+        /// Provides the number of currently sounding voices
+        int activeVoices() {
+            int count = 0;
+            for (int j=0; j<voices.size(); j++){
+                if (voices[j].adsr.isActive()) count++;
+            }
+            return count;
+        }
+
+        int16_t readSample() override {
+            int16_t result;
+            readSamples(&result, 1);
+            return result;
+        }
+
+        /// Renders all voices into the int32 mix bus in a single pass
+        size_t readSamples(int16_t *data, size_t sampleCount) override {
+            size_t result = 0;
+            while (result < sampleCount){
+                int frames = min((int)(sampleCount - result), MIX_BUS_FRAMES);
+                renderBus(frames, 1);
+                for (int j=0; j<frames; j++){
+                    data[result + j] = NumberConverter::clipT<int16_t>(
+                        (int)((mix_bus[j] * (int64_t)volume_q) >> 15));
+                }
+                result += frames;
+            }
+            return sampleCount;
+        }
+
+        /// Stereo output applies the voice pan; other channel counts use the
+        /// default mono duplication
+        size_t readBytes(uint8_t *data, size_t len) override {
+            int channels = audioInfo().channels;
+            if (!active || channels != 2 || len < 2 * sizeof(int16_t)){
+                return SoundGenerator<int16_t>::readBytes(data, len);
+            }
+            int16_t *result_buffer = (int16_t*)data;
+            int open = len / (2 * sizeof(int16_t));
+            size_t result = 0;
+            while (open > 0){
+                int frames = min(open, MIX_BUS_FRAMES / 2);
+                renderBus(frames, 2);
+                for (int j=0; j<frames*2; j++){
+                    *result_buffer++ = NumberConverter::clipT<int16_t>(
+                        (int)((mix_bus[j] * (int64_t)volume_q) >> 15));
+                }
+                open -= frames;
+                result += frames * 2 * sizeof(int16_t);
+            }
+            return result;
+        }
+
+    protected:
+        static const int MIX_BUS_FRAMES = 64;
+
+        /// The state of a single voice
+        struct Voice {
+            ADSR adsr;
+            uint32_t phase = 0;
+            uint32_t phase_inc = 0;
+            int32_t velocity_q = 32767;
+            int32_t gain_left_q = 23170;   // cos(45°) in Q15
+            int32_t gain_right_q = 23170;
+            float note = 0;
+            uint32_t order = 0;
+            bool released = true;
+        };
+
+        Vector<Voice> voices{0};
+        const int16_t *p_table = nullptr;
+        ADSR adsr_template{0.0001, 0.0001, 0.8, 0.0005};
+        int32_t volume_q = 32767;
+        uint32_t order_counter = 0;
+        int32_t mix_bus[MIX_BUS_FRAMES * 2];
+
+        /// Selects the voice for the next note: idle first, then released,
+        /// then the oldest one
+        Voice &stealVoice(){
+            Voice *p_released = nullptr;
+            Voice *p_oldest = &voices[0];
+            for (int j=0; j<voices.size(); j++){
+                Voice &voice = voices[j];
+                if (!voice.adsr.isActive()) return voice;
+                if (voice.released && (p_released==nullptr || voice.order < p_released->order)){
+                    p_released = &voice;
+                }
+                if (voice.order < p_oldest->order){
+                    p_oldest = &voice;
+                }
+            }
+            LOGD("stealing voice");
+            return p_released!=nullptr ? *p_released : *p_oldest;
+        }
+
+        /// Clears the bus and accumulates all active voices: the envelope is
+        /// evaluated per segment (constant slope) so the inner loop contains
+        /// only the table lookup, the scaling and the add
+        void renderBus(int frames, int channels){
+            memset(mix_bus, 0, frames * channels * sizeof(int32_t));
+            for (int v=0; v<voices.size(); v++){
+                Voice &voice = voices[v];
+                if (!voice.adsr.isActive()) continue;
+                uint32_t ph = voice.phase;
+                uint32_t inc = voice.phase_inc;
+                int pos = 0;
+                while (pos < frames && voice.adsr.isActive()){
+                    float slope;
+                    int n = voice.adsr.segment(frames - pos, slope);
+                    float env = voice.adsr.value();
+                    for (int j=0; j<n; j++){
+                        env += slope;
+                        uint32_t idx = ph >> 24;
+                        int32_t frac = (ph >> 9) & 0x7FFF;
+                        int32_t val0 = p_table[idx];
+                        int32_t val1 = p_table[idx + 1];
+                        int32_t val = val0 + (((val1 - val0) * frac) >> 15);
+                        ph += inc;
+                        int32_t sample = (int32_t)(val * env);
+                        sample = (sample * voice.velocity_q) >> 15;
+                        if (channels == 2){
+                            mix_bus[(pos + j) * 2] += (sample * voice.gain_left_q) >> 15;
+                            mix_bus[(pos + j) * 2 + 1] += (sample * voice.gain_right_q) >> 15;
+                        } else {
+                            mix_bus[pos + j] += sample;
+                        }
+                    }
+                    voice.adsr.advance(n, slope);
+                    pos += n;
+                }
+                voice.phase = ph;
             }
         }
 };
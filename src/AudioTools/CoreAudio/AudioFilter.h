@@ -3,3 +3,4 @@
 #include "AudioTools/CoreAudio/AudioFilter/Filter.h"
 #include "AudioTools/CoreAudio/AudioFilter/Equalizer.h"
 #include "AudioTools/CoreAudio/AudioFilter/MedianFilter.h"
+#include "AudioTools/CoreAudio/AudioFilter/Crossover.h"
@@ -0,0 +1,163 @@
+#pragma once
+#include <math.h>
+
+#include "AudioConfig.h"
+#include "AudioTools/CoreAudio/AudioFilter/Filter.h"
+#include "AudioTools/CoreAudio/AudioOutput.h"
+
+/**
+ * @defgroup crossover Crossover
+ * @ingroup dsp
+ * @brief Multiband crossover
+ **/
+
+namespace audio_tools {
+
+/**
+ * @brief N-way Linkwitz-Riley (LR4) crossover which reads one input block
+ * and produces one output per band in a single pass. Each split consists of
+ * two cascaded Butterworth biquads (q=0.7071) per side, so the summed bands
+ * are phase matched - unlike two independently filtered copies of the
+ * stream. Add the band outputs from low to high with addOutput() and the
+ * crossover frequencies with addFrequency(): for n bands n-1 frequencies
+ * are needed. Each output receives the full frame format (all channels).
+ * @ingroup crossover
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ */
+class CrossoverOutput : public AudioOutput {
+ public:
+  CrossoverOutput() = default;
+
+  /// Convenience constructor for a 2-way crossover
+  CrossoverOutput(Print &low, Print &high, float frequency) {
+    addOutput(low);
+    addOutput(high);
+    addFrequency(frequency);
+  }
+
+  ~CrossoverOutput() { clearFilters(); }
+
+  /// Adds a band output (from low to high)
+  void addOutput(Print &out) { outputs.push_back(&out); }
+
+  /// Adds a crossover frequency (from low to high)
+  void addFrequency(float frequency) { frequencies.push_back(frequency); }
+
+  bool begin(AudioInfo info) {
+    setAudioInfo(info);
+    return begin();
+  }
+
+  bool begin() override {
+    if (outputs.size() < 2 || frequencies.size() != outputs.size() - 1) {
+      LOGE("bands: %d, frequencies: %d", (int)outputs.size(),
+           (int)frequencies.size());
+      return false;
+    }
+    setupFilters();
+    is_active = true;
+    return true;
+  }
+
+  void end() override {
+    is_active = false;
+    clearFilters();
+  }
+
+  /// Splits the data into the bands and writes each band to its output
+  size_t write(const uint8_t *data, size_t len) override {
+    if (!is_active) return 0;
+    switch (cfg.bits_per_sample) {
+      case 16:
+        return writeT<int16_t>(data, len);
+      case 24:
+        return writeT<int24_t>(data, len);
+      case 32:
+        return writeT<int32_t>(data, len);
+      default:
+        LOGE("Unsupported bits_per_sample: %d", cfg.bits_per_sample);
+        return 0;
+    }
+  }
+
+ protected:
+  /// LR4 split: two cascaded Butterworth biquads per side and channel
+  struct Split {
+    LowPassFilter<float> *lp1 = nullptr;
+    LowPassFilter<float> *lp2 = nullptr;
+    HighPassFilter<float> *hp1 = nullptr;
+    HighPassFilter<float> *hp2 = nullptr;
+  };
+
+  Vector<Print *> outputs{0};
+  Vector<float> frequencies{0};
+  Vector<Split> splits{0};  // [split * channels + channel]
+  Vector<Vector<uint8_t>> band_data{0};
+
+  void setupFilters() {
+    clearFilters();
+    int channels = cfg.channels > 0 ? cfg.channels : 1;
+    splits.resize(frequencies.size() * channels);
+    band_data.resize(outputs.size());
+    for (int s = 0; s < (int)frequencies.size(); s++) {
+      for (int ch = 0; ch < channels; ch++) {
+        Split &split = splits[s * channels + ch];
+        split.lp1 = new LowPassFilter<float>(frequencies[s], cfg.sample_rate);
+        split.lp2 = new LowPassFilter<float>(frequencies[s], cfg.sample_rate);
+        split.hp1 = new HighPassFilter<float>(frequencies[s], cfg.sample_rate);
+        split.hp2 = new HighPassFilter<float>(frequencies[s], cfg.sample_rate);
+      }
+    }
+  }
+
+  void clearFilters() {
+    for (int j = 0; j < (int)splits.size(); j++) {
+      delete splits[j].lp1;
+      delete splits[j].lp2;
+      delete splits[j].hp1;
+      delete splits[j].hp2;
+    }
+    splits.resize(0);
+  }
+
+  template <typename T>
+  size_t writeT(const uint8_t *data, size_t len) {
+    int channels = cfg.channels > 0 ? cfg.channels : 1;
+    int sample_count = len / sizeof(T);
+    int bands = outputs.size();
+    int n_splits = frequencies.size();
+    T *samples = (T *)data;
+
+    // one interleaved buffer per band
+    for (int b = 0; b < bands; b++) {
+      if (band_data[b].size() < len) band_data[b].resize(len);
+    }
+
+    // single pass: each split sends the low part to its band and passes
+    // the high part on to the next split
+    for (int j = 0; j < sample_count; j += channels) {
+      for (int ch = 0; ch < channels; ch++) {
+        float value = static_cast<float>(samples[j + ch]);
+        for (int s = 0; s < n_splits; s++) {
+          Split &split = splits[s * channels + ch];
+          float low = split.lp2->process(split.lp1->process(value));
+          float high = split.hp2->process(split.hp1->process(value));
+          T *band = (T *)band_data[s].data();
+          band[j + ch] = (T)low;
+          value = high;
+        }
+        T *band = (T *)band_data[bands - 1].data();
+        band[j + ch] = (T)value;
+      }
+    }
+
+    // write each band to its output
+    for (int b = 0; b < bands; b++) {
+      outputs[b]->write(band_data[b].data(), len);
+    }
+    return len;
+  }
+};
+
+}  // namespace audio_tools
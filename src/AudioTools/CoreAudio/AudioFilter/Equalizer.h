@@ -233,4 +233,239 @@ class Equalizer3Bands : public ModifyingStream {
   }
 };
 
+/**
+ * @brief Configuration for the N Band Equalizer: Set
+ * channels, bits_per_sample, sample_rate and the number of bands. The band
+ * center frequencies are octave spaced starting at freq_start.
+ * @ingroup equilizer
+ * @author pschatzmann
+ */
+struct ConfigEqualizerNBands : public AudioInfo {
+  ConfigEqualizerNBands() {
+    channels = 2;
+    bits_per_sample = 16;
+    sample_rate = 44100;
+  }
+
+  ConfigEqualizerNBands(const ConfigEqualizerNBands &) = delete;
+
+  /// Number of bands
+  int bands = 10;
+  /// Center frequency of the first band
+  float freq_start = 31.25f;
+  /// Q factor of the peaking filters
+  float q = 1.414f;
+  /// Number of frames processed per block
+  int block_size = 64;
+};
+
+/**
+ * @brief N Band Equalizer (default 10 bands) built from peaking biquads.
+ * Unlike the per sample cascade of Equalizer3Bands, the coefficients of all
+ * bands are kept in one contiguous array which is shared between the
+ * channels (only the filter state is per channel) and a whole block of
+ * samples is processed band by band per channel: each set of coefficients
+ * is loaded once per block and the state stays in registers, which cuts
+ * the per sample overhead considerably.
+ * @ingroup equilizer
+ * @author pschatzmann
+ */
+class EqualizerNBands : public ModifyingStream {
+ public:
+  EqualizerNBands(Print &out) { setOutput(out); }
+
+  EqualizerNBands(Stream &in) { setStream(in); }
+
+  EqualizerNBands(AudioOutput &out) {
+    setOutput(out);
+    out.addNotifyAudioChange(*this);
+  }
+
+  EqualizerNBands(AudioStream &stream) {
+    setStream(stream);
+    stream.addNotifyAudioChange(*this);
+  }
+
+  /// Defines/Changes the input & output
+  void setStream(Stream &io) override {
+    p_print = &io;
+    p_stream = &io;
+  };
+
+  /// Defines/Changes the output target
+  void setOutput(Print &out) override { p_print = &out; }
+
+  ConfigEqualizerNBands &config() { return cfg; }
+
+  ConfigEqualizerNBands &defaultConfig() { return config(); }
+
+  bool begin(ConfigEqualizerNBands &config) {
+    p_cfg = &config;
+    if (p_cfg->bands <= 0) {
+      LOGE("Invalid bands: %d", p_cfg->bands);
+      return false;
+    }
+    // coefficients are shared between all channels
+    coefficients.resize(p_cfg->bands);
+    gains_db.resize(p_cfg->bands);
+    states.resize(p_cfg->bands * p_cfg->channels);
+    for (int band = 0; band < p_cfg->bands; band++) {
+      updateCoefficients(band);
+    }
+    for (int j = 0; j < (int)states.size(); j++) {
+      memset(&states[j], 0, sizeof(BandState));
+    }
+    block.resize(p_cfg->block_size);
+    return true;
+  }
+
+  virtual void setAudioInfo(AudioInfo info) override {
+    p_cfg->sample_rate = info.sample_rate;
+    p_cfg->channels = info.channels;
+    p_cfg->bits_per_sample = info.bits_per_sample;
+    begin(*p_cfg);
+  }
+
+  /// Defines the gain (in dB) for the indicated band
+  void setGain(int band, float gainDB) {
+    if (band < 0 || band >= p_cfg->bands) {
+      LOGE("Invalid band: %d", band);
+      return;
+    }
+    gains_db[band] = gainDB;
+    if (coefficients.size() > 0) updateCoefficients(band);
+  }
+
+  /// Provides the center frequency of the indicated band
+  float frequency(int band) {
+    return p_cfg->freq_start * powf(2.0f, (float)band);
+  }
+
+  size_t write(const uint8_t *data, size_t len) override {
+    filterSamples(data, len);
+    return p_print->write(data, len);
+  }
+
+  int availableForWrite() override { return p_print->availableForWrite(); }
+
+  /// Provides the filtered data from the defined input
+  size_t readBytes(uint8_t *data, size_t len) override {
+    size_t result = 0;
+    if (p_stream != nullptr) {
+      result = p_stream->readBytes(data, len);
+      filterSamples(data, result);
+    }
+    return result;
+  }
+
+  int available() override {
+    return p_stream != nullptr ? p_stream->available() : 0;
+  }
+
+ protected:
+  /// Peaking biquad coefficients: one cache friendly array of structs
+  struct BandCoefficients {
+    float b0, b1, b2, a1, a2;
+  };
+  /// Per channel and band filter state
+  struct BandState {
+    float x1, x2, y1, y2;
+  };
+  ConfigEqualizerNBands cfg;
+  ConfigEqualizerNBands *p_cfg = &cfg;
+  Print *p_print = nullptr;
+  Stream *p_stream = nullptr;
+  Vector<BandCoefficients> coefficients{0};
+  Vector<BandState> states{0};
+  Vector<float> gains_db{0};
+  Vector<float> block{0};
+
+  /// Recalculates the peaking filter for the indicated band
+  void updateCoefficients(int band) {
+    BandCoefficients &c = coefficients[band];
+    float freq = frequency(band);
+    if (freq >= p_cfg->sample_rate / 2.0f || gains_db[band] == 0.0f) {
+      // bypass bands above nyquist or with flat gain
+      c.b0 = 1.0f;
+      c.b1 = c.b2 = c.a1 = c.a2 = 0.0f;
+      return;
+    }
+    float A = powf(10.0f, gains_db[band] / 40.0f);
+    float omega = 2.0f * PI * freq / p_cfg->sample_rate;
+    float sn = sinf(omega);
+    float cs = cosf(omega);
+    float alpha = sn / (2.0f * p_cfg->q);
+    float a0 = 1.0f + alpha / A;
+    c.b0 = (1.0f + alpha * A) / a0;
+    c.b1 = (-2.0f * cs) / a0;
+    c.b2 = (1.0f - alpha * A) / a0;
+    c.a1 = (-2.0f * cs) / a0;
+    c.a2 = (1.0f - alpha / A) / a0;
+  }
+
+  void filterSamples(const uint8_t *data, size_t len) {
+    switch (p_cfg->bits_per_sample) {
+      case 16:
+        filterSamplesT<int16_t>(data, len);
+        break;
+      case 24:
+        filterSamplesT<int24_t>(data, len);
+        break;
+      case 32:
+        filterSamplesT<int32_t>(data, len);
+        break;
+      default:
+        LOGE("Unsupported bits_per_sample: %d", p_cfg->bits_per_sample);
+        break;
+    }
+  }
+
+  /// Processes block_size frames at a time: per channel the whole block is
+  /// run through all bands before moving on
+  template <typename T>
+  void filterSamplesT(const uint8_t *data, size_t len) {
+    T *p_dataT = (T *)data;
+    int frames = len / sizeof(T) / p_cfg->channels;
+    int bits = p_cfg->bits_per_sample;
+    for (int start = 0; start < frames; start += p_cfg->block_size) {
+      int n = min(p_cfg->block_size, frames - start);
+      for (int ch = 0; ch < p_cfg->channels; ch++) {
+        // gather the channel into the float block
+        for (int j = 0; j < n; j++) {
+          block[j] = NumberConverter::toFloat(
+              p_dataT[(start + j) * p_cfg->channels + ch], bits);
+        }
+        // run the whole block through each band
+        for (int band = 0; band < p_cfg->bands; band++) {
+          processBand(coefficients[band],
+                      states[ch * p_cfg->bands + band], block.data(), n);
+        }
+        // scatter the result back
+        for (int j = 0; j < n; j++) {
+          p_dataT[(start + j) * p_cfg->channels + ch] =
+              NumberConverter::fromFloat(block[j], bits);
+        }
+      }
+    }
+  }
+
+  /// Biquad kernel with the state in locals
+  void processBand(BandCoefficients &c, BandState &s, float *values, int n) {
+    float x1 = s.x1, x2 = s.x2, y1 = s.y1, y2 = s.y2;
+    for (int j = 0; j < n; j++) {
+      float x0 = values[j];
+      float y0 = c.b0 * x0 + c.b1 * x1 + c.b2 * x2 - c.a1 * y1 - c.a2 * y2;
+      x2 = x1;
+      x1 = x0;
+      y2 = y1;
+      y1 = y0;
+      values[j] = y0;
+    }
+    s.x1 = x1;
+    s.x2 = x2;
+    s.y1 = y1;
+    s.y2 = y2;
+  }
+};
+
 }  // namespace audio_tools
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 #include "AudioConfig.h"
 #include <math.h>
+#include <string.h>
 #ifdef USE_TYPETRAITS
 #include <type_traits>
 #endif
@@ -34,6 +35,16 @@ class Filter {
   Filter &operator=(Filter const &) = delete;
 
   virtual T process(T in) = 0;
+
+  /// Process a block of samples: the default implementation just calls
+  /// process() per sample; subclasses override this with a tight loop so
+  /// the virtual dispatch is paid once per block instead of per sample.
+  /// in and out may point to the same array.
+  virtual void processBlock(const T *in, T *out, size_t len) {
+    for (size_t j = 0; j < len; j++) {
+      out[j] = process(in[j]);
+    }
+  }
 };
 
 /**
@@ -48,6 +59,9 @@ class NoFilter : Filter<T> {
   // construct without coefs
   NoFilter() = default;
   virtual T process(T in) { return in; }
+  void processBlock(const T *in, T *out, size_t len) override {
+    if (in != out) memmove(out, in, len * sizeof(T));
+  }
 };
 
 /**
@@ -103,6 +117,32 @@ class FIR : public Filter<T> {
     return b_terms;
   }
 
+  /// block processing with the index state hoisted into locals
+  void processBlock(const T *in, T *out, size_t len) override {
+    uint8_t ib = i_b;
+    for (size_t j = 0; j < len; j++) {
+      x[ib] = in[j];
+      T b_terms = 0;
+      T *b_shift = &coeff_b[lenB - ib - 1];
+      for (uint8_t i = 0; i < lenB; i++) {
+        b_terms += b_shift[i] * x[i];
+      }
+      ib++;
+      if (ib == lenB) ib = 0;
+#ifdef USE_TYPETRAITS
+      if (!(std::is_same<T, float>::value || std::is_same<T, float>::value)) {
+        b_terms = b_terms / factor;
+      }
+#else
+      if (factor != 1.0) {
+        b_terms = b_terms / factor;
+      }
+#endif
+      out[j] = b_terms;
+    }
+    i_b = ib;
+  }
+
  private:
   const uint8_t lenB;
   uint8_t i_b = 0;
@@ -180,6 +220,43 @@ class IIR : public Filter<T> {
     return filtered;
   }
 
+  /// block processing with the index state hoisted into locals
+  void processBlock(const T *in, T *out, size_t len) override {
+    uint8_t ib = i_b;
+    uint8_t ia = i_a;
+    for (size_t j = 0; j < len; j++) {
+      x[ib] = in[j];
+      T b_terms = 0;
+      T *b_shift = &coeff_b[lenB - ib - 1];
+      T a_terms = 0;
+      T *a_shift = &coeff_a[lenA - ia - 1];
+      for (uint8_t i = 0; i < lenB; i++) {
+        b_terms += x[i] * b_shift[i];
+      }
+      for (uint8_t i = 0; i < lenA; i++) {
+        a_terms += y[i] * a_shift[i];
+      }
+      T filtered = b_terms - a_terms;
+      y[ia] = filtered;
+      ib++;
+      if (ib == lenB) ib = 0;
+      ia++;
+      if (ia == lenA) ia = 0;
+#ifdef USE_TYPETRAITS
+      if (!(std::is_same<T, float>::value || std::is_same<T, float>::value)) {
+        filtered = filtered / factor;
+      }
+#else
+      if (factor != 1.0) {
+        filtered = filtered / factor;
+      }
+#endif
+      out[j] = filtered;
+    }
+    i_b = ib;
+    i_a = ia;
+  }
+
  private:
   T factor;
   const uint8_t lenB, lenA;
@@ -234,6 +311,24 @@ class BiQuadDF1 : public Filter<T> {
     return y_1;
   }
 
+  /// block processing with the filter state kept in registers
+  void processBlock(const T *in, T *out, size_t len) override {
+    T x0 = x_0, x1 = x_1, y1 = y_1, y2 = y_2;
+    for (size_t j = 0; j < len; j++) {
+      T x2 = x1;
+      x1 = x0;
+      x0 = in[j];
+      T result = x0 * b_0 + x1 * b_1 + x2 * b_2 - y1 * a_1 - y2 * a_2;
+      y2 = y1;
+      y1 = result;
+      out[j] = result;
+    }
+    x_0 = x0;
+    x_1 = x1;
+    y_1 = y1;
+    y_2 = y2;
+  }
+
  private:
   T b_0;
   T b_1;
@@ -289,6 +384,19 @@ class BiQuadDF2 : public Filter<T> {
     return y;
   }
 
+  /// block processing with the filter state kept in registers
+  void processBlock(const T *in, T *out, size_t len) override {
+    T w0 = w_0, w1 = w_1;
+    for (size_t j = 0; j < len; j++) {
+      T w2 = w1;
+      w1 = w0;
+      w0 = in[j] - a_1 * w1 - a_2 * w2;
+      out[j] = b_0 * w0 + b_1 * w1 + b_2 * w2;
+    }
+    w_0 = w0;
+    w_1 = w1;
+  }
+
  protected:
   T b_0 = 0;
   T b_1 = 0;
@@ -519,6 +627,189 @@ class HighShelfFilter : public BiQuadDF2<T> {
   }
 };
 
+/**
+ * @brief Biquad DF1 filter with fixed point coefficients for targets
+ * without FPU. The float design is quantized to Q14 (which covers the
+ * |a1| < 2 coefficient range); the samples are processed with a 64 bit
+ * accumulator, so both int16_t (Q15 style) and int32_t (Q31 style) sample
+ * types run integer-only. The begin methods quantize the same designs as
+ * LowPassFilter, HighPassFilter, BandPassFilter and NotchFilter.
+ * @ingroup filter
+ * @author pschatzmann
+ * @copyright GNU General Public License v3.0
+ * @tparam T integer sample type: int16_t or int32_t
+ */
+template <typename T>
+class BiQuadDF1Fx : public Filter<T> {
+ public:
+  BiQuadDF1Fx() = default;
+
+  /// Quantizes the normalized float coefficients (already divided by a0)
+  void setCoefficients(float b0f, float b1f, float b2f, float a1f, float a2f) {
+    b0 = toFx(b0f);
+    b1 = toFx(b1f);
+    b2 = toFx(b2f);
+    a1 = toFx(a1f);
+    a2 = toFx(a2f);
+  }
+
+  /// Low pass design (same math as LowPassFilter)
+  void beginLowPass(float frequency, float sampleRate, float q = 0.7071f) {
+    float w0 = frequency * (2.0f * 3.141592654f / sampleRate);
+    float sinW0 = sinf(w0);
+    float cosW0 = cosf(w0);
+    float alpha = sinW0 / (q * 2.0f);
+    float scale = 1.0f / (1.0f + alpha);
+    setCoefficients(((1.0f - cosW0) / 2.0f) * scale, (1.0f - cosW0) * scale,
+                    ((1.0f - cosW0) / 2.0f) * scale, (-2.0f * cosW0) * scale,
+                    (1.0f - alpha) * scale);
+  }
+
+  /// High pass design (same math as HighPassFilter)
+  void beginHighPass(float frequency, float sampleRate, float q = 0.7071f) {
+    float w0 = frequency * (2.0f * 3.141592654f / sampleRate);
+    float sinW0 = sinf(w0);
+    float cosW0 = cosf(w0);
+    float alpha = sinW0 / (q * 2.0f);
+    float scale = 1.0f / (1.0f + alpha);
+    setCoefficients(((1.0f + cosW0) / 2.0f) * scale, -(1.0f + cosW0) * scale,
+                    ((1.0f + cosW0) / 2.0f) * scale, (-2.0f * cosW0) * scale,
+                    (1.0f - alpha) * scale);
+  }
+
+  /// Band pass design (same math as BandPassFilter)
+  void beginBandPass(float frequency, float sampleRate, float q = 1.0f) {
+    float w0 = frequency * (2.0f * 3.141592654f / sampleRate);
+    float sinW0 = sinf(w0);
+    float cosW0 = cosf(w0);
+    float alpha = sinW0 / (q * 2.0f);
+    float scale = 1.0f / (1.0f + alpha);
+    setCoefficients(alpha * scale, 0.0f, -alpha * scale,
+                    (-2.0f * cosW0) * scale, (1.0f - alpha) * scale);
+  }
+
+  /// Notch design (same math as NotchFilter)
+  void beginNotch(float frequency, float sampleRate, float q = 1.0f) {
+    float w0 = frequency * (2.0f * 3.141592654f / sampleRate);
+    float sinW0 = sinf(w0);
+    float cosW0 = cosf(w0);
+    float alpha = sinW0 / (q * 2.0f);
+    float scale = 1.0f / (1.0f + alpha);
+    setCoefficients(scale, (-2.0f * cosW0) * scale, scale,
+                    (-2.0f * cosW0) * scale, (1.0f - alpha) * scale);
+  }
+
+  T process(T value) override {
+    int64_t acc = (int64_t)b0 * value + (int64_t)b1 * x1 + (int64_t)b2 * x2 -
+                  (int64_t)a1 * y1 - (int64_t)a2 * y2;
+    int32_t result = (int32_t)(acc >> 14);
+    x2 = x1;
+    x1 = value;
+    y2 = y1;
+    y1 = result;
+    return (T)result;
+  }
+
+  /// block processing with the filter state kept in registers
+  void processBlock(const T *in, T *out, size_t len) override {
+    int32_t lx1 = x1, lx2 = x2, ly1 = y1, ly2 = y2;
+    for (size_t j = 0; j < len; j++) {
+      int32_t x0 = in[j];
+      int64_t acc = (int64_t)b0 * x0 + (int64_t)b1 * lx1 + (int64_t)b2 * lx2 -
+                    (int64_t)a1 * ly1 - (int64_t)a2 * ly2;
+      int32_t result = (int32_t)(acc >> 14);
+      lx2 = lx1;
+      lx1 = x0;
+      ly2 = ly1;
+      ly1 = result;
+      out[j] = (T)result;
+    }
+    x1 = lx1;
+    x2 = lx2;
+    y1 = ly1;
+    y2 = ly2;
+  }
+
+ protected:
+  int32_t b0 = 0, b1 = 0, b2 = 0, a1 = 0, a2 = 0;
+  int32_t x1 = 0, x2 = 0, y1 = 0, y2 = 0;
+
+  /// float -> Q14
+  int32_t toFx(float value) { return (int32_t)roundf(value * 16384.0f); }
+};
+
+/**
+ * @brief FIR filter with Q15 quantized coefficients: the float taps are
+ * quantized once in setValues() and the samples are convolved with integer
+ * multiply/accumulate only, so the same FilteredStream code runs without
+ * FPU.
+ * @ingroup filter
+ * @author pschatzmann
+ * @copyright GNU General Public License v3.0
+ * @tparam T integer sample type: int16_t or int32_t
+ */
+template <typename T>
+class FIRFx : public Filter<T> {
+ public:
+  FIRFx() = default;
+
+  template <size_t B>
+  FIRFx(const float (&b)[B]) {
+    setValues(b);
+  }
+
+  ~FIRFx() {
+    delete[] x;
+    delete[] coeff;
+  }
+
+  /// Quantizes the float taps to Q15
+  template <size_t B>
+  void setValues(const float (&b)[B]) {
+    if (x != nullptr) {
+      delete[] x;
+      delete[] coeff;
+    }
+    len = B;
+    x = new T[len]();
+    coeff = new int32_t[len];
+    for (size_t i = 0; i < len; i++) {
+      coeff[i] = (int32_t)roundf(b[i] * 32768.0f);
+    }
+    pos = 0;
+  }
+
+  T process(T value) override {
+    T result;
+    processBlock(&value, &result, 1);
+    return result;
+  }
+
+  /// block processing with the history index hoisted into a local
+  void processBlock(const T *in, T *out, size_t n) override {
+    size_t p = pos;
+    for (size_t j = 0; j < n; j++) {
+      x[p] = in[j];
+      int64_t acc = 0;
+      size_t idx = p;
+      for (size_t i = 0; i < len; i++) {
+        acc += (int64_t)coeff[i] * x[idx];
+        idx = idx == 0 ? len - 1 : idx - 1;
+      }
+      p++;
+      if (p == len) p = 0;
+      out[j] = (T)(acc >> 15);
+    }
+    pos = p;
+  }
+
+ protected:
+  size_t len = 0;
+  size_t pos = 0;
+  T *x = nullptr;
+  int32_t *coeff = nullptr;
+};
+
 /**
  * @brief Second Order Filter: Instead of manually cascading BiQuad filters, you
  * can use a Second Order Sections filter (SOS). converted from
@@ -563,6 +854,14 @@ class SOSFilter : public Filter<T> {
     return value;
   }
 
+  /// block processing: each section runs over the whole block in turn
+  void processBlock(const T *in, T *out, size_t len) override {
+    filters[0]->processBlock(in, out, len);
+    for (size_t i = 1; i < N; i++) {
+      filters[i]->processBlock(out, out, len);
+    }
+  }
+
  private:
   Filter<T> *filters[N];
   template <size_t M>
@@ -595,6 +894,21 @@ class FilterChain : public Filter<T> {
     return value;
   }
 
+  /// block processing: each filter runs over the whole block in turn
+  void processBlock(const T *in, T *out, size_t len) override {
+    const T *source = in;
+    for (Filter<T> *&filter : filters) {
+      if (filter != nullptr) {
+        filter->processBlock(source, out, len);
+        source = out;
+      }
+    }
+    if (source == in && in != out) {
+      // no filter defined
+      memmove(out, in, len * sizeof(T));
+    }
+  }
+
  private:
   Filter<T> *filters[N] = {0};
 };
@@ -0,0 +1,152 @@
+#pragma once
+#include "AudioConfig.h"
+
+#if __has_include(<atomic>)
+#  include <atomic>
+#  define AUDIO_HEALTH_ATOMIC 1
+#endif
+
+namespace audio_tools {
+
+/**
+ * @brief Ids of the health counters which are maintained by the library:
+ * application specific counters can use the ids starting at HealthUser
+ * @ingroup tools
+ */
+enum HealthCounter : uint8_t {
+  HealthBufferOverflow = 0,  // a buffer write was dropped: buffer full
+  HealthBufferUnderflow,     // a buffer was read while empty
+  HealthI2SIncompleteWrite,  // i2s accepted less data than provided
+  HealthUdpLatePacket,       // udp packet arrived too late to be played
+  HealthUdpLostPacket,       // udp packet was lost or concealed
+  HealthUser,                // first id for application counters
+  HealthCounterLast = HealthUser + 4  // number of counters
+};
+
+/**
+ * @brief Central health registry: the buffers, I2SStream and UDPStream
+ * report their drop events here, so fleet telemetry has one poll point
+ * instead of scraping the individual objects. The counters are plain
+ * relaxed atomics: the reporting hot paths only pay for the increment.
+ * Thresholds with callbacks are evaluated by calling check() from the
+ * application housekeeping loop - never on the audio path.
+ * @ingroup tools
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ */
+class AudioHealth {
+ public:
+  /// Provides the (single) instance
+  static AudioHealth &instance() {
+    static AudioHealth health;
+    return health;
+  }
+
+  /// Increments the counter: relaxed atomic, safe from tasks and ISRs
+  inline void increment(HealthCounter id) {
+#ifdef AUDIO_HEALTH_ATOMIC
+    counters[id].fetch_add(1, std::memory_order_relaxed);
+#else
+    counters[id]++;
+#endif
+  }
+
+  /// Provides the current counter value
+  uint32_t count(HealthCounter id) {
+#ifdef AUDIO_HEALTH_ATOMIC
+    return counters[id].load(std::memory_order_relaxed);
+#else
+    return counters[id];
+#endif
+  }
+
+  /// Defines a callback which is fired (once) by check() when the counter
+  /// reaches the indicated limit; it is re-armed by clear()
+  void setThreshold(HealthCounter id, uint32_t limit,
+                    void (*callback)(void *ref, HealthCounter id,
+                                     uint32_t count),
+                    void *ref = nullptr) {
+    limits[id] = limit;
+    callbacks[id] = callback;
+    callback_refs[id] = ref;
+    fired[id] = false;
+  }
+
+  /// Evaluates the thresholds and fires the due callbacks: call this from
+  /// the application loop, not from the audio path. Returns true if any
+  /// callback was fired.
+  bool check() {
+    bool result = false;
+    for (int j = 0; j < HealthCounterLast; j++) {
+      if (callbacks[j] == nullptr || fired[j]) continue;
+      uint32_t value = count((HealthCounter)j);
+      if (value >= limits[j]) {
+        fired[j] = true;
+        callbacks[j](callback_refs[j], (HealthCounter)j, value);
+        result = true;
+      }
+    }
+    return result;
+  }
+
+  /// Resets all counters and re-arms the threshold callbacks
+  void clear() {
+    for (int j = 0; j < HealthCounterLast; j++) {
+#ifdef AUDIO_HEALTH_ATOMIC
+      counters[j].store(0, std::memory_order_relaxed);
+#else
+      counters[j] = 0;
+#endif
+      fired[j] = false;
+    }
+  }
+
+  /// Writes all counters as name;count lines: the single poll point for
+  /// telemetry
+  void dump(Print &out) {
+    char line[60];
+    for (int j = 0; j < HealthCounterLast; j++) {
+      snprintf(line, sizeof(line), "%s;%u", name((HealthCounter)j),
+               (unsigned)count((HealthCounter)j));
+      out.println(line);
+    }
+  }
+
+  /// Provides the counter name
+  const char *name(HealthCounter id) {
+    switch (id) {
+      case HealthBufferOverflow:
+        return "buffer_overflow";
+      case HealthBufferUnderflow:
+        return "buffer_underflow";
+      case HealthI2SIncompleteWrite:
+        return "i2s_incomplete_write";
+      case HealthUdpLatePacket:
+        return "udp_late_packet";
+      case HealthUdpLostPacket:
+        return "udp_lost_packet";
+      default:
+        return "user";
+    }
+  }
+
+ protected:
+  AudioHealth() = default;
+#ifdef AUDIO_HEALTH_ATOMIC
+  std::atomic<uint32_t> counters[HealthCounterLast] = {};
+#else
+  volatile uint32_t counters[HealthCounterLast] = {0};
+#endif
+  uint32_t limits[HealthCounterLast] = {0};
+  void (*callbacks[HealthCounterLast])(void *, HealthCounter,
+                                       uint32_t) = {nullptr};
+  void *callback_refs[HealthCounterLast] = {nullptr};
+  bool fired[HealthCounterLast] = {false};
+};
+
+/// Reports a health event: shorthand for the hot paths
+inline void healthIncrement(HealthCounter id) {
+  AudioHealth::instance().increment(id);
+}
+
+}  // namespace audio_tools
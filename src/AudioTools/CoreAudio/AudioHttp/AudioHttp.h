@@ -6,6 +6,7 @@
 **/
 
 #include "URLStream.h"
+#include "RangeURLStream.h"
 #include "AudioServer.h"
 
 #if ((defined(ESP32) && defined(USE_URL_ARDUINO)) || defined(ESP32_CMAKE)) 
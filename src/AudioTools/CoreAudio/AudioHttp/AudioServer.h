@@ -70,6 +70,7 @@ class AudioServerT {
     TRACED();
     this->in = &in;
     this->content_type = contentType;
+    send_buffer.resize(send_buffer_size);
 
 #ifdef USE_WIFI
     connectWiFi();
@@ -90,6 +91,7 @@ class AudioServerT {
     this->in = nullptr;
     this->callback = cb;
     this->content_type = contentType;
+    send_buffer.resize(send_buffer_size);
 
 #ifdef USE_WIFI
     connectWiFi();
@@ -138,7 +140,7 @@ class AudioServerT {
           // closed when all has been sent
           if (!client_obj) {
             LOGI("stop client...");
-            client_obj.stop();
+            endClient();
             active = false;
           }
         }
@@ -166,7 +168,33 @@ class AudioServerT {
     copier.resize(size);
   }
 
+  /// Defines the size of the send buffer: the audio data is collected and
+  /// written to the client with few large writes (0 = write directly)
+  void setSendBufferSize(int size) { send_buffer_size = size; }
+
+  /// Activates HTTP/1.1 chunked transfer encoding: each flush of the send
+  /// buffer is framed as one chunk
+  void setChunkedTransfer(bool active) { is_chunked = active; }
+
  protected:
+  /**
+   * @brief Collects the writes in the send buffer of the server, so that
+   * the data is passed to the network stack with few large writes: the
+   * encoder can write its output directly into this buffer and the flush
+   * sends it to the client without any further copy.
+   */
+  class ClientSendBuffer : public Print {
+   public:
+    ClientSendBuffer(AudioServerT &server) { p_server = &server; }
+    size_t write(const uint8_t *data, size_t len) override {
+      return p_server->writeBuffered(data, len);
+    }
+    size_t write(uint8_t c) override { return write(&c, 1); }
+
+   protected:
+    AudioServerT *p_server = nullptr;
+  };
+
   // WIFI
 #ifdef ESP32
   Server server;
@@ -183,12 +211,83 @@ class AudioServerT {
   Stream *in = nullptr;
   StreamCopy copier;
   BaseConverter *converter_ptr = nullptr;
+  ClientSendBuffer buffered_client{*this};
+  SingleBuffer<uint8_t> send_buffer{0};
+  Vector<char> header_scratch{0};
+  int send_buffer_size = 0;
+  bool is_chunked = false;
 
   void setupServer(int port) {
     Server tmp(port);
     server = tmp;
   }
 
+  /// Provides the output for the reply content: buffered or direct
+  Print &clientOutput() {
+    if (send_buffer_size > 0 || is_chunked) return buffered_client;
+    return client_obj;
+  }
+
+  /// Collects the data in the send buffer and flushes it as large writes
+  size_t writeBuffered(const uint8_t *data, size_t len) {
+    if (send_buffer.size() == 0) return writeChunk(data, len);
+    size_t pos = 0;
+    while (pos < len) {
+      pos += send_buffer.writeArray(data + pos, len - pos);
+      if (send_buffer.isFull()) flushSendBuffer();
+    }
+    return len;
+  }
+
+  /// Sends the collected data to the client with a single write
+  void flushSendBuffer() {
+    if (send_buffer.available() > 0) {
+      writeChunk(send_buffer.data(), send_buffer.available());
+      send_buffer.reset();
+    }
+  }
+
+  /// Writes one block to the client: in chunked mode it is framed as one
+  /// transfer encoding chunk
+  size_t writeChunk(const uint8_t *data, size_t len) {
+    if (len == 0) return 0;
+    if (is_chunked) {
+      char size_line[12];
+      int line_len =
+          snprintf(size_line, sizeof(size_line), "%X\r\n", (unsigned)len);
+      client_obj.write((const uint8_t *)size_line, line_len);
+    }
+    size_t result = client_obj.write(data, len);
+    if (is_chunked) client_obj.write((const uint8_t *)"\r\n", 2);
+    return result;
+  }
+
+  /// Flushes the pending data and closes the connection
+  void endClient() {
+    flushSendBuffer();
+    if (is_chunked && client_obj.connected()) {
+      // the empty chunk terminates the chunked reply
+      client_obj.write((const uint8_t *)"0\r\n\r\n", 5);
+    }
+    client_obj.stop();
+  }
+
+  /// Formats the complete reply header once into the scratch buffer, so
+  /// that it can be sent with a single write
+  void buildReplyHeader() {
+    char mime_line[120] = {0};
+    if (content_type != nullptr) {
+      snprintf(mime_line, sizeof(mime_line), "Content-Type: %s\r\n",
+               content_type);
+    }
+    const char *transfer = is_chunked ? "Transfer-Encoding: chunked\r\n" : "";
+    int len = snprintf(nullptr, 0, "HTTP/1.1 200 OK\r\n%s%s\r\n", mime_line,
+                       transfer);
+    header_scratch.resize(len + 1);
+    snprintf(header_scratch.data(), len + 1, "HTTP/1.1 200 OK\r\n%s%s\r\n",
+             mime_line, transfer);
+  }
+
 #ifdef USE_WIFI
   void connectWiFi() {
     TRACED();
@@ -212,18 +311,18 @@ class AudioServerT {
   virtual void sendReplyHeader() {
     TRACED();
     // HTTP headers always start with a response code (e.g. HTTP/1.1 200 OK)
-    // and a content-type so the client knows what's coming, then a blank line:
-    client_obj.println("HTTP/1.1 200 OK");
+    // and a content-type so the client knows what's coming, then a blank
+    // line: the preformatted header is sent with a single write
+    buildReplyHeader();
+    client_obj.write((const uint8_t *)header_scratch.data(),
+                     strlen(header_scratch.data()));
     LOGI("Reply: HTTP/1.1 200 OK");
     if (content_type != nullptr) {
-      client_obj.print("Content-type:");
-      client_obj.println(content_type);
       LOGI("Content-type: %s", content_type);
     }
-    client_obj.println();
-      if (!client_obj.connected()){
-        LOGE("connection was closed");
-      }
+    if (!client_obj.connected()){
+      LOGE("connection was closed");
+    }
   }
 
   virtual void sendReplyContent() {
@@ -231,12 +330,12 @@ class AudioServerT {
     if (callback != nullptr) {
       // provide data via Callback
       LOGI("sendReply - calling callback");
-      callback(&client_obj);
-      client_obj.stop();
+      callback(&clientOutput());
+      endClient();
     } else if (in != nullptr) {
       // provide data for stream
       LOGI("sendReply - Returning audio stream...");
-      copier.begin(client_obj, *in);
+      copier.begin(clientOutput(), *in);
       if (!client_obj.connected()){
         LOGE("connection was closed");
       }
@@ -260,6 +359,7 @@ class AudioServerT {
             // row. that's the end of the client HTTP request, so send a
             // response:
             if (currentLine.length() == 0) {
+              send_buffer.reset();
               sendReplyHeader();
               sendReplyContent();
               // break out of the while loop:
@@ -341,7 +441,7 @@ class AudioEncoderServer : public AudioServer {
     audio_info.bits_per_sample = bits_per_sample;
     encoder->setAudioInfo(audio_info);
     // encoded_stream.begin(&client_obj, encoder);
-    encoded_stream.setOutput(&client_obj);
+    encoded_stream.setOutput(&clientOutput());
     encoded_stream.setEncoder(encoder);
     encoded_stream.begin(audio_info);
     return AudioServer::begin(in, encoder->mime());
@@ -361,7 +461,7 @@ class AudioEncoderServer : public AudioServer {
     this->audio_info = info;
     setConverter(converter);
     encoder->setAudioInfo(audio_info);
-    encoded_stream.setOutput(&client_obj);
+    encoded_stream.setOutput(&clientOutput());
     encoded_stream.setEncoder(encoder);
     if (!encoded_stream.begin(audio_info)){
       LOGE("encoder begin failed");
@@ -384,7 +484,7 @@ class AudioEncoderServer : public AudioServer {
     this->audio_info = in.audioInfo();
     setConverter(converter);
     encoder->setAudioInfo(audio_info);
-    encoded_stream.setOutput(&client_obj);
+    encoded_stream.setOutput(&clientOutput());
     encoded_stream.setEncoder(encoder);
     encoded_stream.begin(audio_info);
 
@@ -431,7 +531,7 @@ class AudioEncoderServer : public AudioServer {
 
     if (callback != nullptr) {
       // encoded_stream.begin(out_ptr(), encoder);
-      encoded_stream.setOutput(out_ptr());
+      encoded_stream.setOutput(&clientOutput());
       encoded_stream.setEncoder(encoder);
       encoded_stream.begin();
 
@@ -445,7 +545,7 @@ class AudioEncoderServer : public AudioServer {
       // provide data for stream: in -copy>  encoded_stream -> out
       LOGI("sendReply - Returning encoded stream...");
       // encoded_stream.begin(out_ptr(), encoder);
-      encoded_stream.setOutput(out_ptr());
+      encoded_stream.setOutput(&clientOutput());
       encoded_stream.setEncoder(encoder);
       encoded_stream.begin();
 
@@ -459,6 +559,215 @@ class AudioEncoderServer : public AudioServer {
   }
 };
 
+/**
+ * @brief A Webserver which broadcasts one encoded stream to multiple
+ * clients: the encoder runs exactly once and produces into a shared byte
+ * ring; each connected client keeps its own cursor into the ring and is
+ * served the bytes it has not received yet. A slow client whose cursor
+ * falls out of the ring is skipped forward to the oldest available data
+ * instead of stalling the encode - so N listeners cost one encode.
+ * @ingroup http
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ */
+template <class Client, class Server>
+class AudioEncoderBroadcastServerT {
+ public:
+  /// We assume that the WiFi is already connected
+  AudioEncoderBroadcastServerT(AudioEncoder *encoder, int port = 80)
+      : server(port) {
+    this->encoder = encoder;
+    copier.setCheckAvailableForWrite(false);
+  }
+
+  /// Start the server: the data is read from the indicated stream
+  bool begin(Stream &in, AudioInfo info) {
+    TRACED();
+    this->in = &in;
+    this->audio_info = info;
+    ring.resize(ring_size);
+    encoder->setAudioInfo(info);
+    encoded_stream.setOutput(&ring_writer);
+    encoded_stream.setEncoder(encoder);
+    if (!encoded_stream.begin(info)) {
+      LOGE("encoder begin failed");
+      return false;
+    }
+    copier.begin(encoded_stream, in);
+    server.begin();
+    return true;
+  }
+
+  /// Add this method to your loop: accepts new clients, encodes one block
+  /// and distributes it. Returns true while any client is connected.
+  bool doLoop() {
+    acceptClient();
+    bool any_connected = false;
+    for (int j = 0; j < clients.size(); j++) {
+      if (clients[j].client.connected()) any_connected = true;
+    }
+    if (any_connected) {
+      // single shared encode: in -copy> encoder -> ring
+      copier.copy();
+      serveClients();
+    }
+    cleanupClients();
+    return any_connected;
+  }
+
+  /// Same as doLoop()
+  bool copy() { return doLoop(); }
+
+  /// Defines the size of the shared ring with the encoded data
+  void setBufferSize(int size) { ring_size = size; }
+
+  /// Limits the number of concurrent clients (default 10)
+  void setMaxClients(int max) { max_clients = max; }
+
+  /// Provides the number of connected clients
+  int clientCount() { return clients.size(); }
+
+  // provides a pointer to the encoder
+  AudioEncoder *audioEncoder() { return encoder; }
+
+ protected:
+  /// A connected client and its absolute read position in the ring
+  struct ClientCursor {
+    Client client;
+    uint32_t pos = 0;
+  };
+
+  /// Print adapter which appends the encoder output to the shared ring
+  class RingWriter : public Print {
+   public:
+    RingWriter(AudioEncoderBroadcastServerT &server) { p_server = &server; }
+    size_t write(const uint8_t *data, size_t len) override {
+      return p_server->writeRing(data, len);
+    }
+    size_t write(uint8_t c) override { return write(&c, 1); }
+
+   protected:
+    AudioEncoderBroadcastServerT *p_server = nullptr;
+  };
+
+  Server server;
+  Vector<ClientCursor> clients;
+  Vector<uint8_t> ring{0};
+  RingWriter ring_writer{*this};
+  EncodedAudioOutput encoded_stream;
+  StreamCopy copier;
+  AudioEncoder *encoder = nullptr;
+  Stream *in = nullptr;
+  AudioInfo audio_info;
+  uint32_t write_pos = 0;  // absolute position of the encoder output
+  int ring_size = 1024 * 8;
+  int max_clients = 10;
+
+  /// Appends the encoded data to the ring (absolute positions, the ring
+  /// just stores the last ring_size bytes)
+  size_t writeRing(const uint8_t *data, size_t len) {
+    for (size_t j = 0; j < len; j++) {
+      ring[write_pos % ring_size] = data[j];
+      write_pos++;
+    }
+    return len;
+  }
+
+  /// Accepts a new client: reads the request, sends the reply header and
+  /// registers the cursor at the current encoder position
+  void acceptClient() {
+#if USE_SERVER_ACCEPT
+    Client new_client = server.accept();
+#else
+    Client new_client = server.available();
+#endif
+    if (!new_client) return;
+    if (clients.size() >= max_clients) {
+      LOGW("max clients reached");
+      new_client.stop();
+      return;
+    }
+    LOGI("New Client:");
+    readRequest(new_client);
+    sendReplyHeader(new_client);
+    ClientCursor cursor;
+    cursor.client = new_client;
+    // new clients start at the live position
+    cursor.pos = write_pos;
+    clients.push_back(cursor);
+  }
+
+  /// Reads the HTTP request up to the empty line
+  void readRequest(Client &client) {
+    String current_line = "";
+    while (client.connected()) {
+      if (client.available()) {
+        char c = client.read();
+        if (c == '\n') {
+          if (current_line.length() == 0) break;
+          LOGI("Request: %s", current_line.c_str());
+          current_line = "";
+        } else if (c != '\r') {
+          current_line += c;
+        }
+      }
+    }
+  }
+
+  void sendReplyHeader(Client &client) {
+    char header[160];
+    int len = snprintf(header, sizeof(header),
+                       "HTTP/1.1 200 OK\r\nContent-Type: %s\r\n\r\n",
+                       encoder->mime());
+    client.write((const uint8_t *)header, len);
+  }
+
+  /// Writes the pending ring content to each client from its own cursor
+  void serveClients() {
+    for (int j = 0; j < clients.size(); j++) {
+      ClientCursor &cursor = clients[j];
+      if (!cursor.client.connected()) continue;
+      uint32_t pending = write_pos - cursor.pos;
+      if (pending > (uint32_t)ring_size) {
+        // the client is too slow: skip forward to the oldest valid byte
+        LOGW("client %d is behind: skipping %d bytes", j,
+             (int)(pending - ring_size));
+        cursor.pos = write_pos - ring_size;
+        pending = ring_size;
+      }
+      while (pending > 0) {
+        uint32_t start = cursor.pos % ring_size;
+        uint32_t n = min(pending, (uint32_t)(ring_size - start));
+        size_t written = cursor.client.write(ring.data() + start, n);
+        cursor.pos += written;
+        pending -= written;
+        if (written < n) break;  // client cannot take more right now
+      }
+    }
+  }
+
+  /// Removes the disconnected clients
+  void cleanupClients() {
+    for (int j = clients.size() - 1; j >= 0; j--) {
+      if (!clients[j].client.connected()) {
+        LOGI("client %d disconnected", j);
+        clients[j].client.stop();
+        clients.erase(j);
+      }
+    }
+  }
+};
+
+#ifdef USE_WIFI
+using AudioEncoderBroadcastServer =
+    AudioEncoderBroadcastServerT<WiFiClient, WiFiServer>;
+#endif
+
+#if defined(USE_ETHERNET) && !defined(USE_WIFI)
+using AudioEncoderBroadcastServer =
+    AudioEncoderBroadcastServerT<EthernetClient, EthernetServer>;
+#endif
+
 /**
  * @brief A simple Arduino Webserver which streams the audio as WAV data.
  * This class is based on the AudioEncodedServer class. All you need to do is to
@@ -32,24 +32,35 @@ class HttpChunkReader : public HttpLineReader {
     readChunkLen(client);
   }
 
-  // reads a block of data from the chunks
+  // reads a block of data from the chunks: the chunk bodies are read with
+  // bulk transfers directly into the provided buffer - only the chunk size
+  // lines are parsed byte-wise. A single call crosses chunk boundaries as
+  // long as the data has already arrived, so the caller's buffer is filled
+  // like with a content-length reply.
   virtual int read(Client &client, uint8_t *str, int len) {
     LOGD("HttpChunkReader: %s", "read");
-    if (has_ended && open_chunk_len == 0) return 0;
-
-    // read the chunk data - but not more then available
-    int read_max = len < open_chunk_len ? len : open_chunk_len;
-    int len_processed = client.read(str, read_max);
-    // update current unprocessed chunk
-    open_chunk_len -= len_processed;
-
-    // remove traling CR LF from data
-    if (open_chunk_len <= 0) {
-      removeCRLF(client);
-      readChunkLen(client);
+    int total = 0;
+    while (total < len && !(has_ended && open_chunk_len == 0)) {
+      // read the chunk data - but not more then available
+      int read_max = len - total < open_chunk_len ? len - total : open_chunk_len;
+      int len_processed = client.read(str + total, read_max);
+      if (len_processed < 0) len_processed = 0;
+      // update current unprocessed chunk
+      open_chunk_len -= len_processed;
+      total += len_processed;
+
+      // remove traling CR LF from data
+      if (open_chunk_len <= 0) {
+        removeCRLF(client);
+        readChunkLen(client);
+        // continue with the next chunk only if its data is already waiting
+        if (client.available() == 0) break;
+      } else if (len_processed < read_max) {
+        // no more data on the socket right now
+        break;
+      }
     }
-
-    return len_processed;
+    return total;
   }
 
   // reads a single line from the chunks
@@ -83,7 +94,7 @@ class HttpChunkReader : public HttpLineReader {
  protected:
   int open_chunk_len;
   bool has_ended = false;
-  HttpReplyHeader *http_heaer_ptr;
+  HttpReplyHeader *http_heaer_ptr = nullptr;
 
   void removeCRLF(Client &client) {
     LOGD("HttpChunkReader: %s", "removeCRLF");
@@ -68,16 +68,22 @@ class HttpHeader {
   ~HttpHeader() {
     LOGD("~HttpHeader");
     clear();
+    // release the pooled header lines
+    for (auto& ptr : unused_lines) {
+      delete ptr;
+    }
+    unused_lines.clear();
   }
 
-  /// clears the data
+  /// clears the data: the header line objects are recycled via a pool, so
+  /// frequent reconnects do not allocate any heap after warm-up
   HttpHeader& clear() {
     is_written = false;
     is_chunked = false;
     url_path = "/";
-    // delete HttpHeaderLine objects
-    for (auto& ptr : lines){
-      delete ptr;
+    // move HttpHeaderLine objects to the pool
+    for (auto& ptr : lines) {
+      releaseHeaderLine(ptr);
     }
     lines.clear();
     return *this;
@@ -304,6 +310,9 @@ class HttpHeader {
     temp_buffer.resize(bufferSize);
   }
 
+  /// Defines the max number of header line objects that are kept for reuse
+  void setHeaderLinePoolSize(int size) { max_pooled_lines = size; }
+
   /// Provides the http parameter lines
   List<HttpHeaderLine*> &getHeaderLines(){
     return lines;
@@ -322,6 +331,9 @@ class HttpHeader {
   Str url_path{70};
   Str status_msg{20};
   List<HttpHeaderLine*> lines;
+  // pool of recycled header lines to avoid heap churn on reconnects
+  List<HttpHeaderLine*> unused_lines;
+  int max_pooled_lines = 20;
   HttpLineReader reader;
   const char* CRLF = "\r\n";
   int timeout_ms = URL_CLIENT_TIMEOUT;
@@ -351,7 +363,7 @@ class HttpHeader {
       }
       if (create_new_lines || StrView(key).equalsIgnoreCase(CONTENT_LENGTH) ||
           StrView(key).equalsIgnoreCase(CONTENT_TYPE)) {
-        HttpHeaderLine *new_line = new HttpHeaderLine(key);    
+        HttpHeaderLine* new_line = createHeaderLine(key);
         lines.push_back(new_line);
         return new_line;
       }
@@ -361,6 +373,28 @@ class HttpHeader {
     return nullptr;
   }
 
+  /// provides a header line from the pool - or allocates a new one
+  HttpHeaderLine* createHeaderLine(const char* key) {
+    HttpHeaderLine* result = nullptr;
+    if (unused_lines.pop_back(result)) {
+      result->key = key;
+      result->value = "";
+      result->active = true;
+      return result;
+    }
+    return new HttpHeaderLine(key);
+  }
+
+  /// returns a header line to the pool; surplus lines are deleted
+  void releaseHeaderLine(HttpHeaderLine* line) {
+    if (line == nullptr) return;
+    if ((int)unused_lines.size() < max_pooled_lines) {
+      unused_lines.push_back(line);
+    } else {
+      delete line;
+    }
+  }
+
   MethodID getMethod(const char* line) {
     // set action
     for (int j = 0; methods[j] != nullptr; j++) {
@@ -337,6 +337,15 @@ class HttpRequest : public BaseStream {
   /// Defines the client timeout in ms
   void setTimeout(int timeoutMs) { clientTimeout = timeoutMs; }
 
+  /// Defines an optional resolver which e.g. provides a cached textual ip
+  /// for a host: when it returns a result the client connects to that
+  /// address instead of doing its own dns lookup
+  void setDNSResolver(const char* (*resolver)(const char* host, void* ref),
+                      void* ref = nullptr) {
+    dns_resolver = resolver;
+    dns_resolver_ref = ref;
+  }
+
   /// we are sending the data chunked
   bool isChunked() { return request_header.isChunked(); }
 
@@ -356,6 +365,8 @@ class HttpRequest : public BaseStream {
   void (*http_connect_callback)(HttpRequest &request, Url &url,
                                 HttpRequestHeader &request_header) = nullptr;
   bool is_chunked_output_active = false;
+  const char *(*dns_resolver)(const char *host, void *ref) = nullptr;
+  void *dns_resolver_ref = nullptr;
 
   // opens a connection to the indicated host
   virtual int connect(const char *ip, uint16_t port, int32_t timeout) {
@@ -363,7 +374,15 @@ class HttpRequest : public BaseStream {
     client_ptr->setTimeout(timeout / 1000);  // client timeout is in seconds!
     request_header.setTimeout(timeout);
     reply_header.setTimeout(timeout);
-    int is_connected = this->client_ptr->connect(ip, port);
+    const char *target = ip;
+    if (dns_resolver != nullptr) {
+      const char *resolved = dns_resolver(ip, dns_resolver_ref);
+      if (resolved != nullptr) {
+        LOGI("using resolved address %s for %s", resolved, ip);
+        target = resolved;
+      }
+    }
+    int is_connected = this->client_ptr->connect(target, port);
     LOGI("is connected %s  with timeout %d", is_connected ? "true" : "false", (int)timeout);
     return is_connected;
   }
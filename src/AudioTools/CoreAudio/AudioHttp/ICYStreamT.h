@@ -70,6 +70,9 @@ namespace audio_tools {
       icySetup.executeCallback(callback);
       icy.setIcyMetaInt(iceMetaint);
       icy.begin();
+      // the first metadata block starts after metaint audio bytes
+      meta_int = iceMetaint;
+      data_remaining = iceMetaint;
 
       if (!icy.hasMetaData()) {
         LOGW("url does not provide metadata");
@@ -88,21 +91,21 @@ namespace audio_tools {
   /// provides the available method from the URLStream
   virtual int available() override { return url.available(); }
 
-  /// reads the audio bytes
+  /// reads the audio bytes: since metaint is fixed per connection the
+  /// audio is passed thru in bulk transfers and the metadata is only
+  /// parsed at the exact block boundary
   virtual size_t readBytes(uint8_t* data, size_t len) override {
     size_t result = 0;
     if (icy.hasMetaData()) {
-      // get data
-      int read = url.readBytes(data, len);
-      // remove metadata from data
-      int pos = 0;
-      for (int j = 0; j < read; j++) {
-        icy.processChar(data[j]);
-        if (icy.isData()) {
-          data[pos++] = data[j];
-        }
+      // at the block boundary: consume the metadata before the audio
+      if (data_remaining <= 0) {
+        if (!readMetaData()) return 0;
+        data_remaining = meta_int;
       }
-      result = pos;
+      // pass the audio thru untouched up to the next boundary
+      size_t to_read = min(len, (size_t)data_remaining);
+      result = url.readBytes(data, to_read);
+      data_remaining -= result;
     } else {
       // fast access if there is no metadata
       result = url.readBytes(data, len);
@@ -111,19 +114,10 @@ namespace audio_tools {
     return result;
   }
 
-  // Read character and processes using the MetaDataICY state engine
+  // Reads a single character: the block accounting is handled by readBytes
   virtual int read() override {
-    int ch = -1;
-
-    // get next data byte
-    do {
-      ch = url.read();
-      if (ch == -1) {
-        break;
-      }
-
-      icy.processChar(ch);
-    } while (!icy.isData());
+    uint8_t ch = 0;
+    if (readBytes(&ch, 1) != 1) return -1;
     return ch;
   }
 
@@ -163,9 +157,38 @@ namespace audio_tools {
   void setClient(Client& client) override { url.setClient(client); }
 
  protected:
+  /// Provides access to the protected metadata parsing of MetaDataICY
+  struct MetaDataICYBlock : public MetaDataICY {
+    using MetaDataICY::processMetaData;
+  };
+
   T url;
-  MetaDataICY icy;  // icy state machine
+  MetaDataICYBlock icy;  // icy metadata parser
   void (*callback)(MetaDataType info, const char* str, int len) = nullptr;
+  Vector<char> meta_buffer{0};
+  int meta_int = 0;
+  int data_remaining = 0;
+
+  /// Reads the complete metadata block at the metaint boundary and parses
+  /// it with the help of the MetaDataICY logic
+  bool readMetaData() {
+    uint8_t size_byte = 0;
+    if (url.readBytes(&size_byte, 1) != 1) return false;
+    int meta_len = size_byte * 16;
+    if (meta_len > 0) {
+      meta_buffer.resize(meta_len + 1);
+      int pos = 0;
+      while (pos < meta_len) {
+        int read = url.readBytes((uint8_t*)meta_buffer.data() + pos,
+                                 meta_len - pos);
+        if (read <= 0) return false;
+        pos += read;
+      }
+      meta_buffer[meta_len] = 0;
+      icy.processMetaData(meta_buffer.data(), meta_len);
+    }
+    return true;
+  }
 };
 
 }
@@ -0,0 +1,360 @@
+#pragma once
+
+#include "AudioConfig.h"
+#ifdef USE_URL_ARDUINO
+
+#include "AudioTools/CoreAudio/AudioHttp/URLStream.h"
+
+#ifndef RANGE_URL_CHUNK_SIZE
+#define RANGE_URL_CHUNK_SIZE (64 * 1024)
+#endif
+
+namespace audio_tools {
+
+/**
+ * @brief Provides the content of a large URL as Stream by requesting it as
+ * consecutive HTTP Range chunks over multiple parallel tcp connections.
+ * While one chunk is consumed, the replies for the following chunks are
+ * already arriving on the other sockets, so the round trip and (tls) window
+ * limits of a single connection no longer cap the throughput. The connections
+ * are kept open across the chunk requests, therefore the tls handshake is
+ * only paid once per connection. If the server does not support range
+ * requests (no 206 reply) we fall back to a regular single connection
+ * download. Use RangeURLStreamBuffered if you want the data to be prefetched
+ * into a ring buffer by a separate task.
+ * @author Phil Schatzmann
+ * @ingroup http
+ * @copyright GPLv3
+ */
+class RangeURLStream : public AbstractURLStream {
+ public:
+  RangeURLStream(int connectionCount = 2,
+                 int chunkSize = RANGE_URL_CHUNK_SIZE) {
+    TRACED();
+    setConnectionCount(connectionCount);
+    setChunkSize(chunkSize);
+  }
+
+  RangeURLStream(const char* network, const char* password,
+                 int connectionCount = 2,
+                 int chunkSize = RANGE_URL_CHUNK_SIZE) {
+    TRACED();
+    setConnectionCount(connectionCount);
+    setChunkSize(chunkSize);
+    setSSID(network);
+    setPassword(password);
+  }
+
+  RangeURLStream(const RangeURLStream&) = delete;
+
+  ~RangeURLStream() {
+    end();
+    for (auto* con : connections) delete con;
+    connections.clear();
+  }
+
+  /// Defines the number of parallel connections (before calling begin)
+  void setConnectionCount(int count) {
+    if (count < 1) count = 1;
+    connection_count = count;
+  }
+
+  /// Defines the size of the individual range requests (before calling begin)
+  void setChunkSize(int size) { chunk_size = size; }
+
+  /// Sets the ssid that will be used for logging in (when calling begin)
+  void setSSID(const char* ssid) override { this->network = ssid; }
+
+  /// Sets the password that will be used for logging in (when calling begin)
+  void setPassword(const char* password) override { this->password = password; }
+
+  /// if set to true, it activates the power save mode which comes at the cost
+  /// of performance! - By default this is deactivated. ESP32 Only!
+  void setPowerSave(bool ps) override { is_power_save = ps; }
+
+  /// Define the Root PEM Certificate for SSL
+  void setCACert(const char* cert) override {
+    ca_cert = cert;
+    for (auto* con : connections) con->stream.setCACert(cert);
+  }
+
+  /// Not supported: each connection creates its own client
+  void setClient(Client& clientPar) override {
+    LOGE("setClient is not supported: each connection uses its own client");
+  }
+
+  /// Defines the client timeout
+  void setTimeout(int ms) { client_timeout = ms; }
+
+  /// Defines the buffer that is used by individual read() or peek() calls
+  void setReadBufferSize(int readBufferSize) {
+    read_buffer_size = readBufferSize;
+  }
+
+  /// Execute http request: only GET requests are supported
+  bool begin(const char* urlStr, const char* acceptMime = nullptr,
+             MethodID action = GET, const char* reqMime = "",
+             const char* reqData = "") override {
+    LOGI("%s: %s", LOG_METHOD, urlStr);
+    if (action != GET) {
+      LOGE("only GET requests are supported");
+      return false;
+    }
+    end();
+    url_str = urlStr;
+    accept_mime = acceptMime;
+    setupConnections();
+
+    // probe with the first chunk: a 206 reply confirms range support
+    RangeConnection& first = *connections[0];
+    if (!startChunk(first, 0, chunk_size)) {
+      LOGE("request failed");
+      return false;
+    }
+    int status = first.stream.httpRequest().reply().statusCode();
+    if (status == 206) {
+      total_size = parseTotalSize(first.stream);
+      if (total_size < 0) {
+        LOGW("no total size in Content-Range: using single connection");
+        is_fallback = true;
+      }
+    } else {
+      LOGW("no range support (status %d): using single connection", status);
+      is_fallback = true;
+      total_size = first.stream.contentLength();
+    }
+
+    // issue the requests for the next chunks on the other connections
+    if (!is_fallback) {
+      for (int j = 1; j < (int)connections.size(); j++) {
+        if (next_start >= total_size) break;
+        startChunk(*connections[j], next_start,
+                   chunkLength(next_start));
+      }
+    }
+    current = 0;
+    active = true;
+    return true;
+  }
+
+  void end() override {
+    for (auto* con : connections) {
+      con->stream.end();
+      con->length = 0;
+      con->read = 0;
+    }
+    active = false;
+    is_fallback = false;
+    has_peek = false;
+    total_size = -1;
+    next_start = 0;
+    total_read = 0;
+  }
+
+  int available() override {
+    if (!active) return 0;
+    if (has_peek) return 1;
+    if (is_fallback) return connections[0]->stream.available();
+    RangeConnection* con = currentConnection();
+    if (con == nullptr) return 0;
+    long remaining = con->length - con->read;
+    int result = con->stream.available();
+    if (result > remaining) result = remaining;
+    return result;
+  }
+
+  size_t readBytes(uint8_t* data, size_t len) override {
+    if (!active || len == 0) return 0;
+    size_t result = 0;
+    if (has_peek) {
+      data[0] = peek_byte;
+      has_peek = false;
+      result = 1;
+      data++;
+      len--;
+      if (len == 0) return result;
+    }
+    if (is_fallback) {
+      result += connections[0]->stream.readBytes(data, len);
+      total_read += result;
+      return result;
+    }
+    RangeConnection* con = currentConnection();
+    if (con == nullptr) return result;
+    long remaining = con->length - con->read;
+    if ((long)len > remaining) len = remaining;
+    size_t n = con->stream.readBytes(data, len);
+    con->read += n;
+    total_read += n;
+    result += n;
+    LOGD("readBytes %d -> %d", (int)len, (int)n);
+    return result;
+  }
+
+  int read() override {
+    uint8_t c;
+    return readBytes(&c, 1) == 1 ? c : -1;
+  }
+
+  int peek() override {
+    if (!has_peek) {
+      has_peek = readBytes(&peek_byte, 1) == 1;
+    }
+    return has_peek ? peek_byte : -1;
+  }
+
+  void flush() override {}
+
+  size_t write(uint8_t) override { return not_supported(0); }
+
+  size_t write(const uint8_t*, size_t len) override {
+    return not_supported(0);
+  }
+
+  /// Adds/Updates a request header which is resubmitted with each chunk
+  void addRequestHeader(const char* header, const char* value) override {
+    for (auto& line : request_headers) {
+      if (line.key.equals(header)) {
+        line.value = value;
+        return;
+      }
+    }
+    HeaderLine line;
+    line.key = header;
+    line.value = value;
+    request_headers.push_back(line);
+  }
+
+  const char* getReplyHeader(const char* header) override {
+    if (connections.empty()) return nullptr;
+    return connections[0]->stream.getReplyHeader(header);
+  }
+
+  /// provides access to the HttpRequest of the first connection
+  HttpRequest& httpRequest() override {
+    return connections[0]->stream.httpRequest();
+  }
+
+  operator bool() { return active; }
+
+  /// provides the total size of the requested file
+  int contentLength() { return total_size; }
+
+  size_t totalRead() { return total_read; }
+
+ protected:
+  struct HeaderLine {
+    Str key;
+    Str value;
+  };
+
+  /// A connection which downloads one chunk at a time
+  struct RangeConnection {
+    URLStream stream;
+    long start = 0;   // absolute position of the current chunk
+    long length = 0;  // size of the current chunk
+    long read = 0;    // bytes consumed from the current chunk
+  };
+
+  Vector<RangeConnection*> connections;
+  Vector<HeaderLine> request_headers;
+  Str url_str;
+  const char* accept_mime = nullptr;
+  const char* network = nullptr;
+  const char* password = nullptr;
+  const char* ca_cert = nullptr;
+  int connection_count = 2;
+  int chunk_size = RANGE_URL_CHUNK_SIZE;
+  int client_timeout = URL_CLIENT_TIMEOUT;
+  int read_buffer_size = DEFAULT_BUFFER_SIZE;
+  long total_size = -1;
+  long next_start = 0;
+  size_t total_read = 0;
+  int current = 0;
+  bool active = false;
+  bool is_fallback = false;
+  bool is_power_save = false;
+  bool has_peek = false;
+  uint8_t peek_byte = 0;
+
+  /// Creates the connections: they are reused across begin() calls
+  void setupConnections() {
+    while ((int)connections.size() < connection_count) {
+      RangeConnection* con = new RangeConnection();
+      // keep the sockets open, so the (tls) handshake is only paid once
+      con->stream.setReuseConnection(true);
+      con->stream.setTimeout(client_timeout);
+      con->stream.setReadBufferSize(read_buffer_size);
+      con->stream.setPowerSave(is_power_save);
+      if (network != nullptr) con->stream.setSSID(network);
+      if (password != nullptr) con->stream.setPassword(password);
+      if (ca_cert != nullptr) con->stream.setCACert(ca_cert);
+      connections.push_back(con);
+    }
+  }
+
+  /// Provides the length for the chunk starting at the indicated position
+  long chunkLength(long start) {
+    long result = chunk_size;
+    if (total_size >= 0 && start + result > total_size) {
+      result = total_size - start;
+    }
+    return result;
+  }
+
+  /// Requests the chunk [start, start+length) on the indicated connection
+  bool startChunk(RangeConnection& con, long start, long length) {
+    char range[50];
+    snprintf(range, sizeof(range), "bytes=%ld-%ld", start, start + length - 1);
+    LOGI("range request: %s", range);
+    for (auto& line : request_headers) {
+      con.stream.addRequestHeader(line.key.c_str(), line.value.c_str());
+    }
+    con.stream.addRequestHeader("Range", range);
+    bool ok = con.stream.begin(url_str.c_str(), accept_mime, GET);
+    con.start = start;
+    con.length = ok ? con.stream.contentLength() : 0;
+    // some servers do not report a length: trust the requested range
+    if (ok && con.length <= 0) con.length = length;
+    con.read = 0;
+    next_start = start + length;
+    return ok;
+  }
+
+  /// Provides the connection holding the next sequential chunk: finished
+  /// chunks trigger the request for the next unassigned chunk
+  RangeConnection* currentConnection() {
+    for (int j = 0; j < (int)connections.size(); j++) {
+      RangeConnection& con = *connections[current];
+      if (con.read < con.length) return &con;
+      // chunk consumed: reuse the connection for the next pending chunk
+      if (next_start < total_size) {
+        startChunk(con, next_start, chunkLength(next_start));
+      } else {
+        con.length = 0;
+        con.read = 0;
+      }
+      current = (current + 1) % connections.size();
+    }
+    // all chunks are consumed
+    return nullptr;
+  }
+
+  /// Determines the total size from the Content-Range reply header
+  long parseTotalSize(URLStream& stream) {
+    const char* content_range = stream.getReplyHeader("Content-Range");
+    if (content_range == nullptr) return -1;
+    const char* slash = strchr(content_range, '/');
+    if (slash == nullptr || slash[1] == '*') return -1;
+    return atol(slash + 1);
+  }
+};
+
+#if defined(USE_CONCURRENCY)
+/// RangeURLStream with a task which prefetches the data into a ring buffer
+using RangeURLStreamBuffered = URLStreamBufferedT<RangeURLStream>;
+#endif
+
+}  // namespace audio_tools
+
+#endif
@@ -19,6 +19,169 @@
 
 namespace audio_tools {
 
+#ifdef USE_WIFI
+/**
+ * @brief Small DNS cache with expiry: host names are resolved with
+ * WiFi.hostByName and the textual ip is kept for the configured time to
+ * live, so that repeated connects to the same host skip the lookup. The
+ * lookup API does not report the record ttl, therefore the expiry time is
+ * configurable.
+ * @author Phil Schatzmann
+ * @ingroup http
+ * @copyright GPLv3
+ */
+class URLDNSCache {
+ public:
+  /// Defines the time to live of a cache entry in seconds
+  void setTTL(uint32_t seconds) { ttl_ms = seconds * 1000; }
+
+  /// Defines the maximum number of cached hosts
+  void setMaxEntries(int max) {
+    if (used > max) used = max;
+    max_entries = max;
+  }
+
+  /// Resolves the host to a textual ip: returns nullptr if the lookup fails
+  const char* resolve(const char* host) {
+    if (host == nullptr) return nullptr;
+    if (entries.size() != max_entries) entries.resize(max_entries);
+    uint32_t now = millis();
+    for (int j = 0; j < used; j++) {
+      Entry& entry = entries[j];
+      if (strcmp(entry.host, host) == 0) {
+        if (now < entry.expires_at) {
+          LOGD("dns cache hit: %s -> %s", host, entry.ip);
+          return entry.ip;
+        }
+        return lookup(entry, host, now);
+      }
+    }
+    // new host: drop the oldest entry when the cache is full
+    int idx;
+    if (used < max_entries) {
+      idx = used++;
+    } else {
+      for (int j = 1; j < max_entries; j++) entries[j - 1] = entries[j];
+      idx = max_entries - 1;
+    }
+    return lookup(entries[idx], host, now);
+  }
+
+  /// Removes all cached entries
+  void clear() { used = 0; }
+
+ protected:
+  /// POD entry: must stay trivially copyable since the Vector moves the
+  /// entries around on eviction
+  struct Entry {
+    char host[80] = {0};
+    char ip[46] = {0};
+    uint32_t expires_at = 0;
+  };
+  Vector<Entry> entries;
+  uint32_t ttl_ms = 300 * 1000;
+  int max_entries = 4;
+  int used = 0;
+
+  const char* lookup(Entry& entry, const char* host, uint32_t now) {
+    IPAddress addr;
+    if (WiFi.hostByName(host, addr) != 1) {
+      LOGW("dns lookup failed: %s", host);
+      return nullptr;
+    }
+    strncpy(entry.host, host, sizeof(entry.host) - 1);
+    entry.host[sizeof(entry.host) - 1] = 0;
+    strncpy(entry.ip, addr.toString().c_str(), sizeof(entry.ip) - 1);
+    entry.ip[sizeof(entry.ip) - 1] = 0;
+    entry.expires_at = now + ttl_ms;
+    LOGI("dns cache: %s -> %s", host, entry.ip);
+    return entry.ip;
+  }
+};
+#endif
+
+// The BearSSL based cores (ESP8266, Pico W) expose the TLS session of a
+// secure client, so that a reconnect can resume it instead of paying the
+// full handshake. The ESP32 WiFiClientSecure does not provide a session API.
+#if defined(USE_WIFI_CLIENT_SECURE) && \
+    (defined(ESP8266) || defined(ARDUINO_RASPBERRY_PI_PICO_W) || \
+     defined(ARDUINO_ARCH_RP2040))
+#  define USE_TLS_SESSION_CACHE
+#endif
+
+#ifdef USE_TLS_SESSION_CACHE
+/**
+ * @brief TLS session cache keyed by host: each host gets its own session
+ * object which the secure client fills on the first handshake and resumes
+ * on the following connects - cutting the reconnect time from a full
+ * handshake to a session resumption.
+ * @author Phil Schatzmann
+ * @ingroup http
+ * @copyright GPLv3
+ */
+class TLSSessionCache {
+ public:
+  ~TLSSessionCache() { clear(); }
+
+  /// Defines the maximum number of cached hosts
+  void setMaxEntries(int max) {
+    // when shrinking drop the oldest surplus entries
+    while (used > max && used > 0) {
+      delete entries[0].session;
+      for (int j = 1; j < used; j++) entries[j - 1] = entries[j];
+      used--;
+    }
+    max_entries = max;
+    entries.resize(max);
+  }
+
+  /// Provides the session for the host: a new (empty) session is created
+  /// for a host which was not seen yet
+  BearSSL::Session* get(const char* host) {
+    if (host == nullptr) return nullptr;
+    if (entries.size() != max_entries) entries.resize(max_entries);
+    for (int j = 0; j < used; j++) {
+      if (strcmp(entries[j].host, host) == 0) {
+        LOGD("tls session cache hit: %s", host);
+        return entries[j].session;
+      }
+    }
+    // new host: drop the oldest entry when the cache is full
+    int idx;
+    if (used < max_entries) {
+      idx = used++;
+    } else {
+      delete entries[0].session;
+      for (int j = 1; j < max_entries; j++) entries[j - 1] = entries[j];
+      idx = max_entries - 1;
+    }
+    Entry& entry = entries[idx];
+    strncpy(entry.host, host, sizeof(entry.host) - 1);
+    entry.host[sizeof(entry.host) - 1] = 0;
+    entry.session = new BearSSL::Session();
+    LOGI("tls session cache: new entry for %s", host);
+    return entry.session;
+  }
+
+  /// Removes all cached sessions
+  void clear() {
+    for (int j = 0; j < used; j++) delete entries[j].session;
+    used = 0;
+  }
+
+ protected:
+  /// POD entry: must stay trivially copyable since the Vector moves the
+  /// entries around on eviction
+  struct Entry {
+    char host[80] = {0};
+    BearSSL::Session* session = nullptr;
+  };
+  Vector<Entry> entries;
+  int max_entries = 4;
+  int used = 0;
+};
+#endif
+
 /**
  * @brief Represents the content of a URL as Stream. We use the WiFi.h API.
  * If you run into performance issues, check if the data is provided chunked.
@@ -101,7 +264,9 @@ class URLStream : public AbstractURLStream {
       }
     }
     total_read = 0;
-    active = result == 200;
+    recordConnection();
+    // 206 is returned for requests with a Range header
+    active = result == 200 || result == 206;
     LOGI("==> http status: %d", result);
 #if USE_AUDIO_LOGGING && !defined(USE_IDF_LOGGER)
     custom_log_level.reset();
@@ -127,7 +292,8 @@ class URLStream : public AbstractURLStream {
       }
     }
     total_read = 0;
-    active = result == 200;
+    recordConnection();
+    active = result == 200 || result == 206;
     LOGI("==> http status: %d", result);
 #if USE_AUDIO_LOGGING && !defined(USE_IDF_LOGGER)
     custom_log_level.reset();
@@ -136,7 +302,14 @@ class URLStream : public AbstractURLStream {
   }
 
   virtual void end() override {
-    if (active) request.stop();
+    if (active) {
+      if (keepConnectionOpen()) {
+        LOGI("keeping connection to %s:%d open", last_host.c_str(),
+             (int)last_port);
+      } else {
+        request.stop();
+      }
+    }
     active = false;
     clear();
   }
@@ -210,6 +383,35 @@ class URLStream : public AbstractURLStream {
     httpRequest().setConnection(close ? CON_CLOSE : CON_KEEP_ALIVE);
   }
 
+  /// Keeps the tcp connection open across begin() calls, so that consecutive
+  /// requests to the same host and port skip the connection setup
+  void setReuseConnection(bool active) {
+    is_reuse_connection = active;
+    if (active) setConnectionClose(false);
+  }
+
+#ifdef USE_WIFI
+  /// Activates a DNS cache, so that repeated connects to the same host skip
+  /// the lookup for the indicated time to live
+  void setDNSCache(bool active, uint32_t ttlSeconds = 300) {
+    is_dns_cache = active;
+    dns_cache.setTTL(ttlSeconds);
+    if (!active) dns_cache.clear();
+  }
+#endif
+
+  /// Activates a per host TLS session cache, so that reconnects resume the
+  /// session instead of paying the full handshake. Only effective on cores
+  /// whose secure client exposes sessions (ESP8266, Pico W)
+  void setTLSSessionCache(bool active) {
+#ifdef USE_TLS_SESSION_CACHE
+    is_tls_session_cache = active;
+    if (!active) tls_session_cache.clear();
+#else
+    if (active) LOGW("TLS session cache not supported on this platform");
+#endif
+  }
+
   /// Releases the memory from the request and reply
   void clear() {
     httpRequest().reply().clear();
@@ -302,6 +504,20 @@ class URLStream : public AbstractURLStream {
   int clientTimeout = URL_CLIENT_TIMEOUT;                  // 60000;
   unsigned long handshakeTimeout = URL_HANDSHAKE_TIMEOUT;  // 120000
   bool is_power_save = false;
+  // connection reuse
+  bool is_reuse_connection = false;
+  Str last_host;
+  int last_port = 0;
+  bool last_secure = false;
+  int reuse_drain_limit = 16 * 1024;
+#ifdef USE_WIFI
+  bool is_dns_cache = false;
+  URLDNSCache dns_cache;
+#ifdef USE_TLS_SESSION_CACHE
+  bool is_tls_session_cache = false;
+  TLSSessionCache tls_session_cache;
+#endif
+#endif
 
   bool preProcess(const char* urlStr, const char* acceptMime) {
     TRACED();
@@ -315,6 +531,20 @@ class URLStream : public AbstractURLStream {
     // close it - if we have an active connection
     if (active) end();
 
+    // a connection which was kept open can only be reused for the same
+    // host, port and scheme
+    if (request.connected() && !isSameConnection()) {
+      LOGI("closing connection to previous host");
+      request.stop();
+    }
+
+#ifdef USE_WIFI
+    // the dns cache is only used for http: connecting https via the ip
+    // would break the certificate host check
+    request.setDNSResolver(
+        is_dns_cache && !url.isSecure() ? resolveDNS : nullptr, this);
+#endif
+
 #ifdef USE_WIFI
     // optional: login if necessary if no external client is defined
     if (client == nullptr){
@@ -383,6 +613,53 @@ class URLStream : public AbstractURLStream {
     return status_code;
   }
 
+  /// Checks if the open connection matches the current url
+  bool isSameConnection() {
+    return is_reuse_connection && last_host.equals(url.host()) &&
+           last_port == url.port() && last_secure == url.isSecure();
+  }
+
+  /// Records the connection endpoint (after redirects) for the reuse check
+  void recordConnection() {
+    last_host = url.host();
+    last_port = url.port();
+    last_secure = url.isSecure();
+  }
+
+  /// Tries to drain the remaining reply body, so that the connection can be
+  /// reused for the next request: returns false when the connection has to
+  /// be closed instead
+  bool keepConnectionOpen() {
+    if (!is_reuse_connection) return false;
+    if (!request.connected()) return false;
+    // the server might have requested a close
+    const char* con = request.reply().get(CONNECTION);
+    if (con != nullptr && StrView(con).equalsIgnoreCase(CON_CLOSE))
+      return false;
+    // without a content length (e.g. chunked) we can not find the body end
+    if (size <= 0) return false;
+    long remaining = size - total_read;
+    if (remaining < 0 || remaining > reuse_drain_limit) return false;
+    uint8_t tmp[128];
+    uint32_t timeout_at = millis() + 1000;
+    while (remaining > 0) {
+      int n = request.read(tmp, min((long)sizeof(tmp), remaining));
+      if (n > 0) {
+        remaining -= n;
+      } else if (millis() > timeout_at) {
+        return false;
+      }
+    }
+    return request.connected();
+  }
+
+#ifdef USE_WIFI
+  /// Callback for the HttpRequest which resolves hosts via the dns cache
+  static const char* resolveDNS(const char* host, void* ref) {
+    return static_cast<URLStream*>(ref)->dns_cache.resolve(host);
+  }
+#endif
+
   /// Determines the client
   Client& getClient(bool isSecure) {
 #ifdef USE_WIFI_CLIENT_SECURE
@@ -391,6 +668,12 @@ class URLStream : public AbstractURLStream {
         clientSecure = new WiFiClientSecure();
         clientSecure->setInsecure();
       }
+#ifdef USE_TLS_SESSION_CACHE
+      // resume the TLS session of a previous connect to this host
+      if (is_tls_session_cache) {
+        clientSecure->setSession(tls_session_cache.get(url.host()));
+      }
+#endif
       LOGI("WiFiClientSecure");
       return *clientSecure;
     }
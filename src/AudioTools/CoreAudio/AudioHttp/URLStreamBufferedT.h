@@ -44,11 +44,60 @@ class BufferedTaskStream : public AudioStream {
     stop();
   }
 
+  /// Callback reporting the buffer fill level (0.0 - 1.0)
+  typedef void (*WatermarkCallback)(float level, void *ref);
+
   /// Define an explicit the buffer size in bytes
   void setBufferSize(int bufferSize, int bufferCount) {
     buffers.resize(bufferSize, bufferCount);
   }
 
+  /// Defines the allocator which provides the buffer memory: e.g. an
+  /// AllocatorPSRAM to place big buffers in PSRAM when it exists
+  void setAllocator(Allocator &allocator) { buffers.setAllocator(allocator); }
+
+  /// Provides the actual buffer fill level (0.0 - 1.0)
+  float fillLevel() {
+    size_t size = buffers.size();
+    return size > 0 ? (float)buffers.available() / size : 0.0f;
+  }
+
+  /// Defines the watermarks (0.0 - 1.0): onLow fires when the fill level
+  /// drops below low and is re-armed when it recovers above high
+  void setWatermarks(float low, float high) {
+    watermark_low = low;
+    watermark_high = high;
+  }
+
+  /// Defines the callbacks which are executed on the buffer task when a
+  /// watermark is crossed
+  void setWatermarkCallbacks(WatermarkCallback onLow, WatermarkCallback onHigh,
+                             void *ref = nullptr) {
+    watermark_low_cb = onLow;
+    watermark_high_cb = onHigh;
+    watermark_ref = ref;
+  }
+
+  /// Activates the fill level history: entries samples recorded every
+  /// intervalMs ms (0 entries = off)
+  void setFillHistory(int entries, int intervalMs = 100) {
+    history.resize(entries);
+    history_interval_ms = intervalMs;
+    history_pos = 0;
+    history_count = 0;
+  }
+
+  /// Provides the recorded fill levels in percent (oldest first) and
+  /// returns the number of provided entries
+  int getFillHistory(uint8_t *percent, int len) {
+    int count = min(len, history_count);
+    for (int j = 0; j < count; j++) {
+      int idx = (history_pos + history.size() - history_count + j) % history.size();
+      percent[j] = history[idx];
+    }
+    return count;
+  }
+
   virtual void begin(bool wait = true) {
     TRACED();
     active = true;
@@ -118,6 +167,40 @@ class BufferedTaskStream : public AudioStream {
             URL_STREAM_CORE};
   SynchronizedNBuffer buffers{DEFAULT_BUFFER_SIZE, URL_STREAM_BUFFER_COUNT};
   bool ready = false;
+  // watermark handling
+  float watermark_low = 0.0f;
+  float watermark_high = 1.0f;
+  WatermarkCallback watermark_low_cb = nullptr;
+  WatermarkCallback watermark_high_cb = nullptr;
+  void *watermark_ref = nullptr;
+  bool is_below_watermark = false;
+  // fill level history
+  Vector<uint8_t> history{0};
+  int history_interval_ms = 100;
+  int history_pos = 0;
+  int history_count = 0;
+  uint32_t history_time_ms = 0;
+
+  /// Watermark notifications and history sampling: runs on the buffer task
+  void updateMetrics() {
+    float level = fillLevel();
+    if (!is_below_watermark && level < watermark_low) {
+      is_below_watermark = true;
+      if (watermark_low_cb != nullptr) watermark_low_cb(level, watermark_ref);
+    } else if (is_below_watermark && level >= watermark_high) {
+      is_below_watermark = false;
+      if (watermark_high_cb != nullptr) watermark_high_cb(level, watermark_ref);
+    }
+    if (history.size() > 0) {
+      uint32_t now = millis();
+      if (now - history_time_ms >= (uint32_t)history_interval_ms) {
+        history_time_ms = now;
+        history[history_pos] = (uint8_t)(level * 100.0f);
+        history_pos = (history_pos + 1) % history.size();
+        if (history_count < (int)history.size()) history_count++;
+      }
+    }
+  }
 
   void processTask() {
     size_t available_to_write = this->buffers.availableForWrite();
@@ -139,6 +222,7 @@ class BufferedTaskStream : public AudioStream {
     if (available_to_write == 0) {
       this->ready = true;
     }
+    updateMetrics();
   }
 };
 
@@ -184,6 +268,35 @@ class URLStreamBufferedT : public AbstractURLStream {
     taskStream.setBufferSize(bufferSize, bufferCount);
   }
 
+  /// Defines the allocator which provides the buffer memory (e.g.
+  /// AllocatorPSRAM)
+  void setAllocator(Allocator &allocator) { taskStream.setAllocator(allocator); }
+
+  /// Provides the actual buffer fill level (0.0 - 1.0)
+  float fillLevel() { return taskStream.fillLevel(); }
+
+  /// Defines the watermarks (0.0 - 1.0) for the fill level notifications
+  void setWatermarks(float low, float high) {
+    taskStream.setWatermarks(low, high);
+  }
+
+  /// Defines the callbacks which are executed when a watermark is crossed
+  void setWatermarkCallbacks(BufferedTaskStream::WatermarkCallback onLow,
+                             BufferedTaskStream::WatermarkCallback onHigh,
+                             void *ref = nullptr) {
+    taskStream.setWatermarkCallbacks(onLow, onHigh, ref);
+  }
+
+  /// Activates the fill level history recording
+  void setFillHistory(int entries, int intervalMs = 100) {
+    taskStream.setFillHistory(entries, intervalMs);
+  }
+
+  /// Provides the recorded fill levels in percent (oldest first)
+  int getFillHistory(uint8_t *percent, int len) {
+    return taskStream.getFillHistory(percent, len);
+  }
+
   bool begin(const char *urlStr, const char *acceptMime = nullptr,
              MethodID action = GET, const char *reqMime = "",
              const char *reqData = "") {
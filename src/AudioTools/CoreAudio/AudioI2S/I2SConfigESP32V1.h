@@ -72,6 +72,10 @@ class I2SConfigESP32V1 : public AudioInfo {
     I2SChannelSelect channel_format = I2SChannelSelect::Default;
     /// masterclock multiple (-1 = use default)
     int mclk_multiple = -1;
+    /// If set to 32: 16 (or 24) bit data is expanded to 32 bit slots
+    /// directly in the driver write loop (TX only), so no separate
+    /// NumberFormatConverterStream is needed (0 = off)
+    int expand_to_bits = 0;
 
     void logInfo(const char* source="") {
       AudioInfo::logInfo(source);
@@ -5,11 +5,13 @@
         ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 0, 0) || \
     defined(DOXYGEN)
 
+#include "AudioTools/Concurrency/QueueLockFree.h"
 #include "AudioTools/CoreAudio/AudioI2S/I2SConfig.h"
 #include "driver/i2s_pdm.h"
 #include "driver/i2s_std.h"
 #include "driver/i2s_tdm.h"
 #include "esp_system.h"
+#include "esp_timer.h"
 
 #define IS_I2S_IMPLEMENTED
 
@@ -55,6 +57,16 @@ class I2SDriverESP32V1 {
   /// starts the DAC
   bool begin(I2SConfigESP32V1 cfg) {
     TRACED();
+    // fused bit width expansion: the channel is configured with the slot
+    // width and writeBytes() expands while copying
+    expand_from_bits = 0;
+    if (cfg.expand_to_bits == 32 && cfg.rx_tx_mode == TX_MODE &&
+        (cfg.bits_per_sample == 16 || cfg.bits_per_sample == 24)) {
+      expand_from_bits = cfg.bits_per_sample;
+      cfg.bits_per_sample = cfg.expand_to_bits;
+      LOGI("expanding %d bit data to %d bit slots", expand_from_bits,
+           cfg.expand_to_bits);
+    }
     this->cfg = cfg;
 
     // stop if it is already open
@@ -106,6 +118,7 @@ class I2SDriverESP32V1 {
     TRACED();
     size_t result;
     assert(tx_chan != nullptr);
+    if (expand_from_bits != 0) return writeBytesExpanded(src, size_bytes);
     if (i2s_channel_write(tx_chan, src, size_bytes, &result,
                           ticks_to_wait_write) != ESP_OK) {
       TRACEE();
@@ -129,6 +142,31 @@ class I2SDriverESP32V1 {
     ticks_to_wait_write = pdMS_TO_TICKS(ms);
   }
 
+  /// Completed RX DMA block with the capture timestamp latched in the ISR
+  struct I2SCaptureBlock {
+    void *data = nullptr;       // DMA buffer of the completed block
+    size_t size = 0;            // size in bytes
+    uint64_t timestamp_us = 0;  // esp_timer value latched in the ISR
+  };
+
+  /// Activates the timestamped capture: call before begin(). Completed RX
+  /// DMA buffers are then reported through a lock free queue together
+  /// with the esp_timer value latched in the on_recv callback, so capture
+  /// blocks can be time aligned w/o any extra copy
+  void setCaptureActive(bool active, int queueSize = I2S_BUFFER_COUNT) {
+    capture_active = active;
+    if (active) capture_queue.resize(queueSize);
+  }
+
+  /// Provides the next completed capture block: the data must be
+  /// processed before the driver reuses the DMA buffer
+  bool nextCaptureBlock(I2SCaptureBlock &block) {
+    return capture_queue.dequeue(block);
+  }
+
+  /// Number of capture blocks which were lost because the queue was full
+  uint32_t captureOverflows() { return capture_overflows; }
+
  protected:
   I2SConfigESP32V1 cfg = defaultConfig(RXTX_MODE);
   i2s_std_config_t i2s_config;
@@ -137,6 +175,56 @@ class I2SDriverESP32V1 {
   bool is_started = false;
   TickType_t ticks_to_wait_read = portMAX_DELAY;
   TickType_t ticks_to_wait_write = portMAX_DELAY;
+  int expand_from_bits = 0;  // source bits when expand_to_bits is used
+  QueueLockFree<I2SCaptureBlock> capture_queue{2};
+  bool capture_active = false;
+  volatile uint32_t capture_overflows = 0;
+
+  /// Executed in the ISR context when a RX DMA buffer has been completed:
+  /// latches the time and publishes the block w/o copying
+  static IRAM_ATTR bool captureCallback(i2s_chan_handle_t handle,
+                                        i2s_event_data_t *event,
+                                        void *user_ctx) {
+    I2SDriverESP32V1 *self = (I2SDriverESP32V1 *)user_ctx;
+    I2SCaptureBlock block;
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 2, 0)
+    block.data = event->dma_buf;
+#else
+    block.data = event->data;
+#endif
+    block.size = event->size;
+    block.timestamp_us = (uint64_t)esp_timer_get_time();
+    if (!self->capture_queue.enqueue(block)) self->capture_overflows++;
+    return false;
+  }
+
+  /// Expands 16 or 24 bit samples to the 32 bit slot width while copying
+  /// into the driver, so no separate converter pass is needed
+  size_t writeBytesExpanded(const void *src, size_t size_bytes) {
+    const int src_sample_size = expand_from_bits == 16 ? 2 : sizeof(int24_t);
+    int samples = size_bytes / src_sample_size;
+    const uint8_t *src8 = (const uint8_t *)src;
+    int32_t tmp[256];
+    int pos = 0;
+    while (pos < samples) {
+      int n = min(samples - pos, 256);
+      if (expand_from_bits == 16) {
+        const int16_t *data = (const int16_t *)src8 + pos;
+        for (int j = 0; j < n; j++) tmp[j] = (int32_t)data[j] << 16;
+      } else {
+        const int24_t *data = (const int24_t *)src8 + pos;
+        for (int j = 0; j < n; j++) tmp[j] = (int32_t)(int)data[j] << 8;
+      }
+      size_t written = 0;
+      if (i2s_channel_write(tx_chan, tmp, n * sizeof(int32_t), &written,
+                            ticks_to_wait_write) != ESP_OK) {
+        TRACEE();
+      }
+      pos += written / sizeof(int32_t);
+      if ((int)written < n * (int)sizeof(int32_t)) break;
+    }
+    return pos * src_sample_size;
+  }
 
   struct DriverCommon {
     virtual bool startChannels(I2SConfigESP32V1 &cfg,
@@ -536,6 +624,16 @@ class I2SDriverESP32V1 {
       return false;
     }
 
+    // the capture callback must be registered before the channel is
+    // enabled
+    if (capture_active && rx_chan != nullptr) {
+      i2s_event_callbacks_t cbs = {};
+      cbs.on_recv = captureCallback;
+      if (i2s_channel_register_event_callback(rx_chan, &cbs, this) != ESP_OK) {
+        LOGE("i2s_channel_register_event_callback");
+      }
+    }
+
     is_started = driver.startChannels(cfg, tx_chan, rx_chan, txPin, rxPin);
     if (!is_started) {
       end();
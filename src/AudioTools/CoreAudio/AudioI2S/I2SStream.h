@@ -14,6 +14,7 @@
 #include "AudioTools/CoreAudio/AudioI2S/I2SRP2040.h"
 #include "AudioTools/CoreAudio/AudioI2S/I2SSAMD.h"
 #include "AudioTools/CoreAudio/AudioI2S/I2SSTM32.h"
+#include "AudioTools/CoreAudio/AudioHealth.h"
 #include "AudioTools/CoreAudio/AudioStreams.h"
 #include "AudioTools/CoreAudio/AudioTypes.h"
 
@@ -115,9 +116,36 @@ class I2SStream : public AudioStream {
   virtual size_t write(const uint8_t *data, size_t len) {
     LOGD("I2SStream::write: %d", len);
     if (data == nullptr || len == 0 || !is_active)  return 0;
-    return i2s.writeBytes(data, len);
+    size_t result = i2s.writeBytes(data, len);
+    if (result < len) healthIncrement(HealthI2SIncompleteWrite);
+    return result;
   }
 
+  /// Zero copy style write: provides a span into which the decoder or
+  /// converter can render directly; hand the data to the driver with
+  /// commit(). This saves the producer side copy into an intermediate
+  /// buffer - use it instead of write() for generated data.
+  uint8_t *writeSpan(int &len) {
+    if (!is_active) {
+      len = 0;
+      return nullptr;
+    }
+    if (span.size() != (size_t)span_size) span.resize(span_size);
+    len = span_size;
+    return span.data();
+  }
+
+  /// Writes the indicated number of bytes which were rendered into the
+  /// span provided by writeSpan()
+  bool commit(int len) {
+    if (len <= 0 || len > span_size || !is_active) return false;
+    return i2s.writeBytes(span.data(), len) == (size_t)len;
+  }
+
+  /// Defines the size of the span provided by writeSpan() (default
+  /// DEFAULT_BUFFER_SIZE): use a multiple of the DMA buffer size
+  void setSpanSize(int size) { span_size = size; }
+
   /// Reads the audio data
   virtual size_t readBytes(uint8_t *data, size_t len) override {
     return i2s.readBytes(data, len);
@@ -142,6 +170,8 @@ class I2SStream : public AudioStream {
 
  protected:
   I2SDriver i2s;
+  Vector<uint8_t> span{0};
+  int span_size = DEFAULT_BUFFER_SIZE;
   int mute_pin;
   bool is_active = false;
 
@@ -4,4 +4,5 @@
 #  include "AudioTools/CoreAudio/AudioLoggerIDF.h"
 #else
 #  include "AudioTools/CoreAudio/AudioLoggerSTD.h"
-#endif
\ No newline at end of file
+#endif
+#include "AudioTools/CoreAudio/AudioTrace.h"
\ No newline at end of file
@@ -118,16 +118,10 @@ class MetaDataID3V1  : public MetaDataID3Base {
         memset(tag_str, 0, 5);
     }
 
-    /// Ends the processing and releases the memory
+    /// Ends the processing
     void end() {
-        if (tag!=nullptr){
-            delete tag;
-            tag = nullptr;
-        }
-        if (tag_ext!=nullptr){
-            delete tag_ext;
-            tag_ext = nullptr;
-        }
+        tag_loaded = false;
+        tag_ext_loaded = false;
     }
 
     /// provide the (partial) data which might contain the meta data
@@ -154,8 +148,12 @@ class MetaDataID3V1  : public MetaDataID3Base {
   protected:
     int use_bytes_of_next_write = 0;
     char tag_str[5] = "";
-    ID3v1 *tag = nullptr;
-    ID3v1Enhanced *tag_ext = nullptr;
+    // fixed preallocated tag buffers: the tags are small, so we avoid any
+    // heap allocation in the data path
+    ID3v1 tag;
+    ID3v1Enhanced tag_ext;
+    bool tag_loaded = false;
+    bool tag_ext_loaded = false;
     ParseStatus status = TagNotFound;
 
 
@@ -164,31 +162,26 @@ class MetaDataID3V1  : public MetaDataID3Base {
         // find tags
         int pos = findTag("TAG+",(const char*) data, len);
         if (pos>0){
-            tag_ext = new ID3v1Enhanced();
-            if (tag_ext!=nullptr){
-                if (len-pos>=sizeof(ID3v1Enhanced)){
-                    memcpy(tag,data+pos,sizeof(ID3v1Enhanced));
-                    processnotifyAudioChange();                    
-                } else {
-                    use_bytes_of_next_write = min(sizeof(ID3v1Enhanced), len-pos);
-                    memcpy(tag_ext, data+pos, use_bytes_of_next_write);
-                    status = TagFoundPartial;
-                }
+            tag_ext_loaded = true;
+            if (len-pos>=sizeof(ID3v1Enhanced)){
+                memcpy(&tag_ext,data+pos,sizeof(ID3v1Enhanced));
+                processnotifyAudioChange();
+            } else {
+                use_bytes_of_next_write = min(sizeof(ID3v1Enhanced), len-pos);
+                memcpy(&tag_ext, data+pos, use_bytes_of_next_write);
+                status = TagFoundPartial;
             }
         } else {
             pos = findTag("TAG", (const char*) data, len);
             if (pos>0){
-                tag = new ID3v1();
-                if (tag!=nullptr){
-                    if (len-pos>=sizeof(ID3v1)){
-                        memcpy(tag,data+pos,sizeof(ID3v1));
-                        processnotifyAudioChange();                    
-                    } else {
-                        use_bytes_of_next_write = min(sizeof(ID3v1), len-pos);
-                        memcpy(tag,data+pos,use_bytes_of_next_write);
-                        status = TagFoundPartial;
-                        
-                    }
+                tag_loaded = true;
+                if (len-pos>=sizeof(ID3v1)){
+                    memcpy(&tag,data+pos,sizeof(ID3v1));
+                    processnotifyAudioChange();
+                } else {
+                    use_bytes_of_next_write = min(sizeof(ID3v1), len-pos);
+                    memcpy(&tag,data+pos,use_bytes_of_next_write);
+                    status = TagFoundPartial;
                 }
             }
         }
@@ -200,8 +193,8 @@ class MetaDataID3V1  : public MetaDataID3Base {
                 status = TagFoundPartial;
             } else if (data[len-2] == 'T' && data[len-1] == 'A' ){
                 strcpy(tag_str,"TA");
-                status = TagFoundPartial;                
-            } else if (data[len-1] == 'T'){            
+                status = TagFoundPartial;
+            } else if (data[len-1] == 'T'){
                 strcpy(tag_str,"T");
                 status = TagFoundPartial;
             }
@@ -214,30 +207,30 @@ class MetaDataID3V1  : public MetaDataID3Base {
         int missing = 5 - tag_len;
         strncat((char*)tag_str, (char*)data, missing);
         if (strncmp((char*)tag_str, "TAG+", 4)==0){
-            tag_ext = new ID3v1Enhanced();
-            memcpy(tag,tag_str, 4);
-            memcpy(tag,data+len,sizeof(ID3v1Enhanced));
-            processnotifyAudioChange();                    
+            tag_ext_loaded = true;
+            memcpy(&tag_ext,tag_str, 4);
+            memcpy((uint8_t*)&tag_ext+4,data+(4-tag_len),sizeof(ID3v1Enhanced)-4);
+            processnotifyAudioChange();
         } else if (strncmp((char*)tag_str,"TAG",3)==0){
-            tag = new ID3v1();
-            memcpy(tag,tag_str, 3);
-            memcpy(tag,data+len,sizeof(ID3v1));
-            processnotifyAudioChange();                    
+            tag_loaded = true;
+            memcpy(&tag,tag_str, 3);
+            memcpy((uint8_t*)&tag+3,data+(3-tag_len),sizeof(ID3v1)-3);
+            processnotifyAudioChange();
         }
     }
 
     /// We have the beginning of the metadata and need to process the remainder
     void processTagFoundPartial(const uint8_t* data, size_t len) {
-        if (tag!=nullptr){
+        if (tag_loaded){
             int remainder = sizeof(ID3v1) - use_bytes_of_next_write;
-            memcpy(tag,data+use_bytes_of_next_write,remainder);
-            processnotifyAudioChange();                 
-            use_bytes_of_next_write = 0;   
-        } else if (tag_ext!=nullptr){
+            memcpy((uint8_t*)&tag+use_bytes_of_next_write,data,remainder);
+            processnotifyAudioChange();
+            use_bytes_of_next_write = 0;
+        } else if (tag_ext_loaded){
             int remainder = sizeof(ID3v1Enhanced) - use_bytes_of_next_write;
-            memcpy(tag_ext,data+use_bytes_of_next_write,remainder);
-            processnotifyAudioChange();                 
-            use_bytes_of_next_write = 0;   
+            memcpy((uint8_t*)&tag_ext+use_bytes_of_next_write,data,remainder);
+            processnotifyAudioChange();
+            use_bytes_of_next_write = 0;
         }
     }
 
@@ -245,27 +238,25 @@ class MetaDataID3V1  : public MetaDataID3Base {
     void processnotifyAudioChange() {
         if (callback==nullptr) return;
 
-        if (tag_ext!=nullptr){
-            callback(Title, tag_ext->title,strnlength(tag_ext->title,60));
-            callback(Artist, tag_ext->artist,strnlength(tag_ext->artist,60));
-            callback(Album, tag_ext->album,strnlength(tag_ext->album,60));
-            callback(Genre, tag_ext->genre,strnlength(tag_ext->genre,30));
-            delete tag_ext;
-            tag_ext = nullptr;
+        if (tag_ext_loaded){
+            callback(Title, tag_ext.title,strnlength(tag_ext.title,60));
+            callback(Artist, tag_ext.artist,strnlength(tag_ext.artist,60));
+            callback(Album, tag_ext.album,strnlength(tag_ext.album,60));
+            callback(Genre, tag_ext.genre,strnlength(tag_ext.genre,30));
+            tag_ext_loaded = false;
             status = TagProcessed;
         }
 
-        if (tag!=nullptr){
-            callback(Title, tag->title,strnlength(tag->title,30));
-            callback(Artist, tag->artist,strnlength(tag->artist,30));
-            callback(Album, tag->album,strnlength(tag->album,30));        
-            uint16_t genre = tag->genre;
+        if (tag_loaded){
+            callback(Title, tag.title,strnlength(tag.title,30));
+            callback(Artist, tag.artist,strnlength(tag.artist,30));
+            callback(Album, tag.album,strnlength(tag.album,30));
+            uint16_t genre = tag.genre;
             if (genre < sizeof(genres)){
                 const char* genre_str = genres[genre];
                 callback(Genre, genre_str,strlen(genre_str));
             }
-            delete tag;
-            tag = nullptr;
+            tag_loaded = false;
             status = TagProcessed;
         }
     }
@@ -322,7 +313,13 @@ struct ID3v2FrameString {
 static const int ID3FrameSize = 11;
 
 /**
- * @brief Simple ID3 Meta Data API which supports ID3 V2: We only support the "TALB", "TOPE", "TIT2", "TCON" tags
+ * @brief Simple ID3 Meta Data API which supports ID3 V2: We only support the "TALB", "TOPE", "TIT2", "TCON" tags.
+ * The tag is expected at the start of the stream and is consumed with a
+ * byte counting state machine: frames which are not relevant and the tag
+ * remainder are skipped with a count instead of scanning the content.
+ * After the tag has been processed (or the stream did not start with one)
+ * write() is fully passive and does not look at the data any more. The
+ * frame content goes into a fixed preallocated buffer (resize()).
  * @ingroup metadata-id3
  * @author Phil Schatzmann
  * @copyright GPLv3
@@ -333,36 +330,46 @@ class MetaDataID3V2 : public MetaDataID3Base  {
 
     /// (re)starts the processing
     void begin() {
-        status = TagNotFound;
-        use_bytes_of_next_write = 0;
+        parse_state = SearchHeader;
+        header_len = 0;
+        tag_remaining = 0;
+        frame_remaining = 0;
+        skip_len = 0;
+        result_len = 0;
         actual_tag = nullptr;
-        tag_active = false;
         tag_processed = false;
         result.resize(result_size);
     }
-    
-    /// Ends the processing and releases the memory
+
+    /// Ends the processing
     void end() {
-        status = TagNotFound;
-        use_bytes_of_next_write = 0;
+        parse_state = Passive;
         actual_tag = nullptr;
-        tag_active = false;
-        tag_processed = false;
     }
 
     /// provide the (partial) data which might contain the meta data
     size_t write(const uint8_t* data, size_t len){
-        if (armed){ 
-            switch(status){
-                case TagNotFound:
-                    processTagNotFound(data,len);
+        if (!armed || parse_state == Passive || len == 0) return len;
+        size_t pos = 0;
+        while (pos < len && parse_state != Passive){
+            switch(parse_state){
+                case SearchHeader:
+                    pos += processHeader(data+pos, len-pos);
                     break;
-                case PartialTagAtTail:
-                    processPartialTagAtTail(data,len);
+                case ReadExtLen:
+                    pos += processExtLen(data+pos, len-pos);
                     break;
-                default:                
-                    // do nothing
+                case ReadFrameHeader:
+                    pos += processFrameHeader(data+pos, len-pos);
+                    break;
+                case ReadFrameData:
+                    pos += processFrameData(data+pos, len-pos);
                     break;
+                case SkipBytes:
+                    pos += processSkip(data+pos, len-pos);
+                    break;
+                default:
+                    return len;
             }
         }
         return len;
@@ -392,17 +399,22 @@ class MetaDataID3V2 : public MetaDataID3Base  {
     }
 
   protected:
+    enum ID3v2ParseState { SearchHeader, ReadExtLen, ReadFrameHeader, ReadFrameData, SkipBytes, Passive };
+
     ID3v2 tagv2;
-    bool tag_active = false;
+    ID3v2ParseState parse_state = SearchHeader;
     bool tag_processed = false;
-    ParseStatus status = TagNotFound;
-    const char* actual_tag;
+    const char* actual_tag = nullptr;
     ID3v2FrameString frame_header;
-    int use_bytes_of_next_write = 0;
+    uint8_t header_buf[10];
+    int header_len = 0;
+    int64_t tag_remaining = 0;
+    int64_t frame_remaining = 0;
+    int64_t skip_len = 0;
+    int result_len = 0;
+    bool is_encoding_byte = false;
     int result_size = 256;
     Vector<char> result{0};
-    uint64_t total_len = 0;
-    uint64_t end_len = 0;
 
     // calculate the synch save size
     uint32_t calcSize(uint8_t chars[4]) {
@@ -413,80 +425,151 @@ class MetaDataID3V2 : public MetaDataID3Base  {
         return byte0 << 21 | byte1 << 14 | byte2 << 7 | byte3;
     }
 
-    /// try to find the metatdata tag in the provided data
-    void processTagNotFound(const uint8_t* data, size_t len) {
+    // plain 32 bit big endian size (frame size before v2.4)
+    uint32_t calcSize32(uint8_t chars[4]) {
+        return (uint32_t)chars[0] << 24 | (uint32_t)chars[1] << 16 |
+               (uint32_t)chars[2] << 8 | chars[3];
+    }
 
-        // activate tag processing when we have an ID3 Tag
-        if (!tag_active && !tag_processed){
-            int pos = findTag("ID3", (const char*) data, len);
-            if (pos>=0){
-                // fill v2 tag header
-                tag_active = true;  
-                // if we have enough data for the header we process it
-                if (len>=pos+sizeof(ID3v2)){
-                    memcpy(&tagv2, data+pos, sizeof(ID3v2));   
-                    end_len = total_len + calcSize(tagv2.size);
-                }
+    /// the tag is done (or was never there): we do not look at the data
+    /// any more
+    void setPassive(bool processed) {
+        tag_processed = processed;
+        parse_state = Passive;
+    }
+
+    /// The tag header must be at the very start of the stream: one memcmp
+    /// decides - there is no scanning
+    size_t processHeader(const uint8_t* data, size_t len) {
+        size_t consumed = 0;
+        while (header_len < 3 && consumed < len) header_buf[header_len++] = data[consumed++];
+        if (header_len == 3 && memcmp(header_buf, "ID3", 3) != 0){
+            setPassive(false);
+            return consumed;
+        }
+        while (header_len < (int)sizeof(ID3v2) && consumed < len) header_buf[header_len++] = data[consumed++];
+        if (header_len == (int)sizeof(ID3v2)){
+            memcpy(&tagv2, header_buf, sizeof(ID3v2));
+            tag_remaining = calcSize(tagv2.size);
+            header_len = 0;
+            LOGI("ID3v2.%d tag: %d bytes", tagv2.version[0], (int)tag_remaining);
+            if (tag_remaining == 0){
+                setPassive(true);
+            } else {
+                parse_state = (tagv2.flags & ExtendedHeaderFlag) ? ReadExtLen : ReadFrameHeader;
             }
         }
+        return consumed;
+    }
 
-        // deactivate tag processing when we are out of range
-        if (end_len>0 && total_len>end_len){
-            tag_active = false;
-            tag_processed = false;
+    /// determine the size of the extended header so that we can skip it
+    size_t processExtLen(const uint8_t* data, size_t len) {
+        size_t consumed = 0;
+        while (header_len < 4 && consumed < len){
+            header_buf[header_len++] = data[consumed++];
+            tag_remaining--;
         }
+        if (header_len == 4){
+            uint32_t ext = tagv2.version[0] >= 4 ? calcSize(header_buf) : calcSize32(header_buf);
+            // in v2.4 the size includes the 4 size bytes
+            skip_len = tagv2.version[0] >= 4 && ext >= 4 ? ext - 4 : ext;
+            if (skip_len > tag_remaining) skip_len = tag_remaining;
+            header_len = 0;
+            parse_state = SkipBytes;
+        }
+        return consumed;
+    }
 
-        
-        if (tag_active){
-            // process all tags in current buffer
-            const char* partial_tag = nullptr;
-            for (const char* tag : id3_v2_tags){
-                actual_tag = tag;
-                int tag_pos = findTag(tag, (const char*)  data, len);
-
-                if (tag_pos>0 && tag_pos+sizeof(ID3v2Frame)<=len){
-                    // setup tag header
-                    memmove(&frame_header, data+tag_pos, sizeof(ID3v2FrameString));
-
-                    // get tag content
-                    if(calcSize(frame_header.size) <= len){
-                        int l = min(calcSize(frame_header.size)-1, (uint32_t) result.size());
-                        memset(result.data(), 0, result.size());
-                        strncpy((char*)result.data(), (char*) data+tag_pos+ID3FrameSize, l);
-                        int checkLen = min(l, 10);
-                        if (isAscii(checkLen)){
-                            processnotifyAudioChange();
-                        } else {
-                            LOGW("TAG %s ignored", tag);
-                        }
-                    } else {
-                        partial_tag = tag;
-                        LOGI("%s partial tag", tag);
-                    }
-                } 
+    /// collects the 10 frame header bytes: a relevant frame is read, any
+    /// other frame (and the padding) is skipped by count
+    size_t processFrameHeader(const uint8_t* data, size_t len) {
+        if (header_len == 0 && (tag_remaining < (int64_t)sizeof(ID3v2Frame) || data[0] == 0)){
+            // padding or no space for another frame -> skip the remainder
+            skip_len = tag_remaining;
+            parse_state = SkipBytes;
+            if (skip_len == 0) setPassive(true);
+            return 0;
+        }
+        size_t consumed = 0;
+        while (header_len < (int)sizeof(ID3v2Frame) && consumed < len){
+            header_buf[header_len++] = data[consumed++];
+            tag_remaining--;
+        }
+        if (header_len == (int)sizeof(ID3v2Frame)){
+            memcpy(&frame_header, header_buf, sizeof(ID3v2Frame));
+            header_len = 0;
+            frame_remaining = tagv2.version[0] >= 4 ? calcSize(frame_header.size) : calcSize32(frame_header.size);
+            if (frame_remaining > tag_remaining) frame_remaining = tag_remaining;
+            actual_tag = relevantTag(frame_header.id);
+            if (actual_tag != nullptr && frame_remaining > 0){
+                result_len = 0;
+                is_encoding_byte = true;
+                parse_state = ReadFrameData;
+            } else {
+                skip_len = frame_remaining;
+                parse_state = SkipBytes;
+                if (skip_len == 0 && tag_remaining == 0) setPassive(true);
             }
-            
-            // save partial tag information so that we process the remainder with the next write
-            if (partial_tag!=nullptr){
-                int tag_pos = findTag(partial_tag, (const char*)  data, len);
-                memmove(&frame_header, data+tag_pos, sizeof(ID3v2FrameString));
-                int size = min(len - tag_pos, (size_t) calcSize(frame_header.size)-1); 
-                strncpy((char*)result.data(), (char*)data+tag_pos+ID3FrameSize, size);
-                use_bytes_of_next_write = size;
-                status = PartialTagAtTail;
+        }
+        return consumed;
+    }
+
+    /// copies the frame content into the preallocated result buffer
+    size_t processFrameData(const uint8_t* data, size_t len) {
+        size_t consumed = 0;
+        if (is_encoding_byte){
+            frame_header.encoding = data[consumed++];
+            tag_remaining--;
+            frame_remaining--;
+            is_encoding_byte = false;
+        }
+        size_t to_copy = min((size_t)frame_remaining, len - consumed);
+        // content which does not fit into the result buffer is dropped
+        size_t fit = min(to_copy, (size_t)(result.size() - 1 - result_len));
+        if (fit > 0) memcpy(result.data() + result_len, data + consumed, fit);
+        result_len += fit;
+        consumed += to_copy;
+        tag_remaining -= to_copy;
+        frame_remaining -= to_copy;
+        if (frame_remaining == 0){
+            result[result_len] = 0;
+            if (isAscii(result_len)){
+                processnotifyAudioChange();
+            } else {
+                LOGW("TAG %s ignored", actual_tag);
             }
+            parse_state = ReadFrameHeader;
+            if (tag_remaining == 0) setPassive(true);
         }
-    
-        total_len += len;
+        return consumed;
+    }
+
+    /// skips over irrelevant data with a plain byte count
+    size_t processSkip(const uint8_t* data, size_t len) {
+        size_t consumed = min((size_t)skip_len, len);
+        skip_len -= consumed;
+        tag_remaining -= consumed;
+        if (skip_len == 0){
+            parse_state = ReadFrameHeader;
+            if (tag_remaining == 0) setPassive(true);
+        }
+        return consumed;
+    }
 
+    /// checks if the frame id is one of the supported tags
+    const char* relevantTag(const uint8_t* id) {
+        for (const char* tag : id3_v2_tags){
+            if (memcmp(id, tag, 4) == 0) return tag;
+        }
+        return nullptr;
     }
-    
+
     int isCharAscii(int ch) {return ch >= 0 && ch < 128; }
 
     /// Make sure that the result is a valid ASCII string
     bool isAscii(int l){
         // check on first 10 characters
-        int m = l < 5 ? l : 10;
+        int m = l < 10 ? l : 10;
         for (int j=0; j<m; j++){
             if (!isCharAscii(result[j])) {
                 return false;
@@ -495,16 +578,6 @@ class MetaDataID3V2 : public MetaDataID3Base  {
         return true;
     }
 
-    /// We have the beginning of the metadata and need to process the remainder
-    void processPartialTagAtTail(const uint8_t* data, size_t len) {
-        int remainder = calcSize(frame_header.size) - use_bytes_of_next_write;
-        memcpy(result.data()+use_bytes_of_next_write, data, remainder);
-        processnotifyAudioChange();    
-
-        status = TagNotFound;
-        processTagNotFound(data+use_bytes_of_next_write, len-use_bytes_of_next_write);
-    }
-
     /// For the time beeing we support only ASCII and UTF8
     bool encodingIsSupported(){
         return frame_header.encoding == 0 || frame_header.encoding == 3;
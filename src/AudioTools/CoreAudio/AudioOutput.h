@@ -26,6 +26,7 @@ public:
   virtual size_t write(const uint8_t *data, size_t len) override = 0;
 
   virtual size_t write(uint8_t ch) override {
+    per_byte_check.track();
     if (tmp.isFull()) {
       flush();
     }
@@ -56,14 +57,26 @@ public:
   /// If true we need to release the related memory in the destructor
   virtual bool isDeletable() { return false; }
 
+  /// Requests a contiguous writable buffer of len bytes so that producers
+  /// (e.g. decoders) can generate their result directly into the output
+  /// w/o an intermediate copy: returns nullptr if this is not supported
+  virtual uint8_t *writeBegin(size_t len) { return nullptr; }
+
+  /// Commits len bytes that have been filled into the buffer provided by
+  /// writeBegin()
+  virtual size_t writeEnd(size_t len) { return 0; }
+
   virtual AudioInfo audioInfo() override { return cfg; }
 
   /// Writes n 0 values (= silence)
   /// @param len
   virtual void writeSilence(size_t len) {
-    int16_t zero = 0;
-    for (int j = 0; j < len / 2; j++) {
-      write((uint8_t *)&zero, 2);
+    // write in blocks instead of per sample
+    uint8_t zero[512] = {0};
+    while (len > 0) {
+      size_t n = len < sizeof(zero) ? len : sizeof(zero);
+      write(zero, n);
+      len -= n;
     }
   }
 
@@ -84,6 +97,7 @@ protected:
   int tmpPos = 0;
   AudioInfo cfg;
   SingleBuffer<uint8_t> tmp{MAX_SINGLE_CHARS};
+  PerByteIOCheck per_byte_check;
   bool is_active = false;
 };
 
@@ -595,6 +609,20 @@ public:
 
   int size() { return max_size; }
 
+  /// provides direct access to the target memory for zero copy writes
+  uint8_t *writeBegin(size_t len) override {
+    if (p_next == nullptr || pos + len > max_size) return nullptr;
+    return p_next;
+  }
+
+  /// commits the data written via writeBegin()
+  size_t writeEnd(size_t len) override {
+    if (p_next == nullptr || pos + len > max_size) return 0;
+    pos += len;
+    p_next += len;
+    return len;
+  }
+
 protected:
   int pos = 0;
   uint8_t *p_start = nullptr;
@@ -52,6 +52,11 @@ struct PWMConfig : public AudioInfo {
   /// max sample sample rate that still produces good audio
   uint32_t max_sample_rate = PWM_MAX_SAMPLE_RATE;
 
+  /// Second order noise shaping with TPDF dither when the samples are
+  /// scaled down to the PWM resolution: better perceived SNR for a few
+  /// integer operations per sample
+  bool noise_shaping = false;
+
 #ifndef __AVR__
   /// GPIO of starting pin
   uint16_t start_pin = PIN_PWM_START;
@@ -96,6 +101,7 @@ struct PWMConfig : public AudioInfo {
     LOGI("buffer_count: %u", buffers);
     LOGI("pwm_frequency: %u", (unsigned)pwm_frequency);
     LOGI("resolution: %d", resolution);
+    LOGI("noise_shaping: %s", noise_shaping ? "true" : "false");
     // LOGI("timer_id: %d", timer_id);
   }
 
@@ -134,6 +140,9 @@ class DriverPWMBase {
       return false;
     }
 
+    is_noise_shaping = audio_config.noise_shaping;
+    if (is_noise_shaping) setupNoiseShaping();
+
     if (buffer == nullptr) {
       LOGI("->Allocating new buffer %d * %d bytes", audio_config.buffers,
            audio_config.buffer_size);
@@ -257,6 +266,13 @@ class DriverPWMBase {
   bool is_blocking_write = true;
   Decimate decimate;
   int decimation_factor = 0;
+  // noise shaping state
+  bool is_noise_shaping = false;
+  Vector<int32_t> ns_err1{0};
+  Vector<int32_t> ns_err2{0};
+  int ns_shift = 0;
+  int ns_channel = 0;
+  uint32_t ns_seed = 0x2545F491ul;
 
   void deleteBuffer() {
     // delete buffer if necessary
@@ -293,8 +309,10 @@ class DriverPWMBase {
           LOGE(READ_ERROR_MSG);
           value = 0;
         }
-        result = map(value, -NumberConverter::maxValue(8),
-                     NumberConverter::maxValue(8), 0, maxOutputValue());
+        result = is_noise_shaping
+                     ? nextShapedValue((int32_t)value << 8)
+                     : map(value, -NumberConverter::maxValue(8),
+                           NumberConverter::maxValue(8), 0, maxOutputValue());
         break;
       }
       case 16: {
@@ -302,8 +320,10 @@ class DriverPWMBase {
         if (buffer->readArray((uint8_t *)&value, 2) != 2) {
           LOGE(READ_ERROR_MSG);
         }
-        result = map(value, -NumberConverter::maxValue(16),
-                     NumberConverter::maxValue(16), 0, maxOutputValue());
+        result = is_noise_shaping
+                     ? nextShapedValue(value)
+                     : map(value, -NumberConverter::maxValue(16),
+                           NumberConverter::maxValue(16), 0, maxOutputValue());
         break;
       }
       case 24: {
@@ -311,8 +331,10 @@ class DriverPWMBase {
         if (buffer->readArray((uint8_t *)&value, 3) != 3) {
           LOGE(READ_ERROR_MSG);
         }
-        result = map((int32_t)value, -NumberConverter::maxValue(24),
-                     NumberConverter::maxValue(24), 0, maxOutputValue());
+        result = is_noise_shaping
+                     ? nextShapedValue((int32_t)value >> 8)
+                     : map((int32_t)value, -NumberConverter::maxValue(24),
+                           NumberConverter::maxValue(24), 0, maxOutputValue());
         break;
       }
       case 32: {
@@ -320,14 +342,60 @@ class DriverPWMBase {
         if (buffer->readArray((uint8_t *)&value, 4) != 4) {
           LOGE(READ_ERROR_MSG);
         }
-        result = map(value, -NumberConverter::maxValue(32),
-                     NumberConverter::maxValue(32), 0, maxOutputValue());
+        result = is_noise_shaping
+                     ? nextShapedValue(value >> 16)
+                     : map(value, -NumberConverter::maxValue(32),
+                           NumberConverter::maxValue(32), 0, maxOutputValue());
         break;
       }
     }
     return result;
   }
 
+  /// Determines the output resolution in bits and sets up the per
+  /// channel error state for the noise shaping
+  void setupNoiseShaping() {
+    int out_bits = 0;
+    for (int v = maxOutputValue(); v > 0; v >>= 1) out_bits++;
+    ns_shift = 16 - out_bits;
+    if (ns_shift < 1) {
+      LOGI("noise shaping not necessary: %d bits output", out_bits);
+      is_noise_shaping = false;
+      return;
+    }
+    ns_err1.resize(audio_config.channels);
+    ns_err2.resize(audio_config.channels);
+    for (int j = 0; j < audio_config.channels; j++) {
+      ns_err1[j] = 0;
+      ns_err2[j] = 0;
+    }
+    ns_channel = 0;
+    LOGI("noise shaping: 16 -> %d bits", out_bits);
+  }
+
+  /// Second order noise shaped quantization with TPDF dither: the
+  /// quantization error of the last two samples is fed back, so the
+  /// truncation noise is pushed out of the audible range - integer
+  /// operations only. The input is a signed 16 bit sample.
+  int nextShapedValue(int32_t value) {
+    int ch = ns_channel;
+    if (++ns_channel >= audio_config.channels) ns_channel = 0;
+    // second order error feedback
+    int32_t in = value + 2 * ns_err1[ch] - ns_err2[ch];
+    // TPDF dither of +-1 output LSB from a cheap LCG
+    ns_seed = ns_seed * 1664525ul + 1013904223ul;
+    int32_t mask = (1 << ns_shift) - 1;
+    int32_t dither = (int32_t)(ns_seed & mask) +
+                     (int32_t)((ns_seed >> 16) & mask) - mask;
+    int32_t mid = (maxOutputValue() + 1) >> 1;
+    int32_t out = ((in + dither + (1 << (ns_shift - 1))) >> ns_shift) + mid;
+    if (out < 0) out = 0;
+    if (out > maxOutputValue()) out = maxOutputValue();
+    ns_err2[ch] = ns_err1[ch];
+    ns_err1[ch] = in - ((out - mid) << ns_shift);
+    return out;
+  }
+
   /// Provides the max working sample rate
   virtual int maxSampleRate() { return audio_config.max_sample_rate; }
 
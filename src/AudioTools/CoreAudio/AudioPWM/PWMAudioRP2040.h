@@ -4,7 +4,9 @@
 #include "AudioTools/CoreAudio/AudioPWM/PWMAudioBase.h"
 #include "hardware/adc.h"
 #include "hardware/clocks.h"
+#include "hardware/dma.h"
 #include "hardware/gpio.h"
+#include "hardware/irq.h"
 #include "hardware/pwm.h"
 #include "hardware/structs/clocks.h"
 #include "pico/time.h"
@@ -13,11 +15,16 @@ namespace audio_tools {
 
 // forwrd declaratioin of callback
 class PWMDriverRP2040;
+class PWMDriverRP2040DMA;
 /**
  * @typedef  DriverPWMBase
  * @brief Please use DriverPWMBase!
  */
+#ifdef USE_PWM_DMA
+using PWMDriver = PWMDriverRP2040DMA;
+#else
 using PWMDriver = PWMDriverRP2040;
+#endif
 
 /**
  * @brief Rasperry Pico Channel to pin assignments
@@ -97,7 +104,7 @@ class PWMDriverRP2040 : public DriverPWMBase {
   }
 
   // defines the pwm_config which will be used to drive the pins
-  pwm_config setupPWMConfig() {
+  virtual pwm_config setupPWMConfig() {
     TRACED();
     if (audio_config.pwm_frequency == 0){
       audio_config.pwm_frequency = PWM_AUDIO_FREQUENCY;
@@ -158,6 +165,141 @@ class PWMDriverRP2040 : public DriverPWMBase {
   }
 };
 
+/**
+ * @brief DMA driven PWM output for the Rasperry Pico without per sample
+ * interrupts: the PWM slice wraps at the sample rate and its wrap DREQ
+ * paces a DMA channel which writes one counter compare (cc) value per
+ * wrap - both pwm channels of the slice with a single 32 bit write. The
+ * cpu is only interrupted once per block (default 256 frames) to refill
+ * the finished half of the double buffer. Activate it with
+ * #define USE_PWM_DMA before including the AudioTools. Restrictions: max
+ * 2 channels and for stereo both pins must be on the same pwm slice
+ * (e.g. gpio 2 and 3).
+ * @ingroup platform
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ */
+class PWMDriverRP2040DMA : public PWMDriverRP2040 {
+ public:
+  /// Ends the output -> stops the dma channel and resets the pins
+  void end() override {
+    TRACED();
+    if (dma_channel >= 0) {
+      dma_channel_set_irq0_enabled(dma_channel, false);
+      dma_channel_abort(dma_channel);
+      dma_channel_unclaim(dma_channel);
+      irq_remove_handler(DMA_IRQ_0, dmaCallbackPico);
+      dma_channel = -1;
+    }
+    if (self_dma == this) self_dma = nullptr;
+    PWMDriverRP2040::end();
+  }
+
+  /// Defines the number of frames per dma block (default 256): this
+  /// determines the interrupt rate (sample_rate / frames)
+  void setBlockFrames(int frames) { block_frames = frames; }
+
+  /// The dma writes to a single slice: max 2 channels
+  int maxChannels() override { return 2; }
+
+ protected:
+  inline static PWMDriverRP2040DMA *self_dma = nullptr;
+  int dma_channel = -1;
+  Vector<uint32_t> blocks[2];
+  int block_frames = 256;
+  volatile int play_block = 0;
+
+  /// The slice wraps at the sample rate, so each wrap requests the next
+  /// cc value via dreq
+  pwm_config setupPWMConfig() override {
+    TRACED();
+    pwm_config pico_pwm_config = pwm_get_default_config();
+    int wrap_value = maxOutputValue();
+    float pwmClockDivider =
+        static_cast<float>(clock_get_hz(clk_sys)) /
+        (static_cast<float>(audio_config.sample_rate) * (wrap_value + 1));
+    LOGI("->wrap_value = %d", wrap_value);
+    LOGI("->divider = %f", pwmClockDivider);
+    LOGI("->pwm frequency = sample rate: %d", (int)audio_config.sample_rate);
+    pwm_config_set_clkdiv(&pico_pwm_config, pwmClockDivider);
+    pwm_config_set_clkdiv_mode(&pico_pwm_config, PWM_DIV_FREE_RUNNING);
+    pwm_config_set_wrap(&pico_pwm_config, wrap_value);
+    return pico_pwm_config;
+  }
+
+  /// Instead of a timer we start the dma channel
+  void startTimer() override {
+    TRACED();
+    if (audio_config.channels == 2 && pins[0].slice != pins[1].slice) {
+      LOGE("stereo pins must be on the same pwm slice");
+      return;
+    }
+    uint slice = pins[0].slice;
+
+    // prefill both blocks
+    blocks[0].resize(block_frames);
+    blocks[1].resize(block_frames);
+    fillBlock(0);
+    fillBlock(1);
+
+    // setup the dma channel paced by the pwm wrap
+    self_dma = this;
+    dma_channel = dma_claim_unused_channel(true);
+    dma_channel_config cfg = dma_channel_get_default_config(dma_channel);
+    channel_config_set_transfer_data_size(&cfg, DMA_SIZE_32);
+    channel_config_set_read_increment(&cfg, true);
+    channel_config_set_write_increment(&cfg, false);
+    channel_config_set_dreq(&cfg, pwm_get_dreq(slice));
+    dma_channel_configure(dma_channel, &cfg, &pwm_hw->slice[slice].cc,
+                          blocks[0].data(), block_frames, false);
+    dma_channel_set_irq0_enabled(dma_channel, true);
+    irq_add_shared_handler(DMA_IRQ_0, dmaCallbackPico,
+                           PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(DMA_IRQ_0, true);
+    play_block = 0;
+    dma_channel_start(dma_channel);
+    is_timer_started = true;
+  }
+
+  /// Converts one block of samples into cc values: pwm channel A in the
+  /// low, channel B in the high 16 bits
+  void fillBlock(int idx) {
+    uint32_t *data = blocks[idx].data();
+    int required = frame_size;
+    uint32_t silence = (maxOutputValue() + 1) >> 1;
+    for (int i = 0; i < block_frames; i++) {
+      uint32_t a = silence, b = silence;
+      if (buffer != nullptr && buffer->available() >= required) {
+        a = nextValue();
+        b = (audio_config.channels == 2) ? nextValue() : a;
+      } else {
+        underflow_count++;
+      }
+      // respect the pwm channel of the first pin
+      data[i] = (pins[0].channel == PWM_CHAN_A) ? (a | (b << 16))
+                                                : (b | (a << 16));
+      updateStatistics();
+    }
+  }
+
+  /// Restarts the dma with the other block and refills the finished one
+  void onBlockDone() {
+    dma_hw->ints0 = 1u << dma_channel;
+    int done = play_block;
+    play_block = 1 - done;
+    dma_channel_set_read_addr(dma_channel, blocks[play_block].data(), true);
+    fillBlock(done);
+  }
+
+  static void dmaCallbackPico() {
+    PWMDriverRP2040DMA *self = self_dma;
+    if (self != nullptr && self->dma_channel >= 0 &&
+        (dma_hw->ints0 & (1u << self->dma_channel))) {
+      self->onBlockDone();
+    }
+  }
+};
+
 }  // namespace audio_tools
 
 #endif
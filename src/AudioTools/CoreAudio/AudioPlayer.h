@@ -175,7 +175,7 @@ public:
           copier.setCallbackOnWrite(decodeMetaData, this);
         }
         copier.begin(out_decoding, *p_input_stream);
-        timeout = millis() + p_source->timeoutAutoNext();
+        timeout = p_clock->millis() + p_source->timeoutAutoNext();
         active = isActive;
         result = true;
       } else {
@@ -283,6 +283,25 @@ public:
     return active;
   }
 
+  /// Seeks to the indicated play time in seconds: the decoder translates
+  /// the time into a byte offset and the source repositions the stream, so
+  /// resuming at a position is instant instead of skipping through the data
+  bool seekTo(float seconds) {
+    TRACED();
+    if (p_decoder == nullptr || p_source == nullptr) return false;
+    int64_t offset = p_decoder->byteOffsetForTime(seconds);
+    if (offset < 0) {
+      LOGE("seekTo not supported by decoder");
+      return false;
+    }
+    if (!p_source->setPosition(static_cast<size_t>(offset))) {
+      LOGE("setPosition not supported by source");
+      return false;
+    }
+    timeout = p_clock->millis() + p_source->timeoutAutoNext();
+    return true;
+  }
+
   /// moves to previous file
   bool previous(int offset = 1) {
     TRACED();
@@ -355,6 +374,10 @@ public:
   /// Defines the wait time in ms if the target output is full
   void setDelayIfOutputFull(int delayMs) { delay_if_full = delayMs; }
 
+  /// Defines the clock for the timeout handling: tests can inject a
+  /// SimulatedClock
+  void setClock(AudioClockBase &clock) { p_clock = &clock; }
+
   /// Copies DEFAULT_BUFFER_SIZE (=1024 bytes) from the source to the decoder: Call this method in the loop.
   size_t copy() {
     return copy(copier.bufferSize());
@@ -377,7 +400,18 @@ public:
       result = copier.copyBytes(bytes);
       if (result > 0 || timeout == 0) {
         // reset timeout if we had any data
-        timeout = millis() + p_source->timeoutAutoNext();
+        timeout = p_clock->millis() + p_source->timeoutAutoNext();
+      }
+      // handle transient source stalls with faded silence
+      if (silence_on_underrun) {
+        if (result == 0 && p_input_stream != nullptr) {
+          handleUnderrun(bytes);
+        } else if (result > 0 && in_underrun) {
+          // the source recovered
+          in_underrun = false;
+          underrun_time_ms += p_clock->millis() - underrun_start_ms;
+          if (is_auto_fade) fade.setFadeInActive(true);
+        }
       }
       // move to next stream after timeout
       moveToNextFileOnTimeout();
@@ -430,6 +464,30 @@ public:
   /// Checks if silence_on_inactive has been activated (default false)
   bool isSilenceOnInactive() { return silence_on_inactive; }
 
+  /// If set to true a source stall does not drain the output: the last
+  /// sample is faded to 0 and silence is written until the source
+  /// recovers, so transient underruns stay glitch free (default false)
+  void setSilenceOnUnderrun(bool active) { silence_on_underrun = active; }
+
+  /// Checks if silence_on_underrun has been activated
+  bool isSilenceOnUnderrun() { return silence_on_underrun; }
+
+  /// Number of source underruns since the last reset
+  uint32_t underrunCount() { return underrun_count; }
+
+  /// Accumulated underrun duration in ms
+  uint32_t underrunTimeMs() {
+    uint32_t result = underrun_time_ms;
+    if (in_underrun) result += p_clock->millis() - underrun_start_ms;
+    return result;
+  }
+
+  /// Restarts the underrun accounting
+  void resetUnderrunStats() {
+    underrun_count = 0;
+    underrun_time_ms = 0;
+  }
+
   /// Sends the requested bytes as 0 values to the output
   void writeSilence(size_t bytes) {
     TRACEI();
@@ -462,6 +520,11 @@ protected:
   bool active = false;
   bool autonext = true;
   bool silence_on_inactive = false;
+  bool silence_on_underrun = false;
+  bool in_underrun = false;
+  uint32_t underrun_count = 0;
+  uint32_t underrun_time_ms = 0;
+  uint32_t underrun_start_ms = 0;
   AudioSource *p_source = nullptr;
   VolumeStream volume_out; // Volume control
   FadeStream fade;         // Phase in / Phase Out to avoid popping noise
@@ -477,6 +540,7 @@ protected:
   AudioInfo info;
   bool meta_active = false;
   uint32_t timeout = 0;
+  AudioClockBase *p_clock = &defaultClock();
   int stream_increment = 1;    // +1 moves forward; -1 moves backward
   float current_volume = -1.0f; // illegal value which will trigger an update
   int delay_if_full = 100;
@@ -495,7 +559,7 @@ protected:
       return;
     if (p_final_stream != nullptr && p_final_stream->availableForWrite() == 0)
         return;
-    if (p_input_stream == nullptr || millis() > timeout) {
+    if (p_input_stream == nullptr || p_clock->millis() > timeout) {
       if (is_auto_fade)
         fade.setFadeInActive(true);
       if (autonext) {
@@ -507,8 +571,27 @@ protected:
       } else {
         active = false;
       }
-      timeout = millis() + p_source->timeoutAutoNext();
+      timeout = p_clock->millis() + p_source->timeoutAutoNext();
+    }
+  }
+
+  /// The source stalled: fade the last sample to 0 on the first stalled
+  /// copy and keep the output fed with silence until the data resumes
+  void handleUnderrun(size_t bytes) {
+    if (!in_underrun) {
+      in_underrun = true;
+      underrun_count++;
+      underrun_start_ms = p_clock->millis();
+      LOGW("source underrun %d", (int)underrun_count);
+      // ramp the last sample down to 0 to avoid a pop
+      if (p_final_print != nullptr) {
+        fade.writeEnd(*p_final_print);
+      } else if (p_final_stream != nullptr) {
+        fade.writeEnd(*p_final_stream);
+      }
     }
+    // keep the DMA fed while the source recovers
+    writeSilence(bytes);
   }
 
   void writeEnd() {
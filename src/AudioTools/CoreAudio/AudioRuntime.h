@@ -35,6 +35,25 @@ inline void stop() {
   #endif
 }
 
+/// Sets the CPU frequency in MHz via the power management API: returns false
+/// on platforms which do not support frequency scaling  @ingroup basic
+inline bool setCpuMhz(uint32_t mhz) {
+    #if defined(ESP32) && defined(ARDUINO)
+        return setCpuFrequencyMhz(mhz);
+    #else
+        return false;
+    #endif
+}
+
+/// Provides the current CPU frequency in MHz (0 if not available)  @ingroup basic
+inline uint32_t getCpuMhz() {
+    #if defined(ESP32) && defined(ARDUINO)
+        return getCpuFrequencyMhz();
+    #else
+        return 0;
+    #endif
+}
+
 /// Executes heap_caps_check_integrity_all()  @ingroup basic
 inline static void checkMemory(bool printMemory=false) {
     #if defined(ESP32) && defined(ARDUINO)
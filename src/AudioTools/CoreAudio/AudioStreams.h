@@ -1,6 +1,7 @@
 #pragma once
 #include "AudioConfig.h"
 #include "AudioTools/CoreAudio/AudioTimer/AudioTimer.h"
+#include "AudioTools/CoreAudio/AudioClock.h"
 #include "AudioTools/CoreAudio/AudioTypes.h"
 #include "AudioTools/CoreAudio/Buffers.h"
 #include "AudioTools/CoreAudio/AudioLogger.h"
@@ -72,6 +73,12 @@ class ModifyingStream : public AudioStream {
   virtual void setStream(Stream& in) = 0;
   /// Defines/Changes the output target
   virtual void setOutput(Print& out) = 0;
+  /// Returns true if the stage can transform the data in place w/o any
+  /// buffer copies: such stages can be fused by the Pipeline
+  virtual bool isInPlace() { return false; }
+  /// In-place transformation of the provided block; returns the resulting
+  /// length. Only relevant when isInPlace() reports true.
+  virtual size_t transformInPlace(uint8_t* data, size_t len) { return len; }
 };
 
 /**
@@ -657,6 +664,14 @@ class ConverterStream : public ModifyingStream {
           return p_stream->available();
         }
 
+        /// converters transform the data in place
+        bool isInPlace() override { return p_converter != nullptr; }
+
+        size_t transformInPlace(uint8_t *data, size_t len) override {
+          if (p_converter == nullptr) return len;
+          return p_converter->convert(data, len);
+        }
+
     protected:
         Stream *p_stream = nullptr;
         Print *p_out = nullptr;
@@ -664,6 +679,28 @@ class ConverterStream : public ModifyingStream {
 
 };
 
+/**
+ * @brief Plain metrics snapshot provided by MeasuringStream::metrics():
+ * counters only, so it can be shipped as-is e.g. over MQTT
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ */
+struct AudioMetrics {
+  uint32_t bytes_per_second = 0;
+  uint32_t total_bytes = 0;
+  /// number of read/write operations
+  uint32_t operations = 0;
+  /// operations which returned no data (source/sink starved)
+  uint32_t underflows = 0;
+  /// short writes: the sink accepted less than offered
+  uint32_t overflows = 0;
+  uint32_t latency_min_us = 0;
+  uint32_t latency_max_us = 0;
+  uint32_t latency_avg_us = 0;
+  /// 95th percentile (upper bound of the log2 histogram bucket)
+  uint32_t latency_p95_us = 0;
+};
+
 /**
  * @brief Class which measures the thruput
  * @author Phil Schatzmann
@@ -702,6 +739,11 @@ class MeasuringStream : public ModifyingStream {
       p_logout = &out;
     }
 
+    /// Defines the clock: tests can inject a SimulatedClock
+    void setClock(AudioClockBase &clock){
+      p_clock = &clock;
+    }
+
     /// Defines/Changes the input & output
     void setStream(Stream& io) override {
       p_print = &io; 
@@ -717,7 +759,10 @@ class MeasuringStream : public ModifyingStream {
         /// Provides the data from all streams mixed together 
     size_t readBytes(uint8_t* data, size_t len) override {
       total_bytes_since_begin += len;
-      return measure(p_stream->readBytes(data, len));
+      uint32_t t0 = p_clock->micros();
+      size_t result = p_stream->readBytes(data, len);
+      recordOperation(t0, result, len, true);
+      return measure(result);
     }
 
     int available()  override {
@@ -727,7 +772,10 @@ class MeasuringStream : public ModifyingStream {
     /// Writes raw PCM audio data, which will be the input for the volume control 
     virtual size_t write(const uint8_t *data, size_t len) override {
       total_bytes_since_begin += len;
-      return measure(p_print->write(data, len));
+      uint32_t t0 = p_clock->micros();
+      size_t result = p_print->write(data, len);
+      recordOperation(t0, result, len, false);
+      return measure(result);
     }
 
     /// Provides the nubmer of bytes we can write
@@ -758,10 +806,45 @@ class MeasuringStream : public ModifyingStream {
 
     bool begin(){
       total_bytes_since_begin = 0;
-      ms_at_begin = millis();
+      ms_at_begin = p_clock->millis();
+      start_time = ms_at_begin;
+      total_bytes = 0;
+      count = max_count;
+      resetMetrics();
       return AudioStream::begin();
     }
 
+    /// Activates/deactivates the detailed latency metrics (default on)
+    void setMetricsActive(bool flag){
+      metrics_active = flag;
+    }
+
+    /// Pull API: provides all counters as a plain struct
+    AudioMetrics metrics() {
+      AudioMetrics result;
+      result.bytes_per_second = bytes_per_second;
+      result.total_bytes = total_bytes_since_begin;
+      result.operations = op_count;
+      result.underflows = underflow_count;
+      result.overflows = overflow_count;
+      result.latency_min_us = latency_min_us;
+      result.latency_max_us = latency_max_us;
+      result.latency_avg_us = op_count == 0 ? 0 : latency_sum_us / op_count;
+      result.latency_p95_us = latencyPercentileUs(95);
+      return result;
+    }
+
+    /// Resets all metrics counters
+    void resetMetrics() {
+      op_count = 0;
+      underflow_count = 0;
+      overflow_count = 0;
+      latency_min_us = 0;
+      latency_max_us = 0;
+      latency_sum_us = 0;
+      memset(latency_histogram, 0, sizeof(latency_histogram));
+    }
+
     bool begin(AudioInfo info){
       setAudioInfo(info);
       return begin();
@@ -783,7 +866,7 @@ class MeasuringStream : public ModifyingStream {
 
     /// Provides the time in ms since the last call of begin()
     uint32_t timeSinceBegin() {
-      return millis() - ms_at_begin;
+      return p_clock->millis() - ms_at_begin;
     }
 
     /// Provides the total processed bytes since the last call of begin()
@@ -829,13 +912,53 @@ class MeasuringStream : public ModifyingStream {
     const char* name = "";
     uint32_t ms_at_begin = 0;
     uint32_t total_bytes_since_begin = 0;
+    bool metrics_active = true;
+    AudioClockBase *p_clock = &defaultClock();
+    uint32_t op_count = 0;
+    uint32_t underflow_count = 0;
+    uint32_t overflow_count = 0;
+    uint32_t latency_min_us = 0;
+    uint32_t latency_max_us = 0;
+    uint64_t latency_sum_us = 0;
+    // log2 bucket histogram for the percentiles
+    uint32_t latency_histogram[32] = {0};
+
+    /// hot path metrics update: a few adds and compares only
+    void recordOperation(uint32_t t0, size_t result, size_t requested, bool is_read){
+      if (!metrics_active) return;
+      uint32_t dur = p_clock->micros() - t0;
+      op_count++;
+      latency_sum_us += dur;
+      if (op_count == 1 || dur < latency_min_us) latency_min_us = dur;
+      if (dur > latency_max_us) latency_max_us = dur;
+      int bucket = 0;
+      for (uint32_t v = dur; v > 1; v >>= 1) bucket++;
+      latency_histogram[bucket]++;
+      if (result == 0) {
+        underflow_count++;
+      } else if (!is_read && result < requested) {
+        overflow_count++;
+      }
+    }
+
+    /// provides the upper bucket bound of the requested latency percentile
+    uint32_t latencyPercentileUs(int percent) {
+      if (op_count == 0) return 0;
+      uint64_t limit = (uint64_t)op_count * percent / 100;
+      uint64_t cumulated = 0;
+      for (int j = 0; j < 32; j++) {
+        cumulated += latency_histogram[j];
+        if (cumulated >= limit) return 1UL << j;
+      }
+      return latency_max_us;
+    }
 
     size_t measure(size_t len) {
       count--;
       total_bytes+=len;
 
       if (count<=0){
-        uint32_t end_time = millis();
+        uint32_t end_time = p_clock->millis();
         int time_diff = end_time - start_time; // in ms
         if (time_diff>0){
           bytes_per_second = total_bytes / time_diff * 1000;
@@ -863,11 +986,194 @@ class MeasuringStream : public ModifyingStream {
     }
 };
 
+/// Checksum algorithm used by ChecksumStream
+enum class ChecksumType { CRC32, Adler32 };
+
+/**
+ * @brief CRC32 (IEEE, reflected, like zlib) with a slice by 8 table kernel:
+ * 8 bytes are folded per iteration with one table read each, which is
+ * several times faster than the single table version. The 8 KB of tables
+ * are shared and filled once at first use.
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ */
+class CRC32SliceBy8 {
+  public:
+    static CRC32SliceBy8 &instance() {
+      static CRC32SliceBy8 self;
+      return self;
+    }
+
+    /// Updates the crc with the indicated data (initial value is 0)
+    uint32_t update(uint32_t crc, const uint8_t *data, size_t len) {
+      uint32_t c = crc ^ 0xFFFFFFFF;
+      while (len >= 8) {
+        c ^= (uint32_t)data[0] | ((uint32_t)data[1] << 8) |
+             ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+        uint32_t hi = (uint32_t)data[4] | ((uint32_t)data[5] << 8) |
+                      ((uint32_t)data[6] << 16) | ((uint32_t)data[7] << 24);
+        c = t[7][c & 0xFF] ^ t[6][(c >> 8) & 0xFF] ^ t[5][(c >> 16) & 0xFF] ^
+            t[4][c >> 24] ^ t[3][hi & 0xFF] ^ t[2][(hi >> 8) & 0xFF] ^
+            t[1][(hi >> 16) & 0xFF] ^ t[0][hi >> 24];
+        data += 8;
+        len -= 8;
+      }
+      while (len-- > 0) {
+        c = (c >> 8) ^ t[0][(c ^ *data++) & 0xFF];
+      }
+      return c ^ 0xFFFFFFFF;
+    }
+
+  protected:
+    uint32_t t[8][256];
+
+    CRC32SliceBy8() {
+      for (int b = 0; b < 256; b++) {
+        uint32_t r = b;
+        for (int j = 0; j < 8; j++) {
+          r = (r & 1) ? (r >> 1) ^ 0xEDB88320 : r >> 1;
+        }
+        t[0][b] = r;
+      }
+      for (int k = 1; k < 8; k++) {
+        for (int b = 0; b < 256; b++) {
+          t[k][b] = (t[k - 1][b] >> 8) ^ t[0][t[k - 1][b] & 0xFF];
+        }
+      }
+    }
+};
+
+/**
+ * @brief Pass through stage which computes a running CRC32 or Adler32
+ * checksum over all the data which flows through it: e.g. in front of the
+ * encoder while recording, so that the file can be verified - or stamped
+ * with the checksum at finalize - without reading it back. The CRC32 uses
+ * the slice by 8 kernel, Adler32 needs no tables at all. Works in both
+ * directions: write() and readBytes() update the same checksum.
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ * @ingroup io
+ */
+class ChecksumStream : public ModifyingStream {
+  public:
+    ChecksumStream(ChecksumType type = ChecksumType::CRC32) {
+      setChecksumType(type);
+    }
+
+    ChecksumStream(Print &print, ChecksumType type = ChecksumType::CRC32) {
+      setChecksumType(type);
+      setOutput(print);
+    }
+
+    ChecksumStream(Stream &stream, ChecksumType type = ChecksumType::CRC32) {
+      setChecksumType(type);
+      setStream(stream);
+    }
+
+    /// Defines/Changes the input & output
+    void setStream(Stream &io) override {
+      p_print = &io;
+      p_stream = &io;
+    }
+
+    /// Defines/Changes the output target
+    void setOutput(Print &out) override { p_print = &out; }
+
+    /// Defines the checksum algorithm (and resets the checksum)
+    void setChecksumType(ChecksumType type) {
+      checksum_type = type;
+      resetChecksum();
+    }
+
+    bool begin() {
+      resetChecksum();
+      total_bytes = 0;
+      return AudioStream::begin();
+    }
+
+    size_t write(const uint8_t *data, size_t len) override {
+      size_t result = p_print == nullptr ? len : p_print->write(data, len);
+      // only the accepted bytes are part of the checksum
+      update(data, result);
+      return result;
+    }
+
+    size_t readBytes(uint8_t *data, size_t len) override {
+      if (p_stream == nullptr) return 0;
+      size_t result = p_stream->readBytes(data, len);
+      update(data, result);
+      return result;
+    }
+
+    int available() override {
+      return p_stream == nullptr ? 0 : p_stream->available();
+    }
+
+    int availableForWrite() override {
+      return p_print == nullptr ? DEFAULT_BUFFER_SIZE
+                                : p_print->availableForWrite();
+    }
+
+    /// the stage does not change the data, so it can be fused
+    bool isInPlace() override { return true; }
+
+    size_t transformInPlace(uint8_t *data, size_t len) override {
+      update(data, len);
+      return len;
+    }
+
+    /// Provides the current checksum value
+    uint32_t checksum() { return value; }
+
+    /// Provides the number of bytes which went into the checksum
+    uint64_t totalBytes() { return total_bytes; }
+
+    /// Restarts the checksum calculation
+    void resetChecksum() {
+      value = checksum_type == ChecksumType::Adler32 ? 1 : 0;
+    }
+
+  protected:
+    Print *p_print = nullptr;
+    Stream *p_stream = nullptr;
+    ChecksumType checksum_type = ChecksumType::CRC32;
+    uint32_t value = 0;
+    uint64_t total_bytes = 0;
+
+    void update(const uint8_t *data, size_t len) {
+      if (len == 0) return;
+      total_bytes += len;
+      if (checksum_type == ChecksumType::CRC32) {
+        value = CRC32SliceBy8::instance().update(value, data, len);
+      } else {
+        value = adler32(value, data, len);
+      }
+    }
+
+    /// Adler32 as defined in RFC 1950: the sums are reduced only every
+    /// 5552 bytes (the largest n before s2 can overflow)
+    uint32_t adler32(uint32_t adler, const uint8_t *data, size_t len) {
+      uint32_t s1 = adler & 0xFFFF;
+      uint32_t s2 = adler >> 16;
+      while (len > 0) {
+        size_t n = len < 5552 ? len : 5552;
+        len -= n;
+        while (n-- > 0) {
+          s1 += *data++;
+          s2 += s1;
+        }
+        s1 %= 65521;
+        s2 %= 65521;
+      }
+      return (s2 << 16) | s1;
+    }
+};
+
 /**
  * @brief Configuration for ProgressStream
  * @author Phil Schatzmann
  * @copyright GPLv3
- * 
+ *
  */
 class ProgressStreamInfo : public AudioInfo {
   public:
@@ -1059,6 +1365,11 @@ class Throttle : public ModifyingStream {
     p_out = &out;
   }
 
+  /// Defines the clock: tests can inject a SimulatedClock
+  void setClock(AudioClockBase &clock) {
+    p_clock = &clock;
+  }
+
   ThrottleConfig defaultConfig() {
     ThrottleConfig c;
     return c;
@@ -1080,14 +1391,44 @@ class Throttle : public ModifyingStream {
 
   bool begin(){ 
     frame_size = cfg.bits_per_sample / 8 * cfg.channels;
+#ifdef USE_TIMER
+    if (timed_mode) {
+      if (frames_per_tick == 0) {
+        // ~5 ms granularity by default
+        frames_per_tick = max(1, (int)(cfg.sample_rate / 200));
+      }
+      uint32_t period_us =
+          (uint64_t)frames_per_tick * 1000000 / cfg.sample_rate;
+      timer.setCallbackParameter(this);
+      timer.begin(throttleTimerCallback, period_us, US);
+    }
+#endif
     startDelay();
     return true;
   }
 
+#ifdef USE_TIMER
+  /// Activates hardware timer driven pacing: a repeating timer grants the
+  /// frame budget, so delayBytes() just blocks until the next tick instead
+  /// of recomputing elapsed micros per write. framesPerTick defines the
+  /// pacing granularity (0 = ~5 ms worth of frames).
+  void setTimedMode(bool active, int framesPerTick = 0) {
+    timed_mode = active;
+    frames_per_tick = framesPerTick;
+  }
+
+  void end() override {
+    if (timed_mode) timer.end();
+  }
+#endif
+
   // (re)starts the timing
   void startDelay() { 
-    start_time = micros(); 
+    start_time = p_clock->micros(); 
     sum_frames = 0;
+#ifdef USE_TIMER
+    tick_count = 0;
+#endif
   }
 
   int availableForWrite() {
@@ -1124,14 +1465,24 @@ class Throttle : public ModifyingStream {
   // delay
   void delayFrames(size_t frames) {
     sum_frames += frames;
-    uint64_t durationUsEff = micros() - start_time;
+#ifdef USE_TIMER
+    if (timed_mode) {
+      // block until the timer has granted enough frame budget: exact frame
+      // boundaries at near-zero CPU
+      while (sum_frames > (uint64_t)tick_count * frames_per_tick) {
+        delayMicroseconds(200);
+      }
+      return;
+    }
+#endif
+    uint64_t durationUsEff = p_clock->micros() - start_time;
     uint64_t durationUsToBe = getDelayUs(sum_frames);
     int64_t waitUs = durationUsToBe - durationUsEff + cfg.correction_us;
     LOGD("wait us: %ld", static_cast<long>(waitUs));
     if (waitUs > 0) {
       int64_t waitMs = waitUs / 1000;
-      if (waitMs > 0) delay(waitMs);
-      delayMicroseconds(waitUs - (waitMs * 1000));
+      if (waitMs > 0) p_clock->delay(waitMs);
+      p_clock->delayMicroseconds(waitUs - (waitMs * 1000));
     } else {
       LOGD("negative delay!")
     }
@@ -1153,9 +1504,20 @@ class Throttle : public ModifyingStream {
   uint32_t start_time = 0;
   uint32_t sum_frames = 0;
   ThrottleConfig cfg;
+  AudioClockBase *p_clock = &defaultClock();
   int frame_size = 0;
   Print *p_out = nullptr;
   Stream *p_in = nullptr;
+#ifdef USE_TIMER
+  TimerAlarmRepeating timer;
+  volatile uint32_t tick_count = 0;
+  int frames_per_tick = 0;
+  bool timed_mode = false;
+
+  static void throttleTimerCallback(void* obj) {
+    ((Throttle*)obj)->tick_count++;
+  }
+#endif
 };
 
 
@@ -1177,6 +1539,7 @@ class InputMixer : public AudioStream {
       streams.push_back(&in);
       weights.push_back(weight);
       total_weights += weight;
+      updateWeightsQ15();
     }
 
     /// Replaces a stream at the indicated channel
@@ -1204,6 +1567,7 @@ class InputMixer : public AudioStream {
           total += weights[j];
         }
         total_weights = total;
+        updateWeightsQ15();
       } else {
         LOGE("Invalid channel %d - max is %d", channel, size()-1);
       }
@@ -1213,6 +1577,7 @@ class InputMixer : public AudioStream {
     void end() override {
       streams.clear();
       weights.clear();
+      weights_q15.clear();
       result_vect.clear();
       current_vect.clear();
       total_weights = 0.0;
@@ -1259,6 +1624,7 @@ class InputMixer : public AudioStream {
   protected:
     Vector<Stream*> streams{0};
     Vector<int> weights{0}; 
+    Vector<int32_t> weights_q15{0};
     int total_weights = 0;
     int frame_size = 4;
     bool limit_available_data = false;
@@ -1266,7 +1632,10 @@ class InputMixer : public AudioStream {
     Vector<int> result_vect;
     Vector<T> current_vect;
 
-    /// mixing using a vector of samples
+    /// mixing using a vector of samples: the input blocks are accumulated
+    /// into an int32 scratch row with Q15 fixed point weights and the
+    /// saturation is applied once per output sample; the tight loops are
+    /// simple enough for the compiler to auto-vectorize
     int readBytesVector(T* p_data, int byteCount) {
       int samples = byteCount / sizeof(T);
       result_vect.resize(samples);
@@ -1279,14 +1648,12 @@ class InputMixer : public AudioStream {
           int samples_eff = readSamples(streams[j],current_vect.data(), samples, retry_count);
           if (samples_eff > samples_eff_max)
             samples_eff_max = samples_eff;
-          // if all weights are 0.0 we stop to output
-          float factor = total_weights == 0.0f ? 0.0f : static_cast<float>(weights[j]) / total_weights;
-          resultAdd(factor);
+          resultAddQ15(weights_q15[j]);
         }
       }
-      // copy result
+      // saturate and copy result
       for (int j=0;j<samples;j++){
-        p_data[j] = result_vect[j];
+        p_data[j] = clipResult(result_vect[j]);
       }
       return samples_eff_max * sizeof(T);
     }
@@ -1300,10 +1667,36 @@ class InputMixer : public AudioStream {
       return result;
     }
 
-    void resultAdd(float fact){
-      for (int j=0;j<current_vect.size();j++){
-        current_vect[j]*=fact;
-        result_vect[j] += current_vect[j];
+    /// accumulates a whole input block with a Q15 weight: no per sample
+    /// float math
+    void resultAddQ15(int32_t weight){
+      int n = current_vect.size();
+      const T* in = current_vect.data();
+      int* acc = result_vect.data();
+      for (int j=0;j<n;j++){
+        if (sizeof(T) <= 2) {
+          acc[j] += ((int32_t)in[j] * weight) >> 15;
+        } else {
+          acc[j] += (int32_t)(((int64_t)in[j] * weight) >> 15);
+        }
+      }
+    }
+
+    /// saturates an accumulated value to the range of T
+    T clipResult(int32_t value){
+      const int32_t mv = (int32_t)NumberConverter::maxValue(sizeof(T)*8);
+      if (value > mv) return mv;
+      if (value < -mv) return -mv;
+      return value;
+    }
+
+    /// precomputes the normalized Q15 weights
+    void updateWeightsQ15(){
+      weights_q15.resize(weights.size());
+      for (int j=0;j<weights.size();j++){
+        weights_q15[j] = total_weights == 0
+            ? 0
+            : (int32_t)(((int64_t)weights[j] << 15) / total_weights);
       }
     }
 
@@ -1351,20 +1744,38 @@ class InputMerge : public AudioStream {
       return AudioStream::begin();
     }
 
-    /// Provides the data from all streams mixed together
+    /// Provides the data from all streams mixed together: each input is
+    /// read as one block into planar scratch and then interleaved, so the
+    /// per sample stream reads of the scalar version are avoided
     size_t readBytes(uint8_t* data, size_t len) override {
       LOGD("readBytes: %d",(int)len);
-      T *p_data = (T*) data;
-      int result_len = MIN(available(), len/size());
-      int sample_count = result_len / sizeof(T);
       int size_value = size();
-      int result_idx = 0;
-      for (int j=0;j<sample_count; j++){
-        for (int i=0; i<size_value; i++){
-          p_data[result_idx++] = weights[i] * readSample<T>(streams[i]);
+      if (size_value == 0) return 0;
+      setupPlanar();
+      int frames_requested = len / (size_value * sizeof(T));
+      int channel_bytes = frames_requested * sizeof(T);
+
+      // block read per input: short reads are reconciled per block by
+      // clamping to the smallest fill level and carrying the surplus over
+      int min_filled = channel_bytes;
+      for (int i=0; i<size_value; i++){
+        if ((int)planar[i].size() < channel_bytes) planar[i].resize(channel_bytes);
+        int open = channel_bytes - filled[i];
+        if (open > 0){
+          filled[i] += streams[i]->readBytes(planar[i].data()+filled[i], open);
         }
+        if (filled[i] < min_filled) min_filled = filled[i];
+      }
+      int frames = min_filled / sizeof(T);
+      interleave((T*)data, frames);
+
+      // keep any surplus of the faster inputs for the next call
+      int consumed = frames * sizeof(T);
+      for (int i=0; i<size_value; i++){
+        filled[i] -= consumed;
+        if (filled[i] > 0) memmove(planar[i].data(), planar[i].data()+consumed, filled[i]);
       }
-      return result_idx*sizeof(T);
+      return frames * size_value * sizeof(T);
     }
 
     /// Adds a new input stream
@@ -1407,7 +1818,48 @@ class InputMerge : public AudioStream {
 
   protected:
     Vector<Stream*> streams{10};
-    Vector<float> weights{10}; 
+    Vector<float> weights{10};
+    Vector<Vector<uint8_t>> planar;
+    Vector<int> filled;
+
+    /// (re-)creates the planar scratch buffers when the inputs changed
+    void setupPlanar(){
+      if ((int)planar.size() != size()){
+        planar.resize(size());
+        filled.resize(size());
+        for (int i=0; i<size(); i++) filled[i] = 0;
+      }
+    }
+
+    /// checks if all weights are 1.0 so that the scaling can be skipped
+    bool isUnityWeights(){
+      for (int i=0; i<size(); i++){
+        if (weights[i] != 1.0f) return false;
+      }
+      return true;
+    }
+
+    /// interleaves the planar scratch buffers into the result frames
+    void interleave(T* p_data, int frames){
+      int size_value = size();
+      if (sizeof(T)==2 && size_value==2 && isUnityWeights()){
+        // word-wise kernel: two int16 lanes packed as one 32 bit store
+        const uint16_t *left = (const uint16_t*) planar[0].data();
+        const uint16_t *right = (const uint16_t*) planar[1].data();
+        uint32_t *frame = (uint32_t*) p_data;
+        for (int j=0; j<frames; j++){
+          frame[j] = (uint32_t)left[j] | ((uint32_t)right[j] << 16);
+        }
+        return;
+      }
+      int result_idx = 0;
+      for (int j=0; j<frames; j++){
+        for (int i=0; i<size_value; i++){
+          T* channel = (T*) planar[i].data();
+          p_data[result_idx++] = weights[i] * channel[j];
+        }
+      }
+    }
 };
 
 
@@ -1657,6 +2109,14 @@ class FilteredStream : public ModifyingStream {
           setFilter(channel, &filter);
         }
 
+        /// the filters are applied in place on the provided block
+        bool isInPlace() override { return p_converter != nullptr; }
+
+        size_t transformInPlace(uint8_t *data, size_t len) override {
+          if (p_converter == nullptr) return len;
+          return p_converter->convert(data, len);
+        }
+
     protected:
         int channels=0;
         Stream *p_stream = nullptr;
@@ -1705,9 +2165,20 @@ public:
     if (info.channels > 0) {
       volumes.resize(info.channels);
       volumes_tmp.resize(info.channels);
+      sum.resize(info.channels);
+      sum_tmp.resize(info.channels);
     }
   }
 
+  /// Defines the exponential decay per processed block (0.0 - 1.0): with
+  /// e.g. 0.9 the reported volume falls back gradually instead of dropping
+  /// to the level of the next block (0 = no decay)
+  void setDecay(float factor) {
+    if (factor < 0.0f) factor = 0.0f;
+    if (factor >= 1.0f) factor = 0.0f;
+    decay_factor = factor;
+  }
+
   size_t write(const uint8_t *data, size_t len) {
     updateVolumes(data, len);
     size_t result = len;
@@ -1728,6 +2199,12 @@ public:
   /// bits_per_sample.
   float volume() { return f_volume; }
 
+  /// Volume (max amplitude) as integer: no float conversion on the reader
+  int32_t volumeInt() { return (int32_t)f_volume; }
+
+  /// Volume of the indicated channel as integer
+  int32_t volumeInt(int channel) { return (int32_t)volume(channel); }
+
   /// Determines the volume for the indicated channel. You must call the begin
   /// method to define the number of channels
   float volume(int channel) {
@@ -1789,7 +2266,7 @@ public:
   /// Resets the actual volume
   void clear() {
     f_volume_tmp = 0;
-    for (int j = 0; j < info.channels; j++) {
+    for (int j = 0; j < (int)volumes_tmp.size(); j++) {
       volumes_tmp[j] = 0;
       sum_tmp[j] = 0;
     }
@@ -1806,6 +2283,7 @@ public:
 protected:
   float f_volume_tmp = 0;
   float f_volume = 0;
+  float decay_factor = 0.0f;
   Vector<float> volumes{0};
   Vector<float> volumes_tmp{0};
   Vector<float> sum{0};
@@ -1838,32 +2316,44 @@ protected:
   template <typename T> void updateVolumesT(const uint8_t *buffer, size_t size) {
     T *bufferT = (T *)buffer;
     int samplesCount = size / sizeof(T);
-    sample_count_per_channel = samplesCount / info.channels;
-    for (int j = 0; j < samplesCount; j++) {
-      float tmp = abs(static_cast<float>(bufferT[j]));
-      updateVolume(tmp, j);
-    }
-    commit();
-  }
-
-  void updateVolume(float tmp, int j) {
-    if (tmp > f_volume_tmp) {
-      f_volume_tmp = tmp;
-    }
-    if (volumes_tmp.size() > 0 && info.channels > 0) {
-      int ch = j % info.channels;
-      if (tmp > volumes_tmp[ch]) {
-        volumes_tmp[ch] = tmp;
-        sum_tmp[ch] = tmp;
+    int channels = info.channels > 0 ? info.channels : 1;
+    sample_count_per_channel = samplesCount / channels;
+    // per channel abs-max/abs-sum with integer ops only: the float
+    // conversion happens once per block and channel
+    for (int ch = 0; ch < channels; ch++) {
+      int32_t max_value = 0;
+      int64_t sum_value = 0;
+      for (int j = ch; j < samplesCount; j += channels) {
+        int32_t value = static_cast<int32_t>(bufferT[j]);
+        value = value < 0 ? -value : value;
+        if (value > max_value) max_value = value;
+        sum_value += value;
       }
+      if ((int)volumes_tmp.size() > ch) {
+        volumes_tmp[ch] = max_value;
+        sum_tmp[ch] = sum_value;
+      }
+      if ((float)max_value > f_volume_tmp) f_volume_tmp = max_value;
     }
+    commit();
   }
 
   void commit() {
-    f_volume = f_volume_tmp;
-    for (int j = 0; j < info.channels; j++) {
-      volumes[j] = volumes_tmp[j];
-      sum[j] = sum_tmp[j];
+    if (decay_factor > 0.0f) {
+      // exponential decay once per block: the volume falls back gradually
+      f_volume *= decay_factor;
+      if (f_volume_tmp > f_volume) f_volume = f_volume_tmp;
+      for (int j = 0; j < (int)volumes.size(); j++) {
+        volumes[j] *= decay_factor;
+        if (volumes_tmp[j] > volumes[j]) volumes[j] = volumes_tmp[j];
+        sum[j] = sum_tmp[j];
+      }
+    } else {
+      f_volume = f_volume_tmp;
+      for (int j = 0; j < (int)volumes.size(); j++) {
+        volumes[j] = volumes_tmp[j];
+        sum[j] = sum_tmp[j];
+      }
     }
   }
 };
@@ -315,6 +315,181 @@ class ChannelFormatConverterStream : public ReformatBaseStream {
   }
 };
 
+/**
+ * @brief Shift-only number format conversion: the generic template reports
+ * that no fast path is available; the specializations below handle the
+ * pairs which are pure shifts (16<->24, 16<->32) with 4 samples per
+ * iteration, avoiding the float scaling of NumberConverter::convertArray.
+ * @ingroup transform
+ */
+template <typename TFrom, typename TTo>
+inline bool convertShiftArray(TFrom *from, TTo *to, size_t samples) {
+  return false;
+}
+
+template <>
+inline bool convertShiftArray<int16_t, int32_t>(int16_t *from, int32_t *to,
+                                                size_t samples) {
+  size_t n4 = samples & ~(size_t)3;
+  for (size_t j = 0; j < n4; j += 4) {
+    to[j] = (int32_t)from[j] << 16;
+    to[j + 1] = (int32_t)from[j + 1] << 16;
+    to[j + 2] = (int32_t)from[j + 2] << 16;
+    to[j + 3] = (int32_t)from[j + 3] << 16;
+  }
+  for (size_t j = n4; j < samples; j++) to[j] = (int32_t)from[j] << 16;
+  return true;
+}
+
+template <>
+inline bool convertShiftArray<int32_t, int16_t>(int32_t *from, int16_t *to,
+                                                size_t samples) {
+  size_t n4 = samples & ~(size_t)3;
+  for (size_t j = 0; j < n4; j += 4) {
+    to[j] = (int16_t)(from[j] >> 16);
+    to[j + 1] = (int16_t)(from[j + 1] >> 16);
+    to[j + 2] = (int16_t)(from[j + 2] >> 16);
+    to[j + 3] = (int16_t)(from[j + 3] >> 16);
+  }
+  for (size_t j = n4; j < samples; j++) to[j] = (int16_t)(from[j] >> 16);
+  return true;
+}
+
+template <>
+inline bool convertShiftArray<int16_t, int24_t>(int16_t *from, int24_t *to,
+                                                size_t samples) {
+  size_t n4 = samples & ~(size_t)3;
+  for (size_t j = 0; j < n4; j += 4) {
+    to[j] = int24_t((int32_t)from[j] << 8);
+    to[j + 1] = int24_t((int32_t)from[j + 1] << 8);
+    to[j + 2] = int24_t((int32_t)from[j + 2] << 8);
+    to[j + 3] = int24_t((int32_t)from[j + 3] << 8);
+  }
+  for (size_t j = n4; j < samples; j++) to[j] = int24_t((int32_t)from[j] << 8);
+  return true;
+}
+
+template <>
+inline bool convertShiftArray<int24_t, int16_t>(int24_t *from, int16_t *to,
+                                                size_t samples) {
+  size_t n4 = samples & ~(size_t)3;
+  for (size_t j = 0; j < n4; j += 4) {
+    to[j] = (int16_t)((int32_t)from[j] >> 8);
+    to[j + 1] = (int16_t)((int32_t)from[j + 1] >> 8);
+    to[j + 2] = (int16_t)((int32_t)from[j + 2] >> 8);
+    to[j + 3] = (int16_t)((int32_t)from[j + 3] >> 8);
+  }
+  for (size_t j = n4; j < samples; j++) to[j] = (int16_t)((int32_t)from[j] >> 8);
+  return true;
+}
+
+template <>
+inline bool convertShiftArray<int24_3bytes_t, int32_t>(int24_3bytes_t *from,
+                                                       int32_t *to,
+                                                       size_t samples) {
+  // word wide kernel: 4 packed little endian 24 bit samples (12 bytes) are
+  // loaded as 3 words and shuffled into 4 int32 samples - no per sample
+  // byte assembly
+  size_t n4 = samples & ~(size_t)3;
+  const uint8_t *src = (const uint8_t *)from;
+  for (size_t j = 0; j < n4; j += 4) {
+    uint32_t w[3];
+    memcpy(w, src, 12);
+    src += 12;
+    to[j] = (int32_t)(w[0] << 8);
+    to[j + 1] = (int32_t)(((w[0] >> 24) | (w[1] << 8)) << 8);
+    to[j + 2] = (int32_t)((w[1] >> 16 << 8) | (w[2] << 24));
+    to[j + 3] = (int32_t)(w[2] & 0xFFFFFF00);
+  }
+  for (size_t j = n4; j < samples; j++)
+    to[j] = (int32_t)from[j].toInt() << 8;
+  return true;
+}
+
+template <>
+inline bool convertShiftArray<int32_t, int24_3bytes_t>(int32_t *from,
+                                                       int24_3bytes_t *to,
+                                                       size_t samples) {
+  // reverse word wide kernel: 4 int32 samples are shuffled into 3 words of
+  // packed little endian 24 bit samples
+  size_t n4 = samples & ~(size_t)3;
+  uint8_t *dst = (uint8_t *)to;
+  for (size_t j = 0; j < n4; j += 4) {
+    uint32_t t0 = (uint32_t)from[j] >> 8;
+    uint32_t t1 = (uint32_t)from[j + 1] >> 8;
+    uint32_t t2 = (uint32_t)from[j + 2] >> 8;
+    uint32_t t3 = (uint32_t)from[j + 3] >> 8;
+    uint32_t w[3];
+    w[0] = t0 | (t1 << 24);
+    w[1] = (t1 >> 8) | (t2 << 16);
+    w[2] = (t2 >> 16) | (t3 << 8);
+    memcpy(dst, w, 12);
+    dst += 12;
+  }
+  for (size_t j = n4; j < samples; j++)
+    to[j] = int24_3bytes_t((int32_t)(from[j] >> 8));
+  return true;
+}
+
+template <>
+inline bool convertShiftArray<int24_4bytes_t, int32_t>(int24_4bytes_t *from,
+                                                       int32_t *to,
+                                                       size_t samples) {
+  // the 4 byte int24 already stores the sample shifted left by 8 bits, so
+  // the scaled int32 is just the raw word
+  memcpy(to, from, samples * sizeof(int32_t));
+  return true;
+}
+
+template <>
+inline bool convertShiftArray<int32_t, int24_4bytes_t>(int32_t *from,
+                                                       int24_4bytes_t *to,
+                                                       size_t samples) {
+  // keep only the upper 24 bits: this is the raw format of the 4 byte int24
+  int32_t *to32 = (int32_t *)to;
+  size_t n4 = samples & ~(size_t)3;
+  for (size_t j = 0; j < n4; j += 4) {
+    to32[j] = from[j] & 0xFFFFFF00;
+    to32[j + 1] = from[j + 1] & 0xFFFFFF00;
+    to32[j + 2] = from[j + 2] & 0xFFFFFF00;
+    to32[j + 3] = from[j + 3] & 0xFFFFFF00;
+  }
+  for (size_t j = n4; j < samples; j++) to32[j] = from[j] & 0xFFFFFF00;
+  return true;
+}
+
+template <>
+inline bool convertShiftArray<float16, FloatAudio>(float16 *from,
+                                                   FloatAudio *to,
+                                                   size_t samples) {
+  // fp16 storage to float compute: a plain per sample cast, no scaling
+  size_t n4 = samples & ~(size_t)3;
+  for (size_t j = 0; j < n4; j += 4) {
+    to[j] = FloatAudio((float)from[j]);
+    to[j + 1] = FloatAudio((float)from[j + 1]);
+    to[j + 2] = FloatAudio((float)from[j + 2]);
+    to[j + 3] = FloatAudio((float)from[j + 3]);
+  }
+  for (size_t j = n4; j < samples; j++) to[j] = FloatAudio((float)from[j]);
+  return true;
+}
+
+template <>
+inline bool convertShiftArray<FloatAudio, float16>(FloatAudio *from,
+                                                   float16 *to,
+                                                   size_t samples) {
+  // float compute to fp16 storage: a plain per sample cast, no scaling
+  size_t n4 = samples & ~(size_t)3;
+  for (size_t j = 0; j < n4; j += 4) {
+    to[j] = float16((float)from[j]);
+    to[j + 1] = float16((float)from[j + 1]);
+    to[j + 2] = float16((float)from[j + 2]);
+    to[j + 3] = float16((float)from[j + 3]);
+  }
+  for (size_t j = n4; j < samples; j++) to[j] = float16((float)from[j]);
+  return true;
+}
+
 /**
  * @brief A more generic templated Converter which converts from a source type to a
  * target type: You can use e.g. uint8_t, int8_t, int16_t, uint16_t, int24_t, uint32_t, int32_t, FloatAudio.AbstractMetaDat.
@@ -381,8 +556,13 @@ class NumberFormatConverterStreamT : public ReformatBaseStream {
     } else {
       int size_bytes = sizeof(TTo) * samples;
       buffer.resize(size_bytes);
-      NumberConverter::convertArray<TFrom, TTo>(
-          data_source, (TTo *)buffer.data(), samples, gain);
+      // use the unrolled shift-only fast path when possible
+      if (gain != 1.0f ||
+          !convertShiftArray<TFrom, TTo>(data_source, (TTo *)buffer.data(),
+                                         samples)) {
+        NumberConverter::convertArray<TFrom, TTo>(
+            data_source, (TTo *)buffer.data(), samples, gain);
+      }
       p_print->write((uint8_t *)buffer.address(), size_bytes);
       buffer.reset();
     }
@@ -406,8 +586,12 @@ class NumberFormatConverterStreamT : public ReformatBaseStream {
       buffer.resize(sizeof(TFrom) * samples);
       readSamples<TFrom>(p_stream, (TFrom *)buffer.address(), samples);
       TFrom *data = (TFrom *)buffer.address();
-      NumberConverter::convertArray<TFrom, TTo>(data, data_target, samples,
-                                                gain);
+      // use the unrolled shift-only fast path when possible
+      if (gain != 1.0f ||
+          !convertShiftArray<TFrom, TTo>(data, data_target, samples)) {
+        NumberConverter::convertArray<TFrom, TTo>(data, data_target, samples,
+                                                  gain);
+      }
       buffer.reset();
     }
     return len;
@@ -488,6 +672,11 @@ class NumberFormatConverterStream : public ReformatBaseStream {
 
   void setToBits(uint8_t bits) { to_bit_per_samples = bits; }
 
+  /// Treats the 16 bit side as float16 storage and the 32 bit side as float:
+  /// memory bound DSP can trade precision for capacity explicitly. Call
+  /// before begin()
+  void setFloat16(bool active) { is_float16 = active; }
+
   bool begin(int from_bit_per_samples, int to_bit_per_samples,
              float gain = 1.0) {
     assert(to_bit_per_samples > 0);
@@ -509,6 +698,12 @@ class NumberFormatConverterStream : public ReformatBaseStream {
       converter = new NumberFormatConverterStreamT<int24_t, int16_t>(gain);
     } else if (from_bit_per_samples == 16 && to_bit_per_samples == 24) {
       converter = new NumberFormatConverterStreamT<int16_t, int24_t>(gain);
+    } else if (is_float16 && from_bit_per_samples == 32 &&
+               to_bit_per_samples == 16) {
+      converter = new NumberFormatConverterStreamT<FloatAudio, float16>(gain);
+    } else if (is_float16 && from_bit_per_samples == 16 &&
+               to_bit_per_samples == 32) {
+      converter = new NumberFormatConverterStreamT<float16, FloatAudio>(gain);
     } else if (from_bit_per_samples == 32 && to_bit_per_samples == 16) {
       converter = new NumberFormatConverterStreamT<int32_t, int16_t>(gain);
     } else if (from_bit_per_samples == 16 && to_bit_per_samples == 32) {
@@ -544,6 +739,12 @@ class NumberFormatConverterStream : public ReformatBaseStream {
       return getConverter<int24_t, int16_t>()->write(data, len);
     } else if (from_bit_per_samples == 16 && to_bit_per_samples == 24) {
       return getConverter<int16_t, int24_t>()->write(data, len);
+    } else if (is_float16 && from_bit_per_samples == 32 &&
+               to_bit_per_samples == 16) {
+      return getConverter<FloatAudio, float16>()->write(data, len);
+    } else if (is_float16 && from_bit_per_samples == 16 &&
+               to_bit_per_samples == 32) {
+      return getConverter<float16, FloatAudio>()->write(data, len);
     } else if (from_bit_per_samples == 32 && to_bit_per_samples == 16) {
       return getConverter<int32_t, int16_t>()->write(data, len);
     } else if (from_bit_per_samples == 16 && to_bit_per_samples == 32) {
@@ -568,6 +769,12 @@ class NumberFormatConverterStream : public ReformatBaseStream {
       return getConverter<int24_t, int16_t>()->readBytes(data, len);
     } else if (from_bit_per_samples == 16 && to_bit_per_samples == 24) {
       return getConverter<int16_t, int24_t>()->readBytes(data, len);
+    } else if (is_float16 && from_bit_per_samples == 32 &&
+               to_bit_per_samples == 16) {
+      return getConverter<FloatAudio, float16>()->readBytes(data, len);
+    } else if (is_float16 && from_bit_per_samples == 16 &&
+               to_bit_per_samples == 32) {
+      return getConverter<float16, FloatAudio>()->readBytes(data, len);
     } else if (from_bit_per_samples == 32 && to_bit_per_samples == 16) {
       return getConverter<int32_t, int16_t>()->readBytes(data, len);
     } else if (from_bit_per_samples == 16 && to_bit_per_samples == 32) {
@@ -590,6 +797,12 @@ class NumberFormatConverterStream : public ReformatBaseStream {
       return getConverter<int24_t, int16_t>()->available();
     } else if (from_bit_per_samples == 16 && to_bit_per_samples == 24) {
       return getConverter<int16_t, int24_t>()->available();
+    } else if (is_float16 && from_bit_per_samples == 32 &&
+               to_bit_per_samples == 16) {
+      return getConverter<FloatAudio, float16>()->available();
+    } else if (is_float16 && from_bit_per_samples == 16 &&
+               to_bit_per_samples == 32) {
+      return getConverter<float16, FloatAudio>()->available();
     } else if (from_bit_per_samples == 32 && to_bit_per_samples == 16) {
       return getConverter<int32_t, int16_t>()->available();
     } else if (from_bit_per_samples == 16 && to_bit_per_samples == 32) {
@@ -613,6 +826,12 @@ class NumberFormatConverterStream : public ReformatBaseStream {
       return getConverter<int24_t, int16_t>()->availableForWrite();
     } else if (from_bit_per_samples == 16 && to_bit_per_samples == 24) {
       return getConverter<int16_t, int24_t>()->availableForWrite();
+    } else if (is_float16 && from_bit_per_samples == 32 &&
+               to_bit_per_samples == 16) {
+      return getConverter<FloatAudio, float16>()->availableForWrite();
+    } else if (is_float16 && from_bit_per_samples == 16 &&
+               to_bit_per_samples == 32) {
+      return getConverter<float16, FloatAudio>()->availableForWrite();
     } else if (from_bit_per_samples == 32 && to_bit_per_samples == 16) {
       return getConverter<int32_t, int16_t>()->availableForWrite();
     } else if (from_bit_per_samples == 16 && to_bit_per_samples == 32) {
@@ -632,6 +851,12 @@ class NumberFormatConverterStream : public ReformatBaseStream {
       getConverter<int24_t, int16_t>()->setBuffered(flag);
     } else if (from_bit_per_samples == 16 && to_bit_per_samples == 24) {
       getConverter<int16_t, int24_t>()->setBuffered(flag);
+    } else if (is_float16 && from_bit_per_samples == 32 &&
+               to_bit_per_samples == 16) {
+      getConverter<FloatAudio, float16>()->setBuffered(flag);
+    } else if (is_float16 && from_bit_per_samples == 16 &&
+               to_bit_per_samples == 32) {
+      getConverter<float16, FloatAudio>()->setBuffered(flag);
     } else if (from_bit_per_samples == 32 && to_bit_per_samples == 16) {
       getConverter<int32_t, int16_t>()->setBuffered(flag);
     } else if (from_bit_per_samples == 16 && to_bit_per_samples == 32) {
@@ -649,6 +874,7 @@ class NumberFormatConverterStream : public ReformatBaseStream {
   int from_bit_per_samples = 16;
   int to_bit_per_samples = 0;
   float gain = 1.0;
+  bool is_float16 = false;
 
   template <typename TFrom, typename TTo>
   NumberFormatConverterStreamT<TFrom, TTo> *getConverter() {
@@ -665,6 +891,12 @@ class NumberFormatConverterStream : public ReformatBaseStream {
         getConverter<int24_t, int16_t>()->setStream(*p_stream);
       } else if (from_bit_per_samples == 16 && to_bit_per_samples == 24) {
         getConverter<int16_t, int24_t>()->setStream(*p_stream);
+      } else if (is_float16 && from_bit_per_samples == 32 &&
+                 to_bit_per_samples == 16) {
+        getConverter<FloatAudio, float16>()->setStream(*p_stream);
+      } else if (is_float16 && from_bit_per_samples == 16 &&
+                 to_bit_per_samples == 32) {
+        getConverter<float16, FloatAudio>()->setStream(*p_stream);
       } else if (from_bit_per_samples == 32 && to_bit_per_samples == 16) {
         getConverter<int32_t, int16_t>()->setStream(*p_stream);
       } else if (from_bit_per_samples == 16 && to_bit_per_samples == 32) {
@@ -681,6 +913,12 @@ class NumberFormatConverterStream : public ReformatBaseStream {
         getConverter<int24_t, int16_t>()->setOutput(*p_print);
       } else if (from_bit_per_samples == 16 && to_bit_per_samples == 24) {
         getConverter<int16_t, int24_t>()->setOutput(*p_print);
+      } else if (is_float16 && from_bit_per_samples == 32 &&
+                 to_bit_per_samples == 16) {
+        getConverter<FloatAudio, float16>()->setOutput(*p_print);
+      } else if (is_float16 && from_bit_per_samples == 16 &&
+                 to_bit_per_samples == 32) {
+        getConverter<float16, FloatAudio>()->setOutput(*p_print);
       } else if (from_bit_per_samples == 32 && to_bit_per_samples == 16) {
         getConverter<int32_t, int16_t>()->setOutput(*p_print);
       } else if (from_bit_per_samples == 16 && to_bit_per_samples == 32) {
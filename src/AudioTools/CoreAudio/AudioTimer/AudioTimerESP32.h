@@ -39,10 +39,13 @@ class UserCallback {
 
 } static *simpleUserCallback = nullptr;
 
-static IRAM_ATTR void userCallback0() { simpleUserCallback[0].call(); }
-static IRAM_ATTR void userCallback1() { simpleUserCallback[1].call(); }
-static IRAM_ATTR void userCallback2() { simpleUserCallback[2].call(); }
-static IRAM_ATTR void userCallback3() { simpleUserCallback[3].call(); }
+// fractional tick correction (defined after the driver class)
+static void timerFracTick(int id);
+
+static IRAM_ATTR void userCallback0() { simpleUserCallback[0].call(); timerFracTick(0); }
+static IRAM_ATTR void userCallback1() { simpleUserCallback[1].call(); timerFracTick(1); }
+static IRAM_ATTR void userCallback2() { simpleUserCallback[2].call(); timerFracTick(2); }
+static IRAM_ATTR void userCallback3() { simpleUserCallback[3].call(); timerFracTick(3); }
 
 /**
  * @brief Internal class to manage the different timer callbacks for the 4
@@ -84,10 +87,15 @@ class TimerCallback {
 
 } static *timerCallbackArray = nullptr;
 
-static IRAM_ATTR void timerCallback0() { timerCallbackArray[0].call(); }
-static IRAM_ATTR void timerCallback1() { timerCallbackArray[1].call(); }
-static IRAM_ATTR void timerCallback2() { timerCallbackArray[2].call(); }
-static IRAM_ATTR void timerCallback3() { timerCallbackArray[3].call(); }
+static IRAM_ATTR void timerCallback0() { timerCallbackArray[0].call(); timerFracTick(0); }
+static IRAM_ATTR void timerCallback1() { timerCallbackArray[1].call(); timerFracTick(1); }
+static IRAM_ATTR void timerCallback2() { timerCallbackArray[2].call(); timerFracTick(2); }
+static IRAM_ATTR void timerCallback3() { timerCallbackArray[3].call(); timerFracTick(3); }
+
+// drivers with an active fractional tick correction by timer id
+class TimerAlarmRepeatingDriverESP32;
+static TimerAlarmRepeatingDriverESP32 *fracTimerDrivers[4] = {nullptr, nullptr,
+                                                              nullptr, nullptr};
 
 /**
  * @brief Repeating Timer functions for simple scheduling of repeated execution.
@@ -140,6 +148,17 @@ class TimerAlarmRepeatingDriverESP32 : public TimerAlarmRepeatingDriverBase {
       case HZ:
         // convert hz to time in us
         timeUs = AudioTime::toTimeUs(time);
+        // fractional tick correction: we start from the floor period and
+        // the isr alternates long and short alarms, so the average rate
+        // is exact (44100 Hz stays 44100 Hz and not 44091 Hz)
+        rate_hz = time;
+        frac_rem = 1000000ul % time;
+        if (frac_rem != 0) {
+          timeUs = 1000000ul / time;
+          alarm_us = timeUs;
+          frac_accum = 0;
+          fracTimerDrivers[timer_id] = this;
+        }
         break;
     }
 #if ESP_IDF_VERSION < ESP_IDF_VERSION_VAL(5, 1, 0)
@@ -169,9 +188,31 @@ class TimerAlarmRepeatingDriverESP32 : public TimerAlarmRepeatingDriverBase {
     return true;
   }
 
+  /// Accumulates the missing microseconds and reprograms the alarm with
+  /// a long tick when a full microsecond is due: called from the timer
+  /// isr via timerFracTick()
+  IRAM_ATTR void applyFracTick() {
+    if (frac_rem == 0) return;
+    frac_accum += frac_rem;
+    uint32_t next = timeUs;
+    if (frac_accum >= rate_hz) {
+      frac_accum -= rate_hz;
+      next++;
+    }
+    if (next != alarm_us) {
+      alarm_us = next;
+#if ESP_IDF_VERSION < ESP_IDF_VERSION_VAL(5, 1, 0)
+      timerAlarmWrite(adc_timer, next, true);
+#else
+      timerAlarm(adc_timer, next, true, 0);
+#endif
+    }
+  }
+
   /// ends the timer and if necessary the task
   bool end() override {
     TRACED();
+    fracTimerDrivers[timer_id] = nullptr;
     if (started) {
       timerDetachInterrupt(adc_timer);
       timerEnd(adc_timer);
@@ -202,6 +243,10 @@ class TimerAlarmRepeatingDriverESP32 : public TimerAlarmRepeatingDriverBase {
   int core = 1;
   int priority = 1;  // configMAX_PRIORITIES - 1;
   uint32_t timeUs;
+  uint32_t alarm_us = 0;
+  uint32_t rate_hz = 0;
+  uint32_t frac_rem = 0;
+  uint32_t frac_accum = 0;
 
   /// call timerAttachInterrupt
   void attach(hw_timer_t *timer, void (*cb)()) {
@@ -326,6 +371,12 @@ class TimerAlarmRepeatingDriverESP32 : public TimerAlarmRepeatingDriverBase {
   }
 };
 
+/// Dispatches the fractional tick correction to the driver of the timer
+static IRAM_ATTR void timerFracTick(int id) {
+  TimerAlarmRepeatingDriverESP32 *self = fracTimerDrivers[id];
+  if (self != nullptr) self->applyFracTick();
+}
+
 /// @brief  use TimerAlarmRepeating!  @ingroup timer_esp32
 using TimerAlarmRepeatingDriver = TimerAlarmRepeatingDriverESP32;
 
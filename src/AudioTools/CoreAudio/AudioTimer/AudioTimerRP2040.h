@@ -47,12 +47,20 @@ class TimerAlarmRepeatingDriverRP2040 : public TimerAlarmRepeatingDriverBase {
         result = alarm_pool_add_repeating_timer_us(ap, time, &staticCallback,
                                                   this, &timer);
         break;
-      case HZ:
-        // convert hz to time in us
-        uint64_t time_us = AudioTime::toTimeUs(time);
-        result = alarm_pool_add_repeating_timer_us(ap, time_us, &staticCallback,
-                                                   this, &timer);
+      case HZ: {
+        // fractional tick correction: we start from the floor period and
+        // the callback alternates long and short ticks, so the average
+        // rate is exact (44100 Hz stays 44100 Hz and not 44091 Hz)
+        rate_hz = time;
+        base_us = 1000000ul / time;
+        frac_rem = 1000000ul % time;
+        frac_accum = 0;
+        // negative delay: the spacing is measured between the callback
+        // starts and does not include the callback runtime
+        result = alarm_pool_add_repeating_timer_us(ap, -base_us,
+                                                   &staticCallback, this, &timer);
         break;
+      }
     }
 
     return result;
@@ -62,6 +70,17 @@ class TimerAlarmRepeatingDriverRP2040 : public TimerAlarmRepeatingDriverBase {
     TimerAlarmRepeatingDriverRP2040 *self =
         (TimerAlarmRepeatingDriverRP2040 *)ptr->user_data;
     self->instanceCallback(self->object);
+    // fractional tick correction: accumulate the missing microseconds
+    // and insert a long tick when a full microsecond is due
+    if (self->frac_rem != 0) {
+      self->frac_accum += self->frac_rem;
+      int64_t delay = self->base_us;
+      if (self->frac_accum >= self->rate_hz) {
+        self->frac_accum -= self->rate_hz;
+        delay++;
+      }
+      ptr->delay_us = -delay;
+    }
     return true;
   }
 
@@ -72,6 +91,10 @@ class TimerAlarmRepeatingDriverRP2040 : public TimerAlarmRepeatingDriverBase {
   alarm_pool_t *ap = nullptr;
   repeating_timer_t timer;
   my_repeating_timer_callback_t instanceCallback = nullptr;
+  int64_t base_us = 0;
+  uint32_t rate_hz = 0;
+  uint32_t frac_rem = 0;
+  uint32_t frac_accum = 0;
 };
 
 /// @brief use TimerAlarmRepeating! @ingroup timer_rp2040
@@ -0,0 +1,126 @@
+#pragma once
+#include "AudioConfig.h"
+
+/**
+ * Lightweight compile time optional tracing: activate it with
+ * #define USE_AUDIO_TRACE before including AudioTools.h. Each AUDIO_TRACE()
+ * call just stores an 8 byte event (timestamp, id, value) into a per core
+ * ring buffer, so it is cheap enough for the pipeline hot paths (StreamCopy,
+ * buffer watermarks, codec frame boundaries) and can stay enabled while
+ * chasing e.g. an I2S underrun. AudioTrace::dump() writes the collected
+ * events as csv timeline. When USE_AUDIO_TRACE is not defined the macro
+ * expands to nothing and no code or memory is added.
+ */
+
+#ifdef USE_AUDIO_TRACE
+
+// number of events kept per core: must be a power of 2
+#ifndef AUDIO_TRACE_SIZE
+#  define AUDIO_TRACE_SIZE 256
+#endif
+
+#if defined(ESP32) || defined(ARDUINO_ARCH_RP2040)
+#  define AUDIO_TRACE_CORES 2
+#else
+#  define AUDIO_TRACE_CORES 1
+#endif
+
+namespace audio_tools {
+
+/**
+ * @brief Event ids used by the built in tracepoints: application specific
+ * events should start at TraceUser
+ * @ingroup tools
+ */
+enum AudioTraceId : uint16_t {
+  TraceCopy = 1,         // StreamCopy: value = copied bytes
+  TraceCopyStall = 2,    // StreamCopy: write consumed no data
+  TraceBufferLevel = 3,  // buffer watermark: value = available bytes
+  TraceFrame = 4,        // codec frame boundary: value = frame bytes
+  TraceUser = 100        // first id for application events
+};
+
+/**
+ * @brief Collects 8 byte trace events into a per core ring buffer. The
+ * recording side is lock free (single writer per core) so it can be used
+ * from tasks and timer callbacks alike. Use dump() to write the timeline
+ * as csv (time_us;core;id;value) e.g. to Serial and feed it to a trace
+ * viewer or spreadsheet.
+ * @ingroup tools
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ */
+class AudioTrace {
+ public:
+  /// A single 8 byte trace event
+  struct Event {
+    uint32_t time_us;
+    uint16_t id;
+    int16_t value;
+  };
+
+  /// Records an event on the ring buffer of the current core
+  static inline void record(uint16_t id, int16_t value) {
+    Ring &ring = rings()[coreId()];
+    Event &event = ring.events[ring.pos++ & (AUDIO_TRACE_SIZE - 1)];
+    event.time_us = micros();
+    event.id = id;
+    event.value = value;
+  }
+
+  /// Writes the recorded events as csv timeline: time_us;core;id;value
+  static void dump(Print &out) {
+    for (int core = 0; core < AUDIO_TRACE_CORES; core++) {
+      Ring &ring = rings()[core];
+      uint32_t end = ring.pos;
+      uint32_t start = end > AUDIO_TRACE_SIZE ? end - AUDIO_TRACE_SIZE : 0;
+      for (uint32_t j = start; j < end; j++) {
+        Event &event = ring.events[j & (AUDIO_TRACE_SIZE - 1)];
+        char line[50];
+        snprintf(line, sizeof(line), "%u;%d;%u;%d", (unsigned)event.time_us,
+                 core, (unsigned)event.id, (int)event.value);
+        out.println(line);
+      }
+    }
+  }
+
+  /// Discards all recorded events
+  static void clear() {
+    for (int core = 0; core < AUDIO_TRACE_CORES; core++) {
+      rings()[core].pos = 0;
+    }
+  }
+
+ protected:
+  /// Wrapping event buffer for one core
+  struct Ring {
+    Event events[AUDIO_TRACE_SIZE];
+    volatile uint32_t pos = 0;
+  };
+
+  static Ring *rings() {
+    static Ring data[AUDIO_TRACE_CORES];
+    return data;
+  }
+
+  static inline int coreId() {
+#if defined(ESP32)
+    return xPortGetCoreID();
+#elif defined(ARDUINO_ARCH_RP2040)
+    return get_core_num();
+#else
+    return 0;
+#endif
+  }
+};
+
+}  // namespace audio_tools
+
+#define AUDIO_TRACE(id, value) \
+  audio_tools::AudioTrace::record(id, (int16_t)(value))
+
+#else
+
+#define AUDIO_TRACE(id, value)
+
+#endif  // USE_AUDIO_TRACE
@@ -6,6 +6,8 @@
 #  include <limits>
 #endif
 
+#include <atomic>
+
 #include "AudioTools/CoreAudio/AudioLogger.h"
 #include "AudioTools/CoreAudio/AudioBasic/Collections/Vector.h"
 
@@ -132,6 +134,55 @@ struct AudioInfo {
 
 };
 
+/**
+ * @brief Publishes an AudioInfo thru a sequence lock: the writer never
+ * blocks and a reader on another core retries when it observed a torn
+ * update, so no mutex is needed and the access is wait free for the
+ * writer. An even sequence number means that the value is stable.
+ * @ingroup basic
+ */
+class AudioInfoSeqLock {
+ public:
+  /// Writer: publishes a new value w/o ever blocking
+  void publish(AudioInfo info) {
+    uint32_t seq = sequence.load(std::memory_order_relaxed);
+    // odd sequence marks the write in progress
+    sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    value = info;
+    std::atomic_thread_fence(std::memory_order_release);
+    sequence.store(seq + 2, std::memory_order_release);
+  }
+
+  /// Reader: retries until a consistent value has been read
+  AudioInfo read() {
+    AudioInfo result;
+    uint32_t seq1, seq2;
+    do {
+      seq1 = sequence.load(std::memory_order_acquire);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      result = value;
+      std::atomic_thread_fence(std::memory_order_acquire);
+      seq2 = sequence.load(std::memory_order_relaxed);
+    } while (seq1 != seq2 || (seq1 & 1) != 0);
+    return result;
+  }
+
+  /// Returns true (and updates lastVersion) when a new value has been
+  /// published since the provided version
+  bool isUpdated(uint32_t &lastVersion) {
+    uint32_t seq = sequence.load(std::memory_order_acquire);
+    if ((seq & 1) != 0) seq--;
+    if (seq == lastVersion) return false;
+    lastVersion = seq;
+    return true;
+  }
+
+ protected:
+  AudioInfo value;
+  std::atomic<uint32_t> sequence{0};
+};
+
 /**
  * @brief Supports changes to the sampling rate, bits and channels
  * @ingroup basic
@@ -175,17 +226,34 @@ class AudioInfoSource {
         is_notify_active = flag;
       }
 
-      /// Checks if the automatic AudioInfo update is active 
+      /// Checks if the automatic AudioInfo update is active
       bool isNotifyActive(){
         return is_notify_active;
       }
 
+      /// Provides the last notified AudioInfo thru a sequence lock: safe
+      /// to call from another core w/o any mutex
+      AudioInfo notifiedAudioInfo() {
+        return published_info.read();
+      }
+
+      /// Returns true (and updates lastVersion) when a new AudioInfo has
+      /// been notified since the provided version: together with
+      /// notifiedAudioInfo() this allows a consumer on another core to
+      /// poll for rate changes w/o any locking
+      bool isNotifiedAudioInfoUpdated(uint32_t &lastVersion) {
+        return published_info.isUpdated(lastVersion);
+      }
+
     protected:
       Vector<AudioInfoSupport*> notify_vector;
+      AudioInfoSeqLock published_info;
       bool is_notify_active = true;
 
       void notifyAudioChange(AudioInfo info){
         if (isNotifyActive()){
+          // publish for concurrent readers: never blocks
+          published_info.publish(info);
           for(auto n : notify_vector){
               n->setAudioInfo(info);
           }
@@ -422,6 +490,18 @@ class NumberConverter {
 
 };
 
+// FloatAudio and float16 hold values in the range -1.0 to 1.0: the bit
+// width based fallback of maxValueT() would report the integer maximum,
+// so we provide the limits explicitly
+template <>
+inline float NumberConverter::maxValueT<FloatAudio>(){ return 1.0f; }
+template <>
+inline float NumberConverter::minValueT<FloatAudio>(){ return -1.0f; }
+template <>
+inline float NumberConverter::maxValueT<float16>(){ return 1.0f; }
+template <>
+inline float NumberConverter::minValueT<float16>(){ return -1.0f; }
+
 #if defined(USE_I2S) 
 
 /**
@@ -513,6 +593,39 @@ size_t  writeSamples(Print* p_out, T* data, int samples, int maxSamples=512){
 }
 
 
+/**
+ * @brief Watchdog for the single byte I/O fallbacks of the stream base
+ * classes: the audio classes are expected to move data with the block API
+ * (write(data, len) / readBytes(data, len)), because per byte transfers
+ * easily cost an order of magnitude in throughput. When the number of
+ * tracked single byte operations reaches PER_BYTE_IO_LIMIT a warning is
+ * logged once; define PER_BYTE_IO_ASSERT to turn this into an assert so
+ * that the offending call stack surfaces immediately during development.
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ */
+class PerByteIOCheck {
+ public:
+  /// Registers a single byte operation
+  void track() {
+#if PER_BYTE_IO_LIMIT > 0
+    if (reported) return;
+    if (++count >= PER_BYTE_IO_LIMIT) {
+      reported = true;
+      LOGW("per byte I/O detected: use write(data, len) / readBytes(data, "
+           "len)");
+#ifdef PER_BYTE_IO_ASSERT
+      assert(false);
+#endif
+    }
+#endif
+  }
+
+ protected:
+  uint32_t count = 0;
+  bool reported = false;
+};
+
 /// @brief Mime type for PCM
 static const char* mime_pcm = "audio/pcm";
 
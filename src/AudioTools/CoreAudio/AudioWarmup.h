@@ -0,0 +1,157 @@
+#pragma once
+#include "AudioConfig.h"
+#include "AudioTools/CoreAudio/AudioLogger.h"
+#ifdef ESP32
+#include "AudioTools/Concurrency/RTOS/Task.h"
+#endif
+
+#ifndef AUDIO_WARMUP_MAX
+#define AUDIO_WARMUP_MAX 12
+#endif
+
+namespace audio_tools {
+
+/**
+ * @brief Registry for the expensive one time initializations (codec tables,
+ * FFT twiddle factors, filter coefficients). By default the components set
+ * themselves up lazily when they are first used; an application which cares
+ * about the first-audio latency can register the initializations with add()
+ * and precompute them during idle time with warmup() - on the ESP32 also in
+ * parallel on an own core with warmupAsync(). Every entry records how long
+ * its initialization took, so report() shows where the startup budget goes.
+ * @ingroup tools
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ */
+class AudioWarmup {
+ public:
+  typedef void (*warmup_callback_t)(void *ref);
+
+  /// Provides the shared instance
+  static AudioWarmup &instance() {
+    static AudioWarmup inst;
+    return inst;
+  }
+
+  /// Registers an initialization which warmup() can precompute. The name
+  /// must be a literal or otherwise outlive the registry
+  bool add(const char *name, warmup_callback_t callback, void *ref = nullptr) {
+    if (count >= AUDIO_WARMUP_MAX) {
+      LOGE("too many warmup entries: %d", count);
+      return false;
+    }
+    Entry &entry = entries[count++];
+    entry.name = name;
+    entry.callback = callback;
+    entry.ref = ref;
+    entry.init_us = 0;
+    entry.is_done = false;
+    entry.is_lazy = false;
+    return true;
+  }
+
+  /// Executes all registered initializations which did not run yet
+  void warmup() {
+    for (int j = 0; j < count; j++) {
+      Entry &entry = entries[j];
+      if (entry.is_done || entry.callback == nullptr) continue;
+      uint32_t start = micros();
+      entry.callback(entry.ref);
+      entry.init_us = micros() - start;
+      entry.is_done = true;
+      LOGI("warmup %s: %u us", entry.name, (unsigned)entry.init_us);
+    }
+  }
+
+#ifdef ESP32
+  /// Executes the registered initializations on an own task so that e.g.
+  /// core 1 can warm up while core 0 finishes the boot sequence
+  bool warmupAsync(int core = 1, int stackSize = 8192, int priority = 1) {
+    if (!task.create("warmup", stackSize, priority, core)) return false;
+    return task.begin([this]() {
+      warmup();
+      task.end();
+    });
+  }
+#endif
+
+  /// Reports the measured cost of a component which initialized itself
+  /// lazily on first use (outside of warmup())
+  void record(const char *name, uint32_t init_us) {
+    for (int j = 0; j < count; j++) {
+      if (strcmp(entries[j].name, name) == 0) {
+        entries[j].init_us = init_us;
+        entries[j].is_done = true;
+        return;
+      }
+    }
+    if (count >= AUDIO_WARMUP_MAX) return;
+    Entry &entry = entries[count++];
+    entry.name = name;
+    entry.callback = nullptr;
+    entry.ref = nullptr;
+    entry.init_us = init_us;
+    entry.is_done = true;
+    entry.is_lazy = true;
+  }
+
+  /// Returns true when all registered initializations have been executed
+  bool isComplete() {
+    for (int j = 0; j < count; j++) {
+      if (!entries[j].is_done) return false;
+    }
+    return true;
+  }
+
+  /// Provides the total measured initialization time in us
+  uint32_t totalUs() {
+    uint32_t result = 0;
+    for (int j = 0; j < count; j++) result += entries[j].init_us;
+    return result;
+  }
+
+  /// Prints one 'name;init_us;state' line per component (state is warmed,
+  /// lazy or pending) followed by the total
+  void report(Print &out) {
+    out.println("component;init_us;state");
+    for (int j = 0; j < count; j++) {
+      Entry &entry = entries[j];
+      const char *state =
+          !entry.is_done ? "pending" : (entry.is_lazy ? "lazy" : "warmed");
+      char line[120];
+      snprintf(line, sizeof(line), "%s;%u;%s", entry.name,
+               (unsigned)entry.init_us, state);
+      out.println(line);
+    }
+    char line[60];
+    snprintf(line, sizeof(line), "total;%u;", (unsigned)totalUs());
+    out.println(line);
+  }
+
+  /// Removes all entries
+  void clear() { count = 0; }
+
+ protected:
+  struct Entry {
+    const char *name = nullptr;
+    warmup_callback_t callback = nullptr;
+    void *ref = nullptr;
+    uint32_t init_us = 0;
+    bool is_done = false;
+    bool is_lazy = false;
+  };
+
+  Entry entries[AUDIO_WARMUP_MAX];
+  int count = 0;
+#ifdef ESP32
+  Task task;
+#endif
+};
+
+/// Reports the lazy initialization cost of a component to the shared
+/// AudioWarmup registry
+inline void warmupRecord(const char *name, uint32_t init_us) {
+  AudioWarmup::instance().record(name, init_us);
+}
+
+}  // namespace audio_tools
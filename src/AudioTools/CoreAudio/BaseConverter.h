@@ -98,21 +98,37 @@ class ConverterScaler : public BaseConverter {
 };
 
 /**
- * @brief Makes sure that the avg of the signal is set to 0
+ * @brief Makes sure that the avg of the signal is set to 0. By default the
+ * offset is determined as block mean; with setFilterMode() the DC is
+ * tracked continuously per channel with a fixed point one pole high pass
+ * (one add and shift per sample, no division).
  * @ingroup convert
  * @tparam T
  */
 template <typename T>
 class ConverterAutoCenterT : public BaseConverter {
  public:
-  ConverterAutoCenterT(int channels = 2, bool isDynamic = false) {
+  ConverterAutoCenterT(int channels = 2, bool isDynamic = false,
+                       bool isFilter = false) {
     this->channels = channels;
     this->is_dynamic = isDynamic;
+    this->is_filter = isFilter;
+  }
+
+  /// Activates the one pole high pass mode: the time constant of the DC
+  /// estimate is 2^shift samples
+  void setFilterMode(bool active, int shift = 8) {
+    is_filter = active;
+    filter_shift = shift;
   }
 
   size_t convert(uint8_t(*src), size_t byte_count) override {
     size_t size = byte_count / channels / sizeof(T);
     T *sample = (T *)src;
+    if (is_filter) {
+      convertFiltered(sample, size);
+      return byte_count;
+    }
     setup((T *)src, size);
     // convert data
     if (is_setup) {
@@ -141,12 +157,34 @@ class ConverterAutoCenterT : public BaseConverter {
   Vector<float> offset_to{0};
   Vector<float> offset_step{0};
   Vector<float> total{0};
+  Vector<int64_t> dc_acc{0};
   float left = 0.0;
   float right = 0.0;
   bool is_setup = false;
   bool is_dynamic;
+  bool is_filter = false;
+  int filter_shift = 8;
   int channels;
 
+  /// one pole high pass: dc += (x - dc) / 2^shift; out = x - dc. The DC
+  /// estimate is kept scaled by 2^shift so no precision is lost.
+  void convertFiltered(T *sample, size_t size) {
+    if (dc_acc.size() != channels) {
+      dc_acc.resize(channels);
+      for (int ch = 0; ch < channels; ch++) dc_acc[ch] = 0;
+    }
+    int shift = filter_shift;
+    for (size_t j = 0; j < size; j++) {
+      for (int ch = 0; ch < channels; ch++) {
+        size_t idx = (j * channels) + ch;
+        int32_t x = (int32_t)sample[idx];
+        int32_t dc = (int32_t)(dc_acc[ch] >> shift);
+        dc_acc[ch] += x - dc;
+        sample[idx] = (T)(x - dc);
+      }
+    }
+  }
+
   void setup(T *src, size_t size) {
     if (size == 0) return;
     if (!is_setup || is_dynamic) {
@@ -200,25 +238,30 @@ class ConverterAutoCenter : public BaseConverter {
     }
   }
 
-  void begin(int channels, int bitsPerSample, bool isDynamic = false) {
+  void begin(int channels, int bitsPerSample, bool isDynamic = false,
+             bool isFilter = false) {
     this->channels = channels;
     this->bits_per_sample = bitsPerSample;
     if (p_converter != nullptr) delete p_converter;
     switch (bits_per_sample) {
       case 8: {
-        p_converter = new ConverterAutoCenterT<int8_t>(channels, isDynamic);
+        p_converter =
+            new ConverterAutoCenterT<int8_t>(channels, isDynamic, isFilter);
         break;
       }
       case 16: {
-        p_converter = new ConverterAutoCenterT<int16_t>(channels, isDynamic);
+        p_converter =
+            new ConverterAutoCenterT<int16_t>(channels, isDynamic, isFilter);
         break;
       }
       case 24: {
-        p_converter = new ConverterAutoCenterT<int24_t>(channels, isDynamic);
+        p_converter =
+            new ConverterAutoCenterT<int24_t>(channels, isDynamic, isFilter);
         break;
       }
       case 32: {
-        p_converter = new ConverterAutoCenterT<int32_t>(channels, isDynamic);
+        p_converter =
+            new ConverterAutoCenterT<int32_t>(channels, isDynamic, isFilter);
         break;
       }
     }
@@ -488,6 +531,50 @@ class ChannelReducer : public BaseConverter {
   int bits;
 };
 
+/**
+ * @brief ChannelReducer with the channel counts as template parameters: the
+ * per frame work is fully unrolled by the compiler, so common fixed
+ * reductions (e.g. 8 channel TDM capture to stereo) compile to a
+ * straight-line copy loop without per-sample branches.
+ * @ingroup convert
+ * @tparam T
+ * @tparam from_channels
+ * @tparam to_channels
+ */
+template <typename T, int from_channels, int to_channels>
+class ChannelReducerFixedT : public BaseConverter {
+  static_assert(to_channels <= from_channels,
+                "to_channels must not exceed from_channels");
+
+ public:
+  ChannelReducerFixedT() = default;
+
+  size_t convert(uint8_t *src, size_t size) override {
+    return convert(src, src, size);
+  }
+
+  size_t convert(uint8_t *target, uint8_t *src, size_t size) {
+    int frame_count = size / (sizeof(T) * from_channels);
+    T *result = (T *)target;
+    T *source = (T *)src;
+    constexpr int reduceDiv = from_channels - to_channels + 1;
+
+    for (int i = 0; i < frame_count; i++) {
+      // copy first to_channels-1
+      for (int j = 0; j < to_channels - 1; j++) {
+        *result++ = *source++;
+      }
+      // combined last channels
+      T total = (int16_t)0;
+      for (int j = to_channels - 1; j < from_channels; j++) {
+        total += *source++ / reduceDiv;
+      }
+      *result++ = total;
+    }
+    return frame_count * to_channels * sizeof(T);
+  }
+};
+
 /**
  * @brief Provides reduced sampling rates
  * @ingroup convert
@@ -594,6 +681,59 @@ class Decimate : public BaseConverter {
   int factor = 1;
 };
 
+/**
+ * @brief Decimation with the factor and channel count as template
+ * parameters: every frame index is computed at compile time, so common
+ * fixed factors (e.g. /3) compile to a straight-line copy loop without
+ * the per-frame counter logic.
+ * @ingroup convert
+ * @tparam T
+ * @tparam factor
+ * @tparam channels
+ */
+template <typename T, int factor, int channels>
+class DecimateFixedT : public BaseConverter {
+  static_assert(factor >= 1, "factor must be >= 1");
+
+ public:
+  DecimateFixedT() = default;
+
+  size_t convert(uint8_t *src, size_t size) override {
+    return convert(src, src, size);
+  }
+
+  size_t convert(uint8_t *target, uint8_t *src, size_t size) {
+    if (size % (sizeof(T) * channels) > 0) {
+      LOGE("Buffer size %d is not a multiple of the number of channels %d",
+           (int)size, channels);
+      return 0;
+    }
+    int frame_count = size / (sizeof(T) * channels);
+    T *p_target = (T *)target;
+    T *p_source = (T *)src;
+    size_t result_size = 0;
+
+    // carry the phase over from the prior block, then run the hot path
+    // with compile time constant strides
+    int i = factor - 1 - count;
+    count = (count + frame_count) % factor;
+    for (; i < frame_count; i += factor) {
+      for (int ch = 0; ch < channels; ch++) {
+        *p_target++ = p_source[i * channels + ch];
+      }
+      result_size += sizeof(T) * channels;
+    }
+
+    LOGD("decimate %d: %d -> %d bytes", factor, (int)size, (int)result_size);
+    return result_size;
+  }
+
+  operator bool() { return factor > 1; }
+
+ protected:
+  int count = 0;
+};
+
 /**
  * @brief We reduce the number of samples in a datastream by summing (binning) or averaging.
  * This will result in the same number of channels but binSize times less samples.
@@ -1334,6 +1474,151 @@ class ChannelConverter {
   int to_channels;
 };
 
+/**
+ * @brief Remaps channels according to a channel map which lists for each
+ * target channel the source channel to copy from: e.g. the map {0,1,0,1}
+ * expands stereo to 4 channels. This is the runtime fallback for dynamic
+ * maps - for maps known at compile time use ChannelMapFixedT which unrolls
+ * the frame copy completely.
+ * @ingroup convert
+ * @tparam T
+ */
+template <typename T>
+class ChannelMapT {
+ public:
+  ChannelMapT() = default;
+
+  /// Defines for each target channel the source channel to copy from
+  void setMap(const int16_t *map, int toChannels) {
+    this->map.resize(toChannels);
+    for (int j = 0; j < toChannels; j++) this->map[j] = map[j];
+  }
+
+  void setSourceChannels(int channelCountOfSource) {
+    from_channels = channelCountOfSource;
+  }
+
+  size_t convert(uint8_t *target, uint8_t *src, size_t size) {
+    int to_channels = map.size();
+    int frame_count = size / (sizeof(T) * from_channels);
+    T *result = (T *)target;
+    T *source = (T *)src;
+    for (int i = 0; i < frame_count; i++) {
+      for (int j = 0; j < to_channels; j++) {
+        *result++ = source[map[j]];
+      }
+      source += from_channels;
+    }
+    return frame_count * to_channels * sizeof(T);
+  }
+
+  /// Determine the size of the conversion result
+  size_t resultSize(size_t inSize) {
+    return inSize * map.size() / from_channels;
+  }
+
+ protected:
+  Vector<int16_t> map{0};
+  int from_channels = 2;
+};
+
+/**
+ * @brief Channel remapping with the map as template parameters: e.g.
+ * ChannelMapFixedT<int16_t, 0, 1, 0, 1, 0, 1, 0, 1> expands stereo to 8
+ * channels. The source channel count is derived from the map and the per
+ * frame copies are fully unrolled at compile time, so the remap becomes a
+ * handful of vectorizable copies instead of nested per-sample loops.
+ * @ingroup convert
+ * @tparam T
+ */
+template <typename T, int... map>
+class ChannelMapFixedT {
+ public:
+  /// Number of target channels (= number of map entries)
+  static constexpr int toChannels() { return sizeof...(map); }
+
+  /// Number of source channels (= highest mapped channel + 1)
+  static constexpr int fromChannels() {
+    int result = 0;
+    for (int ch : {map...}) {
+      if (ch + 1 > result) result = ch + 1;
+    }
+    return result;
+  }
+
+  size_t convert(uint8_t *target, uint8_t *src, size_t size) {
+    constexpr int from_channels = fromChannels();
+    constexpr int to_channels = toChannels();
+    int frame_count = size / (sizeof(T) * from_channels);
+    T *result = (T *)target;
+    T *source = (T *)src;
+    for (int i = 0; i < frame_count; i++) {
+      // pack expansion: one straight copy per target channel
+      int unroll[] = {(*result++ = source[map], 0)...};
+      (void)unroll;
+      source += from_channels;
+    }
+    return frame_count * to_channels * sizeof(T);
+  }
+
+  /// Determine the size of the conversion result
+  size_t resultSize(size_t inSize) {
+    return inSize * toChannels() / fromChannels();
+  }
+};
+
+/**
+ * @brief Fuses a statically known chain of converters: MultiConverter lets
+ * every converter traverse the whole block again, so a 3 stage chain reads
+ * and writes the memory 3 times. ConverterChain processes the block in
+ * small tiles which pass through all stages while they are still in the
+ * cache, so the block only travels through memory once. The converters are
+ * resolved at compile time (no virtual dispatch between the stages) and
+ * must convert in place without changing the size (e.g. ConverterAutoCenter,
+ * ConverterScaler). Pick a tile size which is a multiple of the frame size.
+ * @ingroup convert
+ * @tparam Converters
+ */
+template <typename... Converters>
+class ConverterChain : public BaseConverter {
+ public:
+  size_t convert(uint8_t *src, size_t size) override { return size; }
+  void applyTile(uint8_t *src, size_t size) {}
+};
+
+template <typename First, typename... Rest>
+class ConverterChain<First, Rest...> : public BaseConverter {
+ public:
+  ConverterChain(First &firstConverter, Rest &...restConverters)
+      : first(firstConverter), rest(restConverters...) {}
+
+  size_t convert(uint8_t *src, size_t size) override {
+    size_t open = size;
+    uint8_t *ptr = src;
+    while (open > 0) {
+      size_t tile = open < tile_size ? open : tile_size;
+      applyTile(ptr, tile);
+      ptr += tile;
+      open -= tile;
+    }
+    return size;
+  }
+
+  /// Defines the tile size in bytes (default 512)
+  void setTileSize(size_t size) { tile_size = size; }
+
+  /// Applies all stages to a single tile
+  void applyTile(uint8_t *src, size_t size) {
+    first.convert(src, size);
+    rest.applyTile(src, size);
+  }
+
+ protected:
+  First &first;
+  ConverterChain<Rest...> rest;
+  size_t tile_size = 512;
+};
+
 /**
  * @brief Combines multiple converters
  * @ingroup convert
@@ -1372,70 +1657,90 @@ class MultiConverter : public BaseConverter {
   Vector<BaseConverter *> converters;
 };
 
-// /**
-//  * @brief Converts e.g. 24bit data to the indicated smaller or bigger data
-//  type
-//  * @ingroup convert
-//  * @author Phil Schatzmann
-//  * @copyright GPLv3
-//  *
-//  * @tparam T
-//  */
-// template<typename FromType, typename ToType>
-// class FormatConverter {
-//     public:
-//         FormatConverter(ToType (*converter)(FromType v)){
-//             this->convert_ptr = converter;
-//         }
-
-//         FormatConverter( float factor, float clip){
-//             this->factor = factor;
-//             this->clip = clip;
-//         }
-
-//         // The data is provided as int24_t tgt[][2] but  returned as int24_t
-//         size_t convert(uint8_t *src, uint8_t *target, size_t byte_count_src)
-//         {
-//             return convert((FromType *)src, (ToType*)target, byte_count_src
-//             );
-//         }
-
-//         // The data is provided as int24_t tgt[][2] but  returned as int24_t
-//         size_t convert(FromType *src, ToType *target, size_t byte_count_src)
-//         {
-//             int size = byte_count_src / sizeof(FromType);
-//             FromType *s = src;
-//             ToType *t = target;
-//             if (convert_ptr!=nullptr){
-//                 // standard conversion
-//                 for (int i=size; i>0; i--) {
-//                     *t = (*convert_ptr)(*s);
-//                     t++;
-//                     s++;
-//                 }
-//             } else {
-//                 // conversion using indicated factor
-//                 for (int i=size; i>0; i--) {
-//                     float tmp = factor * *s;
-//                     if (tmp>clip){
-//                         tmp=clip;
-//                     } else if (tmp<-clip){
-//                         tmp = -clip;
-//                     }
-//                     *t = tmp;
-//                     t++;
-//                     s++;
-//                 }
-//             }
-//             return size*sizeof(ToType);
-//         }
-
-//     private:
-//         ToType (*convert_ptr)(FromType v) = nullptr;
-//         float factor=0;
-//         float clip=0;
-
-// };
+/**
+ * @brief Fused single-pass converter which changes the bit depth, the
+ * channel count and (by an integer decimation factor) the sample rate in
+ * one loop over the input block. Chaining NumberFormatConverterStream,
+ * ChannelFormatConverterStream and ResampleStream touches every sample
+ * once per stage - this class touches it once in total. The channel count
+ * can be reduced (the exceeding source channels are combined into the last
+ * target channel) or expanded from mono by duplication.
+ * @ingroup convert
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ * @tparam FromType
+ * @tparam ToType
+ */
+template <typename FromType, typename ToType>
+class FormatConverter {
+ public:
+  FormatConverter() = default;
+
+  FormatConverter(int fromChannels, int toChannels, int decimation = 1) {
+    setChannels(fromChannels, toChannels);
+    setDecimation(decimation);
+  }
+
+  /// Defines the number of source and target channels
+  void setChannels(int fromChannels, int toChannels) {
+    from_channels = fromChannels;
+    to_channels = toChannels;
+  }
+
+  /// Sets the decimation factor: e.g. with 3 we keep every third frame
+  void setDecimation(int factor) { decimation = factor; }
+
+  /// Result size in bytes for the indicated source size
+  size_t resultSize(size_t byte_count_src) {
+    size_t frames = byte_count_src / (sizeof(FromType) * from_channels);
+    return frames / decimation * to_channels * sizeof(ToType);
+  }
+
+  /// In place conversion: only valid if the data is shrinking
+  size_t convert(uint8_t *src, size_t byte_count_src) {
+    return convert(src, src, byte_count_src);
+  }
+
+  size_t convert(uint8_t *target, uint8_t *src, size_t byte_count_src) {
+    int frame_count = byte_count_src / (sizeof(FromType) * from_channels);
+    FromType *source = (FromType *)src;
+    ToType *result = (ToType *)target;
+    size_t result_size = 0;
+
+    for (int i = 0; i < frame_count; i++) {
+      // rate: keep every decimation-th frame
+      if (++count < decimation) continue;
+      count = 0;
+      FromType *frame = source + i * from_channels;
+      if (to_channels <= from_channels) {
+        // copy first to_channels-1, combine the exceeding channels
+        int reduceDiv = from_channels - to_channels + 1;
+        for (int j = 0; j < to_channels - 1; j++) {
+          *result++ = NumberConverter::convert<FromType, ToType>(frame[j]);
+        }
+        FromType total = (int16_t)0;
+        for (int j = to_channels - 1; j < from_channels; j++) {
+          total += frame[j] / reduceDiv;
+        }
+        *result++ = NumberConverter::convert<FromType, ToType>(total);
+      } else {
+        // expand: duplicate the last source channel into the extra targets
+        for (int j = 0; j < to_channels; j++) {
+          int src_ch = j < from_channels ? j : from_channels - 1;
+          *result++ = NumberConverter::convert<FromType, ToType>(frame[src_ch]);
+        }
+      }
+      result_size += to_channels * sizeof(ToType);
+    }
+    return result_size;
+  }
+
+ protected:
+  int from_channels = 2;
+  int to_channels = 2;
+  int decimation = 1;
+  int count = 0;
+};
 
 /**
  * @brief Reads n numbers from an Arduino Stream
@@ -1570,16 +1875,24 @@ class ConverterNChannels : public BaseConverter {
     }
   }
 
-  // convert all samples for each channel separately
+  // convert all samples for each channel separately: the samples of a
+  // channel are gathered into a block so that the filter is called once
+  // per block instead of once per sample
   size_t convert(uint8_t *src, size_t size) {
     int count = size / channels / sizeof(T);
     T *sample = (T *)src;
-    for (size_t j = 0; j < count; j++) {
-      for (int channel = 0; channel < channels; channel++) {
-        if (filters[channel] != nullptr) {
-          *sample = filters[channel]->process(*sample);
-        }
-        sample++;
+    FT block[64];
+    for (int channel = 0; channel < channels; channel++) {
+      if (filters[channel] == nullptr) continue;
+      T *p = sample + channel;
+      int open = count;
+      while (open > 0) {
+        int n = min(open, 64);
+        for (int j = 0; j < n; j++) block[j] = p[j * channels];
+        filters[channel]->processBlock(block, block, n);
+        for (int j = 0; j < n; j++) p[j * channels] = block[j];
+        p += n * channels;
+        open -= n;
       }
     }
     return size;
@@ -1593,9 +1906,12 @@ class ConverterNChannels : public BaseConverter {
 };
 
 /**
- * @brief Removes any silence from the buffer that is longer then n samples with
- * a amplitude below the indicated threshhold. If you process multiple channels
- * you need to multiply the channels with the number of samples to indicate n
+ * @brief Removes silence from the audio data. The detection works on blocks
+ * with integer energy sums (mean abs amplitude per block) and hysteresis:
+ * the output opens as soon as one block exceeds the open threshold and
+ * closes only after releaseBlocks consecutive blocks below the (lower)
+ * close threshold. While closed the last lookahead blocks are buffered and
+ * emitted when the output opens, so the first syllable is not clipped.
  * @ingroup convert
  * @tparam T
  */
@@ -1607,64 +1923,135 @@ class SilenceRemovalConverter : public BaseConverter {
     set(n, aplidudeLimit);
   }
 
+  /// Defines the detection block size in samples
+  void setBlockSize(int samples) {
+    if (samples > 0) {
+      block_size = samples;
+      updateLookahead();
+    }
+  }
+
+  /// Defines the open and close thresholds as mean abs amplitude per block:
+  /// with close < open the detection has hysteresis (-1 = open / 2)
+  void setAmplitudeLimit(int open, int close = -1) {
+    open_limit = open;
+    close_limit = close >= 0 ? close : open / 2;
+    if (close_limit < 1) close_limit = 1;
+  }
+
+  /// Number of consecutive quiet blocks before the output is muted
+  void setReleaseBlocks(int blocks) { release_blocks = blocks < 1 ? 1 : blocks; }
+
+  /// Number of blocks buffered while muted and emitted when the output
+  /// opens (0 = no lookahead)
+  void setLookaheadBlocks(int blocks) {
+    lookahead_blocks = blocks < 0 ? 0 : blocks;
+    updateLookahead();
+  }
+
   virtual size_t convert(uint8_t *data, size_t size) override {
     if (!active) {
       // no change to the data
       return size;
     }
-    size_t sample_count = size / sizeof(T);
-    size_t write_count = 0;
     T *audio = (T *)data;
+    int sample_count = size / sizeof(T);
+    int written = 0;
 
-    // find relevant data
-    T *p_buffer = (T *)data;
-    for (int j = 0; j < sample_count; j++) {
-      int pos = findLastAudioPos(audio, j);
-      if (pos < n) {
-        write_count++;
-        *p_buffer++ = audio[j];
+    for (int start = 0; start < sample_count; start += block_size) {
+      int len = sample_count - start;
+      if (len > block_size) len = block_size;
+
+      // integer block energy: mean abs amplitude
+      int64_t sum = 0;
+      for (int j = 0; j < len; j++) {
+        int32_t value = static_cast<int32_t>(audio[start + j]);
+        sum += value < 0 ? -value : value;
       }
-    }
+      int32_t mean = sum / len;
 
-    // write audio data w/o silence
-    size_t write_size = write_count * sizeof(T);
-    LOGI("filtered silence from %d -> %d", (int)size, (int)write_size);
+      // hysteresis state machine
+      if (is_open) {
+        if (mean < close_limit) {
+          if (++quiet_blocks >= release_blocks) is_open = false;
+        } else {
+          quiet_blocks = 0;
+        }
+      } else if (mean >= open_limit) {
+        is_open = true;
+        quiet_blocks = 0;
+        // emit the lookahead into the space freed by discarded blocks
+        flushLookahead(audio, written, start);
+      }
 
-    // number of empty samples of prior buffer
-    priorLastAudioPos = findLastAudioPos(audio, sample_count - 1);
+      if (is_open) {
+        // keep the block
+        if (written != start) {
+          memmove(audio + written, audio + start, len * sizeof(T));
+        }
+        written += len;
+      } else {
+        // buffer the block as lookahead for the next onset
+        pushLookahead(audio + start, len);
+      }
+    }
 
-    // return new data size
+    size_t write_size = written * sizeof(T);
+    if (write_size != size) {
+      LOGI("filtered silence from %d -> %d", (int)size, (int)write_size);
+    }
     return write_size;
   }
 
  protected:
   bool active = false;
-  const uint8_t *buffer = nullptr;
-  int n;
-  int priorLastAudioPos = 0;
-  int amplidude_limit = 0;
+  bool is_open = false;
+  int block_size = 32;
+  int open_limit = 0;
+  int close_limit = 0;
+  int release_blocks = 2;
+  int lookahead_blocks = 1;
+  int quiet_blocks = 0;
+  Vector<T> lookahead{0};
+  int la_pos = 0;
+  int la_count = 0;
 
   void set(int n = 5, int aplidudeLimit = 2) {
     LOGI("begin(n=%d, aplidudeLimit=%d", n, aplidudeLimit);
-    this->n = n;
-    this->amplidude_limit = aplidudeLimit;
-    this->priorLastAudioPos = n + 1;  // ignore first values
+    setAmplitudeLimit(aplidudeLimit);
+    if (n > 0) setBlockSize(n * 4);
     this->active = n > 0;
   }
 
-  // find last position which contains audible data
-  int findLastAudioPos(T *audio, int pos) {
-    for (int j = 0; j < n; j++) {
-      // we are before the start of the current buffer
-      if (pos - j <= 0) {
-        return priorLastAudioPos;
-      }
-      // we are in the current buffer
-      if (abs(audio[pos - j]) > amplidude_limit) {
-        return j;
-      }
+  void updateLookahead() {
+    lookahead.resize(lookahead_blocks * block_size);
+    la_pos = 0;
+    la_count = 0;
+  }
+
+  void pushLookahead(T *values, int len) {
+    int size = lookahead.size();
+    if (size == 0) return;
+    for (int j = 0; j < len; j++) {
+      lookahead[la_pos] = values[j];
+      la_pos = (la_pos + 1) % size;
+      if (la_count < size) la_count++;
+    }
+  }
+
+  /// writes the most recent buffered samples before the onset - limited to
+  /// the space that was freed by the blocks discarded earlier in this call
+  void flushLookahead(T *audio, int &written, int limit) {
+    int size = lookahead.size();
+    if (size == 0 || la_count == 0) return;
+    int n_flush = la_count;
+    if (n_flush > limit - written) n_flush = limit - written;
+    int idx = (la_pos - n_flush + size) % size;
+    for (int j = 0; j < n_flush; j++) {
+      audio[written++] = lookahead[idx];
+      idx = (idx + 1) % size;
     }
-    return n + 1;
+    la_count = 0;
   }
 };
 
@@ -48,6 +48,7 @@ class BaseStream : public Stream {
   virtual size_t write(const uint8_t *data, size_t len) override = 0;
 
   virtual size_t write(uint8_t ch) override {
+    per_byte_check.track();
     tmp_out.resize(MAX_SINGLE_CHARS);
     if (tmp_out.isFull()) {
       flush();
@@ -73,6 +74,7 @@ class BaseStream : public Stream {
   }
 
   virtual int read() override {
+    per_byte_check.track();
     refillReadBuffer();
     // if it is empty we need to return an int -1
     if (tmp_in.isEmpty()) return -1;
@@ -91,6 +93,7 @@ class BaseStream : public Stream {
  protected:
   RingBuffer<uint8_t> tmp_in{0};
   RingBuffer<uint8_t> tmp_out{0};
+  PerByteIOCheck per_byte_check;
 
   void refillReadBuffer() {
     tmp_in.resize(DEFAULT_BUFFER_SIZE);
@@ -150,10 +153,13 @@ class AudioStream : public BaseStream, public AudioInfoSupport, public AudioInfo
 
   /// Writes len bytes of silence (=0).
   virtual void writeSilence(size_t len){
-    int16_t zero = 0;
-    for (int j=0;j<len/2;j++){
-      write((uint8_t*)&zero,2);
-    } 
+    // write in blocks instead of per sample
+    uint8_t zero[512] = {0};
+    while (len > 0) {
+      size_t n = len < sizeof(zero) ? len : sizeof(zero);
+      write(zero, n);
+      len -= n;
+    }
   }
 
   /// Source to generate silence: just sets the buffer to 0
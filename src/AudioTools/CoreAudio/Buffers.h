@@ -1,7 +1,10 @@
 
 #pragma once
 
+#include <atomic>
+
 #include "AudioTools/CoreAudio/AudioBasic/Collections.h"
+#include "AudioTools/CoreAudio/AudioHealth.h"
 #include "AudioTools/CoreAudio/AudioLogger.h"
 
 #ifndef INT_MAX
@@ -43,11 +46,19 @@ class BaseBuffer {
       LOGE("NPE");
       return 0;
     }
+    int lenResult = readBlock(data, len);
+    LOGD("readArray %d -> %d", len, lenResult);
+    return lenResult;
+  }
+
+  /// reads a contiguous block of values: subclasses with linear storage
+  /// override this with a memcpy based implementation to avoid the
+  /// virtual call per sample
+  virtual int readBlock(T data[], int len) {
     int lenResult = min(len, available());
     for (int j = 0; j < lenResult; j++) {
       data[j] = read();
     }
-    LOGD("readArray %d -> %d", len, lenResult);
     return lenResult;
   }
 
@@ -61,11 +72,21 @@ class BaseBuffer {
   }
 
 
-  /// Fills the buffer data 
+  /// Fills the buffer data
   virtual int writeArray(const T data[], int len) {
     // LOGD("%s: %d", LOG_METHOD, len);
     // CHECK_MEMORY();
 
+    int result = writeBlock(data, len);
+    // CHECK_MEMORY();
+    LOGD("writeArray %d -> %d", len, result);
+    return result;
+  }
+
+  /// writes a contiguous block of values: subclasses with linear storage
+  /// override this with a memcpy based implementation to avoid the
+  /// virtual call per sample
+  virtual int writeBlock(const T data[], int len) {
     int result = 0;
     for (int j = 0; j < len; j++) {
       if (!write(data[j])) {
@@ -73,8 +94,6 @@ class BaseBuffer {
       }
       result = j + 1;
     }
-    // CHECK_MEMORY();
-    LOGD("writeArray %d -> %d", len, result);
     return result;
   }
 
@@ -142,6 +161,28 @@ class BaseBuffer {
   /// returns the address of the start of the physical read buffer
   virtual T *address() = 0;
 
+  /// Zero copy write: provides direct access to a contiguous unused region
+  /// of the buffer (or nullptr if not supported); fill it and then call
+  /// commit() with the number of entries actually written
+  virtual T *acquire(int &len) {
+    len = 0;
+    return nullptr;
+  }
+
+  /// Completes an acquire() by making len entries available to the reader
+  virtual bool commit(int len) { return false; }
+
+  /// Zero copy read: provides direct access to the next contiguous filled
+  /// region (or nullptr if not supported); call consume() with the number
+  /// of entries that have been processed
+  virtual T *peekSpan(int &len) {
+    len = 0;
+    return nullptr;
+  }
+
+  /// Completes a peekSpan() by removing len processed entries
+  virtual bool consume(int len) { return clearArray(len) == len; }
+
   virtual size_t size() = 0;
 
   /// Returns the level of the buffer in %
@@ -151,8 +192,61 @@ class BaseBuffer {
     return 100.0f * static_cast<float>(available()) / static_cast<float>(size());
   }
 
+  /// Defines a callback which is fired (once) when the fill level falls to
+  /// or below the indicated watermark; it is re-armed when the level rises
+  /// above again. The callback must be ISR/task safe: e.g. just issue a
+  /// FreeRTOS task notification to wake the producer for a refill.
+  void setLowWatermark(int level, void (*callback)(void* ref), void* ref = nullptr) {
+    low_watermark = level;
+    low_watermark_cb = callback;
+    low_watermark_ref = ref;
+    low_watermark_fired = false;
+  }
+
+  /// Defines a callback which is fired (once) when the fill level rises to
+  /// or above the indicated watermark; re-armed when the level falls below
+  void setHighWatermark(int level, void (*callback)(void* ref), void* ref = nullptr) {
+    high_watermark = level;
+    high_watermark_cb = callback;
+    high_watermark_ref = ref;
+    high_watermark_fired = false;
+  }
+
  protected:
-  void setWritePos(int pos){};
+  int low_watermark = -1;
+  int high_watermark = -1;
+  bool low_watermark_fired = false;
+  bool high_watermark_fired = false;
+  void (*low_watermark_cb)(void* ref) = nullptr;
+  void (*high_watermark_cb)(void* ref) = nullptr;
+  void* low_watermark_ref = nullptr;
+  void* high_watermark_ref = nullptr;
+
+  /// fires the edge triggered watermark callbacks for the actual level
+  void checkWatermarks(int level) {
+    if (low_watermark_cb != nullptr && low_watermark >= 0) {
+      if (level <= low_watermark) {
+        if (!low_watermark_fired) {
+          low_watermark_fired = true;
+          low_watermark_cb(low_watermark_ref);
+        }
+      } else {
+        low_watermark_fired = false;
+      }
+    }
+    if (high_watermark_cb != nullptr && high_watermark >= 0) {
+      if (level >= high_watermark) {
+        if (!high_watermark_fired) {
+          high_watermark_fired = true;
+          high_watermark_cb(high_watermark_ref);
+        }
+      } else {
+        high_watermark_fired = false;
+      }
+    }
+  }
+
+  virtual void setWritePos(int pos){};
 
   friend NBuffer<T>;
 };
@@ -178,6 +272,20 @@ class SingleBuffer : public BaseBuffer<T> {
     reset();
   }
 
+  /**
+   * @brief Construct a new Single Buffer with aligned storage (e.g. for
+   * SIMD or word-wise converter kernels)
+   *
+   * @param size
+   * @param alignment in bytes (e.g. 16 for a cache line / SIMD register)
+   */
+  SingleBuffer(int size, int alignment)
+      : aligned_allocator(alignment) {
+    buffer.setAllocator(aligned_allocator);
+    buffer.resize(size);
+    reset();
+  }
+
   /**
    * @brief Construct a new Single Buffer w/o allocating any memory
    */
@@ -196,6 +304,8 @@ class SingleBuffer : public BaseBuffer<T> {
     if (current_write_pos < buffer.size()) {
       buffer[current_write_pos++] = sample;
       result = true;
+    } else {
+      healthIncrement(HealthBufferOverflow);
     }
     return result;
   }
@@ -216,6 +326,50 @@ class SingleBuffer : public BaseBuffer<T> {
     return result;
   }
 
+  /// writes a block of data with a single memcpy
+  int writeBlock(const T data[], int len) override {
+    int result = min(len, availableForWrite());
+    if (result > 0) {
+      memcpy(buffer.data() + current_write_pos, data, result * sizeof(T));
+      current_write_pos += result;
+    }
+    return result;
+  }
+
+  /// reads a block of data with a single memcpy
+  int readBlock(T data[], int len) override {
+    int result = min(len, available());
+    if (result > 0) {
+      memcpy(data, buffer.data() + current_read_pos, result * sizeof(T));
+      current_read_pos += result;
+    }
+    return result;
+  }
+
+  /// Zero copy write: provides the unused region at the end of the buffer
+  T *acquire(int &len) override {
+    len = availableForWrite();
+    return buffer.data() + current_write_pos;
+  }
+
+  bool commit(int len) override {
+    if (len > availableForWrite()) return false;
+    current_write_pos += len;
+    return true;
+  }
+
+  /// Zero copy read: provides the filled region starting at the read pos
+  T *peekSpan(int &len) override {
+    len = available();
+    return buffer.data() + current_read_pos;
+  }
+
+  bool consume(int len) override {
+    if (len > available()) return false;
+    current_read_pos += len;
+    return true;
+  }
+
   int available() override {
     int result = current_write_pos - current_read_pos;
     return max(result, 0);
@@ -278,6 +432,9 @@ class SingleBuffer : public BaseBuffer<T> {
     }
   }
 
+  /// Defines the allocator (e.g. AllocatorPSRAM): call before resize
+  void setAllocator(Allocator &allocator) { buffer.setAllocator(allocator); }
+
   /// Sets the buffer to 0 on clear
   void setClearWithZero(bool flag){
     is_clear_with_zero = flag;
@@ -288,6 +445,7 @@ class SingleBuffer : public BaseBuffer<T> {
   int current_write_pos = 0;
   bool owns_buffer = true;
   bool is_clear_with_zero = false;
+  AllocatorAligned aligned_allocator;
   Vector<T> buffer{0};
 
   void setWritePos(int pos) { current_write_pos = pos; }
@@ -307,11 +465,15 @@ class RingBuffer : public BaseBuffer<T> {
   }
 
   virtual T read() {
-    if (isEmpty()) return -1;
+    if (isEmpty()) {
+      healthIncrement(HealthBufferUnderflow);
+      return -1;
+    }
 
     T value = _aucBuffer[_iTail];
     _iTail = nextIndex(_iTail);
     _numElems--;
+    this->checkWatermarks(_numElems);
 
     return value;
   }
@@ -350,11 +512,81 @@ class RingBuffer : public BaseBuffer<T> {
       _aucBuffer[_iHead] = data;
       _iHead = nextIndex(_iHead);
       _numElems++;
+      this->checkWatermarks(_numElems);
       result = true;
+    } else {
+      healthIncrement(HealthBufferOverflow);
+    }
+    return result;
+  }
+
+  /// writes a block of data in max 2 memcpy steps (to handle the wrap at
+  /// the end of the buffer)
+  virtual int writeBlock(const T data[], int len) {
+    int result = min(len, availableForWrite());
+    if (result < len) healthIncrement(HealthBufferOverflow);
+    if (result > 0) {
+      int to_end = min(result, max_size - _iHead);
+      memcpy(_aucBuffer.data() + _iHead, data, to_end * sizeof(T));
+      if (result > to_end) {
+        memcpy(_aucBuffer.data(), data + to_end, (result - to_end) * sizeof(T));
+      }
+      _iHead = incIndex(_iHead, result);
+      _numElems += result;
+      this->checkWatermarks(_numElems);
+    }
+    return result;
+  }
+
+  /// reads a block of data in max 2 memcpy steps (to handle the wrap at
+  /// the end of the buffer)
+  virtual int readBlock(T data[], int len) {
+    int result = min(len, available());
+    if (result > 0) {
+      int to_end = min(result, max_size - _iTail);
+      memcpy(data, _aucBuffer.data() + _iTail, to_end * sizeof(T));
+      if (result > to_end) {
+        memcpy(data + to_end, _aucBuffer.data(), (result - to_end) * sizeof(T));
+      }
+      _iTail = incIndex(_iTail, result);
+      _numElems -= result;
+      this->checkWatermarks(_numElems);
     }
     return result;
   }
 
+  /// Zero copy write: provides the contiguous unused region up to the wrap
+  /// point; a codec can produce its data directly into the ring storage
+  T *acquire(int &len) override {
+    len = min(availableForWrite(), max_size - _iHead);
+    return _aucBuffer.data() + _iHead;
+  }
+
+  bool commit(int len) override {
+    if (len > min(availableForWrite(), max_size - _iHead)) return false;
+    if (len <= 0) return len == 0;
+    _iHead = incIndex(_iHead, len);
+    _numElems += len;
+    this->checkWatermarks(_numElems);
+    return true;
+  }
+
+  /// Zero copy read: provides the contiguous filled region up to the wrap
+  /// point; e.g. a DMA transfer can be started directly on the result
+  T *peekSpan(int &len) override {
+    len = min(available(), max_size - _iTail);
+    return _aucBuffer.data() + _iTail;
+  }
+
+  bool consume(int len) override {
+    if (len > min(available(), max_size - _iTail)) return false;
+    if (len <= 0) return len == 0;
+    _iTail = incIndex(_iTail, len);
+    _numElems -= len;
+    this->checkWatermarks(_numElems);
+    return true;
+  }
+
   // clears the buffer
   virtual void reset() {
     _iHead = 0;
@@ -371,11 +603,20 @@ class RingBuffer : public BaseBuffer<T> {
   // returns the address of the start of the physical read buffer
   virtual T *address() { return _aucBuffer.data(); }
 
+  /// Defines the allocator (e.g. AllocatorPSRAM): call before the first
+  /// resize
+  void setAllocator(Allocator &allocator) { _aucBuffer.setAllocator(allocator); }
+
+  /// Resizes the buffer: with a power of 2 len the index advance is done
+  /// with a mask instead of a modulo division (which is a library call on
+  /// Cortex-M0+)
   virtual void resize(int len) {
     if (max_size != len) {
       LOGI("resize: %d", len);
       _aucBuffer.resize(len);
       max_size = len;
+      is_pow2 = len > 0 && (len & (len - 1)) == 0;
+      index_mask = len - 1;
     }
   }
 
@@ -388,8 +629,18 @@ class RingBuffer : public BaseBuffer<T> {
   int _iTail;
   int _numElems;
   int max_size = 0;
+  int index_mask = 0;
+  bool is_pow2 = false;
+
+  int nextIndex(int index) { return incIndex(index, 1); }
 
-  int nextIndex(int index) { return (uint32_t)(index + 1) % max_size; }
+  /// advances an index by n entries w/o division when the size is a power
+  /// of 2; n must not be bigger than max_size
+  int incIndex(int index, int n) {
+    int pos = index + n;
+    if (is_pow2) return pos & index_mask;
+    return pos < max_size ? pos : pos - max_size;
+  }
 };
 
 /**
@@ -442,6 +693,7 @@ class RingBufferFile : public BaseBuffer<T> {
       LOGI("pos 0");
       write_pos = 0;
       read_pos = 0;
+      invalidateReadCache();
     }
 
     return result;
@@ -451,10 +703,31 @@ class RingBufferFile : public BaseBuffer<T> {
   int readArray(T data[], int count) override {
     if (p_file == nullptr) return 0;
     int read_count = min(count, element_count);
-    file_seek(read_pos);
-    int elements_processed = file_read(data, read_count);
-    read_pos += elements_processed;
-    element_count -= elements_processed;
+    int elements_processed = 0;
+    if (cache_page > 0) {
+      // serve the data page wise from the read ahead cache
+      while (elements_processed < read_count) {
+        if (!inReadCache(read_pos)) fillReadCache(read_pos);
+        int offset = read_pos - read_cache_pos;
+        int n = min(read_count - elements_processed, read_cache_len - offset);
+        if (n <= 0) break;
+        memcpy(data + elements_processed, read_cache.data() + offset,
+               n * sizeof(T));
+        elements_processed += n;
+        read_pos += n;
+        element_count -= n;
+      }
+      if (auto_rewind && isEmpty()) {
+        write_pos = 0;
+        read_pos = 0;
+        invalidateReadCache();
+      }
+    } else {
+      file_seek(read_pos);
+      elements_processed = file_read(data, read_count);
+      read_pos += elements_processed;
+      element_count -= elements_processed;
+    }
     return elements_processed;
   }
 
@@ -463,6 +736,11 @@ class RingBufferFile : public BaseBuffer<T> {
     if (p_file == nullptr) return 0;
     if (isEmpty()) return -1;
 
+    if (cache_page > 0) {
+      if (!inReadCache(read_pos)) fillReadCache(read_pos);
+      return read_cache[read_pos - read_cache_pos];
+    }
+
     file_seek(read_pos);
     T result;
     size_t count = file_read(&result, 1);
@@ -480,6 +758,20 @@ class RingBufferFile : public BaseBuffer<T> {
   /// Fills the data from the buffer
   int writeArray(const T data[], int len) override {
     if (p_file == nullptr) return 0;
+    if (cache_page > 0) {
+      // coalesce the writes into page sized bursts
+      int result = 0;
+      while (result < len) {
+        int n = min(len - result, cache_page - write_cache_len);
+        memcpy(write_cache.data() + write_cache_len, data + result,
+               n * sizeof(T));
+        write_cache_len += n;
+        result += n;
+        if (write_cache_len == cache_page) flushWriteCache();
+      }
+      element_count += result;
+      return result;
+    }
     file_seek(write_pos);
     int elements_written = file_write(data, len);
     write_pos += elements_written;
@@ -487,11 +779,28 @@ class RingBufferFile : public BaseBuffer<T> {
     return elements_written;
   }
 
+  /// Defines an in-RAM page cache (elements of T per page): reads are done
+  /// page wise ahead of time and writes are coalesced into page sized
+  /// bursts, so SD access cost is paid once per page instead of per access.
+  /// Use a multiple of the sector size (e.g. 512 bytes) for best results.
+  void setCachePage(int elements) {
+    cache_page = elements;
+    read_cache.resize(elements);
+    write_cache.resize(elements);
+    invalidateReadCache();
+    write_cache_len = 0;
+  }
+
+  /// writes any pending cached data to the file
+  void flush() { flushWriteCache(); }
+
   // clears the buffer
   void reset() override {
     write_pos = 0;
     read_pos = 0;
     element_count = 0;
+    write_cache_len = 0;
+    invalidateReadCache();
     if (p_file != nullptr) file_seek(0);
   }
 
@@ -518,6 +827,45 @@ class RingBufferFile : public BaseBuffer<T> {
   int element_count;
   int max_size = INT_MAX;
   bool auto_rewind = true;
+  // optional page cache
+  int cache_page = 0;
+  Vector<T> read_cache;
+  int read_cache_pos = -1;
+  int read_cache_len = 0;
+  Vector<T> write_cache;
+  int write_cache_len = 0;
+
+  bool inReadCache(int pos) {
+    return read_cache_pos >= 0 && pos >= read_cache_pos &&
+           pos < read_cache_pos + read_cache_len;
+  }
+
+  void invalidateReadCache() {
+    read_cache_pos = -1;
+    read_cache_len = 0;
+  }
+
+  /// reads a full page ahead starting at pos; pending writes that overlap
+  /// the page are flushed first
+  void fillReadCache(int pos) {
+    if (pos + cache_page > write_pos) flushWriteCache();
+    int n = min(cache_page, write_pos - pos);
+    if (n <= 0) {
+      invalidateReadCache();
+      return;
+    }
+    file_seek(pos);
+    read_cache_len = file_read(read_cache.data(), n);
+    read_cache_pos = pos;
+  }
+
+  void flushWriteCache() {
+    if (write_cache_len == 0) return;
+    file_seek(write_pos);
+    int elements_written = file_write(write_cache.data(), write_cache_len);
+    write_pos += elements_written;
+    write_cache_len = 0;
+  }
 
   void file_seek(int pos) {
     if (p_file->position() != pos * sizeof(T)) {
@@ -554,7 +902,8 @@ class RingBufferFile : public BaseBuffer<T> {
 
 /**
  * @brief A lock free N buffer. If count=2 we create a DoubleBuffer, if
- * count=3 a TripleBuffer etc.
+ * count=3 a TripleBuffer etc. The watermark callbacks (see BaseBuffer)
+ * report the level as number of filled component buffers.
  * @ingroup buffers
  * @author Phil Schatzmann
  * @copyright GPLv3
@@ -603,9 +952,11 @@ class NBuffer : public BaseBuffer<T> {
       if (actual_write_buffer->isFull()) {
         addFilledBuffer(actual_write_buffer);
         actual_write_buffer = getNextAvailableBuffer();
+        this->checkWatermarks(filled_buffers.size());
       }
     } else {
       // Logger.debug("actual_write_buffer is full");
+      healthIncrement(HealthBufferOverflow);
     }
 
     if (start_time == 0l) {
@@ -617,6 +968,83 @@ class NBuffer : public BaseBuffer<T> {
     return result;
   }
 
+  /// writes a block of data: the data is distributed block-wise over the
+  /// component buffers
+  int writeBlock(const T data[], int len) override {
+    int result = 0;
+    while (result < len) {
+      if (actual_write_buffer == nullptr) {
+        actual_write_buffer = getNextAvailableBuffer();
+        if (actual_write_buffer == nullptr) break;
+      }
+      int written = actual_write_buffer->writeBlock(data + result, len - result);
+      if (actual_write_buffer->isFull()) {
+        addFilledBuffer(actual_write_buffer);
+        actual_write_buffer = getNextAvailableBuffer();
+        this->checkWatermarks(filled_buffers.size());
+      }
+      if (written == 0) break;
+      result += written;
+    }
+    if (result < len) healthIncrement(HealthBufferOverflow);
+    if (start_time == 0l) {
+      start_time = millis();
+    }
+    sample_count += result;
+    return result;
+  }
+
+  /// reads a block of data: the data is collected block-wise from the
+  /// component buffers
+  int readBlock(T data[], int len) override {
+    int result = 0;
+    while (result < len && available() > 0) {
+      result += actual_read_buffer->readBlock(data + result, len - result);
+    }
+    return result;
+  }
+
+  /// Zero copy write: provides a completely empty component buffer that can
+  /// be filled e.g. by a DMA transfer; do not mix with write() calls
+  T *acquire(int &len) override {
+    if (actual_write_buffer == nullptr) {
+      actual_write_buffer = getNextAvailableBuffer();
+    }
+    if (actual_write_buffer == nullptr) {
+      len = 0;
+      return nullptr;
+    }
+    len = buffer_size;
+    return actual_write_buffer->address();
+  }
+
+  bool commit(int len) override {
+    if (actual_write_buffer == nullptr || len > buffer_size) return false;
+    actual_write_buffer->setWritePos(len);
+    addFilledBuffer(actual_write_buffer);
+    actual_write_buffer = getNextAvailableBuffer();
+    this->checkWatermarks(filled_buffers.size());
+    if (start_time == 0l) {
+      start_time = millis();
+    }
+    sample_count += len;
+    return true;
+  }
+
+  /// Zero copy read: provides the filled region of the current read buffer
+  T *peekSpan(int &len) override {
+    if (available() == 0) {
+      len = 0;
+      return nullptr;
+    }
+    return actual_read_buffer->peekSpan(len);
+  }
+
+  bool consume(int len) override {
+    if (available() == 0) return len == 0;
+    return actual_read_buffer->consume(len);
+  }
+
   // determines the available entries for the current read buffer
   int available() {
     if (actual_read_buffer == nullptr) {
@@ -771,6 +1199,7 @@ class NBuffer : public BaseBuffer<T> {
     }
     // get next read buffer
     actual_read_buffer = getNextFilledBuffer();
+    this->checkWatermarks(filled_buffers.size());
   }
 
   virtual BaseBuffer<T> *getNextAvailableBuffer() {
@@ -796,6 +1225,141 @@ class NBuffer : public BaseBuffer<T> {
   }
 };
 
+/**
+ * @brief A lock free ping-pong buffer which owns exactly 2 equally sized,
+ * aligned blocks: the producer (e.g. an I2S capture callback) fills the
+ * front block while the consumer can process the completed back block as
+ * a whole (e.g. one writeArray to SD). The roles are swapped atomically
+ * when the front block is full and the back block has been consumed.
+ * Single producer / single consumer only.
+ * @ingroup buffers
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ */
+template <typename T>
+class DoubleBuffer : public BaseBuffer<T> {
+ public:
+  /// Allocates the 2 blocks with size entries each; the alignment (bytes)
+  /// should match the cache line or DMA requirements of the platform
+  DoubleBuffer(int size, int alignment = 64) { resize(size, alignment); }
+
+  void resize(int size, int alignment = 64) {
+    block_size = size;
+    owned.resize(2 * size * sizeof(T) + alignment - 1);
+    uintptr_t addr = (uintptr_t)owned.data();
+    addr = (addr + alignment - 1) & ~((uintptr_t)alignment - 1);
+    p_blocks[0] = (T *)addr;
+    p_blocks[1] = p_blocks[0] + size;
+    reset();
+  }
+
+  bool write(T data) override {
+    if (write_pos >= block_size && !swap()) return false;
+    p_blocks[front.load(std::memory_order_relaxed)][write_pos++] = data;
+    if (write_pos == block_size) swap();
+    return true;
+  }
+
+  int writeBlock(const T data[], int len) override {
+    int result = 0;
+    while (result < len) {
+      if (write_pos >= block_size && !swap()) break;
+      int n = min(len - result, block_size - write_pos);
+      memcpy(p_blocks[front.load(std::memory_order_relaxed)] + write_pos,
+             data + result, n * sizeof(T));
+      write_pos += n;
+      result += n;
+      if (write_pos == block_size) swap();
+    }
+    return result;
+  }
+
+  T read() override {
+    int avail = back_avail.load(std::memory_order_acquire);
+    if (avail == 0) return 0;
+    T result = backBlock()[block_size - avail];
+    back_avail.fetch_sub(1, std::memory_order_release);
+    return result;
+  }
+
+  int readBlock(T data[], int len) override {
+    int avail = back_avail.load(std::memory_order_acquire);
+    int result = min(len, avail);
+    if (result > 0) {
+      memcpy(data, backBlock() + (block_size - avail), result * sizeof(T));
+      back_avail.fetch_sub(result, std::memory_order_release);
+    }
+    return result;
+  }
+
+  T peek() override {
+    int avail = back_avail.load(std::memory_order_acquire);
+    if (avail == 0) return 0;
+    return backBlock()[block_size - avail];
+  }
+
+  /// Zero copy read: provides the unread part of the completed block
+  T *peekSpan(int &len) override {
+    len = back_avail.load(std::memory_order_acquire);
+    return len == 0 ? nullptr : backBlock() + (block_size - len);
+  }
+
+  bool consume(int len) override {
+    if (len > back_avail.load(std::memory_order_acquire)) return false;
+    back_avail.fetch_sub(len, std::memory_order_release);
+    return true;
+  }
+
+  bool isFull() override { return availableForWrite() == 0; }
+
+  int available() override {
+    return back_avail.load(std::memory_order_acquire);
+  }
+
+  int availableForWrite() override {
+    int result = block_size - write_pos;
+    // when the back block is empty a swap will provide a fresh block
+    if (back_avail.load(std::memory_order_acquire) == 0) result += block_size;
+    return result;
+  }
+
+  /// start of the completed (readable) block
+  T *address() override { return backBlock(); }
+
+  void reset() override {
+    write_pos = 0;
+    front.store(0, std::memory_order_relaxed);
+    back_avail.store(0, std::memory_order_release);
+  }
+
+  size_t size() override { return 2 * block_size; }
+
+  /// Provides the number of entries per block
+  int blockSize() { return block_size; }
+
+ protected:
+  Vector<uint8_t> owned;
+  T *p_blocks[2] = {nullptr, nullptr};
+  int block_size = 0;
+  int write_pos = 0;
+  std::atomic<int> front{0};
+  std::atomic<int> back_avail{0};
+
+  T *backBlock() { return p_blocks[1 - front.load(std::memory_order_acquire)]; }
+
+  /// swaps the roles of the blocks; fails while the consumer still has
+  /// unread data in the back block
+  bool swap() {
+    if (write_pos < block_size) return true;
+    if (back_avail.load(std::memory_order_acquire) != 0) return false;
+    front.store(1 - front.load(std::memory_order_relaxed),
+                std::memory_order_release);
+    back_avail.store(block_size, std::memory_order_release);
+    write_pos = 0;
+    return true;
+  }
+};
+
 /**
  * @brief Class which is usfull ot provide incremental data access e.g. for
  * EdgeImpulse which request data with an offset and length starting from 0 up
@@ -4,10 +4,18 @@
 
 namespace audio_tools {
 
+/**
+ * @brief Shape of the fade ramp: Linear is the default, EqualPower uses a
+ * sine segment which keeps the perceived loudness constant and is the
+ * recommended choice when two signals are crossfaded.
+ */
+enum class FadeCurve { Linear, EqualPower };
+
 /**
  * @brief Fade In and Fade out in order to prevent popping sound when the
  * audio is started or stopped. The fade in/out is performed over the length
- * of the buffer.
+ * of the buffer: the ramp is precomputed as a Q15 gain table when the fade
+ * is triggered and applied with one integer multiply per sample.
  *
  * @author Phil Schatzmann
  * @copyright GPLv3
@@ -37,6 +45,9 @@ public:
 
   bool isFadeOutActive() { return is_fade_out; }
 
+  /// Defines the shape of the fade ramp (default FadeCurve::Linear)
+  void setFadeCurve(FadeCurve curve) { this->curve = curve; }
+
   /// @brief Updates the amplitude of the data when a fade in or fade out has
   /// been requested
   /// @param data
@@ -52,8 +63,9 @@ public:
                              bytes / bytes_per_sample / channels, channels);
       break;
     case 24:
+      // int24_t is stored in 4 bytes unless USE_3BYTE_INT24 is set
       convertFrames<int24_t>((int24_t *)data,
-                             bytes / bytes_per_sample / channels, channels);
+                             bytes / sizeof(int24_t) / channels, channels);
       break;
     case 32:
       convertFrames<int32_t>((int32_t *)data,
@@ -74,50 +86,64 @@ protected:
   int channels = 2;
   float volume = 1.0;
   bool is_done = false;
+  FadeCurve curve = FadeCurve::Linear;
+  Vector<int16_t> ramp;
 
   template <typename T> void convertFrames(T *data, int frames, int channels) {
-    float delta = 1.0 / frames;
     // handle fade out
     if (is_fade_in) {
-      fadeIn<T>(data, frames, channels, delta);
+      fadeIn<T>(data, frames, channels);
       is_fade_in = false;
     }  else if (is_fade_out) {
-      fadeOut<T>(data, frames, channels, delta);
+      fadeOut<T>(data, frames, channels);
     }
     if (frames > 0) {
       is_done = true;
     }
   }
 
-  template <typename T>
-  void fadeOut(T *data, int frames, int channels, float delta) {
+  /// Precomputes the per frame Q15 gains for the requested fade: the float
+  /// math happens once at trigger time, the per sample work is an integer
+  /// multiply
+  void buildRamp(int frames, bool rising) {
+    ramp.resize(frames);
     for (int j = 0; j < frames; j++) {
-      for (int ch = 0; ch < channels; ch++) {
-        data[j * channels + ch] = data[j * channels + ch] * volume;
-        if (volume > 0) {
-          volume -= delta;
-          if (volume < 0) {
-            volume = 0;
-          }
-        }
-      }
+      float x = static_cast<float>(rising ? j + 1 : frames - 1 - j) / frames;
+      float factor = curve == FadeCurve::EqualPower ? sinf(x * PI / 2.0f) : x;
+      ramp[j] = static_cast<int16_t>(factor * 32767.0f);
     }
-    is_fade_out = false;
-    LOGI("faded out %d frames to volume %f",frames, volume);
   }
 
+  /// Scales each frame with its precomputed Q15 gain
   template <typename T>
-  void fadeIn(T *data, int frames, int channels, float delta) {
-    LOGI("fade in %d frames from volume %f",frames, volume);
+  void applyRamp(T *data, int frames, int channels) {
     for (int j = 0; j < frames; j++) {
+      int32_t gain = ramp[j];
+      T *frame = data + j * channels;
       for (int ch = 0; ch < channels; ch++) {
-        data[j * channels + ch] = data[j * channels + ch] * volume;
-        volume += delta;
-        if (volume > 1.0f) {
-          volume = 1.0f;
-        }
+        int32_t value = static_cast<int32_t>(frame[ch]);
+        // 16 bit samples get by with a 32 bit product
+        frame[ch] = (sizeof(T) <= 2)
+                        ? static_cast<T>((value * gain) >> 15)
+                        : static_cast<T>((static_cast<int64_t>(value) * gain) >> 15);
       }
     }
+  }
+
+  template <typename T>
+  void fadeOut(T *data, int frames, int channels) {
+    buildRamp(frames, false);
+    applyRamp<T>(data, frames, channels);
+    volume = 0.0f;
+    is_fade_out = false;
+    LOGI("faded out %d frames", frames);
+  }
+
+  template <typename T>
+  void fadeIn(T *data, int frames, int channels) {
+    LOGI("fade in %d frames", frames);
+    buildRamp(frames, true);
+    applyRamp<T>(data, frames, channels);
     volume = 1.0f;
     is_fade_in = false;
   }
@@ -309,6 +335,10 @@ public:
 
   bool isFadeOutActive() { return fade.isFadeOutActive(); }
 
+  /// Defines the shape of the fade ramp: use FadeCurve::EqualPower for
+  /// crossfades
+  void setFadeCurve(FadeCurve curve) { fade.setFadeCurve(curve); }
+
   bool isFadeComplete() { return fade.isFadeComplete(); }
 
   // If can not provide any more samples we bring the last sample slowy back to 0
@@ -344,11 +374,13 @@ public:
 
   bool isFadeOutActive() { return fade.isFadeOutActive(); }
 
+  /// Defines the shape of the fade ramp (default FadeCurve::Linear)
+  void setFadeCurve(FadeCurve curve) { fade.setFadeCurve(curve); }
+
   bool isFadeComplete() { return fade.isFadeComplete(); }
 
   virtual size_t convert(uint8_t *src, size_t size) {
-    int frames = size / sizeof(T) / channels;
-    fade.convertFrames<T>(src, frames, channels);
+    fade.convert(src, size, channels, sizeof(T) * 8);
     return size;
   };
 
@@ -0,0 +1,192 @@
+#pragma once
+#include "AudioTools/CoreAudio/AudioBasic/Collections/Vector.h"
+#include "AudioTools/CoreAudio/AudioEffects/SoundGenerator.h"
+#include "AudioTools/CoreAudio/AudioRuntime.h"
+#include "AudioTools/CoreAudio/Pipeline.h"
+
+namespace audio_tools {
+
+/**
+ * @brief Measures the end to end latency of an audio chain by injecting a
+ * short sine burst generated with a SineWaveGenerator and cross correlating
+ * the captured loopback signal against the reference: the lag of the
+ * correlation peak is the total latency. On the desktop the loopback is
+ * provided by a duplex MiniAudioStream, on a microcontroller by connecting
+ * the I2S data out pin to the data in pin. When a Pipeline with active
+ * measurement is attached, its per stage metrics are appended to the
+ * report, so the busy time of the individual stages can be compared with
+ * the measured total.
+ * @ingroup tools
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ */
+class LatencyMeasurement {
+ public:
+  void setAudioInfo(AudioInfo info) { this->info = info; }
+
+  /// Defines the frequency of the probe burst (default 1000 hz)
+  void setProbeFrequency(float hz) { probe_frequency = hz; }
+
+  /// Defines the length of the probe burst in frames (default 256)
+  void setProbeFrames(int frames) { probe_frames = frames; }
+
+  /// Defines the capture window and with it the max measurable latency
+  /// (default 500 ms)
+  void setWindowMs(int ms) { window_ms = ms; }
+
+  /// Gives up when the capture window could not be filled in time
+  void setTimeoutMs(uint32_t ms) { timeout_ms = ms; }
+
+  /// Minimum normalized correlation peak to accept a measurement
+  /// (default 0.5)
+  void setMinCorrelation(float value) { min_correlation = value; }
+
+  /// Attaches a Pipeline so that its metrics become part of the report:
+  /// call pipeline.setMeasurementActive(true) before adding the stages
+  void setPipeline(Pipeline &pipeline) { p_pipeline = &pipeline; }
+
+  /// Writes the probe to out and captures the loopback from in; returns
+  /// true when a correlation peak above the minimum was found
+  bool measure(Print &out, Stream &in) {
+    if (info.bits_per_sample != 16) {
+      LOGE("bits_per_sample %d not supported", info.bits_per_sample);
+      return false;
+    }
+    generateProbe();
+
+    // drop any stale loopback data
+    uint8_t trash[256];
+    while (in.available() > 0) in.readBytes(trash, sizeof(trash));
+
+    // send the probe followed by silence so that the chain keeps running
+    int channels = info.channels;
+    Vector<int16_t> frame_out;
+    frame_out.resize(probe_frames * channels);
+    for (int j = 0; j < probe_frames; j++) {
+      for (int ch = 0; ch < channels; ch++)
+        frame_out[j * channels + ch] = reference[j];
+    }
+    out.write((uint8_t *)frame_out.data(), frame_out.size() * sizeof(int16_t));
+
+    // capture the loopback window (first channel only)
+    int capture_frames =
+        probe_frames + window_ms * info.sample_rate / 1000;
+    captured.resize(capture_frames);
+    int16_t silence[64] = {0};
+    int16_t chunk[64];
+    int pos = 0;
+    uint32_t start = millis();
+    while (pos < capture_frames) {
+      if (millis() - start > timeout_ms) {
+        LOGW("capture timeout after %d of %d frames", pos, capture_frames);
+        break;
+      }
+      int len = in.readBytes((uint8_t *)chunk, sizeof(chunk));
+      int samples = len / sizeof(int16_t);
+      if (samples == 0) {
+        // keep the output side clocked
+        out.write((uint8_t *)silence, sizeof(silence));
+        continue;
+      }
+      for (int j = 0; j < samples && pos < capture_frames; j += channels) {
+        captured[pos++] = chunk[j];
+      }
+    }
+    return correlate(pos);
+  }
+
+  /// Measures using the same duplex stream for output and capture
+  bool measure(Stream &duplex) { return measure(duplex, duplex); }
+
+  /// Latency of the last measurement in milliseconds
+  float latencyMs() { return latency_ms; }
+
+  /// Latency of the last measurement in frames
+  int latencyFrames() { return lag_frames; }
+
+  /// Normalized correlation peak (0.0 - 1.0) of the last measurement
+  float correlation() { return peak_correlation; }
+
+  /// Prints a LATENCY csv line followed by the attached pipeline metrics
+  void report(Print &out) {
+    char msg[120];
+    snprintf(msg, sizeof(msg), "LATENCY, total_ms, %0.2f, frames, %d, corr, %0.2f",
+             latency_ms, lag_frames, peak_correlation);
+    out.println(msg);
+    if (p_pipeline != nullptr) {
+      p_pipeline->reportMetrics(out);
+    }
+  }
+
+ protected:
+  AudioInfo info;
+  Pipeline *p_pipeline = nullptr;
+  Vector<int16_t> reference;
+  Vector<int16_t> captured;
+  float probe_frequency = 1000.0f;
+  int probe_frames = 256;
+  int window_ms = 500;
+  uint32_t timeout_ms = 3000;
+  float min_correlation = 0.5f;
+  float latency_ms = 0.0f;
+  int lag_frames = -1;
+  float peak_correlation = 0.0f;
+
+  /// Generates the mono reference burst with a short fade in and out to
+  /// avoid clicks in the loopback
+  void generateProbe() {
+    reference.resize(probe_frames);
+    SineWaveGenerator<int16_t> sine;
+    AudioInfo mono{info.sample_rate, 1, 16};
+    sine.begin(mono, probe_frequency);
+    for (int j = 0; j < probe_frames; j++) reference[j] = sine.readSample();
+    int ramp = probe_frames / 8;
+    for (int j = 0; j < ramp; j++) {
+      float factor = static_cast<float>(j) / ramp;
+      reference[j] = reference[j] * factor;
+      reference[probe_frames - 1 - j] = reference[probe_frames - 1 - j] * factor;
+    }
+  }
+
+  /// Finds the lag with the highest normalized correlation between the
+  /// reference burst and the captured signal
+  bool correlate(int capture_len) {
+    lag_frames = -1;
+    peak_correlation = 0.0f;
+    latency_ms = 0.0f;
+    if (capture_len < probe_frames) return false;
+
+    int64_t ref_energy = 0;
+    for (int j = 0; j < probe_frames; j++)
+      ref_energy += (int32_t)reference[j] * reference[j];
+    if (ref_energy == 0) return false;
+
+    int lags = capture_len - probe_frames + 1;
+    for (int lag = 0; lag < lags; lag++) {
+      int64_t dot = 0;
+      int64_t energy = 0;
+      for (int j = 0; j < probe_frames; j++) {
+        int32_t sample = captured[lag + j];
+        dot += (int32_t)reference[j] * sample;
+        energy += (int64_t)sample * sample;
+      }
+      if (dot <= 0 || energy == 0) continue;
+      float corr = static_cast<float>(dot) /
+                   sqrtf(static_cast<float>(ref_energy) *
+                         static_cast<float>(energy));
+      if (corr > peak_correlation) {
+        peak_correlation = corr;
+        lag_frames = lag;
+      }
+    }
+
+    if (lag_frames < 0 || peak_correlation < min_correlation) {
+      LOGW("no correlation peak: %0.2f", peak_correlation);
+      return false;
+    }
+    latency_ms = 1000.0f * lag_frames / info.sample_rate;
+    return true;
+  }
+};
+
+}  // namespace audio_tools
@@ -131,7 +131,7 @@ public:
     float frequency(MusicalNotesEnum note, uint8_t octave) const {
         if (note>11) return 0;
         if (octave>8) return 0;
-        return notes[octave][note];
+        return notesTable()[octave][note];
     }
 
     /// Determines the frequency of the indicate note index from 0 to 107
@@ -167,7 +167,7 @@ public:
 
     /// Determines the closes note for a frequency. We also return the frequency difference
     const char* note(float frequency, float &diff) const {
-        float* all_notes = (float*) notes;
+        const float* all_notes = (const float*) notesTable();
         const int note_count = 12*9;
 
         // find closest note
@@ -183,7 +183,7 @@ public:
 
         float noteFrequency = all_notes[min_pos];
         diff = frequency - noteFrequency;
-        return notes_str[min_pos];
+        return notesStrTable()[min_pos];
     }
 
     /// Determines the closes note for a frequency
@@ -194,7 +194,7 @@ public:
 
     /// Provides the note name for an index position
     const char* noteAt(int idx) {
-        return notes_str[idx];
+        return notesStrTable()[idx];
     }
 
     /// Determine frequency of MIDI note
@@ -214,7 +214,11 @@ public:
 
 protected:
 
-    float notes[9][12] = {
+    // The tables are constexpr data in static storage, so they live in
+    // flash (rodata), cost no startup time and do not add to the size of
+    // a MusicalNotes instance
+    static const float (&notesTable())[9][12] {
+        static constexpr float notes[9][12] = {
         {N_C0, N_CS0, N_D0, N_DS0, N_E0, N_F0, N_FS0, N_G0, N_GS0, N_A0, N_AS0, N_B0},
         {N_C1, N_CS1, N_D1, N_DS1, N_E1, N_F1, N_FS1, N_G1, N_GS1, N_A1, N_AS1, N_B1},
         {N_C2, N_CS2, N_D2, N_DS2, N_E2, N_F2, N_FS2, N_G2, N_GS2, N_A2, N_AS2, N_B2},
@@ -224,9 +228,12 @@ protected:
         {N_C6, N_CS6, N_D6, N_DS6, N_E6, N_F6, N_FS6, N_G6, N_GS6, N_A6, N_AS6, N_B6},
         {N_C7, N_CS7, N_D7, N_DS7, N_E7, N_F7, N_FS7, N_G7, N_GS7, N_A7, N_AS7, N_B7},
         {N_C8, N_CS8, N_D8, N_DS8, N_E8, N_F8, N_FS8, N_G8, N_GS8, N_A8, N_AS8, N_B8}
-    };
+        };
+        return notes;
+    }
 
-    const char *notes_str[9*12]= {
+    static const char* const (&notesStrTable())[9*12] {
+        static constexpr const char *notes_str[9*12]= {
          "C0","CS0","D0","DS0","E0","F0","FS0","G0","GS0","A0","AS0","B0",
          "C1","CS1","D1","DS1","E1","F1","FS1","G1","GS1","A1","AS1","B1",
          "C2","CS2","D2","DS2","E2","F2","FS2","G2","GS2","A2","AS2","B2",
@@ -236,8 +243,9 @@ protected:
          "C6","CS6","D6","DS6","E6","F6","FS6","G6","GS6","A6","AS6","B6",
          "C7","CS7","D7","DS7","E7","F7","FS7","G7","GS7","A7","AS7","B7",
          "C8","CS8","D8","DS8","E8","F8","FS8","G8","GS8","A8","AS8","B8"
-    };
-
+        };
+        return notes_str;
+    }
 
 };
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "AudioTools/CoreAudio/AudioOutput.h"
+#include "AudioTools/CoreAudio/AudioRuntime.h"
 #include "AudioTools/CoreAudio/AudioStreams.h"
 #include "AudioTools/CoreAudio/AudioIO.h"
 
@@ -19,8 +20,33 @@ class Pipeline : public AudioStream {
 
  public:
   Pipeline() = default;
+
+  /// Activates the per stage measurement (bytes, busy time): must be called
+  /// before the first add(). Measured pipelines do not fuse in-place stages,
+  /// so expect a small overhead while measuring.
+  void setMeasurementActive(bool flag) {
+    if (size() > 0) {
+      LOGE("setMeasurementActive must be called before add()");
+      return;
+    }
+    is_measure = flag;
+  }
+
   ///  adds a component
   bool add(ModifyingStream& io) {
+    if (is_measure) {
+      ModifyingStream* stage = new MeasuringStage(io);
+      cleanup.push_back(stage);
+      return addComponent(*stage);
+    }
+    return addComponent(io);
+  }
+
+ protected:
+  ///  adds a (potentially wrapped) component to the chain
+  bool addComponent(ModifyingStream& io) {
+    // avoid a reallocation per added stage
+    if (components.capacity() == 0) components.reserve(8);
     if (has_output) {
       LOGE("Output already defined");
       is_ok = false;
@@ -55,6 +81,7 @@ class Pipeline : public AudioStream {
     return true;
   }
 
+ public:
   ///  adds a component
   bool add(ModifyingOutput& out) {
     if (has_output) {
@@ -147,7 +174,23 @@ class Pipeline : public AudioStream {
       return 0;
     }
     LOGD("write: %u", (unsigned)len);
-    return components[0]->write(data, len);
+    // fuse leading in-place stages: they are applied directly on the
+    // provided block and we enter the chain after them, saving the copy
+    // in and out per stage
+    int start = 0;
+    size_t act_len = len;
+    while (start < size() && components[start]->isInPlace()) {
+      act_len = components[start]->transformInPlace((uint8_t*)data, act_len);
+      start++;
+    }
+    if (start == 0) return components[0]->write(data, len);
+    size_t written = 0;
+    if (start < size()) {
+      written = components[start]->write(data, act_len);
+    } else if (p_print != nullptr) {
+      written = p_print->write(data, act_len);
+    }
+    return written == act_len ? len : written;
   }
 
   int available() override {
@@ -161,7 +204,20 @@ class Pipeline : public AudioStream {
     if (!is_active) return 0;
     Stream* in = getInput();
     if (in == nullptr) return 0;
-    return in->readBytes(data, len);
+    // fuse trailing in-place stages: we pull the data from below them and
+    // apply the transformations directly on the provided block
+    int end_idx = size();
+    while (end_idx > 0 && components[end_idx - 1]->isInPlace()) {
+      end_idx--;
+    }
+    if (end_idx == size()) return in->readBytes(data, len);
+    Stream* src = end_idx > 0 ? (Stream*)components[end_idx - 1] : p_stream;
+    if (src == nullptr) return 0;
+    size_t result = src->readBytes(data, len);
+    for (int j = end_idx; j < size(); j++) {
+      result = components[j]->transformInPlace(data, result);
+    }
+    return result;
   }
 
   /// Optional method: Calls begin on all components and setAudioInfo on first
@@ -200,6 +256,7 @@ class Pipeline : public AudioStream {
     setNotifyActive(true);
     is_active = ok;
     is_ok = ok;
+    clearMetrics();
     return ok;
   }
 
@@ -288,6 +345,77 @@ class Pipeline : public AudioStream {
   /// Returns true if pipeline is correctly set up and is active
   operator bool() { return is_ok && is_active; }
 
+  /// Resets the collected measurements: automatically called by begin()
+  void clearMetrics() {
+    start_us = micros();
+    if (!is_measure) return;
+    for (auto c : components) {
+      static_cast<MeasuringStage*>(c)->clearMeasurement();
+    }
+  }
+
+  /// Busy time in us which was spent in the indicated stage (and - for
+  /// stages which are not last in the chain - everything after it)
+  uint32_t metricsBusyUs(int idx) {
+    if (!is_measure || idx >= size()) return 0;
+    return static_cast<MeasuringStage*>(components[idx])->busy_us;
+  }
+
+  /// Bytes which were processed by the indicated stage
+  size_t metricsBytes(int idx) {
+    if (!is_measure || idx >= size()) return 0;
+    return static_cast<MeasuringStage*>(components[idx])->bytes;
+  }
+
+  /// Overall pipeline load between 0.0 and 1.0: the busy time of the
+  /// complete chain related to the wall time since begin()/clearMetrics().
+  /// Requires setMeasurementActive(true)
+  float metricsLoad() {
+    if (!is_measure || size() == 0) return 0.0f;
+    uint32_t total_us = (uint32_t)micros() - start_us;
+    if (total_us == 0) return 0.0f;
+    // the first stage of an output chain (resp. the last of an input
+    // chain) includes the busy time of everything behind it
+    int idx = has_input ? size() - 1 : 0;
+    float load = (float)metricsBusyUs(idx) / total_us;
+    return load > 1.0f ? 1.0f : load;
+  }
+
+  /// Writes the measurement report as csv: one line per stage with
+  /// stage;calls;bytes;busy_us;excl_us;cpu_pct;avail. busy_us includes the
+  /// time of the downstream stages, excl_us is the time spent in the stage
+  /// alone (the last stage includes the final output) and cpu_pct relates
+  /// excl_us to the wall time since begin()/clearMetrics(). avail is the
+  /// current availableForWrite() (output chain) resp. available() (input
+  /// chain) - a buffer fill indicator. Requires setMeasurementActive(true).
+  void reportMetrics(Print& out) {
+    if (!is_measure) {
+      LOGE("call setMeasurementActive(true) before add()");
+      return;
+    }
+    uint32_t total_us = (uint32_t)micros() - start_us;
+    if (total_us == 0) total_us = 1;
+    out.println("stage;calls;bytes;busy_us;excl_us;cpu_pct;avail");
+    char line[120];
+    for (int j = 0; j < size(); j++) {
+      auto* stage = static_cast<MeasuringStage*>(components[j]);
+      // the callee of an output stage is the next, of an input stage the
+      // prior one: its busy time is part of ours and is taken out again
+      int callee = has_input ? j - 1 : j + 1;
+      uint32_t callee_us = (callee >= 0 && callee < size())
+              ? static_cast<MeasuringStage*>(components[callee])->busy_us
+              : 0;
+      uint32_t excl_us =
+          stage->busy_us > callee_us ? stage->busy_us - callee_us : 0;
+      int avail = has_input ? stage->available() : stage->availableForWrite();
+      snprintf(line, sizeof(line), "%d;%u;%u;%u;%u;%0.1f;%d", j,
+               (unsigned)stage->calls, (unsigned)stage->bytes,
+               (unsigned)stage->busy_us, (unsigned)excl_us,
+               100.0f * excl_us / total_us, avail);
+      out.println(line);
+    }
+  }
+
  protected:
   Vector<ModifyingStream*> components{0};
   Vector<ModifyingStream*> cleanup{0};
@@ -295,6 +423,8 @@ class Pipeline : public AudioStream {
   bool has_input = false;
   bool is_ok = true;
   bool is_active = true;
+  bool is_measure = false;
+  uint32_t start_us = 0;
   // prior input for input pipline
   Stream* p_stream = nullptr;
   AudioInfoSource* p_ai_source = nullptr;
@@ -332,6 +462,62 @@ class Pipeline : public AudioStream {
     ModifyingOutput* p_out = nullptr;
   };
 
+  /// Wrapper which measures the time spent in a stage and the processed
+  /// bytes. It reports isInPlace() as false so that measured stages are
+  /// never fused and each one is timed via its own write()/readBytes().
+  struct MeasuringStage : public ModifyingStream {
+    MeasuringStage(ModifyingStream& stage) { p_stage = &stage; }
+
+    void setStream(Stream& in) override { p_stage->setStream(in); }
+
+    void setOutput(Print& out) override { p_stage->setOutput(out); }
+
+    int available() override { return p_stage->available(); }
+
+    int availableForWrite() override { return p_stage->availableForWrite(); }
+
+    size_t write(const uint8_t* data, size_t len) override {
+      uint32_t start = micros();
+      size_t result = p_stage->write(data, len);
+      busy_us += (uint32_t)micros() - start;
+      bytes += result;
+      calls++;
+      return result;
+    }
+
+    size_t readBytes(uint8_t* data, size_t len) override {
+      uint32_t start = micros();
+      size_t result = p_stage->readBytes(data, len);
+      busy_us += (uint32_t)micros() - start;
+      bytes += result;
+      calls++;
+      return result;
+    }
+
+    bool begin() override { return p_stage->begin(); }
+
+    void end() override { p_stage->end(); }
+
+    void setAudioInfo(AudioInfo info) override { p_stage->setAudioInfo(info); }
+
+    AudioInfo audioInfoOut() override { return p_stage->audioInfoOut(); }
+
+    void addNotifyAudioChange(AudioInfoSupport& bi) override {
+      p_stage->addNotifyAudioChange(bi);
+    }
+
+    void clearMeasurement() {
+      busy_us = 0;
+      bytes = 0;
+      calls = 0;
+    }
+
+    ModifyingStream* p_stage = nullptr;
+    uint32_t busy_us = 0;
+    size_t bytes = 0;
+    size_t calls = 0;
+  };
+
   /// we read from the last node or the defined input: null if no input is
   /// available
   Stream* getInput() {
@@ -343,4 +529,117 @@ class Pipeline : public AudioStream {
   }
 };
 
+/**
+ * @brief CPU frequency governor: steps the cpu clock between the configured
+ * frequencies based on the measured pipeline load (setMeasurementActive(true)
+ * and metricsLoad()) and an optional buffer fill level, so battery devices do
+ * not have to run at the maximum clock all the time. The clock is only
+ * lowered when the load estimated for the lower frequency still leaves the
+ * configured headroom; a low fill level steps up immediately. Call update()
+ * regularly - e.g. between tracks or from the copy loop; it returns true
+ * when the frequency was changed.
+ * @ingroup transform
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ */
+class PipelineCpuGovernor {
+ public:
+  PipelineCpuGovernor(Pipeline& pipeline) {
+    p_pipeline = &pipeline;
+    static const int default_mhz[] = {80, 160, 240};
+    setFrequencies(default_mhz, 3);
+  }
+
+  /// Defines the available frequency steps in MHz in increasing order
+  /// (default 80, 160, 240)
+  void setFrequencies(const int* mhz, int count) {
+    frequencies.resize(count);
+    for (int j = 0; j < count; j++) frequencies[j] = mhz[j];
+  }
+
+  /// Defines the maximum tolerated load (headroom margin, default 0.6):
+  /// above this the clock is stepped up
+  void setMaxLoad(float value) { max_load = value; }
+
+  /// Defines the hysteresis factor (default 0.75): we only step down when
+  /// the load estimated for the lower frequency stays below
+  /// maxLoad * factor
+  void setDownFactor(float value) { down_factor = value; }
+
+  /// Defines the minimum buffer fill level (default 0.25): below this the
+  /// clock is stepped up independently of the load
+  void setMinFillLevel(float value) { min_fill = value; }
+
+  /// Defines the callback which provides the buffer fill level (0.0 - 1.0)
+  void setFillLevelCallback(float (*cb)(void* ref), void* ref = nullptr) {
+    fill_callback = cb;
+    fill_ref = ref;
+  }
+
+  /// Defines how often the load is evaluated (default 2000 ms)
+  void setUpdateIntervalMs(uint32_t ms) { interval_ms = ms; }
+
+  /// Starts at the highest frequency: this guarantees the headroom until
+  /// the first measurement is in
+  bool begin() {
+    level_idx = frequencies.size() - 1;
+    applyFrequency(frequencies[level_idx]);
+    p_pipeline->clearMetrics();
+    last_ms = millis();
+    return true;
+  }
+
+  /// Evaluates load and fill level and steps the frequency when indicated
+  bool update() {
+    uint32_t now = millis();
+    if (now - last_ms < interval_ms) return false;
+    float load = p_pipeline->metricsLoad();
+    float fill =
+        fill_callback != nullptr ? fill_callback(fill_ref) : 1.0f;
+    p_pipeline->clearMetrics();
+    last_ms = now;
+
+    int idx = level_idx;
+    if (load > max_load || fill < min_fill) {
+      if (idx < frequencies.size() - 1) idx++;
+    } else if (idx > 0) {
+      // the load scales inversely with the clock: step down only when the
+      // estimated load at the lower frequency keeps the headroom
+      float estimated = load * frequencies[idx] / frequencies[idx - 1];
+      if (estimated < max_load * down_factor) idx--;
+    }
+    if (idx == level_idx) return false;
+    if (!applyFrequency(frequencies[idx])) return false;
+    LOGI("cpu: %d MHz (load %0.2f, fill %0.2f)", frequencies[idx], load, fill);
+    level_idx = idx;
+    return true;
+  }
+
+  /// Provides the currently selected frequency in MHz
+  int frequency() { return frequencies[level_idx]; }
+
+ protected:
+  Pipeline* p_pipeline = nullptr;
+  Vector<int> frequencies{0};
+  int level_idx = 0;
+  float max_load = 0.6f;
+  float down_factor = 0.75f;
+  float min_fill = 0.25f;
+  float (*fill_callback)(void*) = nullptr;
+  void* fill_ref = nullptr;
+  uint32_t interval_ms = 2000;
+  uint32_t last_ms = 0;
+
+  /// applies the frequency via the power management API: can be overwritten
+  /// e.g. for platforms with their own API
+  virtual bool applyFrequency(int mhz) {
+#if defined(ESP32) && defined(ARDUINO)
+    return setCpuMhz(mhz);
+#else
+    // no frequency scaling available: keep the bookkeeping working
+    return true;
+#endif
+  }
+};
+
 }  // namespace audio_tools
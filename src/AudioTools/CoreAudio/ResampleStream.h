@@ -10,6 +10,13 @@
 
 namespace audio_tools {
 
+/**
+ * @brief Supported resampling algorithms: linear interpolation (default) or
+ * a polyphase windowed sinc filter with precomputed Q15 coefficients which
+ * provides proper band limiting when downsampling.
+ */
+enum ResampleFilter { RESAMPLE_LINEAR, RESAMPLE_SINC };
+
 /**
  * @brief Optional Configuration object. The critical information is the
  * channels and the step_size. All other information is not used.
@@ -20,6 +27,15 @@ struct ResampleConfig : public AudioInfo {
   /// Optional fixed target sample rate
   int to_sample_rate = 0;
   int buffer_size = DEFAULT_BUFFER_SIZE;
+  /// Resampling algorithm
+  ResampleFilter filter = RESAMPLE_LINEAR;
+  /// Number of filter taps for RESAMPLE_SINC (must be even)
+  int sinc_taps = 16;
+  /// Number of precalculated filter phases for RESAMPLE_SINC
+  int sinc_phases = 32;
+  /// Advance the position with a 32.32 fixed point accumulator instead of
+  /// float arithmetic: integer-only and drift free on targets without FPU
+  bool fixed_point = false;
 };
 
 /**
@@ -66,10 +82,18 @@ class ResampleStream : public ReformatBaseStream {
     to_sample_rate = cfg.to_sample_rate;
     out_buffer.resize(cfg.buffer_size);
 
+    filter = cfg.filter;
+    sinc_taps = cfg.sinc_taps & ~1;  // force even
+    sinc_phases = cfg.sinc_phases;
+    history_frames = filter == RESAMPLE_SINC ? sinc_taps : 1;
+    fixed_point = cfg.fixed_point;
+
     setupLastSamples(cfg);
     setStepSize(cfg.step_size);
+    if (filter == RESAMPLE_SINC) setupSincFilter();
     is_first = true;
     idx = 0;
+    idx_fx = 0;
     // step_dirty = true;
     bytes_per_frame = info.bits_per_sample / 8 * info.channels;
 
@@ -144,6 +168,8 @@ class ResampleStream : public ReformatBaseStream {
   void setStepSize(float step) {
     LOGI("setStepSize: %f", step);
     step_size = step;
+    // 32.32 fixed point representation for the fixed_point mode
+    step_fx = (int64_t)((double)step * 4294967296.0 + 0.5);
   }
 
   void setTargetSampleRate(int rate) { to_sample_rate = rate; }
@@ -203,6 +229,16 @@ class ResampleStream : public ReformatBaseStream {
   float step_size = 1.0;
   int to_sample_rate = 0;
   int bytes_per_frame = 0;
+  // polyphase windowed sinc filter
+  ResampleFilter filter = RESAMPLE_LINEAR;
+  int sinc_taps = 16;
+  int sinc_phases = 32;
+  int history_frames = 1;
+  Vector<int16_t> sinc_table{0};
+  // optional 32.32 fixed point position
+  bool fixed_point = false;
+  int64_t idx_fx = 0;
+  int64_t step_fx = 0;
   // optional buffering
   bool is_buffer_active = USE_RESAMPLE_BUFFER;
   SingleBuffer<uint8_t> out_buffer{0};
@@ -211,11 +247,43 @@ class ResampleStream : public ReformatBaseStream {
   /// Sets up the buffer for the rollover samples
   void setupLastSamples(AudioInfo cfg) {
     int bytes_per_sample = cfg.bits_per_sample / 8;
-    int last_samples_size = cfg.channels * bytes_per_sample;
+    int last_samples_size = cfg.channels * bytes_per_sample * history_frames;
     last_samples.resize(last_samples_size);
     memset(last_samples.data(), 0, last_samples_size);
   }
 
+  /// Precalculates the Q15 polyphase filter bank: one windowed sinc filter
+  /// per phase, band limited to the target rate when downsampling
+  void setupSincFilter() {
+    sinc_table.resize(sinc_taps * sinc_phases);
+    // cutoff relative to the input Nyquist frequency w/ some transition margin
+    float cutoff = step_size > 1.0f ? 0.9f / step_size : 0.9f;
+    int half = sinc_taps / 2;
+    Vector<float> tmp(sinc_taps);
+    for (int p = 0; p < sinc_phases; p++) {
+      float frac = (float)p / sinc_phases;
+      float sum = 0.0f;
+      for (int k = 0; k < sinc_taps; k++) {
+        // distance of this tap from the interpolation point
+        float x = (k - half + 1) - frac;
+        float sinc = 1.0f;
+        if (x != 0.0f) {
+          float xpi = PI * cutoff * x;
+          sinc = sinf(xpi) / xpi;
+        }
+        // Hamming window over the filter length
+        float w = 0.54f - 0.46f * cosf(2.0f * PI * (k + 1.0f - frac) / sinc_taps);
+        tmp[k] = cutoff * sinc * w;
+        sum += tmp[k];
+      }
+      // normalize to unity gain and convert to Q15
+      int16_t *coeff = sinc_table.data() + p * sinc_taps;
+      for (int k = 0; k < sinc_taps; k++) {
+        coeff[k] = (int16_t)roundf(tmp[k] / sum * 32767.0f);
+      }
+    }
+  }
+
   /// Writes the buffer to defined output after resampling
   template <typename T>
   size_t write(Print *p_out, const uint8_t *buffer, size_t bytes,
@@ -244,11 +312,27 @@ class ResampleStream : public ReformatBaseStream {
     T frame[info.channels];
     size_t frame_size = sizeof(frame);
 
+    // the sinc filter needs taps/2 frames of lookahead
+    int guard = filter == RESAMPLE_SINC ? sinc_taps / 2 : 1;
+    int64_t limit_fx = (int64_t)(frames - guard) << 32;
+
     // process all samples
-    while (idx < frames - 1) {
-      for (int ch = 0; ch < info.channels; ch++) {
-        T result = getValue<T>(data, idx, ch);
-        frame[ch] = result;
+    while (fixed_point ? idx_fx < limit_fx : idx < frames - guard) {
+      if (fixed_point) {
+        // integer only: split the accumulator into frame and fraction
+        int frame_idx0 = (int)(idx_fx >> 32);
+        uint32_t frac = (uint32_t)idx_fx;
+        for (int ch = 0; ch < info.channels; ch++) {
+          frame[ch] = filter == RESAMPLE_SINC
+                          ? getValueSincFx<T>(data, frame_idx0, frac, ch)
+                          : getValueFx<T>(data, frame_idx0, frac, ch);
+        }
+      } else {
+        for (int ch = 0; ch < info.channels; ch++) {
+          T result = filter == RESAMPLE_SINC ? getValueSinc<T>(data, idx, ch)
+                                             : getValue<T>(data, idx, ch);
+          frame[ch] = result;
+        }
       }
 
       if (is_buffer_active) {
@@ -272,14 +356,22 @@ class ResampleStream : public ReformatBaseStream {
         }
       }
 
-      idx += step_size;
+      if (fixed_point) {
+        idx_fx += step_fx;
+      } else {
+        idx += step_size;
+      }
     }
 
     flush();
 
-    // save last samples to be made available at index position -1;
-    setupLastSamples<T>(data, frames - 1);
-    idx -= frames;
+    // save last samples to be made available at negative index positions
+    saveHistory<T>(data, frames);
+    if (fixed_point) {
+      idx_fx -= (int64_t)frames << 32;
+    } else {
+      idx -= frames;
+    }
 
     if (bytes != (written * step_size)) {
       LOGD("write: %d vs %d", (int)bytes, (int)written);
@@ -306,24 +398,86 @@ class ResampleStream : public ReformatBaseStream {
     return (float)round(result);
   }
 
-  /// lookup value for indicated frame & channel: index starts with -1;
+  /// get the band limited value for indicated (float) index value: Q15
+  /// multiply/accumulate over the precalculated filter phase
+  template <typename T>
+  T getValueSinc(T *data, float frame_idx, int channel) {
+    int frame_idx0 = (int)floorf(frame_idx);
+    float frac = frame_idx - frame_idx0;
+    int phase = (int)(frac * sinc_phases);
+    if (phase >= sinc_phases) phase = sinc_phases - 1;
+    return sincMac<T>(data, frame_idx0, phase, channel);
+  }
+
+  /// Q15 multiply/accumulate of the indicated filter phase
+  template <typename T>
+  T sincMac(T *data, int frame_idx0, int phase, int channel) {
+    int16_t *coeff = sinc_table.data() + phase * sinc_taps;
+    int half = sinc_taps / 2;
+    int64_t acc = 0;
+    for (int k = 0; k < sinc_taps; k++) {
+      acc += (int64_t)coeff[k] *
+             (int32_t)lookup<T>(data, frame_idx0 - half + 1 + k, channel);
+    }
+    return NumberConverter::clipT<T>((float)(acc >> 15));
+  }
+
+  /// integer-only linear interpolation for the fixed_point mode
+  template <typename T>
+  T getValueFx(T *data, int frame_idx0, uint32_t frac, int channel) {
+    int32_t val0 = lookup<T>(data, frame_idx0, channel);
+    int32_t val1 = lookup<T>(data, frame_idx0 + 1, channel);
+    // interpolate with a 16 bit fraction
+    int32_t f = frac >> 16;
+    return (T)(val0 + (int32_t)(((int64_t)(val1 - val0) * f) >> 16));
+  }
+
+  /// sinc filtering for the fixed_point mode: the filter phase is selected
+  /// with integer arithmetic
+  template <typename T>
+  T getValueSincFx(T *data, int frame_idx0, uint32_t frac, int channel) {
+    int phase = (int)(((uint64_t)frac * sinc_phases) >> 32);
+    return sincMac<T>(data, frame_idx0, phase, channel);
+  }
+
+  /// lookup value for indicated frame & channel: negative indexes are served
+  /// from the history of the previous run (-1 = last frame, -2 one before...)
   template <typename T>
   T lookup(T *data, int frame, int channel) {
     if (frame >= 0) {
       return data[frame * info.channels + channel];
     } else {
-      // index -1 (get last sample from previos run)
+      // get sample from previous run
       T *pt_last_samples = (T *)last_samples.data();
-      return pt_last_samples[channel];
+      return pt_last_samples[(history_frames + frame) * info.channels + channel];
     }
   }
-  /// store last samples to provide values for index -1
+  /// fill the complete history with the indicated frame (to avoid noise if
+  /// audio does not start with 0)
   template <typename T>
   void setupLastSamples(T *data, int frame) {
-    for (int ch = 0; ch < info.channels; ch++) {
-      T *pt_last_samples = (T *)last_samples.data();
-      pt_last_samples[ch] = data[(frame * info.channels) + ch];
-      LOGD("setupLastSamples ch:%d - %d", ch, (int)pt_last_samples[ch])
+    T *pt_last_samples = (T *)last_samples.data();
+    for (int h = 0; h < history_frames; h++) {
+      for (int ch = 0; ch < info.channels; ch++) {
+        pt_last_samples[h * info.channels + ch] =
+            data[(frame * info.channels) + ch];
+      }
+    }
+  }
+  /// store the trailing frames to provide the values for negative indexes
+  template <typename T>
+  void saveHistory(T *data, int frames) {
+    T *pt_last_samples = (T *)last_samples.data();
+    int ch = info.channels;
+    if (frames >= history_frames) {
+      memcpy(pt_last_samples, data + (frames - history_frames) * ch,
+             history_frames * ch * sizeof(T));
+    } else if (frames > 0) {
+      // short write: shift the existing history and append the new frames
+      memmove(pt_last_samples, pt_last_samples + frames * ch,
+              (history_frames - frames) * ch * sizeof(T));
+      memcpy(pt_last_samples + (history_frames - frames) * ch, data,
+             frames * ch * sizeof(T));
     }
   }
 };
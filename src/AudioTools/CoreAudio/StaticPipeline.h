@@ -0,0 +1,144 @@
+#pragma once
+
+#include <tuple>
+
+#include "AudioTools/CoreAudio/AudioStreams.h"
+#include "AudioTools/CoreAudio/Buffers.h"
+
+namespace audio_tools {
+
+/**
+ * @brief Compile time composed pipeline: the stages are defined as template
+ * arguments and invoked via their concrete type, so the complete chain is
+ * resolved statically - no component Vector, no pointer chasing and the
+ * compiler can inline the stage calls into one processing loop. The stages
+ * are applied in place on the data block and must provide the in-place
+ * contract (begin(), setAudioInfo() and transformInPlace()) which is
+ * implemented e.g. by VolumeStream, FilteredStream or ConverterStream. Use
+ * the dynamic Pipeline when the graph is only known at runtime.
+ *
+ * Example: StaticPipeline pipeline(filter, volume);
+ * pipeline.setInput(i2s_in); pipeline.setOutput(i2s_out);
+ * pipeline.begin(info); then call pipeline.copy() in the loop.
+ * @ingroup transform
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ * @tparam TStages the stage types in processing order
+ */
+template <class... TStages>
+class StaticPipeline : public AudioStream {
+ public:
+  StaticPipeline(TStages &...stageRefs) : stages(stageRefs...) {}
+
+  /// Defines the data source (for readBytes() and copy())
+  void setInput(Stream &in) { p_stream = &in; }
+
+  /// Defines the data sink (for write() and copy())
+  void setOutput(Print &out) { p_print = &out; }
+
+  /// Starts all stages and propagates the audio info
+  bool begin(AudioInfo info) {
+    setAudioInfo(info);
+    return begin();
+  }
+
+  /// Starts all stages
+  bool begin() override {
+    is_active = beginAll<0>();
+    return is_active;
+  }
+
+  void end() override { is_active = false; }
+
+  void setAudioInfo(AudioInfo newInfo) override {
+    AudioStream::setAudioInfo(newInfo);
+    setAudioInfoAll<0>(newInfo);
+  }
+
+  /// Reads a block from the input and applies all stages on it
+  size_t readBytes(uint8_t *data, size_t len) override {
+    if (!is_active || p_stream == nullptr) return 0;
+    size_t result = p_stream->readBytes(data, len);
+    return processAll<0>(data, result);
+  }
+
+  /// Applies all stages and writes the result to the output. Like the fused
+  /// in-place stages of Pipeline the provided block is transformed in place!
+  size_t write(const uint8_t *data, size_t len) override {
+    if (!is_active || p_print == nullptr) return 0;
+    size_t act_len = processAll<0>((uint8_t *)data, len);
+    size_t written = p_print->write(data, act_len);
+    return written == act_len ? len : written;
+  }
+
+  int available() override {
+    return p_stream == nullptr ? 0 : p_stream->available();
+  }
+
+  int availableForWrite() override {
+    return p_print == nullptr ? 0 : p_print->availableForWrite();
+  }
+
+  /// Processes one block from the input to the output: the tight copy loop
+  /// for the statically known graph. Returns the number of processed bytes
+  size_t copy() {
+    if (!is_active || p_stream == nullptr || p_print == nullptr) return 0;
+    if ((int)buffer.size() < copy_size) buffer.resize(copy_size);
+    size_t result = readBytes(buffer.data(), copy_size);
+    if (result > 0) {
+      result = p_print->write(buffer.data(), result);
+    }
+    return result;
+  }
+
+  /// Defines the block size used by copy() (default DEFAULT_BUFFER_SIZE)
+  void setCopySize(int size) { copy_size = size; }
+
+  /// Provides the number of stages
+  constexpr int size() { return sizeof...(TStages); }
+
+ protected:
+  std::tuple<TStages &...> stages;
+  Stream *p_stream = nullptr;
+  Print *p_print = nullptr;
+  SingleBuffer<uint8_t> buffer{0};
+  int copy_size = DEFAULT_BUFFER_SIZE;
+  bool is_active = false;
+
+  /// calls begin() on all stages
+  template <size_t I>
+  bool beginAll() {
+    if constexpr (I < sizeof...(TStages)) {
+      return std::get<I>(stages).begin() && beginAll<I + 1>();
+    }
+    return true;
+  }
+
+  /// calls setAudioInfo() on all stages
+  template <size_t I>
+  void setAudioInfoAll(AudioInfo newInfo) {
+    if constexpr (I < sizeof...(TStages)) {
+      std::get<I>(stages).setAudioInfo(newInfo);
+      setAudioInfoAll<I + 1>(newInfo);
+    }
+  }
+
+  /// applies the stages in order on the block: the calls are resolved at
+  /// compile time
+  template <size_t I>
+  size_t processAll(uint8_t *data, size_t len) {
+    if constexpr (I < sizeof...(TStages)) {
+      return processAll<I + 1>(data,
+                               std::get<I>(stages).transformInPlace(data, len));
+    }
+    return len;
+  }
+};
+
+#if __cplusplus >= 201703L
+// allow StaticPipeline pipeline(stage1, stage2);
+template <class... TStages>
+StaticPipeline(TStages &...) -> StaticPipeline<TStages...>;
+#endif
+
+}  // namespace audio_tools
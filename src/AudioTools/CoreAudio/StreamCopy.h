@@ -115,6 +115,7 @@ class StreamCopyT {
 
             // E.g. if we try to write to a server we might not have any output destination yet
             int to_write = to->availableForWrite();
+            AUDIO_TRACE(TraceBufferLevel, min(to_write, 32767));
             if (check_available_for_write && to_write==0){
                  delay(500);
                  return 0;
@@ -129,16 +130,27 @@ class StreamCopyT {
             size_t result = 0;
             size_t delayCount = 0;
             size_t len = bytes;
-            if (check_available) {
+            if (check_available || adaptive_copy_size) {
                 len = available();
             }
             size_t bytes_to_read = bytes;
-            size_t bytes_read = 0; 
+            size_t bytes_read = 0;
 
             if (len > 0){
                 bytes_to_read = min(len, static_cast<size_t>(buffer_size));
-                // don't overflow buffer
-                if (to_write > 0){
+                if (adaptive_copy_size){
+                    // size the transfer to the largest amount both sides can
+                    // handle (up to the configured cap)
+                    size_t max_both = len;
+                    if (to_write > 0){
+                        max_both = min(max_both, (size_t)to_write);
+                    }
+                    bytes_to_read = min(max_both, (size_t)max_copy_size);
+                    if (buffer.size() < bytes_to_read){
+                        buffer.resize(bytes_to_read);
+                    }
+                } else if (to_write > 0){
+                    // don't overflow buffer
                     bytes_to_read = min((int)bytes_to_read, to_write);
                 }
 
@@ -165,6 +177,7 @@ class StreamCopyT {
 
                 // write data
                 result = write(bytes_read, delayCount);
+                AUDIO_TRACE(TraceCopy, min(result, (size_t)32767));
 
                 // callback with unconverted data
                 if (onWrite!=nullptr) onWrite(onWriteObj, &buffer[0], result);
@@ -176,7 +189,8 @@ class StreamCopyT {
 
                 if (result == 0){
                     TRACED();
-                    // give the processor some time 
+                    AUDIO_TRACE(TraceCopyStall, 0);
+                    // give the processor some time
                     delay(delay_on_no_data);
                 }
 
@@ -351,10 +365,32 @@ class StreamCopyT {
             p_mime_detector = &mime;
         }
 
+        /// Adds an additional copy target: each filled buffer is fanned out
+        /// to all targets with bulk writes, so the source is read exactly
+        /// once per block
+        void addTarget(Print &out){
+            additional_targets.push_back(&out);
+        }
+
+        /// Removes all additional copy targets
+        void clearTargets(){
+            additional_targets.clear();
+        }
+
+        /// Activates adaptive block sizing: each copy() queries available()
+        /// and availableForWrite() and transfers the largest amount both
+        /// sides can handle in one call; maxSize caps the transfer (0 =
+        /// 4 x buffer size)
+        void setAdaptiveCopySize(bool flag, int maxSize = 0){
+            adaptive_copy_size = flag;
+            max_copy_size = maxSize == 0 ? 4 * buffer_size : maxSize;
+        }
+
     protected:
         Stream *from = nullptr;
         AudioStream *from_audio = nullptr;
         Print *to = nullptr;
+        Vector<Print*> additional_targets{0};
         Vector<uint8_t> buffer{0};
         int buffer_size = DEFAULT_BUFFER_SIZE;
         void (*onWrite)(void*obj, void*buffer, size_t len) = nullptr;
@@ -370,6 +406,8 @@ class StreamCopyT {
         int channels = 0;
         int min_copy_size = 1;
         bool is_sync_audio_info = false;
+        bool adaptive_copy_size = false;
+        int max_copy_size = 0;
         AudioInfoSupport *p_audio_info_support = nullptr;
         BaseConverter* p_converter = nullptr;
         MimeDetector* p_mime_detector = nullptr;
@@ -388,13 +426,24 @@ class StreamCopyT {
 
         /// blocking write - until everything is processed
         size_t write(size_t len, size_t &delayCount ){
+            size_t result = writeTo(to, len, delayCount);
+            // fan out the same buffer to the additional targets: the source
+            // is only read once per block
+            for (Print *p_out : additional_targets){
+                writeTo(p_out, len, delayCount);
+            }
+            return result;
+        }
+
+        /// blocking write to a single target - until everything is processed
+        size_t writeTo(Print *p_to, size_t len, size_t &delayCount ){
             if (!buffer || len==0) return 0;
             LOGD("write: %d", (int)len);
             size_t total = 0;
             long open = len;
             int retry = 0;
             while(open > 0){
-                size_t written = to->write((const uint8_t*)buffer.data()+total, open);
+                size_t written = p_to->write((const uint8_t*)buffer.data()+total, open);
                 LOGD("write: %d -> %d", (int) open, (int) written);
                 total += written;
                 open -= written;
@@ -0,0 +1,265 @@
+#pragma once
+
+#include "AudioTools/CoreAudio/AudioIO.h"
+
+namespace audio_tools {
+
+/**
+ * @brief Optional Configuration object for the TimeStretchStream. The tempo
+ * defines the speed up (>1.0) or slow down (<1.0) of the playback. The
+ * window parameters can usually be left at their defaults.
+ */
+struct TimeStretchConfig : public AudioInfo {
+  /// playback speed: 0.5 = half speed, 2.0 = double speed
+  float tempo = 1.0f;
+  /// length of one synthesis sequence in milliseconds
+  int sequence_ms = 40;
+  /// length of the cross fade between sequences in milliseconds
+  int overlap_ms = 8;
+  /// seek window in milliseconds for the best overlap search
+  int seek_ms = 15;
+};
+
+/**
+ * @brief Time stretching: changes the tempo of the audio without changing
+ * the pitch using WSOLA (waveform similarity overlap-add). Consecutive
+ * windows are taken from the input at a rate of tempo * synthesis hop, the
+ * start of each window is aligned with the previous output by a cross
+ * correlation search and the windows are joined with a linear cross fade.
+ * The sample processing is integer only; the position is advanced with a
+ * 16.16 fixed point accumulator.
+ * @author Phil Schatzmann
+ * @ingroup transform
+ * @copyright GPLv3
+ */
+class TimeStretchStream : public ReformatBaseStream {
+ public:
+  TimeStretchStream() = default;
+
+  /// Support for time stretching via write.
+  TimeStretchStream(Print &out) { setOutput(out); }
+
+  /// Support for time stretching via write. The audio information is copied
+  /// from the out
+  TimeStretchStream(AudioOutput &out) {
+    setAudioInfo(out.audioInfo());
+    setOutput(out);
+  }
+
+  /// Support for time stretching via write and read.
+  TimeStretchStream(Stream &io) { setStream(io); }
+
+  /// Support for time stretching via write and read. The audio information is
+  /// copied from the io
+  TimeStretchStream(AudioStream &io) {
+    setAudioInfo(io.audioInfo());
+    setStream(io);
+  }
+
+  /// Provides the default configuration
+  TimeStretchConfig defaultConfig() {
+    TimeStretchConfig cfg;
+    cfg.copyFrom(audioInfo());
+    return cfg;
+  }
+
+  bool begin(TimeStretchConfig cfg) {
+    LOGI("begin tempo: %f", cfg.tempo);
+    this->cfg = cfg;
+    bytes_per_frame = cfg.bits_per_sample / 8 * cfg.channels;
+    seq_frames = cfg.sequence_ms * cfg.sample_rate / 1000;
+    overlap_frames = cfg.overlap_ms * cfg.sample_rate / 1000;
+    seek_frames = cfg.seek_ms * cfg.sample_rate / 1000;
+    if (bytes_per_frame == 0 || seq_frames <= 0 || overlap_frames <= 0 ||
+        seek_frames <= 0 || overlap_frames * 2 >= seq_frames) {
+      LOGE("invalid window setup: seq: %d overlap: %d seek: %d", seq_frames,
+           overlap_frames, seek_frames);
+      return false;
+    }
+    hop_frames = seq_frames - overlap_frames;
+    setTempo(cfg.tempo);
+    // correlate in the 16 bit range
+    corr_shift = cfg.bits_per_sample > 16 ? cfg.bits_per_sample - 16 : 0;
+
+    // worst case consumption per step is tempo (max 4.0) * hop_frames
+    in_buffer.resize((seek_frames + seq_frames + 4 * hop_frames) *
+                     bytes_per_frame);
+    overlap_tail.resize(overlap_frames * bytes_per_frame);
+    out_frame.resize(hop_frames * bytes_per_frame);
+    mono_ref.resize(overlap_frames);
+    mono_in.resize(seek_frames + overlap_frames);
+
+    is_first = true;
+    hop_acc_fx = 0;
+
+    setupReader();
+    setAudioInfo(cfg);
+    return true;
+  }
+
+  bool begin(AudioInfo info, float tempo) {
+    TimeStretchConfig tcfg;
+    tcfg.copyFrom(info);
+    tcfg.tempo = tempo;
+    return begin(tcfg);
+  }
+
+  virtual bool begin(AudioInfo info) { return begin(info, tempo); }
+
+  bool begin() override { return begin(audioInfo()); }
+
+  /// Defines the playback speed: valid range 0.25 to 4.0, the intended
+  /// operating range is 0.5 to 2.0. Can be changed while active.
+  void setTempo(float factor) {
+    if (factor < 0.25f || factor > 4.0f) {
+      LOGW("tempo %f out of range", factor);
+      factor = factor < 0.25f ? 0.25f : 4.0f;
+    }
+    tempo = factor;
+    // analysis hop in frames as 16.16 fixed point
+    step_fx = (uint32_t)(tempo * hop_frames * 65536.0f + 0.5f);
+  }
+
+  /// Provides the actual playback speed
+  float getTempo() { return tempo; }
+
+  size_t write(const uint8_t *data, size_t len) override {
+    LOGD("TimeStretchStream::write: %d", (int)len);
+    switch (info.bits_per_sample) {
+      case 16:
+        return write<int16_t>(data, len);
+      case 24:
+        return write<int24_t>(data, len);
+      case 32:
+        return write<int32_t>(data, len);
+      default:
+        TRACEE();
+        return 0;
+    }
+  }
+
+  float getByteFactor() override { return 1.0f / tempo; }
+
+ protected:
+  TimeStretchConfig cfg;
+  SingleBuffer<uint8_t> in_buffer{0};
+  Vector<uint8_t> overlap_tail{0};
+  Vector<uint8_t> out_frame{0};
+  Vector<int32_t> mono_ref{0};
+  Vector<int32_t> mono_in{0};
+  float tempo = 1.0f;
+  int seq_frames = 0;
+  int overlap_frames = 0;
+  int seek_frames = 0;
+  int hop_frames = 0;
+  int bytes_per_frame = 0;
+  int corr_shift = 0;
+  uint32_t step_fx = 0;
+  uint32_t hop_acc_fx = 0;
+  bool is_first = true;
+
+  template <typename T>
+  size_t write(const uint8_t *data, size_t len) {
+    size_t pos = 0;
+    while (pos < len) {
+      pos += in_buffer.writeArray(data + pos, len - pos);
+      process<T>();
+    }
+    return len;
+  }
+
+  /// Produces output sequences as long as the input buffer holds enough data
+  template <typename T>
+  void process() {
+    int ch = info.channels;
+    while (true) {
+      // frames needed: the seek window plus one full sequence, but at least
+      // what the next analysis step is going to consume
+      int adv = (int)((hop_acc_fx + step_fx) >> 16);
+      int need = seq_frames + seek_frames;
+      if (adv + 1 > need) need = adv + 1;
+      if (in_buffer.available() < need * bytes_per_frame) break;
+
+      T *in = (T *)in_buffer.data();
+      T *prev = (T *)overlap_tail.data();
+      int offset = 0;
+      if (is_first) {
+        // nothing to align with yet: cross fading with itself is an identity
+        memcpy(overlap_tail.data(), in, overlap_frames * bytes_per_frame);
+        is_first = false;
+      } else {
+        offset = seekBestOverlap<T>(in);
+      }
+      T *src = in + offset * ch;
+      T *out = (T *)out_frame.data();
+
+      // linear cross fade from the previous tail into the selected window
+      for (int i = 0; i < overlap_frames; i++) {
+        for (int c = 0; c < ch; c++) {
+          int64_t mix = (int64_t)prev[i * ch + c] * (overlap_frames - i) +
+                        (int64_t)src[i * ch + c] * i;
+          out[i * ch + c] = (T)(int32_t)(mix / overlap_frames);
+        }
+      }
+      // the rest of the synthesis hop is copied unchanged
+      memcpy(out + overlap_frames * ch, src + overlap_frames * ch,
+             (hop_frames - overlap_frames) * bytes_per_frame);
+      // keep the tail for the next cross fade
+      memcpy(overlap_tail.data(), src + hop_frames * ch,
+             overlap_frames * bytes_per_frame);
+
+      p_print->write(out_frame.data(), hop_frames * bytes_per_frame);
+
+      // advance the input by tempo * synthesis hop
+      hop_acc_fx += step_fx;
+      adv = (int)(hop_acc_fx >> 16);
+      hop_acc_fx &= 0xFFFF;
+      in_buffer.clearArray(adv * bytes_per_frame);
+    }
+  }
+
+  /// Determines the start offset in the seek window which is most similar to
+  /// the previous tail: the correlation runs on a mono mix in the 16 bit
+  /// range with integer multiply accumulate; only the normalization of the
+  /// candidate metric uses float
+  template <typename T>
+  int seekBestOverlap(T *in) {
+    int ch = info.channels;
+    T *prev = (T *)overlap_tail.data();
+    for (int i = 0; i < overlap_frames; i++) {
+      mono_ref[i] = monoMix(prev + i * ch, ch);
+    }
+    int count = seek_frames + overlap_frames;
+    for (int i = 0; i < count; i++) {
+      mono_in[i] = monoMix(in + i * ch, ch);
+    }
+    int best = 0;
+    float best_metric = -1e30f;
+    for (int offset = 0; offset < seek_frames; offset++) {
+      int32_t *p = mono_in.data() + offset;
+      int64_t corr = 0;
+      int64_t norm = 0;
+      for (int i = 0; i < overlap_frames; i++) {
+        corr += (int64_t)p[i] * mono_ref[i];
+        norm += (int64_t)p[i] * p[i];
+      }
+      float metric = (float)corr / sqrtf((float)norm + 1.0f);
+      if (metric > best_metric) {
+        best_metric = metric;
+        best = offset;
+      }
+    }
+    return best;
+  }
+
+  template <typename T>
+  int32_t monoMix(T *frame, int channels) {
+    int32_t sum = 0;
+    for (int c = 0; c < channels; c++) {
+      sum += (int32_t)frame[c] >> corr_shift;
+    }
+    return sum / channels;
+  }
+};
+
+}  // namespace audio_tools
@@ -140,6 +140,92 @@ class SimulatedAudioPot : public VolumeControl {
         float x, y;
 };
 
+#if __cplusplus >= 201402L
+
+/// exp usable in constant expressions (Taylor series): the exponents used
+/// for the volume curves are small, so the series converges quickly
+constexpr float volume_exp(float x) {
+    double term = 1.0;
+    double sum = 1.0;
+    for (int j = 1; j <= 30; j++) {
+        term *= (double)x / j;
+        sum += term;
+    }
+    return (float)sum;
+}
+
+/// natural log usable in constant expressions: range reduction by halving
+/// plus the artanh series
+constexpr float volume_ln(float x) {
+    double xd = x;
+    constexpr double ln2 = 0.69314718055994530942;
+    int k = 0;
+    while (xd > 1.5) { xd /= 2.0; k++; }
+    while (xd < 0.75) { xd *= 2.0; k--; }
+    double y = (xd - 1.0) / (xd + 1.0);
+    double y2 = y * y;
+    double term = y;
+    double sum = 0.0;
+    for (int j = 0; j < 20; j++) {
+        sum += term / (2 * j + 1);
+        term *= y2;
+    }
+    return (float)(2.0 * sum + k * ln2);
+}
+
+/**
+ * @brief Logarithmic volume control from a compile time generated lookup
+ * table: same curve as LogarithmicVolumeControl, but the N entries are
+ * constexpr data in flash, so there is no powf at runtime and no RAM or
+ * startup cost. The steepness ym is provided in permille, since floating
+ * point template parameters are not available (100 = ym 0.1). Intermediate
+ * inputs are interpolated linearly between the table entries.
+ * @ingroup volume
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ * @tparam ym_permille steepness ym * 1000
+ * @tparam N number of table entries
+ */
+template <int ym_permille = 100, int N = 101>
+class LogVolumeControlT : public VolumeControl {
+    public:
+        LogVolumeControlT() = default;
+
+        // provides a factor in the range of 0.0 to 1.0
+        virtual float getVolumeFactor(float volume) {
+            float in = limit(volume);
+            float pos = in * (N - 1);
+            int idx = (int)pos;
+            if (idx >= N - 1) return table().data[N - 1];
+            float frac = pos - idx;
+            return table().data[idx] * (1.0f - frac) +
+                   table().data[idx + 1] * frac;
+        }
+
+    protected:
+        struct Table {
+            float data[N];
+            constexpr Table() : data{} {
+                constexpr float ym = ym_permille / 1000.0f;
+                constexpr float b = ((1.0f / ym) - 1.0f) * ((1.0f / ym) - 1.0f);
+                constexpr float a = 1.0f / (b - 1.0f);
+                constexpr float ln_b = volume_ln(b);
+                for (int j = 0; j < N; j++) {
+                    float input = (float)j / (N - 1);
+                    float value = volume_exp(input * ln_b) * a - a;
+                    data[j] = value > 1.0f ? 1.0f : (value < 0.0f ? 0.0f : value);
+                }
+            }
+        };
+
+        static const Table& table() {
+            static constexpr Table t{};
+            return t;
+        }
+};
+
+#endif // __cplusplus >= 201402L
+
 /**
  * @brief The simplest possible implementation of a VolumeControl: The input = output which describes a linear curve.
  * You would use this implementation if you physically connect an audio pot!
@@ -19,6 +19,9 @@ struct VolumeStreamConfig : public AudioInfo {
   }
   bool allow_boost = false;
   float volume=1.0;  // start_volume
+  /// Use the Q15 fixed point gain and ramp volume changes linearly across
+  /// each processed block to avoid zipper noise
+  bool ramp = false;
 };
 
 
@@ -199,6 +202,12 @@ class VolumeStream : public ModifyingStream, public VolumeSupport {
                 LOGI("setVolume: %f at %d", volume_value, channel);
                 float factor = volumeControl().getVolumeFactor(volume_value);
                 volume_values[channel]=volume_value;
+                // Q15 target for the ramped fixed point path
+                factor_q15_target[channel] = (int32_t)(factor * 32768.0f + 0.5f);
+                if (factor_q15_start[channel] < 0){
+                    // first definition: start at the target (no ramp)
+                    factor_q15_start[channel] = factor_q15_target[channel];
+                }
                 #if PREFER_FIXEDPOINT
                     //convert float to fixed point 2.6
                     //Fixedpoint-Math from https://github.com/earlephilhower/ESP8266Audio/blob/0abcf71012f6128d52a6bcd155ed1404d6cc6dcd/src/AudioOutput.h#L67
@@ -247,6 +256,9 @@ class VolumeStream : public ModifyingStream, public VolumeSupport {
         #else
             Vector<float> factor_for_channel;
         #endif
+        Vector<int32_t> factor_q15_start;  // Q15 factor at the block begin
+        Vector<int32_t> factor_q15_target; // Q15 factor at the block end
+        bool is_ramp_active = false;
         bool is_started = false;
         float max_value = 32767; // max value for clipping
         int max_channels = 0;
@@ -254,10 +266,20 @@ class VolumeStream : public ModifyingStream, public VolumeSupport {
         // checks if volume needs to be updated
         bool isVolumeUpdate(){
             if (!is_started) return false;
+            // a pending ramp must be completed even towards full volume
+            if (is_ramp_active && isRampPending()) return true;
             if (isAllChannelsFullVolume()) return false;
             return true;
         }
 
+        // checks if any channel still needs to ramp to its target factor
+        bool isRampPending(){
+            for (int ch=0;ch<info.channels;ch++){
+                if (factor_q15_start[ch] != factor_q15_target[ch]) return true;
+            }
+            return false;
+        }
+
         bool isAllChannelsFullVolume(){
             for (int ch=0;ch<info.channels;ch++){
                 if (volume_values[ch]!=1.0) return false;
@@ -269,6 +291,14 @@ class VolumeStream : public ModifyingStream, public VolumeSupport {
         void setupVectors() {
             factor_for_channel.resize(info.channels);
             volume_values.resize(info.channels);
+            int old_size = factor_q15_start.size();
+            factor_q15_start.resize(info.channels);
+            factor_q15_target.resize(info.channels);
+            for (int ch=old_size;ch<info.channels;ch++){
+                // -1 marks "not defined yet"
+                factor_q15_start[ch] = -1;
+                factor_q15_target[ch] = 32768;
+            }
         }
 
         /// Provides a VolumeStreamConfig based on a AudioInfo
@@ -285,6 +315,7 @@ class VolumeStream : public ModifyingStream, public VolumeSupport {
         /// Stores the local variable and calculates some max values
         void setupVolumeStreamConfig(VolumeStreamConfig cfg){
             info = cfg;
+            is_ramp_active = cfg.ramp;
             max_value = NumberConverter::maxValue(info.bits_per_sample);
             if (info.channels>max_channels){
               max_channels = info.channels;
@@ -314,6 +345,22 @@ class VolumeStream : public ModifyingStream, public VolumeSupport {
         }
 
         void applyVolume(const uint8_t *buffer, size_t size){
+            if (is_ramp_active){
+                switch(info.bits_per_sample){
+                    case 16:
+                        applyVolumeRamped<int16_t>((int16_t*)buffer, size/2);
+                        return;
+                    case 24:
+                        applyVolumeRamped<int24_t>((int24_t*)buffer, size/sizeof(int24_t));
+                        return;
+                    case 32:
+                        applyVolumeRamped<int32_t>((int32_t*)buffer, size/4);
+                        return;
+                    default:
+                        LOGE("Unsupported bits_per_sample: %d", info.bits_per_sample);
+                        return;
+                }
+            }
             switch(info.bits_per_sample){
                 case 16:
                     applyVolume16((int16_t*)buffer, size/2);
@@ -329,6 +376,40 @@ class VolumeStream : public ModifyingStream, public VolumeSupport {
             }
         }
 
+        /// Q15 fixed point gain: the factor is interpolated linearly from the
+        /// value at the last block end to the requested target across the
+        /// block, so volume jumps do not produce zipper noise. With a stable
+        /// volume this reduces to one integer multiply/shift per sample.
+        template <typename T>
+        void applyVolumeRamped(T* data, size_t size){
+            int channels = info.channels;
+            int frames = size / channels;
+            if (frames == 0) return;
+            int64_t max_val = (int64_t)max_value;
+            for (int ch=0; ch<channels; ch++){
+                int32_t start = factor_q15_start[ch];
+                if (start < 0) start = 32768;
+                int32_t target = factor_q15_target[ch];
+                if (start == target && start == 32768) continue;
+                // Q30 accumulator for a smooth per frame increment
+                int64_t acc = (int64_t)start << 15;
+                int64_t step = ((int64_t)(target - start) << 15) / frames;
+                T* p = data + ch;
+                for (int j=0; j<frames; j++){
+                    int32_t factor = (int32_t)(acc >> 15);
+                    int64_t result = ((int64_t)(int32_t)*p * factor) >> 15;
+                    if (!info.allow_boost){
+                        if (result > max_val) result = max_val;
+                        if (result < -max_val) result = -max_val;
+                    }
+                    *p = (T)result;
+                    p += channels;
+                    acc += step;
+                }
+                factor_q15_start[ch] = target;
+            }
+        }
+
         void applyVolume16(int16_t* data, size_t size){
             for (size_t j=0;j<size;j++){
                 #if PREFER_FIXEDPOINT
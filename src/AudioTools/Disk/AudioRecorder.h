@@ -0,0 +1,182 @@
+#pragma once
+
+#include "AudioTools/CoreAudio/AudioOutput.h"
+#include "AudioTools/CoreAudio/Buffers.h"
+
+// Special logic for SDTFAT
+#ifdef SDT_FAT_VERSION
+#  define USE_SDFAT
+#endif
+
+namespace audio_tools {
+
+/**
+ * @brief Recording sink for long SD recordings with bounded write
+ * latency: the audio task only copies into a RAM staging ring (PSRAM
+ * when available) and flushStep() - called from loop() or a low priority
+ * task - writes aligned chunks to the file. The file can be preallocated
+ * in one large extent (SdFat), so the cluster chain does not grow during
+ * the recording, and the directory entry update (sync) is deferred to a
+ * configurable interval. Before every sync the true data length is
+ * journaled to a sidecar file, so a recording which was interrupted by a
+ * crash or power loss can be recovered with recoverLength().
+ * @ingroup io
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ * @tparam SDT SD library class
+ * @tparam FileT file class of the SD library
+ */
+template <class SDT, class FileT>
+class AudioRecorder : public AudioOutput {
+ public:
+  AudioRecorder(SDT &sd) { p_sd = &sd; }
+
+  ~AudioRecorder() { end(); }
+
+  /// Defines the staging ring size in bytes (default 64k): it must cover
+  /// the worst case SD stall
+  void setBufferSize(int size) { buffer_size = size; }
+
+  /// Defines the number of bytes per SD write (default 4096): a multiple
+  /// of the sector size keeps the writes aligned
+  void setChunkSize(int size) { chunk_size = size; }
+
+  /// Defines how often the directory entry and the journal are updated
+  /// (default 10000 ms)
+  void setSyncInterval(uint32_t ms) { sync_interval_ms = ms; }
+
+  /// Opens the file and optionally preallocates the indicated extent
+  bool begin(const char *path, uint64_t preallocateBytes = 0) {
+    TRACED();
+    file = p_sd->open(path, FILE_WRITE);
+    if (!file) {
+      LOGE("open failed: %s", path);
+      return false;
+    }
+#ifdef USE_SDFAT
+    if (preallocateBytes > 0 && !file.preAllocate(preallocateBytes)) {
+      LOGW("preAllocate %u MB failed",
+           (unsigned)(preallocateBytes / 1024 / 1024));
+    }
+#else
+    if (preallocateBytes > 0) LOGI("preallocation not supported");
+#endif
+    snprintf(journal_path, sizeof(journal_path), "%s.len", path);
+    ring.resize(buffer_size);
+    ring.reset();
+    length = 0;
+    bytes_dropped = 0;
+    last_sync_ms = millis();
+    is_active = true;
+    return true;
+  }
+
+  /// Flushes the remaining data, truncates the file to the true length
+  /// and removes the journal
+  void end() override {
+    TRACED();
+    if (!is_active) return;
+    // drain the staging ring completely
+    while (ring.available() > 0) flushChunk(ring.available());
+#ifdef USE_SDFAT
+    file.truncate(length);
+#endif
+    file.close();
+    p_sd->remove(journal_path);
+    is_active = false;
+  }
+
+  /// Called from the audio task: only copies into the staging ring
+  size_t write(const uint8_t *data, size_t len) override {
+    if (!is_active) return 0;
+    size_t result = ring.writeArray(data, len);
+    bytes_dropped += len - result;
+    return result;
+  }
+
+  int availableForWrite() override { return ring.availableForWrite(); }
+
+  /// Call from loop() or a background task: writes at most one aligned
+  /// chunk and performs the deferred sync
+  size_t flushStep() {
+    if (!is_active) return 0;
+    size_t result = 0;
+    if (ring.available() >= chunk_size) result = flushChunk(chunk_size);
+    if (millis() - last_sync_ms >= sync_interval_ms) sync();
+    return result;
+  }
+
+  /// Number of recorded bytes
+  uint64_t size() { return length; }
+
+  /// Number of bytes which were lost because the staging ring was full
+  size_t bytesDropped() { return bytes_dropped; }
+
+  /// Fill level of the staging ring in bytes
+  int bufferAvailable() { return ring.available(); }
+
+  /// Provides the journaled length of an interrupted recording: the
+  /// bytes beyond it belong to the preallocated extent and are garbage
+  uint64_t recoverLength(const char *path) {
+    char jpath[sizeof(journal_path)];
+    snprintf(jpath, sizeof(jpath), "%s.len", path);
+    FileT f = p_sd->open(jpath);
+    if (!f) return 0;
+    JournalRecord rec;
+    bool ok = f.read((uint8_t *)&rec, sizeof(rec)) == sizeof(rec) &&
+              rec.magic == JournalMagic;
+    f.close();
+    return ok ? rec.length : 0;
+  }
+
+ protected:
+  static const uint32_t JournalMagic = 0x41524543;  // "AREC"
+
+  struct JournalRecord {
+    uint32_t magic = JournalMagic;
+    uint64_t length = 0;
+  };
+
+  SDT *p_sd = nullptr;
+  FileT file;
+  RingBuffer<uint8_t> ring{0};
+  Vector<uint8_t> chunk{0};
+  char journal_path[200] = {0};
+  int buffer_size = 64 * 1024;
+  int chunk_size = 4096;
+  uint32_t sync_interval_ms = 10000;
+  uint32_t last_sync_ms = 0;
+  uint64_t length = 0;
+  size_t bytes_dropped = 0;
+  bool is_active = false;
+
+  size_t flushChunk(int len) {
+    if (chunk.size() != (size_t)chunk_size) chunk.resize(chunk_size);
+    int n = min(len, chunk_size);
+    n = ring.readArray(chunk.data(), n);
+    if (n > 0) {
+      file.write(chunk.data(), n);
+      length += n;
+    }
+    return n;
+  }
+
+  /// Journals the true length first, then updates the directory entry
+  void sync() {
+    JournalRecord rec;
+    rec.length = length;
+    FileT journal = p_sd->open(journal_path, FILE_WRITE);
+    if (journal) {
+      journal.write((const uint8_t *)&rec, sizeof(rec));
+      journal.close();
+    }
+#ifdef USE_SDFAT
+    file.sync();
+#else
+    file.flush();
+#endif
+    last_sync_ms = millis();
+  }
+};
+
+}  // namespace audio_tools
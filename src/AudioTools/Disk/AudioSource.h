@@ -59,6 +59,10 @@ public:
     /// Returns default setting go to the next
     virtual bool isAutoNext() {return true; }
 
+    /// Repositions the actual stream (e.g. file) to the indicated byte
+    /// offset: returns false if the source does not support seeking
+    virtual bool setPosition(size_t pos) { return false; }
+
     /// access with array syntax
     Stream* operator[](int idx){
         return setIndex(idx);
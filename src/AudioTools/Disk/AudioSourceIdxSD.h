@@ -95,6 +95,17 @@ public:
   /// Dylan.*"
   void setFileFilter(const char *filter) { file_name_pattern = filter; }
 
+  /// Activates the incremental index revalidation: only changed
+  /// directories are rescanned on begin()
+  void setIncrementalCheck(bool active) { idx.setIncrementalCheck(active); }
+
+  /// Activates the random play order: each index access then provides a
+  /// shuffled title
+  void setShuffle(bool active) { idx.setShuffle(active); }
+
+  /// Draws a new random play order
+  void reshuffle() { idx.reshuffle(); }
+
   /// Provides the current index position
   int index() { return idx_pos; }
 
@@ -69,6 +69,12 @@ public:
   // provides default setting go to the next
   virtual bool isAutoNext() { return true; }
 
+  /// Repositions the actual file to the indicated byte offset
+  virtual bool setPosition(size_t pos) override {
+    if (!file) return false;
+    return file.seek(pos);
+  }
+
   /// Allows to "correct" the start path if not defined in the constructor
   virtual void setPath(const char *p) { start_path = p; }
 
@@ -0,0 +1,129 @@
+#pragma once
+
+#include "AudioTools/CoreAudio/BaseStream.h"
+#include "AudioTools/CoreAudio/Buffers.h"
+#include "AudioTools/Disk/AudioSource.h"
+
+namespace audio_tools {
+
+/**
+ * @brief Presents the files of an AudioSource as one continuous Stream
+ * for gapless album playback: when the remaining data of the actual file
+ * fits into the tail buffer, the remainder is read into RAM and the next
+ * file is opened right away - the transition is then served from the
+ * buffer while the next file is already providing data, so the decoder
+ * never sees a gap. This also works with sources which reuse a single
+ * File object, since the old file is fully buffered before the next one
+ * is opened. Use it only when the files share the same format (e.g. an
+ * album of MP3 files with identical parameters), since the decoder is
+ * not reset between the files.
+ * @ingroup player
+ * @ingroup io
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ */
+class ChainedFileStream : public BaseStream {
+ public:
+  /**
+   * @brief Construct a new Chained File Stream
+   *
+   * @param source the AudioSource which provides the files
+   * @param tailBufferSize tail buffer in bytes: the switch to the next
+   * file happens when the remainder of the actual file fits into it
+   */
+  ChainedFileStream(AudioSource &source, int tailBufferSize = 8 * 1024) {
+    p_source = &source;
+    tail.resize(tailBufferSize);
+    tail_size = tailBufferSize;
+  }
+
+  /// Opens the first file
+  bool begin(int startIndex = 0) {
+    TRACED();
+    next_index = startIndex;
+    tail.reset();
+    p_current = p_source->selectStream(next_index);
+    return p_current != nullptr;
+  }
+
+  void end() override {
+    p_current = nullptr;
+    tail.reset();
+  }
+
+  /// Provides the data of all chained files as one continuous stream
+  size_t readBytes(uint8_t *data, size_t len) override {
+    size_t result = 0;
+    while (result < len) {
+      // serve the buffered tail of the previous file first
+      if (tail.available() > 0) {
+        result += tail.readArray(data + result, len - result);
+        continue;
+      }
+      if (p_current == nullptr) break;
+      // when the remainder fits into the tail buffer we buffer it and
+      // open the next file right away
+      int avail = p_current->available();
+      if (avail > 0 && avail <= tail_size) {
+        bufferTailAndOpenNext(avail);
+        continue;
+      }
+      int read = p_current->readBytes(data + result, len - result);
+      if (read <= 0) {
+        // unexpected end: move to the next file directly
+        openNext();
+        if (p_current == nullptr && tail.available() == 0) break;
+        continue;
+      }
+      result += read;
+    }
+    return result;
+  }
+
+  int available() override {
+    int result = tail.available();
+    if (p_current != nullptr) result += p_current->available();
+    return result;
+  }
+
+  size_t write(const uint8_t *data, size_t len) override { return 0; }
+
+  int availableForWrite() override { return 0; }
+
+  /// Index of the file which is currently providing data
+  int fileIndex() { return index_pos; }
+
+  operator bool() { return available() > 0; }
+
+ protected:
+  AudioSource *p_source = nullptr;
+  Stream *p_current = nullptr;
+  SingleBuffer<uint8_t> tail{0};
+  int tail_size = 0;
+  int next_index = 0;
+  int index_pos = 0;
+
+  /// Reads the remainder of the actual file into the tail buffer and
+  /// opens the next file
+  void bufferTailAndOpenNext(int avail) {
+    TRACED();
+    tail.reset();
+    int filled = 0;
+    while (filled < avail) {
+      int read = p_current->readBytes(tail.address() + filled, avail - filled);
+      if (read <= 0) break;
+      filled += read;
+    }
+    tail.setAvailable(filled);
+    openNext();
+  }
+
+  void openNext() {
+    index_pos = next_index;
+    next_index++;
+    p_current = p_source->selectStream(next_index);
+    if (p_current == nullptr) LOGI("last file reached");
+  }
+};
+
+}  // namespace audio_tools
@@ -0,0 +1,179 @@
+#pragma once
+
+#include "AudioTools/CoreAudio/AudioMetaData/MetaDataID3.h"
+#include "AudioTools/Disk/AudioSource.h"
+
+// Special logic for SDTFAT
+#ifdef SDT_FAT_VERSION
+#  define USE_SDFAT
+#endif
+
+namespace audio_tools {
+
+/**
+ * @brief Fixed width metadata record which is stored in the cache file
+ * @ingroup metadata
+ */
+struct MetaDataRecord {
+  char title[64] = {0};
+  char artist[48] = {0};
+  char album[48] = {0};
+  char genre[16] = {0};
+};
+
+/**
+ * @brief Metadata pre-scan cache: walks an AudioSource once, extracts the
+ * ID3 metadata with a bounded read per file and stores one fixed width
+ * record per title in a cache file on the card. A browse UI can then
+ * query title/artist/album for any index with a single seek instead of
+ * opening and parsing the audio file. The scan can be executed step by
+ * step (e.g. from a background task or from loop()) via scanStep(); run
+ * it while no playback is active, since it shares the SD card and the
+ * source with the player.
+ * @ingroup metadata
+ * @ingroup player
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ * @tparam SDT SD library class
+ * @tparam FileT file class of the SD library
+ */
+template <class SDT, class FileT>
+class MetaDataCache {
+ public:
+  MetaDataCache(SDT &sd) { p_sd = &sd; }
+
+  /// Defines the cache file location (default /meta-cache.bin)
+  void begin(const char *cachePath = "/meta-cache.bin") {
+    cache_path = cachePath;
+  }
+
+  /// Starts the scan of the indicated number of titles
+  bool beginScan(AudioSource &source, long count,
+                 int maxBytesPerFile = 16 * 1024) {
+    TRACED();
+    p_source = &source;
+    scan_count = count;
+    scan_pos = 0;
+    max_bytes = maxBytesPerFile;
+    scan_file = p_sd->open(cache_path, FILE_WRITE);
+    return scan_file;
+  }
+
+  /// Scans the next title and appends its record to the cache: returns
+  /// false when the scan is completed
+  bool scanStep() {
+    if (scan_pos >= scan_count) return false;
+    MetaDataRecord rec;
+    scanTitle(scan_pos, rec);
+    scan_file.write((const uint8_t *)&rec, sizeof(rec));
+    scan_pos++;
+    if (scan_pos >= scan_count) {
+      scan_file.close();
+      LOGI("Metadata scan completed: %ld titles", scan_count);
+      return false;
+    }
+    return true;
+  }
+
+  /// Scans all titles in one go (blocking)
+  void scan(AudioSource &source, long count, int maxBytesPerFile = 16 * 1024) {
+    beginScan(source, count, maxBytesPerFile);
+    while (scanStep());
+  }
+
+  /// Number of cached records
+  long size() {
+    FileT f = p_sd->open(cache_path);
+    long result = f.size() / sizeof(MetaDataRecord);
+    f.close();
+    return result;
+  }
+
+  /// True when the cache matches the indicated title count
+  bool isValid(long count) { return size() == count; }
+
+  /// Provides the record of the indicated title with a single seek
+  bool get(long idx, MetaDataRecord &result) {
+    if (idx < 0) return false;
+    FileT f = p_sd->open(cache_path);
+    if (!f) return false;
+    seek(f, idx * sizeof(MetaDataRecord));
+    bool ok = f.read((uint8_t *)&result, sizeof(MetaDataRecord)) ==
+              sizeof(MetaDataRecord);
+    f.close();
+    return ok;
+  }
+
+ protected:
+  SDT *p_sd = nullptr;
+  AudioSource *p_source = nullptr;
+  FileT scan_file;
+  const char *cache_path = "/meta-cache.bin";
+  long scan_count = 0;
+  long scan_pos = 0;
+  int max_bytes = 16 * 1024;
+
+  /// the ID3 parser reports via a plain function pointer: the actual
+  /// record is provided via this singleton (the scan is single threaded)
+  static MetaDataRecord *&actualRecord() {
+    static MetaDataRecord *record = nullptr;
+    return record;
+  }
+
+  static void copyStr(char *target, const char *str, int len, int maxLen) {
+    int n = min(len, maxLen - 1);
+    strncpy(target, str, n);
+    target[n] = 0;
+  }
+
+  static void collectMetaData(MetaDataType type, const char *str, int len) {
+    MetaDataRecord *rec = actualRecord();
+    if (rec == nullptr) return;
+    switch (type) {
+      case Title:
+        copyStr(rec->title, str, len, sizeof(rec->title));
+        break;
+      case Artist:
+        copyStr(rec->artist, str, len, sizeof(rec->artist));
+        break;
+      case Album:
+        copyStr(rec->album, str, len, sizeof(rec->album));
+        break;
+      case Genre:
+        copyStr(rec->genre, str, len, sizeof(rec->genre));
+        break;
+      default:
+        break;
+    }
+  }
+
+  /// Feeds at most max_bytes from the file start into the ID3 parser
+  void scanTitle(long idx, MetaDataRecord &rec) {
+    Stream *stream = p_source->selectStream((int)idx);
+    if (stream == nullptr) return;
+    actualRecord() = &rec;
+    MetaDataID3V2 id3;
+    id3.setCallback(collectMetaData);
+    id3.begin();
+    uint8_t buffer[256];
+    int total = 0;
+    while (total < max_bytes) {
+      int read = stream->readBytes(buffer, sizeof(buffer));
+      if (read <= 0) break;
+      id3.write(buffer, read);
+      total += read;
+    }
+    id3.end();
+    actualRecord() = nullptr;
+  }
+
+  void seek(FileT &f, uint32_t pos) {
+#ifdef USE_SDFAT
+    f.seekSet(pos);
+#else
+    f.seek(pos);
+#endif
+  }
+};
+
+}  // namespace audio_tools
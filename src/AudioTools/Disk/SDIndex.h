@@ -2,6 +2,7 @@
 
 #include "AudioTools/CoreAudio/AudioBasic/Str.h"
 #include "AudioTools/CoreAudio/AudioBasic/Collections/List.h"
+#include "AudioTools/CoreAudio/AudioBasic/Collections/Vector.h"
 
 #define MAX_FILE_LEN 256
 
@@ -28,6 +29,7 @@ class SDIndex {
     this->file_name_pattern = file_name_pattern;
     idx_path = filePathString(startDir, "idx.txt");
     idx_defpath = filePathString(startDir, "idx-def.txt");
+    idx_dirpath = filePathString(startDir, "idx-dir.txt");
     int idx_file_size = indexFileTSize();
     LOGI("Index file size: %d", idx_file_size);
     String keyNew =
@@ -36,14 +38,25 @@ class SDIndex {
     if (setupIndex && (keyNew != keyOld || idx_file_size == 0)) {
       FileT idxfile = p_sd->open(idx_path.c_str(), FILE_WRITE);
       LOGW("Creating index file");
+      dir_signatures.clear();
       listDir(idxfile, startDir);
       LOGI("Indexing completed");
       idxfile.close();
       // update index definition file
       saveIndexDef(keyNew);
+      saveDirSignatures();
+      invalidateOffsets();
+    } else if (setupIndex && is_incremental_check) {
+      // the index is valid: rescan only the changed directories
+      updateChangedDirs();
     }
   }
 
+  /// Activates the incremental revalidation: on each begin() the per
+  /// directory signatures (entry count and file sizes) are compared with
+  /// the persisted ones and only changed directories are rescanned
+  void setIncrementalCheck(bool active) { is_incremental_check = active; }
+
   void ls(Print &p, const char *startDir, const char *extension,
           const char *file_name_pattern = "*") {
     TRACED();
@@ -54,76 +67,74 @@ class SDIndex {
     file_path_str.clear();
   }
 
-  /// Access file name by index
+  /// Access file name by index: a positional open using the line offset
+  /// table, so the access cost is independent of the index size
   const char *operator[](int idx) {
-    // return null when inx too big
-    if (max_idx >= 0 && idx > max_idx) {
-      LOGE("idx %d > size %d", idx, max_idx);
+    // map the index through the shuffle order
+    if (is_shuffle) {
+      if (shuffle_order.size() == 0) reshuffle();
+      if (idx >= 0 && idx < (int)shuffle_order.size())
+        idx = shuffle_order[idx];
+    }
+    if (offset_table.size() == 0) buildOffsets();
+    // return null when idx too big
+    if (idx < 0 || idx >= (int)offset_table.size()) {
+      LOGE("idx %d > size %d", idx, (int)offset_table.size());
       return nullptr;
     }
-    // find record
     FileT idxfile = p_sd->open(idx_path.c_str());
-    int count = 0;
-
-    if (idxfile.available() == 0) {
-      LOGE("Index file is empty");
-    }
-
-    bool found = false;
-    while (idxfile.available() > 0 && !found) {
-      result = idxfile.readStringUntil('\n');
-
-      // result c-string
-      char *c_str = (char *)result.c_str();
-      // remove potential cr character - hax to avoid any allocations
-      int lastPos = result.length() - 1;
-      if (c_str[lastPos] == 13) {
-        c_str[lastPos] = 0;
-      }
-
-      LOGD("%d -> %s", count, c_str);
-      if (count == idx) {
-        found = true;
-      }
-      count++;
-    }
-    if (!found) {
-      max_idx = count;
-    }
+    seek(idxfile, offset_table[idx]);
+    result = readLine(idxfile);
     idxfile.close();
-
-    return found ? result.c_str() : nullptr;
+    LOGD("%d -> %s", idx, result.c_str());
+    return result.c_str();
   }
 
   long size() {
-    if (max_idx == -1) {
-      FileT idxfile = p_sd->open(idx_path.c_str());
-      int count = 0;
-
-      while (idxfile.available() > 0) {
-        result = idxfile.readStringUntil('\n');
-        // result c-string
-        char *c_str = (char *)result.c_str();
-        count++;
-      }
-      idxfile.close();
-      max_idx = count;
+    if (offset_table.size() == 0) buildOffsets();
+    return offset_table.size();
+  }
+
+  /// Activates the shuffle mode: the index access is mapped through a
+  /// random permutation, so "next title" provides a random track with a
+  /// single positional open
+  void setShuffle(bool active) {
+    is_shuffle = active;
+    if (active && shuffle_order.size() != (size_t)size()) reshuffle();
+  }
+
+  bool isShuffle() { return is_shuffle; }
+
+  /// Draws a new random play order (Fisher-Yates)
+  void reshuffle() {
+    long n = size();
+    shuffle_order.resize(n);
+    for (long j = 0; j < n; j++) shuffle_order[j] = j;
+    for (long j = n - 1; j > 0; j--) {
+      long k = rand() % (j + 1);
+      int tmp = shuffle_order[j];
+      shuffle_order[j] = shuffle_order[k];
+      shuffle_order[k] = tmp;
     }
-    return max_idx;
   }
 
  protected:
   String result;
   String idx_path;
   String idx_defpath;
+  String idx_dirpath;
   SDT *p_sd = nullptr;
   List<String> file_path_stack;
   String file_path_str;
   const char *start_dir;
+  Vector<String> dir_signatures;
+  bool is_incremental_check = false;
+  Vector<uint32_t> offset_table;
+  Vector<int> shuffle_order;
+  bool is_shuffle = false;
 
   const char *ext = nullptr;
   const char *file_name_pattern = nullptr;
-  long max_idx = -1;
 
   String filePathString(const char *name, const char *suffix) {
     String result = name;
@@ -151,14 +162,18 @@ class SDIndex {
     }
 
     rewind(root);
+    long sig_count = 0;
+    unsigned long sig_bytes = 0;
     FileT file = openNext(root);
     while (file) {
+      sig_count++;
       if (isDirectory(file)) {
         String name = String(fileNamePath(file));
         LOGD("name: %s", name.c_str());
         pushPath(fileName(file));
         listDir(idxfile, name.c_str());
       } else {
+        sig_bytes += fileSize(file);
         const char *fn = fileNamePath(file);
         if (isValidAudioFile(file)) {
           LOGD("Adding file to index: %s", fn);
@@ -169,6 +184,8 @@ class SDIndex {
       }
       file = openNext(root);
     }
+    String sig = signatureLine(dirname, sig_count, sig_bytes);
+    dir_signatures.push_back(sig);
     popPath();
   }
 
@@ -244,6 +261,212 @@ class SDIndex {
     return result;
   }
 
+  /// Scans the index file once and records the byte offset of each line,
+  /// so that any entry can be opened with a single seek
+  void buildOffsets() {
+    TRACED();
+    offset_table.clear();
+    FileT idxfile = p_sd->open(idx_path.c_str());
+    uint32_t pos = 0;
+    while (idxfile.available() > 0) {
+      String line = idxfile.readStringUntil('\n');
+      if (line.length() > 0 && line.c_str()[0] != '\r')
+        offset_table.push_back(pos);
+      pos += line.length() + 1;
+    }
+    idxfile.close();
+    LOGI("Index entries: %d", (int)offset_table.size());
+  }
+
+  /// The index file was rewritten: the offsets and the shuffle order
+  /// are stale
+  void invalidateOffsets() {
+    offset_table.clear();
+    shuffle_order.clear();
+  }
+
+  void seek(FileT &f, uint32_t pos) {
+#ifdef USE_SDFAT
+    f.seekSet(pos);
+#else
+    f.seek(pos);
+#endif
+  }
+
+  /// Reads one line w/o the line end
+  String readLine(FileT &file) {
+    String line = file.readStringUntil('\n');
+    if (line.endsWith("\r")) line.remove(line.length() - 1);
+    return line;
+  }
+
+  /// Signature of a directory: entry count and accumulated file sizes
+  String signatureLine(const char *dir, long count, unsigned long bytes) {
+    return normalizeDir(dir) + "|" + String(count) + "|" + String(bytes);
+  }
+
+  /// Removes a trailing / so that the directory strings are comparable
+  String normalizeDir(const char *dir) {
+    String result(dir);
+    if (result.length() > 1 && result.endsWith("/"))
+      result.remove(result.length() - 1);
+    return result;
+  }
+
+  /// Provides the directory part of an indexed file path
+  String directoryOf(String &line) {
+    int pos = line.lastIndexOf('/');
+    if (pos <= 0) return String("/");
+    return line.substring(0, pos);
+  }
+
+  String dirFromSignature(String &sig) {
+    return sig.substring(0, sig.indexOf('|'));
+  }
+
+  bool containsStr(Vector<String> &v, String &str) {
+    for (int j = 0; j < (int)v.size(); j++)
+      if (v[j] == str) return true;
+    return false;
+  }
+
+  void saveDirSignatures() {
+    FileT f = p_sd->open(idx_dirpath.c_str(), FILE_WRITE);
+    for (int j = 0; j < (int)dir_signatures.size(); j++)
+      f.println(dir_signatures[j].c_str());
+    f.close();
+  }
+
+  void loadDirSignatures(Vector<String> &out) {
+    FileT f = p_sd->open(idx_dirpath.c_str());
+    while (f.available() > 0) {
+      String line = readLine(f);
+      if (line.length() > 0) out.push_back(line);
+    }
+    f.close();
+  }
+
+  /// Walks the directory tree computing only the signatures: much faster
+  /// than a full rebuild since no pattern matching and no writes happen
+  void collectDirSignatures(const char *dirname, Vector<String> &out) {
+    FileT root = open(dirname);
+    if (!root || !isDirectory(root) || StrView(dirname).startsWith(".")) {
+      popPath();
+      return;
+    }
+    rewind(root);
+    long count = 0;
+    unsigned long bytes = 0;
+    FileT file = openNext(root);
+    while (file) {
+      count++;
+      if (isDirectory(file)) {
+        String name = String(fileNamePath(file));
+        pushPath(fileName(file));
+        collectDirSignatures(name.c_str(), out);
+      } else {
+        bytes += fileSize(file);
+      }
+      file = openNext(root);
+    }
+    String sig = signatureLine(dirname, count, bytes);
+    out.push_back(sig);
+    popPath();
+  }
+
+  /// Compares the actual directory signatures with the persisted ones and
+  /// rescans only the directories which have changed
+  void updateChangedDirs() {
+    TRACED();
+    Vector<String> stored;
+    loadDirSignatures(stored);
+    Vector<String> current;
+    file_path_stack.clear();
+    collectDirSignatures(start_dir, current);
+    // directories with a new or changed signature need a rescan
+    Vector<String> changed;
+    for (int j = 0; j < (int)current.size(); j++) {
+      if (!containsStr(stored, current[j])) {
+        String dir = dirFromSignature(current[j]);
+        changed.push_back(dir);
+      }
+    }
+    // directories which do not exist any more: their lines are dropped
+    Vector<String> removed;
+    for (int j = 0; j < (int)stored.size(); j++) {
+      String dir = dirFromSignature(stored[j]);
+      bool found = false;
+      for (int i = 0; i < (int)current.size(); i++) {
+        if (dirFromSignature(current[i]) == dir) {
+          found = true;
+          break;
+        }
+      }
+      if (!found) removed.push_back(dir);
+    }
+    if (changed.size() == 0 && removed.size() == 0) {
+      LOGI("Index is up to date");
+      return;
+    }
+    LOGW("Rescanning %d changed directories",
+         (int)(changed.size() + removed.size()));
+    rebuildIndexFor(changed, removed);
+    dir_signatures = current;
+    saveDirSignatures();
+    invalidateOffsets();
+  }
+
+  /// Rewrites the index: the lines of unchanged directories are copied,
+  /// the changed directories are scanned again
+  void rebuildIndexFor(Vector<String> &changed, Vector<String> &removed) {
+    String tmp_path = filePathString(start_dir, "idx-new.txt");
+    FileT out = p_sd->open(tmp_path.c_str(), FILE_WRITE);
+    FileT in = p_sd->open(idx_path.c_str());
+    while (in.available() > 0) {
+      String line = readLine(in);
+      if (line.length() == 0) continue;
+      String dir = directoryOf(line);
+      if (!containsStr(changed, dir) && !containsStr(removed, dir))
+        out.println(line.c_str());
+    }
+    in.close();
+    // append fresh scans of the changed directories: files only, the
+    // subdirectories are covered by their own signatures
+    for (int j = 0; j < (int)changed.size(); j++)
+      appendDirFiles(out, changed[j].c_str());
+    out.close();
+    p_sd->remove(idx_path.c_str());
+    p_sd->rename(tmp_path.c_str(), idx_path.c_str());
+  }
+
+  /// Adds the matching files of a single directory (non recursive)
+  void appendDirFiles(Print &out, const char *dirname) {
+    FileT dir = open(dirname);
+    if (!dir || !isDirectory(dir)) return;
+    rewind(dir);
+    FileT file = openNext(dir);
+    while (file) {
+      if (!isDirectory(file)) {
+        String name = String(fileName(file));
+        String fn = filePathString(dirname, name.c_str());
+        StrView strName(name.c_str());
+        bool valid = strName.endsWithIgnoreCase(ext) &&
+                     strName.matches(file_name_pattern) &&
+                     !StrView(fn.c_str()).contains("/.");
+        if (valid) out.println(fn.c_str());
+      }
+      file = openNext(dir);
+    }
+  }
+
+  uint32_t fileSize(FileT &f) {
+#ifdef USE_SDFAT
+    return f.fileSize();
+#else
+    return f.size();
+#endif
+  }
+
   void rewind(FileT &f) {
     TRACED();
 #ifdef USE_SDFAT
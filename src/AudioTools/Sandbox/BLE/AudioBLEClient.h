@@ -46,13 +46,27 @@ public:
       return 0;
     }
 
+    // notification mode: consume the receive ring and grant new credits
+    if (is_notifications_active) {
+      BLE.poll();
+      size_t result = receive_buffer.readArray(data, len);
+      grantCredits();
+      return result;
+    }
+
     if (!ch01_char.canRead())
       return 0;
 
     return ch01_char.readValue(data, len);
   }
 
-  int available() override { return BLE_MTU - BLE_MTU_OVERHEAD; }
+  int available() override {
+    if (is_notifications_active) {
+      BLE.poll();
+      return receive_buffer.available();
+    }
+    return BLE_MTU - BLE_MTU_OVERHEAD;
+  }
 
   size_t write(const uint8_t *data, size_t len) override {
     TRACED();
@@ -91,14 +105,22 @@ public:
 
   void setConfirmWrite(bool flag) { write_confirmation_flag = flag; }
 
+  /// Defines the credit window: the number of notifications the server may
+  /// send ahead of our reads (default 8)
+  void setCreditWindow(int count) { credit_window = count; }
+
 protected:
   BLEDevice peripheral;
   BLECharacteristic ch01_char;
   BLECharacteristic ch02_char;
   BLECharacteristic info_char;
+  BLECharacteristic credits_char;
   SingleBuffer<uint8_t> write_buffer{0};
+  RingBuffer<uint8_t> receive_buffer{0};
   int write_throttle = 0;
   bool write_confirmation_flag = false;
+  int credit_window = 8;
+  volatile int notifications_to_ack = 0;
 
   void writeAudioInfoCharacteristic(AudioInfo info) override {
     TRACEI();
@@ -131,6 +153,41 @@ protected:
                                      characteristic.valueLength());
   }
 
+  static void onAudioUpdated(BLEDevice central,
+                             BLECharacteristic characteristic) {
+    selfAudioBLEClient->receiveAudio(characteristic.value(),
+                                     characteristic.valueLength());
+  }
+
+  /// stores one notified audio frame in the receive ring
+  void receiveAudio(const uint8_t *data, size_t size) {
+    int written = receive_buffer.writeArray(data, size);
+    if (written < (int)size) {
+      // the credits should prevent this
+      LOGW("receive ring overflow: %d bytes lost", (int)size - written);
+    }
+    notifications_to_ack++;
+  }
+
+  /// Grants new notification credits to the server: the grants are batched
+  /// (half a window) and limited to the free space in the receive ring, so
+  /// the server can never overrun us
+  void grantCredits() {
+    if (!credits_char) return;
+    int frame_size = getMTU();
+    int max_grant = receive_buffer.availableForWrite() / frame_size;
+    int grant = std::min((int)notifications_to_ack, max_grant);
+    if (grant < std::max(1, credit_window / 2)) return;
+    writeCredits(grant);
+    notifications_to_ack -= grant;
+  }
+
+  void writeCredits(int count) {
+    uint8_t tmp[2] = {(uint8_t)(count & 0xFF), (uint8_t)(count >> 8)};
+    credits_char.writeValue(tmp, 2, false);
+    LOGD("credits: +%d", count);
+  }
+
   bool setupBLEClient() {
     // if we are already connected there is nothing to do
     if (peripheral.connected()) {
@@ -180,8 +237,31 @@ protected:
       info_char.setEventHandler(BLEUpdated, onInfoUpdated);
     }
 
+    // notification mode: the server pushes the audio, we grant credits
+    if (is_notifications_active) {
+      if (receive_buffer.size() == 0) {
+        receive_buffer.resize(RX_BUFFER_SIZE);
+      }
+      ch01_char.setEventHandler(BLEUpdated, onAudioUpdated);
+      if (!ch01_char.subscribe()) {
+        LOGE("subscribe failed");
+        peripheral.disconnect();
+        return false;
+      }
+      credits_char = peripheral.characteristic(BLE_CREDITS_UUID);
+      if (!credits_char) {
+        LOGE("Failed to find char. UUID: %s", BLE_CREDITS_UUID);
+        peripheral.disconnect();
+        return false;
+      }
+      // initial credit window
+      writeCredits(credit_window);
+    }
+
     return true;
   }
+
+  int getMTU() override { return BLE_MTU - BLE_MTU_OVERHEAD; }
 };
 
 } // namespace audio_tools
\ No newline at end of file
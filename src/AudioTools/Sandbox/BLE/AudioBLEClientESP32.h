@@ -55,6 +55,12 @@ public:
     setupBLEClient();
     if (!is_client_connected || !is_client_set_up)
       return 0;
+    // notification mode: consume the receive ring and grant new credits
+    if (is_notifications_active) {
+      size_t result = receive_buffer.readArray(data, len);
+      grantCredits();
+      return result;
+    }
     if (!ch01_char->canRead())
       return 0;
     // changed to auto to be version independent (it changed from std::string to
@@ -66,7 +72,10 @@ public:
     return str.length();
   }
 
-  int available() override { return BLE_MTU - BLE_MTU_OVERHEAD; }
+  int available() override {
+    if (is_notifications_active) return receive_buffer.available();
+    return BLE_MTU - BLE_MTU_OVERHEAD;
+  }
 
   size_t write(const uint8_t *data, size_t len) override {
     TRACED();
@@ -112,6 +121,10 @@ public:
     write_confirmation_flag = flag;
   }
 
+  /// Defines the credit window: the number of notifications the server may
+  /// send ahead of our reads (default 8)
+  void setCreditWindow(int count) { credit_window = count; }
+
 protected:
   // client
   BLEClient *p_client = nullptr;
@@ -121,14 +134,18 @@ protected:
   BLERemoteCharacteristic *ch01_char = nullptr; // read
   BLERemoteCharacteristic *ch02_char = nullptr; // write
   BLERemoteCharacteristic *info_char = nullptr;
+  BLERemoteCharacteristic *credits_char = nullptr;
   BLEAdvertisedDevice advertised_device;
   BLEUUID BLUEID_AUDIO_SERVICE_UUID{BLE_AUDIO_SERVICE_UUID};
   BLEUUID BLUEID_CH1_UUID{BLE_CH1_UUID};
   BLEUUID BLUEID_CH2_UUID{BLE_CH2_UUID};
   BLEUUID BLUEID_INFO_UUID{BLE_INFO_UUID};
   SingleBuffer<uint8_t> write_buffer{0};
+  RingBuffer<uint8_t> receive_buffer{0};
   int write_throttle = 0;
   bool write_confirmation_flag = false;
+  int credit_window = 8;
+  volatile int notifications_to_ack = 0;
 
   volatile bool is_client_connected = false;
   bool is_client_set_up = false;
@@ -156,6 +173,25 @@ protected:
     }
   }
 
+  /// Grants new notification credits to the server: the grants are batched
+  /// (half a window) and limited to the free space in the receive ring, so
+  /// the server can never overrun us
+  void grantCredits() {
+    if (credits_char == nullptr) return;
+    int frame_size = getMTU() - BLE_MTU_OVERHEAD;
+    int max_grant = receive_buffer.availableForWrite() / frame_size;
+    int grant = std::min((int)notifications_to_ack, max_grant);
+    if (grant < std::max(1, credit_window / 2)) return;
+    writeCredits(grant);
+    notifications_to_ack -= grant;
+  }
+
+  void writeCredits(int count) {
+    uint8_t tmp[2] = {(uint8_t)(count & 0xFF), (uint8_t)(count >> 8)};
+    credits_char->writeValue(tmp, 2, false);
+    LOGD("credits: +%d", count);
+  }
+
   bool readAudioInfoCharacteristic(){
     if (!info_char->canRead())
       return false;
@@ -184,13 +220,25 @@ protected:
 
   static void notifyCallback(BLERemoteCharacteristic *pBLERemoteCharacteristic,
                              uint8_t *pData, size_t length, bool isNotify) {
-    TRACEI();
-    if (pBLERemoteCharacteristic->getUUID().toString() ==
-        selfAudioBLEClient->BLE_INFO_UUID) {
+    TRACED();
+    auto uuid = pBLERemoteCharacteristic->getUUID().toString();
+    if (uuid == selfAudioBLEClient->BLE_INFO_UUID) {
       selfAudioBLEClient->setAudioInfo(pData, length);
+    } else if (uuid == selfAudioBLEClient->BLE_CH1_UUID) {
+      selfAudioBLEClient->receiveAudio(pData, length);
     }
   }
 
+  /// stores one notified audio frame in the receive ring
+  void receiveAudio(const uint8_t *data, size_t size) {
+    int written = receive_buffer.writeArray(data, size);
+    if (written < (int)size) {
+      // the credits should prevent this
+      LOGW("receive ring overflow: %d bytes lost", (int)size - written);
+    }
+    notifications_to_ack++;
+  }
+
   bool setupBLEClient() {
     if (is_client_set_up)
       return true;
@@ -242,6 +290,24 @@ protected:
       }
     }
 
+    // notification mode: the server pushes the audio, we grant credits
+    if (is_notifications_active) {
+      if (receive_buffer.size() == 0) {
+        receive_buffer.resize(RX_BUFFER_SIZE);
+      }
+      ch01_char->registerForNotify(notifyCallback);
+      if (credits_char == nullptr) {
+        credits_char =
+            p_remote_service->getCharacteristic(BLEUUID(BLE_CREDITS_UUID));
+        if (credits_char == nullptr) {
+          LOGE("Failed to find char. UUID: %s", BLE_CREDITS_UUID);
+          return false;
+        }
+      }
+      // initial credit window
+      writeCredits(credit_window);
+    }
+
     if (ch02_char == nullptr) {
       ch02_char = p_remote_service->getCharacteristic(BLUEID_CH2_UUID);
       if (ch02_char == nullptr) {
@@ -83,9 +83,45 @@ public:
     if (is_framed && availableForWrite() < len) {
       return 0;
     }
-    return transmit_buffer.writeArray(data, len);
+    size_t result = transmit_buffer.writeArray(data, len);
+    if (is_notifications_active) {
+      writeNotifications();
+    }
+    return result;
+  }
+
+  /// Pushes the buffered audio as notifications: one MTU sized frame per
+  /// notification, up to notifications_in_flight frames back to back and
+  /// only as long as the central has granted credits. Returns the number of
+  /// sent notifications. Called from write() - an additional call from the
+  /// sketch loop drains the buffer when no new data arrives.
+  int writeNotifications() {
+    if (!is_notifications_active) return 0;
+    int frame_size = getMTU();
+    int count = 0;
+    while (count < notifications_in_flight && transmit_credits > 0) {
+      int len = std::min(frame_size, (int)transmit_buffer.available());
+      if (is_framed) {
+        if (transmit_buffer_sizes.available() == 0) break;
+        len = transmit_buffer_sizes.read();
+      }
+      if (len <= 0) break;
+      uint8_t tmp[len];
+      transmit_buffer.readArray(tmp, len);
+      // writeValue on a notify characteristic informs the subscribers
+      if (!ch01_char.writeValue(tmp, len)) {
+        LOGW("writeValue failed");
+        break;
+      }
+      transmit_credits--;
+      count++;
+    }
+    return count;
   }
 
+  /// Credits (= notifications we may still send) granted by the central
+  int transmitCredits() { return transmit_credits; }
+
   int availableForWrite() override {
     if (!checkCentralConnected())
       return 0;
@@ -103,13 +139,16 @@ protected:
   // server
   BLEDevice central;
   BLEService service{BLE_AUDIO_SERVICE_UUID}; // create service
-  BLECharacteristic ch01_char{BLE_CH1_UUID, BLERead, getMTU()};
+  BLECharacteristic ch01_char{BLE_CH1_UUID, BLERead | BLENotify, getMTU()};
   BLECharacteristic ch02_char{BLE_CH2_UUID, BLEWrite, getMTU()};
   BLECharacteristic info_char{BLE_INFO_UUID, BLERead | BLEWrite | BLENotify,
                               80};
+  BLECharacteristic credits_char{BLE_CREDITS_UUID, BLEWrite, 4};
   BLEDescriptor ch01_desc{"2901", "channel 1"};
   BLEDescriptor ch02_desc{"2901", "channel 2"};
   BLEDescriptor info_desc{"2901", "info"};
+  BLEDescriptor credits_desc{"2901", "credits"};
+  volatile int transmit_credits = 0;
 
   RingBuffer<uint8_t> receive_buffer{0};
   RingBuffer<uint16_t> receive_sizes{0};
@@ -133,10 +172,14 @@ protected:
     selfAudioBLEServer->onRead(characteristic);
   }
 
-  void onConnect(BLEDevice device) { TRACEI(); }
+  void onConnect(BLEDevice device) {
+    TRACEI();
+    transmit_credits = 0;
+  }
 
   void onDisconnect(BLEDevice device) {
     TRACEI();
+    transmit_credits = 0;
     BLE.advertise();
   }
 
@@ -149,12 +192,24 @@ protected:
     if (StrView(BLE_INFO_UUID).equals(characteristic.uuid())) {
       setAudioInfo((uint8_t *)characteristic.value(),
                    characteristic.valueLength());
+    } else if (StrView(BLE_CREDITS_UUID).equals(characteristic.uuid())) {
+      receiveCredits((uint8_t *)characteristic.value(),
+                     characteristic.valueLength());
     } else {
       receiveAudio((uint8_t *)characteristic.value(),
                    characteristic.valueLength());
     }
   }
 
+  /// the central grants more notification credits
+  void receiveCredits(const uint8_t *data, size_t size) {
+    if (size >= 2) {
+      int granted = ((int)data[1] << 8) | data[0];
+      transmit_credits += granted;
+      LOGD("credits: +%d -> %d", granted, transmit_credits);
+    }
+  }
+
   /// provide the next batch of audio data
   void onRead(BLECharacteristic characteristic) {
     TRACED();
@@ -241,6 +296,14 @@ protected:
       service.addCharacteristic(info_char);
     }
 
+    // flow control: the central grants notification credits by writing a
+    // uint16 count to this characteristic
+    if (is_notifications_active) {
+      credits_char.addDescriptor(credits_desc);
+      service.addCharacteristic(credits_char);
+      credits_char.setEventHandler(BLEWritten, bleOnWrite);
+    }
+
     // add service
     BLE.addService(service);
 
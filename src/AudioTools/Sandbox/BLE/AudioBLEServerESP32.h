@@ -65,9 +65,42 @@ public:
     if (is_framed && availableForWrite() < dataSize) {
       return 0;
     }
-    return transmit_buffer.writeArray(data, dataSize);
+    size_t result = transmit_buffer.writeArray(data, dataSize);
+    if (is_notifications_active) {
+      writeNotifications();
+    }
+    return result;
+  }
+
+  /// Pushes the buffered audio as notifications: one MTU sized frame per
+  /// notification, up to notifications_in_flight frames back to back and
+  /// only as long as the client has granted credits. Returns the number of
+  /// sent notifications. Called from write() - an additional call from the
+  /// sketch loop drains the buffer when no new data arrives.
+  int writeNotifications() {
+    if (!is_notifications_active || ch01_char == nullptr) return 0;
+    int frame_size = getMTU() - BLE_MTU_OVERHEAD;
+    int count = 0;
+    while (count < notifications_in_flight && transmit_credits > 0) {
+      int len = std::min(frame_size, (int)transmit_buffer.available());
+      if (is_framed) {
+        if (transmit_buffer_sizes.available() == 0) break;
+        len = transmit_buffer_sizes.read();
+      }
+      if (len <= 0) break;
+      uint8_t tmp[len];
+      transmit_buffer.readArray(tmp, len);
+      ch01_char->setValue(tmp, len);
+      ch01_char->notify();
+      transmit_credits--;
+      count++;
+    }
+    return count;
   }
 
+  /// Credits (= notifications we may still send) granted by the client
+  int transmitCredits() { return transmit_credits; }
+
   int availableForWrite() override {
     int result =  transmit_buffer.availableForWrite();
     // make sure we copy always a consistent amount of data
@@ -85,9 +118,12 @@ protected:
   BLECharacteristic *ch01_char;
   BLECharacteristic *ch02_char;
   BLECharacteristic *info_char;
+  BLECharacteristic *credits_char = nullptr;
   BLEDescriptor ch01_desc{"2901"};
   BLEDescriptor ch02_desc{"2901"};
   BLEDescriptor info_desc{"2901"};
+  BLEDescriptor credits_desc{"2901"};
+  volatile int transmit_credits = 0;
   RingBuffer<uint8_t> receive_buffer{0};
   RingBuffer<uint16_t> receive_sizes{0};
   RingBuffer<uint8_t> transmit_buffer{0};
@@ -115,9 +151,11 @@ protected:
   int getMTU() override {
     TRACED();
     if (max_transfer_size == 0) {
+      // use the negotiated MTU of the peer, but never more than our own
       int peer_max_transfer_size =
           p_server->getPeerMTU(p_server->getConnId()) - BLE_MTU_OVERHEAD;
-      max_transfer_size = std::min(BLE_MTU - BLE_MTU, peer_max_transfer_size);
+      max_transfer_size =
+          std::min(BLE_MTU - BLE_MTU_OVERHEAD, peer_max_transfer_size);
 
       LOGI("max_transfer_size: %d", max_transfer_size);
     }
@@ -131,8 +169,11 @@ protected:
     if (p_service == nullptr) {
       p_service = p_server->createService(BLE_AUDIO_SERVICE_UUID);
 
-      ch01_char = p_service->createCharacteristic(
-          BLE_CH1_UUID, BLECharacteristic::PROPERTY_READ );
+      uint32_t ch01_properties = BLECharacteristic::PROPERTY_READ;
+      if (is_notifications_active) {
+        ch01_properties |= BLECharacteristic::PROPERTY_NOTIFY;
+      }
+      ch01_char = p_service->createCharacteristic(BLE_CH1_UUID, ch01_properties);
       ch01_desc.setValue("Channel 1");
       ch01_char->addDescriptor(&ch01_desc);
       ch01_char->setCallbacks(this);
@@ -143,6 +184,16 @@ protected:
       ch02_char->addDescriptor(&ch02_desc);
       ch02_char->setCallbacks(this);
 
+      // flow control: the client grants notification credits by writing a
+      // uint16 count to this characteristic
+      if (is_notifications_active) {
+        credits_char = p_service->createCharacteristic(
+            BLE_CREDITS_UUID, BLECharacteristic::PROPERTY_WRITE);
+        credits_desc.setValue("Credits");
+        credits_char->addDescriptor(&credits_desc);
+        credits_char->setCallbacks(this);
+      }
+
       // optional setup of audio info notifications
       if (is_audio_info_active && info_char == nullptr) {
 
@@ -169,10 +220,14 @@ protected:
 
   void onConnect(BLEServer *pServer) override {
     TRACEI();
+    // renegotiate the transfer size for the new connection
+    max_transfer_size = 0;
+    transmit_credits = 0;
   }
 
   void onDisconnect(BLEServer *pServer) override {
     TRACEI();
+    transmit_credits = 0;
     BLEDevice::startAdvertising();
   }
 
@@ -182,13 +237,25 @@ protected:
     setupRXBuffer();
     // changed to auto to be version independent (it changed from std::string to String)
     auto value = pCharacteristic->getValue();
-    if (pCharacteristic->getUUID().toString() == BLE_INFO_UUID) {
+    auto uuid = pCharacteristic->getUUID().toString();
+    if (uuid == BLE_INFO_UUID) {
       setAudioInfo((uint8_t *)&value[0], value.length());
+    } else if (uuid == BLE_CREDITS_UUID) {
+      receiveCredits((uint8_t *)&value[0], value.length());
     } else {
       receiveAudio((uint8_t *)&value[0], value.length());
     }
   }
 
+  /// the client grants more notification credits
+  void receiveCredits(const uint8_t *data, size_t size) {
+    if (size >= 2) {
+      int granted = ((int)data[1] << 8) | data[0];
+      transmit_credits += granted;
+      LOGD("credits: +%d -> %d", granted, transmit_credits);
+    }
+  }
+
   /// provide the next batch of audio data
   void onRead(BLECharacteristic *pCharacteristic) override {
     TRACED();
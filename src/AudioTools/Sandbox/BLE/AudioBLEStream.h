@@ -42,10 +42,20 @@ public:
 
   void setAudioInfoUUID(const char *uuid) { BLE_INFO_UUID = uuid; }
 
+  void setCreditsUUID(const char *uuid) { BLE_CREDITS_UUID = uuid; }
+
   void setAudioInfoActive(bool flag) { is_audio_info_active = flag; }
 
   void setFramed(bool flag) { is_framed = flag; }
 
+  /// Activates the notification based transmission with credit based flow
+  /// control: the server pushes MTU sized frames instead of waiting for reads
+  void setNotificationsActive(bool flag) { is_notifications_active = flag; }
+
+  /// Defines how many notifications may be queued back to back before we
+  /// yield to the BLE stack (multiple notifications per connection event)
+  void setNotificationsInFlight(int count) { notifications_in_flight = count; }
+
   StrView toStr(AudioInfo info) {
     snprintf(audio_info_str, 40, "%d:%d:%d", info.sample_rate, info.channels,
             info.bits_per_sample);
@@ -68,6 +78,8 @@ protected:
   bool is_started = false;
   bool is_audio_info_active = false;
   bool is_framed = false;
+  bool is_notifications_active = false;
+  int notifications_in_flight = 4;
   char audio_info_str[40];
 
   // Bluetooth LE GATT UUIDs for the Nordic UART profile Change UUID here if
@@ -76,6 +88,7 @@ protected:
   const char *BLE_CH1_UUID = "6e400002-b5a3-f393-e0a9-e50e24dcca9e"; // RX
   const char *BLE_CH2_UUID = "6e400003-b5a3-f393-e0a9-e50e24dcca9e"; // TX
   const char *BLE_INFO_UUID = "6e400004-b5a3-f393-e0a9-e50e24dcca9e";
+  const char *BLE_CREDITS_UUID = "6e400005-b5a3-f393-e0a9-e50e24dcca9e";
 
   virtual int getMTU() = 0;
 
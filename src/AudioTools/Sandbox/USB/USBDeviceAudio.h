@@ -147,6 +147,11 @@ class USBDeviceAudio : public USBAudioCB {
     _api.begin(this, cfg);
     _mute.resize(cfg.channels + 1);
     _volume.resize(cfg.channels + 1);
+    _in_fill = _in_drain = 0;
+    _out_fill = _out_send = 0;
+    _consumed_frames = 0;
+    _feedback_time_us = 0;
+    _feedback_value = 0;
 
     // check data
     if (!isMicrophone() && !isSpeaker()) {
@@ -171,8 +176,12 @@ class USBDeviceAudio : public USBAudioCB {
   void end() {
     tud_deinit(cfg.rh_port);
     setStatus(AudioProcessingStatus::INACTIVE);
-    if (_out_buffer.size() > 0) _out_buffer.resize(0);
-    if (_in_buffer.size() > 0) _out_buffer.resize(0);
+    for (auto &buffer : _out_buffers) {
+      if (buffer.size() > 0) buffer.resize(0);
+    }
+    for (auto &buffer : _in_buffers) {
+      if (buffer.size() > 0) buffer.resize(0);
+    }
   }
 
   // If is mounted
@@ -245,7 +254,8 @@ class USBDeviceAudio : public USBAudioCB {
   // from USBD_Interface
 
   virtual uint16_t getMaxEPSize() {
-    return TUD_AUDIO_EP_SIZE(cfg.sample_rate, cfg.bits_per_sample / 8,
+    // the endpoint must fit the highest alternate rate
+    return TUD_AUDIO_EP_SIZE(cfg.maxSampleRate(), cfg.bits_per_sample / 8,
                              cfg.channels);
   }
 
@@ -460,20 +470,20 @@ class USBDeviceAudio : public USBAudioCB {
     // fill buffer from "microphone" input
     if (isMicrophone()) {
       debugWrite(1, HIGH);
-      // manage buffer size
       uint16_t len = getIOSize() - 2;  // CFG_TUD_AUDIO_EP_SZ_IN - 2;
-      if (_out_buffer.size() < len) _out_buffer.resize(len);
-
-      // return if the buffer is already filled
-      if (_out_buffer.available() != 0) {
-        return true;
+      // double buffered: fill the next packet while the last one is still
+      // being sent
+      if ((uint8_t)(_out_fill - _out_send) < 2) {
+        ByteBuffer &buffer = _out_buffers[_out_fill & 1];
+        if (buffer.size() < len) buffer.resize(len);
+        if (buffer.available() == 0) {
+          uint8_t *adr = buffer.data();
+          buffer.clear();
+          int len_eff = (*cfg.p_read_callback)(adr, len, *this);
+          buffer.setAvailable(len_eff);
+          _out_fill++;
+        }
       }
-
-      // fill the buffer with data
-      uint8_t *adr = _out_buffer.data();
-      _out_buffer.clear();
-      int len_eff = (*cfg.p_read_callback)(adr, len, *this);
-      _out_buffer.setAvailable(len_eff);
       debugWrite(1, LOW);
     }
 
@@ -491,9 +501,12 @@ class USBDeviceAudio : public USBAudioCB {
     // output audio from "microphone" buffer to usb
     if (isMicrophone()) {
       debugWrite(2, HIGH);
-      uint8_t *adr = _out_buffer.data();
-      _api.tud_audio_n_write(func_id, adr, _out_buffer.available());
-      _out_buffer.reset();
+      if (_out_send != _out_fill) {
+        ByteBuffer &buffer = _out_buffers[_out_send & 1];
+        _api.tud_audio_n_write(func_id, buffer.data(), buffer.available());
+        buffer.setAvailable(0);
+        _out_send++;
+      }
       debugWrite(2, LOW);
     }
 
@@ -503,15 +516,20 @@ class USBDeviceAudio : public USBAudioCB {
   bool rx_done_pre_read_cb(uint8_t rhport, uint16_t n_bytes_received,
                            uint8_t func_id, uint8_t ep_out,
                            uint8_t cur_alt_setting) override {
-    // read audio from usb
-    if (isSpeaker() && _in_buffer.available() == 0) {
+    // read audio from usb: double buffered, so the next packet can be
+    // received while the last one still drains into the sink
+    if (isSpeaker() && (uint8_t)(_in_fill - _in_drain) < 2) {
       debugWrite(3, HIGH);
-      uint16_t len = _api.tud_audio_n_available(func_id);
-      if (len > 0) {
-        if (_in_buffer.size() < len) _in_buffer.resize(len);
-        uint8_t *adr = _in_buffer.data();
-        int len_eff = _api.tud_audio_n_read(func_id, adr, len);
-        _in_buffer.setAvailable(len_eff);
+      ByteBuffer &buffer = _in_buffers[_in_fill & 1];
+      if (buffer.available() == 0) {
+        uint16_t len = _api.tud_audio_n_available(func_id);
+        if (len > 0) {
+          if (buffer.size() < len) buffer.resize(len);
+          uint8_t *adr = buffer.data();
+          int len_eff = _api.tud_audio_n_read(func_id, adr, len);
+          buffer.setAvailable(len_eff);
+          _in_fill++;
+        }
       }
       debugWrite(3, LOW);
       return true;
@@ -522,12 +540,18 @@ class USBDeviceAudio : public USBAudioCB {
   bool rx_done_post_read_cb(uint8_t rhport, uint16_t n_bytes_received,
                             uint8_t func_id, uint8_t ep_out,
                             uint8_t cur_alt_setting) override {
-    // read audio from usb
-    if (isSpeaker() && _in_buffer.available() > 0) {
+    // drain the filled packets into the sink
+    if (isSpeaker()) {
       debugWrite(4, HIGH);
-      uint8_t *adr = _in_buffer.data();
-      size_t rc = cfg.p_write_callback(adr, _in_buffer.available(), *this);
-      _in_buffer.consume(rc);
+      while (_in_drain != _in_fill) {
+        ByteBuffer &buffer = _in_buffers[_in_drain & 1];
+        size_t rc =
+            cfg.p_write_callback(buffer.data(), buffer.available(), *this);
+        buffer.consume(rc);
+        // the sink is full: keep the rest for the next call
+        if (buffer.available() != 0) break;
+        _in_drain++;
+      }
       debugWrite(4, LOW);
     }
     return true;
@@ -547,11 +571,49 @@ class USBDeviceAudio : public USBAudioCB {
                           audio_feedback_params_t *feedback_param) override {
     (void)func_id;
     (void)alt_itf;
-    // Set feedback method to fifo counting
-    feedback_param->method = AUDIO_FEEDBACK_METHOD_FIFO_COUNT;
+    if (cfg.enable_feedback_from_consumption) {
+      // we provide the value ourselves from the consumption counter
+      feedback_param->method = AUDIO_FEEDBACK_METHOD_DISABLED;
+    } else {
+      // Set feedback method to fifo counting
+      feedback_param->method = AUDIO_FEEDBACK_METHOD_FIFO_COUNT;
+    }
     feedback_param->sample_freq = cfg.sample_rate;
   }
 
+  /// Reports the frames really consumed by the output (e.g. from the i2s dma
+  /// callback): safe to call from an ISR
+  void recordConsumedFrames(uint32_t frames) { _consumed_frames += frames; }
+
+  /// Call regularly from the loop when enable_feedback_from_consumption is
+  /// set: derives the 16.16 feedback value from the consumption counter, so
+  /// the host follows the real dac clock instead of a free-running timer
+  bool updateFeedback() {
+    if (!cfg.enable_feedback_from_consumption) return false;
+    uint32_t now = micros();
+    if (_feedback_time_us == 0) {
+      _feedback_time_us = now;
+      _consumed_frames = 0;
+      return false;
+    }
+    uint32_t elapsed_us = now - _feedback_time_us;
+    // average over ~64 ms windows to filter the dma granularity
+    if (elapsed_us < 64000) return false;
+    uint32_t frames = _consumed_frames;
+    _consumed_frames -= frames;
+    _feedback_time_us = now;
+    // frames per (1 ms) frame interval in 16.16 format
+    uint32_t value =
+        (uint32_t)(((uint64_t)frames << 16) * 1000 / elapsed_us);
+    // smooth the estimate to avoid hunting around the target
+    if (_feedback_value == 0) {
+      _feedback_value = value;
+    } else {
+      _feedback_value += ((int32_t)(value - _feedback_value)) / 8;
+    }
+    return _api.tud_audio_n_fb_set(0, _feedback_value);
+  }
+
   /// Determine the interface descriptor length
   size_t getInterfaceDescriptorLength(uint8_t itfnum) override {
     return getInterfaceDescriptor(nullptr, 0);
@@ -586,8 +648,18 @@ class USBDeviceAudio : public USBAudioCB {
   std::vector<bool> _mute;        // +1 for master channel 0
   std::vector<uint16_t> _volume;  // +1 for master channel 0
   uint8_t _clk_is_valid = true;
-  ByteBuffer _in_buffer;
-  ByteBuffer _out_buffer;
+  // double buffered EP transfers: one packet is filled while the other is
+  // still in flight
+  ByteBuffer _in_buffers[2];
+  ByteBuffer _out_buffers[2];
+  uint8_t _in_fill = 0;
+  uint8_t _in_drain = 0;
+  uint8_t _out_fill = 0;
+  uint8_t _out_send = 0;
+  // feedback from the reported consumption
+  volatile uint32_t _consumed_frames = 0;
+  uint32_t _feedback_time_us = 0;
+  uint32_t _feedback_value = 0;
   bool _led_active = false;
   uint64_t _led_timeout = 0;
 
@@ -756,19 +828,28 @@ class USBDeviceAudio : public USBAudioCB {
             return _api.tud_audio_buffer_and_schedule_control_xfer(
                 rhport, p_request, &cfg.sample_rate, sizeof(cfg.sample_rate));
 
-          case AUDIO_CS_REQ_RANGE:
-            LOG_AUDIO_DEBUG("    Get Sample Freq. range -> %d - %d",
-                            cfg.sample_rate, cfg.sample_rate);
-            audio_control_range_4_n_t(2) sampleFreqRng;
-            sampleFreqRng.wNumSubRanges = 1;
+          case AUDIO_CS_REQ_RANGE: {
+            // report one discrete subrange per supported rate, so that the
+            // host can switch e.g. between 48 and 96 kHz
+            LOG_AUDIO_DEBUG("    Get Sample Freq. range: %d rates",
+                            cfg.sampleRateCount());
+            audio_control_range_4_n_t(5) sampleFreqRng;
+            memset(&sampleFreqRng, 0, sizeof(sampleFreqRng));
+            sampleFreqRng.wNumSubRanges = cfg.sampleRateCount();
             sampleFreqRng.subrange[0].bMin = cfg.sample_rate;
             sampleFreqRng.subrange[0].bMax = cfg.sample_rate;
             sampleFreqRng.subrange[0].bRes = 0;
-            // sampleFreqRng.subrange[1].bMin = cfg.sample_rate;
-            // sampleFreqRng.subrange[1].bMax = AUDIO_FREQ_MAX;
-            // sampleFreqRng.subrange[1].bRes = 0;
+            int idx = 1;
+            for (uint32_t rate : cfg.alt_sample_rates) {
+              if (rate == 0 || idx >= 5) continue;
+              sampleFreqRng.subrange[idx].bMin = rate;
+              sampleFreqRng.subrange[idx].bMax = rate;
+              sampleFreqRng.subrange[idx].bRes = 0;
+              idx++;
+            }
             return tud_control_xfer(rhport, p_request, &sampleFreqRng,
                                     sizeof(sampleFreqRng));
+          }
 
           // Unknown/Unsupported control
           default:
@@ -805,7 +886,12 @@ class USBDeviceAudio : public USBAudioCB {
 
     if (ctrlSel == AUDIO_CS_CTRL_SAM_FREQ) {
       TU_VERIFY(p_request->wLength == sizeof(audio_control_cur_4_t));
-      cfg.sample_rate = (uint32_t)((audio_control_cur_4_t const *)buf)->bCur;
+      uint32_t rate = (uint32_t)((audio_control_cur_4_t const *)buf)->bCur;
+      if (!cfg.isSupportedSampleRate(rate)) {
+        LOG_AUDIO_DEBUG("Clock set freq not supported: %ld", rate);
+        return false;
+      }
+      cfg.sample_rate = rate;
       LOG_AUDIO_DEBUG("Clock set current freq: %ld", cfg.sample_rate);
       return true;
     } else {
@@ -46,7 +46,13 @@ class USBAudioConfig {
   uint8_t channels = 2;
   uint32_t sample_rate = 48000;
   uint8_t bits_per_sample = 16;
+  /// additional rates reported in the UAC2 clock range (e.g. 96000 for a
+  /// 24bit/96kHz alternate): unused entries stay 0
+  uint32_t alt_sample_rates[4] = {0, 0, 0, 0};
   bool enable_feedback_ep = true;
+  /// derive the feedback value from the reported consumption (e.g. the i2s
+  /// dma counter) instead of the fifo count: see recordConsumedFrames()
+  bool enable_feedback_from_consumption = false;
   bool enable_interrupt_ep = true;
   bool enable_feedback_forward_correction = false;
   bool enable_feedback_interval_isr = false;
@@ -68,15 +74,43 @@ class USBAudioConfig {
   bool is_ep_out() { return p_write_callback != nullptr; }
   bool is_ep_in() { return p_read_callback != nullptr; };
 
+  /// number of supported sample rates (current + alternates)
+  int sampleRateCount() {
+    int result = 1;
+    for (auto rate : alt_sample_rates) {
+      if (rate != 0) result++;
+    }
+    return result;
+  }
+
+  /// the highest supported rate: used to size the endpoints
+  uint32_t maxSampleRate() {
+    uint32_t result = sample_rate;
+    for (auto rate : alt_sample_rates) {
+      if (rate > result) result = rate;
+    }
+    return result;
+  }
+
+  /// checks if the host may select the indicated rate
+  bool isSupportedSampleRate(uint32_t rate) {
+    if (rate == sample_rate) return true;
+    for (auto alt : alt_sample_rates) {
+      if (alt != 0 && alt == rate) return true;
+    }
+    return false;
+  }
+
   // setup (missing) default values
   void begin() {
     if (func_ctl_buffer_size == 0) func_ctl_buffer_size = 64;
+    // size the endpoints for the highest supported alternate rate
     if (func_ep_in_size_max == 0)
       func_ep_in_size_max =
-          TUD_AUDIO_EP_SIZE(sample_rate, bits_per_sample / 8, channels);
+          TUD_AUDIO_EP_SIZE(maxSampleRate(), bits_per_sample / 8, channels);
     if (func_ep_out_size_max == 0)
       func_ep_out_size_max =
-          TUD_AUDIO_EP_SIZE(sample_rate, bits_per_sample / 8, channels);
+          TUD_AUDIO_EP_SIZE(maxSampleRate(), bits_per_sample / 8, channels);
     if (func_ep_out_size_max == 0)
       func_ep_in_sw_buffer_size =
           (TUD_OPT_HIGH_SPEED ? 32 : 4) *
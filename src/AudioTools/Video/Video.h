@@ -99,4 +99,66 @@ class VideoAudioBufferedSync : public VideoAudioSync {
   int correction_ms = 0;
 };
 
+/**
+ * @brief Logic to Synchronize video and audio output against the audio
+ * sample clock: the audio bytes written downstream define the master time
+ * (the i2s/dac backpressure makes them progress in real time) and the video
+ * position advances by one frame duration per displayed frame. When the
+ * video runs ahead we wait at most one frame duration; when it falls behind
+ * by more than maxLagFrames we resynchronize instead of delaying the audio
+ * (drop-late policy) - so the audio never waits on a slow frame. Use it
+ * together with VideoOutputTask to also take the jpeg decode off the audio
+ * task.
+ * @ingroup video
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ */
+class VideoAudioClockSync : public VideoAudioSync {
+ public:
+  VideoAudioClockSync(AudioInfo info, int maxLagFrames = 2) {
+    setAudioInfo(info);
+    max_lag_frames = maxLagFrames;
+  }
+
+  /// Defines the audio format which drives the clock
+  void setAudioInfo(AudioInfo info) {
+    bytes_per_second =
+        info.sample_rate * info.channels * info.bits_per_sample / 8;
+  }
+
+  /// Process the audio data: the written bytes advance the master clock
+  void writeAudio(Print *out, uint8_t *data, size_t size) override {
+    out->write(data, size);
+    if (bytes_per_second > 0) audio_us += 1000000ull * size / bytes_per_second;
+  }
+
+  /// Paces the video against the audio clock instead of the wall clock
+  void delayVideoFrame(int32_t microsecondsPerFrame,
+                       uint32_t time_used_ms) override {
+    video_us += microsecondsPerFrame;
+    int64_t ahead_us = (int64_t)(video_us - audio_us);
+    if (ahead_us > microsecondsPerFrame) {
+      // video is ahead: bounded wait, so that the audio keeps flowing
+      delay(microsecondsPerFrame / 1000);
+    } else if (ahead_us < -(int64_t)max_lag_frames * microsecondsPerFrame) {
+      // video is late: resynchronize instead of stalling the audio
+      video_us = audio_us;
+      late_frames++;
+    }
+  }
+
+  /// Number of frames which fell behind the audio clock and were resynced
+  uint32_t lateFrames() { return late_frames; }
+
+  /// Provides the audio master clock position in us
+  uint64_t audioUs() { return audio_us; }
+
+ protected:
+  uint64_t audio_us = 0;
+  uint64_t video_us = 0;
+  uint32_t bytes_per_second = 0;
+  uint32_t late_frames = 0;
+  int max_lag_frames = 2;
+};
+
 }  // namespace audio_tools
@@ -0,0 +1,112 @@
+#pragma once
+#include "AudioTools/Concurrency/RTOS/Task.h"
+#include "AudioTools/CoreAudio/AudioLogger.h"
+#include "AudioTools/CoreAudio/Buffers.h"
+#include "AudioTools/Video/Video.h"
+
+namespace audio_tools {
+
+/**
+ * @brief VideoOutput decorator which moves the expensive jpeg decode and
+ * display to an own FreeRTOS task: the parser task only copies the
+ * compressed frame into a small queue (2 slots by default) and returns
+ * immediately, so the audio never waits on a large frame. When the decode
+ * falls behind and the queue is full, the late frame is dropped instead of
+ * blocking (drop-late policy) which keeps the video close to the audio
+ * clock. Use it together with VideoAudioClockSync.
+ * @ingroup video
+ * @author Phil Schatzmann
+ * @copyright GPLv3
+ */
+class VideoOutputTask : public VideoOutput {
+ public:
+  VideoOutputTask(VideoOutput &out, int frameCount = 2) {
+    p_out = &out;
+    slots.resize(frameCount);
+  }
+
+  ~VideoOutputTask() { end(); }
+
+  /// Starts the decoding task (on the ESP32 pinned to the indicated core)
+  bool begin(int core = 1, int stackSize = 8192, int priority = 1) {
+    TRACED();
+    for (auto &slot : slots) slot.state = SlotFree;
+    write_idx = 0;
+    read_idx = 0;
+    dropped_frames = 0;
+    is_dropping = false;
+    if (!task.create("video-decode", stackSize, priority, core)) return false;
+    return task.begin([this]() { processFrame(); });
+  }
+
+  /// Stops the decoding task
+  void end() { task.end(); }
+
+  /// Called by the parser: selects the slot for the next compressed frame
+  void beginFrame(size_t size) override {
+    Slot &slot = slots[write_idx % slots.size()];
+    if (slot.state != SlotFree) {
+      // the decoder did not keep up: drop the frame instead of waiting
+      is_dropping = true;
+      dropped_frames++;
+      return;
+    }
+    is_dropping = false;
+    slot.state = SlotFilling;
+    slot.data.reset();
+    if (slot.data.size() < (int)size) slot.data.resize(size);
+  }
+
+  /// Called by the parser: collects the compressed frame data
+  size_t write(const uint8_t *data, size_t len) override {
+    if (is_dropping) return len;
+    Slot &slot = slots[write_idx % slots.size()];
+    return slot.data.writeArray(data, len);
+  }
+
+  /// Called by the parser: hands the frame to the decoding task and returns
+  /// immediately
+  uint32_t endFrame() override {
+    if (is_dropping) return 0;
+    Slot &slot = slots[write_idx % slots.size()];
+    slot.state = SlotReady;
+    write_idx++;
+    return 0;
+  }
+
+  /// Number of frames which were dropped because the decode was too slow
+  uint32_t droppedFrames() { return dropped_frames; }
+
+ protected:
+  enum SlotState : uint8_t { SlotFree, SlotFilling, SlotReady, SlotDecoding };
+
+  struct Slot {
+    volatile SlotState state = SlotFree;
+    SingleBuffer<uint8_t> data{0};
+  };
+
+  VideoOutput *p_out = nullptr;
+  Vector<Slot> slots;
+  Task task;
+  uint32_t write_idx = 0;
+  uint32_t read_idx = 0;
+  uint32_t dropped_frames = 0;
+  bool is_dropping = false;
+
+  /// Executed by the task: decodes and displays the next waiting frame
+  void processFrame() {
+    Slot &slot = slots[read_idx % slots.size()];
+    if (slot.state != SlotReady) {
+      delay(1);
+      return;
+    }
+    slot.state = SlotDecoding;
+    p_out->beginFrame(slot.data.available());
+    p_out->write(slot.data.data(), slot.data.available());
+    p_out->endFrame();
+    slot.state = SlotFree;
+    read_idx++;
+  }
+};
+
+}  // namespace audio_tools
@@ -0,0 +1,156 @@
+/**
+ * @file benchmark-converter.cpp
+ * @author Phil Schatzmann
+ * @brief Micro-benchmark for the BaseConverter kernels: times each converter
+ * (ChannelReducer, Decimate, Bin, ConverterAutoCenter and the
+ * NumberFormatConverterStreamT paths) across representative formats and
+ * reports cycles per sample and MB/s. The result is printed as one JSON
+ * document to stdout so that CI can store it and diff the numbers between
+ * commits to catch kernel regressions.
+ *
+ * @copyright Copyright (c) 2024
+ */
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "AudioTools.h"
+
+using namespace audio_tools;
+
+// ----- cycle counter -------------------------------------------------------
+
+static inline uint64_t cpuCycles() {
+#if defined(__x86_64__) || defined(__i386__)
+  return __builtin_ia32_rdtsc();
+#else
+  return 0;  // cycles per sample is reported as 0 when not available
+#endif
+}
+
+// ----- benchmark harness ---------------------------------------------------
+
+static const int FRAMES = 32 * 1024;
+static const int REPS = 20;
+static bool is_first_result = true;
+
+// source / work buffers: sized for up to 8 channels of 32 bit samples
+static uint8_t source_data[FRAMES * 8 * 4];
+static uint8_t work_data[FRAMES * 8 * 4];
+
+/// fills the source buffer with a sine so the kernels work on realistic data
+template <typename T>
+static void fillSource(int channels) {
+  T *data = (T *)source_data;
+  for (int j = 0; j < FRAMES; j++) {
+    T value = (T)(sin(2.0 * PI * j / 64.0) * 1000);
+    for (int ch = 0; ch < channels; ch++) data[j * channels + ch] = value;
+  }
+}
+
+/// runs the operation REPS times and reports the best run as JSON line:
+/// the minimum filters out scheduling noise on a desktop machine
+template <typename Op>
+static void bench(const char *name, size_t bytes, size_t samples, Op op) {
+  uint64_t best_cycles = (uint64_t)-1;
+  uint64_t best_us = (uint64_t)-1;
+  for (int r = 0; r < REPS; r++) {
+    memcpy(work_data, source_data, bytes);
+    uint64_t c0 = cpuCycles();
+    uint64_t t0 = micros();
+    op();
+    uint64_t us = micros() - t0;
+    uint64_t cycles = cpuCycles() - c0;
+    if (cycles < best_cycles) best_cycles = cycles;
+    if (us < best_us) best_us = us;
+  }
+  if (best_us == 0) best_us = 1;
+  double mbps = (double)bytes / best_us;  // bytes/us == MB/s
+  printf("%s\n    {\"name\": \"%s\", \"bytes\": %u, \"samples\": %u, "
+         "\"cycles_per_sample\": %.2f, \"us\": %u, \"mb_per_s\": %.1f}",
+         is_first_result ? "" : ",", name, (unsigned)bytes, (unsigned)samples,
+         (double)best_cycles / samples, (unsigned)best_us, mbps);
+  is_first_result = false;
+}
+
+// ----- benchmark cases -----------------------------------------------------
+
+template <typename T>
+static void benchChannelReducer(const char *name, int from, int to) {
+  fillSource<T>(from);
+  size_t bytes = FRAMES * from * sizeof(T);
+  ChannelReducer cr(to, from, sizeof(T) * 8);
+  bench(name, bytes, FRAMES * from,
+        [&]() { cr.convert(work_data, work_data, bytes); });
+}
+
+template <typename T>
+static void benchDecimate(const char *name, int factor, int channels) {
+  fillSource<T>(channels);
+  size_t bytes = FRAMES * channels * sizeof(T);
+  Decimate dec(factor, channels, sizeof(T) * 8);
+  bench(name, bytes, FRAMES * channels,
+        [&]() { dec.convert(work_data, work_data, bytes); });
+}
+
+template <typename T>
+static void benchBin(const char *name, int binSize, int channels) {
+  fillSource<T>(channels);
+  size_t bytes = FRAMES * channels * sizeof(T);
+  Bin bin(binSize, channels, true, sizeof(T) * 8);
+  bench(name, bytes, FRAMES * channels,
+        [&]() { bin.convert(work_data, work_data, bytes); });
+}
+
+template <typename T>
+static void benchAutoCenter(const char *name, int channels, bool isFilter) {
+  fillSource<T>(channels);
+  // add an offset so there is an actual DC component to remove
+  T *data = (T *)source_data;
+  for (int j = 0; j < FRAMES * channels; j++) data[j] += 500;
+  size_t bytes = FRAMES * channels * sizeof(T);
+  ConverterAutoCenter center(channels, sizeof(T) * 8);
+  if (isFilter) center.begin(channels, sizeof(T) * 8, false, true);
+  bench(name, bytes, FRAMES * channels,
+        [&]() { center.convert(work_data, bytes); });
+}
+
+template <typename TFrom, typename TTo>
+static void benchNumberFormat(const char *name) {
+  fillSource<TFrom>(2);
+  size_t bytes = FRAMES * 2 * sizeof(TFrom);
+  NullStream null_out;
+  NumberFormatConverterStreamT<TFrom, TTo> conv(null_out);
+  conv.begin();
+  bench(name, bytes, FRAMES * 2,
+        [&]() { conv.write(work_data, bytes); });
+}
+
+// ----- main ----------------------------------------------------------------
+
+void setup() {
+  printf("{\n  \"frames\": %d,\n  \"benchmarks\": [", FRAMES);
+
+  benchChannelReducer<int16_t>("ChannelReducer_2to1_16bit", 2, 1);
+  benchChannelReducer<int16_t>("ChannelReducer_8to2_16bit", 8, 2);
+  benchChannelReducer<int32_t>("ChannelReducer_2to1_32bit", 2, 1);
+
+  benchDecimate<int16_t>("Decimate_4_stereo_16bit", 4, 2);
+  benchDecimate<int32_t>("Decimate_4_stereo_32bit", 4, 2);
+
+  benchBin<int16_t>("Bin_4_stereo_16bit", 4, 2);
+  benchBin<int32_t>("Bin_4_stereo_32bit", 4, 2);
+
+  benchAutoCenter<int16_t>("AutoCenter_stereo_16bit", 2, false);
+  benchAutoCenter<int16_t>("AutoCenter_filter_stereo_16bit", 2, true);
+
+  benchNumberFormat<int16_t, int32_t>("NumberFormat_16to32");
+  benchNumberFormat<int32_t, int16_t>("NumberFormat_32to16");
+  benchNumberFormat<int16_t, int24_t>("NumberFormat_16to24");
+  benchNumberFormat<int8_t, int16_t>("NumberFormat_8to16");
+
+  printf("\n  ]\n}\n");
+  exit(0);
+}
+
+void loop() {}
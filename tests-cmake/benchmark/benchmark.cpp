@@ -0,0 +1,272 @@
+/**
+ * @file benchmark.cpp
+ * @author Phil Schatzmann
+ * @brief Codec decode benchmark: feeds canned or generated encoded assets
+ * through each enabled decoder and reports throughput, cycles per sample,
+ * peak heap and output stall counts as CSV lines prefixed with "BENCH," so
+ * that CI can grep and compare the numbers between runs.
+ *
+ * @copyright Copyright (c) 2024
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "AudioTools.h"
+
+#ifdef BENCHMARK_MP3_HELIX
+#include "AudioTools/AudioCodecs/CodecMP3Helix.h"
+#include "BabyElephantWalk60_mp3.h"
+#endif
+#ifdef BENCHMARK_AAC_HELIX
+#include "AudioTools/AudioCodecs/CodecAACHelix.h"
+#include "audio.h"
+#endif
+#ifdef BENCHMARK_ADPCM
+#include "AudioTools/AudioCodecs/CodecADPCM.h"
+#endif
+#ifdef BENCHMARK_OPUS
+#include "AudioTools/AudioCodecs/CodecOpus.h"
+#endif
+#ifdef BENCHMARK_FLAC_FOXEN
+#include "AudioTools/AudioCodecs/CodecFLACFoxen.h"
+#endif
+
+using namespace audio_tools;
+
+// ----- heap tracking -------------------------------------------------------
+// The MemoryManager only switches the ESP32 PSRAM allocation limit and has
+// no accounting, so on the desktop we track the global C++ allocator: each
+// allocation is prefixed with its size and the running total / peak is kept.
+
+static size_t heap_current = 0;
+static size_t heap_peak = 0;
+
+void* operator new(size_t size) {
+  uint8_t* p = (uint8_t*)malloc(size + 16);
+  if (p == nullptr) abort();
+  *(size_t*)p = size;
+  heap_current += size;
+  if (heap_current > heap_peak) heap_peak = heap_current;
+  return p + 16;
+}
+
+void* operator new[](size_t size) { return operator new(size); }
+
+void operator delete(void* ptr) noexcept {
+  if (ptr == nullptr) return;
+  uint8_t* p = (uint8_t*)ptr - 16;
+  heap_current -= *(size_t*)p;
+  free(p);
+}
+
+void operator delete[](void* ptr) noexcept { operator delete(ptr); }
+void operator delete(void* ptr, size_t) noexcept { operator delete(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { operator delete(ptr); }
+
+static void heapResetPeak() { heap_peak = heap_current; }
+
+// ----- cycle counter -------------------------------------------------------
+
+static inline uint64_t cpuCycles() {
+#if defined(__x86_64__) || defined(__i386__)
+  return __builtin_ia32_rdtsc();
+#else
+  return 0;  // cycles per sample is reported as 0 when not available
+#endif
+}
+
+// ----- helpers -------------------------------------------------------------
+
+/// Counting sink for the decoded pcm data
+struct BenchmarkSink : public Print {
+  size_t total = 0;
+  size_t write(const uint8_t* data, size_t len) override {
+    total += len;
+    return len;
+  }
+  size_t write(uint8_t c) override {
+    total++;
+    return 1;
+  }
+};
+
+/// Print which collects the encoded asset into a Vector
+struct VectorPrint : public Print {
+  Vector<uint8_t>& vector;
+  VectorPrint(Vector<uint8_t>& v) : vector(v) {}
+  size_t write(const uint8_t* data, size_t len) override {
+    size_t pos = vector.size();
+    vector.resize(pos + len);
+    memcpy(vector.data() + pos, data, len);
+    return len;
+  }
+  size_t write(uint8_t c) override { return write(&c, 1); }
+};
+
+/// Creates an encoded asset by feeding a generated sine through the encoder
+static void encodeSine(AudioEncoder& enc, AudioInfo info, int seconds,
+                       Vector<uint8_t>& out) {
+  VectorPrint vp(out);
+  enc.setOutput(vp);
+  enc.setAudioInfo(info);
+  enc.begin();
+  SineWaveGenerator<int16_t> sine(20000);
+  sine.begin(info, N_B4);
+  int16_t frame_buffer[256];
+  int frames_per_call = 256 / info.channels;
+  int total_frames = info.sample_rate * seconds;
+  for (int frame = 0; frame < total_frames; frame += frames_per_call) {
+    int frames = min(frames_per_call, total_frames - frame);
+    for (int i = 0; i < frames; i++) {
+      int16_t sample = sine.readSample();
+      for (int ch = 0; ch < info.channels; ch++) {
+        frame_buffer[i * info.channels + ch] = sample;
+      }
+    }
+    enc.write((uint8_t*)frame_buffer, frames * info.channels * sizeof(int16_t));
+  }
+  enc.end();
+}
+
+static bool is_header_printed = false;
+
+/// Feeds the encoded asset through the decoder and reports one CSV line
+static void benchmark(const char* name, AudioDecoder& dec, AudioInfo info,
+                      const uint8_t* data, size_t len) {
+  if (len == 0) {
+    printf("BENCH,%s,skipped: no asset\n", name);
+    return;
+  }
+  BenchmarkSink sink;
+  dec.setOutput(sink);
+  if (info.sample_rate != 0) dec.setAudioInfo(info);
+  dec.begin();
+
+  heapResetPeak();
+  uint64_t cycles_start = cpuCycles();
+  uint64_t time_start = micros();
+
+  const size_t chunk = 1024;
+  size_t pos = 0;
+  int stalls = 0;
+  while (pos < len) {
+    size_t to_write = min(chunk, len - pos);
+    size_t written = dec.write(data + pos, to_write);
+    if (written < to_write) {
+      // the decoder could not take all the data: its output buffer is full
+      stalls++;
+    }
+    if (written == 0) break;
+    pos += written;
+  }
+
+  uint64_t time_us = micros() - time_start;
+  uint64_t cycles = cpuCycles() - cycles_start;
+  size_t peak = heap_peak;
+  AudioInfo out_info = dec.audioInfo();
+  dec.end();
+
+  int bytes_per_sample = out_info.bits_per_sample / 8;
+  if (bytes_per_sample == 0) bytes_per_sample = 2;
+  size_t samples = sink.total / bytes_per_sample;
+  float mb_per_s = time_us == 0 ? 0.0f : (float)len / (float)time_us;
+  float cycles_per_sample = samples == 0 ? 0.0f : (float)cycles / samples;
+
+  if (!is_header_printed) {
+    printf(
+        "BENCH,codec,in_bytes,out_bytes,time_ms,mb_per_s,cycles_per_sample,"
+        "peak_heap,stalls\n");
+    is_header_printed = true;
+  }
+  printf("BENCH,%s,%u,%u,%.2f,%.2f,%.1f,%u,%d\n", name, (unsigned)len,
+         (unsigned)sink.total, time_us / 1000.0f, mb_per_s, cycles_per_sample,
+         (unsigned)peak, stalls);
+}
+
+// ----- benchmark cases -----------------------------------------------------
+
+#ifdef BENCHMARK_MP3_HELIX
+static void benchmarkMP3Helix() {
+  MP3DecoderHelix dec;
+  benchmark("mp3-helix", dec, AudioInfo(0, 0, 0), BabyElephantWalk60_mp3,
+            BabyElephantWalk60_mp3_len);
+}
+#endif
+
+#ifdef BENCHMARK_AAC_HELIX
+static void benchmarkAACHelix() {
+  AACDecoderHelix dec;
+  benchmark("aac-helix", dec, AudioInfo(0, 0, 0), gs_16b_2c_44100hz_aac,
+            gs_16b_2c_44100hz_aac_len);
+}
+#endif
+
+#ifdef BENCHMARK_ADPCM
+static void benchmarkADPCM() {
+  AudioInfo info(16000, 2, 16);
+  Vector<uint8_t> asset;
+  ADPCMEncoder enc(AV_CODEC_ID_ADPCM_IMA_WAV);
+  encodeSine(enc, info, 20, asset);
+  ADPCMDecoder dec(AV_CODEC_ID_ADPCM_IMA_WAV);
+  benchmark("adpcm-ima-wav", dec, info, asset.data(), asset.size());
+}
+#endif
+
+#ifdef BENCHMARK_OPUS
+static void benchmarkOpus() {
+  AudioInfo info(24000, 1, 16);
+  Vector<uint8_t> asset;
+  OpusAudioEncoder enc;
+  encodeSine(enc, info, 20, asset);
+  OpusAudioDecoder dec;
+  benchmark("opus", dec, info, asset.data(), asset.size());
+}
+#endif
+
+#ifdef BENCHMARK_FLAC_FOXEN
+// there is no in-tree FLAC encoder for the Foxen decoder: the asset is
+// loaded from the file defined by the BENCHMARK_FLAC_FILE environment
+// variable
+static void benchmarkFLACFoxen() {
+  const char* path = getenv("BENCHMARK_FLAC_FILE");
+  if (path == nullptr) {
+    printf("BENCH,flac-foxen,skipped: BENCHMARK_FLAC_FILE not set\n");
+    return;
+  }
+  FILE* file = fopen(path, "rb");
+  if (file == nullptr) {
+    printf("BENCH,flac-foxen,skipped: can not open %s\n", path);
+    return;
+  }
+  fseek(file, 0, SEEK_END);
+  long size = ftell(file);
+  fseek(file, 0, SEEK_SET);
+  Vector<uint8_t> asset(size);
+  size_t read = fread(asset.data(), 1, size, file);
+  fclose(file);
+  FLACDecoderFoxen dec;
+  benchmark("flac-foxen", dec, AudioInfo(0, 0, 0), asset.data(), read);
+}
+#endif
+
+void setup() {
+#ifdef BENCHMARK_MP3_HELIX
+  benchmarkMP3Helix();
+#endif
+#ifdef BENCHMARK_AAC_HELIX
+  benchmarkAACHelix();
+#endif
+#ifdef BENCHMARK_ADPCM
+  benchmarkADPCM();
+#endif
+#ifdef BENCHMARK_OPUS
+  benchmarkOpus();
+#endif
+#ifdef BENCHMARK_FLAC_FOXEN
+  benchmarkFLACFoxen();
+#endif
+  exit(0);
+}
+
+void loop() {}
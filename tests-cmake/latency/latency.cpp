@@ -0,0 +1,49 @@
+// Measures the end to end latency of a pipeline with a loopback: a sine
+// burst is injected, the duplex capture is cross correlated against it and
+// the resulting lag is reported together with the pipeline metrics.
+// Desktop: duplex MiniAudioStream (use the real audio device and place the
+// microphone close to the speaker or use a loopback cable). ESP32: I2S in
+// RXTX mode - connect the data out pin to the data in pin.
+#include "AudioTools.h"
+#ifndef ESP32
+#include "AudioTools/AudioLibs/MiniAudioStream.h"
+#endif
+
+AudioInfo info(44100, 2, 16);
+#ifdef ESP32
+I2SStream io;
+#else
+MiniAudioStream io;
+#endif
+Pipeline pip;
+VolumeStream volume;
+LatencyMeasurement latency;
+
+// Arduino Setup
+void setup(void) {
+  AudioToolsLogger.begin(Serial, AudioToolsLogLevel::Warning);
+
+  auto cfg = io.defaultConfig(RXTX_MODE);
+  cfg.copyFrom(info);
+  io.begin(cfg);
+
+  // measured pipeline: add the stages whose latency impact is in question
+  pip.setMeasurementActive(true);
+  volume.setVolume(1.0);
+  pip.add(volume);
+  pip.setOutput(io);
+  pip.begin(info);
+
+  latency.setAudioInfo(info);
+  latency.setPipeline(pip);
+}
+
+void loop() {
+  if (latency.measure(pip, io)) {
+    latency.report(Serial);
+  } else {
+    Serial.println("no correlation peak - check the loopback");
+  }
+  pip.clearMetrics();
+  delay(1000);
+}